@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include "backend/memory.h"
 #include "ode.h"
 #include "runge_kutta.h"
@@ -132,6 +133,20 @@ struct Tolerance
     private:
     value_type m_rtol, m_atol;
 };
+template<class value_type>
+struct ToleranceRatio
+{
+    // sqrt(size) is norm( 1)
+    ToleranceRatio( value_type rtol, value_type atol, value_type size) :
+        m_rtol(rtol*sqrt(size)), m_atol( atol*sqrt(size)){}
+    DG_DEVICE
+    value_type operator()( value_type u0, value_type delta) const{
+        value_type s = delta/ ( m_rtol*fabs(u0) + m_atol);
+        return s*s;
+    }
+    private:
+    value_type m_rtol, m_atol;
+};
 } //namespace detail
 ///@endcond
 
@@ -263,6 +278,38 @@ struct Adaptive
     ///@brief Read access to internal stepper
     const stepper_type& stepper() const { return m_stepper;}
 
+    /*!@brief Fuse the error scaling and the norm into a single sweep
+     *
+     * By default \c step scales the error estimate with
+     * \c dg::blas1::subroutine and afterwards calls the user-supplied
+     * \c ErrorNorm, which reads the scaled error a second time. With the
+     * fused norm both are combined into one \c dg::blas1::reduce sweep over
+     * \c u0 and the error estimate, which halves the number of memory
+     * passes per attempted step.
+     * @attention The fused sweep **bypasses the user-supplied** \c ErrorNorm
+     * parameter of \c step and always computes the l2 norm with a naive
+     * summation equivalent to \c dg::fast_l2norm, i.e. the result is **not**
+     * binary reproducible (in contrast to \c dg::l2norm, which uses
+     * \c dg::blas1::dot). The proposed timesteps may thus differ in the last
+     * digits between runs or processor counts.
+     * @param fused if true, use the fused single-sweep error norm in \c step
+     */
+    void set_fused_norm( bool fused){ m_fused_norm = fused;}
+
+    /*!@brief Treat a \c dg::Fail thrown by the ODE as a rejected step
+     *
+     * An embedded implicit solver (e.g. \c dg::PCG) throws \c dg::Fail when
+     * it cannot converge, in particular as soon as its residual norm turns
+     * non-finite in a diverging solve. By default the exception propagates
+     * and terminates the integration. With this option set, \c step catches
+     * the failure, rejects the attempted step and restarts the controller
+     * with a reduced stepsize, such that a blow-up aborts within the failing
+     * stage instead of wasting the remaining stages of the step
+     * @param reject if true, convert \c dg::Fail exceptions in \c step into
+     * step rejections
+     */
+    void set_reject_on_fail( bool reject){ m_reject_on_fail = reject;}
+
     /*!@brief Semi-implicit adaptive step
      *
      * @copydoc hide_adaptive_params
@@ -287,14 +334,34 @@ struct Adaptive
               )
     {
         // prevent overwriting u0 in case stepper fails
-        m_stepper.step( std::forward<ODE>(ode), t0, u0, m_t_next, m_next, dt,
-                m_delta);
+        bool stage_failed = false;
+        if( m_reject_on_fail)
+        {
+            try{
+                m_stepper.step( std::forward<ODE>(ode), t0, u0, m_t_next,
+                        m_next, dt, m_delta);
+            }catch( const dg::Fail&){
+                stage_failed = true;
+            }
+        }
+        else
+            m_stepper.step( std::forward<ODE>(ode), t0, u0, m_t_next, m_next,
+                    dt, m_delta);
         m_nsteps++;
-        dg::blas1::subroutine( detail::Tolerance<value_type>( rtol, atol,
-                    m_size), u0, m_delta);
-        m_eps0 = norm( m_delta);
+        if( stage_failed)
+            m_eps0 = std::numeric_limits<value_type>::quiet_NaN();
+        else if( m_fused_norm)
+            m_eps0 = sqrt( dg::blas1::reduce( u0, m_delta, (value_type)0,
+                    dg::Sum(), detail::ToleranceRatio<value_type>( rtol, atol,
+                    m_size)));
+        else
+        {
+            dg::blas1::subroutine( detail::Tolerance<value_type>( rtol, atol,
+                        m_size), u0, m_delta);
+            m_eps0 = norm( m_delta);
+        }
         m_dt0 = dt;
-        if( m_eps0 > reject_limit || std::isnan( m_eps0) )
+        if( m_eps0 > reject_limit || !std::isfinite( m_eps0) )
         {
             // if stepper fails, restart controller
             dt = control( std::array<value_type,3>{m_dt0, 0, m_dt2},
@@ -364,12 +431,38 @@ struct Adaptive
     const value_type& get_error( ) const{
         return m_eps0;
     }
+
+    /*!@brief Get the internal state of the timestep controller
+     *
+     * The PID controllers ( \c dg::pid_control and relatives) act on the
+     * history of the last two accepted stepsizes and error norms, which is
+     * reset to its default in the constructor. For a checkpoint-restart
+     * write this state (together with the proposed \c dt held by the
+     * integration loop) to the restart file and restore it with \c
+     * set_controller_state : the restarted run then proposes the same
+     * stepsizes as an uninterrupted one instead of re-entering the
+     * controller transient.
+     * @return the array <tt> {dt1, dt2, eps1, eps2} </tt> of the previous
+     * and second previous stepsize and error norm
+     */
+    std::array<value_type,4> controller_state() const{
+        return {m_dt1, m_dt2, m_eps1, m_eps2};
+    }
+    /*!@brief Re-set the internal state of the timestep controller
+     * @param state as returned by \c controller_state of a previous run
+     */
+    void set_controller_state( const std::array<value_type,4>& state){
+        m_dt1 = state[0], m_dt2 = state[1];
+        m_eps1 = state[2], m_eps2 = state[3];
+    }
     private:
     void reset_history(){
         m_eps1 = m_eps2 = 1.;
         m_dt1 = m_dt2 = 0.;
     }
     bool m_failed = false;
+    bool m_fused_norm = false;
+    bool m_reject_on_fail = false;
     unsigned m_nfailed = 0;
     unsigned m_nsteps = 0;
     Stepper m_stepper;
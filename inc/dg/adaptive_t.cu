@@ -76,6 +76,18 @@ int main()
     std::cout << "With "<<adapt.nsteps()<<"\t Dormand Prince steps norm of error is "
               << dg::fast_l2norm( u_end)<<"\n";
     //![doxygen]
+    {
+        //repeat with the fused single-sweep error norm
+        u_start = solution(t_start, damping, omega_0, omega_drive);
+        dg::Adaptive<dg::ERKStep<Vec>> fused( "Dormand-Prince-7-4-5", u_start);
+        fused.set_fused_norm( true);
+        dg::AdaptiveTimeloop<Vec>( fused, rhs, dg::pid_control, dg::fast_l2norm,
+                1e-6, 1e-10).integrate( t_start, u_start, t_end, u_end);
+        dg::blas1::axpby( 1., solution(t_end, damping, omega_0, omega_drive),
+                -1., u_end);
+        std::cout << "With "<<fused.nsteps()<<"\t fused norm steps norm of error is "
+                  << dg::fast_l2norm( u_end)<<" (expect same as above)\n";
+    }
     std::cout << "Explicit Methods \n";
     std::vector<std::string> names{
         "Heun-Euler-2-1-2",
@@ -5,6 +5,8 @@
 #include "enums.h"
 #include "topology/evaluation.h"
 #include "topology/derivatives.h"
+#include "topology/stencil.h"
+#include "topology/filter.h"
 #ifdef MPI_VERSION
 #include "topology/mpi_derivatives.h"
 #include "topology/mpi_evaluation.h"
@@ -16,6 +18,64 @@
 namespace dg
 {
 
+///@cond
+namespace detail
+{
+//Fused evaluation of the upwind advection in a single kernel: each point
+//computes only the derivative its velocity sign selects and the derivative
+//fields are never written to global memory
+template<class value_type, class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void fused_upwind( value_type alpha, const ContainerType0& vx,
+    const ContainerType1& vy, const ContainerType2& f,
+    value_type beta, ContainerType3& result, unsigned size,
+    const EllSparseBlockMatView<value_type>& dxb, const EllSparseBlockMatView<value_type>& dxf,
+    const EllSparseBlockMatView<value_type>& dyb, const EllSparseBlockMatView<value_type>& dyf)
+{
+    dg::blas2::parallel_for( [dxb,dxf,dyb,dyf,alpha,beta]DG_DEVICE(
+        unsigned i, const value_type* vvx, const value_type* vvy,
+        const value_type* ff, value_type* yy)
+        {
+            value_type dx = vvx[i] >= 0 ? dxb( ff, i) : dxf( ff, i);
+            value_type dy = vvy[i] >= 0 ? dyb( ff, i) : dyf( ff, i);
+            value_type temp = DG_FMA( vvx[i], dx, vvy[i]*dy);
+            if( 0 == beta)
+                yy[i] = alpha*temp;
+            else
+                yy[i] = DG_FMA( alpha, temp, beta*yy[i]);
+        }, size, vx, vy, f, result);
+}
+//Select rows from the backward or the forward derivative according to the
+//sign pattern of the velocity. This is only possible for scalar sparse
+//formats where each matrix row corresponds to exactly one grid point
+template<class Matrix, class value_type>
+void merge_upwind( const Matrix& mb, const Matrix& mf,
+    const thrust::host_vector<value_type>& sign, Matrix& sel)
+{
+    cusp::csr_matrix<int, value_type, cusp::host_memory> b( mb), f( mf), m;
+    unsigned num_entries = 0;
+    for( unsigned i=0; i<b.num_rows; i++)
+        num_entries += sign[i] > 0.5 ?
+            b.row_offsets[i+1]-b.row_offsets[i] :
+            f.row_offsets[i+1]-f.row_offsets[i];
+    m.resize( b.num_rows, b.num_cols, num_entries);
+    m.row_offsets[0] = 0;
+    for( unsigned i=0; i<b.num_rows; i++)
+    {
+        const auto& src = sign[i] > 0.5 ? b : f;
+        int k = m.row_offsets[i];
+        for( int j=src.row_offsets[i]; j<src.row_offsets[i+1]; j++)
+        {
+            m.column_indices[k] = src.column_indices[j];
+            m.values[k] = src.values[j];
+            k++;
+        }
+        m.row_offsets[i+1] = k;
+    }
+    cusp::convert( m, sel);
+}
+}//namespace detail
+///@endcond
+
     //MW this scheme cannot be formulated as a weak form
 
 /**
@@ -88,9 +148,45 @@ struct Advection
     template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
     void upwind( value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result);
 
+    /**
+     * @brief Compute slope-limited advection term \f$ y =  \alpha \vec v\cdot\nabla \Lambda\Pi f + \beta y \f$
+     *
+     * Same as \c upwind except that the generalized slope limiter
+     * \c dg::CSRSlopeLimiter is applied to \c f in both directions before the
+     * upwind derivatives are computed. The limiter passes reuse the internal
+     * workspace of this class such that no separate filter pass over the
+     * field with its own temporary is necessary.
+     * @param alpha constant
+     * @param vx Velocity in x direction
+     * @param vy Velocity in y direction
+     * @param f function
+     * @param beta constant
+     * @param result Result
+     * @param mod the modification parameter of \c dg::CSRSlopeLimiter
+     * (the limiter is only active if the linear modal coefficient exceeds \c mod)
+     * @attention Throws if the grid has only 1 polynomial coefficient
+     * (the slope limiter needs at least 2)
+     * @tparam ContainerTypes must be usable with \c Container in \ref dispatch
+     */
+    template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+    void upwind_limited( value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result, value_type mod = (value_type)0);
+
   private:
-    Container m_temp0, m_temp1;
-    Matrix m_dxf, m_dyf, m_dxb, m_dyb;
+    template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+    void do_upwind( std::true_type, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result);
+    template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+    void do_upwind( std::false_type, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result);
+    template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+    void do_upwind_select( AnyMatrixTag, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result);
+    template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+    void do_upwind_select( CuspMatrixTag, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result);
+    using stencil_matrix_type = decltype( dg::create::limiter_stencil(
+                dg::coo3d::x, std::declval<const Geometry&>(), dg::PER));
+    Container m_temp0, m_temp1, m_limited, m_signx, m_signy;
+    Matrix m_dxf, m_dyf, m_dxb, m_dyb, m_dxs, m_dys;
+    stencil_matrix_type m_limiter_x, m_limiter_y;
+    bool m_has_limiter = false;
+    bool m_sel_valid = false;
 };
 
 ///@cond
@@ -101,16 +197,46 @@ Advection<Geometry, Matrix, Container>::Advection( const Geometry& g ):
 template<class Geometry, class Matrix, class Container>
 Advection<Geometry, Matrix, Container>::Advection( const Geometry& g, bc bcx, bc bcy):
     m_temp0( dg::construct<Container>(dg::evaluate( one, g)) ), m_temp1(m_temp0),
+    m_limited(m_temp0), m_signx(m_temp0), m_signy(m_temp0),
     m_dxf(dg::create::dx( g, bcx, dg::forward)),
     m_dyf(dg::create::dy( g, bcy, dg::forward)),
     m_dxb(dg::create::dx( g, bcx, dg::backward)),
     m_dyb(dg::create::dy( g, bcy, dg::backward))
 {
+    if( g.nx() > 1 && g.ny() > 1) // the slope limiter needs at least 2 coefficients
+    {
+        m_limiter_x = dg::create::limiter_stencil( dg::coo3d::x, g, bcx);
+        m_limiter_y = dg::create::limiter_stencil( dg::coo3d::y, g, bcy);
+        m_has_limiter = true;
+    }
 }
 
 template< class Geometry, class Matrix, class Container>
 template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
 void Advection<Geometry, Matrix, Container>::upwind( value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result)
+{
+    do_upwind( typename detail::is_ell_matrix<Matrix>::type(), alpha, vx, vy, f, beta, result);
+}
+
+template< class Geometry, class Matrix, class Container>
+template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void Advection<Geometry, Matrix, Container>::do_upwind( std::true_type, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result)
+{
+    detail::fused_upwind( alpha, vx, vy, f, beta, result, m_temp0.size(),
+        detail::make_ell_view( m_dxb), detail::make_ell_view( m_dxf),
+        detail::make_ell_view( m_dyb), detail::make_ell_view( m_dyf));
+}
+
+template< class Geometry, class Matrix, class Container>
+template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void Advection<Geometry, Matrix, Container>::do_upwind( std::false_type, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result)
+{
+    do_upwind_select( get_tensor_category<Matrix>(), alpha, vx, vy, f, beta, result);
+}
+
+template< class Geometry, class Matrix, class Container>
+template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void Advection<Geometry, Matrix, Container>::do_upwind_select( AnyMatrixTag, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result)
 {
     blas2::symv( m_dxb, f, m_temp0);
     blas2::symv( m_dxf, f, m_temp1);
@@ -119,6 +245,49 @@ void Advection<Geometry, Matrix, Container>::upwind( value_type alpha, const Con
     blas2::symv( m_dyf, f, m_temp1);
     blas1::evaluate( result, dg::Axpby<value_type>( alpha, 1.), dg::UpwindProduct(), vy, m_temp0, m_temp1);
 }
+
+//For the scalar sparse format we can fold the upwind selection into the
+//matrix itself: one symv per direction with rows taken from the backward or
+//forward derivative instead of two. The merged matrices are only rebuilt
+//when the sign pattern of the velocity changes, which a cheap kernel
+//detects; within a Runge-Kutta step the pattern typically stays fixed
+template< class Geometry, class Matrix, class Container>
+template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void Advection<Geometry, Matrix, Container>::do_upwind_select( CuspMatrixTag, value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result)
+{
+    //diff the sign bits of the velocity against the cached pattern
+    dg::blas1::subroutine( []DG_DEVICE( value_type vxi, value_type vyi,
+        value_type& sx, value_type& sy, value_type& diff)
+        {
+            value_type nx = vxi >= 0 ? 1 : 0, ny = vyi >= 0 ? 1 : 0;
+            diff = fabs( nx-sx) + fabs( ny-sy);
+            sx = nx, sy = ny;
+        }, vx, vy, m_signx, m_signy, m_temp0);
+    value_type changed = dg::blas1::dot( m_temp0, 1.);
+    if( changed != 0 || !m_sel_valid)
+    {
+        thrust::host_vector<value_type> sx, sy;
+        dg::assign( m_signx, sx), dg::assign( m_signy, sy);
+        detail::merge_upwind( m_dxb, m_dxf, sx, m_dxs);
+        detail::merge_upwind( m_dyb, m_dyf, sy, m_dys);
+        m_sel_valid = true;
+    }
+    blas2::symv( m_dxs, f, m_temp0);
+    blas2::symv( m_dys, f, m_temp1);
+    dg::blas1::pointwiseDot( alpha, vx, m_temp0, beta, result);
+    dg::blas1::pointwiseDot( alpha, vy, m_temp1, 1., result);
+}
+
+template< class Geometry, class Matrix, class Container>
+template<class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void Advection<Geometry, Matrix, Container>::upwind_limited( value_type alpha, const ContainerType0& vx, const ContainerType1& vy, const ContainerType2& f, value_type beta, ContainerType3& result, value_type mod)
+{
+    if( !m_has_limiter)
+        throw dg::Error( dg::Message(_ping_) << "upwind_limited not possible for n==1!");
+    blas2::stencil( dg::CSRSlopeLimiter<value_type>(mod), m_limiter_x, f, m_temp0);
+    blas2::stencil( dg::CSRSlopeLimiter<value_type>(mod), m_limiter_y, m_temp0, m_limited);
+    upwind( alpha, vx, vy, m_limited, beta, result);
+}
 ///@endcond
 
 }//namespace dg
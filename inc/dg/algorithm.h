@@ -7,7 +7,10 @@
  */
 #include "backend/config.h"
 #include "backend/timer.h"
+#include "backend/energy.h"
+#include "backend/vector_pool.h"
 #include "backend/transpose.h"
+#include "backend/multicomponent.h"
 #include "topology/split_and_join.h"
 #include "topology/xspacelib.h"
 #include "topology/evaluationX.h"
@@ -17,10 +20,15 @@
 #include "topology/projectionX.h"
 #include "topology/geometry.h"
 #include "topology/stencil.h"
+#include "topology/stagger.h"
+#include "topology/kronecker_weights.h"
+#include "topology/spectral.h"
 #include "blas.h"
+#include "expression.h"
 #include "helmholtz.h"
 #include "pcg.h"
 #include "precond.h"
+#include "schwarz.h"
 #include "bicgstabl.h"
 #include "andersonacc.h"
 #include "lgmres.h"
@@ -36,9 +44,15 @@
 #include "advection.h"
 #include "poisson.h"
 #include "simpsons.h"
+#include "probes.h"
+#include "statistics.h"
 #include "nullstelle.h"
 #include "topology/average.h"
 #ifdef MPI_VERSION
 #include "topology/average_mpi.h"
 #include "backend/mpi_init.h"
+#include "parareal.h"
+#endif
+#ifdef FELTOR_EXPLICIT_INSTANTIATION
+#include "instantiate.h"
 #endif
@@ -40,6 +40,35 @@ void QRdelete1( std::vector<ContainerType>& Q, dg::Operator<value_type>& R, unsi
     return;
 }
 
+// batched dot products of a set of vectors against a common right hand side;
+// with MPI the global reductions are posted asynchronously such that only a
+// single reduction latency is paid for the whole batch
+template<class ContainerType, class value_type>
+void multi_dot( const std::vector<ContainerType>& qs, const ContainerType& wv,
+    unsigned size, value_type* out, AnyVectorTag)
+{
+    for( unsigned i=0; i<size; i++)
+        out[i] = dg::blas1::dot( qs[i], wv);
+}
+#ifdef MPI_VERSION
+template<class ContainerType, class value_type>
+void multi_dot( const std::vector<ContainerType>& qs, const ContainerType& wv,
+    unsigned size, value_type* out, MPIVectorTag)
+{
+    std::vector<dg::blas1::Future<value_type>> futures( size);
+    for( unsigned i=0; i<size; i++)
+        futures[i] = dg::blas1::dot_async( qs[i], wv);
+    for( unsigned i=0; i<size; i++)
+        out[i] = futures[i].get();
+}
+#endif //MPI_VERSION
+template<class ContainerType, class value_type>
+void multi_dot( const std::vector<ContainerType>& qs, const ContainerType& wv,
+    unsigned size, value_type* out)
+{
+    multi_dot( qs, wv, size, out, get_tensor_category<ContainerType>());
+}
+
 }//namespace detail
 ///@endcond
 
@@ -85,6 +114,7 @@ struct AndersonAcceleration
      */
     AndersonAcceleration(const ContainerType& copyable, unsigned mMax ):
         m_g_old( copyable), m_fval( copyable), m_f_old(copyable),
+        m_wf( copyable),
         m_DG( mMax, copyable), m_Q( m_DG),
         m_gamma( mMax, 0.),
         m_R( mMax), m_mMax( mMax)
@@ -147,7 +177,7 @@ struct AndersonAcceleration
         value_type damping, unsigned restart, bool verbose);
 
     private:
-    ContainerType m_g_old, m_fval, m_f_old;
+    ContainerType m_g_old, m_fval, m_f_old, m_wf;
     std::vector<ContainerType> m_DG, m_Q;
     std::vector<value_type> m_gamma;
     dg::Operator<value_type> m_R;
@@ -230,22 +260,43 @@ unsigned AndersonAcceleration<ContainerType>::solve(
 
 
         // update the QR decomposition to incorporate the new column.
-        // MW: This is modified Gram-Schmidt which delivers a reduced QR-factorization
-        for (unsigned j = 0; j < mAA; j++) {
-            m_R(j,mAA) = dg::blas2::dot(m_Q[j],weights,m_Q[mAA]);      //Q(:,j)’*Q(mAA); //Changed mAA -> mAA-1
-
-            dg::blas1::axpby(-m_R(j,mAA),m_Q[j],1.,m_Q[mAA]);  //m_Q[mAA] = Q(mAA) - R(j,mAA)*Q(:,j);
+        // Classical Gram-Schmidt with selective reorthogonalization: all
+        // projection coefficients refer to the same unmodified column such
+        // that the reductions can be batched into a single latency and the
+        // subtraction fused into one dense matrix-vector product. A second
+        // pass restores the orthogonality that modified Gram-Schmidt would
+        // deliver in the rare case of severe cancellation
+        dg::blas1::pointwiseDot( weights, m_Q[mAA], m_wf);
+        value_type nrm = sqrt( dg::blas1::dot( m_Q[mAA], m_wf));
+        for( unsigned j=0; j<mAA; j++)
+            m_R(j,mAA) = 0;
+        for( unsigned pass=0; pass<2 && mAA > 0; pass++)
+        {
+            detail::multi_dot( m_Q, m_wf, mAA, m_gamma.data());
+            dg::blas2::gemv( -1., dg::asDenseMatrix( dg::asPointers(m_Q), mAA),
+                std::vector<value_type>{m_gamma.begin(), m_gamma.begin()+mAA},
+                1., m_Q[mAA]);
+            for( unsigned j=0; j<mAA; j++)
+                m_R(j,mAA) += m_gamma[j];
+            dg::blas1::pointwiseDot( weights, m_Q[mAA], m_wf);
+            value_type nrm_new = sqrt( dg::blas1::dot( m_Q[mAA], m_wf));
+            bool orthogonal = nrm_new > nrm/sqrt(2.);
+            nrm = nrm_new;
+            if( orthogonal)
+                break;
         }
-        m_R(mAA,mAA) = sqrt(dg::blas2::dot(m_Q[mAA],weights,m_Q[mAA]));
+        m_R(mAA,mAA) = nrm;
         dg::blas1::scal(m_Q[mAA], 1./m_R(mAA,mAA));
 
         //Calculate condition number of R to figure whether to keep going or call QR delete to reduce Q and R.
         //value_type condDF = cond(R,mAA+1);
         //Here should be the check for whether to proceed.
 
-        //Solve least squares problem.
+        //Solve least squares problem. The projections of the residual onto
+        //the orthogonal columns are independent and batched as well
+        dg::blas1::pointwiseDot( weights, m_fval, m_wf);
+        detail::multi_dot( m_Q, m_wf, mAA+1, m_gamma.data());
         for(int i = (int)mAA; i>=0; i--){
-            m_gamma[i] = dg::blas2::dot(m_Q[i],weights,m_fval);
             for(int j = i + 1; j < (int)mAA+1; j++){
                 m_gamma[i] = DG_FMA( -m_R(i,j), m_gamma[j], m_gamma[i]) ;
             }
@@ -92,6 +92,15 @@ int main()
     std::cout << "Mean rhs*Jacobian is "<<res.d<<"\t"<<res.i-binary[1]<<"\n";
     res.d = dg::blas2::dot( lhs, w2d, jac);
     std::cout << "Mean lhs*Jacobian is "<<res.d<<"\t"<<res.i-binary[2]<<"\n";
+    //compute several brackets that share the lhs at once
+    dg::DVec jac2( jac), jac3( jac);
+    std::vector<const dg::DVec*> multi_rhs = {&rhs, &rhs};
+    std::vector<dg::DVec*> multi_jac = {&jac2, &jac3};
+    arakawa( 1., lhs, multi_rhs, 0., multi_jac);
+    dg::blas1::axpby( 1., jac, -1., jac2);
+    dg::blas1::axpby( 1., jac, -1., jac3);
+    res.d = sqrt( dg::blas2::dot( w2d, jac2)) + sqrt( dg::blas2::dot( w2d, jac3));
+    std::cout << "Multi bracket distance to bracket "<<res.d<<" (0)\n";
     dg::blas1::axpby( 1., sol, -1., jac);
     res.d = sqrt(dg::blas2::dot( w2d, jac)); //don't forget sqrt when computing errors
     std::cout << "Distance to solution "<<res.d<<"\t\t"<<res.i-binary[3]<<std::endl;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "config.h"
 #include "exblas/exdot_serial.h"
 #ifdef MPI_VERSION
 #include "exblas/mpi_accumulate.h"
@@ -23,6 +24,56 @@ void average( SerialTag, unsigned nx, unsigned ny, const value_type* in0, const
         out[i] = exblas::cpu::Round( &h_accumulator[i*exblas::BIN_COUNT]);
 }
 
+//segmented reduction over contiguous chunks for a batch of fields
+//(inexact "simple" summation), out must hold nf*ny elements
+template<class value_type>
+void segment_average( SerialTag, unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out)
+{
+    static_assert( std::is_same<value_type, double>::value, "Value type must be double!");
+    for( unsigned f=0; f<nf; f++)
+        for( unsigned i=0; i<ny; i++)
+        {
+            value_type sum = 0;
+            for( unsigned j=0; j<nx; j++)
+                sum = DG_FMA( in[f][i*nx+j], w[i*nx+j], sum);
+            out[f*ny+i] = sum;
+        }
+}
+
+//cache-oblivious transpose: recursively halve the larger dimension until a
+//tile fits comfortably in L1, then transpose the tile directly; this keeps
+//both the reads and the writes block-local on every level of the cache
+//hierarchy without machine specific tuning
+template<class value_type>
+void transpose_block( unsigned i0, unsigned i1, unsigned j0, unsigned j1,
+        unsigned nx, unsigned ny, const value_type* in, value_type* out)
+{
+    if( i1-i0 <= 32 && j1-j0 <= 32)
+    {
+        for( unsigned i=i0; i<i1; i++)
+            for( unsigned j=j0; j<j1; j++)
+                out[j*ny+i] = in[i*nx+j];
+    }
+    else if( i1-i0 > j1-j0)
+    {
+        unsigned im = i0 + (i1-i0)/2;
+        transpose_block( i0, im, j0, j1, nx, ny, in, out);
+        transpose_block( im, i1, j0, j1, nx, ny, in, out);
+    }
+    else
+    {
+        unsigned jm = j0 + (j1-j0)/2;
+        transpose_block( i0, i1, j0, jm, nx, ny, in, out);
+        transpose_block( i0, i1, jm, j1, nx, ny, in, out);
+    }
+}
+//out[j*ny+i] = in[i*nx+j]
+template<class value_type>
+void transpose( SerialTag, unsigned nx, unsigned ny, const value_type* in, value_type* out)
+{
+    transpose_block( 0, ny, 0, nx, nx, ny, in, out);
+}
+
 #ifdef MPI_VERSION
 //local data plus communication
 template<class value_type>
@@ -42,6 +93,14 @@ void average_mpi( SerialTag, unsigned nx, unsigned ny, const value_type* in0, co
     for( unsigned i=0; i<ny; i++)
         out[i] = exblas::cpu::Round( &h_accumulator[i*exblas::BIN_COUNT]);
 }
+
+//combine the reductions of all fields into a single MPI_Allreduce
+template<class value_type>
+void segment_average_mpi( SerialTag, unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out, MPI_Comm comm)
+{
+    segment_average( SerialTag(), nf, nx, ny, in, w, out);
+    MPI_Allreduce( MPI_IN_PLACE, out, nf*ny, MPI_DOUBLE, MPI_SUM, comm);
+}
 #endif //MPI_VERSION
 
 }//namespace dg
@@ -19,19 +19,21 @@ The equivalent of
  * @copydoc hide_ContainerType
  * @param nx number of columns in input vector (size of contiguous chunks) /rows in output vector
  * @param ny number of rows in input vector /columns in output vector
- * @param in input
- * @param out output (may not alias in)
+ * @param in input (may be a \c dg::View)
+ * @param out output (may not alias in, may be a \c dg::View)
+ * @note The implementation is blocked: on CPU the matrix is transposed in
+ * cache-oblivious tiles, on GPU through a shared memory tile such that both
+ * reads and writes are coalesced. The blocking parameters are compile-time
+ * constants, so no plan needs to be set up or cached for a given shape.
 */
-template<class ContainerType>
-void transpose( unsigned nx, unsigned ny, const ContainerType& in, ContainerType& out)
+template<class ContainerType0, class ContainerType1>
+void transpose( unsigned nx, unsigned ny, const ContainerType0& in, ContainerType1& out)
 {
-    assert(&in != &out);
-    using value_type = get_value_type<ContainerType>;
-    dg::blas2::parallel_for( [nx,ny]DG_DEVICE( unsigned k, const value_type* ii, value_type* oo)
-        {
-            unsigned i = k/nx, j =  k%nx;
-            oo[j*ny+i] = ii[i*nx+j];
-        }, nx*ny, in, out);
+    assert( (const void*)&in != (const void*)&out);
+    using value_type = get_value_type<ContainerType1>;
+    const value_type* in_ptr = thrust::raw_pointer_cast( in.data());
+          value_type* out_ptr = thrust::raw_pointer_cast( out.data());
+    transpose( get_execution_policy<ContainerType1>(), nx, ny, in_ptr, out_ptr);
 }
 
 /*!@brief Copy a line into rows of output vector
@@ -41,13 +43,13 @@ void transpose( unsigned nx, unsigned ny, const ContainerType& in, ContainerType
  * @param nx size of the input vector/ number of columns (size of contiguous chunks) in output vector
  * @param ny number of rows in output vector
  * @param in input (size \c nx)
- * @param out output (size \c nx*ny; may not alias in)
+ * @param out output (size \c nx*ny; may not alias in, may be a \c dg::View)
 */
-template<class ContainerType>
-void extend_line( unsigned nx, unsigned ny, const ContainerType& in, ContainerType& out)
+template<class ContainerType0, class ContainerType1>
+void extend_line( unsigned nx, unsigned ny, const ContainerType0& in, ContainerType1& out)
 {
-    assert(&in != &out);
-    using value_type = get_value_type<ContainerType>;
+    assert( (const void*)&in != (const void*)&out);
+    using value_type = get_value_type<ContainerType1>;
     dg::blas2::parallel_for( [nx]DG_DEVICE( unsigned k, const value_type* ii, value_type* oo)
         {
             unsigned i = k/nx, j =  k%nx;
@@ -61,13 +63,13 @@ void extend_line( unsigned nx, unsigned ny, const ContainerType& in, ContainerTy
  * @param nx number of columns (size of contiguous chunks) in output vector
  * @param ny size of input vector, number of rows in output vector
  * @param in input (size \c ny)
- * @param out output (size \c nx*ny may not alias in)
+ * @param out output (size \c nx*ny may not alias in, may be a \c dg::View)
 */
-template<class ContainerType>
-void extend_column( unsigned nx, unsigned ny, const ContainerType& in, ContainerType& out)
+template<class ContainerType0, class ContainerType1>
+void extend_column( unsigned nx, unsigned ny, const ContainerType0& in, ContainerType1& out)
 {
-    assert(&in != &out);
-    using value_type = get_value_type<ContainerType>;
+    assert( (const void*)&in != (const void*)&out);
+    using value_type = get_value_type<ContainerType1>;
     dg::blas2::parallel_for( [nx]DG_DEVICE( unsigned k, const value_type* ii, value_type* oo)
         {
             unsigned i = k/nx, j =  k%nx;
@@ -77,25 +79,45 @@ void extend_column( unsigned nx, unsigned ny, const ContainerType& in, Container
 ///@}
 
 ///@cond
-template<class ContainerType>
-void average( unsigned nx, unsigned ny, const ContainerType& in0, const ContainerType& in1, ContainerType& out)
+template<class ContainerType0, class ContainerType1, class ContainerType2>
+void average( unsigned nx, unsigned ny, const ContainerType0& in0, const ContainerType1& in1, ContainerType2& out)
 {
-    static_assert( std::is_same<get_value_type<ContainerType>, double>::value, "We only support double precision dot products at the moment!");
+    static_assert( std::is_same<get_value_type<ContainerType0>, double>::value, "We only support double precision dot products at the moment!");
     const double* in0_ptr = thrust::raw_pointer_cast( in0.data());
     const double* in1_ptr = thrust::raw_pointer_cast( in1.data());
           double* out_ptr = thrust::raw_pointer_cast( out.data());
-    average( get_execution_policy<ContainerType>(), nx, ny, in0_ptr, in1_ptr, out_ptr);
+    average( get_execution_policy<ContainerType1>(), nx, ny, in0_ptr, in1_ptr, out_ptr);
+}
+
+template<class ContainerType0, class ContainerType1, class ContainerType2>
+void segment_average( unsigned nx, unsigned ny, const ContainerType0& in, const ContainerType1& w, ContainerType2& out)
+{
+    static_assert( std::is_same<get_value_type<ContainerType0>, double>::value, "We only support double precision at the moment!");
+    const double* in_ptr = thrust::raw_pointer_cast( in.data());
+    const double* w_ptr  = thrust::raw_pointer_cast( w.data());
+          double* out_ptr = thrust::raw_pointer_cast( out.data());
+    segment_average( get_execution_policy<ContainerType1>(), 1u, nx, ny, &in_ptr, w_ptr, out_ptr);
 }
 
 #ifdef MPI_VERSION
-template<class ContainerType>
-void mpi_average( unsigned nx, unsigned ny, const ContainerType& in0, const ContainerType& in1, ContainerType& out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce)
+template<class ContainerType0, class ContainerType1, class ContainerType2>
+void mpi_average( unsigned nx, unsigned ny, const ContainerType0& in0, const ContainerType1& in1, ContainerType2& out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce)
 {
-    static_assert( std::is_same<get_value_type<ContainerType>, double>::value, "We only support double precision dot products at the moment!");
+    static_assert( std::is_same<get_value_type<ContainerType0>, double>::value, "We only support double precision dot products at the moment!");
     const double* in0_ptr = thrust::raw_pointer_cast( in0.data());
     const double* in1_ptr = thrust::raw_pointer_cast( in1.data());
           double* out_ptr = thrust::raw_pointer_cast( out.data());
-    average_mpi( get_execution_policy<ContainerType>(), nx, ny, in0_ptr, in1_ptr, out_ptr, comm, comm_mod, comm_mod_reduce);
+    average_mpi( get_execution_policy<ContainerType1>(), nx, ny, in0_ptr, in1_ptr, out_ptr, comm, comm_mod, comm_mod_reduce);
+}
+
+template<class ContainerType0, class ContainerType1, class ContainerType2>
+void segment_average_mpi( unsigned nx, unsigned ny, const ContainerType0& in, const ContainerType1& w, ContainerType2& out, MPI_Comm comm)
+{
+    static_assert( std::is_same<get_value_type<ContainerType0>, double>::value, "We only support double precision at the moment!");
+    const double* in_ptr = thrust::raw_pointer_cast( in.data());
+    const double* w_ptr  = thrust::raw_pointer_cast( w.data());
+          double* out_ptr = thrust::raw_pointer_cast( out.data());
+    segment_average_mpi( get_execution_policy<ContainerType1>(), 1u, nx, ny, &in_ptr, w_ptr, out_ptr, comm);
 }
 #endif //MPI_VERSION
 ///@endcond
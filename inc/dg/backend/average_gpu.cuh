@@ -37,6 +37,77 @@ void average( CudaTag, unsigned nx, unsigned ny, const value_type* in0, const va
         throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
 }
 
+//one block per segment, block-wide tree reduction in shared memory
+template<class value_type>
+ __global__ void segment_average_kernel( unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out)
+{
+    __shared__ value_type sdata[256];
+    const unsigned seg = blockIdx.x;
+    if( seg >= nf*ny)
+        return;
+    const value_type* in_ptr = in[seg/ny] + (seg%ny)*nx;
+    const value_type* w_ptr  = w          + (seg%ny)*nx;
+    value_type sum = 0;
+    for( unsigned j=threadIdx.x; j<nx; j+=blockDim.x)
+        sum = fma( in_ptr[j], w_ptr[j], sum);
+    sdata[threadIdx.x] = sum;
+    __syncthreads();
+    for( unsigned s=blockDim.x/2; s>0; s>>=1)
+    {
+        if( threadIdx.x < s)
+            sdata[threadIdx.x] += sdata[threadIdx.x+s];
+        __syncthreads();
+    }
+    if( threadIdx.x == 0)
+        out[seg] = sdata[0];
+}
+
+//segmented reduction over contiguous chunks for a batch of fields
+//(inexact "simple" summation), in holds nf host pointers to device data,
+//out must hold nf*ny elements in device memory
+template<class value_type>
+void segment_average( CudaTag, unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out)
+{
+    static_assert( std::is_same<value_type, double>::value, "Value type must be double!");
+    static thrust::device_vector<const value_type*> d_in;
+    d_in.assign( in, in+nf);
+    segment_average_kernel<value_type><<<nf*ny, 256>>>( nf, nx, ny,
+        thrust::raw_pointer_cast( d_in.data()), w, out);
+    cudaError_t code = cudaGetLastError( );
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+}
+
+//transpose a 32x32 tile through (padded) shared memory so that both the
+//reads and the writes are coalesced
+template<class value_type>
+ __global__ void transpose_kernel( unsigned nx, unsigned ny, const value_type* in, value_type* out)
+{
+    __shared__ value_type tile[32][33];
+    unsigned j = blockIdx.x*32 + threadIdx.x;
+    unsigned i = blockIdx.y*32 + threadIdx.y;
+    for( unsigned k=0; k<32; k+=8)
+        if( j < nx && i+k < ny)
+            tile[threadIdx.y+k][threadIdx.x] = in[(i+k)*nx+j];
+    __syncthreads();
+    j = blockIdx.y*32 + threadIdx.x;
+    i = blockIdx.x*32 + threadIdx.y;
+    for( unsigned k=0; k<32; k+=8)
+        if( j < ny && i+k < nx)
+            out[(i+k)*ny+j] = tile[threadIdx.x][threadIdx.y+k];
+}
+
+//out[j*ny+i] = in[i*nx+j]
+template<class value_type>
+void transpose( CudaTag, unsigned nx, unsigned ny, const value_type* in, value_type* out)
+{
+    dim3 grid( (nx+31)/32, (ny+31)/32), block( 32, 8);
+    transpose_kernel<value_type><<<grid, block>>>( nx, ny, in, out);
+    cudaError_t code = cudaGetLastError( );
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+}
+
 #ifdef MPI_VERSION
 //local data plus communication
 template<class value_type>
@@ -71,6 +142,22 @@ void average_mpi( CudaTag, unsigned nx, unsigned ny, const value_type* in0, cons
     if( code != cudaSuccess)
         throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
 }
+
+//combine the reductions of all fields into a single MPI_Allreduce
+template<class value_type>
+void segment_average_mpi( CudaTag, unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out, MPI_Comm comm)
+{
+    segment_average( CudaTag(), nf, nx, ny, in, w, out);
+    static thrust::host_vector<value_type> send_buf;
+    send_buf.resize( nf*ny);
+    cudaError_t code = cudaMemcpy( &send_buf[0], out, nf*ny*sizeof(value_type), cudaMemcpyDeviceToHost);
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    MPI_Allreduce( MPI_IN_PLACE, &send_buf[0], nf*ny, MPI_DOUBLE, MPI_SUM, comm);
+    code = cudaMemcpy( out, &send_buf[0], nf*ny*sizeof(value_type), cudaMemcpyHostToDevice);
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+}
 #endif //MPI_VERSION
 
 }//namespace dg
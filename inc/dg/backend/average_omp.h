@@ -24,6 +24,42 @@ void average( OmpTag, unsigned nx, unsigned ny, const value_type* in0, const val
         out[i] = exblas::cpu::Round( &h_accumulator[i*exblas::BIN_COUNT]);
 }
 
+//segmented reduction over contiguous chunks for a batch of fields
+//(inexact "simple" summation), out must hold nf*ny elements
+template<class value_type>
+void segment_average( OmpTag, unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out)
+{
+    static_assert( std::is_same<value_type, double>::value, "Value type must be double!");
+    #pragma omp parallel for collapse(2)
+    for( unsigned f=0; f<nf; f++)
+        for( unsigned i=0; i<ny; i++)
+        {
+            value_type sum = 0;
+            for( unsigned j=0; j<nx; j++)
+                sum = DG_FMA( in[f][i*nx+j], w[i*nx+j], sum);
+            out[f*ny+i] = sum;
+        }
+}
+
+//out[j*ny+i] = in[i*nx+j]; the tiles are distributed among the threads and
+//each tile is transposed within the cache of its thread
+template<class value_type>
+void transpose( OmpTag, unsigned nx, unsigned ny, const value_type* in, value_type* out)
+{
+    constexpr unsigned tile = 32;
+    const unsigned nti = (ny+tile-1)/tile, ntj = (nx+tile-1)/tile;
+    #pragma omp parallel for collapse(2)
+    for( unsigned ti=0; ti<nti; ti++)
+        for( unsigned tj=0; tj<ntj; tj++)
+        {
+            const unsigned i1 = (ti+1)*tile < ny ? (ti+1)*tile : ny;
+            const unsigned j1 = (tj+1)*tile < nx ? (tj+1)*tile : nx;
+            for( unsigned i=ti*tile; i<i1; i++)
+                for( unsigned j=tj*tile; j<j1; j++)
+                    out[j*ny+i] = in[i*nx+j];
+        }
+}
+
 #ifdef MPI_VERSION
 //local data plus communication
 template<class value_type>
@@ -43,6 +79,14 @@ void average_mpi( OmpTag, unsigned nx, unsigned ny, const value_type* in0, const
     for( unsigned i=0; i<ny; i++)
         out[i] = exblas::cpu::Round( &h_accumulator[i*exblas::BIN_COUNT]);
 }
+
+//combine the reductions of all fields into a single MPI_Allreduce
+template<class value_type>
+void segment_average_mpi( OmpTag, unsigned nf, unsigned nx, unsigned ny, const value_type* const* in, const value_type* w, value_type* out, MPI_Comm comm)
+{
+    segment_average( OmpTag(), nf, nx, ny, in, w, out);
+    MPI_Allreduce( MPI_IN_PLACE, out, nf*ny, MPI_DOUBLE, MPI_SUM, comm);
+}
 #endif //MPI_VERSION
 
 }//namespace dg
@@ -1,6 +1,7 @@
 #ifndef _DG_BLAS_CUDA_
 #define _DG_BLAS_CUDA_
 #include <thrust/transform_reduce.h>
+#include <thrust/inner_product.h>
 #include <thrust/system/cuda/execution_policy.h>
 #include "exceptions.h"
 #include "exblas/exdot_cuda.cuh"
@@ -14,11 +15,12 @@ namespace detail
 template<class PointerOrValue1, class PointerOrValue2>
 inline std::vector<int64_t> doDot_dispatch( CudaTag, unsigned size, PointerOrValue1 x_ptr, PointerOrValue2 y_ptr) {
     static thrust::device_vector<int64_t> d_superacc(exblas::BIN_COUNT);
+    static thrust::device_vector<bool> d_errorV(1, false);
     int64_t * d_ptr = thrust::raw_pointer_cast( d_superacc.data());
-    int status = 0;
-    exblas::exdot_gpu( size, x_ptr,y_ptr, d_ptr, &status );
-    if( status != 0)
-        throw dg::Error(dg::Message(_ping_)<<"GPU Dot product failed since one of the inputs contains NaN or Inf");
+    d_errorV[0] = false;
+    //the deferred error flag avoids a device synchronization inside exdot_gpu
+    exblas::exdot_gpu( size, x_ptr,y_ptr, d_ptr,
+            thrust::raw_pointer_cast( d_errorV.data()) );
     std::vector<int64_t> h_superacc(exblas::BIN_COUNT);
     // This test checks for errors in the current stream, the error may come
     // from any kernel prior to this point not necessarily the above one
@@ -29,16 +31,19 @@ inline std::vector<int64_t> doDot_dispatch( CudaTag, unsigned size, PointerOrVal
             exblas::BIN_COUNT*sizeof(int64_t), cudaMemcpyDeviceToHost);
     if( code != cudaSuccess)
         throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    if( d_errorV[0])
+        throw dg::Error(dg::Message(_ping_)<<"GPU Dot product failed since one of the inputs contains NaN or Inf");
     return h_superacc;
 }
 template<class PointerOrValue1, class PointerOrValue2, class PointerOrValue3>
 inline std::vector<int64_t> doDot_dispatch( CudaTag, unsigned size, PointerOrValue1 x_ptr, PointerOrValue2 y_ptr, PointerOrValue3 z_ptr) {
     static thrust::device_vector<int64_t> d_superacc(exblas::BIN_COUNT);
+    static thrust::device_vector<bool> d_errorV(1, false);
     int64_t * d_ptr = thrust::raw_pointer_cast( d_superacc.data());
-    int status = 0;
-    exblas::exdot_gpu( size, x_ptr,y_ptr,z_ptr, d_ptr, &status);
-    if( status != 0)
-        throw dg::Error(dg::Message(_ping_)<<"GPU Dot product failed since one of the inputs contains NaN or Inf");
+    d_errorV[0] = false;
+    //the deferred error flag avoids a device synchronization inside exdot_gpu
+    exblas::exdot_gpu( size, x_ptr,y_ptr,z_ptr, d_ptr,
+            thrust::raw_pointer_cast( d_errorV.data()) );
     std::vector<int64_t> h_superacc(exblas::BIN_COUNT);
     // This test checks for errors in the current stream, the error may come
     // from any kernel prior to this point not necessarily the above one
@@ -48,9 +53,90 @@ inline std::vector<int64_t> doDot_dispatch( CudaTag, unsigned size, PointerOrVal
     code = cudaMemcpy( &h_superacc[0], d_ptr, exblas::BIN_COUNT*sizeof(int64_t), cudaMemcpyDeviceToHost);
     if( code != cudaSuccess)
         throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    if( d_errorV[0])
+        throw dg::Error(dg::Message(_ping_)<<"GPU Dot product failed since one of the inputs contains NaN or Inf");
     return h_superacc;
 }
 
+//one thread per superaccumulator suffices for the few dot products of a batch
+template<class T>
+ __global__ void round_superacc_kernel( int64_t* accs, T* results, unsigned num)
+{
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    if( thread_id < (int)num)
+        results[thread_id] = (T)exblas::gpu::Round( &accs[thread_id*exblas::BIN_COUNT]);
+}
+
+template<class T, std::size_t N, class PointerOrValue1, class PointerOrValue2>
+inline std::array<T, N> doDot_batched_dispatch( CudaTag, const std::array<unsigned, N>& sizes, const std::array<PointerOrValue1, N>& x_ptrs, const std::array<PointerOrValue2, N>& y_ptrs)
+{
+    static thrust::device_vector<int64_t> d_superacc( N*exblas::BIN_COUNT);
+    static thrust::device_vector<T> d_result( N);
+    static thrust::device_vector<bool> d_errorV( 1, false);
+    int64_t * d_ptr = thrust::raw_pointer_cast( d_superacc.data());
+    bool * d_error = thrust::raw_pointer_cast( d_errorV.data());
+    d_errorV[0] = false;
+    //submit all reductions back-to-back; the stream serializes their access
+    //to the static partial superaccumulators inside exdot_gpu
+    for( unsigned i=0; i<N; i++)
+        exblas::exdot_gpu( sizes[i], x_ptrs[i], y_ptrs[i],
+                d_ptr + i*exblas::BIN_COUNT, d_error);
+    //round on the device such that a single transfer fetches all results
+    round_superacc_kernel<T><<<1, N>>>( d_ptr,
+            thrust::raw_pointer_cast( d_result.data()), N);
+    cudaError_t code = cudaGetLastError( );
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    std::array<T, N> result;
+    //the only synchronization of the batch
+    code = cudaMemcpy( &result[0], thrust::raw_pointer_cast( d_result.data()),
+            N*sizeof(T), cudaMemcpyDeviceToHost);
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    if( d_errorV[0])
+        throw dg::Error(dg::Message(_ping_)<<"GPU Dot product failed since one of the inputs contains NaN or Inf");
+    return result;
+}
+//runtime sized batch (e.g. a registered diagnostics list); the scratch
+//buffers grow to the largest batch ever taken and are then reused
+template<class T, class PointerOrValue1, class PointerOrValue2>
+inline std::vector<T> doDot_batched_dispatch( CudaTag, const std::vector<unsigned>& sizes, const std::vector<PointerOrValue1>& x_ptrs, const std::vector<PointerOrValue2>& y_ptrs)
+{
+    unsigned num = sizes.size();
+    if( num == 0)
+        return {};
+    static thrust::device_vector<int64_t> d_superacc;
+    static thrust::device_vector<T> d_result;
+    static thrust::device_vector<bool> d_errorV( 1, false);
+    if( d_superacc.size() < num*exblas::BIN_COUNT)
+        d_superacc.resize( num*exblas::BIN_COUNT);
+    if( d_result.size() < num)
+        d_result.resize( num);
+    int64_t * d_ptr = thrust::raw_pointer_cast( d_superacc.data());
+    bool * d_error = thrust::raw_pointer_cast( d_errorV.data());
+    d_errorV[0] = false;
+    //submit all reductions back-to-back; the stream serializes their access
+    //to the static partial superaccumulators inside exdot_gpu
+    for( unsigned i=0; i<num; i++)
+        exblas::exdot_gpu( sizes[i], x_ptrs[i], y_ptrs[i],
+                d_ptr + i*exblas::BIN_COUNT, d_error);
+    //round on the device such that a single transfer fetches all results
+    round_superacc_kernel<T><<<(num-1)/256+1, 256>>>( d_ptr,
+            thrust::raw_pointer_cast( d_result.data()), num);
+    cudaError_t code = cudaGetLastError( );
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    std::vector<T> result( num);
+    //the only synchronization of the batch
+    code = cudaMemcpy( &result[0], thrust::raw_pointer_cast( d_result.data()),
+            num*sizeof(T), cudaMemcpyDeviceToHost);
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    if( d_errorV[0])
+        throw dg::Error(dg::Message(_ping_)<<"GPU Dot product failed since one of the inputs contains NaN or Inf");
+    return result;
+}
+
 template<class T>
 __device__
 inline T get_device_element( T x, int i){
@@ -90,6 +176,15 @@ inline T doReduce_dispatch( CudaTag, int size, Pointer x, T init, BinaryOp op,
             init, op);
 }
 
+template<class T, class Pointer1, class Pointer2, class BinaryOp, class
+    BinaryTransform>
+inline T doReduce_dispatch( CudaTag, int size, Pointer1 x, Pointer2 y, T init,
+        BinaryOp op, BinaryTransform binary_transform)
+{
+    return thrust::inner_product(thrust::cuda::par, x, x+size, y, init, op,
+            binary_transform);
+}
+
 
 }//namespace detail
 }//namespace blas1
@@ -62,8 +62,10 @@ void mpi_assert( const Vector1& x, const Vector2&y)
     do_mpi_assert( x,y, get_tensor_category<Vector1>(), get_tensor_category<Vector2>());
 }
 
+//local superaccumulator plus the communicators for the global reduction
 template< class Vector1, class Vector2>
-std::vector<int64_t> doDot_superacc( const Vector1& x, const Vector2& y, MPIVectorTag)
+std::vector<int64_t> doDot_local_superacc( const Vector1& x, const Vector2& y,
+    MPI_Comm& comm, MPI_Comm& comm_mod, MPI_Comm& comm_mod_reduce)
 {
     //find out which one is the MPIVector and determine category
     constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar, Vector1, Vector1, Vector2>::value;
@@ -74,11 +76,19 @@ std::vector<int64_t> doDot_superacc( const Vector1& x, const Vector2& y, MPIVect
     std::vector<int64_t> acc = doDot_superacc(
         do_get_data(x,get_tensor_category<Vector1>()),
         do_get_data(y,get_tensor_category<Vector2>()));
-    std::vector<int64_t> receive(exblas::BIN_COUNT, (int64_t)0);
     //get communicator from MPIVector
-    auto comm = get_idx<vector_idx>(x,y).communicator();
-    auto comm_mod = get_idx<vector_idx>(x,y).communicator_mod();
-    auto comm_red = get_idx<vector_idx>(x,y).communicator_mod_reduce();
+    comm = get_idx<vector_idx>(x,y).communicator();
+    comm_mod = get_idx<vector_idx>(x,y).communicator_mod();
+    comm_mod_reduce = get_idx<vector_idx>(x,y).communicator_mod_reduce();
+    return acc;
+}
+
+template< class Vector1, class Vector2>
+std::vector<int64_t> doDot_superacc( const Vector1& x, const Vector2& y, MPIVectorTag)
+{
+    MPI_Comm comm, comm_mod, comm_red;
+    std::vector<int64_t> acc = doDot_local_superacc( x, y, comm, comm_mod, comm_red);
+    std::vector<int64_t> receive(exblas::BIN_COUNT, (int64_t)0);
     exblas::reduce_mpi_cpu( 1, acc.data(), receive.data(), comm, comm_mod, comm_red);
     return receive;
 }
@@ -112,6 +122,27 @@ inline T doReduce( MPIVectorTag, const ContainerType& x, T zero, BinaryOp op,
     return result;
 }
 
+template<class T, class ContainerType1, class ContainerType2, class BinaryOp,
+    class BinaryTransform>
+inline T doReduce( MPIVectorTag, const ContainerType1& x, const ContainerType2&
+        y, T zero, BinaryOp op, BinaryTransform binary_transform)
+{
+    T result = doReduce( get_tensor_category<decltype( x.data())>(), x.data(),
+            y.data(), zero, op, binary_transform);
+    //now do the MPI reduction
+    int size;
+    MPI_Comm_size( x.communicator(), &size);
+    thrust::host_vector<T> reduction( size);
+    MPI_Allgather( &result, 1, getMPIDataType<T>(),
+            thrust::raw_pointer_cast(reduction.data()), 1, getMPIDataType<T>(),
+            x.communicator());
+    //reduce received data (serial execution)
+    result = zero;
+    for ( unsigned u=0; u<(unsigned)size; u++)
+        result = op( result, reduction[u]);
+    return result;
+}
+
 } //namespace detail
 } //namespace blas1
 } //namespace dg
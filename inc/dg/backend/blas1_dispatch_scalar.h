@@ -60,6 +60,15 @@ inline T doReduce( AnyScalarTag, ContainerType x, T init, BinaryOp op, UnaryOp
     return init;
 }
 
+template<class T, class ContainerType1, class ContainerType2, class BinaryOp,
+    class BinaryTransform>
+inline T doReduce( AnyScalarTag, ContainerType1 x, ContainerType2 y, T init,
+        BinaryOp op, BinaryTransform binary_transform)
+{
+    init = op( init, binary_transform(x, y));
+    return init;
+}
+
 
 } //namespace detail
 } //namespace blas1
@@ -8,6 +8,7 @@
 #include "scalar_categories.h"
 #include "tensor_traits.h"
 #include "predicate.h"
+#include "perf.h"
 
 #include "blas1_serial.h"
 #if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
@@ -72,6 +73,8 @@ std::vector<int64_t> doDot_superacc( const Vector1& x, const Vector2& y, SharedV
         "All ContainerType types must have compatible execution policies (AnyPolicy or Same)!");
     //maybe assert size here?
     auto size = get_idx<vector_idx>(x,y).size();
+    //2 reads per element, 1 multiply-add per element
+    DG_PERF_SAMPLE( "blas1::dot", 2.*size*sizeof(double), 2.*size);
     return dg::blas1::detail::doDot_dispatch( execution_policy(), size,
             do_get_pointer_or_reference(x, get_tensor_category<Vector1>()),
             do_get_pointer_or_reference(y, get_tensor_category<Vector2>()));
@@ -89,6 +92,16 @@ inline void doSubroutine( SharedVectorTag, Subroutine f, ContainerType&& x, Cont
             >::value,
         "All ContainerType types must have compatible execution policies (AnyPolicy or Same)!");
     constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar_has_not_any_policy, get_value_type<ContainerType>, ContainerType, ContainerTypes...>::value;
+#ifdef DG_PERF_COUNT
+    //one read or write per element per vector argument (scalars are free)
+    constexpr int is_vec[] = { (int)dg::is_not_scalar<ContainerType>::value,
+        (int)dg::is_not_scalar<ContainerTypes>::value...};
+    double num_vecs = 0;
+    for( int b : is_vec)
+        num_vecs += b;
+    double size = get_idx<vector_idx>( x, xs...).size();
+#endif //DG_PERF_COUNT
+    DG_PERF_SAMPLE( "blas1::subroutine", num_vecs*size*sizeof(get_value_type<vector_type>), 0.);
     doSubroutine_dispatch(
             get_execution_policy<vector_type>(),
             get_idx<vector_idx>( std::forward<ContainerType>(x), std::forward<ContainerTypes>(xs)...).size(),
@@ -105,6 +118,16 @@ inline T doReduce( SharedVectorTag, const ContainerType& x, T init, BinaryOp op,
             thrust::raw_pointer_cast( x.data()), init, op, unary_op);
 }
 
+template<class T, class ContainerType1, class ContainerType2, class BinaryOp,
+    class BinaryTransform>
+inline T doReduce( SharedVectorTag, const ContainerType1& x, const
+        ContainerType2& y, T init, BinaryOp op, BinaryTransform binary_transform)
+{
+    return doReduce_dispatch( get_execution_policy<ContainerType1>(), x.size(),
+            thrust::raw_pointer_cast( x.data()),
+            thrust::raw_pointer_cast( y.data()), init, op, binary_transform);
+}
+
 } //namespace detail
 } //namespace blas1
 } //namespace dg
@@ -210,6 +210,18 @@ inline T doReduce( RecursiveVectorTag, const ContainerType& x, T init, BinaryOp
     return init;
 }
 
+template<class T, class ContainerType1, class ContainerType2, class BinaryOp,
+    class BinaryTransform>
+inline T doReduce( RecursiveVectorTag, const ContainerType1& x, const
+        ContainerType2& y, T init, BinaryOp op, BinaryTransform binary_transform)
+{
+    //reduce sequentially recursively
+    for ( unsigned u=0; u<x.size(); u++)
+        init = doReduce( get_tensor_category<decltype( x[u])>(), x[u], y[u],
+                init, op, binary_transform);
+    return init;
+}
+
 } //namespace detail
 } //namespace blas1
 } //namespace dg
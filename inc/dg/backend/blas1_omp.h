@@ -2,6 +2,7 @@
 #define _DG_BLAS_OMP_
 #include <omp.h>
 #include <thrust/transform_reduce.h>
+#include <thrust/inner_product.h>
 #include <thrust/system/omp/execution_policy.h>
 #include "config.h"
 #include "blas1_serial.h"
@@ -39,10 +40,42 @@ inline std::vector<int64_t> doDot_dispatch( OmpTag, unsigned size, PointerOrValu
     return h_superacc;
 }
 
+template<class T, std::size_t N, class PointerOrValue1, class PointerOrValue2>
+inline std::array<T, N> doDot_batched_dispatch( OmpTag, const std::array<unsigned, N>& sizes, const std::array<PointerOrValue1, N>& x_ptrs, const std::array<PointerOrValue2, N>& y_ptrs)
+{
+    std::array<T, N> result;
+    for( unsigned i=0; i<N; i++)
+    {
+        std::vector<int64_t> acc = doDot_dispatch( OmpTag(), sizes[i],
+                x_ptrs[i], y_ptrs[i]);
+        result[i] = (T)exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+//runtime sized batch (e.g. a registered diagnostics list)
+template<class T, class PointerOrValue1, class PointerOrValue2>
+inline std::vector<T> doDot_batched_dispatch( OmpTag, const std::vector<unsigned>& sizes, const std::vector<PointerOrValue1>& x_ptrs, const std::vector<PointerOrValue2>& y_ptrs)
+{
+    std::vector<T> result( sizes.size());
+    for( unsigned i=0; i<sizes.size(); i++)
+    {
+        std::vector<int64_t> acc = doDot_dispatch( OmpTag(), sizes[i],
+                x_ptrs[i], y_ptrs[i]);
+        result[i] = (T)exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+
 template< class Subroutine, class PointerOrValue, class ...PointerOrValues>
 inline void doSubroutine_omp( int size, Subroutine f, PointerOrValue x, PointerOrValues... xs)
 {
-#pragma omp for nowait
+//the simd directive vectorizes the inlined functor where the compiler's
+//cost model bails out on its own (e.g. the trinary pointwiseDot functors);
+//the explicit static schedule pins the (otherwise implementation defined)
+//partition to the contiguous blocks of dg::detail::omp_block_range so that
+//every thread works on the pages it first touched (NUMA locality, see
+//dg::first_touch)
+#pragma omp for SIMD nowait schedule(static)
     for( int i=0; i<size; i++)
         //f(x[i], xs[i]...);
         //f(thrust::raw_reference_cast(*(x+i)), thrust::raw_reference_cast(*(xs+i))...);
@@ -59,7 +92,7 @@ inline void doSubroutine_dispatch( OmpTag, int size, Subroutine f, PointerOrValu
     }
     if(size>MIN_SIZE)
     {
-        #pragma omp parallel
+        #pragma omp parallel num_threads( dg::detail::omp_team_size( size))
         {
             doSubroutine_omp( size, f, x, xs...);
         }
@@ -75,6 +108,15 @@ inline T doReduce_dispatch( OmpTag, int size, Pointer x, T init, BinaryOp op,
     return thrust::transform_reduce(thrust::omp::par, x, x+size, unary_op, init, op);
 }
 
+template<class T, class Pointer1, class Pointer2, class BinaryOp, class
+    BinaryTransform>
+inline T doReduce_dispatch( OmpTag, int size, Pointer1 x, Pointer2 y, T init,
+        BinaryOp op, BinaryTransform binary_transform)
+{
+    return thrust::inner_product(thrust::omp::par, x, x+size, y, init, op,
+            binary_transform);
+}
+
 }//namespace detail
 }//namespace blas1
 }//namespace dg
@@ -1,5 +1,6 @@
 #ifndef _DG_BLAS_SERIAL_
 #define _DG_BLAS_SERIAL_
+#include <array>
 #include "config.h"
 #include "exceptions.h"
 #include "execution_policy.h"
@@ -30,6 +31,32 @@ inline std::vector<int64_t> doDot_dispatch( SerialTag, unsigned size, PointerOrV
     return h_superacc;
 }
 
+template<class T, std::size_t N, class PointerOrValue1, class PointerOrValue2>
+inline std::array<T, N> doDot_batched_dispatch( SerialTag, const std::array<unsigned, N>& sizes, const std::array<PointerOrValue1, N>& x_ptrs, const std::array<PointerOrValue2, N>& y_ptrs)
+{
+    std::array<T, N> result;
+    for( unsigned i=0; i<N; i++)
+    {
+        std::vector<int64_t> acc = doDot_dispatch( SerialTag(), sizes[i],
+                x_ptrs[i], y_ptrs[i]);
+        result[i] = (T)exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+//runtime sized batch (e.g. a registered diagnostics list)
+template<class T, class PointerOrValue1, class PointerOrValue2>
+inline std::vector<T> doDot_batched_dispatch( SerialTag, const std::vector<unsigned>& sizes, const std::vector<PointerOrValue1>& x_ptrs, const std::vector<PointerOrValue2>& y_ptrs)
+{
+    std::vector<T> result( sizes.size());
+    for( unsigned i=0; i<sizes.size(); i++)
+    {
+        std::vector<int64_t> acc = doDot_dispatch( SerialTag(), sizes[i],
+                x_ptrs[i], y_ptrs[i]);
+        result[i] = (T)exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+
 template<class T>
 inline T get_element( T x, int i){
 	return x;
@@ -58,6 +85,16 @@ inline T doReduce_dispatch( SerialTag, int size, Pointer x, T init, BinaryOp
     return init;
 }
 
+template<class T, class Pointer1, class Pointer2, class BinaryOp, class
+    BinaryTransform>
+inline T doReduce_dispatch( SerialTag, int size, Pointer1 x, Pointer2 y, T
+        init, BinaryOp op, BinaryTransform binary_transform)
+{
+    for(int i=0; i<size; i++)
+        init = op( init, binary_transform(x[i], y[i]));
+    return init;
+}
+
 
 }//namespace detail
 }//namespace blas1
@@ -9,6 +9,7 @@
 
 #include "exceptions.h"
 #include "config.h"
+#include "predicate.h"
 #include "tensor_traits.h"
 
 ///@cond
@@ -118,55 +119,53 @@ inline void doSymv( Matrix&& m,
         doSymv( std::forward<Matrix>(m), x[i], y[i], CuspMatrixTag(), get_tensor_category<inner_container>());
 }
 
-template<class Functor, class Matrix, class Vector1, class Vector2>
+template<class Functor, class Matrix, class Vector1, class ...Vectors>
 inline void doStencil(
+                    CuspMatrixTag,
+                    SharedVectorTag,
                     Functor f,
                     Matrix&& m,
                     const Vector1&x,
-                    Vector2& y,
-                    CuspMatrixTag,
-                    SharedVectorTag  )
+                    Vectors&&... ys)
 {
-    static_assert( std::is_base_of<SharedVectorTag, get_tensor_category<Vector2>>::value,
+    static_assert( all_true< std::is_base_of<SharedVectorTag,
+            get_tensor_category<Vectors>>::value...>::value,
         "All data layouts must derive from the same vector category (SharedVectorTag in this case)!");
-    static_assert( std::is_same< get_execution_policy<Vector1>, get_execution_policy<Vector2> >::value, "Execution policies must be equal!");
+    static_assert( all_true< std::is_same< get_execution_policy<Vector1>,
+            get_execution_policy<Vectors> >::value...>::value,
+            "Execution policies must be equal!");
     typedef typename std::decay_t<Matrix>::value_type value_type;
     static_assert( std::is_same< get_value_type<Vector1>, value_type >::value,
         "Value types must be equal"
     );
-    static_assert( std::is_same< get_value_type<Vector2>, value_type >::value,
+    static_assert( all_true< std::is_same< get_value_type<Vectors>,
+            value_type >::value...>::value,
         "Value types must be equal"
     );
 
     if( x.size() != m.num_cols) {
         throw Error( Message(_ping_)<<"x has the wrong size "<<x.size()<<" Number of columns is "<<m.num_cols);
     }
-    if( y.size() != m.num_rows) {
-        throw Error( Message(_ping_)<<"y has the wrong size "<<y.size()<<" Number of rows is "<<m.num_rows);
-    }
-    dg::blas2::parallel_for( f, m.num_rows, m.row_offsets, m.column_indices, m.values, x, y);
+    //the additional arguments are only accessed at the row index, so their
+    //sizes are only checked against the number of rows inside parallel_for
+    dg::blas2::parallel_for( f, m.num_rows, m.row_offsets, m.column_indices, m.values, x, std::forward<Vectors>(ys)...);
 }
-template< class Functor, class Matrix, class Vector1, class Vector2>
-inline void doSymv( get_value_type<Vector1> alpha,
+template< class Functor, class Matrix, class Vector1, class ...Vectors>
+inline void doStencil(
+                    CuspMatrixTag,
+                    RecursiveVectorTag,
                     Functor f,
                     Matrix&& m,
                     const Vector1&x,
-                    get_value_type<Vector1> beta,
-                    Vector2& y,
-                    CuspMatrixTag,
-                    RecursiveVectorTag  )
+                    Vectors&&... ys)
 {
-    static_assert( std::is_base_of<RecursiveVectorTag, get_tensor_category<Vector2>>::value,
+    static_assert( all_true< std::is_base_of<RecursiveVectorTag,
+            get_tensor_category<Vectors>>::value...>::value,
         "All data layouts must derive from the same vector category (RecursiveVectorTag in this case)!");
-    if( x.size() != m.num_cols) {
-        throw Error( Message(_ping_)<<"x has the wrong size "<<x.size()<<" Number of columns is "<<m.num_cols);
-    }
-    if( y.size() != m.num_rows) {
-        throw Error( Message(_ping_)<<"y has the wrong size "<<y.size()<<" Number of rows is "<<m.num_rows);
-    }
     using inner_container = typename std::decay_t<Vector1>::value_type;
     for ( unsigned i=0; i<x.size(); i++)
-        doStencil( f,std::forward<Matrix>(m),x[i],y[i], CuspMatrixTag(), get_tensor_category<inner_container>());
+        doStencil( CuspMatrixTag(), get_tensor_category<inner_container>(),
+                f, std::forward<Matrix>(m), x[i], ys[i]...);
 }
 
 } //namespace detail
@@ -177,16 +177,16 @@ inline void doSymv( get_value_type<Vector1> alpha,
         dg::blas2::symv( alpha, std::forward<Matrix>(m), do_get_vector_element(x,el.first,get_tensor_category<Vector1>()), beta, do_get_vector_element(y,el.first,get_tensor_category<Vector2>()));
 }
 
-template<class Functor, class Matrix, class Vector1, class Vector2>
+template<class Functor, class Matrix, class Vector1, class ...Vectors>
 inline void doStencil(
+                    MPIMatrixTag,
+                    MPIVectorTag,
                     Functor f,
                     Matrix&& m,
                     const Vector1&x,
-                    Vector2& y,
-                    MPIMatrixTag,
-                    MPIVectorTag  )
+                    Vectors&&... ys)
 {
-    m.stencil( f, x,y);
+    m.stencil( f, x, std::forward<Vectors>(ys)...);
 }
 
 
@@ -5,6 +5,7 @@
 #include "tensor_traits.h"
 #include "sparseblockmat.h"
 #include "sparseblockmat.cuh"
+#include "perf.h"
 //
 ///@cond
 namespace dg{
@@ -17,6 +18,35 @@ inline void doTransfer( const Matrix1& x, Matrix2& y, AnyMatrixTag, SparseBlockM
 {
     y = (Matrix2)x; //try to invoke the explicit conversion construction
 }
+
+#ifdef DG_PERF_COUNT
+//memop and flop model of the blocked matrix-vector products (the block
+//values and indices are shared between rows and assumed cached)
+template<class value_type>
+inline void sparseblockmat_work( const EllSparseBlockMat<value_type>& m, double& bytes, double& flops)
+{
+    double rows = (double)m.total_num_rows();
+    //y write + y read + blocks_per_line x reads per output element
+    bytes = ( 2. + m.blocks_per_line)*rows*sizeof(value_type);
+    flops = 2.*m.n*m.blocks_per_line*rows;
+}
+template<class value_type>
+inline void sparseblockmat_work( const CooSparseBlockMat<value_type>& m, double& bytes, double& flops)
+{
+    double entries = (double)m.num_entries*m.left_size*m.right_size;
+    //per entry: read and update n elements of y, read n elements of x
+    bytes = 3.*m.n*entries*sizeof(value_type);
+    flops = 2.*m.n*m.n*entries;
+}
+template<class value_type>
+inline void sparseblockmat_work( const BlockDiagMat<value_type>& m, double& bytes, double& flops)
+{
+    double rows = (double)m.total_num_rows();
+    //y write + y read + m x reads and m block reads per output element
+    bytes = ( 2. + 2.*m.m())*rows*sizeof(value_type);
+    flops = 2.*m.m()*rows;
+}
+#endif //DG_PERF_COUNT
 template< class Matrix, class Vector1, class Vector2>
 inline void doSymv_dispatch(
               get_value_type<Vector1> alpha,
@@ -40,6 +70,11 @@ inline void doSymv_dispatch(
     }
     const value_type * x_ptr = thrust::raw_pointer_cast(x.data());
           value_type * y_ptr = thrust::raw_pointer_cast(y.data());
+#ifdef DG_PERF_COUNT
+    double perf_bytes = 0., perf_flops = 0.;
+    sparseblockmat_work( m, perf_bytes, perf_flops);
+#endif //DG_PERF_COUNT
+    DG_PERF_SAMPLE( "blas2::symv(SparseBlockMat)", perf_bytes, perf_flops);
     m.symv( SharedVectorTag(), get_execution_policy<Vector1>(), alpha, x_ptr, beta, y_ptr);
 }
 
@@ -93,6 +128,109 @@ inline void doSymv_dispatch(
 #endif//_OPENMP
 
 
+template< class Matrix, class Vector1, class Vector2, class Vector3>
+inline void doSymv_axpby_dispatch(
+              get_value_type<Vector1> alpha,
+              Matrix&& m,
+              const Vector1& x,
+              get_value_type<Vector1> beta,
+              const Vector2& y,
+              Vector3& z,
+              SparseBlockMatrixTag,
+              SharedVectorTag,
+              AnyPolicyTag)
+{
+    using value_type = get_value_type<Vector1>;
+
+    if( (int)x.size() != m.total_num_cols()) {
+        throw Error( Message(_ping_)<<"x has the wrong size "<<x.size()<<" Number of columns is "<<m.total_num_cols());
+    }
+    if( (int)y.size() != m.total_num_rows()) {
+        throw Error( Message(_ping_)<<"y has the wrong size "<<y.size()<<" Number of rows is "<<m.total_num_rows());
+    }
+    if( (int)z.size() != m.total_num_rows()) {
+        throw Error( Message(_ping_)<<"z has the wrong size "<<z.size()<<" Number of rows is "<<m.total_num_rows());
+    }
+    const value_type * x_ptr = thrust::raw_pointer_cast(x.data());
+    const value_type * y_ptr = thrust::raw_pointer_cast(y.data());
+          value_type * z_ptr = thrust::raw_pointer_cast(z.data());
+#ifdef DG_PERF_COUNT
+    double perf_bytes = 0., perf_flops = 0.;
+    sparseblockmat_work( m, perf_bytes, perf_flops);
+    perf_bytes += y.size()*sizeof(value_type); //the extra y read
+#endif //DG_PERF_COUNT
+    DG_PERF_SAMPLE( "blas2::symv_axpby(SparseBlockMat)", perf_bytes, perf_flops);
+    m.symv_axpby( SharedVectorTag(), get_execution_policy<Vector1>(), alpha, x_ptr, beta, y_ptr, z_ptr);
+}
+
+template< class Matrix, class Vector1, class Vector2, class Vector3>
+inline void doSymv_axpby_dispatch(
+              get_value_type<Vector1> alpha,
+              Matrix&& m,
+              const Vector1& x,
+              get_value_type<Vector1> beta,
+              const Vector2& y,
+              Vector3& z,
+              SparseBlockMatrixTag,
+              RecursiveVectorTag,
+              AnyPolicyTag)
+{
+    for(unsigned i=0; i<x.size(); i++)
+        doSymv_axpby_dispatch( alpha, std::forward<Matrix>(m), x[i], beta, y[i], z[i],
+                SparseBlockMatrixTag(),
+                get_tensor_category<typename Vector1::value_type>(),
+                get_execution_policy<Vector1>());
+}
+#ifdef _OPENMP
+template< class Matrix, class Vector1, class Vector2, class Vector3>
+inline void doSymv_axpby_dispatch(
+              get_value_type<Vector1> alpha,
+              Matrix&& m,
+              const Vector1& x,
+              get_value_type<Vector1> beta,
+              const Vector2& y,
+              Vector3& z,
+              SparseBlockMatrixTag,
+              RecursiveVectorTag,
+              OmpTag)
+{
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel
+        {
+            for(unsigned i=0; i<x.size(); i++)
+                doSymv_axpby_dispatch( alpha, std::forward<Matrix>(m), x[i], beta, y[i], z[i],
+                        SparseBlockMatrixTag(),
+                        get_tensor_category<typename Vector1::value_type>(),
+                        OmpTag());
+        }
+    }
+    else
+        for(unsigned i=0; i<x.size(); i++)
+            doSymv_axpby_dispatch( alpha, std::forward<Matrix>(m), x[i], beta, y[i], z[i],
+                    SparseBlockMatrixTag(),
+                    get_tensor_category<typename Vector1::value_type>(),
+                    OmpTag());
+}
+#endif//_OPENMP
+
+template< class Matrix, class Vector1, class Vector2, class Vector3>
+inline void doSymv_axpby(
+              get_value_type<Vector1> alpha,
+              Matrix&& m,
+              const Vector1& x,
+              get_value_type<Vector1> beta,
+              const Vector2& y,
+              Vector3& z,
+              SparseBlockMatrixTag)
+{
+    doSymv_axpby_dispatch(alpha, std::forward<Matrix>(m), x, beta, y, z,
+            SparseBlockMatrixTag(),
+            get_tensor_category<Vector1>(),
+            get_execution_policy<Vector1>()
+            );
+}
+
 template< class Matrix, class Vector1, class Vector2>
 inline void doSymv(
               get_value_type<Vector1> alpha,
@@ -121,6 +259,90 @@ inline void doSymv(
 
 } //namespace detail
 } //namespace blas2
+
+namespace detail
+{
+//A POD view of an EllSparseBlockMat usable inside DG_DEVICE lambdas.
+//Evaluating the product at a single index allows classes like Elliptic or
+//Advection to fuse the matrix applications with the pointwise operations in
+//between, which saves reading and writing the intermediate vectors from
+//global memory.
+template<class value_type>
+struct EllSparseBlockMatView
+{
+    const value_type* data;
+    const int* cols_idx;
+    const int* data_idx;
+    int num_rows, num_cols, blocks_per_line, n, right_size;
+    ///compute the matrix-vector product at the (flat) index idx
+    ///@note assumes the default right_range of shared memory matrices
+    DG_DEVICE value_type operator()( const value_type* x, int idx) const
+    {
+        int rr = idx/right_size, j = idx%right_size;
+        int k = rr%n, i = (rr/n)%num_rows, s = rr/(n*num_rows);
+        value_type temp = 0;
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+            for( int q=0; q<n; q++)
+                temp = DG_FMA( data[B+q], x[(J+q)*right_size+j], temp);
+        }
+        return temp;
+    }
+};
+template<class value_type>
+EllSparseBlockMatView<value_type> make_ell_view( const EllSparseBlockMat<value_type>& m)
+{
+    return { thrust::raw_pointer_cast( m.data.data()),
+        thrust::raw_pointer_cast( m.cols_idx.data()),
+        thrust::raw_pointer_cast( m.data_idx.data()),
+        m.num_rows, m.num_cols, m.blocks_per_line, m.n, m.right_size};
+}
+template<class value_type>
+EllSparseBlockMatView<value_type> make_ell_view( const EllSparseBlockMatDevice<value_type>& m)
+{
+    return { thrust::raw_pointer_cast( m.data.data()),
+        thrust::raw_pointer_cast( m.cols_idx.data()),
+        thrust::raw_pointer_cast( m.data_idx.data()),
+        m.num_rows, m.num_cols, m.blocks_per_line, m.n, m.right_size};
+}
+//The product of two EllSparseBlockMats evaluated in a single pass: the
+//outer matrix row is computed with the required elements of the inner
+//product evaluated on the fly instead of read from a temporary.  This turns
+//the two-stage application of e.g. dg::create::fast_projection into one
+//kernel without any intermediate vector in global memory.
+template<class value_type>
+struct KroneckerEllView
+{
+    EllSparseBlockMatView<value_type> outer, inner;
+    ///compute the product of both matrices at the (flat) index idx
+    ///@note assumes the default right_range of shared memory matrices
+    DG_DEVICE value_type operator()( const value_type* x, int idx) const
+    {
+        int rr = idx/outer.right_size, j = idx%outer.right_size;
+        int k = rr%outer.n, i = (rr/outer.n)%outer.num_rows,
+            s = rr/(outer.n*outer.num_rows);
+        value_type temp = 0;
+        for( int d=0; d<outer.blocks_per_line; d++)
+        {
+            int B = (outer.data_idx[i*outer.blocks_per_line+d]*outer.n+k)*outer.n;
+            int J = (s*outer.num_cols+outer.cols_idx[i*outer.blocks_per_line+d])*outer.n;
+            for( int q=0; q<outer.n; q++)
+                temp = DG_FMA( outer.data[B+q],
+                    inner( x, (J+q)*outer.right_size+j), temp);
+        }
+        return temp;
+    }
+};
+//Whether a fused symv path is available for a given Matrix type
+template<class Matrix>
+struct is_ell_matrix : std::false_type{};
+template<class value_type>
+struct is_ell_matrix<EllSparseBlockMat<value_type>> : std::true_type{};
+template<class value_type>
+struct is_ell_matrix<EllSparseBlockMatDevice<value_type>> : std::true_type{};
+} //namespace detail
 } //namespace dg
 ///@endcond
 //
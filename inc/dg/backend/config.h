@@ -55,13 +55,107 @@
 #pragma message( "WARNING: No OpenMP 4 support on your compiler")
 #define SIMD
 #endif //compilers
+
+#include <omp.h>
+namespace dg
+{
+///@cond
+namespace detail
+{
+//Adapt the OpenMP team size to the problem size: on small vectors (e.g. the
+//coarse stages of a multigrid cycle) the implicit barrier of a full team
+//costs more than the surplus threads contribute, so threads only spin
+inline int omp_team_size( long long size, long long min_per_thread = 10000)
+{
+    long long threads = ( size - 1)/min_per_thread + 1;
+    long long max_threads = omp_get_max_threads();
+    return (int)( threads > max_threads ? max_threads : threads);
+}
+//The canonical contiguous block partition of the OpenMP backend: thread tid
+//of tnum threads works on the half open index range [l,r). All OpenMP kernels
+//use this partition (the blas1 kernels through schedule(static), which gives
+//the same blocks up to rounding, exblas::exdot_omp through its block_range,
+//which cannot include this header since exblas also ships standalone), so
+//pages first touched with it are local to the socket that later processes them
+inline void omp_block_range( int tid, int tnum, long long size,
+    long long& l, long long& r)
+{
+    l = ( tid   *size)/tnum;
+    r = ((tid+1)*size)/tnum;
+}
+}//namespace detail
+///@endcond
+}//namespace dg
 #endif //THRUST_DEVICE_SYSTEM
 
+//%%%%%%%%%%%%%%%%%%NUMA aware first touch%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+namespace dg
+{
+/**
+ * @brief Touch the elements of a host vector with the thread partition of the
+ * OpenMP backend (NUMA first-touch placement)
+ *
+ * Linux backs a memory page on the NUMA node of the thread that first writes
+ * to it. On a dual-socket node a vector whose pages were all touched by the
+ * master thread (e.g. during a serial assembly) therefore lives on one socket
+ * and every OpenMP kernel reads half of it over the socket interconnect,
+ * which can cost a factor 2 in \c dg::blas1::dot throughput. This function
+ * value-initializes every element in parallel with the same contiguous block
+ * partition that the blas1 kernels and \c exblas::exdot_omp use, so a vector
+ * allocated without prior initialization ends up distributed across the
+ * sockets exactly as it is later processed.
+ * @note Only pages that have not been backed yet are placed by this call;
+ * pages that were already written to keep their node (automatic NUMA
+ * balancing of the kernel may still migrate them eventually). On the
+ * device vectors of the OpenMP backend thrust itself value-initializes in
+ * parallel, so those are placed correctly on construction already.
+ * @note On the serial and CUDA backends this function is a no-op.
+ * @param x the vector to touch; the values are overwritten with zero
+ * @tparam ContainerType a contiguous host vector, e.g. \c dg::HVec (in an MPI
+ * program call this function on the local data)
+ * @ingroup misc
+ */
+template<class ContainerType>
+void first_touch( ContainerType& x)
+{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_OMP
+    using value_type = typename ContainerType::value_type;
+    value_type* ptr = thrust::raw_pointer_cast( x.data());
+    long long size = x.size();
+    #pragma omp parallel num_threads( detail::omp_team_size( size))
+    {
+        long long l, r;
+        detail::omp_block_range( omp_get_thread_num(),
+            omp_get_num_threads(), size, l, r);
+        for( long long i=l; i<r; i++)
+            ptr[i] = value_type();
+    }
+#else
+    (void)x;
+#endif
+}
+}//namespace dg
+
 //%%%%%%%%%%%%%%%try to check for cuda-aware MPI support%%%%%%%%%%%%%%%%%%%%%%%%%%
+// If the MPI library is CUDA-aware (GPUDirect RDMA) we pass device pointers
+// straight to MPI and avoid all staging copies through the host. The decision
+// can be forced at compile time with -DDG_CUDA_AWARE_MPI or
+// -DDG_CUDA_UNAWARE_MPI; otherwise we try to autodetect (OpenMPI exports the
+// answer in mpi-ext.h) and in case of doubt assume support is present.
+// The runtime answer of the library can be queried with dg::cuda_aware_mpi()
 #ifdef MPI_VERSION
 #if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 
-//#include "mpi-ext.h"
+#if defined( DG_CUDA_UNAWARE_MPI)
+#pragma message( "Falling back to regular MPI as requested (DG_CUDA_UNAWARE_MPI)")
+#define _DG_CUDA_UNAWARE_MPI
+#elif defined( DG_CUDA_AWARE_MPI)
+#pragma message( "Assuming CUDA-aware MPI support as requested (DG_CUDA_AWARE_MPI)")
+//User asserts that the MPI library can handle device pointers
+#else //autodetect
+#if defined( OPEN_MPI) && OPEN_MPI
+#include "mpi-ext.h" //defines MPIX_CUDA_AWARE_SUPPORT
+#endif //OPEN_MPI
 #if defined(MPIX_CUDA_AWARE_SUPPORT) && MPIX_CUDA_AWARE_SUPPORT
 #pragma message( "CUDA-aware MPI support detected! Yay!")
 //Has cuda aware MPI support. Everything fine
@@ -69,10 +163,41 @@
 #warning "No CUDA aware MPI installation! Falling back to regular MPI!"
 #define _DG_CUDA_UNAWARE_MPI
 #else
-#pragma message( "Cannot determine CUDA-aware MPI support! Falling back to regular MPI!")
+#pragma message( "Cannot determine CUDA-aware MPI support! Assuming it is present (compile with -DDG_CUDA_UNAWARE_MPI to override)")
 //#define _DG_CUDA_UNAWARE_MPI
 #endif //MPIX_CUDA
+#endif //DG_CUDA_(UN)AWARE_MPI
 
 #endif //THRUST == CUDA
 
+namespace dg
+{
+/**
+ * @brief Ask the MPI library at runtime whether it can handle device pointers
+ *
+ * The halo and collective exchanges pass device pointers straight to MPI
+ * unless \c _DG_CUDA_UNAWARE_MPI is defined (see above). This function asks
+ * the library itself where possible (OpenMPI) so that a mismatch between the
+ * compile time assumption and the loaded library can be caught at startup.
+ * @return false if either the compile time decision or the MPI library rules
+ * out device buffers, true otherwise (also on shared memory backends, where
+ * no device buffers are involved)
+ * @ingroup misc
+ */
+inline bool cuda_aware_mpi()
+{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+#if defined(_DG_CUDA_UNAWARE_MPI)
+    return false;
+#elif defined(MPIX_CUDA_AWARE_SUPPORT)
+    return MPIX_Query_cuda_support() == 1;
+#else
+    return true; //compile time assumption, the library cannot be queried
+#endif
+#else
+    return true;
+#endif
+}
+}//namespace dg
+
 #endif //MPI_VERSION
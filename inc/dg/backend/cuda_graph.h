@@ -0,0 +1,106 @@
+#pragma once
+
+#include "config.h"
+#include "execution_policy.h"
+
+/*!@file
+ * A cache that records a fixed sequence of device kernels into a CUDA Graph
+ */
+
+namespace dg{
+
+/**
+ * @brief Record a fixed kernel sequence into a CUDA Graph on first call and
+ * replay it on subsequent calls
+ *
+ * On small grids the launch latency of the many small kernels of e.g. a
+ * Runge-Kutta stage sequence can dominate the actual compute time. If the
+ * sequence is fixed and data-independent it can be recorded into a
+ * <a href="https://docs.nvidia.com/cuda/cuda-c-programming-guide/index.html#cuda-graphs">CUDA Graph</a>
+ * once and subsequently replayed with a single launch:
+ * @code{.cpp}
+dg::GraphCache cache;
+for( unsigned i=0; i<100; i++)
+    cache( [&](){
+        dg::blas1::axpby( 1., x, 2., y);
+        dg::blas1::pointwiseDot( y, y, z);
+    }, 0);
+ * @endcode
+ * The functor is executed normally (and the cache stays cold) unless the
+ * program is compiled for CUDA with <tt> --default-stream per-thread </tt>,
+ * because stream capture can only record work submitted to the per-thread
+ * default stream.
+ * @attention A replay re-issues the captured kernels with the @b captured
+ * scalar arguments and device pointers. The functor must therefore enqueue
+ * the same kernels on the same vectors with the same parameters on every
+ * call: no reductions or host synchronization (\c dg::blas1::dot and
+ * friends), no MPI communication, no vector swaps or resizes. Call
+ * \c invalidate whenever scalar parameters or vector addresses change.
+ * @ingroup dispatch
+ */
+class GraphCache
+{
+  public:
+    GraphCache() = default;
+    ///@brief A copy does not copy the captured graph; it is re-captured on first use
+    GraphCache( const GraphCache&){ }
+    ///@brief Assignment invalidates the captured graph of the target
+    GraphCache& operator=( const GraphCache&){ invalidate(); return *this;}
+    ~GraphCache(){ invalidate();}
+    ///@brief Discard the captured graph; the next call records afresh
+    void invalidate()
+    {
+#if defined(__CUDACC__) && defined(CUDA_API_PER_THREAD_DEFAULT_STREAM)
+        if( m_instance != nullptr)
+        {
+            cudaGraphExecDestroy( m_instance);
+            m_instance = nullptr;
+        }
+#endif
+        m_valid = false;
+    }
+    /**
+     * @brief Execute (and possibly record or replay) a kernel sequence
+     *
+     * @param f a callable with no arguments that enqueues the kernel
+     * sequence; called on first invocation (recording) and whenever the
+     * cache is invalid, skipped on replays
+     * @param key a caller provided validity tag (e.g. derived from the
+     * participating vector addresses); if it differs from the recorded one
+     * the graph is re-captured
+     */
+    template<class Functor>
+    void operator()( Functor&& f, std::size_t key)
+    {
+#if defined(__CUDACC__) && defined(CUDA_API_PER_THREAD_DEFAULT_STREAM)
+        if( m_valid && key == m_key)
+        {
+            cudaGraphLaunch( m_instance, cudaStreamPerThread);
+            return;
+        }
+        invalidate();
+        m_key = key;
+        cudaStreamBeginCapture( cudaStreamPerThread,
+                cudaStreamCaptureModeThreadLocal);
+        f();
+        cudaGraph_t graph;
+        cudaStreamEndCapture( cudaStreamPerThread, &graph);
+        cudaGraphInstantiate( &m_instance, graph, nullptr, nullptr, 0);
+        cudaGraphDestroy( graph);
+        m_valid = true;
+        //capture does not execute the work, launch the graph once
+        cudaGraphLaunch( m_instance, cudaStreamPerThread);
+#else
+        (void)key;
+        f();
+#endif
+    }
+  private:
+#if defined(__CUDACC__) && defined(CUDA_API_PER_THREAD_DEFAULT_STREAM)
+    cudaGraphExec_t m_instance = nullptr;
+#endif
+    std::size_t m_key = 0;
+    bool m_valid = false;
+};
+
+}//namespace dg
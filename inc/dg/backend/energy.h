@@ -0,0 +1,189 @@
+#ifndef _DG_ENERGY_
+#define _DG_ENERGY_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "thrust/device_vector.h"
+//the <thrust/device_vector.h> header must be included for the THRUST_DEVICE_SYSTEM macros to work
+#if (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA) && defined(DG_USE_NVML)
+#include <nvml.h>
+#endif
+
+/*!@file
+ *
+ * Energy counter companion to dg::Timer
+ */
+namespace dg
+{
+///@cond
+namespace detail
+{
+//read a single number from a sysfs file; -1 if the file does not exist
+inline double read_sysfs( const std::string& path)
+{
+    std::ifstream is( path);
+    double value = -1.;
+    is >> value;
+    return is ? value : -1.;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Measure the energy consumed between \c tic and \c toc in Joule
+ *
+ * Companion to \c dg::Timer with the same \c tic / \c toc / \c diff
+ * interface, intended for benchmarks on centers that bill by energy rather
+ * than node hours: wrapping a solver phase in a meter next to the timer
+ * yields Joule per timestep or per iteration and thus the clocks and
+ * per-device problem sizes that minimize energy to solution.
+ *
+ * Two counter sources are summed, each used only if present:
+ * - the CPU package (and DRAM, if exposed as a package domain) energy of the
+ *   RAPL powercap interface, read from
+ *   <tt>/sys/class/powercap/intel-rapl:*&zwj;/energy_uj</tt> (no library
+ *   needed; the counter wrap-around is corrected with the advertised range).
+ *   On many systems the files are root readable only, in which case the
+ *   meter reports 0 -- ask the admins for the \c powercap permissions;
+ * - the total energy consumption counter of the GPU driving the current
+ *   process if the code is compiled for GPUs @b and the macro \c DG_USE_NVML
+ *   is defined at compile time (include path to \c nvml.h and link against
+ *   \c -lnvidia-ml), matched via the PCI bus id of the current CUDA device.
+ *
+ * @note The counters are device wide: the RAPL packages count everything on
+ * the node and the NVML counter everything on the GPU, so with several
+ * processes per node (or per GPU) the consumption of the siblings is
+ * included. The MPI overload of \c diff therefore counts every node (not
+ * every rank) once; sharing one GPU between ranks still double counts.
+ * @note \c available says whether any counter source was found; \c diff
+ * returns 0 otherwise so the meter is safe to use unconditionally
+ * @sa dg::Timer
+ * @ingroup timer
+ */
+class EnergyMeter
+{
+  public:
+    EnergyMeter()
+    {
+        //discover the RAPL package domains (intel-rapl:0, intel-rapl:1, ...)
+        for( unsigned i=0; i<64; i++)
+        {
+            std::string base = "/sys/class/powercap/intel-rapl:" + std::to_string(i);
+            if( detail::read_sysfs( base+"/energy_uj") < 0.)
+                break;
+            m_paths.push_back( base+"/energy_uj");
+            double range = detail::read_sysfs( base+"/max_energy_range_uj");
+            m_ranges.push_back( range > 0. ? range : 0.);
+        }
+#if (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA) && defined(DG_USE_NVML)
+        if( NVML_SUCCESS == nvmlInit_v2())
+        {
+            char bus_id[32];
+            int device = 0;
+            cudaGetDevice( &device);
+            if( cudaSuccess == cudaDeviceGetPCIBusId( bus_id, 32, device))
+            {
+                nvmlDevice_t handle;
+                unsigned long long mJ;
+                //probe: the counter is not supported on all architectures
+                if( NVML_SUCCESS == nvmlDeviceGetHandleByPciBusId_v2( bus_id, &handle)
+                    && NVML_SUCCESS == nvmlDeviceGetTotalEnergyConsumption( handle, &mJ))
+                {
+                    m_nvml = handle;
+                    m_has_gpu = true;
+                }
+            }
+        }
+#endif
+        m_start.assign( m_paths.size() + (m_has_gpu ? 1 : 0), 0.);
+        m_stop = m_start;
+    }
+    ///@brief true if at least one counter source (RAPL or NVML) was found
+    bool available() const{ return !m_paths.empty() || m_has_gpu;}
+    ///@brief Read all counters (start of the measured phase)
+    void tic(){ measure( m_start);}
+    ///@brief Read all counters (end of the measured phase)
+    void toc(){ measure( m_stop);}
+    /**
+     * @brief Energy consumed between the last \c tic and \c toc in Joule
+     * @return Joule consumed by this process' node packages and GPU
+     * (0 if no counter source is available)
+     */
+    double diff() const
+    {
+        double joule = 0.;
+        for( unsigned i=0; i<m_paths.size(); i++)
+        {
+            double uj = m_stop[i] - m_start[i];
+            if( uj < 0.) //the counter wrapped around between tic and toc
+                uj += m_ranges[i];
+            joule += uj*1e-6;
+        }
+        if( m_has_gpu)
+            joule += (m_stop.back() - m_start.back())*1e-3; //mJ
+        return joule;
+    }
+#ifdef MPI_VERSION
+    /**
+     * @brief Total energy consumed between \c tic and \c toc by all nodes in Joule
+     *
+     * The node-wide RAPL counters are contributed once per shared memory
+     * node, the GPU counter once per rank, and everything is summed with a
+     * single \c MPI_Allreduce
+     * @param comm the communicator over which to sum (a collective call:
+     * all ranks must call \c tic, \c toc and this function)
+     * @return total Joule, the same on all ranks
+     */
+    double diff( MPI_Comm comm) const
+    {
+        MPI_Comm node;
+        MPI_Comm_split_type( comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+            &node);
+        int node_rank;
+        MPI_Comm_rank( node, &node_rank);
+        MPI_Comm_free( &node);
+        double local = 0.;
+        if( node_rank == 0)
+        {
+            for( unsigned i=0; i<m_paths.size(); i++)
+            {
+                double uj = m_stop[i] - m_start[i];
+                if( uj < 0.)
+                    uj += m_ranges[i];
+                local += uj*1e-6;
+            }
+        }
+        if( m_has_gpu)
+            local += (m_stop.back() - m_start.back())*1e-3;
+        double total = 0.;
+        MPI_Allreduce( &local, &total, 1, MPI_DOUBLE, MPI_SUM, comm);
+        return total;
+    }
+#endif //MPI_VERSION
+  private:
+    void measure( std::vector<double>& values)
+    {
+        for( unsigned i=0; i<m_paths.size(); i++)
+            values[i] = detail::read_sysfs( m_paths[i]);
+#if (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA) && defined(DG_USE_NVML)
+        if( m_has_gpu)
+        {
+            cudaDeviceSynchronize(); //attribute in-flight kernels correctly
+            unsigned long long mJ = 0;
+            nvmlDeviceGetTotalEnergyConsumption( m_nvml, &mJ);
+            values.back() = (double)mJ;
+        }
+#endif
+    }
+    std::vector<std::string> m_paths; //one RAPL energy_uj file per package
+    std::vector<double> m_ranges; //wrap-around range per package in uJ
+    std::vector<double> m_start, m_stop;
+    bool m_has_gpu = false;
+#if (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA) && defined(DG_USE_NVML)
+    nvmlDevice_t m_nvml;
+#endif
+};
+}//namespace dg
+
+#endif //_DG_ENERGY_
@@ -45,12 +45,16 @@ static inline double get_element( T* x, int i){
 // Main computation pass: compute partial superaccs
 ////////////////////////////////////////////////////////////////////////////////
 __device__
-static inline void AccumulateWord( int64_t *accumulator, int i, int64_t x, int stride = 1) {
+static inline void AccumulateWord( int64_t *accumulator, int i, int64_t x, int stride = 1, int nbin = BIN_COUNT) {
     // With atomic superacc updates
     // accumulation and carry propagation can happen in any order,
     // as long as addition is atomic
     // only constraint is: never forget an overflow bit
     //assert(i >= 0 && i < BIN_COUNT);
+    if (i >= nbin){
+        //status = Overflow; a window must never write past its bins
+        return;
+    }
     unsigned char overflow;
     int64_t carry = x;
     int64_t carrybit;
@@ -76,7 +80,7 @@ static inline void AccumulateWord( int64_t *accumulator, int i, int64_t x, int s
         carry += carrybit;
 
         ++i;
-        if (i >= BIN_COUNT){
+        if (i >= nbin){
             //status = Overflow;
             return;
         }
@@ -92,9 +96,12 @@ static inline void AccumulateWord( int64_t *accumulator, int i, int64_t x, int s
 * @param accumulator a pointer to at least \c BIN_COUNT 64 bit integers on the GPU (representing the superaccumulator)
 * @param x the double to add to the superaccumulator
 * @param stride stride in which accumulator is to be accessed
+* @param f_words word index of the binary point (\c F_WORDS for a full
+*  superaccumulator, \c F_WORDS-IMIN_FLOAT for the single precision window)
+* @param nbin number of bins the accumulator holds
 */
 __device__
-static inline void Accumulate( int64_t* accumulator, double x, int stride = 1) { //transposed accumulation
+static inline void Accumulate( int64_t* accumulator, double x, int stride = 1, int f_words = F_WORDS, int nbin = BIN_COUNT) { //transposed accumulation
     if (x == 0)
         return;
     //MW: This assert does not help very much in finding out where the nan originates
@@ -103,7 +110,7 @@ static inline void Accumulate( int64_t* accumulator, double x, int stride = 1) {
     int e;
     frexp(x, &e); //extract the exponent of x (lies in -1024;1023 ?)
     int exp_word = e / DIGITS;  // Word containing MSbit
-    int iup = exp_word + F_WORDS; //can be at most 18 + 20
+    int iup = exp_word + f_words; //can be at most 18 + 20
 
     double xscaled = ldexp(x, -DIGITS * exp_word);
 
@@ -111,7 +118,7 @@ static inline void Accumulate( int64_t* accumulator, double x, int stride = 1) {
     for (i = iup; i>=0 && xscaled != 0; --i) { //MW: i>=0 protects agains NaN
         double xrounded = rint(xscaled);
         int64_t xint = (int64_t) xrounded;
-        AccumulateWord(accumulator, i, xint, stride);
+        AccumulateWord(accumulator, i, xint, stride, nbin);
 
         xscaled -= xrounded;
         xscaled *= DELTASCALE;
@@ -130,16 +137,17 @@ static inline void Accumulate( int64_t* accumulator, double x, int stride = 1) {
 * @param imin the first index in the accumulator
 * @param imax the last index in the accumulator
 * @param stride strid in which the superaccumulator is accessed
+* @param nbin number of bins the accumulator holds
 *
 * @return  carry in bit (sign)
 */
 __device__
-static int Normalize( int64_t *accumulator, int& imin, int& imax, int stride = 1) {
+static int Normalize( int64_t *accumulator, int& imin, int& imax, int stride = 1, int nbin = BIN_COUNT) {
     int64_t carry_in = accumulator[(imin)*stride] >> DIGITS;
     accumulator[(imin)*stride] -= carry_in << DIGITS;
     int i;
     // Sign-extend all the way
-    for (i = imin + 1; i < BIN_COUNT; ++i) {
+    for (i = imin + 1; i < nbin; ++i) {
         accumulator[i*stride] += carry_in;
         int64_t carry_out = accumulator[i*stride] >> DIGITS;    // Arithmetic shift
         accumulator[i*stride] -= (carry_out << DIGITS);
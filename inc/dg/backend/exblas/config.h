@@ -21,6 +21,11 @@
 #ifdef WITHOUT_VCL
 #define _WITHOUT_VCL
 #endif//WITHOUT_VCL
+//vcl only supports x86; on other architectures (e.g. ARM NEON) fall back to
+//the scalar superaccumulator, which relies on compiler auto-vectorization
+#if !defined(__x86_64__) && !defined(__i386__) && !defined(_M_X64) && !defined(_M_IX86)
+#define _WITHOUT_VCL
+#endif//architecture
 
 ////////////////////////////////////////////////////////////////////////
 //include vcl if available
@@ -84,6 +89,17 @@ static constexpr int BIN_COUNT     =  F_WORDS+E_WORDS; //!< size of superaccumul
 static constexpr int IMIN           = 0; //!< first index in a superaccumulator
 static constexpr int IMAX           = BIN_COUNT-1; //!< last index in a superaccumulator
 static constexpr double DELTASCALE = double(1ull << DIGITS); //!< Assumes KRX>0
+////////////// parameters for single precision accumulation ////////////////////
+//Products of floats are computed in double and are thus exact; their exponents
+//lie in [-298, 257] so only a contiguous window of bins of the double
+//superaccumulator can ever be touched. Restricting the accumulation kernels to
+//this window shrinks the per-warp shared memory on GPUs by a factor 3 (which
+//raises occupancy and thus reduction throughput) while the result remains a
+//valid, mostly zero, BIN_COUNT superaccumulator: bitwise equal to what the
+//full-sized accumulation would produce
+static constexpr int IMIN_FLOAT     = 13; //!< first bin a product of floats can touch
+static constexpr int IMAX_FLOAT     = 25; //!< last bin a product of floats can touch (carry margin included)
+static constexpr int BIN_COUNT_FLOAT = IMAX_FLOAT-IMIN_FLOAT+1; //!< size of the active window for floats (in 64 bit units)
 
 ///@brief Characterizes the result of summation
 enum Status
@@ -111,6 +127,8 @@ struct ValueTraits<T*>
 };
 template<class U>
 using has_floating_value = std::conditional_t< std::is_floating_point<typename ValueTraits<U>::value_type>::value, std::true_type, std::false_type>;
+template<class U>
+using has_float_value = std::conditional_t< std::is_same<typename ValueTraits<U>::value_type, float>::value, std::true_type, std::false_type>;
 ///@endcond
 
 }//namespace exblas
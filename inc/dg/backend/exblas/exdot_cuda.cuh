@@ -51,7 +51,10 @@ static inline double KnuthTwoSum(double a, double b, double *s) {
 //In the first kernel each block produces exactly one superacc (because threads within a block can be synchronized and shared memory lives for a block )
 //the second kernel reduces all superaccs from the first kernel (because we need a global synchronization, which is induced by separate kernel launches)
 
-template<uint NBFPE, uint WARP_COUNT, class PointerOrValue1, class PointerOrValue2>
+//NBIN and IMINW restrict the shared memory superaccs to the bin window
+//[IMINW, IMINW+NBIN); for float inputs (BIN_COUNT_FLOAT, IMIN_FLOAT) this
+//cuts shared memory by a factor 3, for doubles use the full (BIN_COUNT, 0)
+template<uint NBFPE, uint WARP_COUNT, uint NBIN, uint IMINW, class PointerOrValue1, class PointerOrValue2>
 __global__ void ExDOT(
     int64_t *d_PartialSuperaccs,
     PointerOrValue1 d_a,
@@ -59,10 +62,10 @@ __global__ void ExDOT(
     const uint NbElements,
     volatile bool* error
 ) {
-    __shared__ int64_t l_sa[WARP_COUNT * BIN_COUNT]; //shared variables live for a thread block (39 rows, 16 columns!)
+    __shared__ int64_t l_sa[WARP_COUNT * NBIN]; //shared variables live for a thread block (39 rows, 16 columns!)
     int64_t *l_workingBase = l_sa + (threadIdx.x & (WARP_COUNT - 1)); //the bitwise & with 15 is a modulo operation: threadIdx.x % 16
     //Initialize superaccs
-    for (uint i = 0; i < BIN_COUNT; i++)
+    for (uint i = 0; i < NBIN; i++)
         l_workingBase[i * WARP_COUNT] = 0;
     __syncthreads(); //syncs all threads in a block (but not across blocks)
 
@@ -84,11 +87,11 @@ __global__ void ExDOT(
             x = s;
         }
         if (x != 0.0) {
-            Accumulate(l_workingBase, x, WARP_COUNT);
+            Accumulate(l_workingBase, x, WARP_COUNT, F_WORDS-IMINW, NBIN);
             // Flush FPEs to superaccs
             #pragma unroll
             for(uint i = 0; i != NBFPE; ++i) {
-                Accumulate(l_workingBase, a[i], WARP_COUNT);
+                Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
                 a[i] = 0.0;
             }
         }
@@ -101,11 +104,11 @@ __global__ void ExDOT(
         //        r = s;
         //    }
         //    if (r != 0.0) {
-        //        Accumulate(l_workingBase, r, WARP_COUNT);
+        //        Accumulate(l_workingBase, r, WARP_COUNT, F_WORDS-IMINW, NBIN);
         //        // Flush FPEs to superaccs
         //        #pragma unroll
         //        for(uint i = 0; i != NBFPE; ++i) {
-        //            Accumulate(l_workingBase, a[i], WARP_COUNT);
+        //            Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
         //            a[i] = 0.0;
         //        }
         //    }
@@ -114,22 +117,25 @@ __global__ void ExDOT(
     //Flush FPEs to superaccs
     #pragma unroll
     for(uint i = 0; i != NBFPE; ++i)
-        Accumulate(l_workingBase, a[i], WARP_COUNT);
+        Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
     __syncthreads();
 
     //Merge sub-superaccs into work-group partial-accumulator ( ATTENTION: PartialSuperacc is transposed!)
     uint pos = threadIdx.x;
     if(pos < WARP_COUNT) {
-        int imin = IMIN, imax = IMAX;
-        Normalize( l_workingBase, imin, imax, WARP_COUNT);
+        int imin = 0, imax = NBIN-1;
+        Normalize( l_workingBase, imin, imax, WARP_COUNT, NBIN);
     }
     __syncthreads();
 
     if (pos < BIN_COUNT) {
+        //bins outside the window are zero (and must be written in case a
+        //previous launch left values in the partial superaccs)
         int64_t sum = 0;
 
-        for(uint i = 0; i < WARP_COUNT; i++)
-            sum += l_sa[pos * WARP_COUNT + i];
+        if( pos >= IMINW && pos < IMINW + NBIN)
+            for(uint i = 0; i < WARP_COUNT; i++)
+                sum += l_sa[(pos-IMINW) * WARP_COUNT + i];
 
         d_PartialSuperaccs[blockIdx.x * BIN_COUNT + pos] = sum;
     }
@@ -141,7 +147,7 @@ __global__ void ExDOT(
     }
 }
 
-template<uint NBFPE, uint WARP_COUNT, class PointerOrValue1, class PointerOrValue2, class PointerOrValue3>
+template<uint NBFPE, uint WARP_COUNT, uint NBIN, uint IMINW, class PointerOrValue1, class PointerOrValue2, class PointerOrValue3>
 __global__ void ExDOT(
     int64_t *d_PartialSuperaccs,
     PointerOrValue1 d_a,
@@ -150,10 +156,10 @@ __global__ void ExDOT(
     const uint NbElements,
     volatile bool *error
 ) {
-    __shared__ int64_t l_sa[WARP_COUNT * BIN_COUNT]; //shared variables live for a thread block (39 rows, 16 columns!)
+    __shared__ int64_t l_sa[WARP_COUNT * NBIN]; //shared variables live for a thread block (39 rows, 16 columns!)
     int64_t *l_workingBase = l_sa + (threadIdx.x & (WARP_COUNT - 1)); //the bitwise & with 15 is a modulo operation: threadIdx.x % 16
     //Initialize superaccs
-    for (uint i = 0; i < BIN_COUNT; i++)
+    for (uint i = 0; i < NBIN; i++)
         l_workingBase[i * WARP_COUNT] = 0;
     __syncthreads(); //syncs all threads in a block (but not across blocks)
 
@@ -178,11 +184,11 @@ __global__ void ExDOT(
                 x2 = s;
             }
             if (x2 != 0.0) {
-                Accumulate(l_workingBase, x2, WARP_COUNT);
+                Accumulate(l_workingBase, x2, WARP_COUNT, F_WORDS-IMINW, NBIN);
                 // Flush FPEs to superaccs
                 #pragma unroll
                 for(uint i = 0; i != NBFPE; ++i) {
-                    Accumulate(l_workingBase, a[i], WARP_COUNT);
+                    Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
                     a[i] = 0.0;
                 }
             }
@@ -195,11 +201,11 @@ __global__ void ExDOT(
         //        r2 = s; //error was here r = s
         //    }
         //    if (r2 != 0.0) { //error was here r != 0.0
-        //        Accumulate(l_workingBase, r2, WARP_COUNT);
+        //        Accumulate(l_workingBase, r2, WARP_COUNT, F_WORDS-IMINW, NBIN);
         //        // Flush FPEs to superaccs
         //        #pragma unroll
         //        for(uint i = 0; i != NBFPE; ++i) {
-        //            Accumulate(l_workingBase, a[i], WARP_COUNT);
+        //            Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
         //            a[i] = 0.0;
         //        }
         //    }
@@ -216,11 +222,11 @@ __global__ void ExDOT(
         //            x2 = s;
         //        }
         //        if (x2 != 0.0) {
-        //            Accumulate(l_workingBase, x2, WARP_COUNT);
+        //            Accumulate(l_workingBase, x2, WARP_COUNT, F_WORDS-IMINW, NBIN);
         //            // Flush FPEs to superaccs
         //            #pragma unroll
         //            for(uint i = 0; i != NBFPE; ++i) {
-        //                Accumulate(l_workingBase, a[i], WARP_COUNT);
+        //                Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
         //                a[i] = 0.0;
         //            }
         //        }
@@ -233,11 +239,11 @@ __global__ void ExDOT(
         //            r2 = s; //error was here r = s
         //        }
         //        if (r2 != 0.0) { //error was here r != 0.0
-        //            Accumulate(l_workingBase, r2, WARP_COUNT);
+        //            Accumulate(l_workingBase, r2, WARP_COUNT, F_WORDS-IMINW, NBIN);
         //            // Flush FPEs to superaccs
         //            #pragma unroll
         //            for(uint i = 0; i != NBFPE; ++i) {
-        //                Accumulate(l_workingBase, a[i], WARP_COUNT);
+        //                Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
         //                a[i] = 0.0;
         //            }
         //        }
@@ -247,21 +253,24 @@ __global__ void ExDOT(
 	//Flush FPEs to superaccs
     #pragma unroll
     for(uint i = 0; i != NBFPE; ++i)
-        Accumulate(l_workingBase, a[i], WARP_COUNT);
+        Accumulate(l_workingBase, a[i], WARP_COUNT, F_WORDS-IMINW, NBIN);
     __syncthreads();
 
     //Merge sub-superaccs into work-group partial-accumulator ( ATTENTION: PartialSuperacc is transposed!)
     uint pos = threadIdx.x;
     if(pos<WARP_COUNT){
-            int imin = IMIN, imax = IMAX;
-            Normalize(l_workingBase, imin, imax, WARP_COUNT);
+            int imin = 0, imax = NBIN-1;
+            Normalize(l_workingBase, imin, imax, WARP_COUNT, NBIN);
         }
     __syncthreads();
     if (pos < BIN_COUNT) {
+        //bins outside the window are zero (and must be written in case a
+        //previous launch left values in the partial superaccs)
         int64_t sum = 0;
 
-        for(uint i = 0; i < WARP_COUNT; i++)
-            sum += l_sa[pos * WARP_COUNT + i];
+        if( pos >= IMINW && pos < IMINW + NBIN)
+            for(uint i = 0; i < WARP_COUNT; i++)
+                sum += l_sa[(pos-IMINW) * WARP_COUNT + i];
 
         d_PartialSuperaccs[blockIdx.x * BIN_COUNT + pos] = sum;
     }
@@ -333,45 +342,84 @@ void ExDOTCompleteFinal(
 }//namespace gpu
 ///@endcond
 
-///@brief GPU version of exact dot product
+///@brief GPU version of exact dot product with deferred error check
 ///@copydoc hide_exdot2
 ///@copydoc hide_deviceacc
+///@param d_error pointer to a flag on the device that is set to true if one
+/// of the inputs contains NaN or Inf (it is never reset to false); in
+/// contrast to the \c status versions no device synchronization happens, all
+/// kernels are simply submitted to the default stream
 template<class PointerOrValue1, class PointerOrValue2, size_t NBFPE=3>
 __host__
-void exdot_gpu(unsigned size, PointerOrValue1 x1_ptr, PointerOrValue2 x2_ptr, int64_t* d_superacc, int* status)
+void exdot_gpu(unsigned size, PointerOrValue1 x1_ptr, PointerOrValue2 x2_ptr, int64_t* d_superacc, bool* d_error)
 {
     static_assert( has_floating_value<PointerOrValue1>::value, "PointerOrValue1 needs to be T or T* with T one of (const) float or (const) double");
     static_assert( has_floating_value<PointerOrValue2>::value, "PointerOrValue2 needs to be T or T* with T one of (const) float or (const) double");
     static thrust::device_vector<int64_t> d_PartialSuperaccsV( gpu::PARTIAL_SUPERACCS_COUNT*BIN_COUNT, 0); //39 columns and PSC rows
     int64_t *d_PartialSuperaccs = thrust::raw_pointer_cast( d_PartialSuperaccsV.data());
-    thrust::device_vector<bool> d_errorV(1, false);
-    bool *d_error = thrust::raw_pointer_cast( d_errorV.data());
-    gpu::ExDOT<NBFPE, gpu::WARP_COUNT><<<gpu::PARTIAL_SUPERACCS_COUNT, gpu::WORKGROUP_SIZE>>>( d_PartialSuperaccs, x1_ptr, x2_ptr,size, d_error);
+    //float products are exact in double and touch only a window of bins,
+    //which shrinks the shared memory superaccs and raises occupancy
+    constexpr bool is_float = has_float_value<PointerOrValue1>::value &&
+                              has_float_value<PointerOrValue2>::value;
+    constexpr uint NBIN  = is_float ? BIN_COUNT_FLOAT : BIN_COUNT;
+    constexpr uint IMINW = is_float ? IMIN_FLOAT : 0;
+    gpu::ExDOT<NBFPE, gpu::WARP_COUNT, NBIN, IMINW><<<gpu::PARTIAL_SUPERACCS_COUNT, gpu::WORKGROUP_SIZE>>>( d_PartialSuperaccs, x1_ptr, x2_ptr,size, d_error);
     gpu::ExDOTComplete<gpu::MERGE_SUPERACCS_SIZE><<<gpu::PARTIAL_SUPERACCS_COUNT/gpu::MERGE_SUPERACCS_SIZE, gpu::MERGE_WORKGROUP_SIZE>>>( d_PartialSuperaccs, d_superacc );
     //# blocks, # threads per block
     gpu::ExDOTCompleteFinal<gpu::MERGE_SUPERACCS_SIZE><<<1, 64>>>( d_PartialSuperaccs, d_superacc );
+}
+
+///@brief GPU version of exact dot product
+///@copydoc hide_exdot2
+///@copydoc hide_deviceacc
+template<class PointerOrValue1, class PointerOrValue2, size_t NBFPE=3>
+__host__
+void exdot_gpu(unsigned size, PointerOrValue1 x1_ptr, PointerOrValue2 x2_ptr, int64_t* d_superacc, int* status)
+{
+    thrust::device_vector<bool> d_errorV(1, false);
+    exdot_gpu<PointerOrValue1, PointerOrValue2, NBFPE>( size, x1_ptr, x2_ptr,
+        d_superacc, thrust::raw_pointer_cast( d_errorV.data()));
     *status = 0;
     if( d_errorV[0] ) *status = 1;
 }
 
-///@brief GPU version of exact dot product
+///@brief GPU version of exact dot product with deferred error check
 ///@copydoc hide_exdot3
 ///@copydoc hide_deviceacc
+///@param d_error pointer to a flag on the device that is set to true if one
+/// of the inputs contains NaN or Inf (it is never reset to false); in
+/// contrast to the \c status versions no device synchronization happens, all
+/// kernels are simply submitted to the default stream
 template<class PointerOrValue1, class PointerOrValue2, class PointerOrValue3, size_t NBFPE=3>
 __host__
-void exdot_gpu(unsigned size, PointerOrValue1 x1_ptr, PointerOrValue2 x2_ptr, PointerOrValue3 x3_ptr, int64_t* d_superacc, int* status)
+void exdot_gpu(unsigned size, PointerOrValue1 x1_ptr, PointerOrValue2 x2_ptr, PointerOrValue3 x3_ptr, int64_t* d_superacc, bool* d_error)
 {
     static_assert( has_floating_value<PointerOrValue1>::value, "PointerOrValue1 needs to be T or T* with T one of (const) float or (const) double");
     static_assert( has_floating_value<PointerOrValue2>::value, "PointerOrValue2 needs to be T or T* with T one of (const) float or (const) double");
     static_assert( has_floating_value<PointerOrValue3>::value, "PointerOrValue3 needs to be T or T* with T one of (const) float or (const) double");
     static thrust::device_vector<int64_t> d_PartialSuperaccsV( gpu::PARTIAL_SUPERACCS_COUNT*BIN_COUNT, 0); //39 columns and PSC rows
     int64_t *d_PartialSuperaccs = thrust::raw_pointer_cast( d_PartialSuperaccsV.data());
-    thrust::device_vector<bool> d_errorV(1, false);
-    bool *d_error = thrust::raw_pointer_cast( d_errorV.data());
-    gpu::ExDOT<NBFPE, gpu::WARP_COUNT><<<gpu::PARTIAL_SUPERACCS_COUNT, gpu::WORKGROUP_SIZE>>>( d_PartialSuperaccs, x1_ptr, x2_ptr, x3_ptr,size,d_error);
+    //the float window of the two-pointer version does NOT apply here: the
+    //triple product fl(fl(a*b)*c) is rounded and its exponents span
+    //[-447, 385] with rounding bits below 2^-392, which exceeds the
+    //[IMIN_FLOAT, IMAX_FLOAT] window derived for exact two-float products;
+    //always accumulate into the full superaccumulator
+    gpu::ExDOT<NBFPE, gpu::WARP_COUNT, BIN_COUNT, 0><<<gpu::PARTIAL_SUPERACCS_COUNT, gpu::WORKGROUP_SIZE>>>( d_PartialSuperaccs, x1_ptr, x2_ptr, x3_ptr,size,d_error);
     gpu::ExDOTComplete<gpu::MERGE_SUPERACCS_SIZE><<<gpu::PARTIAL_SUPERACCS_COUNT/gpu::MERGE_SUPERACCS_SIZE, gpu::MERGE_WORKGROUP_SIZE>>>( d_PartialSuperaccs, d_superacc );
     //# blocks, # threads per block
     gpu::ExDOTCompleteFinal<gpu::MERGE_SUPERACCS_SIZE><<<1, 64>>>( d_PartialSuperaccs, d_superacc );
+}
+
+///@brief GPU version of exact dot product
+///@copydoc hide_exdot3
+///@copydoc hide_deviceacc
+template<class PointerOrValue1, class PointerOrValue2, class PointerOrValue3, size_t NBFPE=3>
+__host__
+void exdot_gpu(unsigned size, PointerOrValue1 x1_ptr, PointerOrValue2 x2_ptr, PointerOrValue3 x3_ptr, int64_t* d_superacc, int* status)
+{
+    thrust::device_vector<bool> d_errorV(1, false);
+    exdot_gpu<PointerOrValue1, PointerOrValue2, PointerOrValue3, NBFPE>( size,
+        x1_ptr, x2_ptr, x3_ptr, d_superacc, thrust::raw_pointer_cast( d_errorV.data()));
     *status = 0;
     if( d_errorV[0] ) *status = 1;
 }
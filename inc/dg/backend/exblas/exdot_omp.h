@@ -61,6 +61,27 @@ inline static void ReductionStep(int step, int64_t * acc1, int64_t * acc2,
     }
 }
 
+/**
+ * \brief Contiguous block partition of the summation loop
+ *
+ * Thread \p tid of \p tnum threads gets the half open index range [l,r).
+ * The blocks are contiguous in memory, so with compactly pinned threads each
+ * socket of a NUMA machine accumulates the part of the vectors that resides
+ * in its local memory, provided the pages were first touched with the same
+ * partition (see \c dg::first_touch): the per-thread superaccumulators then
+ * act as per-socket partial sums whose merge in \c Reduction is exact, i.e.
+ * the rounding of the result does not depend on the partition.
+ * \note keep in sync with \c dg::detail::omp_block_range in
+ * dg/backend/config.h (which cannot be included here since exblas also ships
+ * as a standalone library)
+ */
+inline static void block_range( unsigned tid, unsigned tnum, int N,
+    int* l, int* r)
+{
+    *l = ( tid   *int64_t(N))/tnum;
+    *r = ((tid+1)*int64_t(N))/tnum;
+}
+
 /**
  * \brief Final step of summation -- Parallel reduction among threads
  *
@@ -109,8 +130,9 @@ void ExDOTFPE(int N, PointerOrValue1 a, PointerOrValue2 b, int64_t* h_superacc,
         *(int32_t volatile *)(&ready[tid * linesize]) = 0;  // Race here, who cares?
 
 #ifndef _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum) & ~7ul; // & ~7ul == round down to multiple of 8
-        int r = ((((tid+1) * int64_t(N)) / tnum) & ~7ul) - 1;
+        int l, r;
+        block_range( tid, tnum, N, &l, &r);
+        l &= ~7ul, r = (r & ~7ul) - 1; // & ~7ul == round down to multiple of 8
 
         for(int i = l; i < r; i+=8) {
 #ifndef _MSC_VER
@@ -140,8 +162,9 @@ void ExDOTFPE(int N, PointerOrValue1 a, PointerOrValue2 b, int64_t* h_superacc,
             //cache.Accumulate(r1);
         }
 #else// _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum);
-        int r = ((((tid+1) * int64_t(N)) / tnum) ) - 1;
+        int l, r;
+        block_range( tid, tnum, N, &l, &r);
+        r -= 1;
         for(int i = l; i <= r; i++) {
             //double r1;
             //double x = TwoProductFMA(get_element(a,i),get_element(b,i),r1);
@@ -180,8 +203,9 @@ void ExDOTFPE(int N, PointerOrValue1 a, PointerOrValue2 b, PointerOrValue3 c, in
         *(int32_t volatile *)(&ready[tid * linesize]) = 0;  // Race here, who cares?
 
 #ifndef _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum) & ~7ul;// & ~7ul == round down to multiple of 8
-        int r = ((((tid+1) * int64_t(N)) / tnum) & ~7ul) - 1;
+        int l, r;
+        block_range( tid, tnum, N, &l, &r);
+        l &= ~7ul, r = (r & ~7ul) - 1;// & ~7ul == round down to multiple of 8
 
         for(int i = l; i < r; i+=8) {
 #ifndef _MSC_VER
@@ -221,8 +245,9 @@ void ExDOTFPE(int N, PointerOrValue1 a, PointerOrValue2 b, PointerOrValue3 c, in
             //cache.Accumulate(r2);
         }
 #else// _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum);
-        int r = ((((tid+1) * int64_t(N)) / tnum) ) - 1;
+        int l, r;
+        block_range( tid, tnum, N, &l, &r);
+        r -= 1;
         for(int i = l; i <= r; i++) {
             //double x1 = a[i]*b[i];
             //double x2 = x1*c[i];
@@ -29,6 +29,11 @@ static std::map<MPI_Comm, std::array<MPI_Comm, 2>> comm_mods;
  * @param comm the input communicator (unmodified, may not be \c MPI_COMM_NULL)
  * @param comm_mod a subgroup of comm (comm is split)
  * @param comm_mod_reduce a subgroup of comm, consists of all rank 0 processes in comm_mod
+ * @note The group size adapts to the size of \c comm: since no level of the
+ * reduction tree may sum more than 256 superaccumulators, a group size of
+ * \f$\sqrt{size}\f$ balances the fan-in of the two levels (for up to 256
+ * processes a single level suffices). This keeps the dot product latency flat
+ * up to 65536 processes.
  * @note the creation of new communicators involves communication between all participation processes (comm in this case).
  * @attention In order to avoid excessive creation of new MPI communicators (there is a limit to how many a program can create), the function keeps record of which communicators it has been called with. If you repeatedly call this function with the same \c comm only the first call will actually create new communicators.
  */
@@ -42,10 +47,16 @@ static void mpi_reduce_communicator(MPI_Comm comm, MPI_Comm* comm_mod, MPI_Comm*
     }
     else
     {
-        int mod = 128;
         int rank, size;
         MPI_Comm_rank( comm, &rank);
         MPI_Comm_size( comm, &size);
+        assert( size <= 256*256 && "reduction tree supports at most 65536 processes");
+        //we must not sum more than 256 superaccumulators in either level;
+        //within that constraint a group size of sqrt(size) minimizes the
+        //larger of the two fan-ins
+        int mod = size <= 256 ? size : (int)ceil( sqrt( (double)size));
+        if( mod < (int)ceil( (double)size/256.))
+            mod = (int)ceil( (double)size/256.);
         MPI_Comm_split( comm, rank/mod, rank%mod, comm_mod); //collective call
         MPI_Group group, reduce_group;
         MPI_Comm_group( comm, &group); //local call
@@ -72,20 +83,53 @@ processes.  As usual the resulting superaccumulator is unnormalized.
 @param in unnormalized input superaccumulators ( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (read/write, undefined on out)
 @param out each process contains the result on output( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (write, may not alias in)
 @param comm The complete MPI communicator
-@param comm_mod This is comm modulo 128 ( or any other number <256)
+@param comm_mod This is a subgroup of comm of size <256
 @param comm_mod_reduce This is the communicator consisting of all rank 0 processes in comm_mod, may be \c MPI_COMM_NULL
 @sa \c exblas::mpi_reduce_communicator to generate the required communicators
 */
-static void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce )
+static void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce );
+
+/*! @brief initiate a non-blocking reduction of superaccumulators
+
+Normalizes the input superaccumulators and posts the first (and largest)
+level of the reduction tree as an \c MPI_Ireduce such that it can overlap
+with subsequent computation. The reduction must be completed with
+\c exblas::ireduce_mpi_cpu_wait before the result can be used and before
+\c in or \c out may be touched.
+ * @ingroup highlevel
+@param num_superacc number of Superaccumulators each process holds
+@param in unnormalized input superaccumulators ( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (read/write, must stay alive and untouched until the wait)
+@param out each process contains the result on output( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (write, may not alias in, must stay alive until the wait)
+@param comm_mod This is a subgroup of comm of size <256
+@param rqst request that must be given to \c exblas::ireduce_mpi_cpu_wait
+@sa \c exblas::mpi_reduce_communicator to generate the required communicators
+*/
+static void ireduce_mpi_cpu_init( unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm_mod, MPI_Request* rqst)
 {
     for( unsigned i=0; i<num_superacc; i++)
     {
         int imin=exblas::IMIN, imax=exblas::IMAX;
         cpu::Normalize(&in[i*exblas::BIN_COUNT], imin, imax);
     }
-    MPI_Reduce(in, out, num_superacc*exblas::BIN_COUNT, MPI_LONG, MPI_SUM, 0, comm_mod);
-    int rank;
-    MPI_Comm_rank( comm_mod, &rank);
+    MPI_Ireduce(in, out, num_superacc*exblas::BIN_COUNT, MPI_LONG, MPI_SUM, 0, comm_mod, rqst);
+}
+
+/*! @brief complete a reduction started with \c ireduce_mpi_cpu_init
+
+Waits for the first level of the reduction tree to finish, then performs
+the (small) second level and broadcasts the result to all participating
+processes. As usual the resulting superaccumulator is unnormalized.
+ * @ingroup highlevel
+@param num_superacc number of Superaccumulators each process holds
+@param in the same input superaccumulators that were given to \c ireduce_mpi_cpu_init (read/write, undefined on out)
+@param out each process contains the result on output
+@param comm The complete MPI communicator
+@param comm_mod_reduce This is the communicator consisting of all rank 0 processes in comm_mod, may be \c MPI_COMM_NULL
+@param rqst the request that was returned by \c ireduce_mpi_cpu_init
+*/
+static void ireduce_mpi_cpu_wait( unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Comm comm_mod_reduce, MPI_Request* rqst)
+{
+    MPI_Wait( rqst, MPI_STATUS_IGNORE);
     if(comm_mod_reduce != MPI_COMM_NULL)
     {
         for( unsigned i=0; i<num_superacc; i++)
@@ -100,5 +144,14 @@ static void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, M
     MPI_Bcast( out, num_superacc*exblas::BIN_COUNT, MPI_LONG, 0, comm);
 }
 
+///@cond
+static void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce )
+{
+    MPI_Request rqst;
+    ireduce_mpi_cpu_init( num_superacc, in, out, comm_mod, &rqst);
+    ireduce_mpi_cpu_wait( num_superacc, in, out, comm, comm_mod_reduce, &rqst);
+}
+///@endcond
+
 }//namespace exblas
 } //namespace dg
@@ -6,10 +6,18 @@ namespace dg
 {
 
 //there is probably a better class in boost...
-/*!@brief Manager class that invokes the \c clone() method on the managed ptr when copied
+/*!@brief Manager class that invokes the \c clone() method on the managed ptr when written to
 *
-* When copied invokes a deep copy using the \c clone() method.
+* Copies share the managed object and only the first write access of a copy
+* invokes a deep copy using the \c clone() method (copy-on-write). Copying a
+* \c ClonePtr is thus O(1) in time and memory as long as the payload is only
+* read, which matters for solver classes that hold geometries or assembled
+* matrices: their copies no longer duplicate every grid.
 * This class is most useful when a class needs to hold a polymorphic, Cloneable oject as a variable.
+* @note Write access means any of the non-const accessors ( \c get, \c
+* operator* and \c operator-> ): on a shared object these clone before they
+* return, so prefer the const accessors for read access to keep the sharing
+* alive.
 @tparam Cloneable a type that may be uncopyable/unassignable but provides the \c clone() method with signature
  -  \c Cloneable* \c clone() \c const;
 @ingroup lowlevel
@@ -35,38 +43,28 @@ struct ClonePtr
     ClonePtr( const Cloneable& src) : m_ptr( src.clone() ) { }
 
     /**
-    * @brief deep copy the given handle using the \c clone() method of \c Cloneable
-    * @param src an oject to copy, clones the contained object if not empty
+    * @brief share the managed object (copy-on-write)
+    *
+    * No clone happens here: the contained object is deep copied only when a
+    * copy later requests write access while the object is still shared
+    * @param src an oject to copy
     */
-    ClonePtr( const ClonePtr& src) : m_ptr( src.m_ptr.get() == nullptr ? nullptr : src.m_ptr->clone() ) { }
+    ClonePtr( const ClonePtr& src) = default;
     /**
-    * @brief deep copy the given handle using the \c clone() method of \c Cloneable
-    * @param src an oject to copy and swap
+    * @brief share the managed object (copy-on-write)
+    * @param src an oject to copy
     */
-    ClonePtr& operator=( const ClonePtr& src)
-    {
-        //copy and swap
-        ClonePtr tmp(src);
-        swap( *this, tmp );
-        return *this;
-    }
+    ClonePtr& operator=( const ClonePtr& src) = default;
     /**
      * @brief Steal resources (move construct)
      * @param src an object to steal pointer from
      */
-    ClonePtr( ClonePtr&& src) noexcept : m_ptr( nullptr)
-    {
-        swap( *this, src); //steal resource
-    }
+    ClonePtr( ClonePtr&& src) noexcept = default;
     /**
      * @brief Steal resources (move assignment)
      * @param src an object to steal pointer from
      */
-    ClonePtr& operator=( ClonePtr&& src) noexcept
-    {
-        swap( *this, src );
-        return *this;
-    }
+    ClonePtr& operator=( ClonePtr&& src) noexcept = default;
     /**
     * @brief swap the managed pointers
     *
@@ -99,8 +97,19 @@ struct ClonePtr
     void reset( Cloneable* ptr){
         m_ptr.reset( ptr);
     }
-    ///Releases ownership of managed object, \c get() returns \c nullptr after call
-    Cloneable* release() noexcept { m_ptr.release();}
+    /**
+    * @brief Releases ownership of managed object, \c get() returns \c nullptr after call
+    *
+    * The caller receives an object that no other \c ClonePtr shares, so if
+    * the managed object is currently shared with copies the returned object
+    * is a clone and the copies keep the original
+    * @return exclusively owned object or \c nullptr if no object owned
+    */
+    Cloneable* release(){
+        Cloneable* ptr = m_ptr ? m_ptr->clone() : nullptr;
+        m_ptr.reset();
+        return ptr;
+    }
     /**
     * @brief Clone the given object and replace the currently held one
     * @param src a Cloneable object
@@ -112,9 +121,10 @@ struct ClonePtr
 
     /**
     * @brief Get a pointer to the object on the heap
+    * @note clones the object first if it is shared with copies (write access)
     * @return a pointer to the Cloneable object or \c nullptr if no object owned
     */
-    Cloneable * get() {return m_ptr.get();}
+    Cloneable * get() {detach(); return m_ptr.get();}
     /**
     * @brief Get a constant pointer to the object on the heap
     * @return a pointer to the Cloneable object or \c nullptr if no object owned
@@ -122,11 +132,13 @@ struct ClonePtr
     const Cloneable* get() const {return m_ptr.get();}
 
     ///Dereference pointer to owned object, i.e. \c *get()
-    Cloneable& operator*() { return *m_ptr;}
+    ///@note clones the object first if it is shared with copies (write access)
+    Cloneable& operator*() { detach(); return *m_ptr;}
     ///Dereference pointer to owned object, i.e. \c *get()
     const Cloneable& operator*() const { return *m_ptr;}
     ///Dereference pointer to owned object, i.e. \c get()
-    Cloneable* operator->() { return m_ptr.operator->();}
+    ///@note clones the object first if it is shared with copies (write access)
+    Cloneable* operator->() { detach(); return m_ptr.operator->();}
     ///Dereference pointer to owned object, i.e. \c get()
     const Cloneable* operator->()const { return m_ptr.operator->();}
     ///\c true if \c *this owns an object, \c false else
@@ -134,7 +146,15 @@ struct ClonePtr
 
 
     private:
-    std::unique_ptr<Cloneable> m_ptr;
+    //deep copy the payload iff it is shared with other ClonePtr (the pattern
+    //"clone the stages of a solver, modify each" thus clones exactly as often
+    //as the old always-deep-copy behaviour)
+    void detach()
+    {
+        if( m_ptr && m_ptr.use_count() > 1)
+            m_ptr.reset( m_ptr->clone());
+    }
+    std::shared_ptr<Cloneable> m_ptr;
 };
 
 //Memory buffer class: data can be written even if the object is const
@@ -144,6 +164,10 @@ struct ClonePtr
 * this class is most useful as a memory buffer for classes that need
 * some workspace to fulfill their task but do otherwise not change their state. A buffer object
 can be declared const while the data it holds are still writeable.
+* @note In contrast to \c ClonePtr copies of a \c Buffer always deep copy:
+* the payload is mutable workspace by design ( \c data() hands out write
+* access even on const objects), so copy-on-write sharing would detach on
+* every access and buy nothing.
 * @tparam T must be default constructible and copyable
 * @ingroup lowlevel
 */
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include "exceptions.h"
+#include "tensor_traits.h"
+
+/*!@file
+ * @brief Memory usage introspection and budget enforcement
+ */
+namespace dg
+{
+///@cond
+namespace detail
+{
+struct MemoryRegistry
+{
+    std::map<std::string, size_t> tags;
+    size_t total = 0, peak = 0, budget = 0;
+};
+inline MemoryRegistry& memory_registry()
+{
+    static MemoryRegistry registry;
+    return registry;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief A readable report of all currently registered allocations
+ *
+ * List every registered owner tag with its accumulated size together with
+ * the current total, the peak total and the budget (if one is set with
+ * \c dg::set_memory_budget). Only allocations that were announced with
+ * \c dg::register_memory or \c dg::MemoryTicket appear; the solver
+ * classes (e.g. \c dg::PCG, \c dg::NestedGrids) register their workspace
+ * themselves.
+ * @note the registered sizes are per process
+ * @return the report, one line per tag
+ * @ingroup lowlevel
+ */
+inline std::string memory_report()
+{
+    const auto& reg = detail::memory_registry();
+    auto in_MB = []( size_t bytes){ return (double)bytes/1e6;};
+    std::stringstream out;
+    out << std::fixed << std::setprecision(3);
+    for( const auto& tag : reg.tags)
+        out << "# "<<std::setw(40)<<tag.first<<" "
+            <<std::setw(12)<<in_MB(tag.second)<<" MB\n";
+    out << "# "<<std::setw(40)<<"total"<<" "
+        <<std::setw(12)<<in_MB(reg.total)<<" MB\n";
+    out << "# "<<std::setw(40)<<"peak"<<" "
+        <<std::setw(12)<<in_MB(reg.peak)<<" MB\n";
+    if( reg.budget != 0)
+        out << "# "<<std::setw(40)<<"budget"<<" "
+            <<std::setw(12)<<in_MB(reg.budget)<<" MB\n";
+    return out.str();
+}
+
+/**
+ * @brief Set a memory budget that registrations may not exceed
+ *
+ * Once set, any \c dg::register_memory call that pushes the registered
+ * total above the budget throws a \c dg::Error containing
+ * \c dg::memory_report(). This fails fast with a readable account of who
+ * holds the memory instead of an out-of-memory error at allocation time
+ * deep inside a constructor.
+ * @param bytes the budget per process (0, the default, disables the check)
+ * @ingroup lowlevel
+ */
+inline void set_memory_budget( size_t bytes)
+{
+    detail::memory_registry().budget = bytes;
+}
+///@brief The current budget set with \c set_memory_budget
+///@ingroup lowlevel
+inline size_t memory_budget()
+{
+    return detail::memory_registry().budget;
+}
+
+/**
+ * @brief Register an allocation with the memory registry
+ *
+ * @param tag the owner of the allocation; repeated registrations under the
+ * same tag accumulate
+ * @param bytes the size of the allocation
+ * @throw dg::Error if a budget is set and the registered total exceeds it
+ * @sa the RAII companion \c dg::MemoryTicket
+ * @ingroup lowlevel
+ */
+inline void register_memory( const std::string& tag, size_t bytes)
+{
+    auto& reg = detail::memory_registry();
+    reg.tags[tag] += bytes;
+    reg.total += bytes;
+    if( reg.total > reg.peak)
+        reg.peak = reg.total;
+    if( reg.budget != 0 && reg.total > reg.budget)
+        throw Error( Message(_ping_)<<"Memory budget exceeded registering '"
+            <<tag<<"'\n"<<memory_report());
+}
+/**
+ * @brief Remove a previously registered allocation from the registry
+ * @param tag the owner given in \c register_memory
+ * @param bytes the size given in \c register_memory
+ * @ingroup lowlevel
+ */
+inline void deregister_memory( const std::string& tag, size_t bytes)
+{
+    auto& reg = detail::memory_registry();
+    auto it = reg.tags.find( tag);
+    if( it == reg.tags.end())
+        return;
+    bytes = bytes > it->second ? it->second : bytes;
+    it->second -= bytes;
+    reg.total -= bytes;
+    if( it->second == 0)
+        reg.tags.erase( it);
+}
+
+///@cond
+template<class ContainerType>
+size_t bytes_of( const ContainerType& v);
+namespace detail
+{
+template<class T>
+size_t doBytes( const T&, AnyScalarTag)
+{
+    return sizeof(T);
+}
+template<class ContainerType>
+size_t doBytes( const ContainerType& v, SharedVectorTag)
+{
+    return v.size()*sizeof(get_value_type<ContainerType>);
+}
+template<class ContainerType>
+size_t doBytes( const ContainerType& v, MPIVectorTag)
+{
+    return bytes_of( v.data());
+}
+template<class ContainerType>
+size_t doBytes( const ContainerType& v, RecursiveVectorTag)
+{
+    size_t sum = 0;
+    for( unsigned i=0; i<v.size(); i++)
+        sum += bytes_of( v[i]);
+    return sum;
+}
+template<class ContainerType>
+size_t doBytes( const ContainerType& v, StdMapTag)
+{
+    size_t sum = 0;
+    for( const auto& el : v)
+        sum += bytes_of( el.second);
+    return sum;
+}
+}//namespace detail
+///@endcond
+/**
+ * @brief The number of bytes a container holds
+ *
+ * Recurses through recursive containers and returns the local size for MPI
+ * vectors
+ * @param v the container (may be any type in \ref dispatch)
+ * @ingroup lowlevel
+ */
+template<class ContainerType>
+size_t bytes_of( const ContainerType& v)
+{
+    return detail::doBytes( v, get_tensor_category<ContainerType>());
+}
+
+/**
+ * @brief RAII registration of an allocation with the memory registry
+ *
+ * Register in the constructor, deregister in the destructor. Classes that
+ * hold large workspace (solvers, multigrid hierarchies) keep a ticket as a
+ * member so the registry always reflects the live allocations:
+ * @code{.cpp}
+ * m_ticket = dg::MemoryTicket( "dg::PCG", 3*dg::bytes_of( copyable));
+ * @endcode
+ * @ingroup lowlevel
+ */
+struct MemoryTicket
+{
+    ///@brief Register nothing
+    MemoryTicket() = default;
+    /**
+     * @brief Call <tt> dg::register_memory( tag, bytes)</tt>
+     * @param tag the owner of the allocation
+     * @param bytes the size of the allocation
+     * @throw dg::Error if a budget is set and the registered total exceeds
+     * it (in which case nothing is registered)
+     */
+    MemoryTicket( std::string tag, size_t bytes):
+        m_tag( std::move( tag)), m_bytes( bytes)
+    {
+        try{
+            register_memory( m_tag, m_bytes);
+        }catch( ...){
+            deregister_memory( m_tag, m_bytes);
+            m_bytes = 0;
+            throw;
+        }
+    }
+    MemoryTicket( const MemoryTicket& src): MemoryTicket( src.m_tag, src.m_bytes){}
+    MemoryTicket( MemoryTicket&& src) noexcept: m_tag( std::move(src.m_tag)),
+        m_bytes( src.m_bytes)
+    {
+        src.m_bytes = 0;
+    }
+    MemoryTicket& operator=( MemoryTicket src) noexcept
+    {
+        std::swap( m_tag, src.m_tag);
+        std::swap( m_bytes, src.m_bytes);
+        return *this;
+    }
+    ///@brief Call <tt> dg::deregister_memory( tag, bytes)</tt>
+    ~MemoryTicket()
+    {
+        deregister_memory( m_tag, m_bytes);
+    }
+    private:
+    std::string m_tag;
+    size_t m_bytes = 0;
+};
+
+}//namespace dg
@@ -1,6 +1,9 @@
 #include <iostream>
+#include <vector>
 
 #include "memory.h"
+#include "memory_report.h"
+#include "tensor_traits_std.h"
 
 struct aAnimal
 {
@@ -64,6 +67,19 @@ int main()
         h0->speak();
 
     }
+    {
+        std::cout << "Test copy-on-write sharing of ClonePtr\n";
+        dg::ClonePtr<aAnimal> c0( new Cat()), c1( c0); //copy does not clone
+        const dg::ClonePtr<aAnimal>& r0 = c0,& r1 = c1; //const access keeps sharing
+        std::cout << "Copies share the object:    "
+                  <<( r0.get() == r1.get() ? "PASSED" : "FAILED")<<"\n";
+        c1->speak(); //write access to a shared object clones
+        std::cout << "Write access detaches copy: "
+                  <<( r0.get() != r1.get() ? "PASSED" : "FAILED")<<"\n";
+        aAnimal* unshared = r1.get() == nullptr ? nullptr : c1.get();
+        std::cout << "Unique object not re-cloned:"
+                  <<( unshared == r1.get() ? "PASSED" : "FAILED")<<"\n";
+    }
     {
         std::cout << "Test correct behaviour of buffer class with mouse\n";
         dg::Buffer<Mouse> buffer;
@@ -72,6 +88,28 @@ int main()
         buffer2.data().speak();
         std::swap( buffer, buffer2);
     }
+    {
+        std::cout << "Test memory registry and budget enforcement\n";
+        std::vector<double> v( 100, 0.);
+        std::cout << "bytes_of( v) "<<dg::bytes_of( v)<<" (800)\n";
+        dg::set_memory_budget( 2000);
+        dg::MemoryTicket first( "first", dg::bytes_of( v));
+        {
+            dg::MemoryTicket second( "second", 1000);
+            std::cout << dg::memory_report();
+            try{
+                dg::register_memory( "third", 1000);
+                std::cout << "ERROR: budget not enforced!\n";
+            }catch( dg::Error& e){
+                std::cout << "Budget correctly enforced! Message:\n";
+                std::cout << e.what()<<"\n";
+                dg::deregister_memory( "third", 1000);
+            }
+        }
+        std::cout << "After tickets expired:\n";
+        std::cout << dg::memory_report();
+        dg::set_memory_budget( 0);
+    }
 
     return 0;
 }
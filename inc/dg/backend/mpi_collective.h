@@ -1,5 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <map>
+#include <memory>
+#include <vector>
 #include <thrust/sequence.h>
 #include <thrust/sort.h>
 #include <thrust/gather.h>
@@ -23,10 +28,22 @@ namespace dg{
  * to send (or gather from) and connects it to an intermediate "store"
  * In this way gather and scatter are defined with respect to the buffer and
  * the store is the vector.
+ *
+ * For host resident data the all-to-all exchange is hierarchical: the ranks
+ * of a shared-memory node first deposit their data in a window allocated
+ * with \c MPI_Win_allocate_shared, then only the first rank of each node
+ * participates in the inter-node \c MPI_Alltoallv with node-aggregated
+ * messages, and finally distributes the received data back through the
+ * window. With several ranks per node this replaces the many small
+ * intra-node messages of a flat \c MPI_Alltoallv by plain memory copies and
+ * reduces the number of network messages from (ranks)^2 to (nodes)^2.
+ * Device resident data keeps the flat exchange (cuda-aware MPI handles
+ * device pointers directly, which a host window cannot).
  */
 template<class Index, class Vector>
 struct Collective
 {
+    using value_type = get_value_type<Vector>;
     Collective(){
         m_comm = MPI_COMM_NULL;
     }
@@ -49,15 +66,15 @@ struct Collective
         MPI_Comm_rank( m_comm, &rank);
         MPI_Comm_size( m_comm, &size);
         assert( sendTo.size() == (unsigned)size);
-        thrust::host_vector<unsigned> global( size*size);
-        MPI_Allgather( sendTo.data(), size, MPI_UNSIGNED,
-                       global.data(), size, MPI_UNSIGNED,
-                       m_comm);
-        for( unsigned i=0; i<(unsigned)size; i++)
-            recvFrom[i] = global[i*size+rank];
+        //a personalized count exchange scales with the communicator size,
+        //unlike an Allgather of the full size*size count matrix, which
+        //dominates the setup time beyond a few thousand ranks
+        MPI_Alltoall( sendTo.data(), 1, MPI_INT,
+                      recvFrom.data(), 1, MPI_INT, m_comm);
         thrust::exclusive_scan( sendTo.begin(),   sendTo.end(),   accS.begin());
         thrust::exclusive_scan( recvFrom.begin(), recvFrom.end(), accR.begin());
         m_sendTo=sendTo, m_recvFrom=recvFrom, m_accS=accS, m_accR=accR;
+        construct_node_exchange( rank, size);
     }
     /**
      * @brief Number of processes in the communicator
@@ -69,8 +86,10 @@ struct Collective
     unsigned size() const {return values_size();}
     MPI_Comm comm() const {return m_comm;}
 
-    void transpose(){ m_sendTo.swap( m_recvFrom);}
-    void invert(){ m_sendTo.swap( m_recvFrom);}
+    //the node exchange plans are laid out for the original orientation only,
+    //a transposed object falls back to the flat MPI_Alltoallv
+    void transpose(){ m_sendTo.swap( m_recvFrom); m_node.reset();}
+    void invert(){ m_sendTo.swap( m_recvFrom); m_node.reset();}
 
     void scatter( const Vector& values, Vector& store) const;
     void gather( const Vector& store, Vector& values) const;
@@ -88,10 +107,54 @@ struct Collective
     private:
     unsigned sendTo( unsigned pid) const {return m_sendTo[pid];}
     unsigned recvFrom( unsigned pid) const {return m_recvFrom[pid];}
+    //all shared-memory resources of the node exchange; held by shared_ptr
+    //because MPI_Win_free is collective and copies of this object on the
+    //same ranks must free the window exactly once
+    struct NodeHandles
+    {
+        MPI_Comm node = MPI_COMM_NULL;    //all ranks of m_comm on my node
+        MPI_Comm leaders = MPI_COMM_NULL; //rank 0 of every node
+        MPI_Win win_v = MPI_WIN_NULL, win_s = MPI_WIN_NULL;
+        value_type *my_v = nullptr, *my_s = nullptr; //my segments
+        std::vector<value_type*> seg_v, seg_s; //all local segments (leader)
+        bool is_leader = false;
+        ~NodeHandles()
+        {
+            int finalized;
+            MPI_Finalized( &finalized);
+            if( finalized)
+                return;
+            if( win_v != MPI_WIN_NULL)
+            {
+                MPI_Win_unlock_all( win_v);
+                MPI_Win_free( &win_v);
+            }
+            if( win_s != MPI_WIN_NULL)
+            {
+                MPI_Win_unlock_all( win_s);
+                MPI_Win_free( &win_s);
+            }
+            if( leaders != MPI_COMM_NULL)
+                MPI_Comm_free( &leaders);
+            if( node != MPI_COMM_NULL)
+                MPI_Comm_free( &node);
+        }
+    };
+    //a contiguous chunk of a node-local window segment
+    struct PlanEntry
+    {
+        unsigned seg; //node rank owning the segment
+        size_t offset, size; //in elements
+    };
+    void construct_node_exchange( int rank, int size);
+    void node_scatter( const value_type* values, value_type* store) const;
+    void node_gather( const value_type* gatherFrom, value_type* values) const;
 #ifdef _DG_CUDA_UNAWARE_MPI
     thrust::host_vector<int> m_sendTo,   m_accS;
     thrust::host_vector<int> m_recvFrom, m_accR;
-    dg::Buffer<thrust::host_vector<get_value_type<Vector> >> m_values, m_store;
+    //pinned staging buffers make the host-device bounce copies run at full
+    //PCIe speed
+    dg::Buffer<PinnedVec_t<get_value_type<Vector> >> m_values, m_store;
 #else
 //surprisingly MPI_Alltoallv wants the integers to be on the host, only
 //the data is on the device (does this question the necessity of Index?)
@@ -99,8 +162,225 @@ struct Collective
     thrust::host_vector<int> m_recvFrom, m_accR; //accumulated recv
 #endif // _DG_CUDA_UNAWARE_MPI
     MPI_Comm m_comm;
+    //node exchange (empty if flat MPI_Alltoallv is used); note that copies
+    //of this object share the staging windows, just as they would share the
+    //network, so concurrent calls on copies are not possible
+    std::shared_ptr<NodeHandles> m_node;
+    std::vector<PlanEntry> m_packPlan, m_unpackPlan; //leader only
+    thrust::host_vector<int> m_nodeSendTo, m_nodeAccS; //counts between nodes
+    thrust::host_vector<int> m_nodeRecvFrom, m_nodeAccR; //leader only
+    dg::Buffer<thrust::host_vector<value_type>> m_nodeSendBuf, m_nodeRecvBuf;
 };
 
+template<class Index, class Vector>
+void Collective<Index, Vector>::construct_node_exchange( int rank, int size)
+{
+    m_node.reset();
+#ifndef _DG_CUDA_UNAWARE_MPI
+    if( std::is_same< get_execution_policy<Vector>, CudaTag>::value)
+        return; //cuda-aware MPI transfers device buffers directly
+#endif //_DG_CUDA_UNAWARE_MPI
+    MPI_Comm node;
+    MPI_Comm_split_type( m_comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL,
+        &node);
+    int node_rank, node_size;
+    MPI_Comm_rank( node, &node_rank);
+    MPI_Comm_size( node, &node_size);
+    int leader = rank; //the global rank of node rank 0 identifies the node
+    MPI_Bcast( &leader, 1, MPI_INT, 0, node);
+    std::vector<int> info = {leader, node_rank}, all( 2*size);
+    MPI_Allgather( info.data(), 2, MPI_INT, all.data(), 2, MPI_INT, m_comm);
+    std::map<int, std::vector<std::array<int,2>>> nodes; //{node rank, rank}
+    for( int r=0; r<size; r++)
+        nodes[ all[2*r]].push_back( {all[2*r+1], r});
+    if( (int)nodes.size() == size)
+    { //one rank per node: nothing to gain over the flat exchange
+        MPI_Comm_free( &node);
+        return;
+    }
+    for( auto& n : nodes)
+        std::sort( n.second.begin(), n.second.end());
+    m_node = std::make_shared<NodeHandles>();
+    m_node->node = node;
+    m_node->is_leader = (node_rank == 0);
+    MPI_Comm_split( m_comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank,
+        &m_node->leaders);
+    MPI_Win_allocate_shared( (MPI_Aint)values_size()*sizeof(value_type),
+        sizeof(value_type), MPI_INFO_NULL, node, &m_node->my_v,
+        &m_node->win_v);
+    MPI_Win_allocate_shared( (MPI_Aint)store_size()*sizeof(value_type),
+        sizeof(value_type), MPI_INFO_NULL, node, &m_node->my_s,
+        &m_node->win_s);
+    MPI_Win_lock_all( MPI_MODE_NOCHECK, m_node->win_v);
+    MPI_Win_lock_all( MPI_MODE_NOCHECK, m_node->win_s);
+    //the leader only needs the counts of the ranks on its own node, not
+    //the full count matrix of the communicator: rows[l] is what node rank
+    //l sends to every rank, cols[m] is what node rank m receives from
+    //every rank
+    thrust::host_vector<int> rows, cols;
+    if( node_rank == 0)
+        rows.resize( (size_t)node_size*size), cols.resize( (size_t)node_size*size);
+    MPI_Gather( m_sendTo.data(), size, MPI_INT,
+                rows.data(), size, MPI_INT, 0, node);
+    MPI_Gather( m_recvFrom.data(), size, MPI_INT,
+                cols.data(), size, MPI_INT, 0, node);
+    if( node_rank != 0)
+        return;
+    //the leader aggregates the messages of all ranks on its node
+    m_node->seg_v.resize( node_size), m_node->seg_s.resize( node_size);
+    for( int r=0; r<node_size; r++)
+    {
+        MPI_Aint sz;
+        int du;
+        MPI_Win_shared_query( m_node->win_v, r, &sz, &du, &m_node->seg_v[r]);
+        MPI_Win_shared_query( m_node->win_s, r, &sz, &du, &m_node->seg_s[r]);
+    }
+    //exclusive prefix sums over the send (rows) and receive (cols) counts
+    //of the ranks on my node give the offsets into their window segments
+    std::vector<std::vector<size_t>> rowpref( node_size), colpref( node_size);
+    for( int l=0; l<node_size; l++)
+    {
+        rowpref[l].assign( size, 0), colpref[l].assign( size, 0);
+        for( int q=1; q<size; q++)
+        {
+            rowpref[l][q] = rowpref[l][q-1] + rows[(size_t)l*size+q-1];
+            colpref[l][q] = colpref[l][q-1] + cols[(size_t)l*size+q-1];
+        }
+    }
+    unsigned num_nodes = nodes.size();
+    m_nodeSendTo = m_nodeRecvFrom = thrust::host_vector<int>( num_nodes, 0);
+    m_nodeAccS = m_nodeAccR = m_nodeSendTo;
+    m_packPlan.clear(), m_unpackPlan.clear();
+    //the wire format of a message between two nodes is: for each
+    //destination rank (in node rank order) the chunks of all source ranks
+    //(in node rank order); both sides derive it from the global count matrix
+    unsigned n = 0;
+    for( const auto& other : nodes) //ascending == rank order in leaders comm
+    {
+        for( const auto& dest : other.second)
+        for( int l=0; l<node_size; l++)
+        {
+            size_t len = rows[ (size_t)l*size + dest[1]];
+            if( len > 0)
+                m_packPlan.push_back( { (unsigned)l, rowpref[l][dest[1]], len});
+            m_nodeSendTo[n] += len;
+        }
+        for( int m=0; m<node_size; m++)
+        for( const auto& src : other.second)
+        {
+            size_t len = cols[ (size_t)m*size + src[1]];
+            if( len > 0)
+                m_unpackPlan.push_back( { (unsigned)m, colpref[m][src[1]], len});
+            m_nodeRecvFrom[n] += len;
+        }
+        n++;
+    }
+    thrust::exclusive_scan( m_nodeSendTo.begin(), m_nodeSendTo.end(),
+        m_nodeAccS.begin());
+    thrust::exclusive_scan( m_nodeRecvFrom.begin(), m_nodeRecvFrom.end(),
+        m_nodeAccR.begin());
+    m_nodeSendBuf.data().resize( thrust::reduce( m_nodeSendTo.begin(),
+        m_nodeSendTo.end()));
+    m_nodeRecvBuf.data().resize( thrust::reduce( m_nodeRecvFrom.begin(),
+        m_nodeRecvFrom.end()));
+}
+
+template<class Index, class Vector>
+void Collective<Index, Vector>::node_scatter( const value_type* values,
+    value_type* store) const
+{
+    const NodeHandles& h = *m_node;
+    if( values_size() > 0)
+        std::copy( values, values + values_size(), h.my_v);
+    MPI_Win_sync( h.win_v);
+    MPI_Barrier( h.node);
+    if( h.is_leader)
+    {
+        MPI_Win_sync( h.win_v);
+        thrust::host_vector<value_type>& sendbuf = m_nodeSendBuf.data();
+        thrust::host_vector<value_type>& recvbuf = m_nodeRecvBuf.data();
+        size_t pos = 0;
+        for( const PlanEntry& e : m_packPlan)
+        {
+            std::copy( h.seg_v[e.seg] + e.offset,
+                h.seg_v[e.seg] + e.offset + e.size,
+                thrust::raw_pointer_cast( sendbuf.data()) + pos);
+            pos += e.size;
+        }
+        MPI_Alltoallv(
+                thrust::raw_pointer_cast( sendbuf.data()),
+                thrust::raw_pointer_cast( m_nodeSendTo.data()),
+                thrust::raw_pointer_cast( m_nodeAccS.data()),
+                getMPIDataType<value_type>(),
+                thrust::raw_pointer_cast( recvbuf.data()),
+                thrust::raw_pointer_cast( m_nodeRecvFrom.data()),
+                thrust::raw_pointer_cast( m_nodeAccR.data()),
+                getMPIDataType<value_type>(), h.leaders);
+        pos = 0;
+        for( const PlanEntry& e : m_unpackPlan)
+        {
+            std::copy( thrust::raw_pointer_cast( recvbuf.data()) + pos,
+                thrust::raw_pointer_cast( recvbuf.data()) + pos + e.size,
+                h.seg_s[e.seg] + e.offset);
+            pos += e.size;
+        }
+        MPI_Win_sync( h.win_s);
+    }
+    MPI_Barrier( h.node);
+    MPI_Win_sync( h.win_s);
+    if( store_size() > 0)
+        std::copy( h.my_s, h.my_s + store_size(), store);
+}
+
+template<class Index, class Vector>
+void Collective<Index, Vector>::node_gather( const value_type* gatherFrom,
+    value_type* values) const
+{
+    const NodeHandles& h = *m_node;
+    if( store_size() > 0)
+        std::copy( gatherFrom, gatherFrom + store_size(), h.my_s);
+    MPI_Win_sync( h.win_s);
+    MPI_Barrier( h.node);
+    if( h.is_leader)
+    {
+        MPI_Win_sync( h.win_s);
+        //the gather sends each chunk back to where the scatter took it
+        //from, so the plans and counts simply exchange their roles
+        thrust::host_vector<value_type>& sendbuf = m_nodeRecvBuf.data();
+        thrust::host_vector<value_type>& recvbuf = m_nodeSendBuf.data();
+        size_t pos = 0;
+        for( const PlanEntry& e : m_unpackPlan)
+        {
+            std::copy( h.seg_s[e.seg] + e.offset,
+                h.seg_s[e.seg] + e.offset + e.size,
+                thrust::raw_pointer_cast( sendbuf.data()) + pos);
+            pos += e.size;
+        }
+        MPI_Alltoallv(
+                thrust::raw_pointer_cast( sendbuf.data()),
+                thrust::raw_pointer_cast( m_nodeRecvFrom.data()),
+                thrust::raw_pointer_cast( m_nodeAccR.data()),
+                getMPIDataType<value_type>(),
+                thrust::raw_pointer_cast( recvbuf.data()),
+                thrust::raw_pointer_cast( m_nodeSendTo.data()),
+                thrust::raw_pointer_cast( m_nodeAccS.data()),
+                getMPIDataType<value_type>(), h.leaders);
+        pos = 0;
+        for( const PlanEntry& e : m_packPlan)
+        {
+            std::copy( thrust::raw_pointer_cast( recvbuf.data()) + pos,
+                thrust::raw_pointer_cast( recvbuf.data()) + pos + e.size,
+                h.seg_v[e.seg] + e.offset);
+            pos += e.size;
+        }
+        MPI_Win_sync( h.win_v);
+    }
+    MPI_Barrier( h.node);
+    MPI_Win_sync( h.win_v);
+    if( values_size() > 0)
+        std::copy( h.my_v, h.my_v + values_size(), values);
+}
+
 template< class Index, class Device>
 void Collective<Index, Device>::scatter( const Device& values, Device& store) const
 {
@@ -119,7 +399,11 @@ void Collective<Index, Device>::scatter( const Device& values, Device& store) co
 #ifdef _DG_CUDA_UNAWARE_MPI
     m_values.data() = values;
     m_store.data().resize( store.size());
-    MPI_Alltoallv(
+    if( m_node)
+        node_scatter( thrust::raw_pointer_cast( m_values.data().data()),
+                      thrust::raw_pointer_cast( m_store.data().data()));
+    else
+        MPI_Alltoallv(
             thrust::raw_pointer_cast( m_values.data().data()),
             thrust::raw_pointer_cast( m_sendTo.data()),
             thrust::raw_pointer_cast( m_accS.data()), getMPIDataType<get_value_type<Device> >(),
@@ -128,7 +412,11 @@ void Collective<Index, Device>::scatter( const Device& values, Device& store) co
             thrust::raw_pointer_cast( m_accR.data()), getMPIDataType<get_value_type<Device> >(), m_comm);
     store = m_store.data();
 #else
-    MPI_Alltoallv(
+    if( m_node) //only constructed for host resident data
+        node_scatter( thrust::raw_pointer_cast( values.data()),
+                      thrust::raw_pointer_cast( store.data()));
+    else
+        MPI_Alltoallv(
             thrust::raw_pointer_cast( values.data()),
             thrust::raw_pointer_cast( m_sendTo.data()),
             thrust::raw_pointer_cast( m_accS.data()), getMPIDataType<get_value_type<Device> >(),
@@ -157,7 +445,11 @@ void Collective<Index, Device>::gather( const Device& gatherFrom, Device& values
 #ifdef _DG_CUDA_UNAWARE_MPI
     m_store.data() = gatherFrom;
     m_values.data().resize( values.size());
-    MPI_Alltoallv(
+    if( m_node)
+        node_gather( thrust::raw_pointer_cast( m_store.data().data()),
+                     thrust::raw_pointer_cast( m_values.data().data()));
+    else
+        MPI_Alltoallv(
             thrust::raw_pointer_cast( m_store.data().data()),
             thrust::raw_pointer_cast( m_recvFrom.data()),
             thrust::raw_pointer_cast( m_accR.data()), getMPIDataType<get_value_type<Device> >(),
@@ -166,7 +458,11 @@ void Collective<Index, Device>::gather( const Device& gatherFrom, Device& values
             thrust::raw_pointer_cast( m_accS.data()), getMPIDataType<get_value_type<Device> >(), m_comm);
     values = m_values.data();
 #else
-    MPI_Alltoallv(
+    if( m_node) //only constructed for host resident data
+        node_gather( thrust::raw_pointer_cast( gatherFrom.data()),
+                     thrust::raw_pointer_cast( values.data()));
+    else
+        MPI_Alltoallv(
             thrust::raw_pointer_cast( gatherFrom.data()),
             thrust::raw_pointer_cast( m_recvFrom.data()),
             thrust::raw_pointer_cast( m_accR.data()), getMPIDataType<get_value_type<Device> >(),
@@ -202,6 +498,9 @@ is the inverse of G. (see \c aCommunicator for more details)
  * @note a scatter followed by a gather of the received values restores the original array
  * @note The order of the received elements is according to their original array index
  *   (i.e. a[0] appears before a[1]) and their process rank of origin ( i.e. values from rank 0 appear before values from rank 1)
+ * @note For host vectors the communication is node-aware: messages are
+ *   aggregated within each shared-memory node such that only one rank per
+ *   node takes part in the inter-node exchange
  */
 template< class Index, class Vector>
 struct BijectiveComm : public aCommunicator<Vector>
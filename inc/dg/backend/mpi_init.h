@@ -2,8 +2,12 @@
 
 #include <iostream>
 #include <cassert>
+#include <vector>
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h> //declare THRUST_DEVICE_SYSTEM
+#include "config.h"
+#include "mpi_progress.h"
+#include "mpi_shared.h"
 #include "../enums.h"
 
 /*!@file
@@ -30,10 +34,24 @@ namespace dg
  * @endcode
  * @param argc command line argument number
  * @param argv command line arguments
+ * @param async_progress if true, initialize with \c MPI_THREAD_MULTIPLE and
+ *  start a dedicated progress thread with \c dg::mpi_enable_async_progress.
+ *  Use on libraries without background progress where overlapping
+ *  communication (cf. \c RowColDistMat) otherwise yields nothing.
  * @ingroup misc
  */
-static inline void mpi_init( int argc, char* argv[])
+static inline void mpi_init( int argc, char* argv[], bool async_progress = false)
 {
+    if( async_progress)
+    {
+        int provided, error;
+        error = MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+        assert( error == MPI_SUCCESS && "Threaded MPI lib required!\n");
+        assert( provided == MPI_THREAD_MULTIPLE &&
+                "MPI_THREAD_MULTIPLE required for async progress!\n");
+        mpi_enable_async_progress();
+        return;
+    }
 #ifdef _OPENMP
     int provided, error;
     error = MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
@@ -43,13 +61,98 @@ static inline void mpi_init( int argc, char* argv[])
 #endif
 }
 
+///@cond
+namespace detail
+{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+//Bind the process to one of the node's GPUs and enable peer access
+//between all of them
+static inline void mpi_set_device( int rank, bool verbose)
+{
+    int num_devices=0;
+    cudaGetDeviceCount(&num_devices);
+    if(num_devices == 0)
+    {
+        std::cerr << "# No CUDA capable devices found on rank "<<rank<<std::endl;
+        MPI_Abort(MPI_COMM_WORLD, -1);
+        exit(-1);
+    }
+    //bind by node-local rank; the global rank modulo num_devices is only
+    //correct if ranks are placed node by node, not round-robin
+    MPI_Comm shm_comm;
+    MPI_Comm_split_type( MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+            MPI_INFO_NULL, &shm_comm);
+    int local_rank;
+    MPI_Comm_rank( shm_comm, &local_rank);
+    MPI_Comm_free( &shm_comm);
+    int device = local_rank % num_devices;
+    if(verbose)std::cout << "# Rank "<<rank<<" computes with device "<<device<<" !"<<std::endl;
+    cudaSetDevice( device);
+    //enable direct peer copies (NVLink where available) between the node's
+    //devices so intra-node MPI transfers of device buffers do not have to
+    //stage through host memory
+    for( int peer=0; peer<num_devices; peer++)
+    {
+        if( peer == device)
+            continue;
+        int access = 0;
+        cudaDeviceCanAccessPeer( &access, device, peer);
+        if( access)
+            cudaDeviceEnablePeerAccess( peer, 0);
+    }
+}
+#endif //THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+
+//Identify the shared memory node of a process: returns the world rank of the
+//node's first process, i.e. two processes share a node iff the id is equal
+static inline int mpi_node_id( MPI_Comm comm)
+{
+    int rank;
+    MPI_Comm_rank( comm, &rank);
+    MPI_Comm shm_comm;
+    MPI_Comm_split_type( comm, MPI_COMM_TYPE_SHARED, rank,
+            MPI_INFO_NULL, &shm_comm);
+    int node_id = rank;
+    MPI_Bcast( &node_id, 1, MPI_INT, 0, shm_comm);
+    MPI_Comm_free( &shm_comm);
+    return node_id;
+}
+//Percentage of nearest neighbor pairs in dimension dim that live on the same
+//node if cart rank r holds node node_of_cart_rank[r] (row-major coordinates,
+//i.e. the last dimension varies fastest as in MPI_Cart_create)
+static inline double mpi_intranode_fraction(
+        const std::vector<int>& node_of_cart_rank, const int np[3],
+        const int periods[3], int dim)
+{
+    int total = 0, same = 0;
+    for( int r=0; r<(int)node_of_cart_rank.size(); r++)
+    {
+        int coords[3] = { r/(np[1]*np[2]), (r/np[2])%np[1], r%np[2]};
+        coords[dim] += 1;
+        if( coords[dim] == np[dim])
+        {
+            if( !periods[dim])
+                continue;
+            coords[dim] = 0;
+        }
+        int neighbor = (coords[0]*np[1] + coords[1])*np[2] + coords[2];
+        total++;
+        if( node_of_cart_rank[r] == node_of_cart_rank[neighbor])
+            same++;
+    }
+    return total == 0 ? 100. : 100.*same/total;
+}
+}//namespace detail
+///@endcond
+
 /** @class hide_cart_warning
 * @attention Before creating a second Cartesian communicator consider freeing existing ones with \c MPI_Comm_free. (Using \c mpi_init2d and \c mpi_init3d in the same program has sometimes led to Segmentation faults in the past)
   */
 /**
 * @brief Read in number of processses and create Cartesian MPI communicator
 *
-* Also sets the GPU a process should use via \c rank\% num_devices_per_node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+* Also sets the GPU a process should use via its node-local rank and enables
+* peer access between the GPUs of a node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 * @param bcx if \c bcx==dg::PER then the communicator is periodic in x
 * @param bcy if \c bcy==dg::PER then the communicator is periodic in y
 * @param comm (write only) \c MPI_COMM_WORLD as a 2d Cartesian MPI communicator
@@ -91,17 +194,11 @@ static inline void mpi_init2d( dg::bc bcx, dg::bc bcy, MPI_Comm& comm, std::istr
     MPI_Cart_create( MPI_COMM_WORLD, 2, np, periods, true, &comm);
 
 #if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
-    int num_devices=0;
-    cudaGetDeviceCount(&num_devices);
-    if(num_devices == 0)
-    {
-        std::cerr << "# No CUDA capable devices found on rank "<<rank<<std::endl;
-        MPI_Abort(MPI_COMM_WORLD, -1);
-        exit(-1);
-    }
-    int device = rank % num_devices; //assume # of gpus/node is fixed
-    if(verbose)std::cout << "# Rank "<<rank<<" computes with device "<<device<<" !"<<std::endl;
-    cudaSetDevice( device);
+    detail::mpi_set_device( rank, verbose);
+#ifndef _DG_CUDA_UNAWARE_MPI
+    if( !dg::cuda_aware_mpi() && rank == 0)
+        std::cerr << "# WARNING: MPI library reports no CUDA support! Consider compiling with -DDG_CUDA_UNAWARE_MPI\n";
+#endif//_DG_CUDA_UNAWARE_MPI
 #endif//THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 }
 /**
@@ -133,7 +230,8 @@ static inline void mpi_init2d(unsigned& n, unsigned& Nx, unsigned& Ny, MPI_Comm
 /**
 * @brief Read in number of processses and grid size and create Cartesian MPI communicator
 *
-* Also sets the GPU a process should use via \c rank\% num_devices_per_node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+* Also sets the GPU a process should use via its node-local rank and enables
+* peer access between the GPUs of a node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 * @param bcx if \c bcx==dg::PER then the communicator is periodic in x
 * @param bcy if \c bcy==dg::PER then the communicator is periodic in y
 * @param n  rank 0 reads in from \c is and broadcasts to all processes in \c MPI_COMM_WORLD
@@ -155,7 +253,8 @@ static inline void mpi_init2d( dg::bc bcx, dg::bc bcy, unsigned& n, unsigned& Nx
 /**
 * @brief Read in number of processses and create Cartesian MPI communicator
 *
-* Also sets the GPU a process should use via \c rank\% num_devices_per_node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+* Also sets the GPU a process should use via its node-local rank and enables
+* peer access between the GPUs of a node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 * @param bcx if \c bcx==dg::PER then the communicator is periodic in x
 * @param bcy if \c bcy==dg::PER then the communicator is periodic in y
 * @param bcz if \c bcz==dg::PER then the communicator is periodic in z
@@ -197,17 +296,11 @@ static inline void mpi_init3d( dg::bc bcx, dg::bc bcy, dg::bc bcz, MPI_Comm& com
     MPI_Bcast( np, 3, MPI_INT, 0, MPI_COMM_WORLD);
     MPI_Cart_create( MPI_COMM_WORLD, 3, np, periods, true, &comm);
 #if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
-    int num_devices=0;
-    cudaGetDeviceCount(&num_devices);
-    if(num_devices == 0)
-    {
-        std::cerr << "# No CUDA capable devices found on rank "<<rank<<std::endl;
-        MPI_Abort(MPI_COMM_WORLD, -1);
-        exit(-1);
-    }
-    int device = rank % num_devices; //assume # of gpus/node is fixed
-    if(verbose)std::cout << "# Rank "<<rank<<" computes with device "<<device<<" !"<<std::endl;
-    cudaSetDevice( device);
+    detail::mpi_set_device( rank, verbose);
+#ifndef _DG_CUDA_UNAWARE_MPI
+    if( !dg::cuda_aware_mpi() && rank == 0)
+        std::cerr << "# WARNING: MPI library reports no CUDA support! Consider compiling with -DDG_CUDA_UNAWARE_MPI\n";
+#endif//_DG_CUDA_UNAWARE_MPI
 #endif//THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 }
 /**
@@ -241,7 +334,8 @@ static inline void mpi_init3d(unsigned& n, unsigned& Nx, unsigned& Ny, unsigned&
 /**
 * @brief Read in number of processses and grid size and create Cartesian MPI communicator
 *
-* Also sets the GPU via \c rank\% num_devices_per_node a process should use if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+* Also sets the GPU a process should use via its node-local rank and enables
+* peer access between the GPUs of a node if \c THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
 * @param bcx if \c bcx==dg::PER then the communicator is periodic in x
 * @param bcy if \c bcy==dg::PER then the communicator is periodic in y
 * @param bcz if \c bcz==dg::PER then the communicator is periodic in z
@@ -260,4 +354,334 @@ static inline void mpi_init3d( dg::bc bcx, dg::bc bcy, dg::bc bcz, unsigned& n,
     mpi_init3d( bcx, bcy, bcz, comm, is, verbose);
     mpi_init3d( n, Nx, Ny, Nz, comm, is, verbose);
 }
+
+/**
+* @brief Like \c mpi_init3d but with a node-aware rank order
+*
+* \c MPI_Cart_create numbers the Cartesian coordinates such that the last (z)
+* dimension varies fastest with the rank, while the scheduler may place
+* consecutive world ranks round-robin across nodes. In that case the
+* z-neighbors of the decomposition — the high-traffic direction of the
+* parallel derivatives — communicate across the network although they could
+* share a node. This function queries the shared-memory node of every
+* process (the same \c MPI_Comm_split_type mechanism that selects the GPU)
+* and renumbers the ranks node-major before creating the Cartesian
+* communicator, such that consecutive z-ranks stay on the same node wherever
+* the partition allows. If \c verbose, rank 0 reports for each direction the
+* percentage of halo messages that stay intra-node, compared to the default
+* world rank order, as an estimate of the network traffic saved.
+* @param bcx if \c bcx==dg::PER then the communicator is periodic in x
+* @param bcy if \c bcy==dg::PER then the communicator is periodic in y
+* @param bcz if \c bcz==dg::PER then the communicator is periodic in z
+* @param comm (write only) \c MPI_COMM_WORLD as a 3d Cartesian MPI communicator with node-aware rank order
+* @param is Input stream rank 0 reads parameters (\c npx, \c npy, \c npz)
+* @param verbose If true, rank 0 prints queries and information on \c std::cout
+* @ingroup misc
+* @copydoc hide_cart_warning
+*/
+static inline void mpi_init3d_node_aware( dg::bc bcx, dg::bc bcy, dg::bc bcz, MPI_Comm& comm, std::istream& is = std::cin, bool verbose = true  )
+{
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    int periods[3] = {false,false, false};
+    if( bcx == dg::PER) periods[0] = true;
+    if( bcy == dg::PER) periods[1] = true;
+    if( bcz == dg::PER) periods[2] = true;
+    int np[3];
+    if( rank == 0)
+    {
+        int num_threads = 1;
+#ifdef _OPENMP
+        num_threads = omp_get_max_threads( );
+#endif //omp
+        if(verbose) std::cout << "# Type npx and npy and npz\n";
+        is >> np[0] >> np[1]>>np[2];
+        if(verbose) std::cout << "# Computing with "
+                  << np[0]<<" x "<<np[1]<<" x "<<np[2] << " processes x "
+                  << num_threads<<" threads = "
+                  <<size*num_threads<<" total"<<std::endl;
+        if( size != np[0]*np[1]*np[2])
+        {
+            std::cerr << "ERROR: Process partition needs to match total number of processes!"<<std::endl;
+            MPI_Abort(MPI_COMM_WORLD, -1);
+            exit(-1);
+        }
+    }
+    MPI_Bcast( np, 3, MPI_INT, 0, MPI_COMM_WORLD);
+    int node_id = detail::mpi_node_id( MPI_COMM_WORLD);
+    //sort the processes by node; ties keep the world rank order such that
+    //the fastest varying Cartesian coordinate stays within a node wherever
+    //the partition allows
+    MPI_Comm ordered;
+    MPI_Comm_split( MPI_COMM_WORLD, 0, node_id, &ordered);
+    MPI_Cart_create( ordered, 3, np, periods, false, &comm);
+    MPI_Comm_free( &ordered);
+    if( verbose)
+    {
+        //node of every Cartesian rank under the default and node-aware order
+        std::vector<int> nodes_default(size), nodes_aware(size);
+        MPI_Allgather( &node_id, 1, MPI_INT, nodes_default.data(), 1,
+                MPI_INT, MPI_COMM_WORLD);
+        MPI_Allgather( &node_id, 1, MPI_INT, nodes_aware.data(), 1,
+                MPI_INT, comm);
+        if( rank == 0)
+        {
+            const char dims[3] = {'x','y','z'};
+            for( int d=0; d<3; d++)
+                std::cout << "# Topology: "<<dims[d]<<"-halo messages intra-node "
+                    << detail::mpi_intranode_fraction( nodes_aware, np, periods, d)
+                    << "% (world rank order "
+                    << detail::mpi_intranode_fraction( nodes_default, np, periods, d)
+                    << "%)"<<std::endl;
+        }
+    }
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    detail::mpi_set_device( rank, verbose);
+#ifndef _DG_CUDA_UNAWARE_MPI
+    if( !dg::cuda_aware_mpi() && rank == 0)
+        std::cerr << "# WARNING: MPI library reports no CUDA support! Consider compiling with -DDG_CUDA_UNAWARE_MPI\n";
+#endif//_DG_CUDA_UNAWARE_MPI
+#endif//THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+}
+
+/**
+* @brief Like \c mpi_init3d but optionally split off a sidecar group from \c MPI_COMM_WORLD
+*
+* Rank 0 reads the process partition \c npx, \c npy, \c npz from \c is as in
+* \c mpi_init3d. If \c MPI_COMM_WORLD holds exactly <tt>npx*npy*npz</tt>
+* processes this function behaves like \c mpi_init3d and sets
+* <tt>inter_comm = MPI_COMM_NULL</tt>. If \c MPI_COMM_WORLD holds \b more
+* processes, the excess ranks (the highest world ranks) become a \b sidecar
+* group: rank 0 then reads a second partition line for the sidecar group
+* (whose product must equal the number of excess ranks), both groups get
+* their own 3d Cartesian communicator in \c comm, and the two groups are
+* connected through the inter-communicator \c inter_comm.
+*
+* The intended use is staged in-situ processing, where the compute group
+* asynchronously ships fields to a small sidecar group that evaluates
+* diagnostics and writes output concurrently with timestepping.
+* @param bcx if \c bcx==dg::PER then the communicator is periodic in x
+* @param bcy if \c bcy==dg::PER then the communicator is periodic in y
+* @param bcz if \c bcz==dg::PER then the communicator is periodic in z
+* @param comm (write only) the 3d Cartesian communicator of the group this
+* process belongs to
+* @param inter_comm (write only) inter-communicator between the compute and
+* the sidecar group, or \c MPI_COMM_NULL if there are no sidecar ranks; the
+* rank order of each group within \c inter_comm is its \c MPI_COMM_WORLD
+* rank order
+* @param is_sidecar (write only) true if this process belongs to the sidecar
+* group
+* @param is Input stream rank 0 reads parameters (\c npx, \c npy, \c npz,
+* and if there are excess ranks also the sidecar partition)
+* @param verbose If true, rank 0 prints queries and information on \c std::cout
+* @ingroup misc
+* @copydoc hide_cart_warning
+*/
+static inline void mpi_init3d_sidecar( dg::bc bcx, dg::bc bcy, dg::bc bcz,
+    MPI_Comm& comm, MPI_Comm& inter_comm, bool& is_sidecar,
+    std::istream& is = std::cin, bool verbose = true)
+{
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    int periods[3] = {false,false, false};
+    if( bcx == dg::PER) periods[0] = true;
+    if( bcy == dg::PER) periods[1] = true;
+    if( bcz == dg::PER) periods[2] = true;
+    int np[6] = {0,0,0,0,0,0}; //compute and sidecar partition
+    if( rank == 0)
+    {
+        int num_threads = 1;
+#ifdef _OPENMP
+        num_threads = omp_get_max_threads( );
+#endif //omp
+        if(verbose) std::cout << "# Type npx and npy and npz\n";
+        is >> np[0] >> np[1] >> np[2];
+        int num_compute = np[0]*np[1]*np[2];
+        if(verbose) std::cout << "# Computing with "
+                  << np[0]<<" x "<<np[1]<<" x "<<np[2] << " processes x "
+                  << num_threads<<" threads = "
+                  <<num_compute*num_threads<<" total"<<std::endl;
+        if( size < num_compute)
+        {
+            std::cerr << "ERROR: Process partition needs to match total number of processes!"<<std::endl;
+            MPI_Abort(MPI_COMM_WORLD, -1);
+            exit(-1);
+        }
+        if( size > num_compute)
+        {
+            if(verbose) std::cout << "# Type sidecar npx and npy and npz (for the "
+                <<size - num_compute<<" excess processes)\n";
+            is >> np[3] >> np[4] >> np[5];
+            if(verbose) std::cout << "# Sidecar group with "
+                << np[3]<<" x "<<np[4]<<" x "<<np[5]<<" processes"<<std::endl;
+            if( size - num_compute != np[3]*np[4]*np[5])
+            {
+                std::cerr << "ERROR: Sidecar partition needs to match number of excess processes!"<<std::endl;
+                MPI_Abort(MPI_COMM_WORLD, -1);
+                exit(-1);
+            }
+        }
+    }
+    MPI_Bcast( np, 6, MPI_INT, 0, MPI_COMM_WORLD);
+    int num_compute = np[0]*np[1]*np[2];
+    is_sidecar = (rank >= num_compute);
+    if( size == num_compute)
+    {
+        MPI_Cart_create( MPI_COMM_WORLD, 3, np, periods, true, &comm);
+        inter_comm = MPI_COMM_NULL;
+    }
+    else
+    {
+        //keys keep the world rank order within each group so the remote
+        //leaders of the inter-communicator are world ranks 0 and num_compute
+        MPI_Comm member;
+        MPI_Comm_split( MPI_COMM_WORLD, is_sidecar ? 1 : 0, rank, &member);
+        MPI_Cart_create( member, 3, is_sidecar ? np+3 : np, periods, true,
+            &comm);
+        MPI_Intercomm_create( member, 0, MPI_COMM_WORLD,
+            is_sidecar ? 0 : num_compute, 14, &inter_comm);
+        MPI_Comm_free( &member);
+    }
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    detail::mpi_set_device( rank, verbose);
+#ifndef _DG_CUDA_UNAWARE_MPI
+    if( !dg::cuda_aware_mpi() && rank == 0)
+        std::cerr << "# WARNING: MPI library reports no CUDA support! Consider compiling with -DDG_CUDA_UNAWARE_MPI\n";
+#endif//_DG_CUDA_UNAWARE_MPI
+#endif//THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+}
+
+/**
+* @brief Split \c MPI_COMM_WORLD into ensemble member subcommunicators
+*
+* For ensemble runs, where \c MPI_COMM_WORLD executes \c num_members
+* independent copies of the same simulation (differing e.g. only in the
+* noise seed), this function splits the world into \c num_members groups of
+* contiguous world ranks. Each process additionally receives a \b peer
+* communicator connecting it to the processes on its node that have the
+* same member-local rank in another member: since all members run the same
+* code on the same grid, peers hold identical immutable objects and can
+* share them in node memory with \c dg::MPISharedVector instead of each
+* constructing a private copy.
+* @note If the members on a node do not align (e.g. a member spans several
+* nodes) the peer groups simply become smaller, down to single processes;
+* sharing then saves less but everything remains correct
+* @param num_members the number of ensemble members; must divide the size of
+* \c MPI_COMM_WORLD
+* @param member_comm (write only) the communicator of the member this
+* process belongs to (contiguous world ranks)
+* @param member_id (write only) which member this process belongs to, in
+* <tt>[0, num_members)</tt>; use it e.g. to offset the noise seed and to
+* name the output file
+* @param peer_comm (write only) node-local communicator of the processes
+* with equal member-local rank; pass it to \c dg::MPISharedVector
+* @ingroup misc
+*/
+static inline void mpi_init_ensemble( unsigned num_members,
+    MPI_Comm& member_comm, unsigned& member_id, MPI_Comm& peer_comm)
+{
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    if( (unsigned)size % num_members != 0)
+    {
+        if( rank == 0)
+            std::cerr << "ERROR: Number of members "<<num_members
+                <<" needs to divide total number of processes "<<size
+                <<"!"<<std::endl;
+        MPI_Abort(MPI_COMM_WORLD, -1);
+        exit(-1);
+    }
+    unsigned member_size = (unsigned)size/num_members;
+    member_id = (unsigned)rank/member_size;
+    MPI_Comm_split( MPI_COMM_WORLD, member_id, rank, &member_comm);
+    //peers: processes on this node with the same member-local rank
+    int member_rank;
+    MPI_Comm_rank( member_comm, &member_rank);
+    MPI_Comm node_comm;
+    MPI_Comm_split_type( MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+            MPI_INFO_NULL, &node_comm);
+    MPI_Comm_split( node_comm, member_rank, rank, &peer_comm);
+    MPI_Comm_free( &node_comm);
+}
+
+/**
+* @brief Like \c mpi_init2d but split \c MPI_COMM_WORLD into ensemble members
+*
+* Rank 0 reads the process partition \c npx, \c npy of \b one member from
+* \c is; \c MPI_COMM_WORLD must hold exactly <tt>num_members*npx*npy</tt>
+* processes. The world is split with \c mpi_init_ensemble and each member
+* gets its own 2d Cartesian communicator, so an existing program becomes an
+* ensemble driver by constructing its grid from \c comm as usual and by
+* deriving the seed and output file name from \c member_id:
+* @code
+* unsigned member_id; MPI_Comm comm, peer_comm;
+* dg::mpi_init_ensemble2d( p.bcx, p.bcy, num_members, comm, member_id,
+*     peer_comm);
+* dg::CartesianMPIGrid2d grid( 0, p.lx, 0, p.ly, p.n, p.Nx, p.Ny,
+*     p.bcx, p.bcy, comm);
+* // ... seed += member_id; output = "output_"+std::to_string(member_id);
+* @endcode
+* Large immutable host arrays can then be shared among the members of a
+* node with \c dg::MPISharedVector on \c peer_comm.
+* @param bcx if \c bcx==dg::PER then the communicator is periodic in x
+* @param bcy if \c bcy==dg::PER then the communicator is periodic in y
+* @param num_members the number of ensemble members
+* @param comm (write only) the 2d Cartesian communicator of the member this
+* process belongs to
+* @param member_id (write only) which member this process belongs to, in
+* <tt>[0, num_members)</tt>
+* @param peer_comm (write only) node-local communicator of the processes
+* with equal member-local rank; pass it to \c dg::MPISharedVector
+* @param is Input stream rank 0 reads parameters (\c npx, \c npy)
+* @param verbose If true, rank 0 prints queries and information on \c std::cout
+* @ingroup misc
+* @copydoc hide_cart_warning
+*/
+static inline void mpi_init_ensemble2d( dg::bc bcx, dg::bc bcy,
+    unsigned num_members, MPI_Comm& comm, unsigned& member_id,
+    MPI_Comm& peer_comm, std::istream& is = std::cin, bool verbose = true)
+{
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    int periods[2] = {false,false};
+    if( bcx == dg::PER) periods[0] = true;
+    if( bcy == dg::PER) periods[1] = true;
+    int np[2];
+    if( rank == 0)
+    {
+        int num_threads = 1;
+#ifdef _OPENMP
+        num_threads = omp_get_max_threads( );
+#endif //omp
+        if(verbose)std::cout << "# Type npx and npy (per member)\n";
+        is >> np[0] >> np[1];
+        if(verbose)std::cout << "# Computing "<<num_members<<" members with "
+                  << np[0]<<" x "<<np[1]<<" processes x "
+                  << num_threads<<" threads = "
+                  <<size*num_threads<<" total"<<std::endl;
+        if( (unsigned)size != num_members*(unsigned)(np[0]*np[1]))
+        {
+            std::cerr << "ERROR: Process partition times number of members needs to match total number of processes!"<<std::endl;
+            MPI_Abort(MPI_COMM_WORLD, -1);
+            exit(-1);
+        }
+    }
+    MPI_Bcast( np, 2, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Comm member_comm;
+    mpi_init_ensemble( num_members, member_comm, member_id, peer_comm);
+    MPI_Cart_create( member_comm, 2, np, periods, true, &comm);
+    MPI_Comm_free( &member_comm);
+
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    detail::mpi_set_device( rank, verbose);
+#ifndef _DG_CUDA_UNAWARE_MPI
+    if( !dg::cuda_aware_mpi() && rank == 0)
+        std::cerr << "# WARNING: MPI library reports no CUDA support! Consider compiling with -DDG_CUDA_UNAWARE_MPI\n";
+#endif//_DG_CUDA_UNAWARE_MPI
+#endif//THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+}
 } //namespace dg
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include "mpi_vector.h"
+#include "mpi_progress.h"
 #include "memory.h"
 #include "timer.h"
 
@@ -131,6 +134,8 @@ struct RowColDistMat
         MPI_Comm_compare( x.communicator(), m_c.communicator(), &result);
         assert( result == MPI_CONGRUENT || result == MPI_IDENT);
 
+        const bool stats = MPIOverlapStats::instance().enabled();
+        double t0 = stats ? MPI_Wtime() : 0.;
         //1.1 initiate communication
         MPI_Request rqst[4];
         const value_type * x_ptr = thrust::raw_pointer_cast(x.data().data());
@@ -138,8 +143,11 @@ struct RowColDistMat
         m_c.global_gather_init( x_ptr, m_buffer.data(), rqst);
         //1.2 compute inner points
         dg::blas2::symv( alpha, m_i, x.data(), beta, y.data());
+        double t1 = stats ? MPI_Wtime() : 0.;
         //2. wait for communication to finish
         m_c.global_gather_wait( x_ptr, m_buffer.data(), rqst);
+        if( stats)
+            MPIOverlapStats::instance().record( t1-t0, MPI_Wtime()-t1);
         //3. compute and add outer points
         const value_type** b_ptr = thrust::raw_pointer_cast(m_buffer.data().data());
         m_o.symv( SharedVectorTag(), get_execution_policy<ContainerType1>(), alpha, b_ptr, 1., y_ptr);
@@ -171,6 +179,8 @@ struct RowColDistMat
         MPI_Comm_compare( x.communicator(), m_c.communicator(), &result);
         assert( result == MPI_CONGRUENT || result == MPI_IDENT);
 
+        const bool stats = MPIOverlapStats::instance().enabled();
+        double t0 = stats ? MPI_Wtime() : 0.;
         //1.1 initiate communication
         MPI_Request rqst[4];
         const value_type * x_ptr = thrust::raw_pointer_cast(x.data().data());
@@ -178,18 +188,89 @@ struct RowColDistMat
         m_c.global_gather_init( x_ptr, m_buffer.data(), rqst);
         //1.2 compute inner points
         dg::blas2::symv( m_i, x.data(), y.data());
+        double t1 = stats ? MPI_Wtime() : 0.;
         //2. wait for communication to finish
         m_c.global_gather_wait( x_ptr, m_buffer.data(), rqst);
+        if( stats)
+            MPIOverlapStats::instance().record( t1-t0, MPI_Wtime()-t1);
         //3. compute and add outer points
         const value_type** b_ptr = thrust::raw_pointer_cast(m_buffer.data().data());
         m_o.symv( SharedVectorTag(), get_execution_policy<ContainerType1>(), 1., b_ptr, 1., y_ptr);
     }
 
+    /**
+    * @brief Batched Matrix Vector product for a group of vectors
+    *
+    * Computes \f$ y_k = \alpha M x_k + \beta y_k \f$ for all vectors of the
+    * group but exchanges the halos of all of them in a single batched
+    * message per neighbor (cf. the batched \c
+    * NearestNeighborComm::global_gather_init). Compared to \c x.size()
+    * separate calls to \c symv this reduces the number of messages per
+    * neighbor from \c x.size() to one, which relieves message rate and
+    * latency pressure at large numbers of ranks. For example
+    * @code
+    * std::vector<const Vector*> xs = {&ne, &Ni, &ue, &Ui};
+    * std::vector<Vector*> ys = {&dxne, &dxNi, &dxue, &dxUi};
+    * dx.symv( 1., xs, 0., ys);
+    * @endcode
+    * @tparam ContainerType container class of the vector elements
+    * @param alpha scalar
+    * @param x pointers to the input vectors
+    * @param beta scalar
+    * @param y pointers to the output vectors (size must equal \c x.size())
+    */
+    template<class ContainerType1, class ContainerType2>
+    void symv( value_type alpha, const std::vector<const ContainerType1*>& x, value_type beta, std::vector<ContainerType2*>& y) const
+    {
+        unsigned num = x.size();
+        assert( num == y.size());
+        if( !m_c.isCommunicating()) //no communication needed
+        {
+            for( unsigned k=0; k<num; k++)
+                dg::blas2::symv( alpha, m_i, x[k]->data(), beta, y[k]->data());
+            return;
+        }
+        int result;
+        for( unsigned k=0; k<num; k++)
+        {
+            MPI_Comm_compare( x[k]->communicator(), y[k]->communicator(), &result);
+            assert( result == MPI_CONGRUENT || result == MPI_IDENT);
+            MPI_Comm_compare( x[k]->communicator(), m_c.communicator(), &result);
+            assert( result == MPI_CONGRUENT || result == MPI_IDENT);
+        }
+        if( m_batch_buffers.data().size() < num)
+        {
+            m_batch_buffers.data().resize( num);
+            for( unsigned k=0; k<num; k++)
+                m_batch_buffers.data()[k] = m_c.allocate_buffer();
+        }
+        //1.1 initiate one batched communication for the whole group
+        MPI_Request rqst[4];
+        std::vector<const value_type*> x_ptrs( num);
+        for( unsigned k=0; k<num; k++)
+            x_ptrs[k] = thrust::raw_pointer_cast(x[k]->data().data());
+        m_c.global_gather_init( num, x_ptrs.data(), m_batch_buffers.data().data(), rqst);
+        //1.2 compute inner points of all fields (overlaps with communication)
+        for( unsigned k=0; k<num; k++)
+            dg::blas2::symv( alpha, m_i, x[k]->data(), beta, y[k]->data());
+        //2. wait for communication to finish
+        m_c.global_gather_wait( num, x_ptrs.data(), m_batch_buffers.data().data(), rqst);
+        //3. compute and add outer points
+        for( unsigned k=0; k<num; k++)
+        {
+            const value_type** b_ptr = thrust::raw_pointer_cast(m_batch_buffers.data()[k].data());
+            m_o.symv( SharedVectorTag(), get_execution_policy<ContainerType1>(), alpha,
+                b_ptr, 1., thrust::raw_pointer_cast(y[k]->data().data()));
+        }
+    }
+
     private:
     LocalMatrixInner m_i;
     LocalMatrixOuter m_o;
     Collective m_c;
     Buffer< typename Collective::buffer_type>  m_buffer;
+    //buffer objects for the batched group symv (lazily sized)
+    Buffer< std::vector<typename Collective::buffer_type>> m_batch_buffers;
 };
 
 
@@ -308,25 +389,25 @@ struct MPIDistMat
             m_c->global_scatter_reduce( m_buffer.data(), y_ptr);
         }
     }
-    template<class Functor, class ContainerType1, class ContainerType2>
-    void stencil( const Functor f, const ContainerType1& x, ContainerType2& y) const
+    template<class Functor, class ContainerType1, class ...ContainerTypes>
+    void stencil( const Functor f, const ContainerType1& x, ContainerTypes&&... ys) const
     {
         //the blas2 functions should make enough static assertions on tpyes
         if( !m_c->isCommunicating()) //no communication needed
         {
-            dg::blas2::stencil( f, m_m, x.data(), y.data());
+            dg::blas2::stencil( f, m_m, x.data(), ys.data()...);
             return;
 
         }
         int result;
-        MPI_Comm_compare( x.communicator(), y.communicator(), &result);
-        assert( result == MPI_CONGRUENT || result == MPI_IDENT);
         MPI_Comm_compare( x.communicator(), m_c->communicator(), &result);
         assert( result == MPI_CONGRUENT || result == MPI_IDENT);
         if( m_dist == row_dist){
+            //only the stencil argument x is gathered, the additional
+            //arguments are local and must only be accessed at the row index
             const value_type * x_ptr = thrust::raw_pointer_cast(x.data().data());
             m_c->global_gather( x_ptr, m_buffer.data());
-            dg::blas2::stencil( f, m_m, m_buffer.data(), y.data());
+            dg::blas2::stencil( f, m_m, m_buffer.data(), ys.data()...);
         }
         if( m_dist == col_dist){
             throw Error( Message(_ping_)<<"stencil cannot be used with a column distributed mpi matrix!");
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <mpi.h>
+#include "exceptions.h"
+
+/*!@file
+@brief An optional asynchronous progress engine for the MPI backend
+
+Overlapping halo exchange with inner computation (cf. \c RowColDistMat)
+relies on the MPI library advancing non-blocking transfers while the
+application computes. Many MPI implementations only progress messages
+inside MPI calls, in which case the entire exchange happens in
+\c global_gather_wait and the intended overlap yields nothing. The progress
+engine in this file is a portable workaround: a dedicated thread repeatedly
+enters the library through \c MPI_Iprobe, which drives the progress engine
+of implementations without asynchronous progress. On libraries with native
+background progress (e.g. via \c MPICH_ASYNC_PROGRESS) the thread is
+unnecessary and should stay disabled.
+*/
+
+namespace dg
+{
+
+///@cond
+namespace detail
+{
+//Owns the progress thread; a singleton because MPI progress is a per-process
+//property. The thread probes a private duplicate of MPI_COMM_SELF: any entry
+//into the library progresses all communicators, and a local duplicate avoids
+//both collective construction and interference with user messages.
+struct MPIProgressEngine
+{
+    static MPIProgressEngine& instance()
+    {
+        static MPIProgressEngine engine;
+        return engine;
+    }
+    void start( unsigned interval_us)
+    {
+        if( m_thread.joinable())
+            return;
+        int provided;
+        MPI_Query_thread( &provided);
+        if( provided != MPI_THREAD_MULTIPLE)
+            throw dg::Error( dg::Message(_ping_) << "The MPI progress thread "
+                "requires MPI_THREAD_MULTIPLE but the library only provides "
+                "level "<<provided<<"! Initialize MPI with MPI_Init_thread "
+                "or dg::mpi_init( argc, argv, true)!");
+        MPI_Comm_dup( MPI_COMM_SELF, &m_comm);
+        m_run.store( true, std::memory_order_relaxed);
+        m_thread = std::thread( [this, interval_us]()
+        {
+            int flag;
+            while( m_run.load( std::memory_order_relaxed))
+            {
+                MPI_Iprobe( MPI_ANY_SOURCE, MPI_ANY_TAG, m_comm, &flag,
+                    MPI_STATUS_IGNORE);
+                if( interval_us == 0)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(
+                        std::chrono::microseconds( interval_us));
+            }
+        });
+        //the thread must not outlive the library: attributes on
+        //MPI_COMM_SELF are deleted at the very beginning of MPI_Finalize
+        int key;
+        MPI_Comm_create_keyval( MPI_COMM_NULL_COPY_FN, stop_callback, &key,
+            nullptr);
+        MPI_Comm_set_attr( MPI_COMM_SELF, key, this);
+        MPI_Comm_free_keyval( &key);
+    }
+    void stop()
+    {
+        if( !m_thread.joinable())
+            return;
+        m_run.store( false, std::memory_order_relaxed);
+        m_thread.join();
+        MPI_Comm_free( &m_comm);
+    }
+    bool running() const
+    {
+        return m_thread.joinable();
+    }
+    private:
+    MPIProgressEngine() = default;
+    static int stop_callback( MPI_Comm, int, void* attribute_val, void*)
+    {
+        static_cast<MPIProgressEngine*>(attribute_val)->stop();
+        return MPI_SUCCESS;
+    }
+    std::atomic<bool> m_run{false};
+    std::thread m_thread;
+    MPI_Comm m_comm = MPI_COMM_NULL;
+};
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Accumulate how much of the halo exchange is hidden behind computation
+ *
+ * \c RowColDistMat separates the matrix-vector product into an inner part
+ * that overlaps with the halo exchange and an outer part that waits for it.
+ * When enabled, the time between initiating the exchange and entering the
+ * wait (the overlap window) and the time spent inside the wait are
+ * accumulated here. The achieved overlap percentage is defined as
+ * \f$ 100\cdot t_{window} / (t_{window} + t_{wait})\f$: if the exchange
+ * completes in the background the wait vanishes and the percentage
+ * approaches 100, without background progress the wait carries the entire
+ * exchange and the percentage drops.
+ *
+ * Disabled by default; enabling costs two \c MPI_Wtime calls per distributed
+ * matrix-vector product. The counters are local to each process, use
+ * \c report to reduce them over a communicator.
+ * @ingroup misc
+ */
+struct MPIOverlapStats
+{
+    ///@brief The process local instance
+    static MPIOverlapStats& instance()
+    {
+        static MPIOverlapStats stats;
+        return stats;
+    }
+    ///@brief Switch collection on or off (off by default)
+    void enable( bool on){ m_on = on;}
+    ///@brief True if collection is switched on
+    bool enabled() const { return m_on;}
+    ///@brief Add one overlap window and the corresponding wait time (in seconds)
+    void record( double window, double wait)
+    {
+        m_window += window;
+        m_wait += wait;
+        m_count ++;
+    }
+    ///@brief The local achieved overlap percentage (100 if nothing was recorded)
+    double overlap() const
+    {
+        double total = m_window + m_wait;
+        return total == 0. ? 100. : 100.*m_window/total;
+    }
+    ///@brief Reset all counters
+    void reset()
+    {
+        m_window = m_wait = 0.;
+        m_count = 0;
+    }
+    /**
+     * @brief Reduce the counters over \c comm and print a summary on rank 0
+     * @param comm the communicator to reduce over (collective call)
+     * @param os the stream to print to on rank 0 of \c comm
+     */
+    void report( MPI_Comm comm, std::ostream& os = std::cout) const
+    {
+        int rank;
+        MPI_Comm_rank( comm, &rank);
+        double local = overlap(), min, max, avg;
+        MPI_Reduce( &local, &min, 1, MPI_DOUBLE, MPI_MIN, 0, comm);
+        MPI_Reduce( &local, &max, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+        MPI_Reduce( &local, &avg, 1, MPI_DOUBLE, MPI_SUM, 0, comm);
+        unsigned long count = m_count, total_count;
+        MPI_Reduce( &count, &total_count, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0,
+            comm);
+        if( rank == 0)
+        {
+            int size;
+            MPI_Comm_size( comm, &size);
+            os << "# Achieved communication overlap in "<<total_count
+               <<" products: avg "<<avg/(double)size<<"% min "<<min
+               <<"% max "<<max<<"%"<<std::endl;
+        }
+    }
+    private:
+    MPIOverlapStats() = default;
+    bool m_on = false;
+    double m_window = 0., m_wait = 0.;
+    unsigned long m_count = 0;
+};
+
+/**
+ * @brief Start a dedicated MPI progress thread
+ *
+ * The thread repeatedly calls \c MPI_Iprobe on a private communicator, which
+ * drives the progress engine of MPI libraries that otherwise only advance
+ * non-blocking transfers inside MPI calls. Requires the library to be
+ * initialized with \c MPI_THREAD_MULTIPLE (cf. \c dg::mpi_init), else a
+ * \c dg::Error is thrown. A second call while the thread runs is a no-op.
+ * The thread is stopped automatically before \c MPI_Finalize tears down the
+ * library.
+ * @note The thread occupies one core; on fully subscribed nodes reserve a
+ * core per process for it or increase \c interval_us.
+ * @param interval_us microseconds to sleep between probes; 0 spins with
+ *  \c std::this_thread::yield for minimum latency at maximum cpu usage
+ * @ingroup misc
+ */
+static inline void mpi_enable_async_progress( unsigned interval_us = 10)
+{
+    detail::MPIProgressEngine::instance().start( interval_us);
+}
+
+/**
+ * @brief Stop the MPI progress thread started by \c mpi_enable_async_progress
+ * @ingroup misc
+ */
+static inline void mpi_disable_async_progress()
+{
+    detail::MPIProgressEngine::instance().stop();
+}
+
+/**
+ * @brief True if the MPI progress thread is currently running
+ * @ingroup misc
+ */
+static inline bool mpi_async_progress()
+{
+    return detail::MPIProgressEngine::instance().running();
+}
+
+}//namespace dg
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+#include <mpi.h>
+#include "exceptions.h"
+
+/*!@file
+@brief Node-shared read-only storage for ensemble runs
+
+When several independent simulations (ensemble members) run side by side on
+the same node they all construct identical immutable objects: grids,
+abscissas, profiles, cached lookup tables. The \c dg::MPISharedVector in this
+file lets one process per node construct such data once inside an MPI shared
+memory window while its peers on the node map the same physical pages,
+cutting both the setup time and the node memory by the number of peers.
+Use \c dg::mpi_init_ensemble or \c dg::mpi_init2d_ensemble to obtain the
+peer communicator.
+*/
+
+namespace dg
+{
+
+/*!@brief Read-only vector in an MPI shared memory window
+ *
+ * The constructor is collective on a node-local communicator: the root rank
+ * invokes the generator and copies the result into a window allocated with
+ * \c MPI_Win_allocate_shared, all other ranks query the window and map the
+ * same physical memory. Afterwards every rank reads the data through plain
+ * loads at shared memory speed; no rank owns a private copy.
+ *
+ * The intended use are large immutable host arrays in ensemble runs (cf.
+ * \c dg::mpi_init_ensemble), e.g. evaluated background profiles, cached
+ * fieldline distances or interpolation abscissas, where the peers of a node
+ * would otherwise each hold an identical copy:
+ * @code
+ * dg::MPISharedVector<double> profile( [&](){
+ *     return dg::evaluate( my_expensive_functor, grid.local());
+ *     }, peer_comm);
+ * // all peers read profile[i] from the same pages
+ * @endcode
+ * @note The destructor frees the window and is therefore \b collective on
+ * the peer communicator, as is the constructor; all peers must construct
+ * and destruct their \c MPISharedVector objects in the same order
+ * @attention The class is move-only and the data cannot be written after
+ * construction; copy into a private vector if you need to modify it
+ * @tparam T a trivially copyable value type (e.g. \c double)
+ * @ingroup misc
+ */
+template<class T>
+struct MPISharedVector
+{
+    ///@brief no memory allocation, no collective call
+    MPISharedVector() = default;
+    /*!@brief Generate data on the node root and share it with all peers
+     *
+     * @param generate called \b only on rank 0 of \c peer_comm; must return a
+     * container with \c size() and contiguous \c operator[] (e.g.
+     * <tt>std::vector<T></tt> or <tt>thrust::host_vector<T></tt>) holding
+     * the data to share
+     * @param peer_comm a \b node-local communicator, e.g. the peer
+     * communicator of \c dg::mpi_init_ensemble or the result of
+     * <tt>MPI_Comm_split_type( ..., MPI_COMM_TYPE_SHARED, ...)</tt>; the
+     * constructor is collective on it
+     */
+    template<class Generator>
+    MPISharedVector( Generator generate, MPI_Comm peer_comm) : m_comm( peer_comm)
+    {
+        int rank;
+        MPI_Comm_rank( peer_comm, &rank);
+        unsigned long long size = 0;
+        if( rank == 0)
+        {
+            auto src = generate();
+            size = src.size();
+            MPI_Bcast( &size, 1, MPI_UNSIGNED_LONG_LONG, 0, peer_comm);
+            allocate( size, rank, peer_comm);
+            MPI_Win_fence( 0, m_win);
+            for( unsigned long long i=0; i<size; i++)
+                m_ptr[i] = src[i];
+            MPI_Win_fence( 0, m_win);
+        }
+        else
+        {
+            MPI_Bcast( &size, 1, MPI_UNSIGNED_LONG_LONG, 0, peer_comm);
+            allocate( size, rank, peer_comm);
+            MPI_Win_fence( 0, m_win);
+            MPI_Win_fence( 0, m_win);
+        }
+        m_size = size;
+    }
+    MPISharedVector( const MPISharedVector& src) = delete;
+    MPISharedVector& operator=( const MPISharedVector& src) = delete;
+    MPISharedVector( MPISharedVector&& src) noexcept:
+        m_win( src.m_win), m_ptr( src.m_ptr), m_size( src.m_size),
+        m_comm( src.m_comm)
+    {
+        src.m_win = MPI_WIN_NULL;
+        src.m_ptr = nullptr;
+        src.m_size = 0;
+    }
+    MPISharedVector& operator=( MPISharedVector&& src) noexcept
+    {
+        std::swap( m_win, src.m_win);
+        std::swap( m_ptr, src.m_ptr);
+        std::swap( m_size, src.m_size);
+        std::swap( m_comm, src.m_comm);
+        return *this;
+    }
+    ///@brief Free the window (collective on the peer communicator)
+    ~MPISharedVector()
+    {
+        if( m_win != MPI_WIN_NULL)
+            MPI_Win_free( &m_win);
+    }
+    ///@brief pointer to the shared data
+    const T* data() const { return m_ptr;}
+    ///@brief number of shared elements
+    unsigned long long size() const { return m_size;}
+    ///@brief read-only element access
+    const T& operator[]( unsigned long long i) const { return m_ptr[i];}
+    ///@brief pointer to the first shared element
+    const T* begin() const { return m_ptr;}
+    ///@brief pointer behind the last shared element
+    const T* end() const { return m_ptr + m_size;}
+    ///@brief the communicator the window is shared on
+    MPI_Comm communicator() const { return m_comm;}
+    private:
+    void allocate( unsigned long long size, int rank, MPI_Comm peer_comm)
+    {
+        MPI_Aint bytes = rank == 0 ? size*sizeof(T) : 0;
+        int err = MPI_Win_allocate_shared( bytes, sizeof(T), MPI_INFO_NULL,
+            peer_comm, &m_ptr, &m_win);
+        if( err != MPI_SUCCESS)
+            throw dg::Error( dg::Message(_ping_) << "MPI_Win_allocate_shared "
+                "failed! Is the peer communicator node-local?");
+        if( rank != 0)
+        {
+            MPI_Aint qbytes;
+            int disp;
+            MPI_Win_shared_query( m_win, 0, &qbytes, &disp, &m_ptr);
+        }
+    }
+    MPI_Win m_win = MPI_WIN_NULL;
+    T* m_ptr = nullptr;
+    unsigned long long m_size = 0;
+    MPI_Comm m_comm = MPI_COMM_NULL;
+};
+
+}//namespace dg
@@ -1,14 +1,20 @@
 #pragma once
 
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <thrust/host_vector.h>
 #include <thrust/gather.h>
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+#include <thrust/system/cuda/execution_policy.h>
+#endif
 #include "exceptions.h"
 #include "exblas/mpi_accumulate.h"
 #include "tensor_traits.h"
 #include "blas1_dispatch_shared.h"
 #include "mpi_communicator.h"
 #include "memory.h"
+#include "prof.h"
 #include "config.h"
 
 //TODO: should we catch the cases where outer_size \in {1,2,3} in NearestNeighborComm?
@@ -138,6 +144,97 @@ struct TensorTraits<MPI_Vector<container> > {
 };
 ///@}
 
+///@cond
+namespace detail
+{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+//dedicated stream on which the halo gather and staging copies run such that
+//posting an exchange only synchronizes with the halo data, not with
+//unrelated work on the default stream
+inline cudaStream_t mpi_comm_stream()
+{
+    static cudaStream_t stream = [](){
+        cudaStream_t s;
+        cudaStreamCreateWithFlags( &s, cudaStreamNonBlocking);
+        return s;
+    }();
+    return stream;
+}
+//event used to order the halo gather after previously submitted work
+inline cudaEvent_t mpi_comm_event()
+{
+    static cudaEvent_t event = [](){
+        cudaEvent_t e;
+        cudaEventCreateWithFlags( &e, cudaEventDisableTiming);
+        return e;
+    }();
+    return event;
+}
+#endif
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Switch for lossy compression of nearest neighbor halo exchanges
+ *
+ * If set to true the send buffers of \c NearestNeighborComm are truncated to
+ * single precision before they enter MPI and expanded back to the vector's
+ * value type on receive, which halves the number of bytes on the wire of
+ * every halo exchange in double precision runs. This is worthwhile on
+ * bandwidth starved (e.g. Ethernet) clusters where the halo traffic
+ * dominates; the price is that the derivative stencils see the halo layers
+ * with a relative accuracy of only \f$\sim 10^{-7}\f$, which is acceptable
+ * whenever the discretization error exceeds single precision.
+ *
+ * The switch is initialized from the environment variable
+ * \c DG_HALO_COMPRESSION (unset or "0" means off) and can be changed
+ * programmatically at any time, e.g. \c dg::mpi_halo_compression()=true;
+ * @note the switch has no effect if the vector value type already is \c float
+ * and none on CUDA-aware MPI runs, where the buffers stay on the device
+ * @return reference to the switch
+ * @ingroup mpi_structures
+ */
+inline bool& mpi_halo_compression()
+{
+    static bool enabled = [](){
+        const char* env = std::getenv( "DG_HALO_COMPRESSION");
+        return env != nullptr && env[0] != '0';
+    }();
+    return enabled;
+}
+
+/**
+ * @brief Switch for MPI-3 shared memory halo exchanges with intra-node neighbors
+ *
+ * If set to true every \c NearestNeighborComm allocates a node-local shared
+ * memory window ( \c MPI_Win_allocate_shared). Halo layers destined for a
+ * neighbor on the same node are packed into the owner's window segment and
+ * the neighbor reads them there directly (zero-copy); only a zero-byte
+ * message remains for the pairwise synchronization. Neighbors on other nodes
+ * keep the ordinary messages. At typical node fillings most neighbors of a
+ * Cartesian decomposition are intra-node, so this eliminates the majority of
+ * the halo message volume.
+ *
+ * The switch is initialized from the environment variable
+ * \c DG_SHARED_HALO (unset or "0" means off) and can be changed
+ * programmatically, e.g. \c dg::mpi_shared_halo()=true; it must have the
+ * same value on all ranks (the window allocation is collective)
+ * @note the window path only engages for host resident vectors (on the CUDA
+ * backend the halo data lives in device memory) and steps aside if \c
+ * dg::mpi_halo_compression() is active; the batched exchanges of \c
+ * dg::RowColDistMat also keep the message path
+ * @return reference to the switch
+ * @ingroup mpi_structures
+ */
+inline bool& mpi_shared_halo()
+{
+    static bool enabled = [](){
+        const char* env = std::getenv( "DG_SHARED_HALO");
+        return env != nullptr && env[0] != '0';
+    }();
+    return enabled;
+}
+
 /////////////////////////////communicator//////////////////////////
 /**
 * @brief Communicator for asynchronous nearest neighbor communication
@@ -167,6 +264,8 @@ struct TensorTraits<MPI_Vector<container> > {
 *
 * @note the corresponding gather map is of general type and the communication
 *  can also be modeled in \c GeneralComm, but not \c BijectiveComm or \c SurjectiveComm
+* @note if \c dg::mpi_halo_compression() is set the messages are truncated to
+*  single precision on the wire (see there for the accuracy implications)
 *  @attention Currently we cannot handle the case where the whole vector is
 *  the boundary layer (i.e. \c buffer_size()==input.size() and both neighboring layers are on different processes)
 * @ingroup mpi_structures
@@ -282,6 +381,7 @@ struct NearestNeighborComm
     */
     void global_gather_init( const_pointer_type input, buffer_type& buffer, MPI_Request rqst[4])const
     {
+        DG_PROF_SCOPE( "nnc::gather_init");
         unsigned size = buffer_size();
         //init pointers on host
         const_pointer_type host_ptr[6];
@@ -311,6 +411,26 @@ struct NearestNeighborComm
                   thrust::raw_pointer_cast(&m_internal_buffer.data()[0*size]), //host_ptr is const!
                   thrust::raw_pointer_cast(&m_internal_buffer.data()[5*size]), //host_ptr is const!
                   rqst);
+        if( m_shared.used)
+        {
+            //the halo layers of intra-node neighbors are read directly from
+            //the neighbor's shared window segment instead of a receive buffer
+            bool repoint = false;
+            if( m_shared.src_on_node[1])
+            {
+                host_ptr[0] = reinterpret_cast<const_pointer_type>(
+                    m_shared.peer[1]) + m_shared.parity*2*size + size;
+                repoint = true;
+            }
+            if( m_shared.src_on_node[0])
+            {
+                host_ptr[5] = reinterpret_cast<const_pointer_type>(
+                    m_shared.peer[0]) + m_shared.parity*2*size;
+                repoint = true;
+            }
+            if( repoint)
+                thrust::copy( host_ptr, host_ptr+6, buffer.begin());
+        }
     }
     /**
     * @brief Wait for asynchronous communication to finish and gather received data into buffer
@@ -322,7 +442,37 @@ struct NearestNeighborComm
     */
     void global_gather_wait(const_pointer_type input, const buffer_type& buffer, MPI_Request rqst[4])const
     {
+        DG_PROF_SCOPE( "nnc::gather_wait");
         MPI_Waitall( 4, rqst, MPI_STATUSES_IGNORE );
+        if( m_shared.used)
+            MPI_Win_sync( m_shared.win); //observe the neighbor segments
+        if( m_compressed)
+        {
+            //expand the received single precision layers to the value type
+            unsigned size = buffer_size();
+            const float * cb = thrust::raw_pointer_cast( &m_compress_buffer.data()[0]);
+#ifdef _DG_CUDA_UNAWARE_MPI
+            if( std::is_same< get_execution_policy<Vector>, CudaTag>::value)
+            {
+                //the host staging buffer is copied to the device below
+                get_value_type<Vector> * rb = thrust::raw_pointer_cast( &m_internal_host_buffer.data()[0]);
+                for( unsigned i=0; i<size; i++)
+                {
+                    rb[0*size+i] = cb[2*size+i];
+                    rb[5*size+i] = cb[3*size+i];
+                }
+            }
+            else
+#endif
+            {
+                get_value_type<Vector> * rb = thrust::raw_pointer_cast( &m_internal_buffer.data()[0]);
+                for( unsigned i=0; i<size; i++)
+                {
+                    rb[0*size+i] = cb[2*size+i];
+                    rb[5*size+i] = cb[3*size+i];
+                }
+            }
+        }
 #ifdef _DG_CUDA_UNAWARE_MPI
     if( std::is_same< get_execution_policy<Vector>, CudaTag>::value ) //could be serial tag
     {
@@ -330,24 +480,59 @@ struct NearestNeighborComm
         cudaError_t code = cudaGetLastError( );
         if( code != cudaSuccess)
             throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
-        code = cudaMemcpy( thrust::raw_pointer_cast(&m_internal_buffer.data()[0*size]), //dst
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_internal_buffer.data()[0*size]), //dst
                     thrust::raw_pointer_cast(&m_internal_host_buffer.data()[0*size]), //src
-                    size*sizeof(get_value_type<Vector>), cudaMemcpyHostToDevice);
+                    size*sizeof(get_value_type<Vector>), cudaMemcpyHostToDevice,
+                    detail::mpi_comm_stream());
         if( code != cudaSuccess)
             throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
 
-        code = cudaMemcpy( thrust::raw_pointer_cast(&m_internal_buffer.data()[5*size]), //dst
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_internal_buffer.data()[5*size]), //dst
                     thrust::raw_pointer_cast(&m_internal_host_buffer.data()[5*size]), //src
-                    size*sizeof(get_value_type<Vector>), cudaMemcpyHostToDevice);
+                    size*sizeof(get_value_type<Vector>), cudaMemcpyHostToDevice,
+                    detail::mpi_comm_stream());
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaStreamSynchronize( detail::mpi_comm_stream());
         if( code != cudaSuccess)
             throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
     }
 #endif
     }
+    /**
+    * @brief Gather values from a group of vectors and initiate a single batched MPI communication
+    *
+    * Packs the halo layers of all vectors of the group into one contiguous
+    * message per neighbor such that only one send/receive pair per neighbor
+    * is posted no matter how many vectors are exchanged. This reduces the
+    * message rate (and thus latency and matching pressure) compared to
+    * \c num separate exchanges, which pays off at large numbers of ranks.
+    * @param num number of vectors in the group
+    * @param inputs \c num pointers from which to gather data (it is @b unsafe to change values on return)
+    * @param buffers \c num buffer objects (each must be allocated by \c allocate_buffer())
+    * @param rqst four request variables that can be used to call MPI_Waitall
+    * @sa dg::RowColDistMat for a batched matrix-vector product built on this
+    */
+    void global_gather_init( unsigned num, const const_pointer_type* inputs, buffer_type* buffers, MPI_Request rqst[4])const;
+    /**
+    * @brief Wait for batched communication to finish and gather received data into buffers
+    *
+    * Counterpart of the batched \c global_gather_init; after this call
+    * returns it is safe to use the data all \c buffers point to.
+    * @param num number of vectors in the group (must equal the one given in \c global_gather_init)
+    * @param inputs \c num pointers from which data was gathered
+    * @param buffers \c num buffer objects where received data resides on return
+    * @param rqst the same four request variables that were used in \c global_gather_init
+    */
+    void global_gather_wait( unsigned num, const const_pointer_type* inputs, const buffer_type* buffers, MPI_Request rqst[4])const;
     private:
     void do_global_gather_init( OmpTag, const_pointer_type, MPI_Request rqst[4])const;
     void do_global_gather_init( SerialTag, const_pointer_type, MPI_Request rqst[4])const;
     void do_global_gather_init( CudaTag, const_pointer_type, MPI_Request rqst[4])const;
+    void do_batch_pack( SerialTag, unsigned num, const const_pointer_type* inputs)const;
+    void do_batch_pack( OmpTag, unsigned num, const const_pointer_type* inputs)const;
+    void do_batch_pack( CudaTag, unsigned num, const const_pointer_type* inputs)const;
+    void sendrecv_batch( unsigned num, MPI_Request rqst[4])const;
     void construct( unsigned n, const unsigned vector_dimensions[3], MPI_Comm comm, unsigned direction);
 
     unsigned m_n, m_dim[3]; //deepness, dimensions
@@ -357,13 +542,95 @@ struct NearestNeighborComm
     unsigned m_outer_size = 1; //size of vector in units of buffer_size
     Index m_gather_map_middle;
     dg::Buffer<Vector> m_internal_buffer;
+    //staging area for the optional lossy compression of the messages
+    //(layout: send1, send2, recv1, recv2); host resident since the
+    //compression is only applied to host resident MPI buffers
+    dg::Buffer<thrust::host_vector<float>> m_compress_buffer;
+    mutable bool m_compressed = false; //was the last exchange compressed?
+    //storage for the batched multi vector exchange: 6 sections of
+    //num*buffer_size() values each, fields consecutive within a section such
+    //that each section forms one contiguous message (lazily sized)
+    dg::Buffer<Vector> m_batch_buffer;
+#ifdef _DG_CUDA_UNAWARE_MPI
+    dg::Buffer<PinnedVec_t<get_value_type<Vector>>> m_batch_host_buffer;
+#endif
+    mutable bool m_batch_compressed = false;
 #ifdef _DG_CUDA_UNAWARE_MPI
-    //a copy of the data on the host (we need to send data manually through the host)
-    dg::Buffer<thrust::host_vector<get_value_type<Vector>>> m_internal_host_buffer;
+    //a copy of the data on the host (we need to send data manually through
+    //the host); pinned so the cudaMemcpyAsync staging copies are truly
+    //asynchronous and run at full PCIe speed
+    dg::Buffer<PinnedVec_t<get_value_type<Vector>>> m_internal_host_buffer;
 #endif
 
     void sendrecv(const_pointer_type, const_pointer_type, pointer_type, pointer_type, MPI_Request rqst[4])const;
     int m_source[2], m_dest[2];
+    //the communication pattern is fixed for the lifetime of a grid: we set up
+    //persistent requests lazily in sendrecv and simply restart them on every
+    //exchange as long as the buffer addresses do not change
+    struct PersistentRequests
+    {
+        PersistentRequests() = default;
+        //copies do not share persistent requests (they reference the buffers
+        //of the object they were created for)
+        PersistentRequests( const PersistentRequests&){}
+        PersistentRequests& operator=( const PersistentRequests&){ free(); return *this;}
+        ~PersistentRequests(){ free();}
+        void free()
+        {
+            if( active)
+                for( unsigned i=0; i<4; i++)
+                    MPI_Request_free( &rqst[i]);
+            active = false;
+        }
+        bool active = false;
+        bool shared = false; //were the requests built for the window path?
+        const void * sb1 = nullptr, * sb2 = nullptr;
+        MPI_Request rqst[4];
+    };
+    mutable PersistentRequests m_persistent;
+    //MPI-3 shared memory halo exchange (see dg::mpi_shared_halo): every rank
+    //owns a double buffered segment in a node-local shared window into which
+    //it packs the halo layers destined for on-node neighbors; the neighbor
+    //reads them in place and only a zero-byte message remains for the
+    //pairwise synchronization. The double buffering (parity) protects the
+    //previous exchange from being overwritten while the neighbor still reads
+    //it: a rank can only enter exchange N+1 after its own exchange N
+    //completed, which requires the neighbor to have entered exchange N and
+    //thus to have finished reading exchange N-1 of the same parity.
+    struct SharedHalo
+    {
+        SharedHalo() = default;
+        //copies allocate their own window
+        SharedHalo( const SharedHalo&){}
+        SharedHalo& operator=( const SharedHalo&){ free(); return *this;}
+        ~SharedHalo(){ free();}
+        void free()
+        {
+            int finalized = 0;
+            MPI_Finalized( &finalized);
+            if( !finalized && win != MPI_WIN_NULL)
+            {
+                MPI_Win_unlock_all( win);
+                MPI_Win_free( &win); //collective over the node
+            }
+            if( !finalized && node_comm != MPI_COMM_NULL)
+                MPI_Comm_free( &node_comm);
+            win = MPI_WIN_NULL;
+            node_comm = MPI_COMM_NULL;
+            tried = active = used = false;
+        }
+        bool tried = false;  //setup was attempted
+        bool active = false; //any neighbor is on the node
+        mutable bool used = false; //the latest sendrecv took the window path
+        bool src_on_node[2] = {false,false}, dst_on_node[2] = {false,false};
+        MPI_Comm node_comm = MPI_COMM_NULL;
+        MPI_Win win = MPI_WIN_NULL;
+        char* base = nullptr; //my segments: 2 parities x 2 directions
+        const char* peer[2] = {nullptr, nullptr}; //segments of m_source[0|1]
+        unsigned parity = 0;  //toggles every exchange, in lockstep with peers
+    };
+    mutable SharedHalo m_shared;
+    void setup_shared_halo() const;
 };
 
 ///@cond
@@ -433,6 +700,7 @@ void NearestNeighborComm<I,B,V>::construct( unsigned n, const unsigned dimension
     }
     m_gather_map_middle = mid_gather; //transfer to device
     m_internal_buffer.data().resize( 6*buffer_size() );
+    m_compress_buffer.data().resize( 4*buffer_size() );
 #ifdef _DG_CUDA_UNAWARE_MPI
     m_internal_host_buffer.data().resize( 6*buffer_size() );
 #endif
@@ -483,21 +751,85 @@ void NearestNeighborComm<I,B,V>::do_global_gather_init( OmpTag, const_pointer_ty
 template<class I, class B, class V>
 void NearestNeighborComm<I,B,V>::do_global_gather_init( CudaTag, const_pointer_type input, MPI_Request rqst[4]) const
 {
-    //gather values from input into sendbuffer
+    //gather values from input into sendbuffer on a dedicated stream; the
+    //event makes the gather wait until input is valid, i.e. until all
+    //previously submitted work on the default stream has finished
+    cudaStream_t stream = detail::mpi_comm_stream();
+    cudaEventRecord( detail::mpi_comm_event(), 0);
+    cudaStreamWaitEvent( stream, detail::mpi_comm_event(), 0);
     if(!m_trivial)
     {
         unsigned size = buffer_size();
-        thrust::gather( thrust::cuda::tag(), m_gather_map_middle.begin(), m_gather_map_middle.end(), input, m_internal_buffer.data().begin()+size);
+        thrust::gather( thrust::cuda::par.on(stream), m_gather_map_middle.begin(), m_gather_map_middle.end(), input, m_internal_buffer.data().begin()+size);
     }
     cudaError_t code = cudaGetLastError( );
     if( code != cudaSuccess)
         throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
-    code = cudaDeviceSynchronize(); //wait until device functions are finished before sending data
+    //wait until the halo data is ready before sending; in contrast to a
+    //device synchronization, kernels on other streams keep running and
+    //kernels submitted afterwards (the inner matrix in dg::RowColDistMat)
+    //overlap with the MPI exchange
+    code = cudaStreamSynchronize( stream);
     if( code != cudaSuccess)
         throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
 }
 #endif
 
+//Collective over m_comm (all ranks construct the same communicators and
+//exchange halos in lockstep, the same assumption the message path makes)
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::setup_shared_halo() const
+{
+    m_shared.tried = true;
+    unsigned size = buffer_size();
+    MPI_Comm_split_type( m_comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+        &m_shared.node_comm);
+    MPI_Group comm_group, node_group;
+    MPI_Comm_group( m_comm, &comm_group);
+    MPI_Comm_group( m_shared.node_comm, &node_group);
+    int node_rank[2] = {MPI_UNDEFINED, MPI_UNDEFINED};
+    for( unsigned k=0; k<2; k++)
+    {
+        if( m_source[k] != MPI_PROC_NULL)
+        {
+            MPI_Group_translate_ranks( comm_group, 1, &m_source[k],
+                node_group, &node_rank[k]);
+            m_shared.src_on_node[k] = (node_rank[k] != MPI_UNDEFINED);
+        }
+        if( m_dest[k] != MPI_PROC_NULL)
+        {
+            int r = MPI_UNDEFINED;
+            MPI_Group_translate_ranks( comm_group, 1, &m_dest[k],
+                node_group, &r);
+            m_shared.dst_on_node[k] = (r != MPI_UNDEFINED);
+        }
+    }
+    MPI_Group_free( &comm_group);
+    MPI_Group_free( &node_group);
+    //the allocation is collective over the node, so every rank allocates its
+    //segments even if its own neighbors in this direction are all off-node
+    void* base = nullptr;
+    MPI_Win_allocate_shared( 4*size*sizeof(get_value_type<V>),
+        sizeof(get_value_type<V>), MPI_INFO_NULL, m_shared.node_comm, &base,
+        &m_shared.win);
+    m_shared.base = (char*)base;
+    for( unsigned k=0; k<2; k++)
+        if( m_shared.src_on_node[k])
+        {
+            MPI_Aint sz; int disp; void* peer = nullptr;
+            MPI_Win_shared_query( m_shared.win, node_rank[k], &sz, &disp,
+                &peer);
+            m_shared.peer[k] = (const char*)peer;
+        }
+    //passive target epoch for the lifetime of the window; the per exchange
+    //synchronization is the zero-byte notification message plus
+    //MPI_Win_sync on both sides (the standard pattern for point-to-point
+    //synchronized shared memory windows, which have the unified memory model)
+    MPI_Win_lock_all( MPI_MODE_NOCHECK, m_shared.win);
+    m_shared.active = m_shared.src_on_node[0] || m_shared.src_on_node[1]
+                   || m_shared.dst_on_node[0] || m_shared.dst_on_node[1];
+}
+
 template<class I, class B, class V>
 void NearestNeighborComm<I,B,V>::sendrecv( const_pointer_type sb1_ptr, const_pointer_type sb2_ptr, pointer_type rb1_ptr, pointer_type rb2_ptr, MPI_Request rqst[4]) const
 {
@@ -508,12 +840,19 @@ void NearestNeighborComm<I,B,V>::sendrecv( const_pointer_type sb1_ptr, const_poi
         cudaError_t code = cudaGetLastError( );
         if( code != cudaSuccess)
             throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
-        code = cudaMemcpy( thrust::raw_pointer_cast(&m_internal_host_buffer.data()[1*size]),//dst
-            sb1_ptr, size*sizeof(get_value_type<V>), cudaMemcpyDeviceToHost); //src
+        //stage through the host on the communication stream such that the
+        //copies do not serialize with the default stream
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_internal_host_buffer.data()[1*size]),//dst
+            sb1_ptr, size*sizeof(get_value_type<V>), cudaMemcpyDeviceToHost,
+            detail::mpi_comm_stream()); //src
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_internal_host_buffer.data()[4*size]),  //dst
+            sb2_ptr, size*sizeof(get_value_type<V>), cudaMemcpyDeviceToHost,
+            detail::mpi_comm_stream()); //src
         if( code != cudaSuccess)
             throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
-        code = cudaMemcpy( thrust::raw_pointer_cast(&m_internal_host_buffer.data()[4*size]),  //dst
-            sb2_ptr, size*sizeof(get_value_type<V>), cudaMemcpyDeviceToHost); //src
+        code = cudaStreamSynchronize( detail::mpi_comm_stream());
         if( code != cudaSuccess)
             throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
         sb1_ptr = thrust::raw_pointer_cast(&m_internal_host_buffer.data()[1*size]);
@@ -523,19 +862,340 @@ void NearestNeighborComm<I,B,V>::sendrecv( const_pointer_type sb1_ptr, const_poi
     }
 //This is a mistake if called with a host_vector
 #endif
-    MPI_Isend( sb1_ptr, size,
-               getMPIDataType<get_value_type<V>>(),  //sender
-               m_dest[0], 3, m_comm, &rqst[0]); //destination
-    MPI_Irecv( rb2_ptr, size,
-               getMPIDataType<get_value_type<V>>(), //receiver
-               m_source[0], 3, m_comm, &rqst[1]); //source
-
-    MPI_Isend( sb2_ptr, size,
-               getMPIDataType<get_value_type<V>>(),  //sender
-               m_dest[1], 9, m_comm, &rqst[2]);  //destination
-    MPI_Irecv( rb1_ptr, size,
-               getMPIDataType<get_value_type<V>>(), //receiver
-               m_source[1], 9, m_comm, &rqst[3]); //source
+    //optionally truncate the messages to single precision; only profitable
+    //in double precision and only possible if the MPI buffers are host
+    //resident (with CUDA-aware MPI they stay on the device)
+    bool compress = std::is_same<get_value_type<V>, double>::value
+                 && dg::mpi_halo_compression();
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA && !defined(_DG_CUDA_UNAWARE_MPI)
+    if( std::is_same< get_execution_policy<V>, CudaTag>::value)
+        compress = false;
+#endif
+    m_compressed = compress;
+    //the shared memory window path (host vectors only, the device halo of
+    //the CUDA backend cannot live in a shared window)
+    bool shared = !std::is_same< get_execution_policy<V>, CudaTag>::value
+               && !compress && dg::mpi_shared_halo();
+    if( shared && !m_shared.tried)
+        setup_shared_halo();
+    shared = shared && m_shared.active;
+    m_shared.used = shared;
+    unsigned scount[2] = {size, size}; //message size to m_dest[0], m_dest[1]
+    unsigned rcount[2] = {size, size}; //message size from m_source[0], m_source[1]
+    if( shared)
+    {
+        m_shared.parity = 1 - m_shared.parity;
+        get_value_type<V>* wb = reinterpret_cast<get_value_type<V>*>(
+            m_shared.base) + m_shared.parity*2*size;
+        if( m_shared.dst_on_node[0])
+        {
+            std::memcpy( wb, sb1_ptr, size*sizeof(get_value_type<V>));
+            scount[0] = 0; //the data travels through the window
+        }
+        if( m_shared.dst_on_node[1])
+        {
+            std::memcpy( wb+size, sb2_ptr, size*sizeof(get_value_type<V>));
+            scount[1] = 0;
+        }
+        if( m_shared.src_on_node[0]) rcount[0] = 0;
+        if( m_shared.src_on_node[1]) rcount[1] = 0;
+        //make the writes visible to the node before the notifications go out
+        MPI_Win_sync( m_shared.win);
+    }
+    const void * send1 = sb1_ptr, * send2 = sb2_ptr;
+    void * recv1 = rb1_ptr, * recv2 = rb2_ptr;
+    MPI_Datatype dtype = getMPIDataType<get_value_type<V>>();
+    if( compress)
+    {
+        float * cb = thrust::raw_pointer_cast( &m_compress_buffer.data()[0]);
+        for( unsigned i=0; i<size; i++)
+        {
+            cb[0*size+i] = (float)sb1_ptr[i];
+            cb[1*size+i] = (float)sb2_ptr[i];
+        }
+        send1 = cb+0*size, send2 = cb+1*size;
+        recv1 = cb+2*size, recv2 = cb+3*size;
+        dtype = MPI_FLOAT;
+    }
+    //(re)create the persistent requests if the buffer addresses changed
+    //(the receive buffers are internal and only change on grid changes, the
+    //send buffers may point into the input vector if m_trivial; toggling the
+    //compression switch changes the addresses and thus also the requests)
+    if( !m_persistent.active || send1 != m_persistent.sb1
+                             || send2 != m_persistent.sb2
+                             || shared != m_persistent.shared)
+    {
+        m_persistent.free();
+        MPI_Send_init( send1, scount[0], dtype,  //sender
+               m_dest[0], 3, m_comm, &m_persistent.rqst[0]); //destination
+        MPI_Recv_init( recv2, rcount[0], dtype, //receiver
+               m_source[0], 3, m_comm, &m_persistent.rqst[1]); //source
+
+        MPI_Send_init( send2, scount[1], dtype,  //sender
+               m_dest[1], 9, m_comm, &m_persistent.rqst[2]);  //destination
+        MPI_Recv_init( recv1, rcount[1], dtype, //receiver
+               m_source[1], 9, m_comm, &m_persistent.rqst[3]); //source
+        m_persistent.sb1 = send1, m_persistent.sb2 = send2;
+        m_persistent.shared = shared;
+        m_persistent.active = true;
+    }
+    MPI_Startall( 4, m_persistent.rqst);
+    //a wait on a persistent request leaves it allocated (inactive), ready
+    //for the next MPI_Startall
+    for( unsigned i=0; i<4; i++)
+        rqst[i] = m_persistent.rqst[i];
+}
+
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::global_gather_init( unsigned num, const const_pointer_type* inputs, buffer_type* buffers, MPI_Request rqst[4])const
+{
+    DG_PROF_SCOPE( "nnc::batch_init");
+    unsigned size = buffer_size();
+    if( m_batch_buffer.data().size() < 6*num*size)
+    {
+        m_batch_buffer.data().resize( 6*num*size);
+#ifdef _DG_CUDA_UNAWARE_MPI
+        m_batch_host_buffer.data().resize( 6*num*size);
+#endif
+    }
+    const_pointer_type batch = thrust::raw_pointer_cast( &m_batch_buffer.data()[0]);
+    for( unsigned k=0; k<num; k++)
+    {
+        const_pointer_type host_ptr[6];
+        host_ptr[0] = batch + (0*num+k)*size;
+        if( m_trivial)
+        {
+            host_ptr[1] = inputs[k];
+            host_ptr[2] = inputs[k]+size;
+            host_ptr[3] = inputs[k]+(m_outer_size-2)*size;
+            host_ptr[4] = inputs[k]+(m_outer_size-1)*size;
+        }
+        else
+        {
+            for( unsigned s=1; s<5; s++)
+                host_ptr[s] = batch + (s*num+k)*size;
+        }
+        host_ptr[5] = batch + (5*num+k)*size;
+        thrust::copy( host_ptr, host_ptr+6, buffers[k].begin());
+    }
+    //pack the send (and if !trivial also the inner) layers of all fields
+    do_batch_pack( get_execution_policy<V>(), num, inputs);
+    sendrecv_batch( num, rqst);
+}
+
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::do_batch_pack( SerialTag, unsigned num, const const_pointer_type* inputs)const
+{
+    unsigned size = buffer_size();
+    pointer_type batch = thrust::raw_pointer_cast( &m_batch_buffer.data()[0]);
+    if( m_trivial)
+    {
+        //only the two outermost layers are sent and need to be contiguous
+        for( unsigned k=0; k<num; k++)
+        for( unsigned i=0; i<size; i++)
+        {
+            batch[(1*num+k)*size+i] = inputs[k][i];
+            batch[(4*num+k)*size+i] = inputs[k][(m_outer_size-1)*size+i];
+        }
+    }
+    else
+    {
+        for( unsigned k=0; k<num; k++)
+        for( unsigned i=0; i<4*size; i++)
+            batch[((i/size+1)*num+k)*size + i%size] = inputs[k][m_gather_map_middle[i]];
+    }
+}
+#ifdef _OPENMP
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::do_batch_pack( OmpTag, unsigned num, const const_pointer_type* inputs)const
+{
+    unsigned size = buffer_size();
+    pointer_type batch = thrust::raw_pointer_cast( &m_batch_buffer.data()[0]);
+    if( m_trivial)
+    {
+        #pragma omp parallel for
+        for( unsigned i=0; i<num*size; i++)
+        {
+            unsigned k = i/size, j = i%size;
+            batch[(1*num+k)*size+j] = inputs[k][j];
+            batch[(4*num+k)*size+j] = inputs[k][(m_outer_size-1)*size+j];
+        }
+    }
+    else
+    {
+        #pragma omp parallel for
+        for( unsigned i=0; i<num*4*size; i++)
+        {
+            unsigned k = i/(4*size), j = i%(4*size);
+            batch[((j/size+1)*num+k)*size + j%size] = inputs[k][m_gather_map_middle[j]];
+        }
+    }
+}
+#endif
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::do_batch_pack( CudaTag, unsigned num, const const_pointer_type* inputs)const
+{
+    //pack on the dedicated communication stream, cf. do_global_gather_init
+    cudaStream_t stream = detail::mpi_comm_stream();
+    cudaEventRecord( detail::mpi_comm_event(), 0);
+    cudaStreamWaitEvent( stream, detail::mpi_comm_event(), 0);
+    unsigned size = buffer_size();
+    if( m_trivial)
+    {
+        pointer_type batch = thrust::raw_pointer_cast( &m_batch_buffer.data()[0]);
+        for( unsigned k=0; k<num; k++)
+        {
+            cudaMemcpyAsync( batch + (1*num+k)*size, inputs[k],
+                size*sizeof(get_value_type<V>), cudaMemcpyDeviceToDevice, stream);
+            cudaMemcpyAsync( batch + (4*num+k)*size, inputs[k]+(m_outer_size-1)*size,
+                size*sizeof(get_value_type<V>), cudaMemcpyDeviceToDevice, stream);
+        }
+    }
+    else
+    {
+        for( unsigned k=0; k<num; k++)
+        for( unsigned s=0; s<4; s++)
+            thrust::gather( thrust::cuda::par.on(stream),
+                m_gather_map_middle.begin()+s*size,
+                m_gather_map_middle.begin()+(s+1)*size, inputs[k],
+                m_batch_buffer.data().begin()+((s+1)*num+k)*size);
+    }
+    cudaError_t code = cudaGetLastError( );
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    code = cudaStreamSynchronize( stream);
+    if( code != cudaSuccess)
+        throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+}
+#endif
+
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::sendrecv_batch( unsigned num, MPI_Request rqst[4])const
+{
+    unsigned count = num*buffer_size();
+    const_pointer_type sb1_ptr = thrust::raw_pointer_cast(&m_batch_buffer.data()[1*count]);
+    const_pointer_type sb2_ptr = thrust::raw_pointer_cast(&m_batch_buffer.data()[4*count]);
+    pointer_type rb1_ptr = thrust::raw_pointer_cast(&m_batch_buffer.data()[0*count]);
+    pointer_type rb2_ptr = thrust::raw_pointer_cast(&m_batch_buffer.data()[5*count]);
+#ifdef _DG_CUDA_UNAWARE_MPI
+    if( std::is_same< get_execution_policy<V>, CudaTag>::value ) //could be serial tag
+    {
+        cudaError_t code = cudaGetLastError( );
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_batch_host_buffer.data()[1*count]),//dst
+            sb1_ptr, count*sizeof(get_value_type<V>), cudaMemcpyDeviceToHost,
+            detail::mpi_comm_stream()); //src
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_batch_host_buffer.data()[4*count]),  //dst
+            sb2_ptr, count*sizeof(get_value_type<V>), cudaMemcpyDeviceToHost,
+            detail::mpi_comm_stream()); //src
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaStreamSynchronize( detail::mpi_comm_stream());
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        sb1_ptr = thrust::raw_pointer_cast(&m_batch_host_buffer.data()[1*count]);
+        sb2_ptr = thrust::raw_pointer_cast(&m_batch_host_buffer.data()[4*count]);
+        rb1_ptr = thrust::raw_pointer_cast(&m_batch_host_buffer.data()[0*count]);
+        rb2_ptr = thrust::raw_pointer_cast(&m_batch_host_buffer.data()[5*count]);
+    }
+#endif
+    bool compress = std::is_same<get_value_type<V>, double>::value
+                 && dg::mpi_halo_compression();
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA && !defined(_DG_CUDA_UNAWARE_MPI)
+    if( std::is_same< get_execution_policy<V>, CudaTag>::value)
+        compress = false;
+#endif
+    m_batch_compressed = compress;
+    const void * send1 = sb1_ptr, * send2 = sb2_ptr;
+    void * recv1 = rb1_ptr, * recv2 = rb2_ptr;
+    MPI_Datatype dtype = getMPIDataType<get_value_type<V>>();
+    if( compress)
+    {
+        if( m_compress_buffer.data().size() < 4*count)
+            m_compress_buffer.data().resize( 4*count);
+        float * cb = thrust::raw_pointer_cast( &m_compress_buffer.data()[0]);
+        for( unsigned i=0; i<count; i++)
+        {
+            cb[0*count+i] = (float)sb1_ptr[i];
+            cb[1*count+i] = (float)sb2_ptr[i];
+        }
+        send1 = cb+0*count, send2 = cb+1*count;
+        recv1 = cb+2*count, recv2 = cb+3*count;
+        dtype = MPI_FLOAT;
+    }
+    //the group size (and thus the buffer addresses) may change between calls
+    //so plain nonblocking calls are used instead of persistent requests
+    MPI_Isend( send1, count, dtype,  //sender
+           m_dest[0], 3, m_comm, &rqst[0]); //destination
+    MPI_Irecv( recv2, count, dtype, //receiver
+           m_source[0], 3, m_comm, &rqst[1]); //source
+
+    MPI_Isend( send2, count, dtype,  //sender
+           m_dest[1], 9, m_comm, &rqst[2]);  //destination
+    MPI_Irecv( recv1, count, dtype, //receiver
+           m_source[1], 9, m_comm, &rqst[3]); //source
+}
+
+template<class I, class B, class V>
+void NearestNeighborComm<I,B,V>::global_gather_wait( unsigned num, const const_pointer_type* inputs, const buffer_type* buffers, MPI_Request rqst[4])const
+{
+    DG_PROF_SCOPE( "nnc::batch_wait");
+    MPI_Waitall( 4, rqst, MPI_STATUSES_IGNORE );
+    unsigned count = num*buffer_size();
+    if( m_batch_compressed)
+    {
+        //expand the received single precision layers to the value type
+        const float * cb = thrust::raw_pointer_cast( &m_compress_buffer.data()[0]);
+#ifdef _DG_CUDA_UNAWARE_MPI
+        if( std::is_same< get_execution_policy<V>, CudaTag>::value)
+        {
+            //the host staging buffer is copied to the device below
+            get_value_type<V> * rb = thrust::raw_pointer_cast( &m_batch_host_buffer.data()[0]);
+            for( unsigned i=0; i<count; i++)
+            {
+                rb[0*count+i] = cb[2*count+i];
+                rb[5*count+i] = cb[3*count+i];
+            }
+        }
+        else
+#endif
+        {
+            get_value_type<V> * rb = thrust::raw_pointer_cast( &m_batch_buffer.data()[0]);
+            for( unsigned i=0; i<count; i++)
+            {
+                rb[0*count+i] = cb[2*count+i];
+                rb[5*count+i] = cb[3*count+i];
+            }
+        }
+    }
+#ifdef _DG_CUDA_UNAWARE_MPI
+    if( std::is_same< get_execution_policy<V>, CudaTag>::value ) //could be serial tag
+    {
+        cudaError_t code = cudaGetLastError( );
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_batch_buffer.data()[0*count]), //dst
+                    thrust::raw_pointer_cast(&m_batch_host_buffer.data()[0*count]), //src
+                    count*sizeof(get_value_type<V>), cudaMemcpyHostToDevice,
+                    detail::mpi_comm_stream());
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+
+        code = cudaMemcpyAsync( thrust::raw_pointer_cast(&m_batch_buffer.data()[5*count]), //dst
+                    thrust::raw_pointer_cast(&m_batch_host_buffer.data()[5*count]), //src
+                    count*sizeof(get_value_type<V>), cudaMemcpyHostToDevice,
+                    detail::mpi_comm_stream());
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaStreamSynchronize( detail::mpi_comm_stream());
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    }
+#endif
 }
 
 
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "exceptions.h"
+#include "view.h"
+
+namespace dg
+{
+
+/**
+ * @brief A structure-of-arrays vector of equally sized components stored contiguously
+ *
+ * Multispecies codes store their fields in nested arrays like
+ * <tt> std::array<std::array<Container,2>,2></tt>, which the recursive blas1
+ * dispatch loops over with one kernel launch per component. This container
+ * keeps all components in one contiguous chunk of memory and presents itself
+ * to the \c dg::blas1 functions as a single flat shared vector, so
+ * \c dg::blas1::axpby, \c dg::blas1::pointwiseDot etc. across all components
+ * execute as @b one fused kernel over the whole storage, which cuts the
+ * number of launches by the number of components and helps small per-GPU
+ * grids in strong scaling runs.
+ * Individual components are accessed without copies through \c dg::View :
+ * @code
+dg::MultiComponentVector<dg::DVec> density( 2, copyable); //two species
+dg::blas1::axpby( 1., density, 1., result); //one kernel for both species
+dg::View<dg::DVec> electrons = density[0]; //view of the first component
+dg::blas1::scal( electrons, 2.); //operate on a single component
+ * @endcode
+ * @attention In a \c dg::blas1 call all MultiComponentVector arguments must
+ * have the same number of components; mixing with nested \c std::array or \c
+ * std::vector arguments does not compile since this class has the shared
+ * vector category of its underlying container
+ * @note cannot be used in \c dg::construct or \c dg::assign (same as \c dg::View)
+ * @tparam ThrustVector \c TensorTraits exists for this class and the
+ * \c tensor_category derives from \c ThrustVectorTag
+ * @ingroup view
+ */
+template<class ThrustVector>
+struct MultiComponentVector
+{
+    using container_type = ThrustVector;
+    using value_type = get_value_type<ThrustVector>;
+    ///@brief Initialize empty vector of zero components
+    MultiComponentVector( void): m_size(0){}
+    /**
+     * @brief Allocate contiguous storage for \c components components
+     *
+     * @param components the number of components to store
+     * @param copyable the size of each component (the values are not copied)
+     */
+    MultiComponentVector( unsigned components, const ThrustVector& copyable):
+        m_size( copyable.size()), m_data( components*copyable.size()){}
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        *this = MultiComponentVector( std::forward<Params>( ps)...);
+    }
+
+    ///@brief The number of components
+    unsigned components() const{
+        return m_size == 0 ? 0 : m_data.size()/m_size;
+    }
+    ///@brief The size of each component
+    unsigned component_size() const{
+        return m_size;
+    }
+    ///@brief The total size <tt> components()*component_size()</tt> (this is what the blas1 functions parallelize over)
+    unsigned size() const{
+        return m_data.size();
+    }
+    ///@brief Pointer to the contiguous storage (same role as the \c data() member of the underlying container)
+    typename ThrustVector::pointer data() {
+        return m_data.data();
+    }
+    ///@copydoc data()
+    typename ThrustVector::const_pointer data() const {
+        return m_data.data();
+    }
+    ///@brief A view of the i-th component
+    ///@param i component index
+    View<ThrustVector> operator[]( unsigned i){
+#ifdef DG_DEBUG
+        if( !(i < components())) throw Error( Message(_ping_) << "You tried to access component "<<i<<" # of components is "<<components()<<"\n");
+#endif
+        return View<ThrustVector>( m_data.data() + i*m_size, m_size);
+    }
+    ///@brief A const view of the i-th component
+    ///@param i component index
+    View<const ThrustVector> operator[]( unsigned i) const{
+#ifdef DG_DEBUG
+        if( !(i < components())) throw Error( Message(_ping_) << "You tried to access component "<<i<<" # of components is "<<components()<<"\n");
+#endif
+        return View<const ThrustVector>( m_data.data() + i*m_size, m_size);
+    }
+    ///@brief Access the underlying contiguous container
+    const ThrustVector& flat() const{
+        return m_data;
+    }
+    ///@copydoc flat()
+    ThrustVector& flat(){
+        return m_data;
+    }
+    private:
+    unsigned m_size;
+    ThrustVector m_data;
+};
+
+/**
+ * @brief A MultiComponentVector has identical value_type and execution_policy as the underlying container
+ * @ingroup traits
+ */
+template<class ThrustVector>
+struct TensorTraits< MultiComponentVector<ThrustVector>>
+{
+    using value_type = get_value_type<ThrustVector>;
+    using tensor_category = ThrustVectorTag;
+    using execution_policy = get_execution_policy<ThrustVector>;
+};
+
+}//namespace dg
@@ -0,0 +1,28 @@
+#include <iostream>
+
+#include "multicomponent.h"
+#include "typedefs.h"
+#include "../blas1.h"
+
+
+int main()
+{
+    thrust::host_vector<double> copyable( 100, 0.);
+    dg::MultiComponentVector<thrust::host_vector<double>> v( 2, copyable), w( 2, copyable);
+    std::cout << "v has "<<v.components()<<" (2) components of size "
+              <<v.component_size()<<" (100), total "<<v.size()<<" (200)\n";
+    dg::blas1::copy( 3., v); //one kernel for both components
+    dg::blas1::copy( 4., w);
+    dg::blas1::axpby( 1., v, 1., w);
+    std::cout << "Both components now have "<<w.flat()[0]<<" (7) and "
+              <<w.flat()[150]<<" (7)\n";
+    dg::View<thrust::host_vector<double>> first = w[0];
+    dg::blas1::copy( 42., first);
+    std::cout << "The first component now has "<<w.flat()[0]
+              <<" (42), the second still "<<w.flat()[150]<<" (7)\n";
+    const dg::MultiComponentVector<thrust::host_vector<double>>& cw = w;
+    dg::blas1::copy( cw[1], first);
+    std::cout << "The first component now has "<<w.flat()[0]<<" (7)\n";
+
+    return 0;
+}
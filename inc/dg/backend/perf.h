@@ -0,0 +1,131 @@
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include "thrust/device_vector.h"
+//the <thrust/device_vector.h> header must be included for the THRUST_DEVICE_SYSTEM macros to work
+
+/*!@file
+ *
+ * Performance counters for the blas dispatch layer
+ */
+namespace dg
+{
+///@cond
+namespace perf
+{
+namespace detail
+{
+struct Counter
+{
+    unsigned long calls = 0;
+    double bytes = 0.; //estimated bytes moved over all calls
+    double flops = 0.; //counted floating point operations over all calls
+    double time = 0.; //accumulated seconds over all calls
+};
+inline std::map<std::string, Counter>& registry()
+{
+    static std::map<std::string, Counter> m_registry;
+    return m_registry;
+}
+//RAII sample: times the enclosing scope and accumulates into the registry
+struct Sample
+{
+    Sample( const char* name, double bytes, double flops)
+        : m_name( name), m_bytes( bytes), m_flops( flops)
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        cudaDeviceSynchronize();
+#endif
+        m_start = std::chrono::steady_clock::now();
+    }
+    ~Sample()
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        cudaDeviceSynchronize();
+#endif
+        double diff = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start).count()*1e-9;
+        Counter& c = registry()[m_name];
+        c.calls ++;
+        c.bytes += m_bytes;
+        c.flops += m_flops;
+        c.time += diff;
+    }
+    Sample( const Sample&) = delete;
+    Sample& operator=( const Sample&) = delete;
+    private:
+    const char* m_name;
+    double m_bytes, m_flops;
+    std::chrono::steady_clock::time_point m_start;
+};
+}//namespace detail
+}//namespace perf
+///@endcond
+
+/**
+ * @brief Print call counts and achieved bandwidth per kernel class
+ *
+ * When the \c DG_PERF_COUNT macro is defined at compile time the \c dg::blas1
+ * and \c dg::blas2 dispatch functions count their calls, the bytes they move
+ * (following the memop model we use in the documentation: each vector
+ * argument is read or written once per element) and, where the operation
+ * defines them, the floating point operations they perform, together with the
+ * time spent in each kernel class. This function writes the resulting table
+ * including the achieved bandwidth in GB/s and throughput in GFlop/s, e.g. at
+ * the end of a production run, so performance regressions show up in the run
+ * log without re-profiling with vendor tools.
+ * @code
+dg::print_performance_summary(); //write to std::cout
+ * @endcode
+ * @note Without \c DG_PERF_COUNT the counters compile to nothing and this
+ * function prints an empty table
+ * @note Generic \c blas1::subroutine functors have unknown flop counts, which
+ * we record as zero; since all our level 1 routines are memory bound the
+ * bandwidth column is the relevant metric there
+ * @attention Each process prints its own counters; in an MPI program guard
+ * the call with \c DG_RANK0 or write to a per-rank file. The timings include
+ * a device synchronization per call on GPUs, so expect a small overhead
+ * compared to an uninstrumented build
+ * @param os stream to write to
+ * @ingroup misc
+ */
+inline void print_performance_summary( std::ostream& os = std::cout)
+{
+    os << "# Performance summary (kernel class: calls, GB moved, GFlop, seconds, GB/s, GFlop/s)\n";
+    for( const auto& pair : perf::detail::registry())
+    {
+        const perf::detail::Counter& c = pair.second;
+        os << std::setw(30) << std::left << pair.first << std::right
+           << " " << std::setw(10) << c.calls
+           << " " << std::setw(10) << std::setprecision(4) << c.bytes*1e-9
+           << " " << std::setw(10) << c.flops*1e-9
+           << " " << std::setw(10) << c.time
+           << " " << std::setw(10) << ( c.time > 0. ? c.bytes*1e-9/c.time : 0.)
+           << " " << std::setw(10) << ( c.time > 0. ? c.flops*1e-9/c.time : 0.)
+           << "\n";
+    }
+    os << std::flush;
+}
+
+///@brief Clear all performance counters (e.g. after a warm-up phase)
+///@ingroup misc
+inline void reset_performance_counters()
+{
+    perf::detail::registry().clear();
+}
+}//namespace dg
+
+///@cond
+#ifdef DG_PERF_COUNT
+#define DG_PERF_PASTE2( a, b) a##b
+#define DG_PERF_PASTE( a, b) DG_PERF_PASTE2( a, b)
+#define DG_PERF_SAMPLE( name, bytes, flops) dg::perf::detail::Sample DG_PERF_PASTE( _dg_perf_sample_, __LINE__)( name, bytes, flops)
+#else
+/// Count the enclosing scope as a kernel class sample (no-op unless DG_PERF_COUNT is defined)
+#define DG_PERF_SAMPLE( name, bytes, flops)
+#endif //DG_PERF_COUNT
+///@endcond
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <ostream>
+#include "thrust/device_vector.h"
+//the <thrust/device_vector.h> header must be included for the THRUST_DEVICE_SYSTEM macros to work
+
+/*!@file
+ *
+ * A lightweight scoped runtime profiler
+ */
+namespace dg
+{
+namespace prof
+{
+///@cond
+namespace detail
+{
+struct Record
+{
+    double time = 0.; //accumulated seconds over all visits
+    unsigned long count = 0; //number of visits
+};
+inline std::map<std::string, Record>& registry()
+{
+    static std::map<std::string, Record> m_registry;
+    return m_registry;
+}
+inline std::string& current_path()
+{
+    static std::string m_path;
+    return m_path;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief RAII timer region for the scoped runtime profiler
+ *
+ * On construction the region name is appended to the path of currently open
+ * regions (so regions nest, e.g. "pcg::solve/blas2::symv") and a timer is
+ * started; on destruction the elapsed wall time and a visit count are
+ * accumulated into a program wide registry under that path, which
+ * \c dg::prof::dump_json serializes at the end of a run.
+ *
+ * Rather than placing such regions manually, use the \c DG_PROF_SCOPE macro:
+ * it expands to nothing unless the \c DG_PROFILE macro is defined at compile
+ * time, so instrumentation in hot functions (we provide built-in regions in
+ * \c dg::blas2::symv, \c dg::PCG::solve, the multistep steppers, the nearest
+ * neighbor communication and the file output functions) costs nothing in
+ * production builds
+ * @code
+void my_function()
+{
+    DG_PROF_SCOPE( "my_function"); //times until end of scope
+    // ...
+}
+ * @endcode
+ * @note Each region measures per-process wall time without any MPI barriers
+ * (on GPUs the device is synchronized at region boundaries so kernel time is
+ * attributed correctly); rank imbalance is therefore visible in the min/max
+ * statistics of the collective \c dump_json overload
+ * @attention The registry is not thread safe; do not open regions inside
+ * OpenMP parallel sections
+ * @ingroup misc
+ */
+struct ScopedRegion
+{
+    ///@brief Open a region named \c name and start its timer
+    ///@param name the region name, appended to the currently open path
+    ScopedRegion( const char* name)
+    {
+        std::string& path = detail::current_path();
+        m_parent_size = path.size();
+        if( !path.empty()) path += "/";
+        path += name;
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        cudaDeviceSynchronize();
+#endif
+        m_start = std::chrono::steady_clock::now();
+    }
+    ///@brief Stop the timer and accumulate into the registry
+    ~ScopedRegion()
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        cudaDeviceSynchronize();
+#endif
+        double diff = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start).count()*1e-9;
+        std::string& path = detail::current_path();
+        detail::Record& rec = detail::registry()[path];
+        rec.time += diff;
+        rec.count ++;
+        path.resize( m_parent_size);
+    }
+    ScopedRegion( const ScopedRegion&) = delete;
+    ScopedRegion& operator=( const ScopedRegion&) = delete;
+    private:
+    size_t m_parent_size;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+///@brief Clear all accumulated regions (e.g. after a warm-up phase)
+///@ingroup misc
+inline void reset()
+{
+    detail::registry().clear();
+}
+
+/**
+ * @brief Write all accumulated regions as JSON
+ *
+ * The output maps each region path to its visit count and accumulated time in
+ * seconds, e.g.
+ * @code{.js}
+{
+    "multistep::step" : { "count" : 1000, "time" : 12.3 },
+    "multistep::step/blas2::symv" : { "count" : 3000, "time" : 8.9 }
+}
+ * @endcode
+ * @param os stream to write to (e.g. \c std::cout or an \c std::ofstream)
+ * @ingroup misc
+ */
+inline void dump_json( std::ostream& os)
+{
+    os << "{\n";
+    bool first = true;
+    for( const auto& pair : detail::registry())
+    {
+        if( !first)
+            os << ",\n";
+        first = false;
+        os << "    \""<<pair.first<<"\" : { \"count\" : "<<pair.second.count
+           <<", \"time\" : "<<pair.second.time<<" }";
+    }
+    os << "\n}"<<std::endl;
+}
+#ifdef MPI_VERSION
+/**
+ * @brief Write all accumulated regions as JSON with statistics across ranks
+ *
+ * Like the serial overload but the accumulated times are reduced over all
+ * processes in \c comm and rank 0 writes min, max and average per region,
+ * e.g.
+ * @code{.js}
+{
+    "multistep::step" : { "count" : 1000, "min" : 11.9, "max" : 12.5, "avg" : 12.2 }
+}
+ * @endcode
+ * @param os stream to write to (only rank 0 in \c comm writes)
+ * @param comm the communicator over which to reduce (a collective call: all
+ * ranks must call this function and must have visited the same regions)
+ * @ingroup misc
+ */
+inline void dump_json( std::ostream& os, MPI_Comm comm)
+{
+    const auto& reg = detail::registry();
+    std::vector<double> times;
+    times.reserve( reg.size());
+    for( const auto& pair : reg)
+        times.push_back( pair.second.time);
+    std::vector<double> min( times), max( times), sum( times);
+    int rank, size;
+    MPI_Comm_rank( comm, &rank);
+    MPI_Comm_size( comm, &size);
+    unsigned num = times.size();
+    MPI_Reduce( rank==0 ? MPI_IN_PLACE : min.data(), min.data(), num, MPI_DOUBLE, MPI_MIN, 0, comm);
+    MPI_Reduce( rank==0 ? MPI_IN_PLACE : max.data(), max.data(), num, MPI_DOUBLE, MPI_MAX, 0, comm);
+    MPI_Reduce( rank==0 ? MPI_IN_PLACE : sum.data(), sum.data(), num, MPI_DOUBLE, MPI_SUM, 0, comm);
+    if( rank != 0)
+        return;
+    os << "{\n";
+    unsigned i = 0;
+    for( const auto& pair : reg)
+    {
+        os << "    \""<<pair.first<<"\" : { \"count\" : "<<pair.second.count
+           <<", \"min\" : "<<min[i]<<", \"max\" : "<<max[i]
+           <<", \"avg\" : "<<sum[i]/(double)size<<" }";
+        i++;
+        if( i != reg.size())
+            os << ",";
+        os << "\n";
+    }
+    os << "}"<<std::endl;
+}
+#endif //MPI_VERSION
+}//namespace prof
+}//namespace dg
+
+///@cond
+#ifdef DG_PROFILE
+#define DG_PROF_PASTE2( a, b) a##b
+#define DG_PROF_PASTE( a, b) DG_PROF_PASTE2( a, b)
+#define DG_PROF_SCOPE( name) dg::prof::ScopedRegion DG_PROF_PASTE( _dg_prof_region_, __LINE__)( name)
+#else
+/// Time the enclosing scope as a profiler region (no-op unless DG_PROFILE is defined)
+#define DG_PROF_SCOPE( name)
+#endif //DG_PROFILE
+///@endcond
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <vector>
 #include <thrust/device_vector.h>
 //#include <cusp/system/cuda/utils.h>
 #include "sparseblockmat.h"
@@ -11,6 +13,8 @@ template<class value_type>
 using EllSparseBlockMatDevice = EllSparseBlockMat<value_type>;
 template<class value_type>
 using CooSparseBlockMatDevice = CooSparseBlockMat<value_type>;
+template<class value_type>
+using BlockDiagMatDevice = BlockDiagMat<value_type>;
 #else
 
 /**
@@ -33,6 +37,10 @@ struct EllSparseBlockMatDevice
     * A device matrix has to be constructed from a host matrix. It simply
         copies all internal data of the host matrix to the device
         @param src  source on the host
+    * @note if the matrix is a fixed plane stencil (all interior rows apply
+    * the same \c 1x1 blocks to contiguous neighbouring planes, like the
+    * z-derivatives of a \c Grid3d ) this is detected here and \c symv
+    * dispatches to a specialized kernel without per-block index loads
     */
     EllSparseBlockMatDevice( const EllSparseBlockMat<value_type>& src)
     {
@@ -41,6 +49,91 @@ struct EllSparseBlockMatDevice
         num_rows = src.num_rows, num_cols = src.num_cols, blocks_per_line = src.blocks_per_line;
         n = src.n, left_size = src.left_size, right_size = src.right_size;
         right_range = src.right_range;
+        affine_idx = src.affine_idx, affine_vals = src.affine_vals;
+        //detect a fixed plane stencil (e.g. dz at n_z = 1): only the
+        //boundary rows then need the index arrays at all
+        if( n == 1 && left_size == 1 && right_size > 1 && num_rows > 2
+            && blocks_per_line <= 3
+            && src.right_range[0] == 0 && src.right_range[1] == right_size)
+        {
+            plane_stencil = true;
+            stencil_vals.resize( blocks_per_line);
+            stencil_offs.resize( blocks_per_line);
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                stencil_offs[d] = src.cols_idx[blocks_per_line+d] - 1;
+                stencil_vals[d] = src.data[ src.data_idx[blocks_per_line+d]];
+            }
+            for( int i=1; i<num_rows-1 && plane_stencil; i++)
+            for( int d=0; d<blocks_per_line; d++)
+                if( src.cols_idx[i*blocks_per_line+d] != i + stencil_offs[d]
+                 || src.data[ src.data_idx[i*blocks_per_line+d]]
+                    != stencil_vals[d])
+                    plane_stencil = false;
+        }
+        //detect a block diagonal transform ( e.g. dg::create::fast_transform):
+        //every line applies the same single n x n block to its own cell,
+        //which maps onto a (batched) small GEMM that vendor BLAS libraries
+        //accelerate ( enable with DG_USE_CUBLAS / DG_USE_MKL)
+        if( blocks_per_line == 1 && n > 1 && num_rows == num_cols
+            && src.right_range[0] == 0 && src.right_range[1] == right_size)
+        {
+            block_diag = true;
+            for( int i=0; i<num_rows && block_diag; i++)
+                if( src.cols_idx[i] != i || src.data_idx[i] != 0)
+                    block_diag = false;
+        }
+    }
+    /**
+    * @brief Allocate storage in an optional sliced (SELL-C) layout
+    *
+    * In the default layout the data array holds only the \c
+    * num_different_blocks distinct blocks and threads reach them through the
+    * \c data_idx indirection. For matrices with \c right_size==1 (e.g. the
+    * x-derivative) consecutive threads then read block elements \c n values
+    * apart and the loads do not coalesce. The sliced layout instead stores
+    * the blocks of every line explicitly, interleaved in slices of C=32
+    * lines (a warp) such that a warp reads consecutive addresses. This
+    * trades \c num_rows*blocks_per_line*n*n stored values for the \c
+    * n*n*num_different_blocks of the default layout. A sigma sorting step as
+    * in the general SELL-C-sigma format is unnecessary because all lines
+    * hold exactly \c blocks_per_line blocks.
+    * @param src source on the host
+    * @param use_sliced_layout if true, additionally assemble the sliced
+    * data arrays; \c symv then uses them whenever a tuned kernel is
+    * available (CUDA and \c right_size==1 ) and falls back to the default
+    * layout otherwise. Has no effect in OpenMP builds.
+    */
+    EllSparseBlockMatDevice( const EllSparseBlockMat<value_type>& src, bool use_sliced_layout)
+        : EllSparseBlockMatDevice( src)
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        if( !use_sliced_layout)
+            return;
+        //C = 32 (warp size); pad the last slice with zero blocks
+        const int C = 32;
+        const int lines = num_rows*n;
+        const int num_slices = (lines+C-1)/C;
+        thrust::host_vector<value_type> sliced( (size_t)num_slices*blocks_per_line*n*C, 0);
+        thrust::host_vector<int> scols( (size_t)num_slices*blocks_per_line*C, 0);
+        for( int L=0; L<lines; L++)
+        {
+            int i = L/n, k = L%n, slice = L/C, l = L%C;
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                //store the column index premultiplied by n
+                scols[ (slice*blocks_per_line+d)*C+l] = src.cols_idx[i*blocks_per_line+d]*n;
+                for( int q=0; q<n; q++)
+                    sliced[ ((slice*blocks_per_line+d)*n+q)*C+l] =
+                        src.data[ (src.data_idx[i*blocks_per_line+d]*n+k)*n+q];
+            }
+        }
+        data_sliced = sliced;
+        cols_sliced = scols;
+        sliced_layout = true;
+#else
+        (void)use_sliced_layout;
+#endif
     }
     /**
     * @brief Display internal data to a stream
@@ -67,12 +160,40 @@ struct EllSparseBlockMatDevice
     void symv(SharedVectorTag, CudaTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
 #ifdef _OPENMP
     void symv(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+#endif //_OPENMP
+    /**
+    * @brief Apply the matrix and add a vector in a single pass
+    * \f[  z= \alpha M x + \beta y\f]
+    * This fuses \c symv with a subsequent \c axpby such that \c x and \c y
+    * are read and \c z is written only once
+    * @param alpha multiplies input
+    * @param x input
+    * @param beta multiplies \p y
+    * @param y second input (may alias \p z but not \p x)
+    * @param z output may not alias \p x
+    */
+    void symv_axpby(SharedVectorTag, CudaTag, value_type alpha, const value_type* x, value_type beta, const value_type* y, value_type* z) const;
+#ifdef _OPENMP
+    void symv_axpby(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, const value_type* y, value_type* z) const;
 #endif //_OPENMP
     void launch_multiply_kernel(value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+    void launch_multiply_axpby_kernel(value_type alpha, const value_type* x, value_type beta, const value_type* y, value_type* z) const;
+    void launch_affine_kernel(value_type alpha, value_type* y) const;
+    //only defined (and called) if DG_USE_CUBLAS resp. DG_USE_MKL is defined
+    void launch_block_diag_gemm(value_type alpha, const value_type* x, value_type beta, value_type* y) const;
 
     thrust::device_vector<value_type> data;
     thrust::device_vector<int> cols_idx, data_idx;
     thrust::device_vector<int> right_range; // behold that right_size != right_range[1]-right_range[0] in general
+    thrust::device_vector<int> affine_idx; //!< indices of the sparse affine correction (see \c EllSparseBlockMat::set_affine, may be empty)
+    thrust::device_vector<value_type> affine_vals; //!< values of the sparse affine correction (same size as \c affine_idx)
+    thrust::device_vector<value_type> data_sliced; //!< per-line blocks interleaved in slices of 32 lines (only if \c sliced_layout)
+    thrust::device_vector<int> cols_sliced; //!< per-line column indices (times \c n) interleaved in slices of 32 lines (only if \c sliced_layout)
+    bool sliced_layout = false; //!< true if the sliced arrays are assembled
+    thrust::host_vector<value_type> stencil_vals; //!< the interior row blocks (only if \c plane_stencil)
+    thrust::host_vector<int> stencil_offs; //!< the interior row plane offsets (only if \c plane_stencil)
+    bool plane_stencil = false; //!< true if all interior rows apply the same \c 1x1 blocks to contiguous planes
+    bool block_diag = false; //!< true if every line applies the same single \c nxn block to its own cell
     int num_rows, num_cols, blocks_per_line;
     int n;
     int left_size, right_size;
@@ -95,14 +216,39 @@ struct CooSparseBlockMatDevice
     /**
     * @brief Allocate storage
     *
-    * A device matrix has to be constructed from a host matrix. It simply
-        copies all internal data of the host matrix to the device
+    * A device matrix has to be constructed from a host matrix. It
+        copies all internal data of the host matrix to the device and in
+        addition sorts the entries by row and groups entries that share a
+        row, such that the multiply kernel can parallelize over all
+        boundary points with one thread per point (entries of a row are
+        summed inside the thread, which avoids the write conflict)
         @param src  source on the host
     */
     CooSparseBlockMatDevice( const CooSparseBlockMat<value_type>& src)
     {
+        int num = src.rows_idx.size();
+        std::vector<int> order( num);
+        for( int i=0; i<num; i++)
+            order[i] = i;
+        std::stable_sort( order.begin(), order.end(), [&src]( int i, int j){
+            return src.rows_idx[i] < src.rows_idx[j];});
+        thrust::host_vector<int> rows(num), cols(num), blocks(num);
+        thrust::host_vector<int> u_rows, r_ptr;
+        for( int i=0; i<num; i++)
+        {
+            rows[i] = src.rows_idx[order[i]];
+            cols[i] = src.cols_idx[order[i]];
+            blocks[i] = src.data_idx[order[i]];
+            if( i==0 || rows[i] != rows[i-1])
+            {
+                u_rows.push_back( rows[i]);
+                r_ptr.push_back( i);
+            }
+        }
+        r_ptr.push_back( num);
         data = src.data;
-        rows_idx = src.rows_idx, cols_idx = src.cols_idx, data_idx = src.data_idx;
+        rows_idx = rows, cols_idx = cols, data_idx = blocks;
+        unique_rows = u_rows, rows_ptr = r_ptr;
         num_rows = src.num_rows, num_cols = src.num_cols, num_entries = src.num_entries;
         n = src.n, left_size = src.left_size, right_size = src.right_size;
     }
@@ -136,16 +282,88 @@ struct CooSparseBlockMatDevice
 
     thrust::device_vector<value_type> data;
     thrust::device_vector<int> cols_idx, rows_idx, data_idx;
+    //entries are sorted by row; unique_rows holds the distinct row indices
+    //and rows_ptr the csr-like offsets of their entries
+    thrust::device_vector<int> unique_rows, rows_ptr;
     int num_rows, num_cols, num_entries;
     int n, left_size, right_size;
 };
 
+/**
+* @brief Dense Block Diagonal Matrix format device version
+*
+* @ingroup sparsematrix
+* This class holds a copy of a BlockDiagMat on the device, which may
+be gpu or omp depending on the THRUST_DEVICE_SYSTEM macro. It does the same thing as the host version with the difference that it applies to device vectors.
+
+@copydetails BlockDiagMat
+*/
+template<class value_type>
+struct BlockDiagMatDevice
+{
+    BlockDiagMatDevice() = default;
+    /**
+    * @brief Allocate storage
+    *
+    * A device matrix has to be constructed from a host matrix. It simply
+        copies all internal data of the host matrix to the device
+        @param src  source on the host
+    */
+    BlockDiagMatDevice( const BlockDiagMat<value_type>& src)
+    {
+        data = src.data;
+        num_y = src.num_y, num_x = src.num_x;
+        ny = src.ny, nx = src.nx, left_size = src.left_size;
+    }
+    ///@copydoc BlockDiagMat::m()
+    int m() const { return ny*nx;}
+    /// total number of rows is \c left_size*num_y*ny*num_x*nx
+    int total_num_rows()const{
+        return left_size*num_y*ny*num_x*nx;
+    }
+    /// the matrix is square
+    int total_num_cols()const{
+        return total_num_rows();
+    }
+
+    ///@copydoc EllSparseBlockMatDevice::symv()
+    void symv(SharedVectorTag, CudaTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+#ifdef _OPENMP
+    void symv(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+#endif //_OPENMP
+    void launch_multiply_kernel(value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+
+    thrust::device_vector<value_type> data;
+    int num_y, num_x;
+    int ny, nx;
+    int left_size;
+};
+
 ///@cond
 template<class value_type>
 inline void EllSparseBlockMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
         value_type alpha, const value_type* x, value_type beta, value_type* y) const
 {
+#ifdef DG_USE_CUBLAS
+    if( block_diag)
+    {
+        launch_block_diag_gemm( alpha, x, beta, y);
+        if( affine_idx.size() > 0)
+            launch_affine_kernel( alpha, y);
+        return;
+    }
+#endif //DG_USE_CUBLAS
     launch_multiply_kernel( alpha, x, beta, y);
+    if( affine_idx.size() > 0)
+        launch_affine_kernel( alpha, y);
+}
+template<class value_type>
+inline void EllSparseBlockMatDevice<value_type>::symv_axpby(SharedVectorTag, CudaTag,
+        value_type alpha, const value_type* x, value_type beta, const value_type* y, value_type* z) const
+{
+    launch_multiply_axpby_kernel( alpha, x, beta, y, z);
+    if( affine_idx.size() > 0)
+        launch_affine_kernel( alpha, z);
 }
 template<class value_type>
 inline void CooSparseBlockMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
@@ -155,19 +373,68 @@ inline void CooSparseBlockMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
         return;
     launch_multiply_kernel( alpha, x, beta, y);
 }
+template<class value_type>
+inline void BlockDiagMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
+        value_type alpha, const value_type* x, value_type beta, value_type* y) const
+{
+    launch_multiply_kernel( alpha, x, beta, y);
+}
 #ifdef _OPENMP
 template<class value_type>
 inline void EllSparseBlockMatDevice<value_type>::symv(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const
 {
+#ifdef DG_USE_MKL
+    //MKL manages its own threads, so only take this path outside of
+    //parallel regions
+    if( block_diag && !omp_in_parallel())
+    {
+        launch_block_diag_gemm( alpha, x, beta, y);
+        if( affine_idx.size() > 0)
+            launch_affine_kernel( alpha, y);
+        return;
+    }
+#endif //DG_USE_MKL
     if( !omp_in_parallel())
     {
-        #pragma omp parallel
+        #pragma omp parallel num_threads( dg::detail::omp_team_size( \
+            (long long)left_size*num_rows*n*right_size))
         {
             launch_multiply_kernel(alpha, x, beta, y);
         }
+        if( affine_idx.size() > 0)
+            launch_affine_kernel( alpha, y);
         return;
     }
     launch_multiply_kernel(alpha, x, beta, y);
+    if( affine_idx.size() > 0)
+    {
+        #pragma omp barrier
+        #pragma omp single
+        launch_affine_kernel( alpha, y);
+    }
+}
+
+template<class value_type>
+inline void EllSparseBlockMatDevice<value_type>::symv_axpby(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, const value_type* y, value_type* z) const
+{
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel num_threads( dg::detail::omp_team_size( \
+            (long long)left_size*num_rows*n*right_size))
+        {
+            launch_multiply_axpby_kernel(alpha, x, beta, y, z);
+        }
+        if( affine_idx.size() > 0)
+            launch_affine_kernel( alpha, z);
+        return;
+    }
+    launch_multiply_axpby_kernel(alpha, x, beta, y, z);
+    if( affine_idx.size() > 0)
+    {
+        #pragma omp barrier
+        #pragma omp single
+        launch_affine_kernel( alpha, z);
+    }
 }
 
 template<class value_type>
@@ -179,7 +446,23 @@ inline void CooSparseBlockMatDevice<value_type>::symv(SharedVectorTag, OmpTag, v
     // In fact, Beta is ignored in the following code
     if( !omp_in_parallel())
     {
-        #pragma omp parallel
+        #pragma omp parallel num_threads( dg::detail::omp_team_size( \
+            (long long)unique_rows.size()*n*left_size*right_size))
+        {
+            launch_multiply_kernel(alpha, x, beta, y);
+        }
+        return;
+    }
+    launch_multiply_kernel(alpha, x, beta, y);
+}
+
+template<class value_type>
+inline void BlockDiagMatDevice<value_type>::symv(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const
+{
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel num_threads( dg::detail::omp_team_size( \
+            (long long)total_num_rows()))
         {
             launch_multiply_kernel(alpha, x, beta, y);
         }
@@ -256,6 +539,12 @@ struct TensorTraits<CooSparseBlockMatDevice<T> >
     using value_type  = T;
     using tensor_category = SparseBlockMatrixTag;
 };
+template <class T>
+struct TensorTraits<BlockDiagMatDevice<T> >
+{
+    using value_type  = T;
+    using tensor_category = SparseBlockMatrixTag;
+};
 ///@}
 #endif // THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CPP
 } //namespace dg
@@ -74,6 +74,14 @@ struct EllSparseBlockMat
             right_range[0]=0;
             right_range[1]=1;
         }
+    /**
+    * @brief Same as the copy constructor
+    *
+    * The layout flag selects the sliced (SELL-C) storage in the device
+    * version \c EllSparseBlockMatDevice and is ignored on the host; this
+    * overload exists so that shared code compiles for all backends
+    */
+    EllSparseBlockMat( const EllSparseBlockMat& src, bool): EllSparseBlockMat( src){}
     /// total number of rows is \c num_rows*n*left_size*right_size
     int total_num_rows()const{
         return num_rows*n*left_size*right_size;
@@ -101,6 +109,20 @@ struct EllSparseBlockMat
     */
     void symv(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const;
 
+    /**
+    * @brief Apply the matrix and add a vector in a single pass
+    *
+    * \f[  z= \alpha M x + \beta y\f]
+    * This fuses \c symv with a subsequent \c axpby such that \c x and \c y
+    * are read and \c z is written only once
+    * @param alpha multiplies input
+    * @param x input
+    * @param beta multiplies \p y
+    * @param y second input (may alias \p z but not \p x)
+    * @param z output may not alias \p x
+    */
+    void symv_axpby(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, const value_type* RESTRICT y, value_type* RESTRICT z) const;
+
     ///@brief Set <tt> right_range[0] = 0, right_range[1] = right_size</tt>
     void set_default_range(){
         right_range[0]=0;
@@ -116,6 +138,42 @@ struct EllSparseBlockMat
         left_size = new_left_size;
     }
     /**
+    * @brief Set a sparse affine correction \f$ b \f$ such that \c symv computes \f$ y = \alpha ( Mx + b) + \beta y\f$
+    *
+    * The intended use are inhomogeneous boundary conditions: the matrices
+    * created by e.g. \c dg::create::dx assume homogeneous boundaries, so a
+    * Dirichlet or Neumann profile traditionally requires an extra
+    * full-field manipulation of \c x before every application. Since the
+    * boundary only touches a few rows the correction is stored sparsely and
+    * its application costs a scatter over the boundary entries only.
+    * @param idx indices into the result vector (between 0 and
+    * <tt>total_num_rows()</tt>) where the correction adds
+    * @param vals the corresponding nonzero entries of \f$ b\f$ (same size as \c idx)
+    */
+    void set_affine( const thrust::host_vector<int>& idx,
+        const thrust::host_vector<value_type>& vals)
+    {
+        affine_idx = idx, affine_vals = vals;
+    }
+    /**
+    * @brief Compress a full correction vector into the sparse affine term
+    *
+    * Convenience overload that extracts the nonzero entries of \c b, e.g.
+    * computed once at setup by applying the matrix to a lifted boundary
+    * profile
+    * @param b the full correction vector of size <tt>total_num_rows()</tt>
+    */
+    void set_affine( const thrust::host_vector<value_type>& b)
+    {
+        affine_idx.clear(), affine_vals.clear();
+        for( unsigned u=0; u<b.size(); u++)
+            if( b[u] != 0)
+            {
+                affine_idx.push_back( (int)u);
+                affine_vals.push_back( b[u]);
+            }
+    }
+    /**
     * @brief Display internal data to a stream
     *
     * @param os the output stream
@@ -123,6 +181,8 @@ struct EllSparseBlockMat
     */
     void display( std::ostream& os = std::cout, bool show_data = false) const;
 
+    thrust::host_vector<int> affine_idx; //!< indices of the sparse affine correction (see \c set_affine, may be empty)
+    thrust::host_vector<value_type> affine_vals; //!< values of the sparse affine correction (same size as \c affine_idx)
     thrust::host_vector<value_type> data;//!< The data array is of size n*n*num_different_blocks and contains the blocks. The first block is contained in the first n*n elements, then comes the next block, etc.
     thrust::host_vector<int> cols_idx; //!< is of size num_rows*num_blocks_per_line and contains the column indices % n into the vector
     thrust::host_vector<int> data_idx; //!< has the same size as cols_idx and contains indices into the data array, i.e. the block number
@@ -252,11 +312,247 @@ struct CooSparseBlockMat
     int left_size; //!< size of the left Kronecker delta
     int right_size; //!< size of the right Kronecker delta (is e.g 1 for a x - derivative)
 };
+
+/**
+* @brief Dense Block Diagonal Matrix format
+*
+* @ingroup sparsematrix
+* This format stores one dense block per dG cell of a two-dimensional
+* product grid (use <tt> ny = num_y = 1</tt> for one-dimensional grids)
+\f[ M = 1_\mathrm{left} \otimes \mathrm{diag}( B_0, B_1, ... ) \f]
+* where the \f$ B_k\f$ are dense \f$ n_y n_x \times n_y n_x\f$ matrices and
+* \f$ 1_\mathrm{left}\f$ is a diagonal matrix of variable size. In contrast
+* to \c EllSparseBlockMat every cell owns its own block and a block couples
+* all \c ny*nx polynomial coefficients of its cell, which in the vector
+* layout of a product grid are not contiguous; the format therefore does not
+* fit the left/right Kronecker structure of the one-dimensional blocks.
+*
+* The principal use is the per-cell block-Jacobi preconditioner assembled in
+* \c dg::create::block_jacobi, where the \f$ B_k\f$ hold the inverted
+* diagonal blocks of an elliptic operator.
+*/
+template<class value_type>
+struct BlockDiagMat
+{
+    ///@brief default constructor does nothing
+    BlockDiagMat() = default;
+    /**
+    * @brief Allocate storage
+    *
+    * Initializes <tt> left_size = 1</tt> and
+    * <tt> data( num_y*num_x*ny*nx*ny*nx, 0)</tt>
+    * @param num_y number of cells in y (the outer dimension)
+    * @param num_x number of cells in x (the inner dimension)
+    * @param ny number of polynomial coefficients per cell in y
+    * @param nx number of polynomial coefficients per cell in x
+    */
+    BlockDiagMat( int num_y, int num_x, int ny, int nx):
+        data( (size_t)num_y*num_x*ny*nx*ny*nx, 0),
+        num_y(num_y), num_x(num_x), ny(ny), nx(nx), left_size(1){}
+    ///@brief each block is of size \c m x \c m with <tt> m = ny*nx</tt>
+    int m() const { return ny*nx;}
+    /// total number of rows is \c left_size*num_y*ny*num_x*nx
+    int total_num_rows()const{
+        return left_size*num_y*ny*num_x*nx;
+    }
+    /// the matrix is square
+    int total_num_cols()const{
+        return total_num_rows();
+    }
+    ///@brief Set <tt> left_size = new_left_size;</tt>
+    void set_left_size( int new_left_size ){
+        left_size = new_left_size;
+    }
+    ///@copydoc EllSparseBlockMat::symv()
+    void symv(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const;
+    ///@copydoc EllSparseBlockMat::display()
+    void display( std::ostream& os = std::cout, bool show_data = false) const;
+
+    thrust::host_vector<value_type> data; //!< \c num_y*num_x blocks of size m*m in row-major order, the block of cell (i,j) starts at element (i*num_x+j)*m*m
+    int num_y; //!< number of cells in y
+    int num_x; //!< number of cells in x
+    int ny; //!< polynomial coefficients per cell in y
+    int nx; //!< polynomial coefficients per cell in x
+    int left_size; //!< size of the left Kronecker delta
+};
 ///@cond
 
+//serial multiply kernel with compile time block size and blocks per line
+//such that the compiler can fully unroll the two innermost loops
+//(the omp and gpu backends have analogous specializations)
+template<class value_type, int n, int blocks_per_line>
+void ell_serial_multiply_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data, const int * RESTRICT cols_idx,
+         const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range,
+         const value_type * RESTRICT x, value_type * RESTRICT y
+         )
+{
+    for( int s=0; s<left_size; s++)
+    for( int i=0; i<num_rows; i++)
+    {
+        int J[blocks_per_line];
+        for( int d=0; d<blocks_per_line; d++)
+            J[d] = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+        for( int k=0; k<n; k++)
+        {
+            int B[blocks_per_line];
+            for( int d=0; d<blocks_per_line; d++)
+                B[d] = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            for( int j=right_range[0]; j<right_range[1]; j++)
+            {
+                int I = ((s*num_rows + i)*n+k)*right_size+j;
+                // if y[I] isnan then even beta = 0 does not make it 0
+                y[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+                for( int d=0; d<blocks_per_line; d++)
+                {
+                    value_type temp = 0;
+                    for( int q=0; q<n; q++) //multiplication-loop
+                        temp = DG_FMA( data[ B[d]+q],
+                                x[(J[d]+q)*right_size+j],
+                                temp);
+                    y[I] = DG_FMA( alpha, temp, y[I]);
+                }
+            }
+        }
+    }
+}
+//z = alpha M x + beta y
+template<class value_type, int n, int blocks_per_line>
+void ell_serial_multiply_axpby_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data, const int * RESTRICT cols_idx,
+         const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range,
+         const value_type * RESTRICT x, const value_type * RESTRICT y,
+         value_type * RESTRICT z
+         )
+{
+    for( int s=0; s<left_size; s++)
+    for( int i=0; i<num_rows; i++)
+    {
+        int J[blocks_per_line];
+        for( int d=0; d<blocks_per_line; d++)
+            J[d] = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+        for( int k=0; k<n; k++)
+        {
+            int B[blocks_per_line];
+            for( int d=0; d<blocks_per_line; d++)
+                B[d] = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            for( int j=right_range[0]; j<right_range[1]; j++)
+            {
+                int I = ((s*num_rows + i)*n+k)*right_size+j;
+                // if y[I] isnan then even beta = 0 does not make it 0
+                z[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+                for( int d=0; d<blocks_per_line; d++)
+                {
+                    value_type temp = 0;
+                    for( int q=0; q<n; q++) //multiplication-loop
+                        temp = DG_FMA( data[ B[d]+q],
+                                x[(J[d]+q)*right_size+j],
+                                temp);
+                    z[I] = DG_FMA( alpha, temp, z[I]);
+                }
+            }
+        }
+    }
+}
+template<class value_type, int n>
+bool call_ell_serial_multiply_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data, const int * RESTRICT cols_idx,
+         const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range,
+         const value_type * RESTRICT x, value_type * RESTRICT y
+         )
+{
+    if( blocks_per_line == 1)
+        ell_serial_multiply_kernel<value_type, n, 1>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y);
+    else if( blocks_per_line == 2)
+        ell_serial_multiply_kernel<value_type, n, 2>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y);
+    else if( blocks_per_line == 3)
+        ell_serial_multiply_kernel<value_type, n, 3>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y);
+    else if( blocks_per_line == 4)
+        ell_serial_multiply_kernel<value_type, n, 4>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y);
+    else
+        return false;
+    return true;
+}
+template<class value_type, int n>
+bool call_ell_serial_multiply_axpby_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data, const int * RESTRICT cols_idx,
+         const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range,
+         const value_type * RESTRICT x, const value_type * RESTRICT y,
+         value_type * RESTRICT z
+         )
+{
+    if( blocks_per_line == 1)
+        ell_serial_multiply_axpby_kernel<value_type, n, 1>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y, z);
+    else if( blocks_per_line == 2)
+        ell_serial_multiply_axpby_kernel<value_type, n, 2>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y, z);
+    else if( blocks_per_line == 3)
+        ell_serial_multiply_axpby_kernel<value_type, n, 3>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y, z);
+    else if( blocks_per_line == 4)
+        ell_serial_multiply_axpby_kernel<value_type, n, 4>( alpha, beta, data,
+        cols_idx, data_idx, num_rows, num_cols, left_size, right_size,
+        right_range, x, y, z);
+    else
+        return false;
+    return true;
+}
+
 template<class value_type>
 void EllSparseBlockMat<value_type>::symv(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const
 {
+    //dispatch to a kernel with compile time block size if possible
+    const value_type* data_ptr = &data[0];
+    const int* cols_ptr = &cols_idx[0];
+    const int* block_ptr = &data_idx[0];
+    const int* right_range_ptr = &right_range[0];
+    bool dispatched = false;
+    if( n == 1)
+        dispatched = call_ell_serial_multiply_kernel<value_type, 1>( alpha,
+        beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y);
+    else if( n == 2)
+        dispatched = call_ell_serial_multiply_kernel<value_type, 2>( alpha,
+        beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y);
+    else if( n == 3)
+        dispatched = call_ell_serial_multiply_kernel<value_type, 3>( alpha,
+        beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y);
+    else if( n == 4)
+        dispatched = call_ell_serial_multiply_kernel<value_type, 4>( alpha,
+        beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y);
+    else if( n == 5)
+        dispatched = call_ell_serial_multiply_kernel<value_type, 5>( alpha,
+        beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y);
+    if( !dispatched)
+    {
     //simplest implementation (all optimization must respect the order of operations)
     for( int s=0; s<left_size; s++)
     for( int i=0; i<num_rows; i++)
@@ -276,6 +572,65 @@ void EllSparseBlockMat<value_type>::symv(SharedVectorTag, SerialTag, value_type
             y[I] = DG_FMA( alpha,temp, y[I]);
         }
     }
+    }
+    //add the sparse affine correction (inhomogeneous boundary conditions)
+    for( unsigned u=0; u<affine_idx.size(); u++)
+        y[affine_idx[u]] = DG_FMA( alpha, affine_vals[u], y[affine_idx[u]]);
+}
+template<class value_type>
+void EllSparseBlockMat<value_type>::symv_axpby(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, const value_type* RESTRICT y, value_type* RESTRICT z) const
+{
+    //dispatch to a kernel with compile time block size if possible
+    const value_type* data_ptr = &data[0];
+    const int* cols_ptr = &cols_idx[0];
+    const int* block_ptr = &data_idx[0];
+    const int* right_range_ptr = &right_range[0];
+    bool dispatched = false;
+    if( n == 1)
+        dispatched = call_ell_serial_multiply_axpby_kernel<value_type, 1>(
+        alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y, z);
+    else if( n == 2)
+        dispatched = call_ell_serial_multiply_axpby_kernel<value_type, 2>(
+        alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y, z);
+    else if( n == 3)
+        dispatched = call_ell_serial_multiply_axpby_kernel<value_type, 3>(
+        alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y, z);
+    else if( n == 4)
+        dispatched = call_ell_serial_multiply_axpby_kernel<value_type, 4>(
+        alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y, z);
+    else if( n == 5)
+        dispatched = call_ell_serial_multiply_axpby_kernel<value_type, 5>(
+        alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, left_size, right_size, right_range_ptr, x, y, z);
+    if( !dispatched)
+    {
+    //simplest implementation (all optimization must respect the order of operations)
+    for( int s=0; s<left_size; s++)
+    for( int i=0; i<num_rows; i++)
+    for( int k=0; k<n; k++)
+    for( int j=right_range[0]; j<right_range[1]; j++)
+    {
+        int I = ((s*num_rows + i)*n+k)*right_size+j;
+        // if y[I] isnan then even beta = 0 does not make it 0
+        z[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            value_type temp = 0;
+            for( int q=0; q<n; q++) //multiplication-loop
+                temp = DG_FMA( data[ (data_idx[i*blocks_per_line+d]*n + k)*n+q],
+                            x[((s*num_cols + cols_idx[i*blocks_per_line+d])*n+q)*right_size+j],
+                            temp);
+            z[I] = DG_FMA( alpha,temp, z[I]);
+        }
+    }
+    }
+    //add the sparse affine correction (inhomogeneous boundary conditions)
+    for( unsigned u=0; u<affine_idx.size(); u++)
+        z[affine_idx[u]] = DG_FMA( alpha, affine_vals[u], z[affine_idx[u]]);
 }
 template<class value_type>
 cusp::coo_matrix<int, value_type, cusp::host_memory> EllSparseBlockMat<value_type>::asCuspMatrix() const
@@ -333,6 +688,30 @@ void CooSparseBlockMat<value_type>::symv( SharedVectorTag, SerialTag, value_type
     }
 }
 
+template<class value_type>
+void BlockDiagMat<value_type>::symv( SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const
+{
+    const int mm = m();
+    for( int s=0; s<left_size; s++)
+    for( int i=0; i<num_y; i++)
+    for( int j=0; j<num_x; j++)
+    {
+        const value_type* B = &data[ ((size_t)i*num_x+j)*mm*mm];
+        for( int r=0; r<mm; r++)
+        {
+            int I = (((s*num_y + i)*ny+r/nx)*num_x + j)*nx + r%nx;
+            // if y[I] isnan then even beta = 0 does not make it 0
+            y[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+            value_type temp = 0;
+            for( int c=0; c<mm; c++) //multiplication-loop
+                temp = DG_FMA( B[r*mm+c],
+                        x[(((s*num_y + i)*ny+c/nx)*num_x + j)*nx + c%nx],
+                        temp);
+            y[I] = DG_FMA( alpha, temp, y[I]);
+        }
+    }
+}
+
 template<class T>
 void EllSparseBlockMat<T>::display( std::ostream& os, bool show_data ) const
 {
@@ -401,6 +780,30 @@ void CooSparseBlockMat<value_type>::display( std::ostream& os, bool show_data) c
 
 }
 
+template<class value_type>
+void BlockDiagMat<value_type>::display( std::ostream& os, bool show_data) const
+{
+    os << "Data array has   "<<num_y*num_x<<" blocks of size "<<m()<<"x"<<m()<<"\n";
+    os << "num_y            "<<num_y<<"\n";
+    os << "num_x            "<<num_x<<"\n";
+    os << "ny               "<<ny<<"\n";
+    os << "nx               "<<nx<<"\n";
+    os << "left_size             "<<left_size<<"\n";
+    if(show_data)
+    {
+        os << "\n Data: \n";
+        const int mm = m();
+        for( int i=0; i<num_y*num_x; i++)
+            for( int k=0; k<mm*mm; k++)
+            {
+                dg::exblas::udouble res;
+                res.d = data[(size_t)i*mm*mm+k];
+                os << "idx "<<i<<" "<<res.d <<"\t"<<res.i<<"\n";
+            }
+    }
+    os << std::endl;
+}
+
 ///@endcond
 ///@addtogroup traits
 ///@{
@@ -411,6 +814,12 @@ struct TensorTraits<EllSparseBlockMat<T> >
     using tensor_category = SparseBlockMatrixTag;
 };
 template <class T>
+struct TensorTraits<BlockDiagMat<T> >
+{
+    using value_type  = T;
+    using tensor_category = SparseBlockMatrixTag;
+};
+template <class T>
 struct TensorTraits<CooSparseBlockMat<T> >
 {
     using value_type  = T;
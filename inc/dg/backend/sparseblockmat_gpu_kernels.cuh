@@ -1,7 +1,32 @@
 #pragma once
 
+#include <map>
+#include <tuple>
+#ifdef DG_USE_CUBLAS
+#include <cublas_v2.h>
+#endif //DG_USE_CUBLAS
+
 namespace dg
 {
+namespace detail
+{
+//shape of an ell multiply kernel launch; identifies an entry in the tuning cache
+struct EllKernelShape
+{
+    int n, blocks_per_line, num_rows, left_size, right_size;
+    bool operator<( const EllKernelShape& rhs) const
+    {
+        return std::tie( n, blocks_per_line, num_rows, left_size, right_size)
+             < std::tie( rhs.n, rhs.blocks_per_line, rhs.num_rows, rhs.left_size, rhs.right_size);
+    }
+};
+//per process cache of the fastest block size for each matrix shape
+inline std::map<EllKernelShape, size_t>& ell_kernel_tuning_cache()
+{
+    static std::map<EllKernelShape, size_t> cache;
+    return cache;
+}
+}//namespace detail
 
 // general multiply kernel
 template<class value_type>
@@ -145,17 +170,428 @@ template<class value_type, size_t n, size_t blocks_per_line>
     }
 }
 
+// general fused multiply+axpby kernel: z = alpha M x + beta y
+template<class value_type>
+ __global__ void ell_multiply_axpby_kernel( value_type alpha, value_type beta,
+         const value_type* __restrict__  data,
+         const int* __restrict__  cols_idx, const int* __restrict__  data_idx,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int n, const int size,
+         const int right_size,
+         const int* __restrict__  right_range,
+         const value_type* __restrict__  x, const value_type* __restrict__ y,
+         value_type * __restrict__ z
+         )
+{
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const int right_ = right_range[1]-right_range[0];
+    //every thread takes num_rows/grid_size rows
+    for( int row = thread_id; row<size; row += grid_size)
+    {
+        int rr = row/right_size, rrn = rr/n;
+        int s=rrn/num_rows,
+            i = (rrn)%num_rows,
+            k = (rr)%n,
+            j=right_range[0]+row%right_;
+        int idx = ((s*num_rows+i)*n+k)*right_size+j;
+        // if y[I] isnan then even beta = 0 does not make it 0
+        z[idx] = beta == 0 ? (value_type)0 : y[idx]*beta;
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            value_type temp=0;
+            int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+            for( int q=0; q<n; q++) //multiplication-loop
+                temp =fma( data[ B+q], x[(J+q)*right_size+j], temp);
+            z[idx]=fma( alpha, temp, z[idx]);
+        }
+    }
+}
+
+//specialized fused multiply+axpby kernel
+template<class value_type, size_t n, size_t blocks_per_line>
+ __global__ void ell_multiply_axpby_kernel(value_type alpha, value_type beta,
+         const value_type* __restrict__  data,
+         const int* __restrict__  cols_idx, const int* __restrict__  data_idx,
+         const int num_rows, const int num_cols,
+         const int size, const int right_size,
+         const int* __restrict__  right_range,
+         const value_type* __restrict__  x, const value_type* __restrict__ y,
+         value_type * __restrict__ z
+         )
+{
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const int right_ = right_range[1]-right_range[0];
+    //every thread takes num_rows/grid_size rows
+    for( int row = thread_id; row<size; row += grid_size)
+    {
+        value_type temp[blocks_per_line]={0};
+        if(right_size==1)
+        {
+            int rrn = row/n, k = row%n;
+            int s=rrn/num_rows, i = (rrn)%num_rows;
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+                int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+                for( int q=0; q<n; q++) //multiplication-loop
+                    temp[d] = fma( data[ B+q], x[(J+q)], temp[d]);
+            }
+            z[row] = beta == 0 ? (value_type)0 : y[row]*beta;
+            for( int d=0; d<blocks_per_line; d++)
+                z[row] = fma( alpha, temp[d], z[row]);
+        }
+        else
+        {
+            int rr = row/right_size;
+            int rrn = rr/n, k = rr%n;
+            int s=rrn/num_rows, i = (rrn)%num_rows;
+            int j=right_range[0]+row%right_;
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+                int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+                for( int q=0; q<n; q++) //multiplication-loop
+                    temp[d] = fma( data[ B+q], x[(J+q)*right_size+j], temp[d]);
+            }
+            int idx = ((s*num_rows+i)*n+k)*right_size+j;
+            z[idx] = beta == 0 ? (value_type)0 : y[idx]*beta;
+            for( int d=0; d<blocks_per_line; d++)
+                z[idx] = fma( alpha, temp[d], z[idx]);
+        }
+    }
+}
+
 template<class value_type, size_t n>
-void call_ell_multiply_kernel( value_type alpha, value_type beta,
+void call_ell_multiply_axpby_kernel( value_type alpha, value_type beta,
          const value_type * __restrict__ data_ptr,
          const int * __restrict__ cols_ptr, const int * __restrict__ block_ptr,
          const int num_rows, const int num_cols, const int blocks_per_line,
          const int left_size, const int right_size,
          const int * __restrict__ right_range_ptr,
+         const value_type * __restrict__ x_ptr,
+         const value_type * __restrict__ y_ptr, value_type * __restrict__ z_ptr)
+{
+    //set up kernel parameters
+    const size_t BLOCK_SIZE = 256;
+    const size_t size = left_size*right_size*num_rows*n; //number of lines
+    const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+    if( blocks_per_line == 1)
+        ell_multiply_axpby_kernel<value_type, n, 1><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols, size,
+        right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else if (blocks_per_line == 2)
+        ell_multiply_axpby_kernel<value_type, n, 2><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols, size,
+        right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else if (blocks_per_line == 3)
+        ell_multiply_axpby_kernel<value_type, n, 3><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols, size,
+        right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else if (blocks_per_line == 4)
+        ell_multiply_axpby_kernel<value_type, n, 4><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols, size,
+        right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else
+        ell_multiply_axpby_kernel<value_type><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        blocks_per_line, n, size, right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+}
+
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_multiply_axpby_kernel( value_type alpha, const value_type* x_ptr, value_type beta, const value_type* y_ptr, value_type* z_ptr) const
+{
+    const value_type* data_ptr = thrust::raw_pointer_cast( &data[0]);
+    const int* cols_ptr = thrust::raw_pointer_cast( &cols_idx[0]);
+    const int* block_ptr = thrust::raw_pointer_cast( &data_idx[0]);
+    const int* right_range_ptr = thrust::raw_pointer_cast( &right_range[0]);
+    if( n == 1)
+        call_ell_multiply_axpby_kernel<value_type, 1>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            left_size, right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else if( n == 2)
+        call_ell_multiply_axpby_kernel<value_type, 2>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            left_size, right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else if( n == 3)
+        call_ell_multiply_axpby_kernel<value_type, 3>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            left_size, right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else if( n == 4)
+        call_ell_multiply_axpby_kernel<value_type, 4>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            left_size, right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    else
+    {
+        //set up kernel parameters
+        const size_t BLOCK_SIZE = 256;
+        const size_t size = left_size*right_size*num_rows*n; //number of lines
+        const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+        ell_multiply_axpby_kernel<value_type><<<NUM_BLOCKS, BLOCK_SIZE>>>( alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            n, size, right_size, right_range_ptr,  x_ptr,y_ptr,z_ptr);
+    }
+}
+
+//scatter the sparse affine correction (inhomogeneous boundary conditions)
+template<class value_type>
+ __global__ void ell_affine_kernel( value_type alpha,
+         const int* __restrict__ idx,
+         const value_type* __restrict__ vals,
+         const size_t size,
+         value_type* __restrict__ y)
+{
+    const size_t thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const size_t grid_size = gridDim.x*blockDim.x;
+    for( size_t row = thread_id; row<size; row += grid_size)
+        y[idx[row]] = DG_FMA( alpha, vals[row], y[idx[row]]);
+}
+
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_affine_kernel( value_type alpha, value_type* y_ptr) const
+{
+    const int* idx_ptr = thrust::raw_pointer_cast( &affine_idx[0]);
+    const value_type* vals_ptr = thrust::raw_pointer_cast( &affine_vals[0]);
+    const size_t BLOCK_SIZE = 256;
+    const size_t size = affine_idx.size();
+    const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+    ell_affine_kernel<value_type><<<NUM_BLOCKS, BLOCK_SIZE>>>( alpha,
+        idx_ptr, vals_ptr, size, y_ptr);
+}
+
+//sliced (SELL-C) multiply kernel for right_size == 1
+//data and cols hold the blocks of every line explicitly, interleaved in
+//slices of C=32 lines such that the loads of a warp coalesce
+template<class value_type, size_t n, size_t blocks_per_line>
+ __global__ void ell_multiply_kernel_sliced(value_type alpha, value_type beta,
+         const value_type* __restrict__  data,
+         const int* __restrict__  cols,
+         const int num_rows, const int num_cols,
+         const int size,
+         const value_type* __restrict__  x, value_type * __restrict__ y
+         )
+{
+    const int C = 32;
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    //every thread takes size/grid_size lines
+    for( int row = thread_id; row<size; row += grid_size)
+    {
+        int L = row%(num_rows*n), s = row/(num_rows*n);
+        int slice = L/C, l = L%C;
+        value_type temp[blocks_per_line]={0};
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            int B = ((slice*blocks_per_line+d)*n)*C+l;
+            int J = s*num_cols*n + cols[(slice*blocks_per_line+d)*C+l];
+            for( int q=0; q<n; q++) //multiplication-loop
+                temp[d] = fma( data[ B+q*C], x[J+q], temp[d]);
+        }
+        y[row] = beta == 0 ? (value_type)0 : y[row]*beta;
+        for( int d=0; d<blocks_per_line; d++)
+            y[row] = fma( alpha, temp[d], y[row]);
+    }
+}
+
+template<class value_type, size_t n>
+bool call_ell_multiply_kernel_sliced( value_type alpha, value_type beta,
+         const value_type * __restrict__ data_ptr,
+         const int * __restrict__ cols_ptr,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size,
          const value_type * __restrict__ x_ptr, value_type * __restrict__ y_ptr)
 {
     //set up kernel parameters
     const size_t BLOCK_SIZE = 256;
+    const size_t size = left_size*num_rows*n; //number of lines
+    const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+    if( blocks_per_line == 1)
+        ell_multiply_kernel_sliced<value_type, n, 1><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, num_rows, num_cols, size, x_ptr,y_ptr);
+    else if (blocks_per_line == 2)
+        ell_multiply_kernel_sliced<value_type, n, 2><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, num_rows, num_cols, size, x_ptr,y_ptr);
+    else if (blocks_per_line == 3)
+        ell_multiply_kernel_sliced<value_type, n, 3><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, num_rows, num_cols, size, x_ptr,y_ptr);
+    else if (blocks_per_line == 4)
+        ell_multiply_kernel_sliced<value_type, n, 4><<<NUM_BLOCKS, BLOCK_SIZE>>>
+        (alpha, beta, data_ptr, cols_ptr, num_rows, num_cols, size, x_ptr,y_ptr);
+    else //fall back to the default layout
+        return false;
+    return true;
+}
+
+//multiply kernel with the stencil blocks staged in shared memory
+//the dG derivative matrices repeat the same few n*n blocks over all rows, so
+//each thread block loads them once instead of streaming them for every row
+template<class value_type, size_t n, size_t blocks_per_line>
+ __global__ void ell_multiply_kernel_cached(value_type alpha, value_type beta,
+         const value_type* __restrict__  data,
+         const int* __restrict__  cols_idx, const int* __restrict__  data_idx,
+         const int num_rows, const int num_cols, const int num_blocks,
+         const int size, const int right_size,
+         const int* __restrict__  right_range,
+         const value_type* __restrict__  x, value_type * __restrict__ y
+         )
+{
+    extern __shared__ char smem_[]; //declared char to allow both float and double
+    value_type* sdata = reinterpret_cast<value_type*>( smem_);
+    for( int t = threadIdx.x; t < num_blocks*(int)(n*n); t += blockDim.x)
+        sdata[t] = data[t];
+    __syncthreads();
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const int right_ = right_range[1]-right_range[0];
+    //every thread takes num_rows/grid_size rows
+    for( int row = thread_id; row<size; row += grid_size)
+    {
+        value_type temp[blocks_per_line]={0};
+        int rr = row/right_size;
+        int rrn = rr/n, k = rr%n;
+        int s=rrn/num_rows, i = (rrn)%num_rows;
+        int j=right_range[0]+row%right_;
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+            for( int q=0; q<n; q++) //multiplication-loop
+                temp[d] = fma( sdata[ B+q], x[(J+q)*right_size+j], temp[d]);
+        }
+        int idx = ((s*num_rows+i)*n+k)*right_size+j;
+        //idx != row ( if right_range[0] != 0)
+        // if y[I] isnan then even beta = 0 does not make it 0
+        y[idx] = beta == 0 ? (value_type)0 : y[idx]*beta;
+        for( int d=0; d<blocks_per_line; d++)
+            y[idx] = fma( alpha, temp[d], y[idx]);
+    }
+}
+
+template<class value_type, size_t n>
+bool call_ell_multiply_kernel_cached( value_type alpha, value_type beta,
+         const value_type * __restrict__ data_ptr,
+         const int * __restrict__ cols_ptr, const int * __restrict__ block_ptr,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * __restrict__ right_range_ptr, const int num_blocks,
+         const value_type * __restrict__ x_ptr, value_type * __restrict__ y_ptr)
+{
+    //stage only if the blocks fit comfortably (keeps occupancy up)
+    const size_t smem = num_blocks*n*n*sizeof(value_type);
+    if( smem > 8*1024)
+        return false;
+    //set up kernel parameters
+    const size_t BLOCK_SIZE = 256;
+    const size_t size = left_size*right_size*num_rows*n; //number of lines
+    const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+    if( blocks_per_line == 1)
+        ell_multiply_kernel_cached<value_type, n, 1><<<NUM_BLOCKS, BLOCK_SIZE, smem>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        num_blocks, size, right_size, right_range_ptr,  x_ptr,y_ptr);
+    else if (blocks_per_line == 2)
+        ell_multiply_kernel_cached<value_type, n, 2><<<NUM_BLOCKS, BLOCK_SIZE, smem>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        num_blocks, size, right_size, right_range_ptr,  x_ptr,y_ptr);
+    else if (blocks_per_line == 3)
+        ell_multiply_kernel_cached<value_type, n, 3><<<NUM_BLOCKS, BLOCK_SIZE, smem>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        num_blocks, size, right_size, right_range_ptr,  x_ptr,y_ptr);
+    else if (blocks_per_line == 4)
+        ell_multiply_kernel_cached<value_type, n, 4><<<NUM_BLOCKS, BLOCK_SIZE, smem>>>
+        (alpha, beta, data_ptr, cols_ptr, block_ptr, num_rows, num_cols,
+        num_blocks, size, right_size, right_range_ptr,  x_ptr,y_ptr);
+    else //fall back to the default kernel
+        return false;
+    return true;
+}
+
+template<class value_type, size_t n>
+void call_ell_multiply_kernel( value_type alpha, value_type beta,
+         const value_type * __restrict__ data_ptr,
+         const int * __restrict__ cols_ptr, const int * __restrict__ block_ptr,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * __restrict__ right_range_ptr,
+         const value_type * __restrict__ x_ptr, value_type * __restrict__ y_ptr,
+         const size_t BLOCK_SIZE = 0);
+
+//benchmark a small set of block sizes on a scratch output and cache the
+//fastest per matrix shape (one-time cost on the first symv with that shape)
+template<class value_type, size_t n>
+size_t tune_ell_multiply_kernel(
+         const value_type * __restrict__ data_ptr,
+         const int * __restrict__ cols_ptr, const int * __restrict__ block_ptr,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * __restrict__ right_range_ptr,
+         const value_type * __restrict__ x_ptr)
+{
+    detail::EllKernelShape shape{ (int)n, blocks_per_line, num_rows, left_size, right_size};
+    auto& cache = detail::ell_kernel_tuning_cache();
+    auto it = cache.find( shape);
+    if( it != cache.end())
+        return it->second;
+#if defined(CUDA_API_PER_THREAD_DEFAULT_STREAM)
+    //cannot benchmark while a stream capture is active (dg::GraphCache)
+    cudaStreamCaptureStatus status = cudaStreamCaptureStatusNone;
+    cudaStreamIsCapturing( cudaStreamPerThread, &status);
+    if( status != cudaStreamCaptureStatusNone)
+        return 256;
+#endif
+    //benchmark on a scratch output so that the beta accumulation in y is
+    //not corrupted by the repeated launches
+    thrust::device_vector<value_type> scratch( (size_t)left_size*right_size*num_rows*n);
+    value_type* s_ptr = thrust::raw_pointer_cast( scratch.data());
+    cudaEvent_t start, stop;
+    cudaEventCreate( &start), cudaEventCreate( &stop);
+    size_t best_size = 256;
+    float best_time = -1;
+    for( size_t block_size : {128, 256, 512, 1024})
+    {
+        //one warm up launch, then time 3 repetitions
+        call_ell_multiply_kernel<value_type, n>( (value_type)1, (value_type)0,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            left_size, right_size, right_range_ptr, x_ptr, s_ptr, block_size);
+        cudaEventRecord( start);
+        for( int r=0; r<3; r++)
+            call_ell_multiply_kernel<value_type, n>( (value_type)1, (value_type)0,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, right_size, right_range_ptr, x_ptr, s_ptr, block_size);
+        cudaEventRecord( stop);
+        cudaEventSynchronize( stop);
+        float time = 0;
+        cudaEventElapsedTime( &time, start, stop);
+        if( best_time < 0 || time < best_time)
+            best_time = time, best_size = block_size;
+    }
+    cudaEventDestroy( start), cudaEventDestroy( stop);
+    cache[shape] = best_size;
+    return best_size;
+}
+
+template<class value_type, size_t n>
+void call_ell_multiply_kernel( value_type alpha, value_type beta,
+         const value_type * __restrict__ data_ptr,
+         const int * __restrict__ cols_ptr, const int * __restrict__ block_ptr,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * __restrict__ right_range_ptr,
+         const value_type * __restrict__ x_ptr, value_type * __restrict__ y_ptr,
+         const size_t BLOCK_SIZE)
+{
+    if( BLOCK_SIZE == 0) //look up (or measure) the fastest block size
+    {
+        call_ell_multiply_kernel<value_type, n>( alpha, beta, data_ptr,
+            cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+            left_size, right_size, right_range_ptr, x_ptr, y_ptr,
+            tune_ell_multiply_kernel<value_type, n>( data_ptr, cols_ptr,
+                block_ptr, num_rows, num_cols, blocks_per_line, left_size,
+                right_size, right_range_ptr, x_ptr));
+        return;
+    }
+    //set up kernel parameters
     const size_t size = left_size*right_size*num_rows*n; //number of lines
     const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
     //note that the following use size instead of left_size
@@ -182,6 +618,73 @@ void call_ell_multiply_kernel( value_type alpha, value_type beta,
 }
 
 
+namespace detail
+{
+//the few interior coefficients of a fixed plane stencil travel to the
+//kernel by value so the threads load no block or column indices at all
+template<class value_type, int blocks_per_line>
+struct PlaneStencil
+{
+    value_type c[blocks_per_line];
+    int off[blocks_per_line];
+};
+}//namespace detail
+
+//kernel for a fixed plane stencil (n==1, left_size==1), e.g. the
+//z-derivatives of a Grid3d: interior rows apply the by-value coefficients
+//to contiguous planes, only the (two) boundary rows go through the index
+//arrays
+template<class value_type, int blocks_per_line>
+ __global__ void ell_plane_stencil_kernel( value_type alpha, value_type beta,
+         const value_type* __restrict__  data,
+         const int* __restrict__  cols_idx, const int* __restrict__  data_idx,
+         const int num_rows, const int right_size,
+         const detail::PlaneStencil<value_type, blocks_per_line> st,
+         const value_type* __restrict__  x, value_type * __restrict__ y
+         )
+{
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const int size = num_rows*right_size;
+    for( int row = thread_id; row<size; row += grid_size)
+    {
+        int i = row/right_size, j = row%right_size;
+        value_type temp = 0;
+        if( i > 0 && i < num_rows-1)
+        {
+            for( int d=0; d<blocks_per_line; d++)
+                temp = fma( st.c[d], x[(i+st.off[d])*right_size+j], temp);
+        }
+        else
+        {
+            for( int d=0; d<blocks_per_line; d++)
+                temp = fma( data[ data_idx[i*blocks_per_line+d]],
+                    x[ cols_idx[i*blocks_per_line+d]*right_size+j], temp);
+        }
+        // if y[row] is nan then even beta = 0 does not make it 0
+        y[row] = beta == 0 ? alpha*temp : fma( alpha, temp, y[row]*beta);
+    }
+}
+template<class value_type, int blocks_per_line>
+void call_ell_plane_stencil_kernel( value_type alpha, value_type beta,
+         const value_type* data, const int* cols_idx, const int* data_idx,
+         const int num_rows, const int right_size,
+         const thrust::host_vector<value_type>& vals,
+         const thrust::host_vector<int>& offs,
+         const value_type* x, value_type* y
+         )
+{
+    detail::PlaneStencil<value_type, blocks_per_line> st;
+    for( int d=0; d<blocks_per_line; d++)
+        st.c[d] = vals[d], st.off[d] = offs[d];
+    const size_t BLOCK_SIZE = 256;
+    const size_t size = (size_t)num_rows*right_size;
+    const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+    ell_plane_stencil_kernel<value_type, blocks_per_line><<<NUM_BLOCKS,
+        BLOCK_SIZE>>>( alpha, beta, data, cols_idx, data_idx, num_rows,
+        right_size, st, x, y);
+}
+
 template<class value_type>
 void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alpha, const value_type* x_ptr, value_type beta, value_type* y_ptr) const
 {
@@ -189,6 +692,92 @@ void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
     const int* cols_ptr = thrust::raw_pointer_cast( &cols_idx[0]);
     const int* block_ptr = thrust::raw_pointer_cast( &data_idx[0]);
     const int* right_range_ptr = thrust::raw_pointer_cast( &right_range[0]);
+    if( plane_stencil)
+    {
+        //fixed plane stencil (e.g. the z-derivative): no per-block index
+        //loads except in the two boundary rows
+        if( blocks_per_line == 1)
+        {
+            call_ell_plane_stencil_kernel<value_type, 1>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, right_size,
+                stencil_vals, stencil_offs, x_ptr, y_ptr);
+            return;
+        }
+        else if( blocks_per_line == 2)
+        {
+            call_ell_plane_stencil_kernel<value_type, 2>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, right_size,
+                stencil_vals, stencil_offs, x_ptr, y_ptr);
+            return;
+        }
+        else if( blocks_per_line == 3)
+        {
+            call_ell_plane_stencil_kernel<value_type, 3>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, right_size,
+                stencil_vals, stencil_offs, x_ptr, y_ptr);
+            return;
+        }
+    }
+    if( sliced_layout && right_size == 1)
+    {
+        const value_type* sdata_ptr = thrust::raw_pointer_cast( &data_sliced[0]);
+        const int* scols_ptr = thrust::raw_pointer_cast( &cols_sliced[0]);
+        bool launched = false;
+        if( n == 1)
+            launched = call_ell_multiply_kernel_sliced<value_type, 1>( alpha, beta,
+                sdata_ptr, scols_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, x_ptr, y_ptr);
+        else if( n == 2)
+            launched = call_ell_multiply_kernel_sliced<value_type, 2>( alpha, beta,
+                sdata_ptr, scols_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, x_ptr, y_ptr);
+        else if( n == 3)
+            launched = call_ell_multiply_kernel_sliced<value_type, 3>( alpha, beta,
+                sdata_ptr, scols_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, x_ptr, y_ptr);
+        else if( n == 4)
+            launched = call_ell_multiply_kernel_sliced<value_type, 4>( alpha, beta,
+                sdata_ptr, scols_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, x_ptr, y_ptr);
+        else if( n == 5)
+            launched = call_ell_multiply_kernel_sliced<value_type, 5>( alpha, beta,
+                sdata_ptr, scols_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, x_ptr, y_ptr);
+        else if( n == 6)
+            launched = call_ell_multiply_kernel_sliced<value_type, 6>( alpha, beta,
+                sdata_ptr, scols_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, x_ptr, y_ptr);
+        if( launched)
+            return;
+    }
+    {
+        //matrix-free fast path for the dG derivatives: their few distinct
+        //stencil blocks fit into shared memory
+        const int num_blocks = data.size()/(n*n);
+        bool launched = false;
+        if( n == 1)
+            launched = call_ell_multiply_kernel_cached<value_type, 1>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, right_size, right_range_ptr, num_blocks, x_ptr, y_ptr);
+        else if( n == 2)
+            launched = call_ell_multiply_kernel_cached<value_type, 2>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, right_size, right_range_ptr, num_blocks, x_ptr, y_ptr);
+        else if( n == 3)
+            launched = call_ell_multiply_kernel_cached<value_type, 3>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, right_size, right_range_ptr, num_blocks, x_ptr, y_ptr);
+        else if( n == 4)
+            launched = call_ell_multiply_kernel_cached<value_type, 4>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, right_size, right_range_ptr, num_blocks, x_ptr, y_ptr);
+        else if( n == 5)
+            launched = call_ell_multiply_kernel_cached<value_type, 5>( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
+                left_size, right_size, right_range_ptr, num_blocks, x_ptr, y_ptr);
+        if( launched)
+            return;
+    }
     if( n == 1)
         call_ell_multiply_kernel<value_type, 1>  (alpha, beta,
             data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line,
@@ -226,71 +815,76 @@ void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
 }
 
 //////////////////// COO multiply kernel
+//one fused launch over all boundary points: the entries are sorted by row
+//and grouped in rows_ptr so that every output point belongs to exactly one
+//thread (writes stay conflict free and coalesced in j)
 template<class value_type>
  __global__ void coo_multiply_kernel(
          const value_type* __restrict__  data,
-         const int* __restrict__  rows_idx, const int* __restrict__  cols_idx,
+         const int* __restrict__  unique_rows, const int* __restrict__  rows_ptr,
+         const int* __restrict__  cols_idx,
          const int* __restrict__  data_idx,
-         const int num_rows, const int num_cols, const int num_entries,
+         const int num_rows, const int num_cols, const int num_unique,
          const int n,
          const int left, const int right,
          value_type alpha, const value_type**  x, value_type beta,
          value_type * __restrict__ y
          )
 {
-    int size = left*n*right;
+    int size = num_unique*left*n*right;
     const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
     const int grid_size = gridDim.x*blockDim.x;
-    //every thread takes num_rows/grid_size rows
     for( int idx = thread_id; idx<size; idx += grid_size)
     {
-        int s=idx/(n*right),
+        int u=idx/(left*n*right),
+            s=(idx/(n*right))%left,
             k=(idx/right)%n,
             j=idx%right;
-        for( int entry=0; entry<num_entries; entry++)
+        int I = ((s*num_rows+unique_rows[u])*n+k)*right+j;
+        value_type temp = 0;
+        for( int entry=rows_ptr[u]; entry<rows_ptr[u+1]; entry++)
         {
-            int I = ((s*num_rows+rows_idx[entry])*n+k)*right+j;
-            value_type temp = 0;
             int B = data_idx[entry];
             int J = cols_idx[entry];
             for( int q=0; q<n; q++) //multiplication-loop
                 temp = fma( data[ (B*n + k)*n+q],
                     x[J][(q*left +s )*right+j], temp);
-            y[I] = fma( alpha, temp, y[I]);
         }
+        y[I] = fma( alpha, temp, y[I]);
     }
 }
 template<class value_type, int n>
  __global__ void coo_multiply_kernel(
          const value_type* __restrict__  data,
-         const int* __restrict__  rows_idx, const int* __restrict__  cols_idx,
+         const int* __restrict__  unique_rows, const int* __restrict__  rows_ptr,
+         const int* __restrict__  cols_idx,
          const int* __restrict__  data_idx,
-         const int num_rows, const int num_cols, const int num_entries,
+         const int num_rows, const int num_cols, const int num_unique,
          const int left, const int right,
          value_type alpha, const value_type**  x, value_type beta,
          value_type * __restrict__ y
          )
 {
-    int size = left*n*right;
+    int size = num_unique*left*n*right;
     const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
     const int grid_size = gridDim.x*blockDim.x;
-    //every thread takes num_rows/grid_size rows
     for( int idx = thread_id; idx<size; idx += grid_size)
     {
-        int s=idx/(n*right),
+        int u=idx/(left*n*right),
+            s=(idx/(n*right))%left,
             k=(idx/right)%n,
             j=idx%right;
-        for( int entry=0; entry<num_entries; entry++)
+        int I = ((s*num_rows+unique_rows[u])*n+k)*right+j;
+        value_type temp = 0;
+        for( int entry=rows_ptr[u]; entry<rows_ptr[u+1]; entry++)
         {
-            int I = ((s*num_rows+rows_idx[entry])*n+k)*right+j;
-            value_type temp = 0;
             int B = data_idx[entry];
             int J = cols_idx[entry];
             for( int q=0; q<n; q++) //multiplication-loop
                 temp = fma( data[ (B*n + k)*n+q],
                     x[J][(q*left +s )*right+j], temp);
-            y[I] = fma( alpha, temp, y[I]);
         }
+        y[I] = fma( alpha, temp, y[I]);
     }
 }
 
@@ -299,33 +893,134 @@ void CooSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
 {
     //set up kernel parameters
     const size_t BLOCK_SIZE = 256;
-    const size_t size = left_size*right_size*n;
+    const size_t num_unique = unique_rows.size();
+    const size_t size = num_unique*left_size*right_size*n;
     const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
 
     const value_type* data_ptr = thrust::raw_pointer_cast( data.data());
-    const int* rows_ptr = thrust::raw_pointer_cast( rows_idx.data());
+    const int* urows_ptr = thrust::raw_pointer_cast( unique_rows.data());
+    const int* offset_ptr = thrust::raw_pointer_cast( rows_ptr.data());
     const int* cols_ptr = thrust::raw_pointer_cast( cols_idx.data());
     const int* block_ptr = thrust::raw_pointer_cast( data_idx.data());
     if( n == 1)
         coo_multiply_kernel<value_type, 1> <<<NUM_BLOCKS, BLOCK_SIZE>>> (
-            data_ptr, rows_ptr, cols_ptr, block_ptr, num_rows, num_cols,
-            num_entries, left_size, right_size, alpha, x_ptr, beta, y_ptr);
+            data_ptr, urows_ptr, offset_ptr, cols_ptr, block_ptr, num_rows,
+            num_cols, num_unique, left_size, right_size, alpha, x_ptr, beta, y_ptr);
     else if( n == 2)
         coo_multiply_kernel<value_type, 2> <<<NUM_BLOCKS, BLOCK_SIZE>>> (
-            data_ptr, rows_ptr, cols_ptr, block_ptr, num_rows, num_cols,
-            num_entries, left_size, right_size, alpha, x_ptr, beta, y_ptr);
+            data_ptr, urows_ptr, offset_ptr, cols_ptr, block_ptr, num_rows,
+            num_cols, num_unique, left_size, right_size, alpha, x_ptr, beta, y_ptr);
     else if( n == 3)
         coo_multiply_kernel<value_type, 3> <<<NUM_BLOCKS, BLOCK_SIZE>>> (
-            data_ptr, rows_ptr, cols_ptr, block_ptr, num_rows, num_cols,
-            num_entries, left_size, right_size, alpha, x_ptr, beta, y_ptr);
+            data_ptr, urows_ptr, offset_ptr, cols_ptr, block_ptr, num_rows,
+            num_cols, num_unique, left_size, right_size, alpha, x_ptr, beta, y_ptr);
     else if( n == 4)
         coo_multiply_kernel<value_type, 4> <<<NUM_BLOCKS, BLOCK_SIZE>>> (
-            data_ptr, rows_ptr, cols_ptr, block_ptr, num_rows, num_cols,
-            num_entries, left_size, right_size, alpha, x_ptr, beta, y_ptr);
+            data_ptr, urows_ptr, offset_ptr, cols_ptr, block_ptr, num_rows,
+            num_cols, num_unique, left_size, right_size, alpha, x_ptr, beta, y_ptr);
     else
         coo_multiply_kernel<value_type> <<<NUM_BLOCKS, BLOCK_SIZE>>> (
-            data_ptr, rows_ptr, cols_ptr, block_ptr, num_rows, num_cols,
-            num_entries, n, left_size, right_size, alpha, x_ptr, beta, y_ptr);
+            data_ptr, urows_ptr, offset_ptr, cols_ptr, block_ptr, num_rows,
+            num_cols, num_unique, n, left_size, right_size, alpha, x_ptr, beta, y_ptr);
+}
+
+//one thread per output row; the m*m block of a cell is read by its m threads
+template<class value_type>
+ __global__ void blockdiag_multiply_kernel( value_type alpha, value_type beta,
+         const value_type* data,
+         const int num_y, const int num_x,
+         const int ny, const int nx, const int left_size,
+         const value_type* x, value_type* y
+         )
+{
+    const int size = left_size*num_y*ny*num_x*nx;
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const int mm = ny*nx;
+    for( int I = thread_id; I<size; I += grid_size)
+    {
+        int kx = I%nx, j = (I/nx)%num_x, ky = (I/(nx*num_x))%ny;
+        int i = (I/(nx*num_x*ny))%num_y, s = I/(nx*num_x*ny*num_y);
+        const value_type* B = &data[ (((size_t)i*num_x+j)*mm + ky*nx+kx)*mm];
+        // if y[I] isnan then even beta = 0 does not make it 0
+        y[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+        value_type temp = 0;
+        for( int c=0; c<mm; c++) //multiplication-loop
+            temp = fma( B[c],
+                    x[(((s*num_y + i)*ny+c/nx)*num_x + j)*nx + c%nx],
+                    temp);
+        y[I] = fma( alpha, temp, y[I]);
+    }
+}
+
+template<class value_type>
+void BlockDiagMatDevice<value_type>::launch_multiply_kernel( value_type alpha, const value_type* x_ptr, value_type beta, value_type* y_ptr) const
+{
+    //set up kernel parameters
+    const size_t BLOCK_SIZE = 256;
+    const size_t size = total_num_rows();
+    const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+    const value_type* data_ptr = thrust::raw_pointer_cast( data.data());
+    blockdiag_multiply_kernel<value_type> <<<NUM_BLOCKS, BLOCK_SIZE>>> ( alpha,
+        beta, data_ptr, num_y, num_x, ny, nx, left_size, x_ptr, y_ptr);
+}
+
+#ifdef DG_USE_CUBLAS
+namespace detail
+{
+inline cublasHandle_t cublas_handle()
+{
+    static cublasHandle_t handle = []{
+        cublasHandle_t h;
+        cublasCreate( &h);
+        return h;
+    }();
+    return handle;
+}
+inline cublasStatus_t gemm_strided_batched( cublasHandle_t handle,
+    cublasOperation_t opA, cublasOperation_t opB, int m, int n, int k,
+    double alpha, const double* A, int lda, long long int strideA,
+    const double* B, int ldb, long long int strideB,
+    double beta, double* C, int ldc, long long int strideC, int batch)
+{
+    return cublasDgemmStridedBatched( handle, opA, opB, m, n, k, &alpha,
+        A, lda, strideA, B, ldb, strideB, &beta, C, ldc, strideC, batch);
+}
+inline cublasStatus_t gemm_strided_batched( cublasHandle_t handle,
+    cublasOperation_t opA, cublasOperation_t opB, int m, int n, int k,
+    float alpha, const float* A, int lda, long long int strideA,
+    const float* B, int ldb, long long int strideB,
+    float beta, float* C, int ldc, long long int strideC, int batch)
+{
+    return cublasSgemmStridedBatched( handle, opA, opB, m, n, k, &alpha,
+        A, lda, strideA, B, ldb, strideB, &beta, C, ldc, strideC, batch);
+}
+}//namespace detail
+
+//The per-cell transform stage of a block diagonal matrix is exactly a
+//batched small GEMM; our row-major n x n block read column-major is the
+//transposed block, which fixes the transpose parameters below
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_block_diag_gemm( value_type alpha, const value_type* x_ptr, value_type beta, value_type* y_ptr) const
+{
+    const value_type* block = thrust::raw_pointer_cast( &data[0]);
+    cublasHandle_t handle = detail::cublas_handle();
+    cublasStatus_t status;
+    int batch = left_size*num_rows;
+    if( right_size == 1)
+        //cells are contiguous: a single GEMM Y = B X with X = ( n x batch)
+        status = detail::gemm_strided_batched( handle, CUBLAS_OP_T,
+            CUBLAS_OP_N, n, batch, n, alpha, block, n, 0, x_ptr, n, 0,
+            beta, y_ptr, n, 0, 1);
+    else
+        //one ( right_size x n) slab per cell: Y_c = X_c B^T batched over cells
+        status = detail::gemm_strided_batched( handle, CUBLAS_OP_N,
+            CUBLAS_OP_N, right_size, n, n, alpha, x_ptr, right_size,
+            (long long int)n*right_size, block, n, 0, beta, y_ptr,
+            right_size, (long long int)n*right_size, batch);
+    if( status != CUBLAS_STATUS_SUCCESS)
+        throw dg::Error( dg::Message(_ping_)<<"cuBLAS batched GEMM failed with status "<<(int)status);
 }
+#endif //DG_USE_CUBLAS
 
 }//namespace dg
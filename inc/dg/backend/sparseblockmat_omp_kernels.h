@@ -1,10 +1,102 @@
 #include <omp.h>
 #include "config.h"
+#include "exblas/config.h" //vcl (or _WITHOUT_VCL on non-x86)
+#ifdef DG_USE_MKL
+#include <mkl.h>
+#endif //DG_USE_MKL
 
 //for the fmas it is important to activate -mfma compiler flag
 
 namespace dg{
 
+#ifndef _WITHOUT_VCL
+/* Explicitly vectorized micro-kernel for the right_size==1 case with trivial
+ * (row-independent) data blocks, i.e. the interior of the 2d derivative and
+ * jump matrices, where compiler auto-vectorization of the n=2..5 block
+ * multiplications typically stays far below peak. The n outputs of a cell are
+ * kept column-major in one SIMD register and built up with one broadcast-FMA
+ * per input value, so a cell costs blocks_per_line*n vector FMAs instead of
+ * blocks_per_line*n*n dependent scalar ones. As in exblas the instruction set
+ * is selected at compile time through vcl (AVX2 compiles Vec8d to two 256 bit
+ * halves, AVX512 to one register); on non-x86 architectures _WITHOUT_VCL
+ * falls back to the auto-vectorized loops below.
+ * Returns false for value types other than double, in which case the caller
+ * runs the scalar loops. Must be called by all threads of the parallel region.
+ */
+template<int n, int blocks_per_line>
+inline bool ell_multiply_trivial_vcl( double alpha, double beta,
+         const double * RESTRICT data, const int * RESTRICT cols_idx,
+         const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols, const int left_size,
+         const double * RESTRICT x, double * RESTRICT y)
+{
+    // transpose the constant interior blocks once: ct[d*n+q] holds in lane k
+    // the element data[(B_d*n+k)*n+q], i.e. column q of block d
+    vcl::Vec8d ct[blocks_per_line*n];
+    double tmp[8] = {0,0,0,0,0,0,0,0};
+    for( int d=0; d<blocks_per_line; d++)
+        for( int q=0; q<n; q++)
+        {
+            int B = data_idx[blocks_per_line+d];
+            for( int k=0; k<n; k++)
+                tmp[k] = data[(B*n+k)*n+q];
+            ct[d*n+q].load( tmp);
+        }
+    #pragma omp for nowait
+    for( int s=0; s<left_size; s++)
+    {
+        //the first and last row own their blocks: scalar
+        for( int i=0; i<num_rows; i+=(num_rows>1 ? num_rows-1 : 1))
+        {
+            for( int k=0; k<n; k++)
+            {
+                double temp = 0;
+                for( int d=0; d<blocks_per_line; d++)
+                {
+                    int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+                    int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+                    for( int q=0; q<n; q++) //multiplication-loop
+                        temp = DG_FMA( data[B+q], x[J+q], temp);
+                }
+                int I = ((s*num_rows + i)*n+k);
+                // if y[I] isnan then even beta = 0 does not make it 0
+                y[I] = beta == 0 ? 0. : y[I]*beta;
+                y[I] = DG_FMA( alpha, temp, y[I]);
+            }
+        }
+        for( int i=1; i<num_rows-1; i++)
+        {
+            vcl::Vec8d acc(0.);
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                const int J = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+                for( int q=0; q<n; q++)
+                    acc = vcl::mul_add( ct[d*n+q], vcl::Vec8d( x[J+q]), acc);
+            }
+            const int I = (s*num_rows + i)*n;
+            vcl::Vec8d yv(0.);
+            if( beta != 0)
+            {
+                yv.load_partial( n, y+I);
+                yv *= beta;
+            }
+            yv = vcl::mul_add( vcl::Vec8d( alpha), acc, yv);
+            yv.store_partial( n, y+I);
+        }
+    }
+    return true;
+}
+//fallback for float (Vec8d holds doubles): the caller runs the scalar loops
+template<int n, int blocks_per_line, class value_type>
+inline bool ell_multiply_trivial_vcl( value_type, value_type,
+         const value_type*, const int*, const int*,
+         const int, const int, const int,
+         const value_type*, value_type*)
+{
+    return false;
+}
+#endif //_WITHOUT_VCL
+
 // general multiply kernel
 template<class value_type>
 void ell_multiply_kernel( value_type alpha, value_type beta,
@@ -56,6 +148,58 @@ void ell_multiply_kernel( value_type alpha, value_type beta,
         }
     }
 }
+// general fused multiply+axpby kernel: z = alpha M x + beta y
+template<class value_type>
+void ell_multiply_axpby_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data, const int * RESTRICT cols_idx,
+         const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int n,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range,
+         const value_type * RESTRICT x, const value_type * RESTRICT y,
+         value_type * RESTRICT z
+         )
+{
+#pragma omp for nowait //manual collapse(2)
+	for( int si = 0; si<left_size*num_rows; si++)
+	{
+		int s = si / num_rows;
+		int i = si % num_rows;
+#ifdef _MSC_VER //MSVC does not support variable lenght arrays...
+		int* J = (int*)alloca(blocks_per_line * sizeof(int));
+#else
+        int J[blocks_per_line];
+#endif
+        for( int d=0; d<blocks_per_line; d++)
+            J[d] = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+        for( int k=0; k<n; k++)
+        {
+#ifdef _MSC_VER
+			int* B = (int*)alloca(blocks_per_line * sizeof(int));
+#else
+            int B[blocks_per_line];
+#endif
+            for( int d=0; d<blocks_per_line; d++)
+                B[d] = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            for( int j=right_range[0]; j<right_range[1]; j++)
+            {
+                int I = ((s*num_rows + i)*n+k)*right_size+j;
+                // if y[I] isnan then even beta = 0 does not make it 0
+                z[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+                for( int d=0; d<blocks_per_line; d++)
+                {
+                    value_type temp = 0;
+                    for( int q=0; q<n; q++) //multiplication-loop
+                        temp = DG_FMA(data[ B[d]+q],
+                                x[(J[d]+q)*right_size+j],
+                                temp);
+                    z[I] = DG_FMA(alpha, temp, z[I]);
+                }
+            }
+        }
+    }
+}
 //specialized multiply kernel
 template<class value_type, int n, int blocks_per_line>
 void ell_multiply_kernel( value_type alpha, value_type beta,
@@ -80,6 +224,13 @@ void ell_multiply_kernel( value_type alpha, value_type beta,
         }
     if(trivial)
     {
+#ifndef _WITHOUT_VCL
+    if( ell_multiply_trivial_vcl<n, blocks_per_line>( alpha, beta, data,
+            cols_idx, data_idx, num_rows, num_cols, left_size, x, y))
+    {} //the explicitly vectorized kernel (double only) did the work
+    else
+#endif //_WITHOUT_VCL
+    {
     value_type xprivate[blocks_per_line*n];
     value_type dprivate[blocks_per_line*n*n];
     for( int d=0; d<blocks_per_line; d++)
@@ -164,6 +315,7 @@ void ell_multiply_kernel( value_type alpha, value_type beta,
             }
         }
     }
+    } //scalar fallback
     } //trivial
     else // not trivial
     {
@@ -341,78 +493,75 @@ void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
         right_size, right_range_ptr,  x_ptr,y_ptr);
 }
 
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_multiply_axpby_kernel( value_type alpha, const value_type* x_ptr, value_type beta, const value_type* y_ptr, value_type* z_ptr) const
+{
+    const value_type* data_ptr = thrust::raw_pointer_cast( &data[0]);
+    const int* cols_ptr = thrust::raw_pointer_cast( &cols_idx[0]);
+    const int* block_ptr = thrust::raw_pointer_cast( &data_idx[0]);
+    const int* right_range_ptr = thrust::raw_pointer_cast( &right_range[0]);
+    //the fused kernel is memory bound, the general version suffices
+    ell_multiply_axpby_kernel<value_type> ( alpha, beta, data_ptr, cols_ptr,
+        block_ptr, num_rows, num_cols, blocks_per_line, n, left_size,
+        right_size, right_range_ptr,  x_ptr, y_ptr, z_ptr);
+}
+
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_affine_kernel( value_type alpha, value_type* y_ptr) const
+{
+    //scatter the sparse affine correction (inhomogeneous boundary conditions)
+    //serially; it touches only boundary points
+    const int* idx_ptr = thrust::raw_pointer_cast( &affine_idx[0]);
+    const value_type* vals_ptr = thrust::raw_pointer_cast( &affine_vals[0]);
+    for( unsigned u=0; u<affine_idx.size(); u++)
+        y_ptr[idx_ptr[u]] = DG_FMA( alpha, vals_ptr[u], y_ptr[idx_ptr[u]]);
+}
+
+//one fused parallel loop over all boundary points: the entries are sorted
+//by row and grouped in rows_ptr in the device constructor so that every
+//output point is written by exactly one thread
 template<class value_type>
 void coo_multiply_kernel( value_type alpha, const value_type** x, value_type beta, value_type* RESTRICT y, const CooSparseBlockMatDevice<value_type>& m )
 {
+    const int num_unique = m.unique_rows.size();
     #pragma omp for nowait
-	for (int skj = 0; skj < m.left_size*m.n*m.right_size; skj++)
+	for (int idx = 0; idx < num_unique*m.left_size*m.n*m.right_size; idx++)
 	{
-		int s = skj / (m.n*m.right_size);
-		int k = (skj % (m.n*m.right_size)) / m.right_size;
-		int j = (skj % (m.n*m.right_size)) % m.right_size;
-		for (int i = 0; i < m.num_entries; i++)
-		{
-			int I = ((s*m.num_rows + m.rows_idx[i])*m.n + k)*m.right_size + j;
-			value_type temp = 0;
+		int u = idx / (m.left_size*m.n*m.right_size);
+		int s = (idx / (m.n*m.right_size)) % m.left_size;
+		int k = (idx / m.right_size) % m.n;
+		int j = idx % m.right_size;
+		int I = ((s*m.num_rows + m.unique_rows[u])*m.n + k)*m.right_size + j;
+		value_type temp = 0;
+		for (int i = m.rows_ptr[u]; i < m.rows_ptr[u+1]; i++)
 			for (int q = 0; q < m.n; q++) //multiplication-loop
 				temp = DG_FMA(m.data[(m.data_idx[i] * m.n + k)*m.n + q],
                     x[m.cols_idx[i]][(q*m.left_size +s )*m.right_size+j],
 					temp);
-			y[I] = DG_FMA(alpha, temp, y[I]);
-		}
+		y[I] = DG_FMA(alpha, temp, y[I]);
 	}
 }
 template<class value_type, int n>
 void coo_multiply_kernel( value_type alpha, const value_type** x, value_type beta, value_type* RESTRICT y, const CooSparseBlockMatDevice<value_type>& m )
 {
-    bool trivial = true;
-    int CC = m.cols_idx[0], DD = m.data_idx[0];
-    for( int i=0; i<m.num_entries; i++)
-        if( CC+i != m.cols_idx[i] || DD+i != m.data_idx[i])
-            trivial=false;
-    if( trivial)
-    {
-        #pragma omp for SIMD nowait
-        for (int sj = 0; sj < m.left_size*m.right_size; sj++)
-        {
-            int s = sj / m.right_size;
-            int j = (sj % m.right_size) % m.right_size;
-            for( int k=0; k<n; k++)
-            {
-            for (int i = 0; i < m.num_entries; i++)
-            {
-                int I = ((s*m.num_rows + m.rows_idx[i])*n + k)*m.right_size + j;
-                int DDD = ((DD +i)*n+k)*n, CCC = CC+i;
-                value_type temp = 0;
-                for (int q = 0; q < n; q++) //multiplication-loop
-                    temp = DG_FMA(m.data[DDD + q],
-                        x[CCC][q*m.left_size*m.right_size +sj],
-                        temp);
-                y[I] = DG_FMA(alpha, temp, y[I]);
-            }
-            }
-        }
-    }
-    else
+    const int num_unique = m.unique_rows.size();
+    #pragma omp for SIMD nowait
+    for (int usj = 0; usj < num_unique*m.left_size*m.right_size; usj++)
     {
-        #pragma omp for SIMD nowait
-        for (int sj = 0; sj < m.left_size*m.right_size; sj++)
+        int u = usj / (m.left_size*m.right_size);
+        int sj = usj % (m.left_size*m.right_size);
+        int s = sj / m.right_size;
+        int j = sj % m.right_size;
+        for( int k=0; k<n; k++)
         {
-            int s = sj / m.right_size;
-            int j = (sj % m.right_size) % m.right_size;
-            for( int k=0; k<n; k++)
-            {
-            for (int i = 0; i < m.num_entries; i++)
-            {
-                int I = ((s*m.num_rows + m.rows_idx[i])*n + k)*m.right_size + j;
-                value_type temp = 0;
+            int I = ((s*m.num_rows + m.unique_rows[u])*n + k)*m.right_size + j;
+            value_type temp = 0;
+            for (int i = m.rows_ptr[u]; i < m.rows_ptr[u+1]; i++)
                 for (int q = 0; q < n; q++) //multiplication-loop
                     temp = DG_FMA(m.data[(m.data_idx[i] * n + k)*n + q],
                         x[m.cols_idx[i]][q*m.left_size*m.right_size +sj],
                         temp);
-                y[I] = DG_FMA(alpha, temp, y[I]);
-            }
-            }
+            y[I] = DG_FMA(alpha, temp, y[I]);
         }
     }
 }
@@ -431,4 +580,68 @@ void CooSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
         coo_multiply_kernel<value_type>( alpha, x, beta, y, *this);
 }
 
+template<class value_type>
+void BlockDiagMatDevice<value_type>::launch_multiply_kernel( value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const
+{
+    const value_type* RESTRICT data_ptr = thrust::raw_pointer_cast( data.data());
+    const int mm = ny*nx;
+    #pragma omp for nowait
+    for( int I = 0; I < left_size*num_y*ny*num_x*nx; I++)
+    {
+        int kx = I%nx, j = (I/nx)%num_x, ky = (I/(nx*num_x))%ny;
+        int i = (I/(nx*num_x*ny))%num_y, s = I/(nx*num_x*ny*num_y);
+        const value_type* RESTRICT B = &data_ptr[ (((size_t)i*num_x+j)*mm + ky*nx+kx)*mm];
+        // if y[I] isnan then even beta = 0 does not make it 0
+        y[I] = beta == 0 ? (value_type)0 : y[I]*beta;
+        value_type temp = 0;
+        for( int c=0; c<mm; c++) //multiplication-loop
+            temp = DG_FMA( B[c],
+                    x[(((s*num_y + i)*ny+c/nx)*num_x + j)*nx + c%nx],
+                    temp);
+        y[I] = DG_FMA( alpha, temp, y[I]);
+    }
+}
+
+#ifdef DG_USE_MKL
+namespace detail
+{
+inline void gemm_batch_strided( CBLAS_TRANSPOSE opA, CBLAS_TRANSPOSE opB,
+    int m, int n, int k, double alpha, const double* A, int lda,
+    long long int strideA, const double* B, int ldb, long long int strideB,
+    double beta, double* C, int ldc, long long int strideC, int batch)
+{
+    cblas_dgemm_batch_strided( CblasColMajor, opA, opB, m, n, k, alpha,
+        A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batch);
+}
+inline void gemm_batch_strided( CBLAS_TRANSPOSE opA, CBLAS_TRANSPOSE opB,
+    int m, int n, int k, float alpha, const float* A, int lda,
+    long long int strideA, const float* B, int ldb, long long int strideB,
+    float beta, float* C, int ldc, long long int strideC, int batch)
+{
+    cblas_sgemm_batch_strided( CblasColMajor, opA, opB, m, n, k, alpha,
+        A, lda, strideA, B, ldb, strideB, beta, C, ldc, strideC, batch);
+}
+}//namespace detail
+
+//The per-cell transform stage of a block diagonal matrix is exactly a
+//batched small GEMM; our row-major n x n block read column-major is the
+//transposed block, which fixes the transpose parameters below
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_block_diag_gemm( value_type alpha, const value_type* x_ptr, value_type beta, value_type* y_ptr) const
+{
+    const value_type* block = thrust::raw_pointer_cast( &data[0]);
+    int batch = left_size*num_rows;
+    if( right_size == 1)
+        //cells are contiguous: a single GEMM Y = B X with X = ( n x batch)
+        detail::gemm_batch_strided( CblasTrans, CblasNoTrans, n, batch, n,
+            alpha, block, n, 0, x_ptr, n, 0, beta, y_ptr, n, 0, 1);
+    else
+        //one ( right_size x n) slab per cell: Y_c = X_c B^T batched over cells
+        detail::gemm_batch_strided( CblasNoTrans, CblasNoTrans, right_size,
+            n, n, alpha, x_ptr, right_size, (long long int)n*right_size,
+            block, n, 0, beta, y_ptr, right_size,
+            (long long int)n*right_size, batch);
+}
+#endif //DG_USE_MKL
+
 }//namespace dg
@@ -2,6 +2,9 @@
 
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+#include <thrust/system/cuda/experimental/pinned_allocator.h>
+#endif
 #include "vector_categories.h"
 #include "tensor_traits.h"
 
@@ -29,6 +32,35 @@ struct TensorTraits<thrust::host_vector<T>> //, std::enable_if_t< std::is_arithm
 //    using execution_policy  = get_execution_policy<T>;
 //};
 
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+/**
+ * @brief A host vector in page-locked (pinned) memory
+ *
+ * Transfers between pinned memory and the device run at full PCIe speed
+ * and \c cudaMemcpyAsync can truly overlap them with computation, while
+ * pageable \c thrust::host_vector memory is staged through an internal
+ * bounce buffer first. Use this type for host vectors whose main purpose
+ * is to exchange data with the device (file I/O staging, MPI bounce
+ * buffers); behaves like \c thrust::host_vector everywhere else.
+ * @note on non-CUDA builds this is an alias of \c thrust::host_vector
+ */
+template<class T>
+using PinnedVec_t = thrust::host_vector<T,
+    thrust::cuda::experimental::pinned_allocator<T>>;
+///@brief prototypical Shared Vector with Serial Tag (pinned memory)
+template<class T>
+struct TensorTraits<thrust::host_vector<T,
+    thrust::cuda::experimental::pinned_allocator<T>>>
+{
+    using value_type        = T;
+    using tensor_category   = ThrustVectorTag;
+    using execution_policy  = SerialTag;
+};
+#else
+template<class T>
+using PinnedVec_t = thrust::host_vector<T>;
+#endif
+
 ///@brief prototypical Shared Vector with Cuda or Omp Tag
 template<class T>
 struct TensorTraits<thrust::device_vector<T> >
@@ -15,8 +15,12 @@ namespace detail
 template <class Matrix>
 Matrix doTranspose( const Matrix& src, CuspMatrixTag)
 {
-    Matrix out;
-    cusp::transpose( src, out);
+    //convert to csr first because e.g. the ell format cannot be transposed directly
+    cusp::csr_matrix<typename std::decay_t<Matrix>::index_type,
+        typename std::decay_t<Matrix>::value_type,
+        typename std::decay_t<Matrix>::memory_space> csr( src), csrT;
+    cusp::transpose( csr, csrT);
+    Matrix out = csrT;
     return out;
 }
 #ifdef MPI_VERSION
@@ -47,7 +51,6 @@ MPIDistMat<LocalMatrix, Collective> doTranspose( const MPIDistMat<LocalMatrix, C
 template<class Matrix>
 Matrix transpose( const Matrix& src)
 {
-    //%Transposed matrices work only for csr_matrix due to bad matrix form for ell_matrix!!!
     return detail::doTranspose( src, get_tensor_category<Matrix>());
 }
 
@@ -2,8 +2,10 @@
 #define _DG_TYPEDEFS_CUH_
 #include <thrust/host_vector.h>
 #include <thrust/device_vector.h>
+#include "tensor_traits_thrust.h"
 #include "sparseblockmat.h"
 #include "sparseblockmat.cuh"
+#include "vendor_matrix.h"
 
 /*! @file
   @brief Useful typedefs of commonly used types.
@@ -19,6 +21,8 @@ using HVec_t  = thrust::host_vector<T>; //!< Host Vector
 using HVec  = thrust::host_vector<double>; //!< Host Vector
 using iHVec = thrust::host_vector<int>; //!< integer Host Vector
 using fHVec = thrust::host_vector<float>; //!< Host Vector
+using PinnedVec = PinnedVec_t<double>; //!< Host Vector in page-locked memory for fast asynchronous host-device transfers (an alias of dg::HVec unless compiled for a gpu); see \c dg::PinnedVec_t
+using fPinnedVec = PinnedVec_t<float>; //!< Host Vector in page-locked memory for fast asynchronous host-device transfers (an alias of dg::fHVec unless compiled for a gpu); see \c dg::PinnedVec_t
 
 using DVec  = thrust::device_vector<double>; //!< Device Vector. The device can be an OpenMP parallelized cpu or a gpu. This depends on the value of the macro THRUST_DEVICE_SYSTEM, which can be either THRUST_DEVICE_SYSTEM_OMP for openMP or THRUST_DEVICE_SYSTEM_CUDA for a gpu or THRUST_DEVICE_SYSTEM_CPP for a cpu.
 using iDVec = thrust::device_vector<int>; //!< integer Device Vector
@@ -46,6 +50,22 @@ using IDMatrix_t = cusp::csr_matrix<int, real_type, cusp::device_memory>;
 #endif
 using IHMatrix = IHMatrix_t<double>;
 using IDMatrix = IDMatrix_t<double>;
+template<class real_type>
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+//For the application of quasi-banded interpolation matrices (e.g. in Fieldaligned)
+//the ell format is several times faster than csr on GPUs; the coo overflow part
+//of the hyb format catches outlier rows that do not fit in ell
+using IEllMatrix_t = cusp::hyb_matrix<int, real_type, cusp::device_memory>;
+#else
+// csr matrix can be much faster than ell for CPU (we have our own symv implementation!)
+using IEllMatrix_t = cusp::csr_matrix<int, real_type, cusp::device_memory>;
+#endif
+using IEllMatrix = IEllMatrix_t<double>; //!< Device Matrix for the application of interpolation matrices
+
+// Interpolation matrices applied through a vendor sparse library (see dg::VendorMatrix)
+template<class real_type>
+using IVendorMatrix_t = dg::VendorMatrix<thrust::device_vector<real_type>>;
+using IVendorMatrix = IVendorMatrix_t<double>; //!< Device Matrix applied through a vendor sparse library if one is enabled (else falls back to cusp)
 
 ///@}
 }//namespace dg
@@ -95,6 +115,9 @@ template<class real_type>
 using MIDMatrix_t = MPIDistMat< IDMatrix_t<real_type>, GeneralComm< dg::iDVec, thrust::device_vector<real_type>> >;
 using MIHMatrix = MIHMatrix_t<double>;
 using MIDMatrix = MIDMatrix_t<double>;
+template<class real_type>
+using MIEllMatrix_t = MPIDistMat< IEllMatrix_t<real_type>, GeneralComm< dg::iDVec, thrust::device_vector<real_type>> >;
+using MIEllMatrix = MIEllMatrix_t<double>;
 
 
 ///@}
@@ -122,6 +145,7 @@ using fDMatrix = fMDMatrix;
 //interpolation matrices
 using IHMatrix = MIHMatrix;
 using IDMatrix = MIDMatrix;
+using IEllMatrix = MIEllMatrix;
 #else
 using HVec  = HVec;
 using fHVec = fHVec;
@@ -137,6 +161,7 @@ using fDMatrix = fDMatrix;
 //interpolation matrices
 using IHMatrix = IHMatrix;
 using IDMatrix = IDMatrix;
+using IEllMatrix = IEllMatrix;
 #endif //MPI_VERSION
 }//namespace x
 ///@}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <map>
+#include <utility>
+
+namespace dg
+{
+///@cond
+template<class ContainerType, class from_ContainerType, class ...Params>
+inline ContainerType construct( const from_ContainerType& from, Params&& ...ps);
+///@endcond
+
+/*!@brief A pool of equally typed scratch vectors shared between solver classes
+*
+* Solver and stepper classes each keep private copies of their workspace
+* vectors even though most of them are only touched inside a \c solve or
+* \c step call. In an application that holds many solvers (one per species,
+* per multigrid stage, ...) this multiplies the resident memory and slows
+* construction. A \c VectorPool keeps checked-in vectors in a free list
+* keyed by their size; a \c checkout request is served from the free list
+* when a vector of matching size is available and only allocates otherwise.
+*
+* The intended use is through the RAII \c Lease handle which checks its
+* vector back in when it goes out of scope:
+* @code{.cpp}
+void MySolver::solve( ... )
+{
+    //draw two scratch vectors valid until the end of this function
+    auto ap = dg::get_vector_pool<Container>().lease( x);
+    auto  r = dg::get_vector_pool<Container>().lease( x);
+    dg::blas2::symv( A, x, *ap);
+    ...
+} //ap and r return to the pool here
+* @endcode
+* Two solvers that are never active at the same time then share their
+* scratch memory automatically.
+* @note The pool never shrinks by itself; call \c clear to release all
+* checked-in vectors (e.g. after a grid change)
+* @attention The content of a checked out vector is undefined; this class is
+* not thread-safe
+* @tparam Container \c Container must provide a \c size() method and vectors
+* of equal size must be interchangeable (which holds for all shared and MPI
+* vector types in dg)
+* @ingroup lowlevel
+*/
+template<class Container>
+struct VectorPool
+{
+    ///@brief RAII handle that returns its vector to the pool on destruction
+    struct Lease
+    {
+        ///@brief Check out a vector of the same size as \c copyable from \c pool
+        template<class OtherContainer>
+        Lease( VectorPool& pool, const OtherContainer& copyable):
+            m_pool(&pool), m_v( pool.checkout( copyable)){}
+        Lease( const Lease&) = delete;
+        Lease& operator=( const Lease&) = delete;
+        Lease( Lease&& src) noexcept: m_pool( src.m_pool), m_v( std::move( src.m_v))
+        {
+            src.m_pool = nullptr;
+        }
+        Lease& operator=( Lease&& src) noexcept
+        {
+            std::swap( m_pool, src.m_pool);
+            std::swap( m_v, src.m_v);
+            return *this;
+        }
+        ~Lease()
+        {
+            if( m_pool != nullptr)
+                m_pool->checkin( std::move( m_v));
+        }
+        ///@brief Access the checked out vector
+        Container& operator*(){ return m_v;}
+        ///@brief Access the checked out vector
+        Container* operator->(){ return &m_v;}
+        private:
+        VectorPool* m_pool;
+        Container m_v;
+    };
+
+    ///@brief Check out a vector of the same size as \c copyable with RAII semantics
+    ///@param copyable only its size matters
+    template<class OtherContainer>
+    Lease lease( const OtherContainer& copyable)
+    {
+        return Lease( *this, copyable);
+    }
+    /**
+    * @brief Check out a vector of the same size as \c copyable
+    *
+    * @param copyable only its size matters; a vector is only constructed
+    * from it when the free list holds no vector of the same size
+    * @return a vector of the same size as \c copyable with undefined content
+    * @note prefer \c lease which cannot leak pool vectors
+    */
+    template<class OtherContainer>
+    Container checkout( const OtherContainer& copyable)
+    {
+        auto it = m_free.find( copyable.size());
+        if( it != m_free.end())
+        {
+            Container v = std::move( it->second);
+            m_free.erase( it);
+            return v;
+        }
+        return dg::construct<Container>( copyable);
+    }
+    ///@brief Return a vector obtained from \c checkout to the free list
+    void checkin( Container&& v)
+    {
+        auto size = v.size();
+        m_free.emplace( size, std::move( v));
+    }
+    ///@brief Release all checked-in vectors
+    void clear(){ m_free.clear();}
+    ///@return the number of vectors currently in the free list
+    unsigned idle() const{ return m_free.size();}
+    private:
+    std::multimap<std::size_t, Container> m_free;
+};
+
+/*!@brief The process-wide vector pool for the given \c Container type
+*
+* @return one pool instance per \c Container type
+* @ingroup lowlevel
+*/
+template<class Container>
+VectorPool<Container>& get_vector_pool()
+{
+    static VectorPool<Container> pool;
+    return pool;
+}
+
+}//namespace dg
@@ -0,0 +1,37 @@
+#include <iostream>
+
+#include <thrust/device_vector.h>
+#include "vector_pool.h"
+#include "../blas1.h"
+
+using Vector = thrust::device_vector<double>;
+
+int main()
+{
+    std::cout << "Test that the vector pool reuses checked-in vectors\n";
+    dg::VectorPool<Vector>& pool = dg::get_vector_pool<Vector>();
+    Vector copyable( 100, 2.);
+    {
+        auto v = pool.lease( copyable);
+        auto w = pool.lease( copyable);
+        std::cout << "Size of leased vector (100):        "<<v->size()<<"\n";
+        std::cout << "Idle vectors while leased (0):      "<<pool.idle()<<"\n";
+        dg::blas1::copy( 42., *v);
+        dg::blas1::copy( 43., *w);
+    }
+    std::cout << "Idle vectors after lease ends (2):  "<<pool.idle()<<"\n";
+    {
+        //a lease of equal size must not allocate
+        auto v = pool.lease( copyable);
+        std::cout << "Idle vectors while re-leased (1):   "<<pool.idle()<<"\n";
+        //a lease of different size allocates
+        Vector small( 10, 0.);
+        auto w = pool.lease( small);
+        std::cout << "Size of small lease (10):           "<<w->size()<<"\n";
+    }
+    std::cout << "Idle vectors at the end (3):        "<<pool.idle()<<"\n";
+    pool.clear();
+    std::cout << "Idle vectors after clear (0):       "<<pool.idle()<<"\n";
+    std::cout << "\nFINISHED!\n";
+    return 0;
+}
@@ -0,0 +1,241 @@
+#ifndef _DG_VENDOR_MATRIX_
+#define _DG_VENDOR_MATRIX_
+
+#include <cusp/csr_matrix.h>
+#include <cusp/convert.h>
+#include <cusp/multiply.h>
+#include <cusp/array1d.h>
+
+#include "config.h"
+#include "exceptions.h"
+#include "tensor_traits.h"
+#include "tensor_traits_thrust.h"
+#include "tensor_traits_cusp.h"
+
+#if defined(DG_USE_CUSPARSE) && (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA)
+#include <cusparse.h>
+#endif
+#if defined(DG_USE_MKL) && (THRUST_DEVICE_SYSTEM!=THRUST_DEVICE_SYSTEM_CUDA)
+#include <mkl_spblas.h>
+#endif
+
+/*! @file
+  @brief A csr matrix that applies symv through a vendor sparse library
+  */
+namespace dg
+{
+///@cond
+namespace detail
+{
+#if defined(DG_USE_CUSPARSE) && (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA)
+inline cusparseHandle_t cusparse_handle()
+{
+    //the handle initializes the library and is expensive to create
+    static cusparseHandle_t handle = [](){
+        cusparseHandle_t h;
+        if( cusparseCreate( &h) != CUSPARSE_STATUS_SUCCESS)
+            throw Error( Message(_ping_)<<"Failed to initialize cuSPARSE!");
+        return h;
+    }();
+    return handle;
+}
+inline cudaDataType cusparse_dtype( float) { return CUDA_R_32F;}
+inline cudaDataType cusparse_dtype( double){ return CUDA_R_64F;}
+#endif
+#if defined(DG_USE_MKL) && (THRUST_DEVICE_SYSTEM!=THRUST_DEVICE_SYSTEM_CUDA)
+inline sparse_status_t mkl_create_csr( sparse_matrix_t* A, int num_rows,
+        int num_cols, int* rows_start, int* rows_end, int* column_indices,
+        float* values)
+{
+    return mkl_sparse_s_create_csr( A, SPARSE_INDEX_BASE_ZERO, num_rows,
+            num_cols, rows_start, rows_end, column_indices, values);
+}
+inline sparse_status_t mkl_create_csr( sparse_matrix_t* A, int num_rows,
+        int num_cols, int* rows_start, int* rows_end, int* column_indices,
+        double* values)
+{
+    return mkl_sparse_d_create_csr( A, SPARSE_INDEX_BASE_ZERO, num_rows,
+            num_cols, rows_start, rows_end, column_indices, values);
+}
+inline sparse_status_t mkl_mv( float alpha, const sparse_matrix_t A,
+        matrix_descr descr, const float* x, float beta, float* y)
+{
+    return mkl_sparse_s_mv( SPARSE_OPERATION_NON_TRANSPOSE, alpha, A, descr,
+            x, beta, y);
+}
+inline sparse_status_t mkl_mv( double alpha, const sparse_matrix_t A,
+        matrix_descr descr, const double* x, double beta, double* y)
+{
+    return mkl_sparse_d_mv( SPARSE_OPERATION_NON_TRANSPOSE, alpha, A, descr,
+            x, beta, y);
+}
+#endif
+} //namespace detail
+///@endcond
+
+///@addtogroup sparsematrix
+///@{
+/*!@brief A csr matrix that applies \c symv through a vendor sparse library
+ *
+ * This matrix holds a \c cusp::csr_matrix (any cusp format is converted on
+ * construction) and dispatches its application to a vendor sparse library
+ * instead of cusp's legacy kernels when one is enabled at compile time:
+ *  - define \c DG_USE_CUSPARSE in a CUDA build to use \c cusparseSpMV with
+ *  the deterministic merge-path csr algorithm (link with \c -lcusparse);
+ *  for the quasi-banded interpolation matrices of Fieldaligned this is
+ *  several times faster than cusp on recent GPUs
+ *  - define \c DG_USE_MKL in a cpu build to use \c mkl_sparse_?_mv (link
+ *  with the MKL libraries); a hipified build can add rocSPARSE analogously
+ *  to the cuSPARSE branch
+ *
+ * Without either define \c symv falls back to \c cusp::multiply, so code
+ * written against this class compiles and runs everywhere.  The class
+ * registers as a \c SelfMadeMatrixTag matrix, i.e. the backend choice is
+ * made per matrix at construction simply by choosing this type (e.g. as the
+ * \c IMatrix template parameter of \c dg::geo::Fieldaligned) and remains
+ * transparent to all \c dg::blas2::symv callers.
+ * @tparam Container One of the shared memory containers; determines the
+ * value type and whether the matrix lives in host or device memory
+ */
+template<class Container>
+struct VendorMatrix
+{
+    using value_type = get_value_type<Container>;
+    using memory_space = std::conditional_t< std::is_same<
+        get_execution_policy<Container>, CudaTag>::value,
+        cusp::device_memory, cusp::host_memory>;
+    using matrix_type = cusp::csr_matrix<int, value_type, memory_space>;
+    VendorMatrix() = default;
+    /*!@brief Convert and store the given cusp matrix
+     * @param src any cusp matrix; converted to csr format in the memory
+     * space of \c Container
+     */
+    template<class Matrix, class = std::enable_if_t< std::is_base_of<
+        CuspMatrixTag, get_tensor_category<Matrix>>::value>>
+    VendorMatrix( const Matrix& src)
+    {
+        cusp::convert( src, m_matrix);
+    }
+    ///@brief Read access to the stored csr matrix
+    const matrix_type& matrix() const { return m_matrix;}
+    /*!@brief \f$ y = M x\f$ through the enabled vendor library
+     * @param x input vector (size \c num_cols)
+     * @param y contains the result on output (size \c num_rows)
+     */
+    template<class ContainerType0, class ContainerType1>
+    void symv( const ContainerType0& x, ContainerType1& y) const
+    {
+        if( x.size() != m_matrix.num_cols)
+            throw Error( Message(_ping_)<<"x has the wrong size "<<x.size()
+                    <<" Number of columns is "<<m_matrix.num_cols);
+        if( y.size() != m_matrix.num_rows)
+            throw Error( Message(_ping_)<<"y has the wrong size "<<y.size()
+                    <<" Number of rows is "<<m_matrix.num_rows);
+        do_symv( x, y, get_execution_policy<Container>());
+    }
+    private:
+    //fallback through cusp's kernels if no vendor library is enabled
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( const ContainerType0& x, ContainerType1& y,
+            AnyPolicyTag) const
+    {
+        cusp::array1d_view< typename ContainerType0::const_iterator> cx(
+                x.cbegin(), x.cend());
+        cusp::array1d_view< typename ContainerType1::iterator> cy(
+                y.begin(), y.end());
+        cusp::multiply( m_matrix, cx, cy);
+    }
+#if defined(DG_USE_CUSPARSE) && (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA)
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( const ContainerType0& x, ContainerType1& y, CudaTag) const
+    {
+        value_type alpha = 1., beta = 0.;
+        cudaDataType dtype = detail::cusparse_dtype( value_type());
+        cusparseSpMatDescr_t matA;
+        cusparseDnVecDescr_t vecX, vecY;
+        //the descriptors only wrap the existing pointers and are cheap
+        cusparseCreateCsr( &matA, m_matrix.num_rows, m_matrix.num_cols,
+            m_matrix.values.size(),
+            const_cast<int*>( thrust::raw_pointer_cast( &m_matrix.row_offsets[0])),
+            const_cast<int*>( thrust::raw_pointer_cast( &m_matrix.column_indices[0])),
+            const_cast<value_type*>( thrust::raw_pointer_cast( &m_matrix.values[0])),
+            CUSPARSE_INDEX_32I, CUSPARSE_INDEX_32I,
+            CUSPARSE_INDEX_BASE_ZERO, dtype);
+        cusparseCreateDnVec( &vecX, x.size(), const_cast<value_type*>(
+                    thrust::raw_pointer_cast( x.data())), dtype);
+        cusparseCreateDnVec( &vecY, y.size(),
+                thrust::raw_pointer_cast( y.data()), dtype);
+        size_t buffer_size = 0;
+        cusparseSpMV_bufferSize( detail::cusparse_handle(),
+                CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, matA, vecX, &beta,
+                vecY, dtype, CUSPARSE_SPMV_CSR_ALG2, &buffer_size);
+        if( buffer_size > m_buffer.size())
+            m_buffer.resize( buffer_size);
+        void* buffer_ptr = buffer_size == 0 ? nullptr :
+            (void*)thrust::raw_pointer_cast( m_buffer.data());
+        cusparseStatus_t status = cusparseSpMV( detail::cusparse_handle(),
+                CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, matA, vecX, &beta,
+                vecY, dtype, CUSPARSE_SPMV_CSR_ALG2, buffer_ptr);
+        cusparseDestroyDnVec( vecX);
+        cusparseDestroyDnVec( vecY);
+        cusparseDestroySpMat( matA);
+        if( status != CUSPARSE_STATUS_SUCCESS)
+            throw Error( Message(_ping_)<<"cusparseSpMV failed with error code "
+                    <<(int)status);
+    }
+#endif
+#if defined(DG_USE_MKL) && (THRUST_DEVICE_SYSTEM!=THRUST_DEVICE_SYSTEM_CUDA)
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( const ContainerType0& x, ContainerType1& y, OmpTag) const
+    {
+        do_symv_mkl( x, y);
+    }
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( const ContainerType0& x, ContainerType1& y, SerialTag) const
+    {
+        do_symv_mkl( x, y);
+    }
+    template<class ContainerType0, class ContainerType1>
+    void do_symv_mkl( const ContainerType0& x, ContainerType1& y) const
+    {
+        //the mkl handle only wraps the existing pointers and is cheap
+        sparse_matrix_t A;
+        int* rows = const_cast<int*>(
+                thrust::raw_pointer_cast( &m_matrix.row_offsets[0]));
+        sparse_status_t status = detail::mkl_create_csr( &A,
+                m_matrix.num_rows, m_matrix.num_cols, rows, rows+1,
+                const_cast<int*>( thrust::raw_pointer_cast( &m_matrix.column_indices[0])),
+                const_cast<value_type*>( thrust::raw_pointer_cast( &m_matrix.values[0])));
+        if( status != SPARSE_STATUS_SUCCESS)
+            throw Error( Message(_ping_)<<"mkl_sparse_create_csr failed with error code "
+                    <<(int)status);
+        matrix_descr descr;
+        descr.type = SPARSE_MATRIX_TYPE_GENERAL;
+        status = detail::mkl_mv( (value_type)1, A, descr,
+                thrust::raw_pointer_cast( x.data()), (value_type)0,
+                thrust::raw_pointer_cast( y.data()));
+        mkl_sparse_destroy( A);
+        if( status != SPARSE_STATUS_SUCCESS)
+            throw Error( Message(_ping_)<<"mkl_sparse_mv failed with error code "
+                    <<(int)status);
+    }
+#endif
+    matrix_type m_matrix;
+#if defined(DG_USE_CUSPARSE) && (THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA)
+    mutable thrust::device_vector<char> m_buffer; //cusparse work buffer
+#endif
+};
+///@}
+
+///@cond
+template<class Container>
+struct TensorTraits<VendorMatrix<Container>>
+{
+    using value_type = get_value_type<Container>;
+    using tensor_category = SelfMadeMatrixTag;
+    using execution_policy = get_execution_policy<Container>;
+};
+///@endcond
+
+}//namespace dg
+#endif //_DG_VENDOR_MATRIX_
@@ -13,7 +13,10 @@ namespace dg
  * @ingroup view
  * The view class holds a pointer and a size. It does not own the pointer.
  * The user is responsible for allocating and deallocating memory.
- * The intention is to use Views in \c dg::blas1 functions.
+ * The intention is to use Views in \c dg::blas1 and \c dg::blas2 functions;
+ * in particular the planes generated by \c dg::split can be fed directly to
+ * \c dg::blas2::symv, the \c dg::Elliptic and the \c dg::Average classes
+ * without copying them into temporaries first.
  *
  * The class can be used as
  * a traditional "view" in the sense that it can view part of a larger contiguous
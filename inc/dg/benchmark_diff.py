@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Compare two benchmark result files written by `make benchmarks`.
+
+Usage: python3 benchmark_diff.py old.json new.json [--threshold 0.1]
+
+Prints the per-case timing ratio and exits with status 1 if any case
+slowed down by more than the threshold (default 10%), so the script can
+gate a release pipeline.
+"""
+import argparse
+import json
+import sys
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("old", help="baseline result file")
+    parser.add_argument("new", help="new result file to compare against the baseline")
+    parser.add_argument("--threshold", type=float, default=0.1,
+                        help="relative slow-down that counts as a regression (default 0.1)")
+    args = parser.parse_args()
+
+    with open(args.old) as f:
+        old = json.load(f)
+    with open(args.new) as f:
+        new = json.load(f)
+
+    regressions = []
+    print(f"{'case':<40} {'old[s]':>12} {'new[s]':>12} {'ratio':>8}")
+    for name in sorted(set(old) | set(new)):
+        if name not in old:
+            print(f"{name:<40} {'-':>12} {new[name]['time']:>12.4e} {'new':>8}")
+            continue
+        if name not in new:
+            print(f"{name:<40} {old[name]['time']:>12.4e} {'-':>12} {'gone':>8}")
+            continue
+        ratio = new[name]["time"] / old[name]["time"]
+        flag = ""
+        if ratio > 1.0 + args.threshold:
+            flag = " <-- regression"
+            regressions.append(name)
+        if old[name].get("iter") != new[name].get("iter"):
+            flag += (f" (iter {old[name].get('iter')} -> {new[name].get('iter')})")
+        print(f"{name:<40} {old[name]['time']:>12.4e} {new[name]['time']:>12.4e} {ratio:>8.3f}{flag}")
+
+    if regressions:
+        print(f"\n{len(regressions)} case(s) regressed by more than "
+              f"{100 * args.threshold:.0f}%: {', '.join(regressions)}")
+        return 1
+    print("\nNo regressions found.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
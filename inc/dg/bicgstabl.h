@@ -9,6 +9,7 @@
 #include "blas.h"
 #include "functors.h"
 #include "backend/typedefs.h"
+#include "convergence_history.h"
 
 /*!@file
  * BICGSTABl class
@@ -91,6 +92,8 @@ class BICGSTABl
     void set_throw_on_fail( bool throw_on_fail){
         m_throw_on_fail = throw_on_fail;
     }
+    ///@copydoc dg::PCG::set_history(ConvergenceHistory*)
+    void set_history( ConvergenceHistory* hist){ m_hist = hist;}
 
     /**
      * @brief Solve \f$ Ax = b\f$ using a preconditioned BICGSTABl method
@@ -123,6 +126,7 @@ class BICGSTABl
     std::vector<value_type> sigma, gamma, gammap, gammapp;
     std::vector<std::vector<value_type>> tau;
     bool m_verbose = false, m_throw_on_fail = true;
+    ConvergenceHistory* m_hist = nullptr;
 
 };
 ///@cond
@@ -143,11 +147,21 @@ unsigned BICGSTABl< ContainerType>::solve( Matrix&& A, ContainerType0& x, const
         blas1::copy( 0., x);
         return 0;
     }
+    if( m_hist)
+        m_hist->begin_solve( nrmb, tol);
     dg::blas2::symv(std::forward<Matrix>(A),x,m_tmp);
     dg::blas1::axpby(1.,b,-1.,m_tmp);
+    if( m_hist)
+        m_hist->matvec();
     if( sqrt( blas2::dot(W,m_tmp) ) < tol) //if x happens to be the solution
+    {
+        if( m_hist)
+            m_hist->end_solve( 0, true);
         return 0;
+    }
     dg::blas2::symv(std::forward<Preconditioner>(P),m_tmp,rhat[0]);
+    if( m_hist)
+        m_hist->precond();
 
     dg::blas1::copy(0., uhat[0]);
 
@@ -172,6 +186,11 @@ unsigned BICGSTABl< ContainerType>::solve( Matrix&& A, ContainerType0& x, const
             }
             dg::blas2::symv(std::forward<Matrix>(A),uhat[j],m_tmp);
             dg::blas2::symv(std::forward<Preconditioner>(P),m_tmp,uhat[j+1]);
+            if( m_hist)
+            {
+                m_hist->matvec();
+                m_hist->precond();
+            }
             if( rho_0 == 0)
                 alpha = 0;
             else
@@ -182,6 +201,11 @@ unsigned BICGSTABl< ContainerType>::solve( Matrix&& A, ContainerType0& x, const
             }
             dg::blas2::symv(std::forward<Matrix>(A),rhat[j],m_tmp);
             dg::blas2::symv(std::forward<Preconditioner>(P),m_tmp,rhat[j+1]);
+            if( m_hist)
+            {
+                m_hist->matvec();
+                m_hist->precond();
+            }
             dg::blas1::axpby(alpha,uhat[0],1.,xhat);
         }
 
@@ -225,12 +249,18 @@ unsigned BICGSTABl< ContainerType>::solve( Matrix&& A, ContainerType0& x, const
         value_type err = sqrt(dg::blas2::dot(W,rhat[0]));
         if( m_verbose)
             DG_RANK0 std::cout << "# Error is now : " << err << " Against " << tol << std::endl;
+        if( m_hist)
+            m_hist->residual( err);
         if( err < tol){
             if( m_verbose)
                 DG_RANK0 std::cout << "# Exited with error : " << err << " After " << k+m_l << " Iterations." << std::endl;
+            if( m_hist)
+                m_hist->end_solve( k+m_l, true);
             return k+m_l;
         }
     }
+    if( m_hist)
+        m_hist->end_solve( max_iter, false);
     if( m_verbose)
         DG_RANK0 std::cout << "# Failed to converge within max_iter" << std::endl;
     if( m_throw_on_fail)
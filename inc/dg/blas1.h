@@ -90,6 +90,118 @@ inline get_value_type<ContainerType1> dot( const ContainerType1& x, const Contai
     return exblas::cpu::Round(acc.data());
 }
 
+#ifdef MPI_VERSION
+///@cond
+template<class T>
+struct Future;
+template< class ContainerType1, class ContainerType2>
+inline Future<get_value_type<ContainerType1>> dot_async( const ContainerType1& x, const ContainerType2& y);
+///@endcond
+
+/*! @brief Future for the result of an asynchronous \c dg::blas1::dot_async
+ *
+ * Represents a dot product whose global MPI reduction is still in flight.
+ * The result becomes available with \c get(), which waits for the
+ * reduction to finish and may be called any number of times.
+ * @attention The future is a handle to a collective operation: every
+ * process of the communicator must eventually complete it (by calling
+ * \c get() or by destroying the future, which waits as well) and futures
+ * on the same communicator must be completed in the order they were
+ * created
+ * @tparam T the value type of the result
+ */
+template<class T>
+struct Future
+{
+    ///@brief a future holding the result \c T(0)
+    Future() = default;
+    ///@cond
+    Future( const Future& src) = delete;
+    Future& operator=( const Future& src) = delete;
+    //moves transfer the responsibility to complete the collective
+    Future( Future&& src): m_acc( std::move(src.m_acc)),
+        m_receive( std::move(src.m_receive)), m_comm( src.m_comm),
+        m_comm_mod_reduce( src.m_comm_mod_reduce), m_rqst( src.m_rqst),
+        m_result( src.m_result), m_pending( src.m_pending)
+    {
+        src.m_pending = false;
+    }
+    Future& operator=( Future&& src)
+    {
+        if( m_pending)
+            get();
+        m_acc = std::move( src.m_acc), m_receive = std::move( src.m_receive);
+        m_comm = src.m_comm, m_comm_mod_reduce = src.m_comm_mod_reduce;
+        m_rqst = src.m_rqst, m_result = src.m_result, m_pending = src.m_pending;
+        src.m_pending = false;
+        return *this;
+    }
+    ///@endcond
+    ///@brief wait for an unfinished reduction such that no process leaves the collective hanging
+    ~Future(){ if( m_pending) get();}
+    /**
+     * @brief Wait for the reduction to finish and return the result
+     *
+     * The first call blocks until the result is available, subsequent calls
+     * return the cached value immediately.
+     * @return the binary reproducible dot product
+     */
+    T get()
+    {
+        if( m_pending)
+        {
+            exblas::ireduce_mpi_cpu_wait( 1, m_acc.data(), m_receive.data(),
+                m_comm, m_comm_mod_reduce, &m_rqst);
+            m_result = exblas::cpu::Round( m_receive.data());
+            m_pending = false;
+        }
+        return m_result;
+    }
+    private:
+    template< class ContainerType1, class ContainerType2>
+    friend Future<get_value_type<ContainerType1>> dot_async( const ContainerType1& x, const ContainerType2& y);
+    std::vector<int64_t> m_acc, m_receive;
+    MPI_Comm m_comm = MPI_COMM_NULL, m_comm_mod_reduce = MPI_COMM_NULL;
+    MPI_Request m_rqst = MPI_REQUEST_NULL;
+    T m_result = (T)0;
+    bool m_pending = false;
+};
+
+/*! @brief \f$ x^T y\f$ Initiate an asynchronous binary reproducible dot product (MPI only)
+ *
+ * Computes the local superaccumulator synchronously but posts the global
+ * reduction as a non-blocking collective and returns immediately, such
+ * that the reduction latency can be hidden behind subsequent computation
+ * (e.g. the next matrix-vector product in a conjugate gradient iteration).
+ * For example
+@code{.cpp}
+auto future = dg::blas1::dot_async( r, r);
+dg::blas2::symv( A, p, ap); // overlaps with the reduction
+double nrm2 = future.get();
+@endcode
+ * The result equals the one of \c dg::blas1::dot bit for bit.
+ * @param x Left MPI Container
+ * @param y Right MPI Container may alias x
+ * @return a \c dg::blas1::Future holding the scalar product
+ * @attention the input vectors must not be changed before the future is
+ * completed and every process of the communicator must complete it
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class ContainerType2>
+inline Future<get_value_type<ContainerType1>> dot_async( const ContainerType1& x, const ContainerType2& y)
+{
+    Future<get_value_type<ContainerType1>> future;
+    MPI_Comm comm_mod;
+    future.m_acc = dg::blas1::detail::doDot_local_superacc( x, y,
+        future.m_comm, comm_mod, future.m_comm_mod_reduce);
+    future.m_receive.assign( exblas::BIN_COUNT, (int64_t)0);
+    exblas::ireduce_mpi_cpu_init( 1, future.m_acc.data(),
+        future.m_receive.data(), comm_mod, &future.m_rqst);
+    future.m_pending = true;
+    return future;
+}
+#endif //MPI_VERSION
+
 /*! @brief \f$ f(x_0) \otimes f(x_1) \otimes \dots \otimes f(x_{N-1}) \f$ Custom (transform) reduction
  *
  * This routine computes \f[ s = f(x_0) \otimes f(x_1) \otimes \dots \otimes f(x_i) \otimes \dots \otimes f(x_{N-1}) \f]
@@ -146,6 +258,62 @@ inline OutputType reduce( const ContainerType& x, OutputType zero, BinaryOp
             unary_op);
 }
 
+/*! @brief \f$ f(x_0,y_0) \otimes f(x_1,y_1) \otimes \dots \otimes f(x_{N-1},y_{N-1}) \f$ Custom (binary transform) reduction
+ *
+ * This routine computes \f[ s = f(x_0,y_0) \otimes f(x_1,y_1) \otimes \dots \otimes f(x_i,y_i) \otimes \dots \otimes f(x_{N-1},y_{N-1}) \f]
+ * where \f$ \otimes \f$ is an arbitrary **commutative** and **associative** binary operator and \f$ f\f$ a binary transform operator.
+ * The fused single sweep over both vectors replaces a transform followed by a
+ * reduction and thus halves the memory traffic of e.g. a weighted norm
+ *
+ * @note numerical addition/multiplication is **not** exactly associative
+ * which means that the associated reduction looses precision due to inexact arithmetic. For binary reproducible exactly rounded results use the dg::blas1::dot function.
+ * However, this function is more general and faster to execute than dg::blas1::dot.
+
+For example
+@code{.cpp}
+//Compute the l2 distance between x and y in a single pass
+thrust::device_vector<double> x( 100, 2.), y( 100, 1.);
+double dist = sqrt( dg::blas1::reduce( x, y, (double)0,
+    thrust::plus<double>(), []DG_DEVICE(double x, double y){
+        return (x-y)*(x-y);}) );
+@endcode
+ * @param x First container to reduce
+ * @param y Second container to reduce, must have the same size as \c x
+ * @param zero The neutral element with respect to binary_op that is
+ * <tt> x == binary_op( zero, x) </tt>. Determines the \c OutputType so make
+ * sure to make the type clear to the compiler (e.g. write <tt> (double)0 </tt> instead
+ * of \c 0 if you want \c double output)
+ * @attention In the current implementation \c zero is used to initialize
+ * partial sums e.g. when reducing MPI Vectors so it is important that \c zero
+ * is actually the neutral element. The reduction will yield wrong results
+ * if it is not.
+ * @param binary_op an associative and commutative binary operator
+ * @param binary_transform a binary operator applied to each pair of elements of \c x and \c y
+ * @return Custom reduction as defined above
+ * @note This routine is always executed synchronously due to the
+        implicit memcpy of the result. With mpi the result is broadcasted to
+        all processes
+ * @tparam BinaryOp Functor with signature: <tt> value_type  operator()(
+ * value_type, value_type) </tt>, must be associative and commutative.
+ * \c value_tpye must be compatible with \c OutputType
+ * @tparam BinaryTransform a binary operator. The argument types must be
+ * compatible with \c get_value_type<ContainerType1> and
+ * \c get_value_type<ContainerType2>. The return type must be convertible to
+ * \c OutputType
+ * @tparam OutputType The type of the result. Infered from \c zero so make sure
+ * \c zero's type is clear to the compiler.
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class ContainerType2, class OutputType, class
+    BinaryOp, class BinaryTransform>
+inline OutputType reduce( const ContainerType1& x, const ContainerType2& y,
+        OutputType zero, BinaryOp binary_op, BinaryTransform binary_transform)
+{
+    return dg::blas1::detail::doReduce(
+            dg::get_tensor_category<ContainerType1>(), x, y, zero, binary_op,
+            binary_transform);
+}
+
 /**
  * @brief \f$ y=x \f$
  *
@@ -579,9 +747,197 @@ inline std::vector<int64_t> doDot_superacc( const ContainerType1& x, const Conta
     return doDot_superacc( x, y, tensor_category());
 }
 
+template< class ContainerType1, class ContainerType2, std::size_t N>
+std::array<get_value_type<ContainerType1>, N> doDot_batched(
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs, AnyVectorTag)
+{
+    std::array<get_value_type<ContainerType1>, N> result;
+    for( unsigned i=0; i<N; i++)
+    {
+        std::vector<int64_t> acc = doDot_superacc( *pairs[i].first, *pairs[i].second);
+        result[i] = exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+//vectors with a common shared memory execution policy are rounded by the
+//backend (on GPUs in a device kernel) and all results are fetched in a
+//single transfer
+template< class ContainerType1, class ContainerType2, std::size_t N>
+std::array<get_value_type<ContainerType1>, N> doDot_batched(
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs, SharedVectorTag)
+{
+    static_assert( std::is_same< get_execution_policy<ContainerType1>,
+        get_execution_policy<ContainerType2>>::value, "Execution policies must be equal!");
+    using value_type = get_value_type<ContainerType1>;
+    std::array<unsigned, N> sizes;
+    std::array<const value_type*, N> x_ptrs;
+    std::array<const get_value_type<ContainerType2>*, N> y_ptrs;
+    for( unsigned i=0; i<N; i++)
+    {
+        sizes[i] = pairs[i].first->size();
+        x_ptrs[i] = thrust::raw_pointer_cast( pairs[i].first->data());
+        y_ptrs[i] = thrust::raw_pointer_cast( pairs[i].second->data());
+    }
+    return doDot_batched_dispatch<value_type>(
+        get_execution_policy<ContainerType1>(), sizes, x_ptrs, y_ptrs);
+}
+#ifdef MPI_VERSION
+template< class ContainerType1, class ContainerType2, std::size_t N>
+std::array<get_value_type<ContainerType1>, N> doDot_batched(
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs, MPIVectorTag)
+{
+    //compute all local superaccumulators back-to-back ...
+    std::vector<int64_t> acc( N*exblas::BIN_COUNT), receive( N*exblas::BIN_COUNT, (int64_t)0);
+    for( unsigned i=0; i<N; i++)
+    {
+#ifdef DG_DEBUG
+        mpi_assert( *pairs[i].first, *pairs[i].second);
+        mpi_assert( *pairs[0].first, *pairs[i].first);
+#endif //DG_DEBUG
+        std::vector<int64_t> local = doDot_superacc(
+            pairs[i].first->data(), pairs[i].second->data());
+        for( int k=0; k<exblas::BIN_COUNT; k++)
+            acc[i*exblas::BIN_COUNT + k] = local[k];
+    }
+    //... so that a single MPI reduction suffices for all of them
+    exblas::reduce_mpi_cpu( N, acc.data(), receive.data(),
+        pairs[0].first->communicator(),
+        pairs[0].first->communicator_mod(),
+        pairs[0].first->communicator_mod_reduce());
+    std::array<get_value_type<ContainerType1>, N> result;
+    for( unsigned i=0; i<N; i++)
+        result[i] = exblas::cpu::Round( &receive[i*exblas::BIN_COUNT]);
+    return result;
+}
+#endif //MPI_VERSION
+
+//runtime sized versions of the above for batches whose size is only known
+//at runtime (e.g. a registered diagnostics list)
+template< class ContainerType1, class ContainerType2>
+std::vector<get_value_type<ContainerType1>> doDot_batched(
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs, AnyVectorTag)
+{
+    std::vector<get_value_type<ContainerType1>> result( pairs.size());
+    for( unsigned i=0; i<pairs.size(); i++)
+    {
+        std::vector<int64_t> acc = doDot_superacc( *pairs[i].first, *pairs[i].second);
+        result[i] = exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+template< class ContainerType1, class ContainerType2>
+std::vector<get_value_type<ContainerType1>> doDot_batched(
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs, SharedVectorTag)
+{
+    static_assert( std::is_same< get_execution_policy<ContainerType1>,
+        get_execution_policy<ContainerType2>>::value, "Execution policies must be equal!");
+    using value_type = get_value_type<ContainerType1>;
+    unsigned num = pairs.size();
+    std::vector<unsigned> sizes( num);
+    std::vector<const value_type*> x_ptrs( num);
+    std::vector<const get_value_type<ContainerType2>*> y_ptrs( num);
+    for( unsigned i=0; i<num; i++)
+    {
+        sizes[i] = pairs[i].first->size();
+        x_ptrs[i] = thrust::raw_pointer_cast( pairs[i].first->data());
+        y_ptrs[i] = thrust::raw_pointer_cast( pairs[i].second->data());
+    }
+    return doDot_batched_dispatch<value_type>(
+        get_execution_policy<ContainerType1>(), sizes, x_ptrs, y_ptrs);
+}
+#ifdef MPI_VERSION
+template< class ContainerType1, class ContainerType2>
+std::vector<get_value_type<ContainerType1>> doDot_batched(
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs, MPIVectorTag)
+{
+    unsigned num = pairs.size();
+    if( num == 0)
+        return {};
+    //compute all local superaccumulators back-to-back ...
+    std::vector<int64_t> acc( num*exblas::BIN_COUNT), receive( num*exblas::BIN_COUNT, (int64_t)0);
+    for( unsigned i=0; i<num; i++)
+    {
+#ifdef DG_DEBUG
+        mpi_assert( *pairs[i].first, *pairs[i].second);
+        mpi_assert( *pairs[0].first, *pairs[i].first);
+#endif //DG_DEBUG
+        std::vector<int64_t> local = doDot_superacc(
+            pairs[i].first->data(), pairs[i].second->data());
+        for( int k=0; k<exblas::BIN_COUNT; k++)
+            acc[i*exblas::BIN_COUNT + k] = local[k];
+    }
+    //... so that a single MPI reduction suffices for all of them
+    exblas::reduce_mpi_cpu( num, acc.data(), receive.data(),
+        pairs[0].first->communicator(),
+        pairs[0].first->communicator_mod(),
+        pairs[0].first->communicator_mod_reduce());
+    std::vector<get_value_type<ContainerType1>> result( num);
+    for( unsigned i=0; i<num; i++)
+        result[i] = exblas::cpu::Round( &receive[i*exblas::BIN_COUNT]);
+    return result;
+}
+#endif //MPI_VERSION
+
 }//namespace detail
 ///@endcond
 
+/*! @brief \f$ x_s^T y_s \f$ Batched binary reproducible Euclidean dot products
+ *
+ * This routine computes several dot products in one go
+ * \f[ r_s = x_s^T y_s = \sum_{i=0}^{N-1} x_{si} y_{si} \f]
+ * The results are identical to separate calls of \c dg::blas1::dot for each
+ * pair. The advantage over separate calls is that with MPI all
+ * superaccumulators are reduced in a @b single \c MPI_Allreduce instead of
+ * one per pair, which matters when many dot products are taken per solver
+ * iteration at large process counts. On GPUs the final rounding of the
+ * superaccumulators happens in a device kernel and all results are fetched
+ * in a single transfer, so the batch pays only one synchronization instead
+ * of one per pair.
+For example
+@code{.cpp}
+dg::DVec two( 100,2), three(100,3);
+std::array<double,2> result = dg::blas1::dot( std::array{
+    std::make_pair( &two, &three), std::make_pair( &two, &two)});
+// result = {600, 400}
+@endcode
+ * @param pairs an array of pointers to the vector pairs to contract
+ * @return the scalar products, one per pair
+ * @note With MPI all vectors must have congruent communicators
+ * @note This routine is always executed synchronously due to the
+        implicit memcpy of the result. With mpi the result is broadcasted to all processes.
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class ContainerType2, std::size_t N>
+inline std::array<get_value_type<ContainerType1>, N> dot(
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs)
+{
+    return dg::blas1::detail::doDot_batched( pairs,
+        get_tensor_category<ContainerType1>());
+}
+
+/*! @brief \f$ x_s^T y_s \f$ Batched binary reproducible Euclidean dot products (runtime sized)
+ *
+ * Same as the \c std::array overload but for batches whose size is only
+ * known at runtime, e.g. a list of registered 0d diagnostics where all
+ * integrals of one output step are contracted in a single batch: the local
+ * accumulations are submitted back-to-back, on GPUs a single transfer
+ * fetches all results and with MPI a single \c MPI_Allreduce reduces all
+ * superaccumulators at once.
+ * @param pairs pointers to the vector pairs to contract
+ * @return the scalar products, one per pair
+ * @note With MPI all vectors must have congruent communicators
+ * @note This routine is always executed synchronously due to the
+        implicit memcpy of the result. With mpi the result is broadcasted to all processes.
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class ContainerType2>
+inline std::vector<get_value_type<ContainerType1>> dot(
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs)
+{
+    return dg::blas1::detail::doDot_batched( pairs,
+        get_tensor_category<ContainerType1>());
+}
+
 /**
  * @brief \f$ f(x_0, x_1, ...)\f$; Customizable and generic blas1 function
  *
@@ -133,6 +133,20 @@ int main()
     std::array<std::array<Vector, 2>,2> w11( dg::construct<std::array<std::array<Vector,2>,2>>(v1)), w22({w2,w2}), w33({w3,w3}), w44({w4,w4});
     dg::blas1::axpby( 2., w11, 3., w22);
     std::cout << "2*2+ 3*3 = " << w22[1][1][0] <<" (13)\n";
+
+    std::cout << "Human readable test of batched dot products (passed if ouput equals value in brackets) \n";
+    Vector b1( 100, 2.), b2( 100, 3.);
+    std::array<double,2> batched = dg::blas1::dot( std::array<std::pair<const Vector*, const Vector*>,2>{
+        std::make_pair( &b1, &b2), std::make_pair( &b1, &b1)});
+    std::cout << "2*3*100 = " << batched[0]<<" (600)\n";
+    std::cout << "2*2*100 = " << batched[1]<<" (400)\n";
+    //runtime sized batch (one entry per registered diagnostic)
+    std::vector<std::pair<const Vector*, const Vector*>> reg = {
+        { &b1, &b2}, { &b2, &b2}, { &b1, &b1}};
+    std::vector<double> fused = dg::blas1::dot( reg);
+    std::cout << "2*3*100 = " << fused[0]<<" (600)\n";
+    std::cout << "3*3*100 = " << fused[1]<<" (900)\n";
+    std::cout << "2*2*100 = " << fused[2]<<" (400)\n";
     std::cout << "\nFINISHED! Continue with topology/evaluation_t.cu !\n\n";
 
     return 0;
@@ -14,6 +14,7 @@
 #include "backend/blas2_dispatch_mpi.h"
 #endif //MPI_VERSION
 #include "backend/blas2_dispatch_vector.h"
+#include "backend/prof.h"
 
 
 /*!@file
@@ -107,6 +108,151 @@ inline get_value_type<MatrixType> dot( const MatrixType& m, const ContainerType&
 {
     return dg::blas2::dot( x, m, x);
 }
+
+///@cond
+namespace detail{
+template< class ContainerType1, class MatrixType, class ContainerType2, std::size_t N>
+std::array<get_value_type<MatrixType>, N> doDot_batched( const MatrixType& m,
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs,
+    AnyVectorTag)
+{
+    std::array<get_value_type<MatrixType>, N> result;
+    for( unsigned i=0; i<N; i++)
+    {
+        std::vector<int64_t> acc = doDot_superacc( *pairs[i].first, m, *pairs[i].second);
+        result[i] = exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+#ifdef MPI_VERSION
+template< class ContainerType1, class MatrixType, class ContainerType2, std::size_t N>
+std::array<get_value_type<MatrixType>, N> doDot_batched( const MatrixType& m,
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs,
+    MPIVectorTag)
+{
+    //compute all local superaccumulators back-to-back ...
+    std::vector<int64_t> acc( N*exblas::BIN_COUNT), receive( N*exblas::BIN_COUNT, (int64_t)0);
+    for( unsigned i=0; i<N; i++)
+    {
+#ifdef DG_DEBUG
+        dg::blas1::detail::mpi_assert( m, *pairs[i].first);
+        dg::blas1::detail::mpi_assert( m, *pairs[i].second);
+#endif //DG_DEBUG
+        std::vector<int64_t> local = doDot_superacc(
+            pairs[i].first->data(), m.data(), pairs[i].second->data());
+        for( int k=0; k<exblas::BIN_COUNT; k++)
+            acc[i*exblas::BIN_COUNT + k] = local[k];
+    }
+    //... so that a single MPI reduction suffices for all of them
+    exblas::reduce_mpi_cpu( N, acc.data(), receive.data(), m.communicator(),
+        m.communicator_mod(), m.communicator_mod_reduce());
+    std::array<get_value_type<MatrixType>, N> result;
+    for( unsigned i=0; i<N; i++)
+        result[i] = exblas::cpu::Round( &receive[i*exblas::BIN_COUNT]);
+    return result;
+}
+#endif //MPI_VERSION
+//runtime sized versions of the above for batches whose size is only known
+//at runtime (e.g. a registered diagnostics list)
+template< class ContainerType1, class MatrixType, class ContainerType2>
+std::vector<get_value_type<MatrixType>> doDot_batched( const MatrixType& m,
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs,
+    AnyVectorTag)
+{
+    std::vector<get_value_type<MatrixType>> result( pairs.size());
+    for( unsigned i=0; i<pairs.size(); i++)
+    {
+        std::vector<int64_t> acc = doDot_superacc( *pairs[i].first, m, *pairs[i].second);
+        result[i] = exblas::cpu::Round( acc.data());
+    }
+    return result;
+}
+#ifdef MPI_VERSION
+template< class ContainerType1, class MatrixType, class ContainerType2>
+std::vector<get_value_type<MatrixType>> doDot_batched( const MatrixType& m,
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs,
+    MPIVectorTag)
+{
+    unsigned num = pairs.size();
+    if( num == 0)
+        return {};
+    //compute all local superaccumulators back-to-back ...
+    std::vector<int64_t> acc( num*exblas::BIN_COUNT), receive( num*exblas::BIN_COUNT, (int64_t)0);
+    for( unsigned i=0; i<num; i++)
+    {
+#ifdef DG_DEBUG
+        dg::blas1::detail::mpi_assert( m, *pairs[i].first);
+        dg::blas1::detail::mpi_assert( m, *pairs[i].second);
+#endif //DG_DEBUG
+        std::vector<int64_t> local = doDot_superacc(
+            pairs[i].first->data(), m.data(), pairs[i].second->data());
+        for( int k=0; k<exblas::BIN_COUNT; k++)
+            acc[i*exblas::BIN_COUNT + k] = local[k];
+    }
+    //... so that a single MPI reduction suffices for all of them
+    exblas::reduce_mpi_cpu( num, acc.data(), receive.data(), m.communicator(),
+        m.communicator_mod(), m.communicator_mod_reduce());
+    std::vector<get_value_type<MatrixType>> result( num);
+    for( unsigned i=0; i<num; i++)
+        result[i] = exblas::cpu::Round( &receive[i*exblas::BIN_COUNT]);
+    return result;
+}
+#endif //MPI_VERSION
+}//namespace detail
+///@endcond
+
+/*! @brief \f$ x_s^T M y_s\f$; Batched binary reproducible general dot products
+ *
+ * This routine computes several generalized dot products sharing the diagonal
+ * matrix \c M in one go
+ * \f[ r_s = x_s^T M y_s = \sum_{i=0}^{N-1} x_{si} M_{ii} y_{si} \f]
+ * The results are identical to separate calls of \c dg::blas2::dot for each
+ * pair but with MPI all superaccumulators are reduced in a @b single
+ * \c MPI_Allreduce, which matters when e.g. a Krylov solver or the
+ * diagnostics take many scalar products over the same weights per iteration
+ * at large process counts.
+ * @param m The diagonal Matrix
+ * @param pairs an array of pointers to the vector pairs to contract
+ * @return the generalized scalar products, one per pair
+ * @note With MPI all vectors must have congruent communicators
+ * @note This routine is always executed synchronously due to the
+    implicit memcpy of the result.
+ * @tparam MatrixType \c MatrixType has to have a category derived from \c AnyVectorTag and must be compatible with the \c ContainerTypes
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class MatrixType, class ContainerType2, std::size_t N>
+inline std::array<get_value_type<MatrixType>, N> dot( const MatrixType& m,
+    const std::array<std::pair<const ContainerType1*, const ContainerType2*>, N>& pairs)
+{
+    return dg::blas2::detail::doDot_batched( m, pairs,
+        get_tensor_category<MatrixType>());
+}
+
+/*! @brief \f$ x_s^T M y_s\f$; Batched binary reproducible general dot products (runtime sized)
+ *
+ * Same as the \c std::array overload but for batches whose size is only
+ * known at runtime. The intended use are registered 0d diagnostics (mass,
+ * energy, dissipation integrals, ...) that share the volume weights \c M:
+ * all integrals of one output step are contracted in a single batch with a
+ * single result transfer and, with MPI, a single \c MPI_Allreduce instead
+ * of one full-field reduction per record.
+ * @param m The diagonal Matrix
+ * @param pairs pointers to the vector pairs to contract
+ * @return the generalized scalar products, one per pair
+ * @note With MPI all vectors must have congruent communicators
+ * @note This routine is always executed synchronously due to the
+    implicit memcpy of the result.
+ * @tparam MatrixType \c MatrixType has to have a category derived from \c AnyVectorTag and must be compatible with the \c ContainerTypes
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class MatrixType, class ContainerType2>
+inline std::vector<get_value_type<MatrixType>> dot( const MatrixType& m,
+    const std::vector<std::pair<const ContainerType1*, const ContainerType2*>>& pairs)
+{
+    return dg::blas2::detail::doDot_batched( m, pairs,
+        get_tensor_category<MatrixType>());
+}
+
 ///@cond
 namespace detail{
 //resolve tags in two stages: first the matrix and then the container type
@@ -173,28 +319,32 @@ inline void doSymv( MatrixType&& M,
             get_tensor_category<MatrixType>(),
             get_tensor_category<ContainerType1>());
 }
-template< class FunctorType, class MatrixType, class ContainerType1, class ContainerType2>
+template< class FunctorType, class MatrixType, class ContainerType1, class ...ContainerTypes>
 inline void doStencil(
+                  AnyMatrixTag,
                   FunctorType f,
                   MatrixType&& M,
                   const ContainerType1& x,
-                  ContainerType2& y,
-                  AnyMatrixTag)
+                  ContainerTypes&&... ys)
 {
-    static_assert( std::is_same<get_execution_policy<ContainerType1>,
-                                get_execution_policy<ContainerType2>>::value,
+    static_assert( all_true<
+            std::is_same<get_execution_policy<ContainerType1>,
+                get_execution_policy<ContainerTypes>>::value...>::value,
                                 "Vector types must have same execution policy");
     static_assert( std::is_same<get_value_type<ContainerType1>,
                                 get_value_type<MatrixType>>::value &&
-                   std::is_same<get_value_type<ContainerType2>,
-                                get_value_type<MatrixType>>::value,
+                   all_true< std::is_same<get_value_type<ContainerTypes>,
+                       get_value_type<MatrixType>>::value...>::value,
                                 "Vector and Matrix types must have same value type");
-    static_assert( std::is_same<get_tensor_category<ContainerType1>,
-                                get_tensor_category<ContainerType2>>::value,
+    static_assert( all_true<
+            std::is_same<get_tensor_category<ContainerType1>,
+                get_tensor_category<ContainerTypes>>::value...>::value,
                                 "Vector types must have same data layout");
-    dg::blas2::detail::doStencil( f, std::forward<MatrixType>(M), x, y,
+    dg::blas2::detail::doStencil(
             get_tensor_category<MatrixType>(),
-            get_tensor_category<ContainerType1>());
+            get_tensor_category<ContainerType1>(),
+            f, std::forward<MatrixType>(M), x,
+            std::forward<ContainerTypes>(ys)...);
 }
 
 template< class MatrixType, class ContainerType1, class ContainerType2>
@@ -257,6 +407,7 @@ inline void symv( get_value_type<ContainerType1> alpha,
         dg::blas1::scal( y, beta);
         return;
     }
+    DG_PROF_SCOPE( "blas2::symv");
     dg::blas2::detail::doSymv( alpha, std::forward<MatrixType>(M), x, beta, y, get_tensor_category<MatrixType>());
 }
 
@@ -288,6 +439,7 @@ inline void symv( MatrixType&& M,
                   const ContainerType1& x,
                   ContainerType2& y)
 {
+    DG_PROF_SCOPE( "blas2::symv");
     dg::blas2::detail::doSymv( std::forward<MatrixType>(M), x, y, get_tensor_category<MatrixType>());
 }
 /*! @brief \f$ y = \alpha M x + \beta y \f$;
@@ -318,6 +470,47 @@ inline void gemv( MatrixType&& M,
     dg::blas2::symv( std::forward<MatrixType>(M), x, y);
 }
 
+/*! @brief \f$ z = \alpha M x + \beta y\f$; fused matrix-vector product and vector addition
+ *
+ * This routine computes \f[ z = \alpha M x + \beta y \f]
+ * It is functionally equivalent to
+ * @code{.cpp}
+ dg::blas2::symv( alpha, M, x, 0., z);
+ dg::blas1::axpby( beta, y, 1., z);
+ * @endcode
+ * but performs the matrix-vector product and the linear combination in a
+ * single pass over memory, i.e. \c y is read and \c z is written only once.
+ * This matters for bandwidth bound applications like the evaluation of
+ * derivatives in e.g. \c dg::ArakawaX
+ * @note So far this routine is only implemented for the sparse block matrix
+ * formats (i.e. the matrices created by \c dg::create::dx and friends)
+ * applied to shared memory vectors
+ * @param alpha A Scalar
+ * @param M The Matrix.
+ * @param x input vector
+ * @param beta A Scalar
+ * @param y second input vector (may alias \p z but not \p x)
+ * @param z contains the solution on output (may not alias \p x)
+ * @attention If y on input contains a NaN or Inf, then z may contain NaN or
+ * Inf on output as well even if beta is zero.
+ * @copydoc hide_matrix
+ * @copydoc hide_ContainerType
+ */
+template< class MatrixType, class ContainerType1, class ContainerType2, class ContainerType3>
+inline void symv_axpby( get_value_type<ContainerType1> alpha,
+                  MatrixType&& M,
+                  const ContainerType1& x,
+                  get_value_type<ContainerType1> beta,
+                  const ContainerType2& y,
+                  ContainerType3& z)
+{
+    if(alpha == (get_value_type<ContainerType1>)0) {
+        dg::blas1::axpby( beta, y, 0., z);
+        return;
+    }
+    dg::blas2::detail::doSymv_axpby( alpha, std::forward<MatrixType>(M), x, beta, y, z, get_tensor_category<MatrixType>());
+}
+
 /**
  * @brief \f$ f(i, x_0, x_1, ...)\ \forall i\f$; Customizable and generic for loop
  *
@@ -406,27 +599,51 @@ inline void parallel_for( Stencil f, unsigned N, ContainerType&& x, ContainerTyp
  * @endcode
  * Other matrix types have not yet been implemented.
  * @note Since the matrix is known, a communication pattern is available and thus the function works in parallel for MPI (unlike \c dg::blas2::parallel_for).
- * @note In a way this function is a generalization of \c dg::blas2::parallel_for to MPI vectors at the cost of having to encode the communication stencil in the matrix \c M and only one vector argument
+ * @note In a way this function is a generalization of \c dg::blas2::parallel_for to MPI vectors at the cost of having to encode the communication stencil in the matrix \c M in the first vector argument
+ *
+ * In addition to the stencil argument \c x an arbitrary number of further
+ * input and output vectors can be given, for example to fuse an average
+ * with a pointwise term that needs both the average and further fields:
+ * @code
+ * // one kernel: y0 = sum_k v_k x_k (the stencil average), y1 = a*(x - y0)
+ * dg::blas2::stencil( [omega]DG_DEVICE( unsigned i, const int* ro,
+ *     const int* ci, const double* va, const double* x,
+ *     const double* a, double* y0, double* y1)
+ *     {
+ *         y0[i] = 0;
+ *         for( int k=ro[i]; k<ro[i+1]; k++)
+ *             y0[i] += x[ci[k]]*va[k];
+ *         y1[i] = omega*a[i]*(x[i]-y0[i]);
+ *     }, stencil, x, a, y0, y1);
+ * @endcode
+ * @attention Only the first vector argument \c x may be indexed through the
+ * column indices of \c M (in MPI its halo is gathered before the functor
+ * runs); all further arguments are passed through unchanged and must only be
+ * accessed at the row index \c i . Coefficients can also be captured in the
+ * functor directly.
  *
- * @param f The filter function is called like <tt> f(i, m.row_offsets_ptr, m.column_indices_ptr, m.values_ptr, x_ptr, y_ptr) </tt>
+ * @param f The filter function is called like <tt> f(i, m.row_offsets_ptr, m.column_indices_ptr, m.values_ptr, x_ptr, ys_ptrs...) </tt>
  * @param M The Matrix.
- * @param x input vector
- * @param y contains the solution on output (may not alias \p x)
+ * @param x input vector, gathered through the stencil
+ * @param ys further input and/or output vectors, accessed at the row index
+ *  only (an output may not alias \p x)
  * @tparam FunctorType A type that is callable
- *  <tt> void operator()( unsigned, pointer, [m_pointers], const_pointer) </tt>  For GPU vector the functor
+ *  <tt> void operator()( unsigned, pointer, [m_pointers], const_pointer, pointers...) </tt>  For GPU vector the functor
  *  must be callable on the device.
  * @tparam MatrixType So far only one of the \c cusp::csr_matrix types and their MPI variants <tt> dg::MPIDistMat<cusp::csr_matrix, Comm> </tt> are allowed
  * @sa dg::convert, dg::CSRMedianFilter, dg::create::window_stencil
  * @copydoc hide_ContainerType
  */
-template< class FunctorType, class MatrixType, class ContainerType1, class ContainerType2>
+template< class FunctorType, class MatrixType, class ContainerType1, class ...ContainerTypes>
 inline void stencil(
                   FunctorType f,
                   MatrixType&& M,
                   const ContainerType1& x,
-                  ContainerType2& y)
+                  ContainerTypes&&... ys)
 {
-    dg::blas2::detail::doStencil( f, std::forward<MatrixType>(M), x, y, get_tensor_category<MatrixType>());
+    dg::blas2::detail::doStencil( get_tensor_category<MatrixType>(), f,
+            std::forward<MatrixType>(M), x,
+            std::forward<ContainerTypes>(ys)...);
 }
 /**
  * @brief \f$ y = x\f$; Generic way to copy and/or convert a Matrix type to a different Matrix type
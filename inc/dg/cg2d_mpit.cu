@@ -4,6 +4,8 @@
 
 #include "elliptic.h"
 #include "pcg.h"
+#include "schwarz.h"
+#include "multigrid.h"
 
 #include "backend/mpi_init.h"
 
@@ -64,6 +66,41 @@ int main( int argc, char* argv[])
     if(rank==0)std::cout << "L2 Norm of Residuum is        " << res.d<<"\t"<<res.i << std::endl;
     //Fehler der Integration des Sinus ist vernachlässigbar (vgl. evaluation_t)
 
+    if( rank == 0) std::cout << "Create additive Schwarz preconditioner\n";
+    dg::Elliptic<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> A_loc( grid.local());
+    dg::AdditiveSchwarz<decltype(A_loc), dg::DVec> ras( A_loc, A_loc.precond(),
+        A_loc.weights(), 1000, 0.1);
+    dg::blas1::copy( 0., x);
+    number = pcg.solve( A, x, b, ras, w2d, eps);
+    if( rank == 0)
+    {
+        std::cout << "# of Schwarz pcg iterations "<<number<<std::endl;
+        std::cout << "... for a precision of      "<< eps<<std::endl;
+    }
+    dg::blas1::copy( solution, error);
+    dg::blas1::axpby( 1., x,-1., error);
+    res.d = sqrt(dg::blas2::dot(w2d , error));
+    if(rank==0)std::cout << "L2 Norm of Error is           " << res.d<<"\t"<<res.i << std::endl;
+
+    if( rank == 0) std::cout << "Agglomerate onto a single rank and solve there\n";
+    dg::Agglomeration<dg::iDVec, dg::DVec> agg( grid);
+    dg::CartesianGrid2d g_glob( grid.global());
+    dg::Elliptic<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> A_glob( g_glob);
+    dg::PCG<dg::DVec> pcg_glob( agg.global_copyable(), n*n*Nx*Ny);
+    dg::blas1::copy( 0., x);
+    agg.solve( [&]( const auto& bg, auto& xg){
+        number = pcg_glob.solve( A_glob, xg, bg, A_glob.precond(),
+            A_glob.weights(), eps);}, x, b);
+    if( rank == 0)
+    {
+        std::cout << "# of agglomerated pcg iterations "<<number<<std::endl;
+        std::cout << "... for a precision of           "<< eps<<std::endl;
+    }
+    dg::blas1::copy( solution, error);
+    dg::blas1::axpby( 1., x,-1., error);
+    res.d = sqrt(dg::blas2::dot(w2d , error));
+    if(rank==0)std::cout << "L2 Norm of Error is           " << res.d<<"\t"<<res.i << std::endl;
+
     MPI_Finalize();
     return 0;
 }
@@ -7,6 +7,7 @@
 #include "lgmres.h"
 #include "elliptic.h"
 #include "chebyshev.h"
+#include "precond.h"
 
 const double lx = 2.*M_PI;
 const double ly = 2.*M_PI;
@@ -54,6 +55,35 @@ void solve( std::string solver, Matrix& A, Container& x, const Container& b, con
         cheby.solve( A, x, b, A.precond(), lmin, lmax/2., num_iter);
         std::cout << "After "<<num_iter<<" Chebyshev iterations we have:\n";
     }
+    if( "device pcg" == solver)
+    {
+        std::cout <<" DEVICE PCG SOLVER:\n";
+        dg::DevicePCG<Container> dpcg( x, 10000);
+        unsigned num_iter = dpcg.solve( A, x, b, A.precond(), A.weights(), 1e-6, 1, 10);
+        std::cout << "After "<<num_iter<<" DevicePCG iterations we have:\n";
+    }
+    if( "block jacobi pcg" == solver)
+    {
+        std::cout <<" BLOCK JACOBI PCG SOLVER:\n";
+        auto bj = dg::create::block_jacobi<Container>( A, grid);
+        dg::PCG<Container> pcg( x, 10000);
+        unsigned num_iter = pcg.solve( A, x, b, bj, A.weights(), 1e-6);
+        std::cout << "After "<<num_iter<<" block Jacobi PCG iterations we have:\n";
+    }
+    if( "block gauss seidel" == solver)
+    {
+        std::cout <<" BLOCK GAUSS-SEIDEL SMOOTHER:\n";
+        dg::BlockGaussSeidel<Matrix&, Container> gs( A, grid, 100);
+        dg::blas2::symv( gs, b, x);
+        std::cout << "After "<<gs.get_num_sweeps()<<" colored Gauss-Seidel sweeps we have:\n";
+    }
+    if( "cheby pcg" == solver)
+    {
+        std::cout <<" CHEBYSHEV PCG SOLVER:\n";
+        dg::ChebyshevPCG<Container> cpcg( x, 10000);
+        unsigned num_iter = cpcg.solve( A, x, b, A.precond(), A.weights(), 1e-6);
+        std::cout << "After "<<num_iter<<" CG iterations with a degree "<<cpcg.get_degree()<<" polynomial we have:\n";
+    }
     if( "bicgstabl" == solver)
     {
         std::cout <<" BICGSTABl SOLVER:\n";
@@ -68,6 +98,24 @@ void solve( std::string solver, Matrix& A, Container& x, const Container& b, con
         unsigned num_iter = lgmres.solve( A, x, b, A.precond(), A.weights(), 1e-6);
         std::cout << "After "<<num_iter<<" LGMRES iterations we have:\n";
     }
+    if( "block pcg" == solver)
+    {
+        std::cout <<" BLOCK PCG SOLVER:\n";
+        //solve for two right hand sides at once in a common Krylov space
+        std::vector<Container> xs( 2, x), bs( 2, b);
+        //an independent second right hand side (solution sin(2x)sin(2y))
+        dg::assign( dg::evaluate( []( double x, double y){
+            return 8.*sin(2.*x)*sin(2.*y);}, grid), bs[1]);
+        dg::BlockPCG<Container> bpcg( x, 2, 10000);
+        unsigned num_iter = bpcg.solve( A, xs, bs, A.precond(), A.weights(), 1e-6);
+        Container res( b);
+        dg::blas2::symv( A, xs[1], res);
+        dg::blas1::axpby( 1., bs[1], -1., res);
+        std::cout << "Residual norm of second column "
+                  << sqrt( dg::blas2::dot( A.weights(), res)) <<"\n";
+        dg::blas1::copy( xs[0], x);
+        std::cout << "After "<<num_iter<<" BlockPCG iterations we have:\n";
+    }
 
 }
 
@@ -125,7 +173,7 @@ int main()
     std::cout << "L2 Norm of Residuum is        " << res.d<<"\t"<<res.i << std::endl<<std::endl;
     //Fehler der Integration des Sinus ist vernachlässigbar (vgl. evaluation_t)
 
-    std::vector<std::string> solvers{ "eve cg", "eve pcg", "cheby", "P cheby", "bicgstabl", "lgmres"};
+    std::vector<std::string> solvers{ "eve cg", "eve pcg", "cheby", "P cheby", "device pcg", "block jacobi pcg", "block gauss seidel", "cheby pcg", "bicgstabl", "lgmres", "block pcg"};
     for(auto solver : solvers)
     {
         dg::blas1::copy( 0., x);
@@ -147,6 +195,45 @@ int main()
         std::cout << "L2 Norm of Residuum is        " << res.d<<"\n\n";
     }
 
+    std::cout <<" MIXED PRECISION REFINED PCG SOLVER:\n";
+    dg::Elliptic<dg::CartesianGrid2d, dg::fHMatrix, dg::fHVec> A_f( grid);
+    dg::RefinedPCG<dg::HVec, dg::fHVec> refined( copyable_vector, max_iter);
+    dg::blas1::copy( 0., x);
+    num_iter = refined.solve( A, A_f, x, b, A_f.precond(), w2d, A_f.weights(), 1e-10);
+    std::cout << "After "<<num_iter<<" reduced precision iterations we have:\n";
+    dg::blas1::copy( solution, error);
+    dg::blas1::axpby( 1.,x,-1.,error);
+    dg::blas1::copy( b, resi);
+    dg::blas2::symv(  A, x, Ax);
+    dg::blas1::axpby( 1.,Ax,-1.,resi);
+    res.d = sqrt(dg::blas2::dot(w2d , error));
+    std::cout << "L2 Norm of Error is           " << res.d<<"\n";
+    res.d = sqrt(dg::blas2::dot( w2d, resi));
+    std::cout << "L2 Norm of Residuum is        " << res.d<<"\n\n";
+
+    std::cout <<" CONVERGENCE HISTORY:\n";
+    dg::ConvergenceHistory history;
+    pcg.set_history( &history);
+    dg::blas1::copy( 0., x);
+    pcg.solve( A, x, b, 1., w2d, eps);
+    dg::blas1::copy( 0., x);
+    pcg.solve( A, x, b, A.precond(), w2d, eps);
+    std::cout << "Last solve: "<<history.last_iterations()<<" iterations, "
+              << history.last_matvecs()<<" matvecs, reduction factor "
+              << history.reduction()<<", converged "<<history.converged()<<"\n";
+    history.display( std::cout);
+
+    std::cout <<" EIGENVALUE MONITOR:\n";
+    pcg.set_history( nullptr);
+    pcg.set_eigenvalue_monitor( true);
+    dg::blas1::copy( 0., x);
+    num_iter = pcg.solve( A, x, b, 1., w2d, 1e-10);
+    //same reference eigenvalues of Laplace as in the EVE test above
+    std::cout << "L_min     "<<1+1<<" L_max     "<<2*grid.size()<<"\n";
+    std::cout << "Min EV estimate "<<pcg.min_eigenvalue()
+              << " Max EV estimate "<<pcg.max_eigenvalue()
+              << " after "<<num_iter<<" iterations\n";
+    std::cout << "Condition estimate "<<pcg.condition_number()<<"\n";
 
     return 0;
 }
@@ -40,7 +40,10 @@ typedef dg::MDVec Vector;
 /*******************************************************************************
 program expects npx, npy, npz, n, Nx, Ny, Nz from std::cin
 outputs one line to std::cout
-# npx npy npz #procs #threads n Nx Ny Nz t_SCAL t_AXPBY t_POINTWISEDOT t_DOT t_DX_per t_DY_per t_DZ_per t_ARAKAWA #iterations t_1xELLIPTIC_CG_dir_centered t_DS EXBLASCHECK( d and i)
+# npx npy npz #procs #threads n Nx Ny Nz t_SCAL t_AXPBY t_POINTWISEDOT t_DOT t_DX_per t_DY_per t_DZ_per t_ARAKAWA #iterations t_1xELLIPTIC_CG_dir_centered J_1xELLIPTIC_CG t_DS EXBLASCHECK( d and i) J_total
+J_1xELLIPTIC_CG and J_total are the Joule consumed by one CG iteration and
+the whole benchmark summed over all nodes and GPUs (0.0 unless energy
+counters are available, see dg::EnergyMeter)
 if Nz == 1, DZ and DS are not executed
 if std::exception is thrown program writes error to std::cerr and terminates
 Run with:
@@ -83,6 +86,8 @@ int main(int argc, char* argv[])
     if( Nz > 2) lz = 2.*M_PI;
     dg::CylindricalMPIGrid3d gridEll( R_0, R_0+lx, 0., ly, 0.,lz, n, Nx, Ny,Nz, dg::DIR, dg::DIR, dg::PER, commEll);
     dg::Timer t;
+    dg::EnergyMeter joule, joule_total;
+    joule_total.tic();
     Vector w3d, lhs, rhs, jac, x, y, z;
     try{
         dg::assign( dg::create::weights( grid), w3d);
@@ -182,10 +187,14 @@ int main(int argc, char* argv[])
         x = dg::evaluate( initial, gridEll);
         const Vector b = dg::evaluate ( laplace_fct, gridEll);
         dg::PCG< Vector > pcg( x, 1000);
+        joule.tic();
         t.tic();
         unsigned number = pcg.solve(laplace, x, b, 1., ellw3d, 1e-6);
         t.toc();
-        if(rank==0)std::cout <<" "<< number << " "<<t.diff()/(double)number<<std::flush;
+        joule.toc();
+        double J_CG = joule.diff( comm)/(double)number; //collective
+        if(rank==0)std::cout <<" "<< number << " "<<t.diff()/(double)number
+                             <<" "<<J_CG<<std::flush;
         dg::blas1::axpby( 1., solution, -1., x);
         //for missing DS
         if(rank==0)std::cout<<" 0.0";
@@ -200,10 +209,14 @@ int main(int argc, char* argv[])
         x = dg::evaluate( initial, gridEll);
         const Vector b = dg::evaluate ( laplace_fct3d, gridEll);
         dg::PCG< Vector > pcg( x, multi);
+        joule.tic();
         t.tic();
         unsigned number = pcg.solve(laplace, x, b, 1., ellw3d, 1e-6);
         t.toc();
-        if(rank==0)std::cout <<" "<< number << " "<<t.diff()/(double)number<<std::flush;
+        joule.toc();
+        double J_CG = joule.diff( comm)/(double)number; //collective
+        if(rank==0)std::cout <<" "<< number << " "<<t.diff()/(double)number
+                             <<" "<<J_CG<<std::flush;
         dg::blas1::axpby( 1., solution, -1., x);
         res.d = dg::blas2::dot( x, ellw3d, x);
         //Application of ds
@@ -226,6 +239,9 @@ int main(int argc, char* argv[])
         if(rank==0)std::cout<<" "<<t.diff()/(double)multi;
     }
     if(rank==0)std::cout << " "<<res.d<< " "<<res.i;
+    joule_total.toc();
+    double J_total = joule_total.diff( comm); //collective
+    if(rank==0)std::cout << " "<<J_total;
 
     } catch( std::exception& e) {
         if(rank==0)std::cout << std::endl;
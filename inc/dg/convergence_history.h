@@ -0,0 +1,139 @@
+#ifndef _DG_CONVERGENCE_HISTORY_
+#define _DG_CONVERGENCE_HISTORY_
+
+#include <cmath>
+#include <vector>
+#include <iostream>
+#include "backend/timer.h"
+
+/*!@file
+ * Convergence telemetry for iterative solvers
+ */
+
+namespace dg{
+
+/**
+ * @brief Structured convergence telemetry for Krylov solvers
+ *
+ * Collects per-iteration residuals, matrix-vector and preconditioner
+ * application counts and the wall-clock time of each solve, and aggregates
+ * them across all solves of a run. Attach an instance to a solver with its
+ * \c set_history method:
+ * @code
+ * dg::ConvergenceHistory history;
+ * pcg.set_history( &history);
+ * pcg.solve( A, x, b, P, W, eps);
+ * std::cout << "Converged in "<<history.last_time()<<"s with reduction "
+ *           << history.reduction()<<" per iteration\n";
+ * // ... many solves later
+ * history.display( std::cout);
+ * @endcode
+ * The per-iteration residuals are the same quantities the solvers print in
+ * their verbose mode (for dg::PCG \f$ \sqrt{r^TWr}\f$, for dg::LGMRES and
+ * dg::BICGSTABl the preconditioned residual norm) and are written into a
+ * reusable buffer that is overwritten by each solve. A growing average
+ * reduction factor at fixed problem and tolerance indicates preconditioner
+ * degradation.
+ * @note the telemetry calls cost nothing beyond what the solvers compute
+ * anyway; in particular no additional scalar products are performed
+ * @ingroup invert
+ */
+struct ConvergenceHistory
+{
+    ///@brief Begin a new solve (called by the solvers, resets the residual buffer)
+    ///@param nrmb the norm of the right hand side
+    ///@param tol the absolute tolerance of the solve
+    void begin_solve( double nrmb, double tol){
+        m_res.clear();
+        m_nrmb = nrmb, m_tol = tol;
+        m_last_matvecs = m_last_precs = 0;
+        m_timer.tic();
+    }
+    ///@brief Record a residual (called by the solvers once per iteration)
+    void residual( double res){ m_res.push_back( res);}
+    ///@brief Record matrix-vector applications (called by the solvers)
+    void matvec( unsigned num = 1){ m_last_matvecs += num;}
+    ///@brief Record preconditioner applications (called by the solvers)
+    void precond( unsigned num = 1){ m_last_precs += num;}
+    ///@brief End the current solve and update the aggregate counters (called by the solvers)
+    ///@param iterations the iteration count the solve returns
+    ///@param converged false if the solver hit its iteration limit
+    void end_solve( unsigned iterations, bool converged){
+        m_timer.toc();
+        m_last_time = m_timer.diff();
+        m_last_iter = iterations;
+        m_converged = converged;
+        m_solves ++;
+        if( !converged)
+            m_fails ++;
+        m_iter += iterations;
+        m_matvecs += m_last_matvecs;
+        m_precs += m_last_precs;
+        m_time += m_last_time;
+    }
+
+    ///@brief Per-iteration residuals of the last solve
+    const std::vector<double>& residuals() const{ return m_res;}
+    ///@brief Norm of the right hand side of the last solve
+    double nrmb() const{ return m_nrmb;}
+    ///@brief Absolute tolerance of the last solve
+    double tol() const{ return m_tol;}
+    ///@brief Wall-clock duration of the last solve in seconds
+    double last_time() const{ return m_last_time;}
+    ///@brief Iteration count of the last solve
+    unsigned last_iterations() const{ return m_last_iter;}
+    ///@brief Matrix-vector applications of the last solve
+    unsigned last_matvecs() const{ return m_last_matvecs;}
+    ///@brief Preconditioner applications of the last solve
+    unsigned last_precs() const{ return m_last_precs;}
+    ///@brief If the last solve converged or not
+    bool converged() const{ return m_converged;}
+    /**
+     * @brief Average residual reduction factor per iteration of the last solve
+     *
+     * The geometric mean \f$ (r_N/r_0)^{1/N}\f$ over the recorded residuals;
+     * returns 0 if fewer than two residuals were recorded
+     */
+    double reduction() const{
+        if( m_res.size() < 2 || m_res.front() == 0)
+            return 0;
+        return pow( m_res.back()/m_res.front(),
+                1./(double)(m_res.size()-1));
+    }
+
+    ///@brief Number of solves since construction or \c clear
+    unsigned solves() const{ return m_solves;}
+    ///@brief Number of solves that did not converge
+    unsigned fails() const{ return m_fails;}
+    ///@brief Total number of iterations over all solves
+    unsigned iterations() const{ return m_iter;}
+    ///@brief Total number of matrix-vector applications over all solves
+    unsigned matvecs() const{ return m_matvecs;}
+    ///@brief Total number of preconditioner applications over all solves
+    unsigned precs() const{ return m_precs;}
+    ///@brief Total wall-clock time spent in solves in seconds
+    double time() const{ return m_time;}
+
+    ///@brief Write a short aggregate report
+    ///@param os the stream to write to
+    void display( std::ostream& os = std::cout) const{
+        os << "# Solves "<<m_solves<<" (failed "<<m_fails<<")"
+           <<" iterations "<<m_iter<<" matvecs "<<m_matvecs
+           <<" precond "<<m_precs<<" time "<<m_time<<"s";
+        if( m_solves > 0)
+            os <<" ("<<m_iter/(double)m_solves<<" iterations/solve)";
+        os << "\n";
+    }
+    ///@brief Reset all aggregate counters and the residual buffer
+    void clear(){ *this = ConvergenceHistory();}
+  private:
+    std::vector<double> m_res;
+    Timer m_timer;
+    double m_nrmb = 0, m_tol = 0, m_last_time = 0, m_time = 0;
+    unsigned m_last_iter = 0, m_last_matvecs = 0, m_last_precs = 0;
+    unsigned m_solves = 0, m_fails = 0, m_iter = 0, m_matvecs = 0, m_precs = 0;
+    bool m_converged = true;
+};
+
+}//namespace dg
+#endif //_DG_CONVERGENCE_HISTORY_
@@ -23,6 +23,220 @@ namespace dg
 // projection tensors as Chi) geometry_elliptic_b, geometry_elliptic_mpib,
 // and geometryX_elliptic_b and geometryX_refined_elliptic_b
 
+///@cond
+namespace detail
+{
+// The EllSparseBlockMatView machinery lives in backend/blas2_sparseblockmat.h
+
+//Fused evaluation of the 2d elliptic operator in two kernels: the first
+//evaluates the gradient and the chi tensor multiply, the second the
+//divergence, the jump terms and the volume division, keeping all
+//intermediate values in registers
+template<class value_type, class ContainerType0, class ContainerType1, class Container>
+void fused_elliptic2d_symv( value_type alpha, const ContainerType0& x,
+    value_type beta, ContainerType1& y,
+    const EllSparseBlockMatView<value_type>& rx, const EllSparseBlockMatView<value_type>& ry,
+    const EllSparseBlockMatView<value_type>& lx, const EllSparseBlockMatView<value_type>& ly,
+    const EllSparseBlockMatView<value_type>& jumpx, const EllSparseBlockMatView<value_type>& jumpy,
+    const Container& sigma, const SparseTensor<Container>& chi,
+    const Container& vol, Container& tempx, Container& tempy,
+    value_type jfactor, bool chi_weight_jump)
+{
+    unsigned size = vol.size();
+    dg::blas2::parallel_for( [rx,ry]DG_DEVICE( unsigned i, const value_type* xx,
+        const value_type* ss, const value_type* c00, const value_type* c01,
+        const value_type* c10, const value_type* c11,
+        value_type* tx, value_type* ty)
+        {
+            value_type gx = rx( xx, i), gy = ry( xx, i);
+            tx[i] = ss[i]*DG_FMA( c00[i], gx, c01[i]*gy);
+            ty[i] = ss[i]*DG_FMA( c10[i], gx, c11[i]*gy);
+        }, size, x, sigma, chi.value(0,0), chi.value(0,1), chi.value(1,0),
+        chi.value(1,1), tempx, tempy);
+    dg::blas2::parallel_for( [lx,ly,jumpx,jumpy,jfactor,chi_weight_jump,alpha,beta]
+        DG_DEVICE( unsigned i, const value_type* xx,
+        const value_type* tx, const value_type* ty,
+        const value_type* ss, const value_type* c00, const value_type* c01,
+        const value_type* c10, const value_type* c11,
+        const value_type* vv, value_type* yy)
+        {
+            value_type temp = -lx( tx, i) - ly( ty, i);
+            if( 0 != jfactor)
+            {
+                value_type jx = jfactor*jumpx( xx, i), jy = jfactor*jumpy( xx, i);
+                if( chi_weight_jump)
+                    temp += ss[i]*( DG_FMA( c00[i], jx, c01[i]*jy)
+                                  + DG_FMA( c10[i], jx, c11[i]*jy));
+                else
+                    temp += jx + jy;
+            }
+            if( 0 == beta)
+                yy[i] = alpha*temp/vv[i];
+            else
+                yy[i] = DG_FMA( alpha, temp/vv[i], beta*yy[i]);
+        }, size, x, tempx, tempy, sigma, chi.value(0,0), chi.value(0,1),
+        chi.value(1,0), chi.value(1,1), vol, y);
+}
+//Fused evaluation of the 1d elliptic operator, same idea as the 2d version:
+//the jump term is evaluated inside the divergence kernel so no separate
+//pass over x and y is needed
+template<class value_type, class ContainerType0, class ContainerType1, class Container>
+void fused_elliptic1d_symv( value_type alpha, const ContainerType0& x,
+    value_type beta, ContainerType1& y,
+    const EllSparseBlockMatView<value_type>& rx,
+    const EllSparseBlockMatView<value_type>& lx,
+    const EllSparseBlockMatView<value_type>& jumpx,
+    const Container& sigma, Container& tempx, value_type jfactor)
+{
+    unsigned size = sigma.size();
+    dg::blas2::parallel_for( [rx]DG_DEVICE( unsigned i, const value_type* xx,
+        const value_type* ss, value_type* tx)
+        {
+            tx[i] = ss[i]*rx( xx, i);
+        }, size, x, sigma, tempx);
+    dg::blas2::parallel_for( [lx,jumpx,jfactor,alpha,beta]
+        DG_DEVICE( unsigned i, const value_type* xx, const value_type* tx,
+        value_type* yy)
+        {
+            value_type temp = -lx( tx, i);
+            if( 0 != jfactor)
+                temp = DG_FMA( jfactor, jumpx( xx, i), temp);
+            if( 0 == beta)
+                yy[i] = alpha*temp;
+            else
+                yy[i] = DG_FMA( alpha, temp, beta*yy[i]);
+        }, size, x, tempx, y);
+}
+//Fused evaluation of the 3d elliptic operator with optional cache blocking
+//along the z-planes: the gradient/chi-multiply kernel and the perpendicular
+//divergence/jump kernel run back to back on a few planes at a time so that
+//the intermediate flux vectors of the block stay cache resident on CPU
+//backends (block_planes == 0 processes the whole volume in one chunk).
+//Only the z part of the divergence couples neighbouring planes, so it is
+//deferred to a final full-volume pass together with the volume division.
+template<class value_type, class ContainerType0, class ContainerType1, class Container>
+void fused_elliptic3d_symv( value_type alpha, const ContainerType0& x,
+    value_type beta, ContainerType1& y,
+    const EllSparseBlockMatView<value_type>& rx, const EllSparseBlockMatView<value_type>& ry,
+    const EllSparseBlockMatView<value_type>& rz,
+    const EllSparseBlockMatView<value_type>& lx, const EllSparseBlockMatView<value_type>& ly,
+    const EllSparseBlockMatView<value_type>& lz,
+    const EllSparseBlockMatView<value_type>& jumpx, const EllSparseBlockMatView<value_type>& jumpy,
+    const EllSparseBlockMatView<value_type>& jumpz,
+    const Container& sigma, const SparseTensor<Container>& chi,
+    const Container& vol, Container& tempx, Container& tempy, Container& tempz,
+    Container& temp, value_type jfactor, bool chi_weight_jump, bool addJumpZ,
+    bool multiplyZ, unsigned size2d, unsigned block_planes)
+{
+    unsigned size = vol.size();
+    unsigned chunk = block_planes == 0 ? size : block_planes*size2d;
+    for( unsigned off=0; off<size; off+=chunk)
+    {
+        unsigned len = chunk < size-off ? chunk : size-off;
+        dg::blas2::parallel_for( [rx,ry,rz,multiplyZ,off]DG_DEVICE(
+            unsigned i, const value_type* xx, const value_type* ss,
+            const value_type* c00, const value_type* c01, const value_type* c02,
+            const value_type* c10, const value_type* c11, const value_type* c12,
+            const value_type* c20, const value_type* c21, const value_type* c22,
+            value_type* tx, value_type* ty, value_type* tz)
+            {
+                unsigned I = i + off;
+                value_type gx = rx( xx, I), gy = ry( xx, I);
+                if( multiplyZ)
+                {
+                    value_type gz = rz( xx, I);
+                    tx[I] = ss[I]*DG_FMA( c00[I], gx, DG_FMA( c01[I], gy, c02[I]*gz));
+                    ty[I] = ss[I]*DG_FMA( c10[I], gx, DG_FMA( c11[I], gy, c12[I]*gz));
+                    tz[I] = ss[I]*DG_FMA( c20[I], gx, DG_FMA( c21[I], gy, c22[I]*gz));
+                }
+                else
+                {
+                    tx[I] = ss[I]*DG_FMA( c00[I], gx, c01[I]*gy);
+                    ty[I] = ss[I]*DG_FMA( c10[I], gx, c11[I]*gy);
+                }
+            }, len, x, sigma, chi.value(0,0), chi.value(0,1), chi.value(0,2),
+            chi.value(1,0), chi.value(1,1), chi.value(1,2), chi.value(2,0),
+            chi.value(2,1), chi.value(2,2), tempx, tempy, tempz);
+        dg::blas2::parallel_for( [lx,ly,jumpx,jumpy,jumpz,jfactor,
+            chi_weight_jump,addJumpZ,off]DG_DEVICE(
+            unsigned i, const value_type* xx,
+            const value_type* tx, const value_type* ty, const value_type* ss,
+            const value_type* c00, const value_type* c01, const value_type* c02,
+            const value_type* c10, const value_type* c11, const value_type* c12,
+            const value_type* c20, const value_type* c21, const value_type* c22,
+            value_type* tt)
+            {
+                unsigned I = i + off;
+                value_type tmp = -lx( tx, I) - ly( ty, I);
+                if( 0 != jfactor)
+                {
+                    value_type jx = jfactor*jumpx( xx, I), jy = jfactor*jumpy( xx, I);
+                    if( chi_weight_jump)
+                    {
+                        if( addJumpZ)
+                        {
+                            value_type jz = jfactor*jumpz( xx, I);
+                            tmp += ss[I]*(
+                                  DG_FMA( c00[I], jx, DG_FMA( c01[I], jy, c02[I]*jz))
+                                + DG_FMA( c10[I], jx, DG_FMA( c11[I], jy, c12[I]*jz))
+                                + DG_FMA( c20[I], jx, DG_FMA( c21[I], jy, c22[I]*jz)));
+                        }
+                        else
+                            tmp += ss[I]*( DG_FMA( c00[I], jx, c01[I]*jy)
+                                         + DG_FMA( c10[I], jx, c11[I]*jy));
+                    }
+                    else
+                        tmp += jx + jy; //non-weighted jz in the final pass
+                }
+                tt[I] = tmp;
+            }, len, x, tempx, tempy, sigma, chi.value(0,0), chi.value(0,1),
+            chi.value(0,2), chi.value(1,0), chi.value(1,1), chi.value(1,2),
+            chi.value(2,0), chi.value(2,1), chi.value(2,2), temp);
+    }
+    dg::blas2::parallel_for( [lz,jumpz,jfactor,chi_weight_jump,addJumpZ,
+        multiplyZ,alpha,beta]DG_DEVICE( unsigned i, const value_type* xx,
+        const value_type* tz, const value_type* tt, const value_type* vv,
+        value_type* yy)
+        {
+            value_type tmp = tt[i];
+            if( multiplyZ)
+                tmp -= lz( tz, i);
+            if( 0 != jfactor && addJumpZ && !chi_weight_jump)
+                tmp = DG_FMA( jfactor, jumpz( xx, i), tmp);
+            if( 0 == beta)
+                yy[i] = alpha*tmp/vv[i];
+            else
+                yy[i] = DG_FMA( alpha, tmp/vv[i], beta*yy[i]);
+        }, size, x, tempz, temp, vol, y);
+}
+//Gate an incremental set_chi update: counts calls for the lagged chi option
+//and measures the maximum relative pointwise change of sigma since the last
+//accepted update with a single fused reduction. Returns true if the rebuild
+//of the sigma products can be skipped. sigma_old must be allocated by the
+//caller, valid marks whether it holds an accepted update.
+template<class ContainerType0, class Container, class value_type>
+bool lag_chi_update( const ContainerType0& sigma, Container& sigma_old,
+    bool& valid, value_type tol, unsigned lag, unsigned& counter)
+{
+    if( lag > 1 && (counter++ % lag) != 0)
+        return true;
+    if( tol <= 0)
+        return false;
+    if( valid)
+    {
+        value_type change = dg::blas1::reduce( sigma, sigma_old,
+            (value_type)0, thrust::maximum<value_type>(),
+            []DG_DEVICE( value_type nn, value_type oo){
+                return fabs(nn-oo)/(1.+fabs(oo)); });
+        if( change < tol)
+            return true;
+    }
+    dg::blas1::copy( sigma, sigma_old);
+    valid = true;
+    return false;
+}
+}//namespace detail
+///@endcond
 
 /*!
  * @class hide_note_jump
@@ -131,6 +345,9 @@ class Elliptic1d
     template<class ContainerType0>
     void set_chi( const ContainerType0& sigma)
     {
+        if( detail::lag_chi_update( sigma, m_sigma_old, m_chi_valid,
+                m_chi_tol, m_chi_lag, m_chi_counter))
+            return;
         dg::blas1::copy( sigma, m_sigma);
         //update preconditioner
         dg::blas1::pointwiseDivide( 1., sigma, m_precond);
@@ -138,6 +355,22 @@ class Elliptic1d
         // it is important to call this blas1 function because it can
         // overwrite NaN in m_precond in the next update
     }
+    ///@copydoc Elliptic2d::set_chi_tolerance()
+    void set_chi_tolerance( value_type tol)
+    {
+        m_chi_tol = tol;
+        if( tol > 0 && m_sigma_old.size() != m_sigma.size())
+        {
+            m_sigma_old = m_sigma;
+            m_chi_valid = false;
+        }
+    }
+    ///@copydoc Elliptic2d::set_chi_lag()
+    void set_chi_lag( unsigned lag)
+    {
+        m_chi_lag = lag == 0 ? 1 : lag;
+        m_chi_counter = 0;
+    }
 
     /**
      * @brief Return the weights making the operator self-adjoint
@@ -175,6 +408,20 @@ class Elliptic1d
     ///@copydoc Elliptic2d::symv(value_type,const ContainerType0&,value_type,ContainerType1&)
     template<class ContainerType0, class ContainerType1>
     void symv( value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
+    {
+        do_symv( typename detail::is_ell_matrix<Matrix>::type(), alpha, x, beta, y);
+    }
+
+    private:
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( std::true_type, value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
+    {
+        detail::fused_elliptic1d_symv( alpha, x, beta, y,
+            detail::make_ell_view( m_rightx), detail::make_ell_view( m_leftx),
+            detail::make_ell_view( m_jumpX), m_sigma, m_tempx, m_jfactor);
+    }
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( std::false_type, value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
     {
         dg::blas2::gemv( m_rightx, x, m_tempx);
         dg::blas1::pointwiseDot( m_tempx, m_sigma, m_tempx);
@@ -185,12 +432,13 @@ class Elliptic1d
             dg::blas2::symv( m_jfactor*alpha, m_jumpX, x, 1., y);
         }
     }
-
-    private:
     Matrix m_leftx, m_rightx, m_jumpX;
     Container m_weights, m_precond;
     Container m_tempx;
-    Container m_sigma;
+    Container m_sigma, m_sigma_old;
+    value_type m_chi_tol = 0.;
+    unsigned m_chi_lag = 1, m_chi_counter = 0;
+    bool m_chi_valid = false;
     value_type m_jfactor;
 };
 
@@ -310,6 +558,9 @@ class Elliptic2d
     template<class ContainerType0>
     void set_chi( const ContainerType0& sigma)
     {
+        if( detail::lag_chi_update( sigma, m_sigma_old, m_chi_valid,
+                m_chi_tol, m_chi_lag, m_chi_counter))
+            return;
         dg::blas1::pointwiseDot( sigma, m_vol, m_sigma);
         //update preconditioner
         dg::blas1::pointwiseDivide( 1., sigma, m_precond);
@@ -335,6 +586,41 @@ class Elliptic2d
     {
         m_chi = SparseTensor<Container>(tau);
     }
+    /**
+     * @brief Only rebuild the sigma products when sigma changed notably
+     *
+     * If \c tol is greater than zero, \c set_chi measures the maximum
+     * relative pointwise change of \c sigma with respect to the last
+     * accepted update (with a single fused \c dg::blas1::reduce) and
+     * rebuilds the sigma products and the preconditioner only if the change
+     * exceeds \c tol. This saves the rebuild passes in timesteppers that
+     * call \c set_chi in every step even though chi evolves only slowly.
+     * @param tol relative tolerance (0, the default, rebuilds on every call)
+     */
+    void set_chi_tolerance( value_type tol)
+    {
+        m_chi_tol = tol;
+        if( tol > 0 && m_sigma_old.size() != m_sigma.size())
+        {
+            m_sigma_old = m_sigma;
+            m_chi_valid = false;
+        }
+    }
+    /**
+     * @brief Lag updates of the scalar part of chi
+     *
+     * Only every \c lag-th call to \c set_chi is applied, the remaining
+     * calls return immediately. On the coarse stages of a multigrid
+     * hierarchy chi can be lagged aggressively without affecting the fine
+     * grid solution.
+     * @param lag apply only every \c lag-th update (1, the default, applies
+     * every call)
+     */
+    void set_chi_lag( unsigned lag)
+    {
+        m_chi_lag = lag == 0 ? 1 : lag;
+        m_chi_counter = 0;
+    }
 
     /**
      * @brief Return the weights making the operator self-adjoint
@@ -410,9 +696,34 @@ class Elliptic2d
      * @param beta a scalar
      * @param y result
      * @tparam ContainerTypes must be usable with \c Container in \ref dispatch
+     * @note If \c Matrix is a \c dg::EllSparseBlockMat or its device
+     * version (which it is for all shared memory vector classes if
+     * constructed from a \c dg::aGeometry2d) the whole operator is evaluated
+     * in just two fused kernels: the first computes the gradient together
+     * with the chi tensor multiply, the second the divergence together with
+     * the jump terms and the volume division. This saves roughly half the
+     * global memory traffic compared to the chain of individual blas2 calls,
+     * which pays off since this operator is applied in every iteration of a
+     * conjugate gradient solver.
      */
     template<class ContainerType0, class ContainerType1>
     void symv( value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
+    {
+        do_symv( typename detail::is_ell_matrix<Matrix>::type(), alpha, x, beta, y);
+    }
+    private:
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( std::true_type, value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
+    {
+        detail::fused_elliptic2d_symv( alpha, x, beta, y,
+            detail::make_ell_view( m_rightx), detail::make_ell_view( m_righty),
+            detail::make_ell_view( m_leftx), detail::make_ell_view( m_lefty),
+            detail::make_ell_view( m_jumpX), detail::make_ell_view( m_jumpY),
+            m_sigma, m_chi, m_vol, m_tempx, m_tempy,
+            m_jfactor, m_chi_weight_jump);
+    }
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( std::false_type, value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
     {
         //compute gradient
         dg::blas2::gemv( m_rightx, x, m_tempx); //R_x*f
@@ -432,8 +743,8 @@ class Elliptic2d
             {
                 dg::blas2::symv( m_jfactor, m_jumpX, x, 0., m_tempx);
                 dg::blas2::symv( m_jfactor, m_jumpY, x, 0., m_tempy);
-                dg::tensor::multiply2d(m_sigma, m_chi, m_tempx, m_tempy, 0., m_tempx, m_tempy);
-                dg::blas1::axpbypgz(1.0,m_tempx,1.0,m_tempy,1.0,m_temp);
+                //fused contraction and accumulation
+                dg::tensor::multiply_sum2d( 1., m_sigma, m_chi, m_tempx, m_tempy, 1., m_temp);
             }
             else
             {
@@ -443,6 +754,7 @@ class Elliptic2d
         }
         dg::blas1::pointwiseDivide( alpha, m_temp, m_vol, beta, y);
     }
+    public:
 
     /**
      * @brief \f$ \sigma = (\nabla\phi\cdot\tau\cdot\nabla \phi) \f$
@@ -494,9 +806,12 @@ class Elliptic2d
     Container m_weights, m_precond;
     Container m_tempx, m_tempy, m_temp;
     SparseTensor<Container> m_chi;
-    Container m_sigma, m_vol;
+    Container m_sigma, m_vol, m_sigma_old;
     value_type m_jfactor;
     bool m_chi_weight_jump;
+    value_type m_chi_tol = 0.;
+    unsigned m_chi_lag = 1, m_chi_counter = 0;
+    bool m_chi_valid = false;
 };
 
 ///@copydoc Elliptic2d
@@ -609,6 +924,7 @@ class Elliptic3d
         m_temp = m_tempx = m_tempy = m_tempz = m_weights;
         m_chi=g.metric();
         m_sigma = m_vol = dg::tensor::volume(m_chi);
+        m_size2d = g.nx()*g.Nx()*g.ny()*g.Ny();
     }
     ///@copydoc hide_construct
     template<class ...Params>
@@ -622,6 +938,9 @@ class Elliptic3d
     template<class ContainerType0>
     void set_chi( const ContainerType0& sigma)
     {
+        if( detail::lag_chi_update( sigma, m_sigma_old, m_chi_valid,
+                m_chi_tol, m_chi_lag, m_chi_counter))
+            return;
         dg::blas1::pointwiseDot( sigma, m_vol, m_sigma);
         //update preconditioner
         dg::blas1::pointwiseDivide( 1., sigma, m_precond);
@@ -636,6 +955,22 @@ class Elliptic3d
     {
         m_chi = SparseTensor<Container>(tau);
     }
+    ///@copydoc Elliptic2d::set_chi_tolerance()
+    void set_chi_tolerance( value_type tol)
+    {
+        m_chi_tol = tol;
+        if( tol > 0 && m_sigma_old.size() != m_sigma.size())
+        {
+            m_sigma_old = m_sigma;
+            m_chi_valid = false;
+        }
+    }
+    ///@copydoc Elliptic2d::set_chi_lag()
+    void set_chi_lag( unsigned lag)
+    {
+        m_chi_lag = lag == 0 ? 1 : lag;
+        m_chi_counter = 0;
+    }
 
     ///@copydoc Elliptic2d::weights()
     const Container& weights()const {
@@ -665,6 +1000,26 @@ class Elliptic3d
         m_multiplyZ = !compute_in_2d;
     }
 
+    /**
+     * @brief Process blocks of z-planes at a time in the symv function
+     *
+     * On CPU backends the full-volume derivative passes evict the cache
+     * between operations. With plane blocking the gradient, tensor multiply
+     * and perpendicular divergence run back to back on \c planes z-planes at
+     * a time so the intermediate flux vectors of a block stay cache resident
+     * (the z part of the divergence couples neighbouring planes and is
+     * applied in a full-volume pass regardless). Choose \c planes such that
+     * a few 2d planes fit into the L2 cache.
+     * @note On GPU backends blocking only adds kernel launch overhead and
+     * should stay disabled; the parameter is ignored for matrix types other
+     * than \c EllSparseBlockMat
+     * @param planes number of z-planes per block; 0 (the default) processes
+     * the whole volume in one chunk
+     */
+    void set_plane_blocking( unsigned planes) {
+        m_z_block = planes;
+    }
+
     ///@copydoc Elliptic2d::symv(const ContainerType0&,ContainerType1&)
     template<class ContainerType0, class ContainerType1>
     void symv( const ContainerType0& x, ContainerType1& y){
@@ -673,6 +1028,26 @@ class Elliptic3d
     ///@copydoc Elliptic2d::symv(value_type,const ContainerType0&,value_type,ContainerType1&)
     template<class ContainerType0, class ContainerType1>
     void symv( value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
+    {
+        do_symv( typename detail::is_ell_matrix<Matrix>::type(), alpha, x, beta, y);
+    }
+    private:
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( std::true_type, value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
+    {
+        detail::fused_elliptic3d_symv( alpha, x, beta, y,
+            detail::make_ell_view( m_rightx), detail::make_ell_view( m_righty),
+            detail::make_ell_view( m_rightz),
+            detail::make_ell_view( m_leftx), detail::make_ell_view( m_lefty),
+            detail::make_ell_view( m_leftz),
+            detail::make_ell_view( m_jumpX), detail::make_ell_view( m_jumpY),
+            detail::make_ell_view( m_jumpZ),
+            m_sigma, m_chi, m_vol, m_tempx, m_tempy, m_tempz, m_temp,
+            m_jfactor, m_chi_weight_jump, m_addJumpZ, m_multiplyZ,
+            m_size2d, m_z_block);
+    }
+    template<class ContainerType0, class ContainerType1>
+    void do_symv( std::false_type, value_type alpha, const ContainerType0& x, value_type beta, ContainerType1& y)
     {
         //compute gradient
         dg::blas2::gemv( m_rightx, x, m_tempx); //R_x*f
@@ -701,19 +1076,16 @@ class Elliptic3d
             {
                 dg::blas2::symv( m_jfactor, m_jumpX, x, 0., m_tempx);
                 dg::blas2::symv( m_jfactor, m_jumpY, x, 0., m_tempy);
+                //fused contraction and accumulation
                 if( m_addJumpZ)
                 {
                     dg::blas2::symv( m_jfactor, m_jumpZ, x, 0., m_tempz);
-                    dg::tensor::multiply3d(m_sigma, m_chi, m_tempx, m_tempy,
-                            m_tempz, 0., m_tempx, m_tempy, m_tempz);
+                    dg::tensor::multiply_sum3d( 1., m_sigma, m_chi, m_tempx,
+                            m_tempy, m_tempz, 1., m_temp);
                 }
                 else
-                    dg::tensor::multiply2d(m_sigma, m_chi, m_tempx, m_tempy,
-                            0., m_tempx, m_tempy);
-
-                dg::blas1::axpbypgz(1., m_tempx, 1., m_tempy, 1., m_temp);
-                if( m_addJumpZ)
-                    dg::blas1::axpby( 1., m_tempz, 1., m_temp);
+                    dg::tensor::multiply_sum2d( 1., m_sigma, m_chi, m_tempx,
+                            m_tempy, 1., m_temp);
             }
             else
             {
@@ -725,6 +1097,7 @@ class Elliptic3d
         }
         dg::blas1::pointwiseDivide( alpha, m_temp, m_vol, beta, y);
     }
+    public:
 
     ///@copydoc Elliptic2d::variation(const ContainerType0&,ContainerType1&)
     template<class ContainerType0, class ContainerType1>
@@ -754,10 +1127,14 @@ class Elliptic3d
     Container m_weights, m_precond;
     Container m_tempx, m_tempy, m_tempz, m_temp;
     SparseTensor<Container> m_chi;
-    Container m_sigma, m_vol;
+    Container m_sigma, m_vol, m_sigma_old;
     value_type m_jfactor;
+    unsigned m_size2d = 0, m_z_block = 0;
     bool m_multiplyZ = true, m_addJumpZ = false;
     bool m_chi_weight_jump;
+    value_type m_chi_tol = 0.;
+    unsigned m_chi_lag = 1, m_chi_counter = 0;
+    bool m_chi_valid = false;
 };
 ///@cond
 template< class G, class M, class V>
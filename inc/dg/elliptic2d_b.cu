@@ -132,6 +132,18 @@ int main()
     std::cout << "L2 Norm of relative error in derivative is\n "<<std::setprecision(16)<< sqrt( err/norm_der)<<std::endl;
     //derivative converges with p-1, for p = 1 with 1/2
 
+    std::cout << "Full multigrid bootstrap (cold start)\n";
+    x = dg::evaluate( initial, grid);
+    t.tic();
+    number = multigrid.solve_fmg( multi_pol, x, b, eps);
+    t.toc();
+    std::cout << "Solution took "<< t.diff() <<"s\n";
+    for( unsigned u=0; u<number.size(); u++)
+        std::cout << " # iterations stage "<< u << " " << number[u] << " \n";
+    dg::blas1::axpby( 1.,x,-1., solution, error);
+    err = sqrt( dg::blas2::dot( w2d, error)/norm);
+    std::cout << " "<<err << "\t"<<res.i<<"\n";
+
     }
     {
     std::cout << "Forward Elliptic\n";
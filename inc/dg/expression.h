@@ -0,0 +1,200 @@
+#pragma once
+
+#include <type_traits>
+#include "backend/config.h"
+#include "blas1.h"
+#include "subroutines.h"
+
+/*!@file
+ *
+ * Lazy expression templates that fuse chains of trivially parallel
+ * vector operations into a single \c dg::blas1::subroutine call
+ */
+
+namespace dg{
+
+/**
+ * @brief Placeholders and operators to fuse chained \c blas1 operations into one kernel
+ *
+ * A sequence of \c dg::blas1::axpby and \c dg::blas1::pointwiseDot calls
+ * reads and writes every participating vector once per call. With the
+ * placeholders \c dg::expr::i0 to \c dg::expr::i9 an arbitrary arithmetic
+ * combination of up to ten vectors can be written as a single expression that
+ * compiles into exactly one kernel launch (one read of every input, one write
+ * of the output):
+ * @code{.cpp}
+using namespace dg::expr;
+// y = a*u*v + b*w  in a single pass over memory
+dg::blas1::evaluate( y, dg::equals(), a*i0*i1 + b*i2, u, v, w);
+ * @endcode
+ * The placeholder \c iN refers to the (N+1)-st vector argument given to
+ * \c dg::blas1::evaluate. Scalars (any type convertible to \c double) can be
+ * freely mixed into the expression. The expression object itself is a functor
+ * callable on the device and can thus also be used with \c
+ * dg::blas1::transform and friends.
+ * @ingroup blas1
+ */
+namespace expr{
+
+///@cond
+template<unsigned I>
+struct Placeholder
+{
+    template<class T, class ...Ts>
+    DG_DEVICE auto operator()( T x, Ts... xs) const
+    {
+        return Placeholder<I-1>()( xs...);
+    }
+};
+template<>
+struct Placeholder<0>
+{
+    template<class T, class ...Ts>
+    DG_DEVICE T operator()( T x, Ts... xs) const
+    {
+        return x;
+    }
+};
+
+template<class T>
+struct Constant
+{
+    Constant( T value) : m_value(value){}
+    template<class ...Ts>
+    DG_DEVICE T operator()( Ts... xs) const
+    {
+        return m_value;
+    }
+    private:
+    T m_value;
+};
+
+template<class Op, class Left, class Right>
+struct BinaryExpr
+{
+    BinaryExpr( Left l, Right r) : m_l(l), m_r(r){}
+    template<class ...Ts>
+    DG_DEVICE auto operator()( Ts... xs) const
+    {
+        return Op()( m_l(xs...), m_r( xs...));
+    }
+    private:
+    Left m_l;
+    Right m_r;
+};
+template<class Op, class Arg>
+struct UnaryExpr
+{
+    UnaryExpr( Arg arg) : m_arg(arg){}
+    template<class ...Ts>
+    DG_DEVICE auto operator()( Ts... xs) const
+    {
+        return Op()( m_arg(xs...));
+    }
+    private:
+    Arg m_arg;
+};
+
+//The operator overloads must only fire for expression types lest they
+//pollute the global namespace: mark them with a trait
+template<class E>
+struct is_expression : std::false_type{};
+template<unsigned I>
+struct is_expression<Placeholder<I>> : std::true_type{};
+template<class T>
+struct is_expression<Constant<T>> : std::true_type{};
+template<class Op, class L, class R>
+struct is_expression<BinaryExpr<Op,L,R>> : std::true_type{};
+template<class Op, class A>
+struct is_expression<UnaryExpr<Op,A>> : std::true_type{};
+
+//lift scalars to Constant, forward expressions unchanged
+template<class E, class = std::enable_if_t<is_expression<E>::value>>
+E make_expr( E e){ return e;}
+template<class T, class = std::enable_if_t<std::is_arithmetic<T>::value>, class = void>
+Constant<T> make_expr( T t){ return Constant<T>(t);}
+
+template<class T>
+using expr_t = decltype( make_expr( std::declval<T>()));
+
+struct PLUS  { template<class T1, class T2> DG_DEVICE auto operator()( T1 x, T2 y)const{ return x+y;} };
+struct MINUS { template<class T1, class T2> DG_DEVICE auto operator()( T1 x, T2 y)const{ return x-y;} };
+struct TIMES { template<class T1, class T2> DG_DEVICE auto operator()( T1 x, T2 y)const{ return x*y;} };
+struct DIVIDES{ template<class T1, class T2> DG_DEVICE auto operator()( T1 x, T2 y)const{ return x/y;} };
+struct NEGATE{ template<class T> DG_DEVICE T operator()( T x)const{ return -x;} };
+
+template<class L, class R, class = std::enable_if_t<is_expression<expr_t<L>>::value
+    && is_expression<expr_t<R>>::value
+    && (is_expression<L>::value || is_expression<R>::value)>>
+BinaryExpr<PLUS, expr_t<L>, expr_t<R>> operator+( L l, R r){
+    return { make_expr(l), make_expr(r)};
+}
+template<class L, class R, class = std::enable_if_t<is_expression<expr_t<L>>::value
+    && is_expression<expr_t<R>>::value
+    && (is_expression<L>::value || is_expression<R>::value)>>
+BinaryExpr<MINUS, expr_t<L>, expr_t<R>> operator-( L l, R r){
+    return { make_expr(l), make_expr(r)};
+}
+template<class L, class R, class = std::enable_if_t<is_expression<expr_t<L>>::value
+    && is_expression<expr_t<R>>::value
+    && (is_expression<L>::value || is_expression<R>::value)>>
+BinaryExpr<TIMES, expr_t<L>, expr_t<R>> operator*( L l, R r){
+    return { make_expr(l), make_expr(r)};
+}
+template<class L, class R, class = std::enable_if_t<is_expression<expr_t<L>>::value
+    && is_expression<expr_t<R>>::value
+    && (is_expression<L>::value || is_expression<R>::value)>>
+BinaryExpr<DIVIDES, expr_t<L>, expr_t<R>> operator/( L l, R r){
+    return { make_expr(l), make_expr(r)};
+}
+template<class A, class = std::enable_if_t<is_expression<A>::value>>
+UnaryExpr<NEGATE, A> operator-( A a){
+    return { a};
+}
+///@endcond
+
+///@addtogroup blas1
+///@{
+static constexpr Placeholder<0> i0{}; //!< placeholder for the 1st vector argument
+static constexpr Placeholder<1> i1{}; //!< placeholder for the 2nd vector argument
+static constexpr Placeholder<2> i2{}; //!< placeholder for the 3rd vector argument
+static constexpr Placeholder<3> i3{}; //!< placeholder for the 4th vector argument
+static constexpr Placeholder<4> i4{}; //!< placeholder for the 5th vector argument
+static constexpr Placeholder<5> i5{}; //!< placeholder for the 6th vector argument
+static constexpr Placeholder<6> i6{}; //!< placeholder for the 7th vector argument
+static constexpr Placeholder<7> i7{}; //!< placeholder for the 8th vector argument
+static constexpr Placeholder<8> i8{}; //!< placeholder for the 9th vector argument
+static constexpr Placeholder<9> i9{}; //!< placeholder for the 10th vector argument
+///@}
+
+}//namespace expr
+
+namespace blas1{
+
+/*! @brief \f$ y = g(x_0, x_1, ...)\f$ Fused evaluation of a lazy expression
+ *
+ * Convenience overload that assigns an expression built from the \c
+ * dg::expr placeholders to \c y in a single kernel:
+ * @code{.cpp}
+using namespace dg::expr;
+dg::blas1::assign_expr( omega, i0*i1 - 0.5*i2*i2, n, phi, u);
+ * @endcode
+ * is equivalent to but faster than the corresponding chain of \c axpby and
+ * \c pointwiseDot calls because every vector is read exactly once.
+ * @param y contains the result on output (may alias an input vector)
+ * @param g an expression built from \c dg::expr placeholders
+ * @param x0 the first vector argument (substituted for \c dg::expr::i0)
+ * @param xs the remaining vector arguments
+ * @copydoc hide_ContainerType
+ * @ingroup blas1
+ */
+template< class ContainerType, class Expression, class ContainerType0, class ...ContainerTypes>
+inline void assign_expr( ContainerType& y, Expression g, const ContainerType0& x0, const ContainerTypes& ...xs)
+{
+    static_assert( dg::expr::is_expression<Expression>::value,
+        "g must be an expression built from dg::expr placeholders!");
+    dg::blas1::evaluate( y, dg::equals(), g, x0, xs...);
+}
+
+}//namespace blas1
+}//namespace dg
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <vector>
+
+#include "expression.h"
+#include "blas1.h"
+
+//test that fused expressions reproduce the equivalent blas1 call chains
+
+using Vector = thrust::device_vector<double>;
+int main()
+{
+    std::cout << "This program tests the fused expression layer against the equivalent chain of blas1 calls\n";
+    std::cout << "A TEST IS PASSED IF THE RESULT IS ZERO.\n";
+    unsigned size = 500;
+    Vector u( size, 2.0002), v( size, 3.00003), w( size, 5.0005);
+    Vector y( size, 0.), z( size, 0.);
+    using namespace dg::expr;
+
+    //y = 3*u + 5*v
+    dg::blas1::assign_expr( y, 3.*i0 + 5.*i1, u, v);
+    dg::blas1::axpby( 3., u, 0., z);
+    dg::blas1::axpby( 5., v, 1., z);
+    dg::blas1::axpby( 1., y, -1., z);
+    std::cout << "fused axpby           "<<z[0]<<std::endl;
+
+    //y = 2*u*v - 0.5*w*w
+    dg::blas1::assign_expr( y, 2.*i0*i1 - 0.5*i2*i2, u, v, w);
+    dg::blas1::pointwiseDot( 2., u, v, 0., z);
+    dg::blas1::pointwiseDot( -0.5, w, w, 1., z);
+    dg::blas1::axpby( 1., y, -1., z);
+    std::cout << "fused pointwiseDot    "<<z[0]<<std::endl;
+
+    //aliasing output with input: u = u*v + u/w
+    dg::blas1::copy( u, y);
+    dg::blas1::assign_expr( y, i0*i1 + i0/i2, y, v, w);
+    dg::blas1::pointwiseDivide( u, w, z);
+    dg::blas1::pointwiseDot( 1., u, v, 1., z);
+    dg::blas1::axpby( 1., y, -1., z);
+    std::cout << "aliased expression    "<<z[0]<<std::endl;
+
+    //negation and scalar mixing: y = -(u - 2.)*v
+    dg::blas1::assign_expr( y, -(i0 - 2.)*i1, u, v);
+    dg::blas1::transform( u, z, dg::PLUS<double>(-2.));
+    dg::blas1::pointwiseDot( -1., z, v, 0., z);
+    dg::blas1::axpby( 1., y, -1., z);
+    std::cout << "scalar mixing         "<<z[0]<<std::endl;
+
+    std::cout << "\nFINISHED! Continue with topology/evaluation_t.cu !\n\n";
+    return 0;
+}
@@ -248,6 +248,25 @@ struct Extrapolation
         return m_counter;
     }
 
+    /**
+     * @brief Read access to the i-th stored vector (newest first)
+     *
+     * Together with \c history_time this allows serializing the state to a
+     * restart file: restore it by calling \c update with the saved pairs
+     * from oldest ( \c i=get_max()-1 ) to newest ( \c i=0 ), which makes
+     * the first guesses after a restart as good as in the original run
+     * @param i must fulfill \c 0<=i<get_max()
+     */
+    const ContainerType& history( unsigned i) const{
+        return m_x[i];
+    }
+    /**
+     * @brief Read access to the time of the i-th stored vector (newest first)
+     * @param i must fulfill \c 0<=i<get_max()
+     */
+    value_type history_time( unsigned i) const{
+        return m_t[i];
+    }
 
     /**
      * @brief Check if time exists in current points
@@ -1935,33 +1935,42 @@ struct BathRZ{
  */
 struct Horner2d
 {
+    ///Maximum number of coefficients; the coefficients are stored in a fixed
+    ///size array so that the functor is usable in device code
+    static const unsigned max_size = 128;
     ///Initialize 1 coefficient to 1
-    Horner2d(): m_c( 1, 1), m_M(1), m_N(1){}
+    Horner2d(): m_M(1), m_N(1){ m_c[0] = 1;}
 
     /**
      * @brief Initialize coefficients and dimensions
      *
-     * @param c vector of size MN containing coefficientc c (accessed as c[i*N+j] i.e. y-direction is contiguous)
+     * @param c vector of size MN containing coefficientc c (accessed as c[i*N+j] i.e. y-direction is contiguous); at most \c max_size coefficients are supported
      * @param M number of polynomials in x
      * @param N number of polynomials in y
      */
-    Horner2d( std::vector<double> c, unsigned M, unsigned N): m_c(c), m_M(M), m_N(N){}
-    double operator()( double x, double y) const
+    Horner2d( std::vector<double> c, unsigned M, unsigned N): m_M(M), m_N(N)
     {
-        std::vector<double> cx( m_M);
+        assert( c.size() <= max_size &&
+                "Horner2d supports at most max_size coefficients");
+        for( unsigned i=0; i<c.size(); i++)
+            m_c[i] = c[i];
+    }
+    DG_DEVICE double operator()( double x, double y) const
+    {
+        double cx[ max_size];
         for( unsigned i=0; i<m_M; i++)
             cx[i] = horner( &m_c[i*m_N], m_N, y);
         return horner( &cx[0], m_M, x);
     }
     private:
-    double horner( const double * c, unsigned M, double x) const
+    DG_DEVICE double horner( const double * c, unsigned M, double x) const
     {
         double b = c[M-1];
         for( unsigned i=0; i<M-1; i++)
             b = c[M-2-i] + b*x;
         return b;
     }
-    std::vector<double> m_c;
+    double m_c[ max_size];
     unsigned m_M, m_N;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "pcg.h"
+#include "extrapolation.h"
 
 namespace dg{
 ///@cond
@@ -84,7 +85,8 @@ struct DefaultSolver
     */
     template<class Implicit>
     DefaultSolver( Implicit& im, const ContainerType& copyable,
-            unsigned max_iter, value_type eps): m_max_iter(max_iter)
+            unsigned max_iter, value_type eps): m_max_iter(max_iter),
+        m_copyable( copyable)
     {
         m_im = [&im = im]( value_type t, const ContainerType& y, ContainerType&
                 yp) mutable
@@ -113,6 +115,42 @@ struct DefaultSolver
     ///@param benchmark If true, additional output will be written to \c std::cout during solution
     void set_benchmark( bool benchmark){ m_benchmark = benchmark;}
 
+    /*!@brief Activate per-stage extrapolation of initial guesses
+     *
+     * A multistage implicit stepper like \c DIRKStep or \c ARKStep calls this
+     * solver several times per step at the fixed stage offsets \f$ t^n + c_i
+     * \Delta t\f$. With per-stage histories every stage extrapolates its
+     * initial guess from its own solutions of the previous steps instead of
+     * starting from the right hand side, which typically starts the conjugate
+     * gradient iteration much closer to the solution.
+     * The calls are assigned to the histories in a round-robin fashion, so \c
+     * stages must equal the number of implicit solves per step of the
+     * stepper in use (\c s or \c s-1 solves for an \c s stage DIRK method
+     * depending on whether \f$ a_{00} = 0\f$).
+     * @param stages number of implicit solves per step; 0 (the default)
+     * deactivates the per-stage histories and the right hand side is used as
+     * initial guess
+     * @param order forwarded to \c dg::Extrapolation (2 = linear
+     * extrapolation in time)
+     * @note A rejected step of an adaptive integration repeats the stage
+     * pattern, so the round-robin assignment stays aligned; the histories
+     * are time-based and simply update the repeated stage times
+     */
+    void set_stage_extrapolation( unsigned stages, unsigned order = 2)
+    {
+        m_extra.assign( stages, dg::Extrapolation<ContainerType>( order,
+                    m_copyable));
+        m_stage_iter.assign( stages, 0);
+        m_stage = 0;
+    }
+    /// Number of iterations of the latest call to \c operator()
+    unsigned get_iter() const{ return m_iter;}
+    /*!@brief Accumulated iteration count of each stage
+     * @return one counter per stage set in \c set_stage_extrapolation
+     * (empty if per-stage histories are inactive)
+     */
+    const std::vector<unsigned>& stage_iterations() const{ return m_stage_iter;}
+
     void operator()( value_type alpha, value_type time, ContainerType& y, const
             ContainerType& ys)
     {
@@ -126,13 +164,22 @@ struct DefaultSolver
         };
         Timer ti;
         if(m_benchmark) ti.tic();
-        dg::blas1::copy( ys, y); // take rhs as initial guess
-        unsigned number = m_solve( wrapper, y, ys);
+        if( m_extra.empty() || m_extra[m_stage].get_max() == 0)
+            dg::blas1::copy( ys, y); // take rhs as initial guess
+        else
+            m_extra[m_stage].extrapolate( time, y);
+        m_iter = m_solve( wrapper, y, ys);
+        if( !m_extra.empty())
+        {
+            m_extra[m_stage].update( time, y);
+            m_stage_iter[m_stage] += m_iter;
+            m_stage = (m_stage+1)%m_extra.size();
+        }
         if( m_benchmark)
         {
             ti.toc();
             DG_RANK0 std::cout << "# of pcg iterations time solver: "
-                <<number<<"/"<<m_max_iter<<" took "<<ti.diff()<<"s\n";
+                <<m_iter<<"/"<<m_max_iter<<" took "<<ti.diff()<<"s\n";
         }
     }
     private:
@@ -141,7 +188,11 @@ struct DefaultSolver
     std::function< unsigned ( const std::function<void( const
                 ContainerType&,ContainerType&)>&, ContainerType&,
             const ContainerType&)> m_solve;
+    std::vector<dg::Extrapolation<ContainerType>> m_extra;
+    std::vector<unsigned> m_stage_iter;
     unsigned m_max_iter;
+    ContainerType m_copyable;
+    unsigned m_stage = 0, m_iter = 0;
     bool m_benchmark = true;
 };
 
@@ -0,0 +1,82 @@
+#pragma once
+
+/*! @file
+ * @brief Explicit template instantiations for the standard double precision types
+ *
+ * Feltor is a header-only library, which means that every translation unit
+ * recompiles all templates it uses. For projects consisting of many
+ * translation units (or many small executables that share an object library)
+ * the commonly used instantiations can instead be compiled once:
+ *
+ * (i) define \c FELTOR_EXPLICIT_INSTANTIATION before including \c
+ * dg/algorithm.h in every translation unit of the project. This header is
+ * then included automatically and declares the instantiations listed below
+ * as \c extern \c template, which suppresses their (re-)compilation.
+ *
+ * (ii) add exactly one translation unit to the project that provides the
+ * definitions:
+ * @code
+ * // dg_instantiations.cu
+ * #define FELTOR_EXPLICIT_INSTANTIATION
+ * #define FELTOR_INSTANTIATE_LIBRARY
+ * #include "dg/algorithm.h"
+ * @endcode
+ *
+ * Both compile time and binary size shrink because the instantiations exist
+ * exactly once. The list covers the type-heavy cold paths: grids,
+ * geometries, block matrices and the derivative and weight creation
+ * functions for the standard \c double typedefs of backend/typedefs.h.
+ * @note The blas1/blas2 kernels themselves are parameterized on user
+ * functors and lambdas and thus remain implicitly instantiated per
+ * translation unit
+ * @note In an MPI build the local parts of all distributed types profit,
+ * the thin MPI wrappers themselves remain implicit
+ */
+
+#if defined(FELTOR_INSTANTIATE_LIBRARY)
+#define DG_TPL template       //instantiation definition (exactly one translation unit)
+#else
+#define DG_TPL extern template //instantiation declaration (all other translation units)
+#endif
+
+///@cond
+// topology and geometry
+DG_TPL class dg::RealGrid1d<double>;
+DG_TPL class dg::RealGrid2d<double>;
+DG_TPL class dg::RealGrid3d<double>;
+DG_TPL class dg::RealCartesianGrid2d<double>;
+DG_TPL class dg::RealCartesianGrid3d<double>;
+DG_TPL class dg::RealCylindricalGrid3d<double>;
+DG_TPL class dg::Operator<double>;
+
+// block matrices
+DG_TPL class dg::EllSparseBlockMat<double>;
+DG_TPL class dg::CooSparseBlockMat<double>;
+#if THRUST_DEVICE_SYSTEM!=THRUST_DEVICE_SYSTEM_CPP
+// in a serial build the device matrices are aliases of the host matrices
+DG_TPL class dg::EllSparseBlockMatDevice<double>;
+DG_TPL class dg::CooSparseBlockMatDevice<double>;
+#endif
+
+// derivative and weight creation
+DG_TPL dg::EllSparseBlockMat<double> dg::create::dx( const dg::aRealTopology2d<double>&, dg::bc, dg::direction);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::dy( const dg::aRealTopology2d<double>&, dg::bc, dg::direction);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::jumpX( const dg::aRealTopology2d<double>&, dg::bc);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::jumpY( const dg::aRealTopology2d<double>&, dg::bc);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::dx( const dg::aRealTopology3d<double>&, dg::bc, dg::direction);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::dy( const dg::aRealTopology3d<double>&, dg::bc, dg::direction);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::dz( const dg::aRealTopology3d<double>&, dg::bc, dg::direction);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::jumpX( const dg::aRealTopology3d<double>&, dg::bc);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::jumpY( const dg::aRealTopology3d<double>&, dg::bc);
+DG_TPL dg::EllSparseBlockMat<double> dg::create::jumpZ( const dg::aRealTopology3d<double>&, dg::bc);
+DG_TPL thrust::host_vector<double> dg::create::weights( const dg::aRealTopology2d<double>&);
+DG_TPL thrust::host_vector<double> dg::create::inv_weights( const dg::aRealTopology2d<double>&);
+DG_TPL thrust::host_vector<double> dg::create::weights( const dg::aRealTopology3d<double>&);
+DG_TPL thrust::host_vector<double> dg::create::inv_weights( const dg::aRealTopology3d<double>&);
+
+// frequently used solver classes on the standard device types
+DG_TPL class dg::Elliptic2d<dg::CartesianGrid2d, dg::DMatrix, dg::DVec>;
+DG_TPL class dg::Elliptic3d<dg::CylindricalGrid3d, dg::DMatrix, dg::DVec>;
+///@endcond
+
+#undef DG_TPL
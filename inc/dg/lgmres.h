@@ -8,6 +8,7 @@
 
 #include "blas.h"
 #include "functors.h"
+#include "convergence_history.h"
 
 /*!@file
  * LGMRES class
@@ -110,6 +111,8 @@ class LGMRES
     void set_throw_on_fail( bool throw_on_fail){
         m_throw_on_fail = throw_on_fail;
     }
+    ///@copydoc dg::PCG::set_history(ConvergenceHistory*)
+    void set_history( ConvergenceHistory* hist){ m_hist = hist;}
     ///@brief Return an object of same size as the object used for construction
     ///@return A copyable object; what it contains is undefined, its size is important
     const ContainerType& copyable()const{ return m_tmp;}
@@ -160,6 +163,7 @@ class LGMRES
     std::vector<value_type> m_s;
     unsigned m_maxRestarts, m_inner_m, m_outer_k, m_krylovDimension;
     bool m_converged = true, m_throw_on_fail = true;
+    ConvergenceHistory* m_hist = nullptr;
 };
 ///@cond
 
@@ -206,6 +210,8 @@ unsigned LGMRES< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Con
         blas1::copy( 0., x);
         return 0;
     }
+    if( m_hist)
+        m_hist->begin_solve( nrmb, tol);
 
     unsigned restartCycle = 0;
     unsigned counter = 0;
@@ -222,8 +228,17 @@ unsigned LGMRES< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Con
         dg::blas1::axpby(1.,b,-1.,m_residual);
         rho = sqrt(dg::blas2::dot(S,m_residual));
         counter ++;
+        if( m_hist)
+        {
+            m_hist->matvec();
+            m_hist->residual( rho);
+        }
         if( rho < tol) //if x happens to be the solution
+        {
+            if( m_hist)
+                m_hist->end_solve( counter, true);
             return counter;
+        }
         // The first vector in the Krylov subspace is the normalized residual.
         dg::blas1::axpby(1.0/rho,m_residual,0.,m_V[0]);
 
@@ -240,6 +255,11 @@ unsigned LGMRES< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Con
                 dg::blas2::gemv(std::forward<Preconditioner>(P),*m_W[iteration],m_tmp);
                 dg::blas2::gemv(std::forward<Matrix>(A),m_tmp,m_V[iteration+1]);
                 counter++;
+                if( m_hist)
+                {
+                    m_hist->matvec();
+                    m_hist->precond();
+                }
             } else if( iteration < m_krylovDimension){ // size of W
                 unsigned w_idx = iteration - (m_krylovDimension - outer_w_count);
                 m_W[iteration] = &m_outer_w[w_idx];
@@ -312,13 +332,22 @@ unsigned LGMRES< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Con
 			m_s[iteration] = tmp;
 
             rho = fabs(m_s[iteration+1]);
+            if( m_hist)
+                m_hist->residual( rho);
             if( rho < tol)
 			{
                 Update(std::forward<Preconditioner>(P),m_dx,x,iteration,m_H,m_s,m_W);
+                if( m_hist)
+                {
+                    m_hist->precond();
+                    m_hist->end_solve( counter, true);
+                }
                 return counter;
             }
         }
         Update(std::forward<Preconditioner>(P),m_dx,x,m_krylovDimension-1,m_H,m_s,m_W);
+        if( m_hist)
+            m_hist->precond();
         if( m_outer_k > 1)
         {
             std::rotate(m_outer_w.rbegin(),m_outer_w.rbegin()+1,m_outer_w.rend());
@@ -341,6 +370,8 @@ unsigned LGMRES< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Con
         restartCycle ++;
     // Go through the requisite number of restarts.
     } while( (restartCycle < m_maxRestarts) && (rho > tol));
+    if( m_hist)
+        m_hist->end_solve( counter, !(rho > tol));
     if( rho > tol)
     {
         if( m_throw_on_fail)
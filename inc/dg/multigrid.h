@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include "backend/exceptions.h"
 #include "backend/memory.h"
 #include "topology/fast_interpolation.h"
@@ -7,9 +8,12 @@
 #include "blas.h"
 #include "pcg.h"
 #include "chebyshev.h"
+#include "precond.h"
 #include "eve.h"
 #include "backend/timer.h"
 #ifdef MPI_VERSION
+#include <thrust/gather.h>
+#include <thrust/scatter.h>
 #include "topology/mpi_projection.h"
 #endif
 
@@ -74,6 +78,7 @@ struct NestedGrids
             m_x[u] = dg::construct<Container>( dg::evaluate( dg::zero,
                         *m_grids[u]), std::forward<ContainerParams>(ps)...);
         m_w = m_r = m_b = m_x;
+        m_ticket = MemoryTicket( "dg::NestedGrids", 4*bytes_of( m_x));
 
     }
 
@@ -112,6 +117,33 @@ struct NestedGrids
         return out;
 
     }
+    /**
+    * @brief Project a group of vectors to all involved grids
+    *
+    * Same as \c project for each member of the group except that all fields
+    * are transferred together in one batched \c MultiMatrix::symv per stage,
+    * which under MPI exchanges the halos of the whole group in a single
+    * message per neighbor and stage
+    * @param src pointers to the input vectors
+    * @param out out[k] is src[k] projected to all grids (size must equal \c
+    * src.size(), neither the outer nor the inner vectors are resized)
+    */
+    template<class ContainerType0>
+    void project( const std::vector<const ContainerType0*>& src,
+        std::vector<std::vector<ContainerType0>>& out) const
+    {
+        unsigned num = src.size();
+        for( unsigned k=0; k<num; k++)
+            dg::blas1::copy( *src[k], out[k][0]);
+        std::vector<const ContainerType0*> in( num);
+        std::vector<ContainerType0*> res( num);
+        for( unsigned u=0; u<m_stages-1; u++)
+        {
+            for( unsigned k=0; k<num; k++)
+                in[k] = &out[k][u], res[k] = &out[k][u+1];
+            m_project[u].symv( 1., in, 0., res);
+        }
+    }
     ///@brief Return an object of same size as the object used for construction on the finest grid
     ///@return A copyable object; what it contains is undefined, its size is important
     const Container& copyable() const {return m_x[0];}
@@ -154,6 +186,7 @@ struct NestedGrids
     std::vector< MultiMatrix<Matrix, Container> >  m_inter;
     std::vector< MultiMatrix<Matrix, Container> >  m_project;
     std::vector< Container> m_x, m_r, m_b, m_w;
+    MemoryTicket m_ticket;
 };
 
 /*!@brief Full approximation nested iterations
@@ -204,10 +237,13 @@ void nested_iterations(
     dg::blas1::axpby(1., b, -1., nested.r(0));
     // project residual down to coarse grid
     dg::blas1::copy( x, nested.x(0));
+    using Workspace = std::decay_t<decltype(nested.r(0))>;
     for( unsigned u=0; u<nested.stages()-1; u++)
     {
-        dg::blas2::gemv( nested.projection(u), nested.r(u), nested.r(u+1));
-        dg::blas2::gemv( nested.projection(u), nested.x(u), nested.x(u+1));
+        // transfer residual and guess together in one batched pass
+        std::vector<const Workspace*> fine = { &nested.r(u), &nested.x(u)};
+        std::vector<Workspace*> coarse = { &nested.r(u+1), &nested.x(u+1)};
+        nested.projection(u).symv( 1., fine, 0., coarse);
         // compute FAS right hand side
         dg::blas2::symv( ops[u+1], nested.x(u+1), nested.b(u+1));
         dg::blas1::axpby( 1., nested.b(u+1), 1., nested.r(u+1), nested.b(u+1));
@@ -262,9 +298,11 @@ void nested_iterations(
      Index 0 is the Operator on the original grid, 1 on the half grid, 2 on the
      quarter grid, ...
  * @param inverse_ops_down a vector of inverse, smoothing operators (usually
- *  lambda functions combining operators and solvers) of size \c stages-1
+ *  lambda functions combining operators and solvers, or e.g. \c
+ *  dg::BlockGaussSeidel) of size \c stages-1
  * @param inverse_ops_up a vector of inverse, smoothing operators (usually
- *  lambda functions combining operators and solvers) of size \c stages
+ *  lambda functions combining operators and solvers, or e.g. \c
+ *  dg::BlockGaussSeidel) of size \c stages
  * @param nested_grids provides projection and interapolation operations and workspace
  * @param gamma The shape of the multigrid cycle:
     typically 1 (V-cycle) or 2 (W-cycle)
@@ -301,9 +339,11 @@ void multigrid_cycle(
     // 2. Residuum
     dg::apply( ops[p], nested.x(p), nested.r(p));
     dg::blas1::axpby( 1., nested.b(p), -1., nested.r(p));
-    // 3. Coarsen
-    dg::blas2::symv( nested.projection(p), nested.r(p), nested.r(p+1));
-    dg::blas2::symv( nested.projection(p), nested.x(p), nested.x(p+1));
+    // 3. Coarsen (residual and guess together in one batched pass)
+    using Workspace = std::decay_t<decltype(nested.r(0))>;
+    std::vector<const Workspace*> fine = { &nested.r(p), &nested.x(p)};
+    std::vector<Workspace*> coarse = { &nested.r(p+1), &nested.x(p+1)};
+    nested.projection(p).symv( 1., fine, 0., coarse);
     dg::blas2::symv( ops[p+1], nested.x(p+1), nested.b(p+1));
     dg::blas1::axpby( 1., nested.r(p+1), 1., nested.b(p+1));
     // 4. Solve or recursive call to get x[p+1] with initial guess 0
@@ -347,9 +387,11 @@ void multigrid_cycle(
  * @param x (read/write) contains initial guess on input and the solution on output
  * @param b The right hand side
  * @param inverse_ops_down a vector of inverse, smoothing operators (usually
- *  lambda functions combining operators and solvers) of size \c stages-1
+ *  lambda functions combining operators and solvers, or e.g. \c
+ *  dg::BlockGaussSeidel) of size \c stages-1
  * @param inverse_ops_up a vector of inverse, smoothing operators (usually
- *  lambda functions combining operators and solvers) of size \c stages
+ *  lambda functions combining operators and solvers, or e.g. \c
+ *  dg::BlockGaussSeidel) of size \c stages
  * @param nested_grids provides projection and interapolation operations and workspace
  * @param gamma The shape of the multigrid cycle:
     typically 1 (V-cycle) or 2 (W-cycle)
@@ -375,10 +417,13 @@ void full_multigrid(
     dg::blas1::axpby(1., b, -1., nested.r(0));
     // project residual down to coarse grid
     dg::blas1::copy( x, nested.x(0));
+    using Workspace = std::decay_t<decltype(nested.r(0))>;
     for( unsigned u=0; u<nested.stages()-1; u++)
     {
-        dg::blas2::gemv( nested.projection(u), nested.r(u), nested.r(u+1));
-        dg::blas2::gemv( nested.projection(u), nested.x(u), nested.x(u+1));
+        // transfer residual and guess together in one batched pass
+        std::vector<const Workspace*> fine = { &nested.r(u), &nested.x(u)};
+        std::vector<Workspace*> coarse = { &nested.r(u+1), &nested.x(u+1)};
+        nested.projection(u).symv( 1., fine, 0., coarse);
         // compute FAS right hand side
         dg::blas2::symv( ops[u+1], nested.x(u+1), nested.b(u+1));
         dg::blas1::axpby( 1., nested.b(u+1), 1., nested.r(u+1), nested.b(u+1));
@@ -421,9 +466,11 @@ void full_multigrid(
  * @param x (read/write) contains initial guess on input and the solution on output
  * @param b The right hand side
  * @param inverse_ops_down a vector of inverse, smoothing operators (usually
- *  lambda functions combining operators and solvers) of size \c stages-1
+ *  lambda functions combining operators and solvers, or e.g. \c
+ *  dg::BlockGaussSeidel) of size \c stages-1
  * @param inverse_ops_up a vector of inverse, smoothing operators (usually
- *  lambda functions combining operators and solvers) of size \c stages
+ *  lambda functions combining operators and solvers, or e.g. \c
+ *  dg::BlockGaussSeidel) of size \c stages
  * @param nested_grids provides projection and interapolation operations and workspace
  * @param weights Defines the error norm
  * @param eps relative and absolute error tolerance
@@ -549,6 +596,13 @@ struct MultigridCG2d
     {
         return m_nested.project( src);
     }
+    ///@copydoc dg::NestedGrids::project(const std::vector<const ContainerType0*>&,std::vector<std::vector<ContainerType0>>&)const
+    template<class ContainerType0>
+    void project( const std::vector<const ContainerType0*>& src,
+        std::vector<std::vector<ContainerType0>>& out) const
+    {
+        m_nested.project( src, out);
+    }
     ///@return number of stages (same as \c num_stages)
     unsigned stages()const{return m_nested.stages();}
     ///@return number of stages (same as \c stages)
@@ -573,6 +627,18 @@ struct MultigridCG2d
      * @param new_max new maximum number of iterations allowed at stage 0
     */
     void set_max_iter(unsigned new_max){ m_pcg[0].set_max(new_max);}
+    /**
+     * @brief Access the \c dg::PCG solver of the given stage
+     *
+     * Intended to activate and query per-solver features like \c
+     * dg::PCG::set_eigenvalue_monitor or \c dg::PCG::set_history, typically
+     * on stage 0 where the accurate work happens
+     * @param stage must fulfill \c 0 <= stage < stages()
+     */
+    PCG<Container>& pcg( unsigned stage){ return m_pcg[stage];}
+    ///@brief Read access to the \c dg::PCG solver of the given stage
+    ///@param stage must fulfill \c 0 <= stage < stages()
+    const PCG<Container>& pcg( unsigned stage) const{ return m_pcg[stage];}
     /**
      *@brief Set or unset performance timings during iterations
      *@param benchmark If true, additional output will be written to \c std::cout during solution
@@ -584,6 +650,26 @@ struct MultigridCG2d
         m_benchmark = benchmark;
         m_message = message;
     }
+    /**
+     * @brief Scale the tolerances of subsequent calls to \c solve
+     *
+     * All per-stage accuracies \c eps given to \c solve are multiplied by \c
+     * scale. The intended use is the coupling with an adaptive time
+     * integrator: the elliptic equations need not be solved deeper than the
+     * accuracy of the current timestep requires, so the integrator can relax
+     * the (statically chosen) tolerances by its current error slack, e.g.
+     * @code
+     * //eps0 is the tolerance normalized error dg::Adaptive::get_error()
+     * multigrid.set_eps_scale( std::min( 10., std::max( 1., 0.1/eps0)));
+     * @endcode
+     * @param scale factor that multiplies the accuracies in \c solve
+     * (default is 1; values below 1 tighten, values above 1 relax)
+    */
+    void set_eps_scale( value_type scale){
+        m_eps_scale = scale;
+    }
+    ///@brief The current tolerance scale factor set with \c set_eps_scale
+    value_type get_eps_scale() const{ return m_eps_scale;}
 
     ///@brief Return an object of same size as the object used for construction on the finest grid
     ///@return A copyable object; what it contains is undefined, its size is important
@@ -630,6 +716,9 @@ struct MultigridCG2d
         int rank;
         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 #endif //MPI
+        if( m_eps_scale != 1)
+            for( unsigned u=0; u<m_stages; u++)
+                eps[u] *= m_eps_scale;
         std::vector<unsigned> number(m_stages);
         std::vector<std::function<void( const ContainerType1&, ContainerType0&)> >
             multi_inv_pol(m_stages);
@@ -656,14 +745,780 @@ struct MultigridCG2d
         return number;
     }
 
+    /**
+     * @brief Full multigrid bootstrap for cold starts
+     *
+     * Descend to the coarsest grid and work up with W-cycles
+     * (\c dg::full_multigrid) where every stage is treated with the
+     * per-stage \c dg::PCG solver: loose solves act as the smoothers on the
+     * way, the finest stage solves to \c eps.  Compared to \c solve this
+     * visits the coarse grids several times before the first fine-grid
+     * iteration, which pays off when no good initial guess exists, i.e. for
+     * the very first solve of a run; once an \c Extrapolation guess is
+     * available the cheaper \c solve is preferable.
+     * @note In contrast to \c dg::fmg_solve no Chebyshev smoothers and thus
+     * no eigenvalue estimates are needed, the method converges whenever \c
+     * solve does
+     * @copydoc solve()
+     * @param gamma The shape of the multigrid cycle:
+     *  1 is a V-cycle, 2 a W-cycle (default)
+     */
+    template<class MatrixType, class ContainerType0, class ContainerType1>
+    std::vector<unsigned> solve_fmg( std::vector<MatrixType>& ops, ContainerType0&  x, const ContainerType1& b, value_type eps, unsigned gamma = 2)
+    {
+        std::vector<unsigned> number(m_stages, 0);
+        if( m_stages == 1)
+        {
+            number[0] = m_pcg[0].solve( ops[0], x, b, ops[0].precond(),
+                    ops[0].weights(), eps, 1, 1);
+            return number;
+        }
+        std::vector<std::function<void( const ContainerType1&, ContainerType0&)> >
+            multi_inv_down(m_stages-1), multi_inv_up(m_stages);
+        for(unsigned u=0; u<m_stages; u++)
+        {
+            multi_inv_up[u] = [&, u, &pcg = m_pcg[u], &pol = ops[u]](
+            const auto& y, auto& x)
+            {
+                dg::Timer t;
+                t.tic();
+                unsigned num = pcg.solve( pol, x, y, pol.precond(),
+                        pol.weights(), u == 0 ? eps : 0.1*eps, 1, u == 0 ? 1 : 10);
+                number[u] += num;
+                t.toc();
+                if( m_benchmark)
+                    DG_RANK0 std::cout << "# `"<<m_message<<"` stage: " << u << ", iter: " << num << ", took "<<t.diff()<<"s\n";
+            };
+            //pre-smoothing only needs to roughly reduce the residual
+            if( u < m_stages-1)
+                multi_inv_down[u] = [&, u, &pcg = m_pcg[u], &pol = ops[u]](
+                const auto& y, auto& x)
+                {
+                    unsigned num = pcg.solve( pol, x, y, pol.precond(),
+                            pol.weights(), 0.1, 1, u == 0 ? 1 : 10);
+                    number[u] += num;
+                };
+        }
+        full_multigrid( ops, x, b, multi_inv_down, multi_inv_up, m_nested,
+                gamma, 1);
+
+        return number;
+    }
+
   private:
     dg::NestedGrids<Geometry, Matrix, Container> m_nested;
     std::vector< PCG<Container> > m_pcg;
     unsigned m_stages;
     bool m_benchmark = true;
     std::string m_message = "Nested Iterations";
+    value_type m_eps_scale = 1;
+
+};
+
+/**
+* @brief Chebyshev smoothed multigrid cycles to solve \f[ \hat O \phi = \rho \f]
+*
+* This class packages the \c dg::multigrid_cycle and \c dg::full_multigrid
+* functions into a solver for any operator \f$\hat O\f$ that is self-adjoint
+* in appropriate weights \f$ W\f$ (e.g. \c dg::Elliptic assembled on each
+* stage of the \c NestedGrids). \c dg::ChebyshevIteration is used as the
+* smoother on all fine stages and \c dg::PCG solves the coarsest stage. The
+* Chebyshev smoothing range is set from the largest eigenvalue of each stage
+* operator, which is estimated with \c dg::EVE in \c update_eigenvalues
+* (must be called before the first solve and whenever the operator
+* coefficients change significantly).
+*
+* The class can be used standalone through \c solve (repeated V-, W- or
+* full-multigrid cycles until the residual tolerance is met) or as a
+* preconditioner for \c dg::PCG through \c precond, which applies a single
+* full-multigrid cycle with zero initial guess:
+* @code{.cpp}
+dg::MultigridCheby2d<Geometry, Matrix, Container> mg( grid, 3);
+mg.update_eigenvalues( ops);
+pcg.solve( ops[0], x, b, [&]( const auto& y, auto& x){
+    mg.precond( ops, y, x);}, ops[0].weights(), eps);
+* @endcode
+* @attention Plain multigrid convergence depends sensitively on the number
+* of smoothing steps and the jump factor of the \c dg::Elliptic operator;
+* the preconditioner usage is much more robust.
+* @copydoc hide_geometry_matrix_container
+* @sa \c MultigridCG2d \c fmg_solve
+*/
+template< class Geometry, class Matrix, class Container>
+struct MultigridCheby2d
+{
+    using geometry_type = Geometry;
+    using matrix_type = Matrix;
+    using container_type = Container;
+    using value_type = get_value_type<Container>;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    MultigridCheby2d() = default;
+    ///@copydoc MultigridCG2d::MultigridCG2d(const Geometry&,const unsigned,ContainerParams&&...)
+    template<class ...ContainerParams>
+    MultigridCheby2d( const Geometry& grid, const unsigned stages,
+            ContainerParams&& ... ps):
+        m_nested( grid, stages, std::forward<ContainerParams>(ps)...),
+        m_cheby( stages), m_ev( stages, 0), m_stages( stages)
+    {
+        for( unsigned u=0; u<stages; u++)
+            m_cheby[u].construct( m_nested.x(u));
+        m_coarse.construct( m_nested.x(stages-1),
+                m_nested.grid(stages-1).size());
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = MultigridCheby2d( std::forward<Params>( ps)...);
+    }
+    ///@return number of stages (same as \c stages)
+    unsigned stages()const{return m_stages;}
+    ///@copydoc MultigridCG2d::grid(unsigned)const
+    const Geometry& grid( unsigned stage) const {
+        return m_nested.grid(stage);
+    }
+    ///@copydoc MultigridCG2d::copyable()const
+    const Container& copyable() const {return m_nested.copyable();}
+    /**
+     * @brief Set the multigrid schedule
+     *
+     * @param nu1 number of pre-smoothing Chebyshev iterations (default 10)
+     * @param nu2 number of post-smoothing Chebyshev iterations (default 10)
+     * @param gamma the shape of the cycle: 1 is a V-cycle, 2 a W-cycle (default 1)
+     */
+    void set_schedule( unsigned nu1, unsigned nu2, unsigned gamma = 1)
+    {
+        m_nu1 = nu1, m_nu2 = nu2, m_gamma = gamma;
+    }
+    /**
+     * @brief Estimate the largest eigenvalue of each stage operator with \c dg::EVE
+     *
+     * The Chebyshev smoother on stage \c u then smoothes the range
+     * \f$ [\lambda_\max^u/100, 1.1\lambda_\max^u]\f$.
+     * Call this method before the first \c solve or \c precond and again
+     * whenever the operator coefficients (e.g. \c chi in \c dg::Elliptic)
+     * change significantly.
+     * @param ops Index 0 is the \c MatrixType on the original grid, 1 on
+     *  the half grid, ...; \c ops[u].weights() needs to be callable!
+     * @param eps_ev The desired accuracy of the largest eigenvalue
+     * @copydoc hide_matrix
+     */
+    template<class MatrixType>
+    void update_eigenvalues( std::vector<MatrixType>& ops, value_type eps_ev = 1e-4)
+    {
+        dg::EVE<Container> eve;
+        for( unsigned u=0; u<m_stages; u++)
+        {
+            eve.construct( m_nested.x(u));
+            dg::blas1::copy( 0., m_nested.x(u));
+            //the weights are positive and thus a valid right hand side
+            dg::blas1::copy( ops[u].weights(), m_nested.b(u));
+            eve.solve( ops[u], m_nested.x(u), m_nested.b(u), 1.,
+                    ops[u].weights(), m_ev[u], eps_ev);
+        }
+    }
+    /**
+     * @brief Solve by repeated full multigrid cycles
+     *
+     * Equivalent to \c dg::fmg_solve with Chebyshev smoothers on the fine
+     * stages and \c dg::PCG on the coarsest stage
+     * @param ops Index 0 is the \c MatrixType on the original grid, 1 on the
+     *  half grid, ...; \c ops[u].precond() and \c ops[u].weights() need to be
+     *  callable!
+     * @param x (read/write) contains initial guess on input and the solution on output
+     * @param b The right hand side
+     * @param eps the accuracy: cycles stop when \f$ ||b-Ax||_W < \epsilon( ||b||_W+1)\f$
+     * @copydoc hide_matrix
+     * @copydoc hide_ContainerType
+     */
+    template<class MatrixType, class ContainerType0, class ContainerType1>
+    void solve( std::vector<MatrixType>& ops, ContainerType0& x,
+            const ContainerType1& b, value_type eps)
+    {
+        auto inv_down = smoothers( ops, m_nu1), inv_up = smoothers( ops, m_nu2);
+        set_coarse_solver( ops, inv_up, eps);
+        fmg_solve( ops, x, b, inv_down, inv_up, m_nested, ops[0].weights(),
+                eps, m_gamma);
+    }
+    /**
+     * @brief Apply a single full multigrid cycle with zero initial guess
+     *
+     * intended to be used as a preconditioner in \c dg::PCG
+     * @param ops Index 0 is the \c MatrixType on the original grid, 1 on the
+     *  half grid, ...; \c ops[u].precond() and \c ops[u].weights() need to be
+     *  callable!
+     * @param b The right hand side
+     * @param x the approximate solution \f$ x \approx \hat O^{-1} b\f$ on output
+     * @copydoc hide_matrix
+     * @copydoc hide_ContainerType
+     */
+    template<class MatrixType, class ContainerType0, class ContainerType1>
+    void precond( std::vector<MatrixType>& ops, const ContainerType0& b,
+            ContainerType1& x)
+    {
+        auto inv_down = smoothers( ops, m_nu1), inv_up = smoothers( ops, m_nu2);
+        //the coarse grid does not need to be solved accurately in a preconditioner
+        set_coarse_solver( ops, inv_up, 1e-1);
+        dg::blas1::copy( 0., x);
+        full_multigrid( ops, x, b, inv_down, inv_up, m_nested, m_gamma, 1);
+    }
+  private:
+    using function_type = std::function<void( const Container&, Container&)>;
+    template<class MatrixType>
+    std::vector<function_type> smoothers( std::vector<MatrixType>& ops, unsigned nu)
+    {
+        std::vector<function_type> inv( m_stages);
+        for( unsigned u=0; u<m_stages; u++)
+            inv[u] = [nu, ev = m_ev[u], &cheby = m_cheby[u],
+                &op = ops[u]]( const auto& y, auto& x)
+                {
+                    cheby.solve( op, x, y, ev/100., ev*1.1, nu, false);
+                };
+        return inv;
+    }
+    template<class MatrixType>
+    void set_coarse_solver( std::vector<MatrixType>& ops,
+            std::vector<function_type>& inv, value_type eps)
+    {
+        inv[m_stages-1] = [eps, &pcg = m_coarse, &op = ops[m_stages-1]](
+            const auto& y, auto& x)
+            {
+                pcg.solve( op, x, y, op.precond(), op.weights(), eps, 1, 10);
+            };
+    }
+    dg::NestedGrids<Geometry, Matrix, Container> m_nested;
+    std::vector< ChebyshevIteration<Container> > m_cheby;
+    PCG<Container> m_coarse;
+    std::vector<value_type> m_ev;
+    unsigned m_stages, m_nu1 = 10, m_nu2 = 10, m_gamma = 1;
+};
+
+/**
+* @brief Mixed precision nested iterations: coarse stages in reduced
+* precision to solve \f[ \hat O \phi = \rho\f]
+*
+* Same algorithm as \c dg::MultigridCG2d but all stages except the finest
+* run with a second (typically \c float) container type, which roughly
+* doubles the effective memory bandwidth of the coarse grid solves on
+* bandwidth-bound hardware. The residual and the initial guess are projected
+* to the second stage with the \c double transfer operators of the finest
+* grid and then converted with \c dg::assign; the coarse correction is
+* converted back before it is interpolated onto the finest grid. Since the
+* coarse stages only ever produce a correction to the initial guess of the
+* final full precision solve, the overall achievable accuracy is @b not
+* reduced, only the accuracy requested from the coarse stages is limited to
+* roughly \f$ 10^{-6}\f$ in \c float.
+*
+* @tparam CoarseMatrix the \c Matrix analogon for \c CoarseContainer (e.g. \c dg::fDMatrix)
+* @tparam CoarseContainer the reduced precision container (e.g. \c dg::fDVec)
+* @copydoc hide_geometry_matrix_container
+* @sa \c MultigridCG2d
+*/
+template< class Geometry, class Matrix, class Container, class CoarseMatrix, class CoarseContainer>
+struct MixedMultigridCG2d
+{
+    using geometry_type = Geometry;
+    using matrix_type = Matrix;
+    using container_type = Container;
+    using value_type = get_value_type<Container>;
+    using coarse_value_type = get_value_type<CoarseContainer>;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    MixedMultigridCG2d() = default;
+    ///@copydoc MultigridCG2d::MultigridCG2d(const Geometry&,const unsigned,ContainerParams&&...)
+    template<class ...ContainerParams>
+    MixedMultigridCG2d( const Geometry& grid, const unsigned stages,
+            ContainerParams&& ... ps):
+        m_stages(stages)
+    {
+        if(stages < 2 )
+            throw Error( Message(_ping_)<<" There must be minimum 2 stages in mixed precision multigrid! You gave " << stages);
+        //a one stage hierarchy holds the fine grid and its transfer operators
+        m_nested.construct( grid, 2, std::forward<ContainerParams>(ps)...);
+        //the remaining stages all live in reduced precision
+        m_nested_c.construct( m_nested.grid(1), stages-1);
+        m_pcg.construct(m_nested.x(0), m_nested.grid(0).size());
+        m_pcg_c.resize( stages-1);
+        for (unsigned u = 0; u < stages-1; u++)
+            m_pcg_c[u].construct(m_nested_c.x(u), m_nested_c.grid(u).size());
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = MixedMultigridCG2d( std::forward<Params>( ps)...);
+    }
+    ///@return number of stages (same as \c stages)
+    unsigned stages()const{return m_stages;}
+    ///@brief return the grid at given stage
+    ///@param stage must fulfill \c 0 <= stage < stages()
+    const Geometry& grid( unsigned stage) const {
+        return stage == 0 ? m_nested.grid(0) : m_nested_c.grid(stage-1);
+    }
+    ///@copydoc MultigridCG2d::copyable()const
+    const Container& copyable() const {return m_nested.copyable();}
+    ///@copydoc MultigridCG2d::set_benchmark(bool,std::string)
+    void set_benchmark( bool benchmark, std::string message = "Mixed Nested Iterations"){
+        m_benchmark = benchmark;
+        m_message = message;
+    }
+    /**
+     * @brief Mixed precision nested iterations
+     *
+     * same as \c MultigridCG2d::solve except that stages > 0 run with
+     * \c CoarseContainer precision
+     * @param op The \c MatrixType on the original grid;
+     *  \c op.precond() and \c op.weights() need to be callable!
+     * @param coarse_ops Index 0 is the coarse \c MatrixType on the half
+     *  grid, 1 on the quarter grid, ...; (size \c stages-1 );
+     *  \c coarse_ops[u].precond() and \c coarse_ops[u].weights() need to be
+     *  callable!
+     * @param x (read/write) contains initial guess on input and the solution on output
+     * @param b The right hand side
+     * @param eps the accuracy; on the coarse stages it is limited to what
+     *  the reduced precision can resolve (\f$ 10^{-6}\f$ in \c float)
+     * @return the number of iterations in each of the stages beginning with the finest grid
+     * @copydoc hide_matrix
+     * @copydoc hide_ContainerType
+    */
+    template<class MatrixType0, class MatrixType1, class ContainerType0, class ContainerType1>
+    std::vector<unsigned> solve( MatrixType0&& op, std::vector<MatrixType1>&
+            coarse_ops, ContainerType0& x, const ContainerType1& b, value_type eps)
+    {
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+        std::vector<unsigned> number(m_stages);
+        dg::Timer t;
+        //limit what we ask of the reduced precision stages
+        coarse_value_type eps_c = eps;
+        if( eps < 1e4*std::numeric_limits<coarse_value_type>::epsilon())
+            eps_c = 1e4*std::numeric_limits<coarse_value_type>::epsilon();
+        // fine residual r = b - A x
+        dg::apply( std::forward<MatrixType0>(op), x, m_nested.r(0));
+        dg::blas1::axpby(1., b, -1., m_nested.r(0));
+        dg::blas1::copy( x, m_nested.x(0));
+        // project to the second stage in full precision, then convert
+        dg::blas2::gemv( m_nested.projection(0), m_nested.r(0), m_nested.r(1));
+        dg::blas2::gemv( m_nested.projection(0), m_nested.x(0), m_nested.x(1));
+        dg::assign( m_nested.r(1), m_nested_c.r(0));
+        dg::assign( m_nested.x(1), m_nested_c.x(0));
+        // FAS right hand sides down the coarse hierarchy
+        dg::blas2::symv( coarse_ops[0], m_nested_c.x(0), m_nested_c.b(0));
+        dg::blas1::axpby( 1., m_nested_c.r(0), 1., m_nested_c.b(0));
+        dg::blas1::copy( m_nested_c.x(0), m_nested_c.w(0));
+        for( unsigned u=0; u<m_stages-2; u++)
+        {
+            dg::blas2::gemv( m_nested_c.projection(u), m_nested_c.r(u), m_nested_c.r(u+1));
+            dg::blas2::gemv( m_nested_c.projection(u), m_nested_c.x(u), m_nested_c.x(u+1));
+            dg::blas2::symv( coarse_ops[u+1], m_nested_c.x(u+1), m_nested_c.b(u+1));
+            dg::blas1::axpby( 1., m_nested_c.b(u+1), 1., m_nested_c.r(u+1), m_nested_c.b(u+1));
+            dg::blas1::copy( m_nested_c.x(u+1), m_nested_c.w(u+1));
+        }
+        //solve upward through the coarse hierarchy
+        for( int u=(int)m_stages-2; u>=0; u--)
+        {
+            t.tic();
+            try{
+                number[u+1] = m_pcg_c[u].solve( coarse_ops[u], m_nested_c.x(u),
+                    m_nested_c.b(u), coarse_ops[u].precond(),
+                    coarse_ops[u].weights(), eps_c, 1, 10);
+            }catch( dg::Error& err){
+                err.append_line( dg::Message(_ping_)<<"ERROR on coarse stage "<<u+1<<" of mixed precision multigrid");
+                throw;
+            }
+            t.toc();
+            if( m_benchmark)
+                DG_RANK0 std::cout << "# `"<<m_message<<"` stage: " << u+1 << ", iter: " << number[u+1] << ", took "<<t.diff()<<"s\n";
+            // delta
+            dg::blas1::axpby( 1., m_nested_c.x(u), -1., m_nested_c.w(u), m_nested_c.x(u) );
+            if( u>0) // update initial guess
+                dg::blas2::symv( 1., m_nested_c.interpolation(u-1),
+                        m_nested_c.x(u), 1., m_nested_c.x(u-1));
+        }
+        //convert the correction back and update the fine initial guess
+        dg::assign( m_nested_c.x(0), m_nested.x(1));
+        dg::blas2::symv( 1., m_nested.interpolation(0), m_nested.x(1), 1.,
+                m_nested.x(0));
+        dg::blas1::copy( m_nested.x(0), x);
+        t.tic();
+        number[0] = m_pcg.solve( std::forward<MatrixType0>(op), x, b,
+                op.precond(), op.weights(), eps, 1, 1);
+        t.toc();
+        if( m_benchmark)
+            DG_RANK0 std::cout << "# `"<<m_message<<"` stage: " << 0 << ", iter: " << number[0] << ", took "<<t.diff()<<"s\n";
+        return number;
+    }
 
+  private:
+    dg::NestedGrids<Geometry, Matrix, Container> m_nested;
+    dg::NestedGrids<Geometry, CoarseMatrix, CoarseContainer> m_nested_c;
+    PCG<Container> m_pcg;
+    std::vector< PCG<CoarseContainer> > m_pcg_c;
+    unsigned m_stages;
+    bool m_benchmark = true;
+    std::string m_message = "Mixed Nested Iterations";
+};
+
+/**
+* @brief Nested iterations with the coarse stages on the host: solve
+* \f[ \hat O \phi = \rho\f]
+*
+* The backend is fixed at compile time through \c THRUST_DEVICE_SYSTEM, but
+* on a GPU the coarse stages of the grid hierarchy are dominated by kernel
+* launch latency and run faster on the CPU. This class runs the same
+* algorithm as \c dg::MultigridCG2d but all stages with fewer than a
+* tunable number of grid points solve with a second (host) matrix and
+* container type: the residual and initial guess are projected to the
+* boundary stage with the device transfer operators and crossed over with
+* \c dg::assign, the host stages solve and transfer among themselves, and
+* the coarse correction is converted back before it is interpolated onto
+* the next device stage. The finest stage always stays on the device.
+* @note The host kernels are parallelized with OpenMP if the code is
+* compiled with \c -DTHRUST_HOST_SYSTEM=THRUST_HOST_SYSTEM_OMP (serial per
+* default)
+* @tparam HostMatrix the \c Matrix analogon for \c HostContainer (e.g. \c dg::HMatrix)
+* @tparam HostContainer the host container (e.g. \c dg::HVec)
+* @copydoc hide_geometry_matrix_container
+* @sa \c MultigridCG2d \c MixedMultigridCG2d
+*/
+template< class Geometry, class Matrix, class Container, class HostMatrix, class HostContainer>
+struct HybridMultigridCG2d
+{
+    using geometry_type = Geometry;
+    using matrix_type = Matrix;
+    using container_type = Container;
+    using value_type = get_value_type<Container>;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    HybridMultigridCG2d() = default;
+    /**
+     * @brief Construct the grids and the projection/interpolation operators
+     *
+     * @param grid the original grid (Nx() and Ny() must be evenly divisable by pow(2, stages-1)
+     * @param stages number of grids in total (The second grid contains half the points of the original grids,
+     *   The third grid contains half of the second grid ...). Must be >= 1
+     * @param min_device_size stages with fewer than \c min_device_size grid
+     *  points solve on the host; the finest stage always stays on the
+     *  device. Tune to the grid size where a host solve of your operator
+     *  overtakes the device solve (typically somewhere around \f$ 64^2\f$
+     *  points on a discrete GPU)
+     * @param ps parameters necessary for \c dg::construct to construct a \c Container from a \c dg::HVec
+    */
+    template<class ...ContainerParams>
+    HybridMultigridCG2d( const Geometry& grid, const unsigned stages,
+            unsigned min_device_size, ContainerParams&& ... ps):
+        m_stages(stages)
+    {
+        if(stages < 1 )
+            throw Error( Message(_ping_)<<" There must be minimum 1 stage in hybrid multigrid! You gave " << stages);
+        //count the stages that stay on the device
+        m_split = 1;
+        {
+            dg::ClonePtr<Geometry> tmp;
+            tmp.reset( grid);
+            for( unsigned u=1; u<stages; u++)
+            {
+                tmp->multiplyCellNumbers( 0.5, 0.5);
+                if( tmp->size() < min_device_size)
+                    break;
+                m_split = u+1;
+            }
+        }
+        //the device hierarchy additionally holds the boundary stage for staging
+        unsigned stages_d = m_split < m_stages ? m_split+1 : m_stages;
+        m_nested.construct( grid, stages_d, std::forward<ContainerParams>(ps)...);
+        m_pcg.resize( m_split);
+        for( unsigned u=0; u<m_split; u++)
+            m_pcg[u].construct( m_nested.x(u), m_nested.grid(u).size());
+        if( m_split < m_stages)
+        {
+            m_nested_h.construct( m_nested.grid(m_split), m_stages-m_split);
+            m_pcg_h.resize( m_stages-m_split);
+            for( unsigned u=0; u<m_stages-m_split; u++)
+                m_pcg_h[u].construct( m_nested_h.x(u), m_nested_h.grid(u).size());
+        }
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = HybridMultigridCG2d( std::forward<Params>( ps)...);
+    }
+    ///@return number of stages (same as \c stages)
+    unsigned stages()const{return m_stages;}
+    ///@brief The number of stages that solve on the device
+    unsigned device_stages()const{return m_split;}
+    ///@brief return the grid at given stage
+    ///@param stage must fulfill \c 0 <= stage < stages()
+    const Geometry& grid( unsigned stage) const {
+        return stage < m_split ? m_nested.grid(stage)
+                               : m_nested_h.grid(stage-m_split);
+    }
+    ///@copydoc MultigridCG2d::copyable()const
+    const Container& copyable() const {return m_nested.copyable();}
+    ///@copydoc MultigridCG2d::set_benchmark(bool,std::string)
+    void set_benchmark( bool benchmark, std::string message = "Hybrid Nested Iterations"){
+        m_benchmark = benchmark;
+        m_message = message;
+    }
+    /**
+     * @brief Hybrid nested iterations
+     *
+     * same as \c MultigridCG2d::solve except that the stages >= \c
+     * device_stages() run with \c HostContainer on the host
+     * @param ops Index 0 is the \c MatrixType on the original grid, 1 on
+     *  the half grid, ... (size \c device_stages() );
+     *  \c ops[u].precond() and \c ops[u].weights() need to be callable!
+     * @param ops_h The host \c MatrixType on the remaining grids, index 0
+     *  on \c grid(device_stages()), ... (size \c stages()-device_stages() )
+     * @param x (read/write) contains initial guess on input and the solution on output
+     * @param b The right hand side
+     * @param eps the accuracy
+     * @return the number of iterations in each of the stages beginning with the finest grid
+     * @copydoc hide_matrix
+     * @copydoc hide_ContainerType
+    */
+    template<class MatrixType0, class MatrixType1, class ContainerType0, class ContainerType1>
+    std::vector<unsigned> solve( std::vector<MatrixType0>& ops,
+            std::vector<MatrixType1>& ops_h, ContainerType0& x,
+            const ContainerType1& b, value_type eps)
+    {
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+        std::vector<unsigned> number(m_stages);
+        dg::Timer t;
+        unsigned stages_d = m_nested.stages();
+        // fine residual r = b - A x
+        dg::apply( ops[0], x, m_nested.r(0));
+        dg::blas1::axpby(1., b, -1., m_nested.r(0));
+        dg::blas1::copy( x, m_nested.x(0));
+        // FAS right hand sides down the device hierarchy
+        for( unsigned u=0; u<stages_d-1; u++)
+        {
+            dg::blas2::gemv( m_nested.projection(u), m_nested.r(u), m_nested.r(u+1));
+            dg::blas2::gemv( m_nested.projection(u), m_nested.x(u), m_nested.x(u+1));
+            if( u+1 < m_split)
+            {
+                dg::blas2::symv( ops[u+1], m_nested.x(u+1), m_nested.b(u+1));
+                dg::blas1::axpby( 1., m_nested.r(u+1), 1., m_nested.b(u+1));
+                dg::blas1::copy( m_nested.x(u+1), m_nested.w(u+1));
+            }
+        }
+        if( m_split < m_stages)
+        {
+            // cross over to the host at the boundary stage
+            dg::assign( m_nested.r(stages_d-1), m_nested_h.r(0));
+            dg::assign( m_nested.x(stages_d-1), m_nested_h.x(0));
+            dg::blas2::symv( ops_h[0], m_nested_h.x(0), m_nested_h.b(0));
+            dg::blas1::axpby( 1., m_nested_h.r(0), 1., m_nested_h.b(0));
+            dg::blas1::copy( m_nested_h.x(0), m_nested_h.w(0));
+            for( unsigned u=0; u<m_nested_h.stages()-1; u++)
+            {
+                dg::blas2::gemv( m_nested_h.projection(u), m_nested_h.r(u), m_nested_h.r(u+1));
+                dg::blas2::gemv( m_nested_h.projection(u), m_nested_h.x(u), m_nested_h.x(u+1));
+                dg::blas2::symv( ops_h[u+1], m_nested_h.x(u+1), m_nested_h.b(u+1));
+                dg::blas1::axpby( 1., m_nested_h.r(u+1), 1., m_nested_h.b(u+1));
+                dg::blas1::copy( m_nested_h.x(u+1), m_nested_h.w(u+1));
+            }
+            //solve upward through the host hierarchy
+            for( int u=(int)m_nested_h.stages()-1; u>=0; u--)
+            {
+                t.tic();
+                try{
+                    number[m_split+u] = m_pcg_h[u].solve( ops_h[u],
+                        m_nested_h.x(u), m_nested_h.b(u), ops_h[u].precond(),
+                        ops_h[u].weights(), eps, 1, 10);
+                }catch( dg::Error& err){
+                    err.append_line( dg::Message(_ping_)<<"ERROR on host stage "<<m_split+u<<" of hybrid multigrid");
+                    throw;
+                }
+                t.toc();
+                if( m_benchmark)
+                    DG_RANK0 std::cout << "# `"<<m_message<<"` stage: " << m_split+u << " (host), iter: " << number[m_split+u] << ", took "<<t.diff()<<"s\n";
+                // delta
+                dg::blas1::axpby( 1., m_nested_h.x(u), -1., m_nested_h.w(u), m_nested_h.x(u));
+                if( u>0) // update initial guess
+                    dg::blas2::symv( 1., m_nested_h.interpolation(u-1),
+                            m_nested_h.x(u), 1., m_nested_h.x(u-1));
+            }
+            //convert the correction back and update the device initial guess
+            dg::assign( m_nested_h.x(0), m_nested.x(stages_d-1));
+            dg::blas2::symv( 1., m_nested.interpolation(stages_d-2),
+                    m_nested.x(stages_d-1), 1., m_nested.x(stages_d-2));
+        }
+        //solve upward through the device hierarchy
+        for( int u=(int)m_split-1; u>=1; u--)
+        {
+            t.tic();
+            try{
+                number[u] = m_pcg[u].solve( ops[u], m_nested.x(u),
+                    m_nested.b(u), ops[u].precond(), ops[u].weights(), eps,
+                    1, 10);
+            }catch( dg::Error& err){
+                err.append_line( dg::Message(_ping_)<<"ERROR on stage "<<u<<" of hybrid multigrid");
+                throw;
+            }
+            t.toc();
+            if( m_benchmark)
+                DG_RANK0 std::cout << "# `"<<m_message<<"` stage: " << u << ", iter: " << number[u] << ", took "<<t.diff()<<"s\n";
+            // delta
+            dg::blas1::axpby( 1., m_nested.x(u), -1., m_nested.w(u), m_nested.x(u));
+            dg::blas2::symv( 1., m_nested.interpolation(u-1), m_nested.x(u),
+                    1., m_nested.x(u-1));
+        }
+        dg::blas1::copy( m_nested.x(0), x);
+        t.tic();
+        number[0] = m_pcg[0].solve( ops[0], x, b, ops[0].precond(),
+                ops[0].weights(), eps, 1, 1);
+        t.toc();
+        if( m_benchmark)
+            DG_RANK0 std::cout << "# `"<<m_message<<"` stage: " << 0 << ", iter: " << number[0] << ", took "<<t.diff()<<"s\n";
+        return number;
+    }
+
+  private:
+    dg::NestedGrids<Geometry, Matrix, Container> m_nested;
+    dg::NestedGrids<Geometry, HostMatrix, HostContainer> m_nested_h;
+    std::vector< PCG<Container> > m_pcg;
+    std::vector< PCG<HostContainer> > m_pcg_h;
+    unsigned m_stages, m_split = 1;
+    bool m_benchmark = true;
+    std::string m_message = "Hybrid Nested Iterations";
+};
+
+#ifdef MPI_VERSION
+/**
+ * @brief Gather an MPI problem onto a single rank, solve there, scatter back
+ *
+ * Below roughly \f$ 32^2\f$ points per rank the global reductions of a
+ * distributed Krylov solve are pure latency, which makes the coarse stages
+ * of \c dg::nested_iterations or \c dg::multigrid_cycle scale badly. This
+ * class agglomerates such a stage: the right hand side and initial guess
+ * are gathered onto a single root rank with a \c dg::BijectiveComm and
+ * reordered into global grid order, the root solves the global problem
+ * with the shared memory backend (no reductions at all), and the solution
+ * is scattered back. The other ranks idle in the scatter until the root is
+ * done.
+ *
+ * The intended use is as the coarse stage inverse operator in
+ * \c dg::nested_iterations, with the global operator assembled on
+ * \c grid.global():
+ * @code{.cpp}
+dg::Agglomeration<dg::iDVec, dg::DVec> agg( nested.grid(s));
+dg::Elliptic<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> op_glob(
+    nested.grid(s).global());
+dg::PCG<dg::DVec> pcg( agg.global_copyable(), 1000);
+inverse_ops[s] = [&]( const auto& y, auto& x){
+    agg.solve( [&]( const auto& bg, auto& xg){
+        pcg.solve( op_glob, xg, bg, op_glob.precond(), op_glob.weights(),
+            eps);}, x, y);
+};
+ * @endcode
+ * @note Agglomeration onto more than one rank (e.g. one rank per node)
+ * would need the coarse operator assembled on a subcommunicator grid and
+ * is not implemented; in practice the coarse stages are small enough that
+ * a single rank suffices.
+ * @tparam Index an integer thrust Vector
+ * @tparam Vector a thrust Vector, the local \c container_type of the
+ * \c dg::MPI_Vector used in the distributed stages
+ * @sa \c dg::NestedGrids \c dg::nested_iterations
+ */
+template<class Index, class Vector>
+struct Agglomeration
+{
+    using value_type = get_value_type<Vector>;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    Agglomeration() = default;
+    /**
+     * @brief Construct the gather/scatter pattern for the given topology
+     *
+     * @param g the (coarse) MPI topology of the stage to agglomerate
+     * @param root the rank in \c g.communicator() that solves the global
+     * problem
+     */
+    template<class MPITopology>
+    Agglomeration( const MPITopology& g, int root = 0): m_root(root)
+    {
+        MPI_Comm comm = g.communicator();
+        MPI_Comm_rank( comm, &m_rank);
+        int np;
+        MPI_Comm_size( comm, &np);
+        const unsigned local_size = g.local().size();
+        thrust::host_vector<int> pids( local_size, root);
+        m_gather = BijectiveComm<Index, Vector>( pids, comm);
+        m_buffer = m_gather.allocate_buffer();
+        if( m_rank == root)
+        {
+            //the gathered buffer is ordered by rank of origin, then local
+            //index; compute the global grid index of every buffer position
+            thrust::host_vector<int> perm( g.size());
+            unsigned k = 0;
+            for( int r=0; r<np; r++)
+            for( unsigned i=0; i<local_size; i++)
+            {
+                int gIdx = 0;
+                g.local2globalIdx( i, r, gIdx);
+                perm[k++] = gIdx;
+            }
+            dg::assign( perm, m_perm);
+            m_b = m_x = dg::construct<Vector>(
+                thrust::host_vector<value_type>( g.size(), 0.));
+        }
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        *this = Agglomeration( std::forward<Params>( ps)...);
+    }
+    ///@brief Return an object of the size of the global problem (empty on all ranks except root)
+    ///@return A copyable object; what it contains is undefined, its size is important
+    const Vector& global_copyable() const {return m_x;}
+    /**
+     * @brief Gather, solve on root, scatter back
+     *
+     * Every rank in the communicator must call this method.
+     * @param solve_on_root callable as \c solve_on_root(b_glob,x_glob)
+     * with global vectors in global grid order; only invoked on the root
+     * rank. On call \c x_glob contains the gathered initial guess and
+     * should contain the solution on return.
+     * @param x (read/write) the distributed initial guess on input, the
+     * scattered solution on output
+     * @param b the distributed right hand side
+     */
+    template< class SolveOnRoot, class MPIContainer>
+    void solve( SolveOnRoot&& solve_on_root, MPIContainer& x, const MPIContainer& b)
+    {
+        m_gather.global_gather( thrust::raw_pointer_cast( x.data().data()),
+            m_buffer);
+        if( m_rank == m_root)
+            thrust::scatter( m_buffer.begin(), m_buffer.end(),
+                m_perm.begin(), m_x.begin());
+        m_gather.global_gather( thrust::raw_pointer_cast( b.data().data()),
+            m_buffer);
+        if( m_rank == m_root)
+        {
+            thrust::scatter( m_buffer.begin(), m_buffer.end(),
+                m_perm.begin(), m_b.begin());
+            solve_on_root( m_b, m_x);
+            thrust::gather( m_perm.begin(), m_perm.end(), m_x.begin(),
+                m_buffer.begin());
+        }
+        m_gather.global_scatter_reduce( m_buffer,
+            thrust::raw_pointer_cast( x.data().data()));
+    }
+  private:
+    BijectiveComm<Index, Vector> m_gather;
+    Vector m_buffer, m_b, m_x;
+    Index m_perm;
+    int m_rank, m_root;
 };
+#endif //MPI_VERSION
 ///@}
 
 }//namespace dg
@@ -147,6 +147,39 @@ int main()
         res.d = sqrt(dg::blas1::dot( y0, y0)/norm_sol);
         std::cout << "Relative error: "<<std::setw(20) <<name<<"\t"<< res.d<<"\t"<<res.i<<std::endl;
     }
+    std::cout << "### Test adaptive ImEx multistep methods with "<<NT<<" steps\n";
+    for( auto name : imex_names)
+    {
+        dg::AdaptiveImExMultistep< std::array<double,2> > aimex( name, y0);
+        aimex.set_tolerance( 1e-12, 1e-6);
+        //a direct solver: the scheduled eps and the update flag are hints only
+        auto solver = [&im]( double alpha, double t, std::array<double,2>& y,
+                const std::array<double,2>& rhs, double eps, bool update)
+        {
+            im( alpha, t, y, rhs);
+        };
+        time = 0., y0 = init;
+        aimex.init( std::tie(ex, im, solver), time, y0, dt);
+        for( unsigned k=0; k<NT; k++)
+            aimex.step( std::tie(ex, im, solver), time, y0); //inplace step
+        dg::blas1::axpby( -1., sol, 1., y0);
+        res.d = sqrt(dg::blas1::dot( y0, y0)/norm_sol);
+        std::cout << "Relative error: "<<std::setw(20) <<name<<"\t"<< res.d<<"\t"<<res.i<<std::endl;
+    }
+    std::cout << "### Test multirate multistep methods with "<<NT<<" macro steps\n";
+    for( auto name : {"AB-1-1", "AB-2-2", "AB-3-3"})
+    {
+        //slow part is ex, fast part is the diffusion tendency of im
+        dg::MultirateMultistep< std::array<double,2> > mrms( name,
+                "Runge-Kutta-4-4", 4, y0);
+        time = 0., y0 = init;
+        mrms.init( std::tie(ex, im), time, y0, dt);
+        for( unsigned k=0; k<NT; k++)
+            mrms.step( std::tie(ex, im), time, y0); //inplace step
+        dg::blas1::axpby( -1., sol, 1., y0);
+        res.d = sqrt(dg::blas1::dot( y0, y0)/norm_sol);
+        std::cout << "Relative error: "<<std::setw(20) <<name<<"\t"<< res.d<<"\t"<<res.i<<std::endl;
+    }
     std::cout << "### Test semi-implicit ARK methods with 40 steps\n";
     std::vector<std::string> ark_names{"Cavaglieri-3-1-2", "Cavaglieri-4-2-3", "ARK-4-2-3", "ARK-6-3-4", "ARK-8-4-5"};
     for( auto name : ark_names)
@@ -225,5 +258,27 @@ int main()
         std::cout << std::setw(4)<<counter <<" steps! ";
         std::cout << "Relative error: "<<std::setw(24) <<name<<"\t"<<res.d<<"\n";
     }
+    std::cout << "### Test restart from saved multistep history\n";
+    {
+        time = 0., y0 = init;
+        dg::ExplicitMultistep< std::array<double,2> > ab( "AB-3-3", y0);
+        ab.init( full, time, y0, dt);
+        for( unsigned k=0; k<NT/2; k++)
+            ab.step( full, time, y0);
+        //pretend a restart: save the history and continue in a new stepper
+        std::vector<std::array<double,2>> saved = ab.history();
+        dg::ExplicitMultistep< std::array<double,2> > restarted( "AB-3-3", y0);
+        std::array<double,2> y1( y0);
+        double time1 = ab.last_time();
+        restarted.init_from_history( full, time1, saved, dt);
+        for( unsigned k=0; k<NT/2; k++)
+        {
+            ab.step( full, time, y0);
+            restarted.step( full, time1, y1);
+        }
+        dg::blas1::axpby( -1., y0, 1., y1);
+        res.d = sqrt( dg::blas1::dot( y1, y1));
+        std::cout << "Difference restarted - continued: "<<res.d<<" (expect exactly 0)\n";
+    }
     return 0;
 }
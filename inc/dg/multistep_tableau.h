@@ -631,6 +631,21 @@ MultistepTableau<real_type> lmstableau( std::string name)
  *
 */
 
+/*! @class hide_multirate_multistep_tableaus
+ *
+ * The slow part of a multirate method is an explicit multistep method, so any
+ * of the explicit tableaus can formally be used. However, the starting value
+ * of the fast sub-integration is the multistep combination \f$ \tilde v =
+ * \sum_j a_j v^{n-j}\f$, which coincides with the current solution \f$ v^n\f$
+ * only for the Adams type methods:
+ *
+ *    Name  | Identifier | Description
+ *   -------|------------| -----------
+ *   AB-X-X | dg::AB_X_X | **recommended** the Adams-Bashforth schemes have \f$ a_0=1,\ a_{j>0}=0\f$ so the fast subsystem is integrated from the current solution @note **Possible stages are X: 1, 2,..., 5**
+ * eBDF-X-X | dg::eBDF_X_X | usable, but the fast integration starts from an extrapolated state, which introduces an additional first order coupling error
+ * TVB-X-X | dg::TVB_X_X | usable, with the same caveat as eBDF
+*/
+
 /*! @brief Convert identifiers to their corresponding \c dg::MultistepTableau
  *
  * This is a helper class to simplify the interfaces of our timestepper functions and classes.
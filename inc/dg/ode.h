@@ -2,6 +2,8 @@
 #include <functional>
 #include "blas1.h"
 #include "backend/tensor_traits.h"
+#include "backend/memory.h"
+#include "backend/prof.h"
 
 /*! @file
   @brief An abstract ODE integrator
@@ -196,6 +198,183 @@ struct aTimeloop
 
 };
 
+/*!@brief Drive an \c aTimeloop with registered callbacks on configurable cadences
+ *
+ * Our applications all organize their time loop in the same way: \c maxout
+ * outputs of \c itstp inner steps each, with per-step diagnostics, file
+ * output at the (exact) output times and an occasional restart checkpoint.
+ * This class implements that loop once, around any \c aTimeloop:
+ * @code
+ * dg::Timeloop<Container> timeloop(
+ *     dg::AdaptiveTimeloop<Container>( adapt, ode, dg::pid_control,
+ *         dg::l2norm, rtol, atol));
+ * timeloop.set_monitor( [&]( double time, const Container& u){
+ *     std::cout << "Time "<<time<<" dt "<<timeloop.get_dt()<<"\n";
+ *     return true; //false stops the loop after the next output
+ * });
+ * timeloop.set_output( [&]( double time, const Container& u){
+ *     write_fields( ncid, time, u); //may also enqueue to a dg::file::AsyncWriter
+ *     return true;
+ * });
+ * timeloop.set_checkpoint( [&]( double time, const Container& u){
+ *     checkpointer.write( time, u);
+ *     return true;
+ * }, 10); //every 10th output
+ * timeloop.run( t_begin, t_end, u0, maxout, itstp);
+ * @endcode
+ * The inner steps integrate to equidistant times in \c dg::to::at_least mode
+ * and only the output times are matched exactly, so an adaptive stepper takes
+ * the same steps as an uninterrupted integration from \c t_begin to \c t_end
+ * (see the second \c integrate function of \c aTimeloop).
+ *
+ * Each section of the loop is an instrumentation region of the scoped
+ * profiler ( "timeloop::step", "timeloop::monitor", "timeloop::output",
+ * "timeloop::checkpoint"); without \c -DDG_PROF these compile away entirely,
+ * so the loop costs nothing over a handwritten one.
+ * @note If the stepper throws, the output callback is invoked once more with
+ * the last valid state before the exception propagates ("write last output
+ * and exit"), so a crashed simulation can still be inspected and restarted.
+ * @note The callbacks receive the state read-only; an asynchronous output
+ * engine must therefore copy (or stage) the data before it returns.
+ * @copydoc hide_ContainerType
+ * @ingroup time_utils
+ */
+template<class ContainerType>
+struct Timeloop
+{
+    using value_type = dg::get_value_type<ContainerType>;
+    using container_type = ContainerType;
+    /// Signature of all callbacks; return \c false to stop the loop after the next output
+    using callback_type = std::function<bool( value_type, const ContainerType&)>;
+    /// no allocation
+    Timeloop() = default;
+    /**
+     * @brief Construct driving the given timeloop
+     * @param odeint is cloned and stored internally (so it is allowed to go
+     * out of scope after construction)
+     */
+    Timeloop( const aTimeloop<ContainerType>& odeint) : m_odeint( odeint){}
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = Timeloop( std::forward<Params>( ps)...);
+    }
+    /**
+     * @brief Register the per-step diagnostics callback
+     * @param monitor called after every \c cadence -th inner step as
+     * <tt> monitor( time, u) </tt>; return \c false to stop the loop
+     * gracefully (the current output interval is finished and a last output
+     * is written)
+     * @param cadence number of inner steps between calls (0 counts as 1)
+     */
+    void set_monitor( callback_type monitor, unsigned cadence = 1)
+    {
+        m_monitor = monitor;
+        m_monitor_cadence = cadence == 0 ? 1 : cadence;
+    }
+    /**
+     * @brief Register the output callback
+     * @param output called with the initial condition and thereafter at the
+     * \c maxout (exactly matched) output times as <tt> output( time, u) </tt>;
+     * return \c false to stop the loop gracefully
+     */
+    void set_output( callback_type output)
+    {
+        m_output = output;
+    }
+    /**
+     * @brief Register the restart checkpoint callback
+     * @param checkpoint called after every \c cadence -th output as
+     * <tt> checkpoint( time, u) </tt>; return \c false to stop the loop
+     * gracefully
+     * @param cadence number of outputs between calls (0 counts as 1)
+     */
+    void set_checkpoint( callback_type checkpoint, unsigned cadence = 1)
+    {
+        m_checkpoint = checkpoint;
+        m_checkpoint_cadence = cadence == 0 ? 1 : cadence;
+    }
+    ///@copydoc aTimeloop::get_dt()
+    value_type get_dt() const { return m_odeint->get_dt();}
+
+    /**
+     * @brief Run the time loop
+     *
+     * Integrate from \c t_begin to \c t_end in \c maxout output intervals of
+     * \c itstp inner steps each, invoking the registered callbacks on their
+     * cadences
+     * @param t_begin initial time
+     * @param t_end end time
+     * @param u0 (read-write) initial condition on entry; on exit the solution
+     * at the time of the last output (\c t_end unless a callback stopped the
+     * loop early)
+     * @param maxout number of outputs (not counting the initial condition)
+     * @param itstp number of inner steps per output
+     * @attention The function may throw \c dg::Error (or anything derived
+     * from \c std::exception); the output callback is invoked with the last
+     * valid state before the exception propagates
+     */
+    void run( value_type t_begin, value_type t_end, ContainerType& u0,
+            unsigned maxout, unsigned itstp = 1)
+    {
+        value_type time = t_begin;
+        value_type deltaT = (t_end - t_begin)/(value_type)(maxout*itstp);
+        if( m_output && !m_output( time, u0)) //the initial condition
+            return;
+        bool abort = false;
+        for( unsigned i=1; i<=maxout && !abort; i++)
+        {
+            for( unsigned j=1; j<=itstp; j++)
+            {
+                unsigned step = (i-1)*itstp + j;
+                try{
+                    DG_PROF_SCOPE( "timeloop::step");
+                    m_odeint->integrate( time, u0, t_begin + step*deltaT, u0,
+                        j<itstp ? dg::to::at_least : dg::to::exact);
+                }
+                catch( dg::Error& err)
+                {
+                    if( m_output)
+                        m_output( time, u0); //write last output and exit
+                    err.append_line( dg::Message(_ping_) << "Error in Timeloop::run in inner step "<<j<<" of output "<<i<<" at time "<<time);
+                    throw;
+                }
+                catch( ...)
+                {
+                    if( m_output)
+                        m_output( time, u0); //write last output and exit
+                    throw;
+                }
+                if( m_monitor && step%m_monitor_cadence == 0)
+                {
+                    DG_PROF_SCOPE( "timeloop::monitor");
+                    if( !m_monitor( time, u0))
+                        abort = true; //still write the output below
+                }
+                if( abort)
+                    break;
+            }
+            {
+                DG_PROF_SCOPE( "timeloop::output");
+                if( m_output && !m_output( time, u0))
+                    abort = true;
+            }
+            if( m_checkpoint && i%m_checkpoint_cadence == 0)
+            {
+                DG_PROF_SCOPE( "timeloop::checkpoint");
+                if( !m_checkpoint( time, u0))
+                    abort = true;
+            }
+        }
+    }
+    private:
+    dg::ClonePtr<aTimeloop<ContainerType>> m_odeint;
+    callback_type m_monitor, m_output, m_checkpoint;
+    unsigned m_monitor_cadence = 1, m_checkpoint_cadence = 1;
+};
+
 ///@}
 
 }//namespace dg
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cmath>
+#include "blas1.h"
+#include "ode.h"
+#include "backend/memory.h"
+#ifdef MPI_VERSION
+#include "backend/mpi_communicator.h"
+#endif
+
+/*! @file
+ * @brief Parallel-in-time integration
+ */
+namespace dg
+{
+#ifdef MPI_VERSION
+
+/*!@brief Parareal: parallelize the time-axis over MPI ranks
+ *
+ * Simulations that are short on space but long in time stop scaling once
+ * the spatial domain decomposition saturates.  The parareal algorithm
+ * [Lions, Maday, Turinici, 2001] opens the time-axis as an additional
+ * direction of parallelism: the integration interval \f$ [t_0,t_1]\f$ is cut
+ * into \c P time slabs (one per rank in \c comm) and the iteration
+ * \f[ U_{r+1}^{k+1} = \mathcal G( U_r^{k+1}) + \mathcal F( U_r^k)
+ *      - \mathcal G( U_r^k) \f]
+ * corrects the slab start values \f$ U_r \approx u(t_0 + r\Delta T)\f$.  Here
+ * \f$ \mathcal F\f$ is the expensive fine propagator (the integrator you
+ * would use in a serial run) and \f$ \mathcal G\f$ is a cheap coarse
+ * propagator, typically a low order stepper with a large timestep.  In every
+ * iteration all ranks run \f$ \mathcal F\f$ over their slab **in parallel**,
+ * only the coarse correction sweeps sequentially through the ranks.  After
+ * \c k iterations the first \c k slabs are exact, so the iteration converges
+ * in at most \c P steps; it pays off when it converges in far fewer, giving
+ * a speedup of roughly \f$ P/k\f$ (minus the coarse overhead).
+ *
+ * Both propagators are given as \c dg::aTimeloop so any of
+ * \c dg::AdaptiveTimeloop, \c dg::MultistepTimeloop or
+ * \c dg::SinglestepTimeloop can be mixed and matched:
+ * @code
+ * // fine: the adaptive integrator of the serial run
+ * dg::AdaptiveTimeloop<Container> fine(
+ *     dg::Adaptive<dg::ERKStep<Container>>( "Bogacki-Shampine-4-2-3", u0),
+ *     ode, dg::pid_control, dg::l2norm, rtol, atol);
+ * // coarse: first order with a large fixed timestep
+ * dg::SinglestepTimeloop<Container> coarse(
+ *     dg::RungeKutta<Container>( "Euler", u0), ode, dT_coarse);
+ * dg::Parareal<Container> parareal( coarse, fine, u0, comm);
+ * unsigned iter = parareal.solve( t0, u0, t1, u1, 1e-6);
+ * @endcode
+ *
+ * @note The state vectors travel between neighboring ranks once per
+ * iteration, so \c ContainerType can be anything \c dg::blas1 understands,
+ * including recursive containers like <tt> std::array<Container,2></tt>.  If
+ * \c ContainerType is itself an \c MPI_Vector (space **and** time
+ * parallelism) then \c comm must be a communicator **orthogonal** to the
+ * spatial one, e.g. obtained from \c MPI_Comm_split, and all spatial ranks
+ * of a time slab call \c solve together.
+ * @note The propagators are cloned so temporaries may be passed; each rank
+ * holds its own copies and the re-entrant \c integrate function of
+ * \c dg::aTimeloop makes repeated slab integrations safe.
+ * @copydoc hide_ContainerType
+ * @ingroup time_utils
+ * @sa For an introduction see the review by M. J. Gander "50 years of time parallel time integration" (2015)
+ */
+template<class ContainerType>
+struct Parareal
+{
+    using container_type = ContainerType;
+    using value_type = dg::get_value_type<ContainerType>;
+    ///no allocation
+    Parareal() = default;
+    /*!@brief Allocate workspace and clone the propagators
+     *
+     * @param coarse the cheap propagator \f$ \mathcal G\f$ (will be cloned).
+     * The cheaper it is the smaller the sequential fraction of the algorithm,
+     * but the worse its accuracy the more iterations are needed
+     * @param fine the accurate propagator \f$ \mathcal F\f$ (will be cloned).
+     * Defines the accuracy of the converged solution
+     * @param copyable the workspace is allocated based on this vector
+     * @param comm the ranks of this communicator become the time slabs
+     */
+    Parareal( const aTimeloop<ContainerType>& coarse,
+              const aTimeloop<ContainerType>& fine,
+              const ContainerType& copyable, MPI_Comm comm)
+        : m_coarse( coarse), m_fine( fine),
+          m_u( copyable), m_f( copyable), m_g( copyable), m_v( copyable),
+          m_comm( comm)
+    {
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = Parareal( std::forward<Params>( ps)...);
+    }
+    ///@brief Return an object of same size as the object used for construction
+    ///@return A copyable object; what it contains is undefined, its size is important
+    const ContainerType& copyable() const { return m_u;}
+
+    /// Set or unset performance timings during iterations
+    ///@param benchmark If true, additional output will be written to \c std::cout during solution
+    ///@param message An optional identifier that is printed together with the residual
+    void set_benchmark( bool benchmark, std::string message = ""){
+        m_benchmark = benchmark;
+        m_message = message;
+    }
+
+    /*!@brief Integrate from \c t0 to \c t1 with time slabs parallel over ranks
+     *
+     * All ranks of \c comm must call this function together with the same
+     * arguments; on return all ranks hold the same \c u1.
+     * @param t0 initial time
+     * @param u0 initial value at \c t0 (must be the same on all ranks)
+     * @param t1 end time, the interval is cut into \c P equal slabs where
+     * \c P is the size of \c comm
+     * @param u1 (write only) contains the fine solution at \c t1 on output
+     * (may alias \c u0)
+     * @param eps the relative accuracy to which the slab start values must
+     * converge; there is no point in choosing it smaller than the accuracy
+     * of the fine propagator
+     * @param max_iter maximum number of parareal iterations; with
+     * <tt> max_iter >= P </tt> the result equals the serial fine solution
+     * @return number of iterations used
+     * @attention The function may throw \c dg::Error (or anything derived
+     * from \c std::exception) thrown by the propagators
+     */
+    unsigned solve( value_type t0, const ContainerType& u0, value_type t1,
+            ContainerType& u1, value_type eps, unsigned max_iter = 10)
+    {
+        int rank, size;
+        MPI_Comm_rank( m_comm, &rank);
+        MPI_Comm_size( m_comm, &size);
+        value_type deltaT = (t1-t0)/(value_type)size;
+        value_type tb = t0 + rank*deltaT;
+        value_type te = (rank == size-1) ? t1 : tb + deltaT;
+        //coarse propagation to the start of our slab; redundantly computed
+        //on every rank, which avoids a startup pipeline
+        dg::blas1::copy( u0, m_u);
+        for( int s=0; s<rank; s++)
+            m_coarse->integrate( t0+s*deltaT, m_u, t0+(s+1)*deltaT, m_u);
+        unsigned iter = max_iter;
+        for( unsigned k=1; k<=max_iter; k++)
+        {
+            //all ranks propagate their slab in parallel
+            m_fine->integrate( tb, m_u, te, m_f);
+            m_coarse->integrate( tb, m_u, te, m_g);
+            //the correction sweeps sequentially through the ranks
+            value_type residual = 0.;
+            if( rank > 0)
+            {
+                //wait for the updated start value from our left neighbor
+                recv( m_v, rank-1, (int)k,
+                        get_tensor_category<ContainerType>());
+                dg::blas1::axpby( 1., m_v, -1., m_u, m_u);
+                value_type delta = sqrt( dg::blas1::dot( m_u, m_u));
+                value_type norm  = sqrt( dg::blas1::dot( m_v, m_v));
+                residual = delta/(norm+1);
+                dg::blas1::copy( m_v, m_u);
+                //correct the slab end with the new coarse propagation
+                m_coarse->integrate( tb, m_u, te, m_v);
+                dg::blas1::axpbypgz( 1., m_f, -1., m_g, 1., m_v);
+            }
+            else //the start value of the first slab is exact
+                dg::blas1::copy( m_f, m_v);
+            if( rank < size-1)
+                send( m_v, rank+1, (int)k,
+                        get_tensor_category<ContainerType>());
+            MPI_Allreduce( MPI_IN_PLACE, &residual, 1,
+                    getMPIDataType<value_type>(), MPI_MAX, m_comm);
+            if( m_benchmark && rank == 0)
+                std::cout << "# `"<<m_message<<"` parareal iteration: "<<k
+                          <<", residual: "<<residual<<"\n";
+            if( residual < eps)
+            {
+                iter = k;
+                break;
+            }
+        }
+        //the last rank holds the solution at t1
+        dg::blas1::copy( m_v, u1);
+        bcast( u1, size-1, get_tensor_category<ContainerType>());
+        return iter;
+    }
+    private:
+    //MPI can only transport flat host arrays, so the state vectors are
+    //(un)packed recursively down to their shared memory containers
+    template<class Container>
+    void send( const Container& v, int dest, int tag, SharedVectorTag)
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA && defined(_DG_CUDA_UNAWARE_MPI)
+        if( std::is_same<get_execution_policy<Container>, CudaTag>::value)
+        {
+            m_buffer.assign( v.begin(), v.end());
+            MPI_Send( thrust::raw_pointer_cast( m_buffer.data()),
+                    (int)m_buffer.size(), getMPIDataType<value_type>(),
+                    dest, tag, m_comm);
+            return;
+        }
+#endif
+        MPI_Send( thrust::raw_pointer_cast( v.data()), (int)v.size(),
+                getMPIDataType<value_type>(), dest, tag, m_comm);
+    }
+    template<class Container>
+    void recv( Container& v, int source, int tag, SharedVectorTag)
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA && defined(_DG_CUDA_UNAWARE_MPI)
+        if( std::is_same<get_execution_policy<Container>, CudaTag>::value)
+        {
+            m_buffer.resize( v.size());
+            MPI_Recv( thrust::raw_pointer_cast( m_buffer.data()),
+                    (int)m_buffer.size(), getMPIDataType<value_type>(),
+                    source, tag, m_comm, MPI_STATUS_IGNORE);
+            thrust::copy( m_buffer.begin(), m_buffer.end(), v.begin());
+            return;
+        }
+#endif
+        MPI_Recv( thrust::raw_pointer_cast( v.data()), (int)v.size(),
+                getMPIDataType<value_type>(), source, tag, m_comm,
+                MPI_STATUS_IGNORE);
+    }
+    template<class Container>
+    void bcast( Container& v, int root, SharedVectorTag)
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA && defined(_DG_CUDA_UNAWARE_MPI)
+        if( std::is_same<get_execution_policy<Container>, CudaTag>::value)
+        {
+            m_buffer.resize( v.size());
+            thrust::copy( v.begin(), v.end(), m_buffer.begin());
+            MPI_Bcast( thrust::raw_pointer_cast( m_buffer.data()),
+                    (int)m_buffer.size(), getMPIDataType<value_type>(),
+                    root, m_comm);
+            thrust::copy( m_buffer.begin(), m_buffer.end(), v.begin());
+            return;
+        }
+#endif
+        MPI_Bcast( thrust::raw_pointer_cast( v.data()), (int)v.size(),
+                getMPIDataType<value_type>(), root, m_comm);
+    }
+    template<class Container>
+    void send( const Container& v, int dest, int tag, RecursiveVectorTag)
+    {
+        for( unsigned i=0; i<v.size(); i++)
+            send( v[i], dest, tag,
+                get_tensor_category<typename Container::value_type>());
+    }
+    template<class Container>
+    void recv( Container& v, int source, int tag, RecursiveVectorTag)
+    {
+        for( unsigned i=0; i<v.size(); i++)
+            recv( v[i], source, tag,
+                get_tensor_category<typename Container::value_type>());
+    }
+    template<class Container>
+    void bcast( Container& v, int root, RecursiveVectorTag)
+    {
+        for( unsigned i=0; i<v.size(); i++)
+            bcast( v[i], root,
+                get_tensor_category<typename Container::value_type>());
+    }
+    template<class Container>
+    void send( const Container& v, int dest, int tag, MPIVectorTag)
+    {
+        send( v.data(), dest, tag,
+            get_tensor_category<typename Container::container_type>());
+    }
+    template<class Container>
+    void recv( Container& v, int source, int tag, MPIVectorTag)
+    {
+        recv( v.data(), source, tag,
+            get_tensor_category<typename Container::container_type>());
+    }
+    template<class Container>
+    void bcast( Container& v, int root, MPIVectorTag)
+    {
+        bcast( v.data(), root,
+            get_tensor_category<typename Container::container_type>());
+    }
+    dg::ClonePtr<aTimeloop<ContainerType>> m_coarse, m_fine;
+    ContainerType m_u, m_f, m_g, m_v;
+    thrust::host_vector<value_type> m_buffer;
+    MPI_Comm m_comm;
+    bool m_benchmark = true;
+    std::string m_message = "";
+};
+
+#endif //MPI_VERSION
+}//namespace dg
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <cmath>
+#include <array>
+#include "mpi.h"
+
+#include "parareal.h"
+#include "adaptive.h"
+#include "runge_kutta.h"
+
+//test the parareal driver on the harmonic oscillator
+void rhs( double t, const std::array<double,2>& y, std::array<double,2>& yp)
+{
+    yp[0] = y[1];
+    yp[1] = -y[0];
+}
+
+int main( int argc, char* argv[])
+{
+    MPI_Init( &argc, &argv);
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    if( rank == 0) std::cout << "Test parareal on "<<size
+        <<" time slabs with the harmonic oscillator\n";
+    using Vec = std::array<double,2>;
+    const Vec u0 = {1., 0.};
+    double t0 = 0., t1 = 10.;
+
+    //fine: the adaptive integrator of a serial run
+    dg::AdaptiveTimeloop<Vec> fine(
+            dg::Adaptive<dg::ERKStep<Vec>>( "Bogacki-Shampine-4-2-3", u0),
+            rhs, dg::pid_control, dg::l2norm, 1e-10, 1e-10);
+    //coarse: first order with a large fixed timestep
+    dg::SinglestepTimeloop<Vec> coarse(
+            dg::RungeKutta<Vec>( "Euler", u0), rhs, (t1-t0)/(10.*size));
+
+    dg::Parareal<Vec> parareal( coarse, fine, u0, MPI_COMM_WORLD);
+    Vec u1( u0);
+    unsigned iter = parareal.solve( t0, u0, t1, u1, 1e-8);
+    if( rank == 0)
+    {
+        std::cout << "Converged in "<<iter<<" iterations (less than "
+                  <<size<<" is a speedup)\n";
+        std::cout << "Solution  "<<u1[0]<<" "<<u1[1]<<"\n";
+        std::cout << "Exact     "<<cos(t1)<<" "<<-sin(t1)<<"\n";
+        std::cout << "Error     "<<fabs(u1[0]-cos(t1))<<" "
+                  <<fabs(u1[1]+sin(t1))<<" (1e-8)\n";
+    }
+    //the serial fine solution for comparison
+    Vec u1_serial( u0);
+    fine.integrate( t0, u0, t1, u1_serial);
+    if( rank == 0)
+        std::cout << "Difference to serial fine solution "
+                  <<fabs(u1[0]-u1_serial[0])<<" "
+                  <<fabs(u1[1]-u1_serial[1])<<" (1e-8)\n";
+
+    MPI_Finalize();
+    return 0;
+}
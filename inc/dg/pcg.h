@@ -2,13 +2,21 @@
 #define _DG_PCG_
 
 #include <cmath>
+#include <limits>
+#include <vector>
 
 #include "blas.h"
 #include "functors.h"
+#include "topology/operator.h"
 #include "extrapolation.h"
+#include "chebyshev.h"
+#include "eve.h"
 #include "backend/typedefs.h"
 
 #include "backend/timer.h"
+#include "backend/prof.h"
+#include "backend/memory_report.h"
+#include "convergence_history.h"
 
 /*!@file
  * Conjugate gradient class and functions
@@ -67,7 +75,8 @@ class PCG
      * @param max_iterations Maximum number of iterations to be used
      */
     PCG( const ContainerType& copyable, unsigned max_iterations):
-        r(copyable), p(r), ap(r), max_iter(max_iterations){}
+        r(copyable), p(r), ap(r), max_iter(max_iterations),
+        m_ticket( "dg::PCG", 3*bytes_of( copyable)){}
     ///@brief Set the maximum number of iterations
     ///@param new_max New maximum number
     void set_max( unsigned new_max) {max_iter = new_max;}
@@ -87,6 +96,92 @@ class PCG
     void set_throw_on_fail( bool throw_on_fail){
         m_throw_on_fail = throw_on_fail;
     }
+    /**
+     * @brief Use a fast non-reproducible reduction for the inner iteration scalar products
+     *
+     * The two scalar products that drive the recurrence of each iteration are
+     * then computed with a plain tree reduction (as in \c dg::blas1::reduce)
+     * instead of the exactly rounded \c exblas superaccumulator, which is
+     * noticeably faster at small vector sizes per process. The residual norms
+     * that decide convergence (and thus the returned iteration count) are
+     * always computed with the binary reproducible \c dg::blas2::dot.
+     * @param fast_dot If true, the recurrence scalar products are not binary reproducible
+     * @attention With this flag the iterates (but not the convergence
+     * decision) may differ between otherwise identical runs
+     * @note the default value is false
+     */
+    void set_fast_dot( bool fast_dot){
+        m_fast_dot = fast_dot;
+        if( fast_dot)
+        {
+            //the fourth full-size work container must be visible to the
+            //memory registry; update the ticket before allocating so a
+            //budget violation throws without the allocation
+            m_ticket = MemoryTicket( "dg::PCG", 4*bytes_of( r));
+            m_tmp = r;
+        }
+    }
+    ///@brief Attach (or with \c nullptr detach) a convergence telemetry recorder
+    ///@param hist records residuals, operator counts and timings of all subsequent solves; must outlive this object unless detached
+    ///@sa dg::ConvergenceHistory
+    void set_history( ConvergenceHistory* hist){ m_hist = hist;}
+    /**
+     * @brief Record the Lanczos coefficients of subsequent solves
+     *
+     * The CG recurrence implicitly performs a Lanczos process on the
+     * preconditioned operator \f$ PA\f$ and its coefficients
+     * \f$\alpha_i,\ \beta_i\f$ assemble the Lanczos tridiagonal matrix
+     * whose extreme eigenvalues (the Ritz values) converge to the extreme
+     * eigenvalues of \f$ PA\f$ as the iteration proceeds, see
+     * <a href="https://doi.org/10.1016/j.apnum.2005.08.007"> G. Meurant and
+     * Z. Strakos, The Lanczos and conjugate gradient algorithms in finite
+     * precision arithmetic (2006)</a>.
+     * Recording them costs two scalars per iteration, i.e. in contrast to a
+     * dedicated \c dg::EVE solve the estimates accessible through \c
+     * max_eigenvalue, \c min_eigenvalue and \c condition_number come at zero
+     * additional matrix-vector products.
+     * @param monitor if true record the coefficients of all subsequent solves
+     * @note the default value is false
+     * @sa dg::EVE
+     */
+    void set_eigenvalue_monitor( bool monitor){ m_monitor = monitor;}
+    /**
+     * @brief Estimate of the largest eigenvalue of \f$ PA\f$ in the last solve
+     *
+     * The largest Ritz value of the Lanczos tridiagonal matrix recorded in
+     * the last call to \c solve, computed by Sturm sequence bisection
+     * (the cost is quadratic in the number of iterations of the last solve,
+     * which is negligible against the solve itself).
+     * The estimate approaches the largest eigenvalue from below and
+     * converges quickly; the returned value is 0 if \c
+     * set_eigenvalue_monitor was not activated before the last solve or if
+     * the last solve converged without iterating
+     */
+    value_type max_eigenvalue() const{ return lanczos_eigenvalue( true);}
+    /**
+     * @brief Estimate of the smallest eigenvalue of \f$ PA\f$ in the last solve
+     *
+     * The smallest Ritz value of the Lanczos tridiagonal matrix recorded in
+     * the last call to \c solve.
+     * The estimate approaches the smallest eigenvalue from above and
+     * typically converges only close to convergence of the solve itself
+     * @copydetails max_eigenvalue
+     */
+    value_type min_eigenvalue() const{ return lanczos_eigenvalue( false);}
+    /**
+     * @brief Estimate of the condition number of \f$ PA\f$ in the last solve
+     *
+     * The ratio \c max_eigenvalue/min_eigenvalue, a lower bound on the true
+     * condition number that governs the CG iteration count. Watching this
+     * number over a simulation gives an early warning when e.g. steep
+     * gradients degrade the preconditioner before the iteration count
+     * explodes
+     * @return the condition estimate, or 0 if no coefficients were recorded
+     */
+    value_type condition_number() const{
+        value_type lmin = lanczos_eigenvalue( false);
+        return lmin > 0 ? lanczos_eigenvalue( true)/lmin : 0;
+    }
 
     ///@copydoc hide_construct
     template<class ...Params>
@@ -126,9 +221,75 @@ class PCG
     template< class MatrixType0, class ContainerType0, class ContainerType1, class MatrixType1, class ContainerType2 >
     unsigned solve( MatrixType0&& A, ContainerType0& x, const ContainerType1& b, MatrixType1&& P, const ContainerType2& W, value_type eps = 1e-12, value_type nrmb_correction = 1, int test_frequency = 1);
   private:
-    ContainerType r, p, ap;
+    //the recurrence scalar products, subject to the m_fast_dot switch
+    template<class ContainerType0, class ContainerType1, class ContainerType2>
+    value_type recurrence_dot( const ContainerType0& x, const ContainerType1& W, const ContainerType2& y)
+    {
+        if( !m_fast_dot)
+            return blas2::dot( x, W, y);
+        blas1::pointwiseDot( 1., x, W, y, 0., m_tmp);
+        return blas1::reduce( m_tmp, (value_type)0, thrust::plus<value_type>());
+    }
+    //extreme Ritz value of the Lanczos tridiagonal matrix given by the
+    //recorded CG coefficients, via Sturm sequence bisection
+    value_type lanczos_eigenvalue( bool largest) const
+    {
+        unsigned k = m_lanczos_alpha.size();
+        if( k == 0)
+            return 0;
+        // T_k: a_1 = 1/alpha_1, a_i = 1/alpha_i + beta_{i-1}/alpha_{i-1},
+        //      b_i = sqrt(beta_i)/alpha_i
+        std::vector<value_type> a(k), b(k>1 ? k-1 : 0);
+        a[0] = 1./m_lanczos_alpha[0];
+        for( unsigned i=1; i<k; i++)
+            a[i] = 1./m_lanczos_alpha[i]
+                 + m_lanczos_beta[i-1]/m_lanczos_alpha[i-1];
+        for( unsigned i=0; i+1<k; i++)
+            b[i] = sqrt( m_lanczos_beta[i])/m_lanczos_alpha[i];
+        //Gershgorin interval enclosing all eigenvalues
+        value_type lo = a[0], hi = a[0];
+        for( unsigned i=0; i<k; i++)
+        {
+            value_type radius = (i>0   ? fabs( b[i-1]) : 0.)
+                              + (i+1<k ? fabs( b[i])   : 0.);
+            lo = std::min( lo, a[i]-radius);
+            hi = std::max( hi, a[i]+radius);
+        }
+        lo -= 1e-14*(fabs(lo)+1.), hi += 1e-14*(fabs(hi)+1.);
+        //the number of negative pivots of the LDL^T factorization of T_k - x
+        //equals the number of eigenvalues below x (Sturm sequence)
+        auto count_below = [&]( value_type x){
+            unsigned num = 0;
+            value_type d = 1.;
+            for( unsigned i=0; i<k; i++)
+            {
+                d = a[i] - x - (i>0 ? b[i-1]*b[i-1]/d : 0.);
+                if( d == 0) //nudge a zero pivot to keep the count well-defined
+                    d = -std::numeric_limits<value_type>::min();
+                if( d < 0)
+                    num++;
+            }
+            return num;
+        };
+        unsigned target = largest ? k : 1;
+        for( unsigned i=0; i<200 &&
+                hi-lo > 1e-14*std::max( fabs(lo), fabs(hi)); i++)
+        {
+            value_type mid = 0.5*(lo+hi);
+            if( count_below( mid) >= target)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        return 0.5*(lo+hi);
+    }
+    ContainerType r, p, ap, m_tmp;
     unsigned max_iter;
-    bool m_verbose = false, m_throw_on_fail = true;
+    bool m_verbose = false, m_throw_on_fail = true, m_fast_dot = false;
+    bool m_monitor = false;
+    std::vector<value_type> m_lanczos_alpha, m_lanczos_beta;
+    MemoryTicket m_ticket;
+    ConvergenceHistory* m_hist = nullptr;
 };
 
 ///@cond
@@ -136,10 +297,20 @@ template< class ContainerType>
 template< class Matrix, class ContainerType0, class ContainerType1, class Preconditioner, class ContainerType2>
 unsigned PCG< ContainerType>::solve( Matrix&& A, ContainerType0& x, const ContainerType1& b, Preconditioner&& P, const ContainerType2& W, value_type eps, value_type nrmb_correction, int save_on_dots )
 {
+    DG_PROF_SCOPE( "pcg::solve");
     // self-adjoint: apply PCG algorithm to (P 1/W) (W A) x = (P 1/W) (W b) : P' A' x = P' b'
     // This effectively just replaces all scalar products with the weighted one
     value_type nrmb = sqrt( blas2::dot( W, b));
     value_type tol = eps*(nrmb + nrmb_correction);
+    if( m_monitor)
+        m_lanczos_alpha.clear(), m_lanczos_beta.clear();
+    if( !std::isfinite( nrmb))
+    {
+        if( m_throw_on_fail)
+            throw dg::Fail( tol, Message(_ping_)
+                <<"Non-finite norm of right hand side in PCG");
+        return 0;
+    }
 #ifdef MPI_VERSION
     int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -154,35 +325,88 @@ unsigned PCG< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Contai
         blas1::copy( 0., x);
         return 0;
     }
+    if( m_hist)
+        m_hist->begin_solve( nrmb, tol);
     blas2::symv( std::forward<Matrix>(A),x,r);
     blas1::axpby( 1., b, -1., r);
-    if( sqrt( blas2::dot(W,r) ) < tol) //if x happens to be the solution
+    value_type nrmr = sqrt( blas2::dot(W,r));
+    if( m_hist)
+    {
+        m_hist->matvec();
+        m_hist->residual( nrmr);
+    }
+    if( !std::isfinite( nrmr))
+    {
+        // non-finite initial residual: iterating cannot recover, abort now
+        if( m_hist)
+            m_hist->end_solve( 0, false);
+        if( m_throw_on_fail)
+            throw dg::Fail( tol, Message(_ping_)
+                <<"Non-finite initial residual norm in PCG");
+        return 0;
+    }
+    if( nrmr < tol) //if x happens to be the solution
+    {
+        if( m_hist)
+            m_hist->end_solve( 0, true);
         return 0;
+    }
     blas2::symv( std::forward<Preconditioner>(P), r, p );
-    value_type nrmzr_old = blas2::dot( p,W,r); //and store the scalar product
+    if( m_hist)
+        m_hist->precond();
+    value_type nrmzr_old = recurrence_dot( p,W,r); //and store the scalar product
     value_type alpha, nrmzr_new;
     for( unsigned i=1; i<max_iter; i++)
     {
         blas2::symv( std::forward<Matrix>(A), p, ap);
-        alpha =  nrmzr_old/blas2::dot( p, W, ap);
+        if( m_hist)
+            m_hist->matvec();
+        alpha =  nrmzr_old/recurrence_dot( p, W, ap);
+        if( m_monitor)
+            m_lanczos_alpha.push_back( alpha);
         blas1::axpby( alpha, p, 1.,x);
         blas1::axpby( -alpha, ap, 1., r);
         if( 0 == i%save_on_dots )
         {
+            nrmr = sqrt( blas2::dot(W,r));
             if( m_verbose)
             {
-                DG_RANK0 std::cout << "# Absolute r*W*r "<<sqrt( blas2::dot(W,r)) <<"\t ";
+                DG_RANK0 std::cout << "# Absolute r*W*r "<<nrmr <<"\t ";
                 DG_RANK0 std::cout << "#  < Critical "<<tol <<"\t ";
-                DG_RANK0 std::cout << "# (Relative "<<sqrt( blas2::dot(W,r) )/nrmb << ")\n";
+                DG_RANK0 std::cout << "# (Relative "<<nrmr/nrmb << ")\n";
             }
-            if( sqrt( blas2::dot(W,r)) < tol)
+            if( m_hist)
+                m_hist->residual( nrmr);
+            if( !std::isfinite( nrmr))
+            {
+                // a diverging solve cannot recover; abort within this
+                // iteration instead of spinning to max_iter on NaN
+                // comparisons
+                if( m_hist)
+                    m_hist->end_solve( i, false);
+                if( m_throw_on_fail)
+                    throw dg::Fail( tol, Message(_ping_)
+                        <<"Non-finite residual norm in PCG iteration "<<i);
                 return i;
+            }
+            if( nrmr < tol)
+            {
+                if( m_hist)
+                    m_hist->end_solve( i, true);
+                return i;
+            }
         }
         blas2::symv(std::forward<Preconditioner>(P),r,ap);
-        nrmzr_new = blas2::dot( ap, W, r);
+        if( m_hist)
+            m_hist->precond();
+        nrmzr_new = recurrence_dot( ap, W, r);
+        if( m_monitor)
+            m_lanczos_beta.push_back( nrmzr_new/nrmzr_old);
         blas1::axpby(1.,ap, nrmzr_new/nrmzr_old, p );
         nrmzr_old=nrmzr_new;
     }
+    if( m_hist)
+        m_hist->end_solve( max_iter, false);
     if( m_throw_on_fail)
     {
         throw dg::Fail( tol, Message(_ping_)
@@ -192,6 +416,1161 @@ unsigned PCG< ContainerType>::solve( Matrix&& A, ContainerType0& x, const Contai
 }
 ///@endcond
 
+/**
+* @brief Conjugate gradient method with Krylov subspace recycling to solve
+* a sequence of slowly varying systems \f$ A x = b\f$
+*
+* In a time-stepping code the elliptic problem of one timestep differs only
+* slightly from the one before, yet \c dg::PCG rebuilds its Krylov space
+* from scratch every time (warm-starting via \c dg::Extrapolation only
+* improves the initial guess). This class additionally @b recycles a small
+* number of search directions from the previous solve. Since the directions
+* of a converged CG run are \f$ A\f$-orthogonal and the first ones
+* predominantly capture the extremal (low-frequency) modes that dominate the
+* iteration count, the next solve
+* - applies a Galerkin correction of the initial guess in the recycled
+*   subspace (which removes the recycled modes from the residual), and
+* - keeps all new search directions \f$ A\f$-orthogonal to the recycled ones
+*   by an explicit projection after the preconditioner application.
+*
+* The effect is that of a deflated (projected) CG method, see e.g.
+* <a href="https://doi.org/10.1137/S1064827598339761"> Saad et al., A
+* deflated version of the Conjugate Gradient algorithm (2000)</a>.
+* @note The price is \f$ 2m\f$ additional vectors of memory and \f$ m+1\f$
+* scalar products per iteration for \f$ m\f$ recycle vectors; \f$ m \leq
+* 10\f$ is usually enough to capture the persistent low-frequency modes
+* @note If the operator changes strongly (e.g. after a grid change) call
+* \c clear_subspace
+*
+* @ingroup invert
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class RecycledPCG
+{
+  public:
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    RecycledPCG() = default;
+    /**
+     * @brief Allocate memory for the method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param max_iterations Maximum number of iterations to be used
+     * @param mmax Maximum number of directions to recycle between solves (default 8)
+     */
+    RecycledPCG( const ContainerType& copyable, unsigned max_iterations,
+            unsigned mmax = 8):
+        r(copyable), p(r), ap(r), z(r), max_iter(max_iterations), m_mmax(mmax){}
+    ///@copydoc PCG::set_max(unsigned)
+    void set_max( unsigned new_max) {max_iter = new_max;}
+    ///@copydoc PCG::get_max()
+    unsigned get_max() const {return max_iter;}
+    ///@copydoc PCG::copyable()
+    const ContainerType& copyable()const{ return r;}
+    ///@copydoc PCG::set_verbose(bool)
+    void set_verbose( bool verbose){ m_verbose = verbose;}
+    ///@copydoc PCG::set_throw_on_fail(bool)
+    void set_throw_on_fail( bool throw_on_fail){
+        m_throw_on_fail = throw_on_fail;
+    }
+    ///@brief Discard the recycled subspace
+    ///
+    ///Call this method whenever the operator changes significantly, else the
+    ///projected directions harm rather than help convergence
+    void clear_subspace(){
+        m_u.clear(), m_au.clear(), m_uau.clear();
+    }
+    ///@return the current number of recycled directions
+    unsigned subspace_size() const{ return m_u.size();}
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = RecycledPCG( std::forward<Params>( ps)...);
+    }
+    ///@copydoc PCG::solve()
+    template< class MatrixType0, class ContainerType0, class ContainerType1, class MatrixType1, class ContainerType2 >
+    unsigned solve( MatrixType0&& A, ContainerType0& x, const ContainerType1& b, MatrixType1&& P, const ContainerType2& W, value_type eps = 1e-12, value_type nrmb_correction = 1, int test_frequency = 1);
+  private:
+    ContainerType r, p, ap, z;
+    std::vector<ContainerType> m_u, m_au;
+    std::vector<value_type> m_uau;
+    unsigned max_iter, m_mmax = 8;
+    bool m_verbose = false, m_throw_on_fail = true;
+};
+
+///@cond
+template< class ContainerType>
+template< class Matrix, class ContainerType0, class ContainerType1, class Preconditioner, class ContainerType2>
+unsigned RecycledPCG< ContainerType>::solve( Matrix&& A, ContainerType0& x, const ContainerType1& b, Preconditioner&& P, const ContainerType2& W, value_type eps, value_type nrmb_correction, int save_on_dots)
+{
+    value_type nrmb = sqrt( blas2::dot( W, b));
+    value_type tol = eps*(nrmb + nrmb_correction);
+#ifdef MPI_VERSION
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+    if( nrmb == 0)
+    {
+        blas1::copy( 0., x);
+        return 0;
+    }
+    blas2::symv( std::forward<Matrix>(A),x,r);
+    blas1::axpby( 1., b, -1., r);
+    //Galerkin correction in the recycled subspace: the directions are
+    //A-orthogonal so the projected system is diagonal
+    for( unsigned i=0; i<m_u.size(); i++)
+    {
+        value_type c = blas2::dot( m_u[i], W, r)/m_uau[i];
+        blas1::axpby(  c, m_u[i], 1., x);
+        blas1::axpby( -c, m_au[i], 1., r);
+    }
+    if( sqrt( blas2::dot(W,r) ) < tol) //if x happens to be the solution
+        return 0;
+    std::vector<ContainerType> new_u, new_au;
+    std::vector<value_type> new_uau;
+    blas2::symv( std::forward<Preconditioner>(P), r, z );
+    //keep the search space A-orthogonal to the recycled directions
+    for( unsigned i=0; i<m_u.size(); i++)
+        blas1::axpby( -blas2::dot( m_au[i], W, z)/m_uau[i], m_u[i], 1., z);
+    blas1::copy( z, p);
+    value_type nrmzr_old = blas2::dot( p,W,r);
+    value_type alpha, nrmzr_new;
+    for( unsigned i=1; i<max_iter; i++)
+    {
+        blas2::symv( std::forward<Matrix>(A), p, ap);
+        value_type pap = blas2::dot( p, W, ap);
+        alpha =  nrmzr_old/pap;
+        //harvest the first directions of this solve for the next one
+        if( new_u.size() < m_mmax)
+        {
+            new_u.push_back( p), new_au.push_back( ap);
+            new_uau.push_back( pap);
+        }
+        blas1::axpby( alpha, p, 1.,x);
+        blas1::axpby( -alpha, ap, 1., r);
+        if( 0 == i%save_on_dots )
+        {
+            if( m_verbose)
+            {
+                DG_RANK0 std::cout << "# Absolute r*W*r "<<sqrt( blas2::dot(W,r)) <<"\t ";
+                DG_RANK0 std::cout << "#  < Critical "<<tol <<"\t ";
+                DG_RANK0 std::cout << "# (Relative "<<sqrt( blas2::dot(W,r) )/nrmb << ")\n";
+            }
+            if( sqrt( blas2::dot(W,r)) < tol)
+            {
+                m_u = std::move( new_u), m_au = std::move( new_au);
+                m_uau = std::move( new_uau);
+                return i;
+            }
+        }
+        blas2::symv(std::forward<Preconditioner>(P),r,z);
+        for( unsigned j=0; j<m_u.size(); j++)
+            blas1::axpby( -blas2::dot( m_au[j], W, z)/m_uau[j], m_u[j], 1., z);
+        nrmzr_new = blas2::dot( z, W, r);
+        blas1::axpby(1., z, nrmzr_new/nrmzr_old, p );
+        nrmzr_old=nrmzr_new;
+    }
+    if( m_throw_on_fail)
+    {
+        throw dg::Fail( tol, Message(_ping_)
+            <<"After "<<max_iter<<" RecycledPCG iterations with rtol "<<eps<<" and atol "<<eps*nrmb_correction );
+    }
+    return max_iter;
+}
+///@endcond
+
+/**
+* @brief Mixed precision iterative refinement around a reduced precision
+* \c dg::PCG to solve \f$ Ax = b\f$
+*
+* Since both the matrix-vector product and the preconditioner application
+* are memory bandwidth bound, running them with a second (typically \c
+* float) container and matrix type roughly doubles their throughput on
+* bandwidth-bound hardware. This class recovers full precision from the
+* reduced precision solves by classical iterative refinement: the outer
+* loop computes the residual \f$ r = b - Ax\f$ and its norm in full
+* precision with our exactly rounded scalar products, the inner \c dg::PCG
+* solves the correction equation \f$ A d = r/||r||\f$ entirely in reduced
+* precision and the update \f$ x \mathrel{+}= ||r|| d\f$ is again applied in full
+* precision, until the full precision tolerance is met. The normalization
+* of the residual prevents underflow in the reduced precision once \f$
+* ||r||\f$ falls below what a \c float can represent.
+*
+* See <a href="https://doi.org/10.1137/17M1140819"> Carson and Higham,
+* Accelerating the solution of linear systems by iterative refinement in
+* three precisions (2018)</a> for the convergence theory.
+* @note Each inner solve is only asked to reduce the residual by roughly
+* what the reduced precision can resolve (\f$ 10^{-4}\f$ in \c float); for
+* well conditioned (e.g. diffusion-dominated) problems one or two
+* refinement sweeps then suffice to reach \f$ 10^{-12}\f$
+* @note The achievable accuracy is that of the full precision residual
+* computation and thus the same as in \c dg::PCG; only the convergence
+* @b rate degrades when \f$ \kappa(A) \f$ approaches the inverse of the
+* reduced precision epsilon
+* @sa \c MixedMultigridCG2d applies the same idea to the coarse stages of
+* nested iterations
+*
+* @ingroup invert
+* @tparam ContainerType the full precision container (e.g. \c dg::DVec)
+* @tparam ContainerTypeLow the reduced precision container (e.g. \c dg::fDVec)
+*/
+template< class ContainerType, class ContainerTypeLow>
+class RefinedPCG
+{
+  public:
+    using container_type = ContainerType;
+    using low_container_type = ContainerTypeLow;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    using low_value_type = get_value_type<ContainerTypeLow>; //!< value type of the ContainerTypeLow class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    RefinedPCG() = default;
+    /**
+     * @brief Allocate memory for the method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param max_iterations Maximum number of iterations in each inner
+     * reduced precision solve
+     * @param max_refinements Maximum number of outer refinement sweeps
+     * (default 10)
+     */
+    RefinedPCG( const ContainerType& copyable, unsigned max_iterations,
+            unsigned max_refinements = 10):
+        m_r( copyable), m_d( m_r),
+        m_rl( dg::construct<ContainerTypeLow>( copyable)), m_dl( m_rl),
+        m_pcg( m_rl, max_iterations), m_max_ref( max_refinements)
+    {
+        //a stagnating inner solve still yields a usable correction
+        m_pcg.set_throw_on_fail( false);
+    }
+    ///@copydoc PCG::set_max(unsigned)
+    void set_max( unsigned new_max) {m_pcg.set_max( new_max);}
+    ///@copydoc PCG::get_max()
+    unsigned get_max() const {return m_pcg.get_max();}
+    ///@copydoc PCG::copyable()
+    const ContainerType& copyable()const{ return m_r;}
+    ///@copydoc PCG::set_verbose(bool)
+    void set_verbose( bool verbose){ m_verbose = verbose;}
+    ///@copydoc PCG::set_throw_on_fail(bool)
+    void set_throw_on_fail( bool throw_on_fail){
+        m_throw_on_fail = throw_on_fail;
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = RefinedPCG( std::forward<Params>( ps)...);
+    }
+    /**
+     * @brief Solve \f$ Ax = b\f$ using reduced precision inner solves
+     *
+     * @param A The full precision operator; only used to compute the
+     * residual, one application per refinement sweep
+     * @param A_low The same operator assembled with \c ContainerTypeLow;
+     * used in the inner \c dg::PCG iterations
+     * @param x Contains an initial value on input and the solution on output
+     * @param b The right hand side vector
+     * @param P_low The reduced precision preconditioner
+     * @param W The full precision weights that define the scalar product in
+     * which the stopping criterion is computed
+     * @param W_low The same weights in reduced precision for the inner solves
+     * @param eps The relative error to be respected
+     * @param nrmb_correction the absolute error \c C in units of \c eps to be respected
+     * @return Accumulated number of inner iterations over all sweeps
+     * @copydoc hide_matrix
+     * @copydoc hide_ContainerType
+     */
+    template< class MatrixType0, class MatrixType1, class ContainerType0, class ContainerType1, class MatrixType2, class ContainerType2, class ContainerType3>
+    unsigned solve( MatrixType0&& A, MatrixType1&& A_low, ContainerType0& x, const ContainerType1& b, MatrixType2&& P_low, const ContainerType2& W, const ContainerType3& W_low, value_type eps = 1e-12, value_type nrmb_correction = 1);
+  private:
+    ContainerType m_r, m_d;
+    ContainerTypeLow m_rl, m_dl;
+    PCG<ContainerTypeLow> m_pcg;
+    unsigned m_max_ref = 10;
+    bool m_verbose = false, m_throw_on_fail = true;
+};
+
+///@cond
+template< class ContainerType, class ContainerTypeLow>
+template< class MatrixType0, class MatrixType1, class ContainerType0, class ContainerType1, class MatrixType2, class ContainerType2, class ContainerType3>
+unsigned RefinedPCG< ContainerType, ContainerTypeLow>::solve( MatrixType0&& A, MatrixType1&& A_low, ContainerType0& x, const ContainerType1& b, MatrixType2&& P_low, const ContainerType2& W, const ContainerType3& W_low, value_type eps, value_type nrmb_correction)
+{
+    value_type nrmb = sqrt( blas2::dot( W, b));
+    value_type tol = eps*(nrmb + nrmb_correction);
+#ifdef MPI_VERSION
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+    if( nrmb == 0)
+    {
+        blas1::copy( 0., x);
+        return 0;
+    }
+    //limit what we ask of the reduced precision solves
+    low_value_type eps_low = 1e4*std::numeric_limits<low_value_type>::epsilon();
+    unsigned total = 0;
+    for( unsigned k=0; k<m_max_ref; k++)
+    {
+        //exactly rounded full precision residual
+        blas2::symv( std::forward<MatrixType0>(A), x, m_r);
+        blas1::axpby( 1., b, -1., m_r);
+        value_type nrmr = sqrt( blas2::dot( W, m_r));
+        if( m_verbose)
+        {
+            DG_RANK0 std::cout << "# Refinement "<<k<<" Absolute r*W*r "<<nrmr <<"\t ";
+            DG_RANK0 std::cout << "#  < Critical "<<tol <<"\t ";
+            DG_RANK0 std::cout << "# (Relative "<<nrmr/nrmb << ")\n";
+        }
+        if( nrmr < tol)
+            return total;
+        //normalize so the reduced precision cannot underflow
+        blas1::scal( m_r, 1./nrmr);
+        dg::assign( m_r, m_rl);
+        blas1::copy( 0., m_dl);
+        total += m_pcg.solve( std::forward<MatrixType1>(A_low), m_dl, m_rl,
+            std::forward<MatrixType2>(P_low), W_low, eps_low, 1.);
+        dg::assign( m_dl, m_d);
+        blas1::axpby( nrmr, m_d, 1., x);
+    }
+    if( m_throw_on_fail)
+    {
+        throw dg::Fail( tol, Message(_ping_)
+            <<"After "<<m_max_ref<<" refinement sweeps of RefinedPCG with rtol "<<eps<<" and atol "<<eps*nrmb_correction );
+    }
+    return total;
+}
+///@endcond
+
+/**
+* @brief Pipelined (communication-hiding) preconditioned conjugate gradient
+* method to solve \f$ Ax=b\f$
+*
+* This class implements the pipelined PCG algorithm of
+* <a href="https://doi.org/10.1016/j.parco.2013.06.001"> Ghysels and
+* Vanroose, Hiding global synchronization latency in the preconditioned
+* Conjugate Gradient algorithm (2014)</a>. Compared to \c dg::PCG the two
+* blocking scalar products per iteration are replaced by a @b single
+* non-blocking reduction that is overlapped with the application of the
+* preconditioner and the matrix. At large process counts, where the
+* \c MPI_Allreduce latency dominates an iteration, this hides most of the
+* communication cost; on shared memory systems the algorithm falls back to
+* blocking scalar products and behaves like ordinary pipelined CG.
+*
+* The price is 4 additional vectors of memory, roughly double the number of
+* \c axpby calls per iteration and a recurrence that is slightly less stable
+* than ordinary CG, which in practice may cost a few additional iterations
+* at very tight tolerances.
+* @attention The scalar products in this class are @b not binary
+* reproducible; the summation order of the overlapped reduction is
+* implementation defined
+* @note This class can be used as a drop-in replacement for \c dg::PCG e.g.
+* in \c dg::MultigridCG2d since the \c solve method has the same signature
+*
+* @ingroup invert
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class PPCG
+{
+  public:
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    PPCG() = default;
+    ///@copydoc PCG::PCG(const ContainerType&,unsigned)
+    PPCG( const ContainerType& copyable, unsigned max_iterations):
+        r(copyable), u(r), w(r), m(r), n(r), p(r), s(r), q(r), z(r),
+        max_iter(max_iterations){}
+    ///@copydoc PCG::set_max(unsigned)
+    void set_max( unsigned new_max) {max_iter = new_max;}
+    ///@copydoc PCG::get_max()
+    unsigned get_max() const {return max_iter;}
+    ///@copydoc PCG::copyable()
+    const ContainerType& copyable()const{ return r;}
+    ///@copydoc PCG::set_verbose(bool)
+    void set_verbose( bool verbose){ m_verbose = verbose;}
+    ///@copydoc PCG::set_throw_on_fail(bool)
+    void set_throw_on_fail( bool throw_on_fail){
+        m_throw_on_fail = throw_on_fail;
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = PPCG( std::forward<Params>( ps)...);
+    }
+    ///@copydoc PCG::solve()
+    template< class MatrixType0, class ContainerType0, class ContainerType1, class MatrixType1, class ContainerType2 >
+    unsigned solve( MatrixType0&& A, ContainerType0& x, const ContainerType1& b, MatrixType1&& P, const ContainerType2& W, value_type eps = 1e-12, value_type nrmb_correction = 1, int test_frequency = 1);
+  private:
+    //compute the local parts of gamma = (r,u)_W, delta = (w,u)_W and
+    //rho = (r,r)_W and start the non-blocking global reduction
+    template<class ContainerType2>
+    void start_dots( const ContainerType2& W, AnyVectorTag)
+    {
+        //shared memory: nothing to overlap, block right away
+        m_dots[0] = blas2::dot( r, W, u);
+        m_dots[1] = blas2::dot( w, W, u);
+        m_dots[2] = blas2::dot( r, W, r);
+    }
+    void finish_dots( AnyVectorTag){ }
+#ifdef MPI_VERSION
+    template<class ContainerType2>
+    void start_dots( const ContainerType2& W, MPIVectorTag)
+    {
+        const auto& w_data = blas1::detail::do_get_data( W,
+            get_tensor_category<ContainerType2>());
+        m_dots[0] = blas2::dot( r.data(), w_data, u.data());
+        m_dots[1] = blas2::dot( w.data(), w_data, u.data());
+        m_dots[2] = blas2::dot( r.data(), w_data, r.data());
+        MPI_Iallreduce( MPI_IN_PLACE, m_dots, 3, getMPIDataType<value_type>(),
+            MPI_SUM, r.communicator(), &m_request);
+    }
+    void finish_dots( MPIVectorTag)
+    {
+        MPI_Wait( &m_request, MPI_STATUS_IGNORE);
+    }
+#endif //MPI_VERSION
+    ContainerType r, u, w, m, n, p, s, q, z;
+    unsigned max_iter;
+    value_type m_dots[3];
+#ifdef MPI_VERSION
+    MPI_Request m_request = MPI_REQUEST_NULL;
+#endif //MPI_VERSION
+    bool m_verbose = false, m_throw_on_fail = true;
+};
+
+///@cond
+template< class ContainerType>
+template< class Matrix, class ContainerType0, class ContainerType1, class Preconditioner, class ContainerType2>
+unsigned PPCG< ContainerType>::solve( Matrix&& A, ContainerType0& x, const ContainerType1& b, Preconditioner&& P, const ContainerType2& W, value_type eps, value_type nrmb_correction, int test_frequency)
+{
+    value_type nrmb = sqrt( blas2::dot( W, b));
+    value_type tol = eps*(nrmb + nrmb_correction);
+#ifdef MPI_VERSION
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+    if( m_verbose)
+    {
+        DG_RANK0 std::cout << "# Norm of W b "<<nrmb <<"\n";
+        DG_RANK0 std::cout << "# Residual errors: \n";
+    }
+    if( nrmb == 0)
+    {
+        blas1::copy( 0., x);
+        return 0;
+    }
+    using tensor_category = get_tensor_category<ContainerType>;
+    blas2::symv( std::forward<Matrix>(A), x, r);
+    blas1::axpby( 1., b, -1., r);
+    blas2::symv( std::forward<Preconditioner>(P), r, u);
+    blas2::symv( std::forward<Matrix>(A), u, w);
+    value_type alpha = 1, beta = 0, gamma_old = 1;
+    for( unsigned i=0; i<max_iter; i++)
+    {
+        start_dots( W, tensor_category());
+        //overlap the preconditioner and matrix application with the reduction
+        blas2::symv( std::forward<Preconditioner>(P), w, m);
+        blas2::symv( std::forward<Matrix>(A), m, n);
+        finish_dots( tensor_category());
+        value_type gamma = m_dots[0], delta = m_dots[1], res = sqrt( m_dots[2]);
+        if( m_verbose)
+        {
+            DG_RANK0 std::cout << "# Absolute r*W*r "<<res <<"\t ";
+            DG_RANK0 std::cout << "#  < Critical "<<tol <<"\t ";
+            DG_RANK0 std::cout << "# (Relative "<<res/nrmb << ")\n";
+        }
+        if( res < tol)
+            return i;
+        if( i == 0)
+        {
+            beta = 0;
+            alpha = gamma/delta;
+        }
+        else
+        {
+            beta = gamma/gamma_old;
+            alpha = gamma/( delta - beta*gamma/alpha);
+        }
+        blas1::axpby( 1., n, beta, z);
+        blas1::axpby( 1., m, beta, q);
+        blas1::axpby( 1., w, beta, s);
+        blas1::axpby( 1., u, beta, p);
+        blas1::axpby(  alpha, p, 1., x);
+        blas1::axpby( -alpha, s, 1., r);
+        blas1::axpby( -alpha, q, 1., u);
+        blas1::axpby( -alpha, z, 1., w);
+        gamma_old = gamma;
+    }
+    if( m_throw_on_fail)
+    {
+        throw dg::Fail( tol, Message(_ping_)
+            <<"After "<<max_iter<<" PPCG iterations with rtol "<<eps<<" and atol "<<eps*nrmb_correction );
+    }
+    return max_iter;
+}
+///@endcond
+
+///@cond
+namespace detail
+{
+//apply a fixed degree Chebyshev polynomial of PA to Pb (a matrix-free
+//preconditioner for ChebyshevPCG, holds references only)
+template<class Matrix, class Precond, class ContainerType>
+struct ChebyshevPolynomial
+{
+    using value_type = get_value_type<ContainerType>;
+    Matrix& A;
+    Precond& P;
+    ChebyshevIteration<ContainerType>& cheby;
+    value_type ev_min, ev_max;
+    unsigned degree;
+    template<class ContainerType0, class ContainerType1>
+    void symv( const ContainerType0& x, ContainerType1& y)
+    {
+        cheby.solve( A, y, x, P, ev_min, ev_max, degree+1, true);
+    }
+};
+}//namespace detail
+template<class M, class P, class V>
+struct TensorTraits<detail::ChebyshevPolynomial<M,P,V>>
+{
+    using value_type      = get_value_type<V>;
+    using tensor_category = SelfMadeMatrixTag;
+};
+///@endcond
+
+/**
+* @brief Conjugate gradient with automatic Chebyshev polynomial
+* preconditioning to trade scalar products for matrix applications
+*
+* On many processes the cost of a \c dg::PCG iteration is dominated by the
+* latency of the \c MPI_Allreduce in its scalar products while the
+* matrix-vector multiplication still has headroom. This class wraps \c
+* dg::PCG such that each application of the preconditioner evaluates a
+* degree \f$ r\f$ Chebyshev polynomial \f$ C_r( PA) P\f$ (reusing \c
+* dg::ChebyshevIteration, which is free of scalar products, with \c P as
+* inner preconditioner). A polynomial preconditioner cannot reduce the total
+* number of matrix applications needed for a given accuracy (see \ref
+* hide_polynomial) but it reduces the number of CG iterations - and with
+* them the number of global reductions - by roughly a factor \f$ r+1\f$.
+*
+* The Chebyshev interval is estimated automatically: the maximum Eigenvalue
+* of \f$ PA\f$ is computed with \c dg::EVE on the first call to \c solve
+* (and again after \c reset_ev, call it when the operator changes) and
+* slightly overestimated to guard against divergence, while the minimum is
+* set to \f$ \lambda_\max / (5(r+1))\f$ following
+* <a href="https://ieeexplore.ieee.org/document/1245544">Dag and Semlyen,
+* A New Preconditioned Conjugate Gradient Power Flow, IEEE Transactions on
+* power Systems, 18, (2003)</a>. By default the degree adapts between
+* solves: after each solve the total number of matrix applications is
+* compared to the previous solve and the degree takes a step in the
+* direction that lowered it, so a sequence of similar solves settles near
+* the optimum without tuning.
+* @note This class can be used as a drop-in replacement for \c dg::PCG
+* since the \c solve method has the same signature
+*
+* @ingroup invert
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class ChebyshevPCG
+{
+  public:
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    ChebyshevPCG() = default;
+    /**
+     * @brief Allocate memory for the method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param max_iterations Maximum number of CG iterations to be used
+     * @param degree initial degree \c r of the Chebyshev polynomial (each CG
+     * iteration then applies the matrix \c r+1 times); adapted between
+     * solves unless \c set_adapt(false)
+     */
+    ChebyshevPCG( const ContainerType& copyable, unsigned max_iterations,
+            unsigned degree = 5):
+        m_pcg( copyable, max_iterations), m_eve( copyable, max_iterations),
+        m_cheby( copyable), m_tmp( copyable), m_degree( degree){}
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = ChebyshevPCG( std::forward<Params>( ps)...);
+    }
+    ///@copydoc PCG::set_max(unsigned)
+    void set_max( unsigned new_max) { m_pcg.set_max( new_max); m_eve.set_max( new_max);}
+    ///@copydoc PCG::get_max()
+    unsigned get_max() const {return m_pcg.get_max();}
+    ///@copydoc PCG::copyable()
+    const ContainerType& copyable()const{ return m_pcg.copyable();}
+    ///@copydoc PCG::set_verbose(bool)
+    void set_verbose( bool verbose){ m_pcg.set_verbose( verbose);}
+    ///@copydoc PCG::set_throw_on_fail(bool)
+    void set_throw_on_fail( bool throw_on_fail){
+        m_pcg.set_throw_on_fail( throw_on_fail);
+    }
+    ///@copydoc dg::PCG::set_history(ConvergenceHistory*)
+    void set_history( ConvergenceHistory* hist){ m_pcg.set_history( hist);}
+    ///@brief Set the polynomial degree and disable the automatic adaptation
+    ///@param degree the new degree \c r
+    void set_degree( unsigned degree){ m_degree = degree; m_adapt = false;}
+    ///@brief The current polynomial degree
+    unsigned get_degree() const{ return m_degree;}
+    ///@brief Enable or disable the degree adaptation between solves
+    ///@param adapt if false, the degree stays fixed (default is true)
+    void set_adapt( bool adapt){ m_adapt = adapt;}
+    ///@brief Discard the Eigenvalue estimate
+    ///
+    ///The next call to \c solve re-estimates the maximum Eigenvalue of
+    ///\f$ PA\f$; call this when the operator or preconditioner changes
+    ///(Chebyshev iteration may diverge if the Eigenvalue is underestimated)
+    void reset_ev(){ m_ev_max = 0;}
+
+    ///@copydoc PCG::solve()
+    template< class MatrixType0, class ContainerType0, class ContainerType1, class MatrixType1, class ContainerType2 >
+    unsigned solve( MatrixType0&& A, ContainerType0& x, const ContainerType1& b, MatrixType1&& P, const ContainerType2& W, value_type eps = 1e-12, value_type nrmb_correction = 1, int test_frequency = 1)
+    {
+        if( m_ev_max == 0)
+        {
+            blas1::copy( 0., m_tmp);
+            m_eve.solve( std::forward<MatrixType0>(A), m_tmp, b,
+                std::forward<MatrixType1>(P), W, m_ev_max, 1e-2);
+            //guard against underestimation, which makes Chebyshev diverge
+            m_ev_max *= 1.1;
+        }
+        value_type ev_min = m_ev_max/(5.*(m_degree+1)); //Dag & Semlyen
+        detail::ChebyshevPolynomial<std::remove_reference_t<MatrixType0>,
+            std::remove_reference_t<MatrixType1>, ContainerType> cheby{
+                A, P, m_cheby, ev_min, m_ev_max, m_degree};
+        unsigned number = m_pcg.solve( std::forward<MatrixType0>(A), x, b,
+            cheby, W, eps, nrmb_correction, test_frequency);
+        if( m_adapt)
+        {
+            //walk the degree towards fewer total matrix applications
+            value_type cost = (value_type)number*(value_type)(m_degree+1);
+            if( m_cost >= 0 && cost > m_cost)
+                m_dir = -m_dir;
+            m_cost = cost;
+            int degree = (int)m_degree + m_dir;
+            m_degree = degree < 1 ? 1 : degree > 32 ? 32 : degree;
+        }
+        return number;
+    }
+  private:
+    PCG<ContainerType> m_pcg;
+    EVE<ContainerType> m_eve;
+    ChebyshevIteration<ContainerType> m_cheby;
+    ContainerType m_tmp;
+    unsigned m_degree = 5;
+    value_type m_ev_max = 0, m_cost = -1;
+    int m_dir = 1;
+    bool m_adapt = true;
+};
+
+///@cond
+namespace detail
+{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+//scalar recurrences of the conjugate gradient method on the device; a
+//single-thread kernel is cheap compared to the host round-trip it replaces
+//scalars = { nrmzr, alpha, beta}
+template<class T>
+__global__ void pcg_round_kernel( int64_t* acc, T* scalars)
+{
+    scalars[0] = (T)exblas::gpu::Round( acc);
+}
+template<class T>
+__global__ void pcg_alpha_kernel( int64_t* acc, T* scalars)
+{
+    //acc holds the unrounded p W ap
+    scalars[1] = scalars[0]/(T)exblas::gpu::Round( acc);
+}
+template<class T>
+__global__ void pcg_beta_kernel( int64_t* acc, T* scalars)
+{
+    //acc holds the unrounded z W r
+    T nrmzr_new = (T)exblas::gpu::Round( acc);
+    scalars[2] = nrmzr_new/scalars[0];
+    scalars[0] = nrmzr_new;
+}
+// y = sign*(*alpha)*x + y with alpha resident on the device
+template<class T>
+__global__ void pcg_axpby_kernel( T sign, const T* alpha, unsigned size, const T* x, T* y)
+{
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const T a = sign*(*alpha);
+    for( int i = thread_id; i<(int)size; i += grid_size)
+        y[i] = DG_FMA( a, x[i], y[i]);
+}
+// p = z + (*beta)*p with beta resident on the device
+template<class T>
+__global__ void pcg_xpayb_kernel( const T* beta, unsigned size, const T* z, T* p)
+{
+    const int thread_id = blockDim.x * blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    const T b = *beta;
+    for( int i = thread_id; i<(int)size; i += grid_size)
+        p[i] = DG_FMA( b, p[i], z[i]);
+}
+#endif //THRUST_DEVICE_SYSTEM
+}//namespace detail
+///@endcond
+
+/**
+* @brief Device-resident preconditioned conjugate gradient method to solve
+* \f$ Ax=b\f$ for shared memory vectors
+*
+* This class implements the same algorithm as \c dg::PCG but keeps the
+* scalar recurrence on the device: with CUDA the superaccumulators of the
+* two recurrence scalar products are rounded in single-thread kernels and
+* the \f$ \alpha,\ \beta\f$ vector updates read their coefficients from
+* device memory, so an iteration consists of kernel launches only and never
+* transfers data to the host. The host synchronizes once every
+* \c test_frequency iterations when the residual norm is checked for
+* convergence. On the coarse stages of a multigrid hierarchy, where the
+* vectors are tiny and latency-bound, this removes the two to three
+* synchronization bubbles that dominate a \c dg::PCG iteration.
+*
+* The recurrence scalar products use the \c exblas superaccumulators, so in
+* contrast to \c dg::PPCG the iterates remain binary reproducible. With the
+* serial or OpenMP backends there are no transfers to hide and the class
+* behaves exactly like \c dg::PCG.
+* @note This class can be used as a drop-in replacement for \c dg::PCG in
+* shared memory code since the \c solve method has the same signature;
+* choose \c test_frequency > 1 to profit from the device residency
+* @attention Unlike \c dg::PCG this class works for shared memory vectors
+* only (the MPI reduction must involve the host anyway) and the weights
+* \c W must be a vector, not a scalar
+*
+* @ingroup invert
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class DevicePCG
+{
+  public:
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    DevicePCG() = default;
+    ///@copydoc PCG::PCG(const ContainerType&,unsigned)
+    DevicePCG( const ContainerType& copyable, unsigned max_iterations):
+        r(copyable), p(r), ap(r), max_iter(max_iterations){}
+    ///@copydoc PCG::set_max(unsigned)
+    void set_max( unsigned new_max) {max_iter = new_max;}
+    ///@copydoc PCG::get_max()
+    unsigned get_max() const {return max_iter;}
+    ///@copydoc PCG::copyable()
+    const ContainerType& copyable()const{ return r;}
+    ///@copydoc PCG::set_verbose(bool)
+    void set_verbose( bool verbose){ m_verbose = verbose;}
+    ///@copydoc PCG::set_throw_on_fail(bool)
+    void set_throw_on_fail( bool throw_on_fail){
+        m_throw_on_fail = throw_on_fail;
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = DevicePCG( std::forward<Params>( ps)...);
+    }
+    ///@copydoc PCG::solve()
+    template< class MatrixType0, class ContainerType0, class ContainerType1, class MatrixType1, class ContainerType2 >
+    unsigned solve( MatrixType0&& A, ContainerType0& x, const ContainerType1& b, MatrixType1&& P, const ContainerType2& W, value_type eps = 1e-12, value_type nrmb_correction = 1, int test_frequency = 1)
+    {
+        static_assert( std::is_base_of<SharedVectorTag,
+            get_tensor_category<ContainerType>>::value,
+            "DevicePCG only works for shared memory vectors");
+        return do_solve( std::forward<MatrixType0>(A), x, b,
+            std::forward<MatrixType1>(P), W, eps, nrmb_correction,
+            test_frequency, get_execution_policy<ContainerType>());
+    }
+  private:
+    //serial and OpenMP backends have nothing to hide: ordinary host recurrence
+    template< class Matrix, class ContainerType0, class ContainerType1, class Preconditioner, class ContainerType2>
+    unsigned do_solve( Matrix&& A, ContainerType0& x, const ContainerType1& b, Preconditioner&& P, const ContainerType2& W, value_type eps, value_type nrmb_correction, int save_on_dots, AnyPolicyTag)
+    {
+        DG_PROF_SCOPE( "device_pcg::solve");
+        value_type nrmb = sqrt( blas2::dot( W, b));
+        value_type tol = eps*(nrmb + nrmb_correction);
+        if( m_verbose)
+        {
+            std::cout << "# Norm of W b "<<nrmb <<"\n";
+            std::cout << "# Residual errors: \n";
+        }
+        if( nrmb == 0)
+        {
+            blas1::copy( 0., x);
+            return 0;
+        }
+        blas2::symv( std::forward<Matrix>(A),x,r);
+        blas1::axpby( 1., b, -1., r);
+        if( sqrt( blas2::dot(W,r) ) < tol) //if x happens to be the solution
+            return 0;
+        blas2::symv( std::forward<Preconditioner>(P), r, p );
+        value_type nrmzr_old = blas2::dot( p,W,r);
+        value_type alpha, nrmzr_new;
+        for( unsigned i=1; i<max_iter; i++)
+        {
+            blas2::symv( std::forward<Matrix>(A), p, ap);
+            alpha =  nrmzr_old/blas2::dot( p, W, ap);
+            blas1::axpby( alpha, p, 1.,x);
+            blas1::axpby( -alpha, ap, 1., r);
+            if( 0 == i%save_on_dots )
+            {
+                value_type res = sqrt( blas2::dot(W,r));
+                if( m_verbose)
+                {
+                    std::cout << "# Absolute r*W*r "<<res <<"\t ";
+                    std::cout << "#  < Critical "<<tol <<"\t ";
+                    std::cout << "# (Relative "<<res/nrmb << ")\n";
+                }
+                if( res < tol)
+                    return i;
+            }
+            blas2::symv(std::forward<Preconditioner>(P),r,ap);
+            nrmzr_new = blas2::dot( ap, W, r);
+            blas1::axpby(1.,ap, nrmzr_new/nrmzr_old, p );
+            nrmzr_old=nrmzr_new;
+        }
+        if( m_throw_on_fail)
+        {
+            throw dg::Fail( tol, Message(_ping_)
+                <<"After "<<max_iter<<" DevicePCG iterations with rtol "<<eps<<" and atol "<<eps*nrmb_correction );
+        }
+        return max_iter;
+    }
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    template< class Matrix, class ContainerType0, class ContainerType1, class Preconditioner, class ContainerType2>
+    unsigned do_solve( Matrix&& A, ContainerType0& x, const ContainerType1& b, Preconditioner&& P, const ContainerType2& W, value_type eps, value_type nrmb_correction, int save_on_dots, CudaTag)
+    {
+        DG_PROF_SCOPE( "device_pcg::solve");
+        value_type nrmb = sqrt( blas2::dot( W, b));
+        value_type tol = eps*(nrmb + nrmb_correction);
+        if( m_verbose)
+        {
+            std::cout << "# Norm of W b "<<nrmb <<"\n";
+            std::cout << "# Residual errors: \n";
+        }
+        if( nrmb == 0)
+        {
+            blas1::copy( 0., x);
+            return 0;
+        }
+        m_acc.resize( exblas::BIN_COUNT);
+        m_scalars.resize( 3);
+        m_error.assign( 1, false);
+        int64_t* acc = thrust::raw_pointer_cast( m_acc.data());
+        value_type* scalars = thrust::raw_pointer_cast( m_scalars.data());
+        bool* d_error = thrust::raw_pointer_cast( m_error.data());
+        const unsigned size = r.size();
+        const size_t BLOCK_SIZE = 256;
+        const size_t NUM_BLOCKS = std::min<size_t>((size-1)/BLOCK_SIZE+1, 65000);
+        blas2::symv( std::forward<Matrix>(A),x,r);
+        blas1::axpby( 1., b, -1., r);
+        if( sqrt( blas2::dot(W,r) ) < tol) //if x happens to be the solution
+            return 0;
+        blas2::symv( std::forward<Preconditioner>(P), r, p );
+        const value_type* w_ptr = thrust::raw_pointer_cast( W.data());
+        value_type* x_ptr = thrust::raw_pointer_cast( x.data());
+        value_type* r_ptr = thrust::raw_pointer_cast( r.data());
+        value_type* p_ptr = thrust::raw_pointer_cast( p.data());
+        value_type* ap_ptr = thrust::raw_pointer_cast( ap.data());
+        exblas::exdot_gpu( size, p_ptr, w_ptr, r_ptr, acc, d_error);
+        detail::pcg_round_kernel<value_type><<<1,1>>>( acc, scalars);
+        for( unsigned i=1; i<max_iter; i++)
+        {
+            blas2::symv( std::forward<Matrix>(A), p, ap);
+            exblas::exdot_gpu( size, p_ptr, w_ptr, ap_ptr, acc, d_error);
+            detail::pcg_alpha_kernel<value_type><<<1,1>>>( acc, scalars);
+            detail::pcg_axpby_kernel<value_type><<<NUM_BLOCKS, BLOCK_SIZE>>>(
+                (value_type) 1, scalars+1, size, p_ptr, x_ptr);
+            detail::pcg_axpby_kernel<value_type><<<NUM_BLOCKS, BLOCK_SIZE>>>(
+                (value_type)-1, scalars+1, size, ap_ptr, r_ptr);
+            if( 0 == i%save_on_dots )
+            {
+                //the only host synchronization of the iteration
+                value_type res = sqrt( blas2::dot(W,r));
+                if( m_error[0])
+                    throw dg::Error(dg::Message(_ping_)<<"DevicePCG failed since one of the inputs contains NaN or Inf");
+                if( m_verbose)
+                {
+                    std::cout << "# Absolute r*W*r "<<res <<"\t ";
+                    std::cout << "#  < Critical "<<tol <<"\t ";
+                    std::cout << "# (Relative "<<res/nrmb << ")\n";
+                }
+                if( res < tol)
+                    return i;
+            }
+            blas2::symv(std::forward<Preconditioner>(P),r,ap);
+            exblas::exdot_gpu( size, ap_ptr, w_ptr, r_ptr, acc, d_error);
+            detail::pcg_beta_kernel<value_type><<<1,1>>>( acc, scalars);
+            detail::pcg_xpayb_kernel<value_type><<<NUM_BLOCKS, BLOCK_SIZE>>>(
+                scalars+2, size, ap_ptr, p_ptr);
+        }
+        if( m_throw_on_fail)
+        {
+            throw dg::Fail( tol, Message(_ping_)
+                <<"After "<<max_iter<<" DevicePCG iterations with rtol "<<eps<<" and atol "<<eps*nrmb_correction );
+        }
+        return max_iter;
+    }
+#endif //THRUST_DEVICE_SYSTEM
+    ContainerType r, p, ap;
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    thrust::device_vector<int64_t> m_acc;
+    thrust::device_vector<value_type> m_scalars;
+    thrust::device_vector<bool> m_error;
+#endif //THRUST_DEVICE_SYSTEM
+    unsigned max_iter;
+    bool m_verbose = false, m_throw_on_fail = true;
+};
+
+/**
+* @brief Block preconditioned conjugate gradient method to solve
+* \f$ A x_k = b_k\f$ for several right hand sides at once
+*
+* All right hand sides share the same positive definite, self-adjoint matrix
+* \f$ A\f$ and preconditioner \f$ P\f$ (cf. \c PCG for the requirements).
+* Instead of solving the systems one after the other, the block method of
+* <a href="https://doi.org/10.1016/0024-3795(80)90247-5">O'Leary, The block
+* conjugate gradient algorithm and related methods (1980)</a> iterates all
+* columns in a common Krylov space: each iteration applies \f$ A\f$ and
+* \f$ P\f$ to every column and couples them through small \f$ m\times m\f$
+* recurrence systems (\f$ m\f$ the number of right hand sides). This pays
+* twice on bandwidth bound hardware: the matrix passes for all columns can
+* be batched back to back (e.g. the batched \c RowColDistMat::symv
+* aggregates their halo messages), and the shared search space reduces the
+* number of iterations below that of the worst single solve.
+*
+* @note The \f$ m\times m\f$ systems may become ill-conditioned when the
+* residual columns align during the iteration. We solve them with pivoted
+* LU and abort on breakdown, but do not deflate converged columns, so the
+* method is intended for small numbers of structurally related right hand
+* sides (like the per-species Helmholtz problems) rather than for large
+* blocks iterated to very small tolerances.
+*
+* @ingroup invert
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class BlockPCG
+{
+  public:
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    BlockPCG() = default;
+    /**
+     * @brief Allocate memory for the block pcg method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param num_rhs number of simultaneous right hand sides
+     * @param max_iterations Maximum number of iterations to be used
+     */
+    BlockPCG( const ContainerType& copyable, unsigned num_rhs, unsigned max_iterations):
+        m_r( num_rhs, copyable), m_p( m_r), m_q( m_r), m_z( m_r),
+        m_max_iter( max_iterations){}
+    ///@brief Set the maximum number of iterations
+    void set_max( unsigned new_max) { m_max_iter = new_max;}
+    ///@brief Get the current maximum number of iterations
+    unsigned get_max() const { return m_max_iter;}
+    ///@brief The number of simultaneous right hand sides
+    unsigned get_num_rhs() const { return m_r.size();}
+    ///@copydoc PCG::set_verbose(bool)
+    void set_verbose( bool verbose){ m_verbose = verbose;}
+    ///@copydoc PCG::set_throw_on_fail(bool)
+    void set_throw_on_fail( bool throw_on_fail){ m_throw_on_fail = throw_on_fail;}
+    ///@brief Return an object of same size as the object used for construction
+    const ContainerType& copyable()const{ return m_r[0];}
+    ///@brief Perfect forward parameters to one of the constructors
+    ///@tparam Params deduced by the compiler
+    ///@param ps parameters forwarded to constructors
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = BlockPCG( std::forward<Params>( ps)...);
+    }
+    /**
+     * @brief Solve \f$ A x_k = b_k\f$ for all columns using a block
+     * preconditioned conjugate gradient method
+     *
+     * The iteration stops if every column fulfills
+     * \f$ ||Ax_k-b_k||_W < \epsilon( ||b_k||_W + C)\f$
+     * @param A A self-adjoint positive definit matrix (the same for all columns)
+     * @param x Contains initial guesses on input and the solutions on output
+     *  (must have \c get_num_rhs() columns)
+     * @param b The right hand sides (must have \c get_num_rhs() columns)
+     * @param P The preconditioner to be used
+     * @param W Weights that define the scalar product in which \c A and \c P
+     *  are self-adjoint and in which the error norm is computed
+     * @param eps The relative error to be respected by every column
+     * @param nrmb_correction the absolute error \c C in units of \c eps
+     * @return Number of iterations used to achieve desired precision
+     * @copydoc hide_matrix
+     * @copydoc hide_ContainerType
+     */
+    template< class MatrixType0, class MatrixType1, class ContainerType2>
+    unsigned solve( MatrixType0&& A, std::vector<ContainerType>& x,
+        const std::vector<ContainerType>& b, MatrixType1&& P,
+        const ContainerType2& W, value_type eps = 1e-12,
+        value_type nrmb_correction = 1)
+    {
+        DG_PROF_SCOPE( "blockpcg::solve");
+        unsigned m = m_r.size();
+        assert( x.size() == m && b.size() == m);
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+        std::vector<value_type> tol( m);
+        bool converged = true;
+        for( unsigned k=0; k<m; k++)
+        {
+            value_type nrmb = sqrt( blas2::dot( W, b[k]));
+            tol[k] = eps*(nrmb + nrmb_correction);
+            if( !std::isfinite( nrmb))
+            {
+                if( m_throw_on_fail)
+                    throw dg::Fail( tol[k], Message(_ping_)
+                        <<"Non-finite norm of right hand side "<<k
+                        <<" in BlockPCG");
+                return 0;
+            }
+            blas2::symv( std::forward<MatrixType0>(A), x[k], m_r[k]);
+            blas1::axpby( 1., b[k], -1., m_r[k]);
+            if( sqrt( blas2::dot( W, m_r[k])) >= tol[k])
+                converged = false;
+        }
+        if( converged) //if x happens to be the solution
+            return 0;
+        for( unsigned k=0; k<m; k++)
+        {
+            blas2::symv( std::forward<MatrixType1>(P), m_r[k], m_z[k]);
+            blas1::copy( m_z[k], m_p[k]);
+        }
+        dg::Operator<value_type> sigma = small_dots( m_z, W, m_r);
+        dg::Operator<value_type> alpha( m), beta( m);
+        std::vector<value_type> coeffs( m);
+        for( unsigned i=1; i<m_max_iter; i++)
+        {
+            for( unsigned k=0; k<m; k++)
+                blas2::symv( std::forward<MatrixType0>(A), m_p[k], m_q[k]);
+            //the m x m recurrence systems couple the columns
+            small_solve( small_dots( m_p, W, m_q), sigma, alpha, eps);
+            for( unsigned k=0; k<m; k++)
+            {
+                for( unsigned j=0; j<m; j++)
+                    coeffs[j] = alpha(j,k);
+                blas2::gemv( 1., dg::asDenseMatrix( dg::asPointers( m_p)),
+                    coeffs, 1., x[k]);
+                for( unsigned j=0; j<m; j++)
+                    coeffs[j] = -alpha(j,k);
+                blas2::gemv( 1., dg::asDenseMatrix( dg::asPointers( m_q)),
+                    coeffs, 1., m_r[k]);
+            }
+            converged = true;
+            for( unsigned k=0; k<m; k++)
+            {
+                value_type nrmr = sqrt( blas2::dot( W, m_r[k]));
+                if( !std::isfinite( nrmr))
+                {
+                    if( m_throw_on_fail)
+                        throw dg::Fail( tol[k], Message(_ping_)
+                            <<"Non-finite residual norm of column "<<k
+                            <<" in BlockPCG iteration "<<i);
+                    return i;
+                }
+                if( m_verbose)
+                {
+                    DG_RANK0 std::cout << "# Absolute r*W*r of column "<<k
+                        <<" "<<nrmr<<"\t < Critical "<<tol[k]<<"\n";
+                }
+                if( nrmr >= tol[k])
+                    converged = false;
+            }
+            if( converged)
+                return i;
+            for( unsigned k=0; k<m; k++)
+                blas2::symv( std::forward<MatrixType1>(P), m_r[k], m_z[k]);
+            dg::Operator<value_type> sigma_new = small_dots( m_z, W, m_r);
+            small_solve( sigma, sigma_new, beta, eps);
+            //the new search directions must combine the old ones before any
+            //of them is overwritten, so we assemble into m_q and swap
+            for( unsigned k=0; k<m; k++)
+            {
+                for( unsigned j=0; j<m; j++)
+                    coeffs[j] = beta(j,k);
+                blas1::copy( m_z[k], m_q[k]);
+                blas2::gemv( 1., dg::asDenseMatrix( dg::asPointers( m_p)),
+                    coeffs, 1., m_q[k]);
+            }
+            std::swap( m_p, m_q);
+            sigma = sigma_new;
+        }
+        if( m_throw_on_fail)
+        {
+            throw dg::Fail( eps, Message(_ping_)
+                    <<"After "<<m_max_iter<<" BlockPCG iterations for "
+                    <<m<<" right hand sides with rtol "<<eps
+                    <<" and atol "<<eps*nrmb_correction );
+        }
+        return m_max_iter;
+    }
+  private:
+    //the m x m matrix of all pairwise weighted scalar products; both the
+    //recurrence matrices are symmetric so only the upper triangle is computed
+    template<class ContainerType2>
+    dg::Operator<value_type> small_dots( const std::vector<ContainerType>& u,
+        const ContainerType2& W, const std::vector<ContainerType>& v)
+    {
+        unsigned m = u.size();
+        dg::Operator<value_type> dots( m);
+        for( unsigned j=0; j<m; j++)
+            for( unsigned k=j; k<m; k++)
+                dots(j,k) = dots(k,j) = blas2::dot( u[j], W, v[k]);
+        return dots;
+    }
+    //solve lhs * out = rhs column by column with pivoted LU
+    void small_solve( dg::Operator<value_type> lhs,
+        const dg::Operator<value_type>& rhs, dg::Operator<value_type>& out,
+        value_type eps)
+    {
+        unsigned m = lhs.size();
+        std::vector<unsigned> pivot( m);
+        value_type det = dg::create::lu_pivot( lhs, pivot);
+        if( !std::isfinite( det) || det == 0)
+            throw dg::Fail( eps, Message(_ping_)
+                <<"Rank deficient recurrence system in BlockPCG! "
+                <<"The residual columns have become linearly dependent");
+        std::vector<value_type> col( m);
+        for( unsigned k=0; k<m; k++)
+        {
+            for( unsigned j=0; j<m; j++)
+                col[j] = rhs(j,k);
+            dg::create::lu_solve( lhs, pivot, col);
+            for( unsigned j=0; j<m; j++)
+                out(j,k) = col[j];
+        }
+    }
+    std::vector<ContainerType> m_r, m_p, m_q, m_z;
+    unsigned m_max_iter;
+    bool m_verbose = false, m_throw_on_fail = true;
+};
+
 } //namespace dg
 
 
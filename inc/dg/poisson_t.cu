@@ -65,6 +65,16 @@ int main()
     std::cout << "Mean rhs*Jacobian is "<<res.d<<"\t"<<res.i<<"\n";
     res.d = dg::blas2::dot( lhs, w2d, jac);
     std::cout << "Mean lhs*Jacobian is "<<res.d<<"\t"<<res.i<<"\n";
+    //compute several brackets that share the lhs at once
+    poisson( lhs, rhs, jac);
+    dg::DVec jac2( jac), jac3( jac);
+    std::vector<const dg::DVec*> multi_rhs = {&rhs, &rhs};
+    std::vector<dg::DVec*> multi_jac = {&jac2, &jac3};
+    poisson( lhs, multi_rhs, multi_jac);
+    dg::blas1::axpby( 1., jac, -1., jac2);
+    dg::blas1::axpby( 1., jac, -1., jac3);
+    res.d = sqrt( dg::blas2::dot( w2d, jac2)) + sqrt( dg::blas2::dot( w2d, jac3));
+    std::cout << "Multi bracket distance to bracket "<<res.d<<" (0)\n";
     dg::blas1::axpby( 1., sol, -1., jac);
     res.d = sqrt(dg::blas2::dot( w2d, jac));
     std::cout << "Distance to solution "<<res.d<<"\t"<<res.i<<std::endl;
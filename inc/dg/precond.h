@@ -2,15 +2,144 @@
 
 #include <vector>
 
+#include "blas.h"
+#include "topology/grid.h"
+#include "topology/operator.h"
+
 namespace dg
 {
 
+/*!
+ * @brief Direct banded LU solver \f$ x = A^{-1} y\f$ for 1d dG operators
+ *
+ * Stores the LU factorization (without pivoting) of a banded matrix with \c kd
+ * sub- and superdiagonals and applies it with forward and backward
+ * substitution.  The 1d dG elliptic operator with \c n polynomial
+ * coefficients is block-tridiagonal, i.e. banded with \f$ kd = 2n-1\f$, so
+ * \c dg::Elliptic1d and \c dg::Helmholtz1d can be inverted directly in
+ * \f$ \mathcal O( k_d^2 N)\f$ instead of iteratively; use
+ * \c dg::create::banded_direct to construct the band by probing the operator.
+ * The factorization can be used standalone or, via \c dg::blas2::symv, as the
+ * preconditioner in \c dg::PCG or \c dg::DefaultSolver, which then converge
+ * in a single iteration.
+ * @note Without pivoting the factorization is stable for the definite or
+ * diagonally dominant matrices it is intended for, like the elliptic and
+ * Helmholtz operators
+ * @attention The substitution recurrences are inherently sequential and run
+ * on the host; device vectors are transferred (works for GPUs but is not
+ * fast, the intended use are many small 1d solves)
+ * @ingroup invert
+ * @tparam value_type real type
+ */
+template<class value_type>
+struct BandedSolver
+{
+    BandedSolver() = default;
+    /*!@brief Factorize a banded matrix
+     * @param band the matrix in row-major band storage, i.e. entry \f$
+     * a_{ij}\f$ with \f$ |i-j| \leq k_d\f$ at <tt> band[i*(2*kd+1) + j-i+kd]</tt>
+     * (size \c N*(2*kd+1), out of range entries are ignored)
+     * @param kd number of sub- (= super-) diagonals
+     */
+    BandedSolver( thrust::host_vector<value_type> band, unsigned kd):
+        m_lu( band), m_kd(kd)
+    {
+        factorize();
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = BandedSolver( std::forward<Params>( ps)...);
+    }
+    ///@brief number of rows N of the factorized matrix
+    unsigned size() const{ return m_lu.size()/(2*m_kd+1);}
+    /*!@brief Solve \f$ Ax = y\f$
+     * @param y right hand side
+     * @param x contains the solution on output (may alias y)
+     */
+    template<class ContainerType0, class ContainerType1>
+    void operator()( const ContainerType0& y, ContainerType1& x)
+    {
+        dg::assign( y, m_b);
+        const unsigned N = size(), w = 2*m_kd+1;
+        //forward substitution with unit lower triangle
+        for( unsigned i=0; i<N; i++)
+        {
+            unsigned j0 = i > m_kd ? i-m_kd : 0;
+            for( unsigned j=j0; j<i; j++)
+                m_b[i] -= m_lu[i*w + j-i+m_kd]*m_b[j];
+        }
+        //backward substitution
+        for( int i=N-1; i>=0; i--)
+        {
+            unsigned j1 = i+m_kd < N-1 ? i+m_kd : N-1;
+            for( unsigned j=i+1; j<=j1; j++)
+                m_b[i] -= m_lu[i*w + j-i+m_kd]*m_b[j];
+            m_b[i] /= m_lu[i*w + m_kd];
+        }
+        dg::assign( m_b, x);
+    }
+    ///@brief Alias for the \c operator() so that \c dg::blas2::symv works
+    template<class ContainerType0, class ContainerType1>
+    void symv( const ContainerType0& y, ContainerType1& x)
+    {
+        this->operator()( y, x);
+    }
+    private:
+    void factorize()
+    {
+        const unsigned N = size(), w = 2*m_kd+1;
+        for( unsigned k=0; k<N; k++)
+        {
+            if( m_lu[k*w + m_kd] == 0)
+                throw dg::Error( dg::Message(_ping_)
+                    <<"BandedSolver: zero pivot in row "<<k
+                    <<" Is the operator definite and non-periodic?");
+            unsigned i1 = k+m_kd < N-1 ? k+m_kd : N-1;
+            unsigned j1 = i1;
+            for( unsigned i=k+1; i<=i1; i++)
+            {
+                value_type l = m_lu[i*w + k-i+m_kd]/m_lu[k*w + m_kd];
+                m_lu[i*w + k-i+m_kd] = l;
+                for( unsigned j=k+1; j<=j1; j++)
+                    m_lu[i*w + j-i+m_kd] -= l*m_lu[k*w + j-k+m_kd];
+            }
+        }
+        dg::assign( thrust::host_vector<value_type>( N, 0.), m_b);
+    }
+    thrust::host_vector<value_type> m_lu, m_b;
+    unsigned m_kd = 0;
+};
+
+///@cond
+template<class T>
+struct TensorTraits<BandedSolver<T>>
+{
+    using value_type      = T;
+    using tensor_category = SelfMadeMatrixTag;
+};
+///@endcond
+
 namespace create
 {
 
 ///@cond
 namespace detail
 {
+//number of colors such that probed cells of the same color are never
+//(periodic) neighbors of each other
+inline unsigned num_colors( unsigned N, bc bcx)
+{
+    if( bcx != dg::PER || N%2 == 0)
+        return 2;
+    if( N%3 == 0)
+        return 3;
+    //give every cell its own color (exact but expensive; coarse grids
+    //usually have even cell numbers so this is rarely taken)
+    return N;
+}
 template<class T>
 void sparsify( cusp::array1d<int, cusp::host_memory>& row_offsets,
          cusp::array1d<int, cusp::host_memory>& column_indices,
@@ -197,6 +326,336 @@ void sainv_precond(
 
 
 }
+
+/*!
+ * @brief Incomplete sparse approximate inverse (ISAI) preconditioner
+ * \f[ M A \approx I \f]
+ *
+ * where M has the same sparsity pattern as A and the product is matched
+ * exactly on that pattern: for every row i the small dense system
+ * \f[ \sum_{j\in J_i} m_{ij} a_{jk} = \delta_{ik} \quad \forall k \in J_i\f]
+ * with \f$ J_i\f$ the column pattern of row i is solved with a dense LU
+ * factorization.
+ * @note The preconditioner is applied as a plain sparse matrix-vector product
+ * per iteration and needs no triangular solve. It is intended for matrices
+ * with small bandwidth that are strongly diagonally dominant like the fem
+ * mass matrices in \c dg::create::fem_mass, where the diagonal preconditioner
+ * leaves iteration counts on the table.
+ * @attention M is in general not symmetric even for self-adjoint A, so use it
+ * in solvers that allow general preconditioners like \c dg::LGMRES or
+ * \c dg::BICGSTABl, or symmetrize \f$ (M + M^T)/2\f$ before use in \c dg::PCG
+ * @param a input matrix in csr format, columns must be sorted in each row
+ * @param m output matrix with the sparsity pattern of \c a
+ * @ingroup invert
+ * @tparam T real type
+ */
+template<class T>
+void spai_precond(
+        const cusp::csr_matrix<int, T, cusp::host_memory>& a,
+        cusp::csr_matrix<int, T, cusp::host_memory>& m)
+{
+    unsigned n = a.num_rows;
+    cusp::array1d<int, cusp::host_memory> row_offsets( a.row_offsets),
+        column_indices( a.column_indices);
+    cusp::array1d<T, cusp::host_memory> values( a.values.size(), 0.);
+    //lookup of a(j,k) via binary search in the sorted row j
+    auto entry = [&a]( int j, int k)
+    {
+        int begin = a.row_offsets[j], end = a.row_offsets[j+1];
+        auto first = a.column_indices.begin()+begin;
+        auto last  = a.column_indices.begin()+end;
+        auto it = std::lower_bound( first, last, k);
+        if( it != last && *it == k)
+            return a.values[ begin + (int)(it-first)];
+        return (T)0;
+    };
+    for( int i=0; i<(int)n; i++)
+    {
+        const int begin = a.row_offsets[i];
+        const int size  = a.row_offsets[i+1] - begin;
+        dg::Operator<T> g( size, 0.);
+        std::vector<T> rhs( size, 0.);
+        for( int q=0; q<size; q++) //equation for column k
+        {
+            int k = a.column_indices[begin+q];
+            if( k == i)
+                rhs[q] = 1.;
+            for( int p=0; p<size; p++)
+                g( q, p) = entry( a.column_indices[begin+p], k);
+        }
+        std::vector<unsigned> pivot( size);
+        lu_pivot( g, pivot);
+        lu_solve( g, pivot, rhs);
+        for( int p=0; p<size; p++)
+            values[begin+p] = rhs[p];
+    }
+    m.resize( n, n, values.size());
+    m.row_offsets = row_offsets;
+    m.column_indices = column_indices;
+    m.values = values;
+}
+
+/*!
+ * @brief Per-cell block-Jacobi preconditioner for nearest-neighbor operators
+ *
+ * Extract the \f$ (n^2)\times(n^2)\f$ diagonal blocks (one per dG cell) of the
+ * operator \c op by probing: \c op is applied to comb vectors that excite all
+ * cells of one color at once, where cells of the same color are at least two
+ * cells apart in each dimension. For operators that couple only nearest
+ * neighbor cells (true for \c dg::Elliptic including the jump terms) the
+ * extracted blocks are exact. The blocks are then inverted with a dense LU
+ * factorization and stored in a \c dg::BlockDiagMat, which can be used as the
+ * preconditioner in e.g. \c dg::PCG in place of the default inverse diagonal.
+ *
+ * For strongly varying \f$ \chi\f$ the block-Jacobi preconditioner typically
+ * reduces the iteration count significantly compared to the pointwise
+ * \f$ \chi^{-1}\f$ diagonal.
+ * @note The creation costs \f$ 4n^2\f$ applications of \c op (more if the
+ * grid is periodic with an odd number of cells in a direction) plus the dense
+ * inversion of all blocks, so recreate the preconditioner only when \c op
+ * changes, e.g. after \c set_chi.
+ * @note Since the blocks of a self-adjoint operator in diagonal weights W are
+ * symmetric up to the weights, the inverse blocks remain self-adjoint in W
+ * and the preconditioner is admissible in \c dg::PCG
+ * @param op the operator to precondition (forwarded to \c dg::blas2::symv);
+ * must couple only nearest neighbor cells
+ * @param g the 2d grid on which \c op is discretized
+ * @return the inverted diagonal blocks; convert with \c dg::blas2::transfer
+ * to \c dg::BlockDiagMatDevice for device execution
+ * @tparam ContainerType the vector class that \c op can be applied to
+ * (a shared memory vector)
+ * @ingroup invert
+ */
+template<class ContainerType, class MatrixType, class real_type>
+dg::BlockDiagMat<get_value_type<ContainerType>> block_jacobi( MatrixType&& op,
+    const aRealTopology2d<real_type>& g)
+{
+    using value_type = get_value_type<ContainerType>;
+    static_assert( std::is_base_of<SharedVectorTag,
+        get_tensor_category<ContainerType>>::value,
+        "ContainerType must be a shared memory vector");
+    const unsigned n = g.n(), Nx = g.Nx(), Ny = g.Ny(), m = n*n;
+    BlockDiagMat<value_type> bj( Ny, Nx, n, n);
+    const unsigned ncx = detail::num_colors( Nx, g.bcx());
+    const unsigned ncy = detail::num_colors( Ny, g.bcy());
+    thrust::host_vector<value_type> e( g.size(), 0), w( e);
+    ContainerType ed = dg::construct<ContainerType>( e), wd( ed);
+    //probe all columns of all blocks of one color simultaneously
+    for( unsigned j=0; j<m; j++)
+    for( unsigned cy=0; cy<ncy; cy++)
+    for( unsigned cx=0; cx<ncx; cx++)
+    {
+        const unsigned jy = j/n, jx = j%n;
+        dg::blas1::copy( 0, e);
+        for( unsigned iy=cy; iy<Ny; iy+=ncy)
+        for( unsigned ix=cx; ix<Nx; ix+=ncx)
+            e[((iy*n+jy)*Nx+ix)*n+jx] = 1;
+        dg::assign( e, ed);
+        dg::blas2::symv( op, ed, wd);
+        dg::assign( wd, w);
+        for( unsigned iy=cy; iy<Ny; iy+=ncy)
+        for( unsigned ix=cx; ix<Nx; ix+=ncx)
+        for( unsigned i=0; i<m; i++)
+            bj.data[(((size_t)iy*Nx+ix)*m + i)*m + j] =
+                w[((iy*n+i/n)*Nx+ix)*n + i%n];
+    }
+    //invert all blocks with a dense LU factorization
+    for( unsigned k=0; k<Ny*Nx; k++)
+    {
+        dg::Operator<value_type> B( m);
+        for( unsigned i=0; i<m; i++)
+        for( unsigned q=0; q<m; q++)
+            B(i,q) = bj.data[((size_t)k*m + i)*m + q];
+        B = dg::create::inverse( B);
+        for( unsigned i=0; i<m; i++)
+        for( unsigned q=0; q<m; q++)
+            bj.data[((size_t)k*m + i)*m + q] = B(i,q);
+    }
+    return bj;
+}
+
+/*!
+ * @brief Probe a banded 1d operator and factorize it with \c dg::BandedSolver
+ *
+ * The band is extracted by applying \c op to \f$ 2k_d+1\f$ comb vectors that
+ * excite every \f$ (2k_d+1)\f$-th point at once; entries of the result are
+ * then uniquely attributable to one diagonal. The 1d dG elliptic operator
+ * with \c n polynomial coefficients is block-tridiagonal with \f$ n\times
+ * n\f$ blocks, i.e. pass \f$ k_d = 2n-1\f$.
+ * @attention Only for non-periodic boundary conditions: with \c dg::PER the
+ * operator has corner entries and is not banded
+ * @note Recreate the solver when \c op changes, e.g. after \c set_chi
+ * @param op the operator to factorize (forwarded to \c dg::blas2::symv);
+ * must be banded with bandwidth \c kd
+ * @param copyable a vector of the size that \c op applies to
+ * @param kd number of sub- (= super-) diagonals of \c op
+ * @return the factorized operator
+ * @tparam ContainerType the vector class that \c op can be applied to
+ * (a shared memory vector)
+ * @ingroup invert
+ */
+template<class ContainerType, class MatrixType>
+dg::BandedSolver<get_value_type<ContainerType>> banded_direct( MatrixType&& op,
+    const ContainerType& copyable, unsigned kd)
+{
+    using value_type = get_value_type<ContainerType>;
+    static_assert( std::is_base_of<SharedVectorTag,
+        get_tensor_category<ContainerType>>::value,
+        "ContainerType must be a shared memory vector");
+    const unsigned N = copyable.size(), w = 2*kd+1;
+    thrust::host_vector<value_type> e( N, 0), wv( e);
+    ContainerType ed = dg::construct<ContainerType>( e), wd( ed);
+    thrust::host_vector<value_type> band( (size_t)N*w, 0.);
+    for( unsigned s=0; s<w; s++)
+    {
+        dg::blas1::copy( 0, e);
+        for( unsigned p=s; p<N; p+=w)
+            e[p] = 1;
+        dg::assign( e, ed);
+        dg::blas2::symv( op, ed, wd);
+        dg::assign( wd, wv);
+        for( unsigned i=0; i<N; i++)
+        {
+            //the unique j in [i-kd, i+kd] with j ≡ s (mod 2kd+1)
+            int lo = (int)i - (int)kd;
+            int j = lo + (((int)s - lo)%(int)w + (int)w)%(int)w;
+            if( j >= 0 && j < (int)N)
+                band[ (size_t)i*w + (unsigned)(j-lo)] = wv[i];
+        }
+    }
+    return dg::BandedSolver<value_type>( band, kd);
+}
 } //namespace create
 
+///@cond
+namespace detail
+{
+//update x += B^{-1} r on all cells of color (cx, cy); one thread per row
+template<class real_type>
+struct ColoredBlockUpdate
+{
+    unsigned n, Nx, ncx, ncy, cx, cy;
+    DG_DEVICE
+    void operator()( unsigned i, const real_type* blocks,
+        const real_type* r, real_type* x) const
+    {
+        const unsigned jx = i%n, ix = (i/n)%Nx;
+        const unsigned jy = (i/(n*Nx))%n, iy = i/(n*Nx*n);
+        if( ix%ncx != cx || iy%ncy != cy)
+            return;
+        const unsigned m = n*n, row = jy*n + jx;
+        const real_type* B = blocks + ((size_t)(iy*Nx + ix)*m + row)*m;
+        real_type temp = 0;
+        for( unsigned q=0; q<m; q++)
+            temp = DG_FMA( B[q], r[((iy*n + q/n)*Nx + ix)*n + q%n], temp);
+        x[i] += temp;
+    }
+};
+}//namespace detail
+///@endcond
+
+/*!
+ * @brief Cell-colored block Gauss-Seidel smoother \f$ x_{k+1} = x_k + B_c^{-1}
+ * ( b - f(x_k))|_c\f$
+ *
+ * The dG cells of the grid are colored such that cells of the same color do
+ * not couple through the operator \c op (red-black for a non-periodic grid,
+ * more colors if a periodic direction has an odd number of cells, cf.
+ * \c dg::create::block_jacobi). One sweep then visits the colors in turn: the
+ * residual \f$ r = b - f(x)\f$ is computed with the full (matrix-free)
+ * operator and all cells of the current color are updated simultaneously with
+ * their inverted \f$ (n^2)\times(n^2)\f$ diagonal blocks, which are extracted
+ * by probing and factorized once in the constructor. All cells of a color
+ * update in parallel, so the sweep vectorizes on GPUs and with OpenMP while
+ * retaining the Gauss-Seidel property that each color sees the latest values
+ * of all other colors.
+ *
+ * The intended use is as a smoothing operator in \c dg::multigrid_cycle and
+ * \c dg::full_multigrid, where it is more robust than \c
+ * dg::ChebyshevIteration for strongly varying \f$ \chi\f$ since no eigenvalue
+ * estimates are needed. Consecutive sweeps reverse the color ordering, so
+ * pairs of sweeps form a symmetric smoother.
+ * @note One sweep costs one application of \c op per color (plus the cheap
+ * block updates); recreate the smoother when \c op changes, e.g. after
+ * \c set_chi
+ * @copydoc hide_matrix
+ * @copydoc hide_ContainerType
+ * @ingroup invert
+ */
+template<class Matrix, class ContainerType>
+struct BlockGaussSeidel
+{
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    /**
+     * @brief Probe and factorize the diagonal blocks of \c op
+     *
+     * @param op the operator to smooth (copied, so maybe choose a reference
+     * type for shallow copying); must couple only nearest neighbor cells
+     * (true for \c dg::Elliptic including the jump terms)
+     * @param g the 2d grid on which \c op is discretized
+     * @param num_sweeps the number of sweeps to perform in \c symv
+     */
+    template<class real_type>
+    BlockGaussSeidel( Matrix op, const aRealTopology2d<real_type>& g,
+        unsigned num_sweeps = 2):
+        m_op(op),
+        m_r( dg::construct<ContainerType>(
+            thrust::host_vector<value_type>( g.size(), 0))),
+        m_n( g.n()), m_Nx( g.Nx()),
+        m_ncx( create::detail::num_colors( g.Nx(), g.bcx())),
+        m_ncy( create::detail::num_colors( g.Ny(), g.bcy())),
+        m_sweeps( num_sweeps)
+    {
+        dg::BlockDiagMat<value_type> bj =
+            dg::create::block_jacobi<ContainerType>( m_op, g);
+        m_blocks = dg::construct<ContainerType>( bj.data);
+    }
+    ///@brief Set the number of sweeps to perform in \c symv
+    void set_num_sweeps( unsigned new_sweeps){ m_sweeps = new_sweeps;}
+    ///@brief Get the current number of sweeps
+    unsigned get_num_sweeps() const{ return m_sweeps;}
+    /**
+     * @brief Perform \c num_sweeps colored Gauss-Seidel sweeps on \f$ f(x) =
+     * b\f$
+     *
+     * @attention In contrast to a preconditioner the input \c x is used as
+     * the initial guess (as in \c dg::ChebyshevIteration::solve), which is
+     * what \c dg::multigrid_cycle expects of its smoothing operators
+     * @param b the right hand side
+     * @param x contains the initial guess on input, overwritten by the
+     * smoothed iterate
+     */
+    template<class ContainerType0, class ContainerType1>
+    void symv( const ContainerType0& b, ContainerType1& x)
+    {
+        const unsigned nc = m_ncx*m_ncy;
+        for( unsigned s=0; s<m_sweeps; s++)
+        for( unsigned c=0; c<nc; c++)
+        {
+            //reverse the color ordering every other sweep such that
+            //pairs of sweeps form a symmetric smoother
+            const unsigned cc = s%2 == 0 ? c : nc-1-c;
+            dg::blas2::symv( m_op, x, m_r);
+            dg::blas1::axpby( 1., b, -1., m_r);
+            dg::blas2::parallel_for( detail::ColoredBlockUpdate<value_type>{
+                m_n, m_Nx, m_ncx, m_ncy, cc%m_ncx, cc/m_ncx},
+                m_r.size(), m_blocks, m_r, x);
+        }
+    }
+    private:
+    Matrix m_op;
+    ContainerType m_blocks, m_r;
+    unsigned m_n, m_Nx, m_ncx, m_ncy, m_sweeps;
+};
+
+///@cond
+template<class M, class V>
+struct TensorTraits<BlockGaussSeidel<M,V>>
+{
+    using value_type      = get_value_type<V>;
+    using tensor_category = SelfMadeMatrixTag;
+};
+///@endcond
+
 }//namespace dg
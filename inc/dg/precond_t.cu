@@ -5,6 +5,8 @@
 #include <cusp/multiply.h>
 #include <cusp/elementwise.h>
 #include "precond.h"
+#include "elliptic.h"
+#include "pcg.h"
 #include "topology/operator.h"
 #include "backend/timer.h"
 
@@ -102,6 +104,49 @@ int main()
     std::cout << "Absolute error norm (not small) "<<sqrt(norm_err)<<"\n";
     std::cout << "Relative error norm (not small) "<<sqrt(norm_err/norm_ainv)<<"\n";
 
+    std::cout << "Test SPAI preconditioner\n";
+    csr_mat spai;
+    t.tic();
+    dg::create::spai_precond( a_csr, spai);
+    t.toc();
+    std::cout <<"took "<<t.diff()<<"s"<<std::endl;
+    // Test || M A - I ||
+    coo_mat ma, unit( size, size, size);
+    for( unsigned i=0; i<size; i++)
+    {
+        unit.row_indices[i] = unit.column_indices[i] = i;
+        unit.values[i] = 1.;
+    }
+    cusp::multiply( spai, a_csr, ma);
+    ma.sort_by_row_and_column();
+    cusp::subtract( ma, unit, zTD);
+    norm_err = 0.0;
+    for( unsigned u=0; u<zTD.values.size(); u++)
+        norm_err += zTD.values[u]*zTD.values[u];
+    std::cout << "Error norm of M A - I (small) "<<sqrt(norm_err/size)<<"\n";
+
+    std::cout << "Test banded direct solver on Elliptic1d\n";
+    dg::Grid1d g1d( 0, M_PI, 3, 20, dg::DIR);
+    dg::Elliptic1d<dg::Grid1d, dg::HMatrix, dg::HVec> pol( g1d, dg::centered);
+    dg::HVec chi = dg::evaluate( []( double x){ return 1.+x;}, g1d);
+    pol.set_chi( chi);
+    const dg::HVec w1d = dg::create::weights( g1d);
+    const dg::HVec sol = dg::evaluate( []( double x){ return sin(x);}, g1d);
+    dg::HVec rhs( sol), x( sol.size(), 0.);
+    dg::blas2::symv( pol, sol, rhs);
+    t.tic();
+    auto banded = dg::create::banded_direct( pol, rhs, 2*g1d.n()-1);
+    t.toc();
+    std::cout <<"Creation took "<<t.diff()<<"s"<<std::endl;
+    banded( rhs, x);
+    dg::blas1::axpby( 1., sol, -1., x);
+    double err = sqrt( dg::blas2::dot( x, w1d, x)/dg::blas2::dot( sol, w1d, sol));
+    std::cout << "Relative error of direct solve (small) "<<err<<"\n";
+    //and as a preconditioner in PCG
+    dg::PCG<dg::HVec> pcg( x, 100);
+    dg::blas1::copy( 0., x);
+    unsigned number = pcg.solve( pol, x, rhs, banded, pol.weights(), 1e-10);
+    std::cout << "PCG with banded preconditioner took "<<number<<" iterations (expect 1)\n";
 
     return 0;
 }
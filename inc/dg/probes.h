@@ -0,0 +1,223 @@
+#pragma once
+
+#include <vector>
+#include <cusp/csr_matrix.h>
+
+#include "backend/config.h"
+#include "backend/typedefs.h"
+#include "backend/exceptions.h"
+
+/*! @file
+ * @brief Asynchronous probe and line-out extraction for live monitoring
+ */
+namespace dg{
+
+///@cond
+#ifdef __CUDACC__
+namespace detail{
+template<class value_type>
+__global__ void probe_kernel( int num_rows, const int* row_offsets,
+        const int* column_indices, const value_type* values,
+        const value_type* x, value_type* y)
+{
+    const int thread_id = blockDim.x*blockIdx.x + threadIdx.x;
+    const int grid_size = gridDim.x*blockDim.x;
+    for( int row = thread_id; row<num_rows; row += grid_size)
+    {
+        value_type temp = 0;
+        for( int k=row_offsets[row]; k<row_offsets[row+1]; k++)
+            temp = DG_FMA( values[k], x[column_indices[k]], temp);
+        y[row] = temp;
+    }
+}
+}//namespace detail
+#endif //__CUDACC__
+///@endcond
+
+/**
+ * @brief Asynchronous extraction of probe and line-out signals
+ *
+ * Simulations typically extract a handful of 1d line-outs or point probes
+ * from a 2d or 3d field every step for live monitoring, e.g. through the
+ * interpolation matrices of \c dg::create::interpolation. Doing so with
+ * \c dg::blas2::symv and a host transfer synchronizes the device every
+ * step. This class instead registers the interpolation matrices once and
+ * extracts all of them in one non-blocking call: on a CUDA build the field
+ * is copied device-to-device on the default stream (so later steps may
+ * freely overwrite it), the probe products then run on a dedicated
+ * low-priority stream and write their results directly into pinned host
+ * memory, which the device can access without an explicit transfer on
+ * unified virtual addressing systems. The timestep loop thus continues
+ * unhindered while the monitoring side polls \c ready().
+ * @code{.cpp}
+dg::Probes<double> probes;
+unsigned id = probes.add( dg::create::interpolation( xs, ys, grid));
+// inside the timeloop
+probes.extract( density);
+// ... continue stepping; in the monitoring code
+if( probes.ready())
+    display( probes.data( id));
+ * @endcode
+ * @note On non-CUDA builds \c extract computes the products synchronously
+ * and \c ready() always returns \c true, so calling code is portable
+ * @note To monitor several different fields use one \c Probes object per
+ * field
+ * @note Under MPI construct with the local part of the interpolation matrix
+ * and extract from \c field.data(); each rank monitors its own domain
+ * @tparam value_type \c float or \c double, must match the extracted fields
+ * @ingroup misc
+ */
+template<class value_type>
+struct Probes
+{
+    Probes(){ init_cuda();}
+    ///@brief The registered matrices and results are copied, the streams are not shared
+    Probes( const Probes& src) : m_probes( src.m_probes), m_out( src.m_out)
+    {
+        init_cuda();
+    }
+    ///@copydoc Probes(const Probes&)
+    Probes& operator=( const Probes& src)
+    {
+        if( this != &src)
+        {
+            wait();
+            m_probes = src.m_probes;
+            m_out = src.m_out;
+        }
+        return *this;
+    }
+    ~Probes(){ free_cuda();}
+    /*!@brief Register an interpolation matrix
+     *
+     * @param probe the rows are the probe points, the columns must match the
+     * size of the fields later given to \c extract
+     * @return the index under which the result can be retrieved with \c data
+     */
+    unsigned add( const dg::IHMatrix_t<value_type>& probe)
+    {
+        wait();
+        if( !m_probes.empty() && probe.num_cols != m_probes[0].num_cols)
+            throw Error( Message(_ping_)<<"Probe has "<<probe.num_cols
+                    <<" columns while previously registered probes have "
+                    <<m_probes[0].num_cols);
+        m_probes.push_back( dg::IDMatrix_t<value_type>( probe));
+        m_out.push_back( PinnedVec_t<value_type>( probe.num_rows, 0.));
+        return m_probes.size()-1;
+    }
+    ///@brief The number of registered probes
+    unsigned size() const { return m_probes.size();}
+    /*!@brief Extract all registered probes from the given field
+     *
+     * Non-blocking on CUDA builds: the call returns as soon as the work is
+     * enqueued and \c field may be overwritten by subsequent device code.
+     * A second \c extract before the first one finished waits for it.
+     * @param field the field to probe (size must equal the number of
+     * columns of the registered matrices)
+     */
+    template<class ContainerType>
+    void extract( const ContainerType& field)
+    {
+        if( m_probes.empty())
+            return;
+        if( field.size() != m_probes[0].num_cols)
+            throw Error( Message(_ping_)<<"Field has the wrong size "
+                    <<field.size()<<" Number of columns is "
+                    <<m_probes[0].num_cols);
+#ifdef __CUDACC__
+        wait(); //do not overwrite the stage while probes still read it
+        m_stage.resize( field.size());
+        cudaMemcpyAsync( thrust::raw_pointer_cast( m_stage.data()),
+                thrust::raw_pointer_cast( field.data()),
+                field.size()*sizeof(value_type), cudaMemcpyDeviceToDevice, 0);
+        cudaEventRecord( m_order, 0);
+        cudaStreamWaitEvent( m_stream, m_order, 0);
+        for( unsigned i=0; i<m_probes.size(); i++)
+        {
+            int num_rows = m_probes[i].num_rows;
+            if( num_rows == 0)
+                continue;
+            const int blocks = (num_rows+255)/256;
+            detail::probe_kernel<value_type><<<blocks, 256, 0, m_stream>>>(
+                num_rows,
+                thrust::raw_pointer_cast( &m_probes[i].row_offsets[0]),
+                thrust::raw_pointer_cast( &m_probes[i].column_indices[0]),
+                thrust::raw_pointer_cast( &m_probes[i].values[0]),
+                thrust::raw_pointer_cast( m_stage.data()),
+                thrust::raw_pointer_cast( m_out[i].data()));
+        }
+        cudaEventRecord( m_done, m_stream);
+#else
+        const value_type* x_ptr = thrust::raw_pointer_cast( field.data());
+        for( unsigned i=0; i<m_probes.size(); i++)
+        {
+            for( unsigned row=0; row<m_probes[i].num_rows; row++)
+            {
+                value_type temp = 0;
+                for( int k=m_probes[i].row_offsets[row];
+                        k<m_probes[i].row_offsets[row+1]; k++)
+                    temp = DG_FMA( m_probes[i].values[k],
+                            x_ptr[m_probes[i].column_indices[k]], temp);
+                m_out[i][row] = temp;
+            }
+        }
+#endif //__CUDACC__
+    }
+    /*!@brief Non-blocking query whether the last \c extract finished
+     * @return true if the results of the last \c extract can be read
+     */
+    bool ready() const
+    {
+#ifdef __CUDACC__
+        return cudaEventQuery( m_done) == cudaSuccess;
+#else
+        return true;
+#endif //__CUDACC__
+    }
+    /*!@brief Access the result of the last \c extract
+     *
+     * Waits for an unfinished extraction, i.e. blocks unless \c ready()
+     * @param i the index returned by \c add
+     * @return the extracted probe values in pinned host memory
+     */
+    const PinnedVec_t<value_type>& data( unsigned i) const
+    {
+        wait();
+        return m_out[i];
+    }
+    private:
+    void wait() const
+    {
+#ifdef __CUDACC__
+        cudaEventSynchronize( m_done);
+#endif //__CUDACC__
+    }
+    void init_cuda()
+    {
+#ifdef __CUDACC__
+        int least = 0, greatest = 0;
+        cudaDeviceGetStreamPriorityRange( &least, &greatest);
+        cudaStreamCreateWithPriority( &m_stream, cudaStreamNonBlocking, least);
+        cudaEventCreateWithFlags( &m_order, cudaEventDisableTiming);
+        cudaEventCreateWithFlags( &m_done, cudaEventDisableTiming);
+#endif //__CUDACC__
+    }
+    void free_cuda()
+    {
+#ifdef __CUDACC__
+        wait();
+        cudaStreamDestroy( m_stream);
+        cudaEventDestroy( m_order);
+        cudaEventDestroy( m_done);
+#endif //__CUDACC__
+    }
+    std::vector<dg::IDMatrix_t<value_type>> m_probes;
+    std::vector<PinnedVec_t<value_type>> m_out;
+#ifdef __CUDACC__
+    thrust::device_vector<value_type> m_stage;
+    cudaStream_t m_stream;
+    cudaEvent_t m_order, m_done;
+#endif //__CUDACC__
+};
+
+}//namespace dg
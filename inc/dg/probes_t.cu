@@ -0,0 +1,53 @@
+#include <iostream>
+#include <cmath>
+
+#include "probes.h"
+#include "blas.h"
+#include "topology/evaluation.h"
+#include "topology/interpolation.h"
+
+double function( double x, double y){ return sin(x)*sin(y);}
+
+int main()
+{
+    std::cout << "Test asynchronous probe extraction\n";
+    dg::Grid2d g2d( 0, M_PI, 0, M_PI, 3, 16, 16);
+    dg::DVec field = dg::construct<dg::DVec>( dg::evaluate( function, g2d));
+
+    //a line-out at constant y = pi/2
+    unsigned npoints = 50;
+    dg::HVec xs( npoints), ys( npoints, M_PI/2.);
+    for( unsigned i=0; i<npoints; i++)
+        xs[i] = (i+0.5)*M_PI/(double)npoints;
+    dg::IHMatrix line = dg::create::interpolation( xs, ys, g2d);
+    //and a single point probe
+    dg::IHMatrix point = dg::create::interpolation( dg::HVec( 1, M_PI/2.),
+            dg::HVec( 1, M_PI/2.), g2d);
+
+    dg::Probes<double> probes;
+    unsigned line_id = probes.add( line);
+    unsigned point_id = probes.add( point);
+    probes.extract( field);
+    while( !probes.ready())
+        ; //a real simulation keeps stepping here
+
+    //compare to the synchronous extraction
+    dg::DVec direct( npoints);
+    dg::blas2::symv( dg::IDMatrix( line), field, direct);
+    dg::HVec direct_h( direct);
+    double err = 0;
+    for( unsigned i=0; i<npoints; i++)
+        err = std::max( err, fabs( probes.data( line_id)[i] - direct_h[i]));
+    std::cout << "Max difference line-out to synchronous symv: "
+              <<err<<" (0)\n";
+    std::cout << "Point probe: "<<probes.data( point_id)[0]
+              <<" (" <<function( M_PI/2., M_PI/2.)<<")\n";
+
+    //extract again from a different field state
+    dg::blas1::scal( field, 2.);
+    probes.extract( field);
+    std::cout << "Point probe after scaling: "<<probes.data( point_id)[0]
+              <<" (" <<2*function( M_PI/2., M_PI/2.)<<")\n";
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "pcg.h"
+#include "elliptic.h"
+#include "helmholtz.h"
+#include "arakawa.h"
+#include "multistep.h"
+#include "matrix/lanczos.h"
+
+#include "backend/timer.h"
+
+//Unified regression benchmark: runs a curated parameter sweep over the
+//solver and stepper hot paths that the individual *_b.cu programs
+//benchmark by hand (cg2d_b, elliptic2d_b, arakawa_b, lanczos_b, multistep) and
+//writes the timings and iteration counts as JSON to stdout.
+//Run via `make benchmarks` and compare two result files with
+//`python3 benchmark_diff.py old.json new.json`
+
+const double lx = 2.*M_PI;
+const double ly = 2.*M_PI;
+
+double initial( double x, double y) {return 0.;}
+double fct(double x, double y){ return sin(y)*sin(x);}
+double laplace_fct( double x, double y) { return 2.*sin(y)*sin(x);}
+double chi_fct( double x, double y) { return 1. + sin(x)*sin(y)/2.;}
+double left( double x, double y) {return sin(x)*cos(y);}
+double right( double x, double y) {return cos(x)*sin(y);}
+
+struct Result
+{
+    std::string name;
+    double time; //seconds per call resp. per solve
+    unsigned iter; //iterations resp. repetitions
+};
+
+int main()
+{
+    std::vector<Result> results;
+    dg::Timer t;
+    const double eps = 1e-6;
+    //curated sweep: polynomial coefficients and cell numbers of the hot paths
+    std::vector<std::array<unsigned,3>> sizes = {
+        {3, 128, 128}, {3, 256, 256}, {5, 128, 128}
+    };
+    for( auto size : sizes)
+    {
+        unsigned n = size[0], Nx = size[1], Ny = size[2];
+        std::string grid_id = " n"+std::to_string(n)+" Nx"+std::to_string(Nx)
+                            + " Ny"+std::to_string(Ny);
+        std::cerr << "# Benchmarking"<<grid_id<<"\n";
+        dg::Grid2d grid( 0., lx, 0., ly, n, Nx, Ny, dg::DIR, dg::PER);
+        const dg::DVec w2d = dg::create::weights( grid);
+        const dg::DVec b = dg::evaluate( laplace_fct, grid);
+        const dg::DVec chi = dg::evaluate( chi_fct, grid);
+        dg::DVec x = dg::evaluate( initial, grid);
+
+        //// Constant coefficient Laplacian inverted with PCG (cg2d_b)
+        dg::Elliptic<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> lap( grid, dg::centered);
+        dg::PCG<dg::DVec> pcg( x, n*n*Nx*Ny);
+        t.tic();
+        unsigned number = pcg.solve( lap, x, b, 1., w2d, eps);
+        t.toc();
+        results.push_back( { "cg2d"+grid_id, t.diff(), number});
+
+        //// Variable coefficient Laplacian (elliptic2d_b)
+        lap.set_chi( chi);
+        dg::blas1::copy( 0., x);
+        t.tic();
+        number = pcg.solve( lap, x, b, 1., w2d, eps);
+        t.toc();
+        results.push_back( { "elliptic2d"+grid_id, t.diff(), number});
+
+        //// Arakawa bracket (arakawa_b)
+        dg::ArakawaX<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> arakawa( grid);
+        dg::DVec lhs = dg::evaluate( left, grid), jac( lhs);
+        dg::DVec rhs = dg::evaluate( right, grid);
+        unsigned multi = 100;
+        t.tic();
+        for( unsigned i=0; i<multi; i++)
+            arakawa( lhs, rhs, jac);
+        t.toc();
+        results.push_back( { "arakawa"+grid_id, t.diff()/(double)multi, multi});
+
+        //// Lanczos approximation of a Helmholtz operator function (lanczos_b)
+        dg::Helmholtz<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> helm( -0.5,
+                {grid, dg::centered});
+        dg::mat::UniversalLanczos<dg::DVec> lanczos( x, n*n*Nx*Ny);
+        const dg::DVec bl = dg::evaluate( fct, grid);
+        t.tic();
+        number = lanczos.solve( x, dg::mat::make_Linear_Te1( 1), helm, bl,
+                w2d, eps, 1., "residual", 1.);
+        t.toc();
+        results.push_back( { "lanczos"+grid_id, t.diff(), number});
+
+        //// Explicit multistep advection steps (multistep hot path)
+        auto advection = [&]( double time, const dg::DVec& y, dg::DVec& yp)
+        {
+            arakawa( lhs, y, yp);
+        };
+        dg::ExplicitMultistep<dg::DVec> ab( "TVB-3-3", x);
+        double time = 0., dt = 1e-4;
+        dg::DVec y0 = dg::evaluate( fct, grid);
+        ab.init( advection, time, y0, dt);
+        unsigned steps = 20;
+        t.tic();
+        for( unsigned i=0; i<steps; i++)
+            ab.step( advection, time, y0);
+        t.toc();
+        results.push_back( { "multistep"+grid_id, t.diff()/(double)steps, steps});
+    }
+    //emit machine-readable JSON
+    std::cout << "{\n";
+    for( unsigned i=0; i<results.size(); i++)
+    {
+        std::cout << "    \""<<results[i].name<<"\" : { \"time\" : "
+                  << results[i].time<<", \"iter\" : "<<results[i].iter<<" }";
+        if( i != results.size()-1)
+            std::cout << ",";
+        std::cout << "\n";
+    }
+    std::cout << "}"<<std::endl;
+    return 0;
+}
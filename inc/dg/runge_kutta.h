@@ -7,6 +7,7 @@
 
 #include "ode.h"
 #include "backend/exceptions.h"
+#include "backend/cuda_graph.h"
 #include "tableau.h"
 #include "blas1.h"
 #include "implicit.h"
@@ -192,6 +193,8 @@ struct ERKStep
     void ignore_fsal(){ m_ferk.ignore_fsal();}
     ///All subsequent calls to \c step method will enable the check for the first same as last property
     void enable_fsal(){ m_ferk.enable_fsal();}
+    ///@copydoc FilteredERKStep::set_graph_capture(bool)
+    void set_graph_capture( bool capture){ m_ferk.set_graph_capture( capture);}
 
     /// @brief Advance one step with error estimate
     ///@copydetails step(ExplicitRHS&,value_type,const ContainerType&,value_type&,ContainerType&,value_type)
@@ -247,6 +250,10 @@ struct ERKStep
     unsigned num_stages() const{
         return m_ferk.num_stages();
     }
+    ///@copydoc FilteredERKStep::interpolate(value_type,ContainerType&)
+    void interpolate( value_type t, ContainerType& u) const{
+        m_ferk.interpolate( t, u);
+    }
   private:
     FilteredERKStep<ContainerType> m_ferk;
 };
@@ -290,6 +297,12 @@ struct FilteredERKStep
             m_rkb[i] = m_rk.b(i);
             m_rkd[i] = m_rk.d(i);
         }
+        if( m_rk.hasDenseOutput())
+        {
+            m_u0_dense = copyable;
+            if( !m_rk.isFsal())
+                m_k0_dense = copyable;
+        }
     }
 
     ///@copydoc hide_construct
@@ -306,6 +319,25 @@ struct FilteredERKStep
     void ignore_fsal(){ m_ignore_fsal = true;}
     ///All subsequent calls to \c step method will enable the check for the first same as last property
     void enable_fsal(){ m_ignore_fsal = false;}
+    /**
+     * @brief Record the kernel sequence of a step into a CUDA Graph and
+     * replay it in subsequent steps
+     *
+     * This eliminates the per-kernel launch latency, which can take 20-30%
+     * of the step time on small per-GPU grids. See \c dg::GraphCache for
+     * the conditions under which a replay is valid; in particular the right
+     * hand side must be autonomous and purely device-resident (no
+     * reductions, no MPI), the timestep \c dt must be constant (a change
+     * invalidates the recording automatically) and the same vectors must be
+     * passed on every call. The fsal property is ignored while capture is
+     * active since the buffer swap it relies on cannot be replayed.
+     * @param capture If true, record and replay; if false (the default),
+     * execute every kernel sequence normally
+     */
+    void set_graph_capture( bool capture){
+        m_capture = capture;
+        m_graph.invalidate();
+    }
 
     /// @brief Advance one step with error estimate
     ///@copydetails ERKStep::step(ExplicitRHS&,value_type,const ContainerType&,value_type&,ContainerType&,value_type)
@@ -341,6 +373,52 @@ struct FilteredERKStep
     unsigned num_stages() const{
         return m_rk.num_stages();
     }
+    /**
+     * @brief Evaluate the continuous extension (dense output) of the last step
+     *
+     * For tableaus that provide interpolation coefficients (see \c
+     * ButcherTableau::set_dense_output, currently "Dormand-Prince-7-4-5" and
+     * "Bogacki-Shampine-4-2-3") the stage values of the last call to \c step
+     * define a polynomial interpolant
+     * \f$ u( t) = u^n + \Delta t \sum_{j=1}^s b_j( \theta) k_j,\quad \theta =
+     * (t-t^n)/\Delta t\f$
+     * that can be evaluated anywhere inside the last step interval without
+     * additional right hand side evaluations. The intended use is to produce
+     * output at exact times without constraining the step controller of an
+     * adaptive integration to hit them.
+     * @param t the time at which to interpolate; should lie inside the last
+     * step interval \f$ [t^n, t^n+\Delta t]\f$ (values outside extrapolate
+     * with reduced accuracy)
+     * @param u (write-only) contains the interpolated solution on return
+     * @attention \c step must have been called at least once before and the
+     * result is unfiltered; the method throws \c dg::Error if the tableau
+     * does not provide a continuous extension and is not available together
+     * with \c set_graph_capture
+     */
+    void interpolate( value_type t, ContainerType& u) const
+    {
+        if( !m_rk.hasDenseOutput())
+            throw dg::Error( dg::Message(_ping_) << "Tableau does not provide a continuous extension!");
+        unsigned s = m_rk.num_stages();
+        value_type theta = ( t - m_dense_t0)/m_dense_dt;
+        std::vector<value_type> rkb( s);
+        for( unsigned j=0; j<s; j++)
+        {
+            value_type bj = 0;
+            for( unsigned k=m_rk.kmax(); k>0; k--)
+                bj = theta*( bj + m_rk.bi( j, k-1));
+            rkb[j] = bj;
+        }
+        std::vector<const ContainerType*> k_ptrs( s);
+        for( unsigned j=0; j<s; j++)
+            k_ptrs[j] = &m_k[j];
+        if( m_rk.isFsal()) //the step method swaps the first and last stage
+            k_ptrs[0] = &m_k[s-1], k_ptrs[s-1] = &m_k[0];
+        else //the step method overwrites m_k[0] with the rhs at (t1,u1)
+            k_ptrs[0] = &m_k0_dense;
+        dg::blas1::copy( m_u0_dense, u);
+        dg::blas2::gemv( m_dense_dt, dg::asDenseMatrix( k_ptrs), rkb, 1., u);
+    }
   private:
     template<class ExplicitRHS, class Limiter>
     void step( const std::tuple<ExplicitRHS, Limiter>& rhs, value_type t0, const ContainerType& u0, value_type& t1, ContainerType& u1, value_type dt, ContainerType& delta, bool);
@@ -351,6 +429,11 @@ struct FilteredERKStep
     bool m_ignore_fsal = false;
     ContainerType m_tmp; //  only conditionally allocated
     bool m_tmp_allocated = false;
+    ContainerType m_u0_dense, m_k0_dense; //only allocated for dense output tableaus
+    value_type m_dense_t0 = 0, m_dense_dt = 1;
+    GraphCache m_graph;
+    bool m_capture = false;
+    value_type m_capture_dt = 0;
 };
 
 ///@cond
@@ -360,7 +443,49 @@ template<class ExplicitRHS, class Limiter>
 void FilteredERKStep<ContainerType>::step( const std::tuple<ExplicitRHS, Limiter>& ode, value_type t0, const ContainerType& u0, value_type& t1, ContainerType& u1, value_type dt, ContainerType& delta, bool compute_delta)
 {
     unsigned s = m_rk.num_stages();
+    if( m_rk.hasDenseOutput() && !m_capture)
+    {
+        //u0 may alias u1 so save it before the step overwrites it
+        dg::blas1::copy( u0, m_u0_dense);
+        m_dense_t0 = t0, m_dense_dt = dt;
+    }
     std::vector<const ContainerType*> k_ptrs = dg::asPointers( m_k);
+    if( m_capture)
+    {
+        if( dt != m_capture_dt)
+        {
+            m_graph.invalidate();
+            m_capture_dt = dt;
+        }
+        //tag the recording with the addresses of the in/out vectors
+        std::size_t key = (std::size_t)&u0 ^ 3*(std::size_t)&u1
+            ^ 5*(std::size_t)&delta;
+        m_graph( [&](){
+            //no fsal: the buffer swap cannot be replayed
+            std::get<0>(ode)(t0, u0, m_k[0]);
+            for ( unsigned i=1; i<s; i++)
+            {
+                std::vector<value_type> rka( i);
+                for( unsigned l=0; l<i; l++)
+                    rka[l] = m_rk.a(i,l);
+                value_type tu = DG_FMA( dt,m_rk.c(i),t0);
+                dg::blas1::copy( u0, delta);
+                dg::blas2::gemv( dt, dg::asDenseMatrix( k_ptrs, i), rka, 1., delta);
+                std::get<1>(ode)( delta);
+                std::get<0>(ode)( tu, delta, m_k[i]);
+            }
+            dg::blas1::copy( u0, u1);
+            if( compute_delta)
+                detail::gemm( {dt,dt}, dg::asDenseMatrix(k_ptrs), {&m_rkb, &m_rkd},
+                    {1.,0.}, {&u1, &delta});
+            else
+                blas2::gemv( dt, dg::asDenseMatrix(k_ptrs), m_rkb, 1., u1);
+            std::get<1>(ode)( u1);
+            std::get<0>(ode)( t0 + dt, u1, m_k[0]);
+        }, key);
+        m_t1 = t1 = t0 + dt;
+        return;
+    }
     //0 stage: probe
     value_type tu = t0;
     if( t0 != m_t1 || m_ignore_fsal)
@@ -390,7 +515,11 @@ void FilteredERKStep<ContainerType>::step( const std::tuple<ExplicitRHS, Limiter
     //make sure (t1,u1) is the last call to f
     m_t1 = t1 = t0 + dt;
     if(!m_rk.isFsal() )
+    {
+        if( m_rk.hasDenseOutput()) //the refresh overwrites the first stage
+            dg::blas1::copy( m_k[0], m_k0_dense);
         std::get<0>(ode)( t1, u1, m_k[0]);
+    }
     else
     {
         using std::swap;
@@ -640,6 +769,8 @@ struct DIRKStep
             m_rkIb[i] = m_rkI.b(i);
             m_rkId[i] = m_rkI.d(i);
         }
+        if( m_rkI.hasDenseOutput())
+            m_u0_dense = copyable;
     }
 
     ///@copydoc hide_construct
@@ -704,6 +835,32 @@ struct DIRKStep
     unsigned num_stages() const{
         return m_rkI.num_stages();
     }
+    /**
+     * @brief Evaluate the continuous extension (dense output) of the last step
+     *
+     * @copydetails FilteredERKStep::interpolate(value_type,ContainerType&)
+     * @note None of the predefined implicit tableaus currently provides
+     * interpolation coefficients, so this method is useful only with a
+     * user-provided tableau that calls \c ButcherTableau::set_dense_output
+     */
+    void interpolate( value_type t, ContainerType& u) const
+    {
+        if( !m_rkI.hasDenseOutput())
+            throw dg::Error( dg::Message(_ping_) << "Tableau does not provide a continuous extension!");
+        unsigned s = m_rkI.num_stages();
+        value_type theta = ( t - m_dense_t0)/m_dense_dt;
+        std::vector<value_type> rkb( s);
+        for( unsigned j=0; j<s; j++)
+        {
+            value_type bj = 0;
+            for( unsigned k=m_rkI.kmax(); k>0; k--)
+                bj = theta*( bj + m_rkI.bi( j, k-1));
+            rkb[j] = bj;
+        }
+        std::vector<const ContainerType*> kIptr = dg::asPointers( m_kI);
+        dg::blas1::copy( m_u0_dense, u);
+        dg::blas2::gemv( m_dense_dt, dg::asDenseMatrix( kIptr), rkb, 1., u);
+    }
 
     private:
     template< class ImplicitRHS, class Solver>
@@ -714,6 +871,8 @@ struct DIRKStep
     std::vector<ContainerType> m_kI;
     ContainerType m_tmp;
     std::vector<value_type> m_rkIb, m_rkId;
+    ContainerType m_u0_dense; //only allocated for dense output tableaus
+    value_type m_dense_t0 = 0, m_dense_dt = 1;
     bool m_allocated = false;
 };
 
@@ -723,6 +882,12 @@ template< class ImplicitRHS, class Solver>
 void DIRKStep<ContainerType>::step( const std::tuple<ImplicitRHS,Solver>& ode,  value_type t0, const ContainerType& u0, value_type& t1, ContainerType& u1, value_type dt, ContainerType& delta, bool compute_delta)
 {
     unsigned s = m_rkI.num_stages();
+    if( m_rkI.hasDenseOutput())
+    {
+        //u0 may alias u1 so save it before the step overwrites it
+        dg::blas1::copy( u0, m_u0_dense);
+        m_dense_t0 = t0, m_dense_dt = dt;
+    }
     value_type tu = t0;
     //0 stage
     //rhs = u0
@@ -766,6 +931,156 @@ void DIRKStep<ContainerType>::step( const std::tuple<ImplicitRHS,Solver>& ode,
 }
 ///@endcond
 
+/**
+* @brief Second order stabilized explicit Runge-Kutta-Chebyshev time-step
+*
+* The damped RKC2 method of <a href="https://doi.org/10.1016/S0377-0427(97)00219-7">
+* B.P. Sommeijer, L.F. Shampine, J.G. Verwer, RKC: An explicit solver for
+* parabolic PDEs, Journal of Computational and Applied Mathematics 88 (1997)</a>.
+* The internal stages follow the three-term Chebyshev recursion
+* \f$ Y_j = (1-\mu_j-\nu_j) u^n + \mu_j Y_{j-1} + \nu_j Y_{j-2} +
+* \tilde\mu_j \Delta t f( Y_{j-1}) + \tilde\gamma_j \Delta t f( u^n)\f$
+* so only a fixed number of vectors is needed regardless of the number of
+* stages \f$ s\f$, and each extra stage costs one right hand side evaluation.
+* The stability interval along the negative real axis grows like \f$ 0.653
+* s^2\f$, which makes the method attractive for moderately stiff dissipative
+* terms like (hyper)diffusion: instead of an implicit solve the stiffness is
+* absorbed by cheap extra stages. The number of stages is selected
+* automatically in each step from the spectral radius estimate \f$ \rho\f$ set
+* with \c set_spectral_radius such that \f$ \Delta t \rho \leq 0.653 s^2\f$.
+*
+* The spectral radius of a self-adjoint operator can be estimated with \c
+* dg::EVE, e.g. for a diffusion operator \c A:
+* @code
+dg::EVE<Container> eve( x);
+double ev_max;
+eve.solve( A, x, b, 1., A.weights(), ev_max, 1e-4);
+rkc.set_spectral_radius( 1.1*ev_max); //10% safety margin
+* @endcode
+* @note The right hand side must have a spectrum close to the negative real
+* axis (dissipative); for problems with dominant imaginary eigenvalues
+* (advection) use one of the \c ERKStep methods
+* @attention Unlike in \c ERKStep the last call to the right hand side is at
+* an internal stage, not at \c (t1,u1)
+* @copydoc hide_ContainerType
+*/
+template<class ContainerType>
+struct RKCStep
+{
+    using value_type = get_value_type<ContainerType>;//!< the value type of the time variable (float or double)
+    using container_type = ContainerType; //!< the type of the vector class in use
+    ///@copydoc ERKStep::ERKStep()
+    RKCStep() = default;
+    /**
+    * @brief Reserve internal workspace for the integration
+    *
+    * @param copyable vector of the size that is later used in \c step (
+     it does not matter what values \c copyable contains, but its size is important;
+     the \c step method can only be called with vectors of the same size)
+    */
+    RKCStep( const ContainerType& copyable): m_f0( copyable), m_f1( copyable),
+        m_y( copyable), m_ym1( copyable), m_ym2( copyable)
+    {
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = RKCStep( std::forward<Params>( ps)...);
+    }
+    ///@copydoc hide_copyable
+    const ContainerType& copyable()const{ return m_f0;}
+
+    /**
+     * @brief Set the spectral radius estimate used for the stage selection
+     *
+     * @param rho an upper bound on the modulus of the largest eigenvalue of
+     * the Jacobian of the right hand side (include a safety margin of 5-10%
+     * since an underestimate destabilizes the method)
+     */
+    void set_spectral_radius( value_type rho){ m_rho = rho;}
+    /// Set the maximum number of stages per step (200 by default)
+    void set_max_stages( unsigned max_stages){ m_max_stages = max_stages;}
+    /// The number of stages that the given timestep requires
+    unsigned num_stages( value_type dt) const{
+        unsigned s = 2;
+        while( dt*m_rho > 0.653*(value_type)(s*s) && s < m_max_stages)
+            s++;
+        return s;
+    }
+
+    /**
+    * @brief Advance one step
+    *
+    * @copydoc hide_explicit_rhs
+    * @param rhs right hand side subroutine
+    * @param t0 start time
+    * @param u0 value at \c t0
+    * @param t1 (write only) end time ( equals \c t0+dt on return, may alias \c t0)
+    * @param u1 (write only) contains result on return (may alias u0)
+    * @param dt timestep; if \f$ \Delta t\rho\f$ exceeds the stability range
+    * of the maximum number of stages the method becomes unstable, so rather
+    * reduce the timestep than increase the maximum number of stages beyond
+    * reason
+    */
+    template<class ExplicitRHS>
+    void step( ExplicitRHS& rhs, value_type t0, const ContainerType& u0,
+            value_type& t1, ContainerType& u1, value_type dt)
+    {
+        unsigned s = num_stages( dt);
+        //Chebyshev polynomials and derivatives at w0 [Sommeijer et al. (2.5)]
+        value_type eps = 2./13.;
+        value_type w0 = 1. + eps/(value_type)(s*s);
+        std::vector<value_type> T(s+1), Tp(s+1), Tpp(s+1);
+        T[0] = 1., T[1] = w0;
+        Tp[0] = 0., Tp[1] = 1.;
+        Tpp[0] = 0., Tpp[1] = 0.;
+        for( unsigned j=2; j<=s; j++)
+        {
+            T[j]   = 2.*w0*T[j-1] - T[j-2];
+            Tp[j]  = 2.*T[j-1] + 2.*w0*Tp[j-1] - Tp[j-2];
+            Tpp[j] = 4.*Tp[j-1] + 2.*w0*Tpp[j-1] - Tpp[j-2];
+        }
+        value_type w1 = Tp[s]/Tpp[s];
+        std::vector<value_type> b(s+1), c(s+1);
+        for( unsigned j=2; j<=s; j++)
+        {
+            b[j] = Tpp[j]/(Tp[j]*Tp[j]);
+            c[j] = w1*Tpp[j]/Tp[j];
+        }
+        b[0] = b[1] = b[2];
+        c[0] = 0., c[1] = w1*b[1], c[s] = 1.;
+        //first stage
+        rhs( t0, u0, m_f0);
+        dg::blas1::copy( u0, m_ym2);
+        value_type mut1 = b[1]*w1;
+        dg::blas1::axpby( 1., u0, dt*mut1, m_f0, m_ym1);
+        //three-term recursion
+        for( unsigned j=2; j<=s; j++)
+        {
+            value_type mu  = 2.*b[j]*w0/b[j-1];
+            value_type nu  = -b[j]/b[j-2];
+            value_type mut = 2.*b[j]*w1/b[j-1];
+            value_type a   = 1. - b[j-1]*T[j-1];
+            value_type gt  = -a*mut;
+            rhs( t0 + c[j-1]*dt, m_ym1, m_f1);
+            dg::blas1::evaluate( m_y, dg::equals(), dg::PairSum(),
+                1.-mu-nu, u0, mu, m_ym1, nu, m_ym2,
+                dt*mut, m_f1, dt*gt, m_f0);
+            using std::swap;
+            swap( m_ym2, m_ym1);
+            swap( m_ym1, m_y);
+        }
+        dg::blas1::copy( m_ym1, u1);
+        t1 = t0 + dt;
+    }
+    private:
+    ContainerType m_f0, m_f1, m_y, m_ym1, m_ym2;
+    value_type m_rho = 0;
+    unsigned m_max_stages = 200;
+};
+
 /**
 * @brief Runge-Kutta fixed-step explicit time-integration
 * \f$
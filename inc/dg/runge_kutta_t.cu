@@ -112,6 +112,41 @@ int main()
         auto b = dg::create::tableau<double>(name);
         std::cout << "Norm of error in "<<std::setw(24) <<name<<"\t"<<sqrt(dg::blas1::dot( u1, u1))<<(b.isFsal()?" (fsal)" : "") <<"\n";
     }
+    std::cout << "Dense output (interpolate at the middle of each step):\n";
+    for( auto name : {"Bogacki-Shampine-4-2-3", "Dormand-Prince-7-4-5"})
+    {
+        u = solution(t_start, damping, omega_0, omega_drive);
+        dg::ERKStep<std::array<double,2>> erk( name, u);
+        double t = t_start, err = 0.;
+        std::array<double,2> ui;
+        for( unsigned i=0; i<N; i++)
+        {
+            double t0 = t;
+            erk.step( rhs, t, u, t, u, dt);
+            erk.interpolate( t0 + 0.5*dt, ui);
+            dg::blas1::axpby( 1., solution( t0+0.5*dt, damping, omega_0,
+                        omega_drive), -1., ui);
+            err = std::max( err, sqrt( dg::blas1::dot( ui, ui)));
+        }
+        std::cout << "Max norm of error in "<<std::setw(24)
+            <<name<<"\t"<<err<<"\n";
+    }
+    std::cout << "Stabilized Runge-Kutta-Chebyshev method with "<<N<<" steps:\n";
+    {
+        const double rho = 1000.; //stiff dissipative problem
+        auto stiff_rhs = [=]( double t, const double& y, double& yp){
+            yp = -rho*( y - cos(t)) - sin(t);
+        };
+        double us = 1.; //exact solution is cos(t)
+        dg::RKCStep<double> rkc( us);
+        rkc.set_spectral_radius( 1.1*rho);
+        double time = t_start;
+        for( unsigned i=0; i<N; i++)
+            rkc.step( stiff_rhs, time, us, time, us, dt);
+        std::cout << "Norm of error in "<<std::setw(24) <<"RKC2"<<"\t"
+            <<fabs( us - cos(t_end))<<" with "<<rkc.num_stages( dt)
+            <<" stages\n";
+    }
     std::cout << "Shu-Osher Methods with "<<N<<" steps:\n";
     names = std::vector<std::string> {
         "SSPRK-2-2",
@@ -180,5 +215,42 @@ int main()
         dg::blas1::axpby( 1., sol , -1., u1);
         std::cout << "Norm of error in "<<std::setw(24) <<name<<"\t"<<sqrt(dg::blas1::dot( u1, u1))<<"\n";
     }
+    ///-------------------------------Timeloop driver-----------------------//
+    std::cout << "Timeloop driver with callbacks:\n";
+    {
+        u = solution(t_start, damping, omega_0, omega_drive);
+        std::array<double, 2> sol = solution(t_end, damping, omega_0,
+                omega_drive);
+        dg::Timeloop<std::array<double,2>> timeloop(
+            dg::SinglestepTimeloop<std::array<double,2>>(
+                dg::RungeKutta<std::array<double,2>>( "Runge-Kutta-4-4", u),
+                rhs, dt));
+        unsigned maxout = 4, itstp = 5, num_out = 0, num_mon = 0, num_chk = 0;
+        double max_tdiff = 0.;
+        timeloop.set_output( [&]( double time, const std::array<double,2>&){
+            // output times are matched exactly
+            max_tdiff = std::max( max_tdiff, fabs( time - t_start
+                - num_out*(t_end-t_start)/(double)maxout));
+            num_out++;
+            return true;
+        });
+        timeloop.set_monitor( [&]( double, const std::array<double,2>&){
+            num_mon++;
+            return true;
+        });
+        timeloop.set_checkpoint( [&]( double, const std::array<double,2>&){
+            num_chk++;
+            return true;
+        }, 2);
+        timeloop.run( t_start, t_end, u, maxout, itstp);
+        dg::blas1::axpby( 1., sol, -1., u);
+        std::cout << "Norm of error in "<<std::setw(24) <<"Timeloop"<<"\t"
+            <<sqrt(dg::blas1::dot( u, u))<<"\n";
+        std::cout << "Outputs (expect "<<maxout+1<<") "<<num_out
+            <<" monitors (expect "<<maxout*itstp<<") "<<num_mon
+            <<" checkpoints (expect "<<maxout/2<<") "<<num_chk<<"\n";
+        std::cout << "Max deviation from output times (expect 0) "
+            <<max_tdiff<<"\n";
+    }
     return 0;
 }
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "blas.h"
+#include "pcg.h"
+
+/*!@file
+ *
+ * Additive Schwarz preconditioner
+ */
+
+namespace dg
+{
+
+/**
+ * @brief Restricted additive Schwarz preconditioner over the MPI process grid
+ *
+ * Each process approximately solves its local subdomain problem
+ * \f[ A_{loc} z_{loc} = r_{loc} \f]
+ * with a communication-free inner \c dg::PCG on the local part of the
+ * \c dg::MPI_Vector, and the local solutions are combined additively.  The
+ * inner solves run entirely on the shared memory backend, so only the outer
+ * Krylov loop performs global reductions.  This moves work out of the
+ * allreduce-dominated regime at the strong scaling limit.
+ *
+ * The local operator is typically the same operator assembled on the local
+ * grid (e.g. \c dg::Elliptic on \c grid.local()), which implicitly imposes
+ * homogeneous boundary conditions at the subdomain interfaces; this is the
+ * zero-overlap variant of restricted additive Schwarz, i.e. block-Jacobi over
+ * the process grid.  Overlap can be emulated by assembling the local operator
+ * on an enlarged local grid and restricting the solution, which is left to
+ * the application.
+ *
+ * This class has the \c SelfMadeMatrixTag so it can be used as the
+ * preconditioner in \c blas2::symv based solvers
+ * @attention Since the inner iteration count varies between applications the
+ * preconditioner is not exactly constant, which formally requires a flexible
+ * outer method.  In practice \c dg::PCG tolerates a loose, fixed inner
+ * tolerance well; use \c dg::LGMRES or \c dg::BICGSTABl if the outer
+ * iteration stagnates.
+ * @tparam LocalMatrix the local operator, applicable to \c LocalContainer
+ * via \c blas2::symv
+ * @tparam LocalContainer the local (shared memory) vector class, i.e. the
+ * \c container_type of the \c dg::MPI_Vector used in the outer solve
+ * @ingroup invert
+ * @sa \c dg::nested_iterations for an alternative that reduces global
+ * reductions through grid coarsening
+ */
+template< class LocalMatrix, class LocalContainer>
+struct AdditiveSchwarz
+{
+    using container_type = LocalContainer;
+    using value_type = get_value_type<LocalContainer>;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    AdditiveSchwarz() = default;
+    /**
+     * @brief Allocate memory and set the inner solver parameters
+     *
+     * @param op the local operator (copied)
+     * @param precond the preconditioner for the inner solves (e.g.
+     * \c op.precond())
+     * @param weights the weights in which \c op is self-adjoint (e.g.
+     * \c op.weights())
+     * @param max_inner maximum number of inner iterations per application
+     * @param eps_inner (loose) relative tolerance of the inner solves; the
+     * preconditioner only needs to capture the local error components so
+     * values around 0.1 are typical
+     */
+    AdditiveSchwarz( LocalMatrix op, const LocalContainer& precond,
+        const LocalContainer& weights, unsigned max_inner, value_type eps_inner):
+        m_op(op), m_precond( precond), m_weights( weights),
+        m_pcg( weights, max_inner), m_eps( eps_inner)
+    {
+        //the inner solves are approximate by design
+        m_pcg.set_throw_on_fail( false);
+    }
+    ///@brief Perform an individual construction
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        *this = AdditiveSchwarz( std::forward<Params>( ps)...);
+    }
+    /**
+     * @brief Approximately solve the local subdomain problems
+     *
+     * @param r the right hand side (an \c dg::MPI_Vector)
+     * @param z the result (an \c dg::MPI_Vector)
+     */
+    template<class MPIContainer>
+    void symv( const MPIContainer& r, MPIContainer& z)
+    {
+        //restricted additive Schwarz: zero initial guess, local solve
+        dg::blas1::copy( 0., z.data());
+        m_pcg.solve( m_op, z.data(), r.data(), m_precond, m_weights, m_eps, 1.);
+    }
+  private:
+    LocalMatrix m_op;
+    LocalContainer m_precond, m_weights;
+    PCG<LocalContainer> m_pcg;
+    value_type m_eps;
+};
+///@cond
+template< class M, class V>
+struct TensorTraits< AdditiveSchwarz<M, V> >
+{
+    using value_type      = get_value_type<V>;
+    using tensor_category = SelfMadeMatrixTag;
+};
+///@endcond
+
+} //namespace dg
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <list>
+#include <vector>
+#include "backend/config.h"
 #include "backend/exceptions.h"
 #include "blas1.h"
 
@@ -25,6 +26,12 @@ namespace dg{
 The class works by first calling the init function to set the left-side
 boundary and then adding values as they become available.
 * @snippet simpsons_t.cu docu
+* @note The history is kept in a fixed ring buffer and each \c add performs a
+* single vector pass that updates the integral and evicts the oldest sample
+* at once, so continuous integration of full fields costs one fused memory
+* sweep per step and never allocates after \c init
+* @note To integrate many fields at once use a recursive container, e.g.
+* \c Simpsons<std::vector<dg::DVec>>
 * @copydoc hide_ContainerType
 * @ingroup integration
 */
@@ -44,6 +51,13 @@ struct Simpsons
     ///@copydoc Simpsons(unsigned)
     void set_order( unsigned order){
         m_order=order;
+        //rotate the ring such that the newest sample survives a shrink
+        if( m_head != 0 && !m_u.empty())
+        {
+            std::swap( m_t[0], m_t[m_head]);
+            std::swap( m_u[0], m_u[m_head]);
+            m_head = 0;
+        }
         m_t.resize( order-1);
         m_u.resize(order-1);
         if( !(order == 2 || order == 3))
@@ -62,7 +76,8 @@ struct Simpsons
             u = u0;
         for( auto& t: m_t)
             t = 0;
-        m_t.front() = t0;
+        m_head = 0;
+        m_t[m_head] = t0;
         flush();
         m_t0 = t0;
     }
@@ -71,7 +86,7 @@ struct Simpsons
     void flush() {
         m_counter = 0; //since the counter becomes zero we do not need to touch m_u and m_t since the next add triggers the Trapezoidal rule
         dg::blas1::scal( m_integral, 0.);
-        m_t0 = m_t.front();
+        m_t0 = m_t[m_head];
     }
     /*! @brief Add a new (t,u) pair to the time integral
      *
@@ -81,18 +96,34 @@ struct Simpsons
      * @attention the \c init function must be called before you can add values to the integral
      */
     void add( value_type t_new, const ContainerType& u_new){
-        if( t_new < m_t.front())
+        if( t_new < m_t[m_head])
             throw dg::Error(dg::Message()<<"New time must be strictly larger than old time!");
-        auto pt0 = m_t.begin();
-        auto pt1 = std::next( pt0);
-        auto pu0 = m_u.begin();
-        auto pu1 = std::next( pu0);
-        value_type t0 = *pt1, t1 = *pt0, t2 = t_new;
-        if( m_counter % 2 == 0 || m_order == 2)
+        //the oldest sample lives in the slot behind the head and is evicted
+        //in the same vector pass that updates the integral
+        unsigned tail = m_order == 3 ? 1-m_head : 0;
+        value_type t0 = m_t[tail], t1 = m_t[m_head], t2 = t_new;
+        if( m_order == 2)
+        {
+            //Trapezoidal rule
+            value_type pre = 0.5*(t2-t1);
+            dg::blas1::subroutine( [pre] DG_DEVICE
+                ( value_type un, value_type& u1, value_type& integral)
+                {
+                    integral += pre*( un + u1);
+                    u1 = un;
+                }, u_new, m_u[0], m_integral);
+        }
+        else if( m_counter % 2 == 0)
         {
             //Trapezoidal rule
-            dg::blas1::axpbypgz( 0.5*(t2 - t1), u_new,
-                0.5*(t2 - t1), *pu0 , 1., m_integral);
+            value_type pre = 0.5*(t2-t1);
+            dg::blas1::subroutine( [pre] DG_DEVICE
+                ( value_type un, value_type u1, value_type& u0,
+                  value_type& integral)
+                {
+                    integral += pre*( un + u1);
+                    u0 = un;
+                }, u_new, m_u[m_head], m_u[tail], m_integral);
         }
         else
         {
@@ -100,18 +131,19 @@ struct Simpsons
             value_type pre0 = (2.*t0-3.*t1+t2)*(t2-t0)/(6.*(t0-t1));
             value_type pre1 = (t2-t0)*(t2-t0)*(t2-t0)/(6.*(t0-t1)*(t1-t2));
             value_type pre2 = (t0-3.*t1+2.*t2)*(t0-t2)/(6.*(t1-t2));
+            //subtract last Trapezoidal step
+            value_type cor1 = pre1-0.5*(t1-t0), cor0 = pre0-0.5*(t1-t0);
 
-            dg::blas1::axpby( pre2, u_new, 1., m_integral);
-            dg::blas1::axpbypgz(
-                pre1-0.5*(t1-t0), *pu0, //subtract last Trapezoidal step
-                pre0-0.5*(t1-t0), *pu1,
-                1., m_integral);
+            dg::blas1::subroutine( [pre2,cor1,cor0] DG_DEVICE
+                ( value_type un, value_type u1, value_type& u0,
+                  value_type& integral)
+                {
+                    integral += pre2*un + cor1*u1 + cor0*u0;
+                    u0 = un;
+                }, u_new, m_u[m_head], m_u[tail], m_integral);
         }
-        //splice does not copy or move anything, only the internal pointers of the list nodes are re-pointed
-        m_t.splice( pt0, m_t, pt1, m_t.end());//permute elements
-        m_u.splice( pu0, m_u, pu1, m_u.end());
-        m_t.front() = t_new; //and now remove zeroth element
-        dg::blas1::copy( u_new, m_u.front());
+        m_t[tail] = t_new;
+        m_head = tail; //the evicted slot becomes the new head
         m_counter++;
     }
 
@@ -127,15 +159,15 @@ struct Simpsons
      * @return the current integral boundaries
      */
     std::array<value_type,2> get_boundaries() const{
-        std::array<value_type,2> times{ m_t0, m_t.front()};
+        std::array<value_type,2> times{ m_t0, m_t[m_head]};
         return times;
     }
     private:
-    unsigned m_counter, m_order;
+    unsigned m_counter, m_order, m_head = 0;
     ContainerType m_integral;
-    //we use a list here to avoid explicitly calling the swap function
-    std::list<value_type> m_t;
-    std::list<ContainerType> m_u;
+    //fixed ring buffer of the last order-1 samples, m_head indexes the newest
+    std::vector<value_type> m_t;
+    std::vector<ContainerType> m_u;
     value_type m_t0;
 };
 
@@ -50,6 +50,26 @@ int main()
     boundaries = simpsons.get_boundaries();
     std::cout << "Integrated from "<<boundaries[0]<<" ("<<M_PI/2.<<") to "<<boundaries[1]<<" ("<<M_PI<<") "<<std::endl;
 
+    //Integrate several fields at once with a recursive container
+    g1d = dg::Grid1d( 0, M_PI/2., 3, N );
+    times = dg::evaluate( dg::cooX1d, g1d);
+    std::vector<dg::HVec> fields( 2, dg::HVec( 10, 0.)), tmp(fields);
+    dg::blas1::copy( 1., fields[0]); //cos( 0)
+    dg::blas1::copy( 0., fields[1]); //sin( 0)
+    dg::Simpsons<std::vector<dg::HVec>> multi;
+    multi.init( 0., fields);
+    for ( unsigned i=0; i<g1d.size(); i++)
+    {
+        dg::blas1::copy( cos( times[i]), tmp[0]);
+        dg::blas1::copy( sin( times[i]), tmp[1]);
+        multi.add( times[i], tmp);
+    }
+    dg::blas1::copy( 0., tmp[0]);
+    dg::blas1::copy( 1., tmp[1]);
+    multi.add( M_PI/2., tmp);
+    std::cout << "Multi-field errors are "
+              <<fabs(multi.get_integral()[0][0]-1.)<<" (cos) and "
+              <<fabs(multi.get_integral()[1][0]-1.)<<" (sin)"<<std::endl;
 
     return 0;
 }
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "backend/config.h"
+#include "blas1.h"
+
+/*! @file
+ * @brief Streaming statistics of time series
+ */
+namespace dg{
+///@cond
+namespace detail{
+template<class value_type>
+struct WelfordUpdate
+{
+    value_type inv_n;
+    DG_DEVICE
+    void operator()( value_type u, value_type& mean, value_type& m2) const
+    {
+        value_type delta = u - mean;
+        mean = DG_FMA( inv_n, delta, mean);
+        //delta uses the old mean, the second factor the updated one
+        m2 = DG_FMA( delta, u - mean, m2);
+    }
+};
+template<class value_type>
+struct WelfordCoUpdate
+{
+    value_type inv_n;
+    DG_DEVICE
+    void operator()( value_type u, value_type v, value_type& mean_u,
+        value_type& mean_v, value_type& c2) const
+    {
+        value_type delta = u - mean_u;
+        mean_u = DG_FMA( inv_n, delta, mean_u);
+        mean_v = DG_FMA( inv_n, v - mean_v, mean_v);
+        c2 = DG_FMA( delta, v - mean_v, c2);
+    }
+};
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Streaming (pointwise) mean and variance of a time series
+ *
+ * The intention of this class is to accumulate the running mean and
+ * variance of samples \f$ u_i\f$ that become available one after the other
+ * during a simulation (e.g. every N-th timestep), without storing the
+ * series itself. Instead of writing the full fields to file and
+ * re-reading the entire series in post-processing, only the compact
+ * accumulated records need to be written out.
+ *
+ * Each sample is absorbed in a single fused \c dg::blas1::subroutine pass
+ * over three vectors using Welford's numerically stable update
+ \f[ \bar u \mathrel{+}= (u_i - \bar u)/n, \qquad
+     M_2 \mathrel{+}= (u_i - \bar u_{old})(u_i - \bar u) \f]
+ * so the cost per sample is that of roughly two vector additions.
+ * @sa \c Simpsons to accumulate time integrals instead
+ * @sa https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ * @copydoc hide_ContainerType
+ * @ingroup integration
+ */
+template<class ContainerType>
+struct RunningStatistics
+{
+    using value_type = get_value_type<ContainerType>;//!< value type of the samples
+    using container_type = ContainerType; //!< the type of the vector class in use
+    ///@brief Allocate nothing, Call \c init method before usage
+    RunningStatistics() = default;
+    /**
+     * @brief Allocate memory and set all accumulators to zero
+     * @param copyable the samples must have this size
+     */
+    RunningStatistics( const ContainerType& copyable): m_mean( copyable),
+        m_m2( copyable)
+    {
+        init( copyable);
+    }
+    /**
+     * @brief Reset all accumulators to zero
+     * @param copyable the samples must have this size
+     */
+    void init( const ContainerType& copyable)
+    {
+        m_mean = m_m2 = copyable;
+        dg::blas1::copy( 0., m_mean);
+        dg::blas1::copy( 0., m_m2);
+        m_count = 0;
+    }
+    /**
+     * @brief Absorb a new sample into the accumulators
+     * @param u the sample (must have the same size as \c copyable in the
+     * constructor)
+     */
+    void add( const ContainerType& u)
+    {
+        m_count++;
+        dg::blas1::subroutine( detail::WelfordUpdate<value_type>{
+            (value_type)1/(value_type)m_count}, u, m_mean, m_m2);
+    }
+    ///@brief The number of samples absorbed since the last \c init
+    unsigned long count() const{ return m_count;}
+    ///@brief The pointwise mean of all absorbed samples
+    const ContainerType& mean() const{ return m_mean;}
+    /**
+     * @brief Compute the pointwise variance of all absorbed samples
+     * @param out contains \f$ M_2/(n-1)\f$ on output (or \f$ M_2/n\f$ for
+     * the population variance)
+     * @param sample if false, divide by \c n instead of \c n-1
+     * @note at least 2 samples must have been absorbed (1 for
+     * \c sample=false )
+     */
+    void variance( ContainerType& out, bool sample = true) const
+    {
+        unsigned long n = sample ? m_count - 1 : m_count;
+        dg::blas1::axpby( (value_type)1/(value_type)n, m_m2, 0., out);
+    }
+    private:
+    ContainerType m_mean, m_m2;
+    unsigned long m_count = 0;
+};
+
+/**
+ * @brief Streaming (pointwise) covariance of two time series
+ *
+ * Same algorithm as \c RunningStatistics but accumulates the means of two
+ * sample series \f$ u_i,\ v_i\f$ and their mixed central second moment in
+ * a single fused \c dg::blas1::subroutine pass over five vectors
+ * @copydoc hide_ContainerType
+ * @ingroup integration
+ */
+template<class ContainerType>
+struct RunningCovariance
+{
+    using value_type = get_value_type<ContainerType>;//!< value type of the samples
+    using container_type = ContainerType; //!< the type of the vector class in use
+    ///@brief Allocate nothing, Call \c init method before usage
+    RunningCovariance() = default;
+    ///@copydoc RunningStatistics::RunningStatistics(const ContainerType&)
+    RunningCovariance( const ContainerType& copyable)
+    {
+        init( copyable);
+    }
+    ///@copydoc RunningStatistics::init(const ContainerType&)
+    void init( const ContainerType& copyable)
+    {
+        m_mean_u = m_mean_v = m_c2 = copyable;
+        dg::blas1::copy( 0., m_mean_u);
+        dg::blas1::copy( 0., m_mean_v);
+        dg::blas1::copy( 0., m_c2);
+        m_count = 0;
+    }
+    /**
+     * @brief Absorb a new pair of samples into the accumulators
+     * @param u the first sample
+     * @param v the second sample
+     */
+    void add( const ContainerType& u, const ContainerType& v)
+    {
+        m_count++;
+        dg::blas1::subroutine( detail::WelfordCoUpdate<value_type>{
+            (value_type)1/(value_type)m_count}, u, v, m_mean_u, m_mean_v,
+            m_c2);
+    }
+    ///@copydoc RunningStatistics::count()
+    unsigned long count() const{ return m_count;}
+    ///@brief The pointwise mean of the first sample series
+    const ContainerType& mean_u() const{ return m_mean_u;}
+    ///@brief The pointwise mean of the second sample series
+    const ContainerType& mean_v() const{ return m_mean_v;}
+    /**
+     * @brief Compute the pointwise covariance of the absorbed sample pairs
+     * @param out contains \f$ C_2/(n-1)\f$ on output (or \f$ C_2/n\f$ for
+     * the population covariance)
+     * @param sample if false, divide by \c n instead of \c n-1
+     */
+    void covariance( ContainerType& out, bool sample = true) const
+    {
+        unsigned long n = sample ? m_count - 1 : m_count;
+        dg::blas1::axpby( (value_type)1/(value_type)n, m_c2, 0., out);
+    }
+    private:
+    ContainerType m_mean_u, m_mean_v, m_c2;
+    unsigned long m_count = 0;
+};
+
+}//namespace dg
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+#include "statistics.h"
+#include "topology/evaluation.h"
+#include "topology/geometry.h"
+
+int main()
+{
+    std::cout << "Program to test the streaming statistics accumulators\n";
+    // We sample u(x,t) = sin(x)*cos(t) and v(x,t) = sin(x)*sin(t) over one
+    // period; the time averages are analytically known:
+    // <u> = <v> = 0, Var(u) = Var(v) = sin^2(x)/2, Cov(u,v) = 0
+    unsigned Nx = 20, Nt = 100;
+    dg::Grid1d g1d( 0, 2.*M_PI, 3, Nx);
+    const dg::DVec sinx = dg::construct<dg::DVec>( dg::evaluate( sin, g1d));
+    dg::DVec u( sinx), v( sinx), result( sinx);
+
+    dg::RunningStatistics<dg::DVec> stats( u);
+    dg::RunningCovariance<dg::DVec> cov( u);
+    for( unsigned i=0; i<Nt; i++)
+    {
+        double t = 2.*M_PI*(i+0.5)/(double)Nt;
+        dg::blas1::axpby( cos(t), sinx, 0., u);
+        dg::blas1::axpby( sin(t), sinx, 0., v);
+        stats.add( u);
+        cov.add( u, v);
+    }
+    std::cout << "Absorbed "<<stats.count()<<" samples ("<<Nt<<")\n";
+
+    double err = sqrt( dg::blas1::dot( stats.mean(), stats.mean())/(double)g1d.size());
+    std::cout << "Error of mean       is "<<err<<" (0)\n";
+
+    stats.variance( result, false);
+    dg::blas1::pointwiseDot( 0.5, sinx, sinx, -1., result);
+    err = sqrt( dg::blas1::dot( result, result)/(double)g1d.size());
+    std::cout << "Error of variance   is "<<err<<" (0)\n";
+
+    cov.covariance( result, false);
+    err = sqrt( dg::blas1::dot( result, result)/(double)g1d.size());
+    std::cout << "Error of covariance is "<<err<<" (0)\n";
+
+    return 0;
+}
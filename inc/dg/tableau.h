@@ -158,11 +158,49 @@ struct ButcherTableau{
                 return false;
         return true;
     }
+    /*! @brief Provide coefficients for a continuous extension (dense output)
+     *
+     * A continuous extension replaces the constant coefficients \c b_j by
+     * polynomials \f$ b_j(\theta) = \sum_{k=1}^{K} b_{jk}\theta^k\f$ with
+     * \f$ \theta = (t - t^n)/\Delta t \in [0,1]\f$ so that
+     * \f$ u( t^n + \theta\Delta t) = u^n + \Delta t \sum_{j=1}^s
+     * b_j(\theta) k_j\f$ interpolates the solution anywhere inside the last
+     * step without additional right hand side evaluations.
+     * Consistency requires \f$ b_j(1) = b_j\f$.
+     * @param kmax the polynomial degree K
+     * @param bi s*kmax real numbers interpreted as \f$ b_{jk}\f$=bi[j*kmax+k-1]
+     * @sa ERKStep::interpolate
+     */
+    void set_dense_output( unsigned kmax, const std::vector<real_type>& bi){
+        m_kmax = kmax;
+        m_bi = bi;
+        m_dense = true;
+    }
+    /**
+    * @brief Read the dense output coefficients \f$ b_{jk}\f$
+    * @param j col number 0<=j<s, j>=s results in undefined behaviour
+    * @param k monomial number 0<=k<kmax(), the coefficient of \f$\theta^{k+1}\f$
+    * @return b_jk
+    */
+    real_type bi( unsigned j, unsigned k) const {
+        return m_bi[j*m_kmax + k];
+    }
+    ///The polynomial degree of the continuous extension
+    unsigned kmax() const {
+        return m_kmax;
+    }
+    ///True if the method has a continuous extension (dense output)
+    bool hasDenseOutput() const{
+        return m_dense;
+    }
     private:
     dg::Operator<real_type> m_a;
     std::vector<real_type> m_b, m_c, m_bt;
+    std::vector<real_type> m_bi;
     unsigned m_q, m_p, m_s;
+    unsigned m_kmax = 0;
     bool m_embedded = false;
+    bool m_dense = false;
 };
 
 /**
@@ -398,7 +436,16 @@ ButcherTableau<real_type> bogacki_shampine_4_2_3()
     real_type b[4] = {2./9., 1./3., 4./9., 0.};
     real_type bt[4] = {7./24., 1./4.,1./3.,1./8.};
     real_type c[4] = {0.,0.5,3./4.,1.};
-    return ButcherTableau<real_type>(4,2,3, a, b, bt, c);
+    ButcherTableau<real_type> t(4,2,3, a, b, bt, c);
+    // third order continuous extension: the cubic Hermite interpolant through
+    // (u0, k_0) and (u1, k_3) used by the ode23 solver
+    std::vector<real_type> bi = {
+        1., -4./3., 5./9.,
+        0., 1., -2./3.,
+        0., 4./3., -8./9.,
+        0., -1., 1.};
+    t.set_dense_output( 3, bi);
+    return t;
 }
 template<class real_type>
 ButcherTableau<real_type> cavaglieri_exp_4_2_3()
@@ -528,7 +575,34 @@ ButcherTableau<real_type> dormand_prince_7_4_5()
   5 , 35./384. , 0 , 500./1113. , 125./192. , -2187./6784. , 11./84. , 0 ,
   4 , 5179./57600. , 0 , 7571./16695. , 393./640. , -92097./339200. , 187./2100. , 1./40.
     };
-    return ButcherTableau<real_type>(7,data);
+    ButcherTableau<real_type> t(7,data);
+    // fourth order continuous extension [Hairer, Noersett, Wanner, Solving
+    // ordinary differential Equations I, Sec. II.6]: written as
+    // b_j(theta) = bv_j A + cj B + dj theta B (+ extras for j=0,6) with
+    // A = theta^2(3-2 theta), B = theta^2(theta-1)^2
+    real_type bv[7] = {35./384., 0., 500./1113., 125./192., -2187./6784.,
+        11./84., 0.};
+    real_type cj[7] = { -5.*2558722523./11282082432., 0.,
+        100.*882725551./32700410799., -25.*443332067./1880347072.,
+        32805.*23143187./199316789632., -55.*29972135./822651844.,
+        10.*7414447./29380423.};
+    real_type dj[7] = { 5.*31403016./11282082432., 0.,
+        -100.*15701508./32700410799., 25.*31403016./1880347072.,
+        -32805.*3489224./199316789632., 55.*7076736./822651844.,
+        -10.*829305./29380423.};
+    std::vector<real_type> bi( 7*5, 0.);
+    for( unsigned j=0; j<7; j++)
+    {
+        bi[j*5+1] = 3.*bv[j] + cj[j];
+        bi[j*5+2] = -2.*bv[j] + dj[j] - 2.*cj[j];
+        bi[j*5+3] = cj[j] - 2.*dj[j];
+        bi[j*5+4] = dj[j];
+    }
+    // j=0 has an extra theta(theta-1)^2, j=6 an extra theta^2(theta-1)
+    bi[0*5+0] += 1., bi[0*5+1] -= 2., bi[0*5+2] += 1.;
+    bi[6*5+1] -= 1., bi[6*5+2] += 1.;
+    t.set_dense_output( 5, bi);
+    return t;
 }
 template<class real_type>
 ButcherTableau<real_type> tsitouras09_7_4_5()
@@ -11,9 +11,10 @@
   */
 namespace dg{
 ///@cond
-template<class container>
-void simple_average( unsigned nx, unsigned ny, const container& in0, const container& in1, container& out)
+template<class ContainerType0, class ContainerType1, class ContainerType2>
+void simple_average( unsigned nx, unsigned ny, const ContainerType0& in0, const ContainerType1& in1, ContainerType2& out)
 {
+    using container = std::remove_const_t<ContainerType1>;
     const double* in0_ptr = thrust::raw_pointer_cast( in0.data());
     const double* in1_ptr = thrust::raw_pointer_cast( in1.data());
           double* out_ptr = thrust::raw_pointer_cast( out.data());
@@ -75,8 +76,6 @@ struct Average
             dg::blas1::scal( m_temp, 1./g.lx());
             dg::blas1::scal( m_w, 1./g.lx());
             size1d = m_ny;
-            if( "simple" == mode)
-                dg::transpose( m_nx, m_ny, m_temp, m_w);
         }
         else
         {
@@ -105,8 +104,6 @@ struct Average
             dg::blas1::scal( m_temp, 1./g.lx());
             dg::blas1::scal( m_w, 1./g.lx());
             m_nx = nx, m_ny = ny*nz;
-            if( "simple" == mode)
-                dg::transpose( m_nx, m_ny, m_temp, m_w);
         }
         else if( direction == coo3d::z) {
             m_transpose = true;
@@ -120,8 +117,6 @@ struct Average
             dg::blas1::scal( m_temp, 1./g.lx()/g.ly());
             dg::blas1::scal( m_w, 1./g.lx()/g.ly());
             m_nx = nx*ny, m_ny = nz;
-            if( "simple" == mode)
-                dg::transpose( m_nx, m_ny, m_temp, m_w);
         }
         else if( direction == coo3d::yz) {
             m_transpose = true;
@@ -154,6 +149,85 @@ struct Average
      * @param extend if \c true the average is extended back to the original dimensionality, if \c false, this step is skipped
      */
     void operator() (const ContainerType& src, ContainerType& res, bool extend = true)
+    {
+        compute( src);
+        if( extend )
+            extend_back( res);
+        else
+            res = m_temp1d;
+    }
+    /**
+     * @brief Compute the average of a \c dg::View (or in general a foreign container type)
+     *
+     * The same as the \c ContainerType overload except that \c res is never
+     * resized. In particular \c src and \c res may be (const) \c dg::View s
+     * of the planes generated by \c dg::split, which avoids copying each
+     * plane into a temporary.
+     * @param src Source Vector (must have the same size as the grid given in the constructor)
+     * @param res result Vector (must have the same size as \c src if \c
+     * extend==true and the size of the reduced dimensionality if \c
+     * extend==false, may alias \c src)
+     * @param extend if \c true the average is extended back to the original dimensionality, if \c false, this step is skipped
+     */
+    template<class ContainerType0, class ContainerType1>
+    void operator() (const ContainerType0& src, ContainerType1& res, bool extend = true)
+    {
+        compute( src);
+        if( extend )
+            extend_back( res);
+        else
+            dg::blas1::copy( m_temp1d, res);
+    }
+    /**
+     * @brief Average a batch of fields in one go
+     *
+     * In "simple" mode and if the averaged direction is contiguous in memory
+     * all fields are reduced in a single fused segmented-reduction kernel,
+     * which is significantly faster than averaging the fields one by one
+     * (e.g. in diagnostics that average dozens of fields per output step).
+     * Otherwise this method falls back to a field by field computation.
+     * @param src Source Vectors (each must have the same size as the grid given in the constructor)
+     * @param res result Vectors (must have the same number of entries as \c
+     * src; each entry must have the same size as its source if \c
+     * extend==true and the size of the reduced dimensionality if \c
+     * extend==false)
+     * @param extend if \c true the average is extended back to the original dimensionality, if \c false, this step is skipped
+     */
+    template<class ContainerType0, class ContainerType1>
+    void operator() (const std::vector<ContainerType0>& src, std::vector<ContainerType1>& res, bool extend = true)
+    {
+        assert( src.size() == res.size());
+        if( "simple" != m_mode || m_transpose)
+        {
+            //fall back to a field by field computation
+            for( unsigned u=0; u<src.size(); u++)
+                this->operator()( src[u], res[u], extend);
+            return;
+        }
+        unsigned nf = src.size();
+        if( m_batch.size() != nf*m_ny)
+            m_batch = dg::construct<ContainerType>(
+                thrust::host_vector<double>( nf*m_ny, 0.));
+        std::vector<const double*> in_ptrs( nf);
+        for( unsigned u=0; u<nf; u++)
+            in_ptrs[u] = thrust::raw_pointer_cast( src[u].data());
+        dg::segment_average( get_execution_policy<ContainerType>(), nf, m_nx,
+            m_ny, in_ptrs.data(), thrust::raw_pointer_cast( m_w.data()),
+            thrust::raw_pointer_cast( m_batch.data()));
+        for( unsigned u=0; u<nf; u++)
+        {
+            dg::View<const ContainerType> slice(
+                thrust::raw_pointer_cast( m_batch.data()) + u*m_ny, m_ny);
+            if( extend )
+                dg::extend_column( m_nx, m_ny, slice, res[u]);
+            else
+                dg::blas1::copy( slice, res[u]);
+        }
+    }
+
+  private:
+    template<class ContainerType0>
+    void compute( const ContainerType0& src)
     {
         if( !m_transpose)
         {
@@ -161,14 +235,8 @@ struct Average
             if( "exact" == m_mode)
                 dg::average( m_nx, m_ny, src, m_w, m_temp1d);
             else
-            {
-                dg::transpose( m_nx, m_ny, src, m_temp);
-                dg::simple_average( m_ny, m_nx, m_temp, m_w, m_temp1d);
-            }
-            if( extend )
-                dg::extend_column( m_nx, m_ny, m_temp1d, res);
-            else
-                res = m_temp1d;
+                //one segment per contiguous chunk, no transpose needed
+                dg::segment_average( m_nx, m_ny, src, m_w, m_temp1d);
         }
         else
         {
@@ -180,16 +248,18 @@ struct Average
             }
             else
                 dg::simple_average( m_nx, m_ny, src, m_w, m_temp1d);
-            if( extend )
-                dg::extend_line( m_nx, m_ny, m_temp1d, res);
-            else
-                res = m_temp1d;
         }
     }
-
-  private:
+    template<class ContainerType1>
+    void extend_back( ContainerType1& res)
+    {
+        if( !m_transpose)
+            dg::extend_column( m_nx, m_ny, m_temp1d, res);
+        else
+            dg::extend_line( m_nx, m_ny, m_temp1d, res);
+    }
     unsigned m_nx, m_ny;
-    ContainerType m_w, m_temp, m_temp1d;
+    ContainerType m_w, m_temp, m_temp1d, m_batch;
     bool m_transpose;
     std::string m_mode;
 };
@@ -11,9 +11,10 @@
 namespace dg{
 
 ///@cond
-template<class container>
-void simple_mpi_average( unsigned nx, unsigned ny, const container& in0, const container& in1, container& out, MPI_Comm comm)
+template<class ContainerType0, class ContainerType1, class ContainerType2>
+void simple_mpi_average( unsigned nx, unsigned ny, const ContainerType0& in0, const ContainerType1& in1, ContainerType2& out, MPI_Comm comm)
 {
+    using container = std::remove_const_t<ContainerType1>;
     const double* in0_ptr = thrust::raw_pointer_cast( in0.data());
     const double* in1_ptr = thrust::raw_pointer_cast( in1.data());
           double* out_ptr = thrust::raw_pointer_cast( out.data());
@@ -69,8 +70,6 @@ struct Average<MPI_Vector<container> >
             dg::blas1::scal( m_temp, 1./g.lx());
             size1d = m_ny;
             remain_dims[0] = true;
-            if( "simple" == mode)
-                dg::transpose( m_nx, m_ny, m_temp.data(), m_w.data());
         }
         else
         {
@@ -112,8 +111,6 @@ struct Average<MPI_Vector<container> >
             dg::blas1::scal( m_temp, 1./g.lx());
             m_nx = nx, m_ny = ny*nz;
             remain_dims[0] = true;
-            if( "simple" == mode)
-                dg::transpose( m_nx, m_ny, m_temp.data(), m_w.data());
         }
         else if( direction == dg::coo3d::z) {
             m_transpose = true;
@@ -129,8 +126,6 @@ struct Average<MPI_Vector<container> >
             dg::blas1::scal( m_temp, 1./g.lx()/g.ly());
             m_nx = nx*ny, m_ny = nz;
             remain_dims[0] = remain_dims[1] = true;
-            if( "simple" == mode)
-                dg::transpose( m_nx, m_ny, m_temp.data(), m_w.data());
         }
         else if( direction == dg::coo3d::yz) {
             m_transpose = true;
@@ -143,14 +138,23 @@ struct Average<MPI_Vector<container> >
         }
         else
             std::cerr << "Warning: this direction is not implemented\n";
-        //Now get the reduction communicator
-        MPI_Cart_sub( g.communicator(), remain_dims, &m_comm);
-        exblas::mpi_reduce_communicator( m_comm, &m_comm_mod, &m_comm_mod_reduce);
-        // ... and the one perpendicular to it
-        for( unsigned i=0; i<3; i++)
-            remain_dims[i] = !remain_dims[i];
+        //Now get the reduction communicator and the one perpendicular to it;
+        //the grid caches the xy and z subcommunicators, which avoids the
+        //collective MPI_Cart_sub on the full 3d communicator for the two
+        //most common directions
         MPI_Comm comm2;
-        MPI_Cart_sub( g.communicator(), remain_dims, &comm2);
+        if( direction == dg::coo3d::z)
+            m_comm = g.get_para_comm(), comm2 = g.get_perp_comm();
+        else if( direction == dg::coo3d::xy)
+            m_comm = g.get_perp_comm(), comm2 = g.get_para_comm();
+        else
+        {
+            MPI_Cart_sub( g.communicator(), remain_dims, &m_comm);
+            for( unsigned i=0; i<3; i++)
+                remain_dims[i] = !remain_dims[i];
+            MPI_Cart_sub( g.communicator(), remain_dims, &comm2);
+        }
+        exblas::mpi_reduce_communicator( m_comm, &m_comm_mod, &m_comm_mod_reduce);
         // with that construct the reduce mpi vec
         thrust::host_vector<double> t1d;
         if(!m_transpose)
@@ -175,6 +179,85 @@ struct Average<MPI_Vector<container> >
      * In that case, each process has a result vector with reduced dimensionality and a Cartesian communicator only in the remaining dimensions. Note that in any case \b all processes get the result (since the underlying dot product distributes its result to all processes)
      */
     void operator() (const MPI_Vector<container>& src, MPI_Vector<container>& res, bool extend = true)
+    {
+        compute( src);
+        if( extend )
+            extend_back( res);
+        else
+            res = m_temp1d;
+    }
+    /**
+     * @brief Compute the average of an \c MPI_Vector of \c dg::View
+     *
+     * The same as the \c MPI_Vector<container> overload except that \c res
+     * is never resized. In particular \c src and \c res may be the
+     * \c MPI_Vector s of (const) \c dg::View generated by \c dg::split,
+     * which avoids copying each plane into a temporary.
+     * @param src Source Vector (must have the same size and communicator as the grid given in the constructor)
+     * @param res result Vector (must have the same size as \c src if \c
+     * extend==true and the size of the reduced dimensionality if \c
+     * extend==false, may alias \c src)
+     * @param extend if \c true the average is extended back to the original dimensionality, if \c false, this step is skipped
+     */
+    template<class ContainerType0, class ContainerType1>
+    void operator() (const ContainerType0& src, ContainerType1& res, bool extend = true)
+    {
+        compute( src);
+        if( extend )
+            extend_back( res);
+        else
+            dg::blas1::copy( m_temp1d, res);
+    }
+    /**
+     * @brief Average a batch of fields in one go
+     *
+     * In "simple" mode and if the averaged direction is contiguous in memory
+     * all fields are reduced in a single fused segmented-reduction kernel and
+     * the per-field reductions are combined into a single \c MPI_Allreduce,
+     * which is significantly faster than averaging the fields one by one
+     * (e.g. in diagnostics that average dozens of fields per output step).
+     * Otherwise this method falls back to a field by field computation.
+     * @param src Source Vectors (each must have the same size and communicator as the grid given in the constructor)
+     * @param res result Vectors (must have the same number of entries as \c
+     * src; each entry must have the same size as its source if \c
+     * extend==true and the size of the reduced dimensionality if \c
+     * extend==false)
+     * @param extend if \c true the average is extended back to the original dimensionality, if \c false, this step is skipped
+     */
+    template<class ContainerType0, class ContainerType1>
+    void operator() (const std::vector<ContainerType0>& src, std::vector<ContainerType1>& res, bool extend = true)
+    {
+        assert( src.size() == res.size());
+        if( "simple" != m_mode || m_transpose)
+        {
+            //fall back to a field by field computation
+            for( unsigned u=0; u<src.size(); u++)
+                this->operator()( src[u], res[u], extend);
+            return;
+        }
+        unsigned nf = src.size();
+        if( m_batch.size() != nf*m_ny)
+            m_batch = dg::construct<container>(
+                thrust::host_vector<double>( nf*m_ny, 0.));
+        std::vector<const double*> in_ptrs( nf);
+        for( unsigned u=0; u<nf; u++)
+            in_ptrs[u] = thrust::raw_pointer_cast( src[u].data().data());
+        dg::segment_average_mpi( get_execution_policy<container>(), nf, m_nx,
+            m_ny, in_ptrs.data(), thrust::raw_pointer_cast( m_w.data().data()),
+            thrust::raw_pointer_cast( m_batch.data()), m_comm);
+        for( unsigned u=0; u<nf; u++)
+        {
+            dg::View<const container> slice(
+                thrust::raw_pointer_cast( m_batch.data()) + u*m_ny, m_ny);
+            if( extend )
+                dg::extend_column( m_nx, m_ny, slice, res[u].data());
+            else
+                dg::blas1::copy( slice, res[u].data());
+        }
+    }
+  private:
+    template<class ContainerType0>
+    void compute( const ContainerType0& src)
     {
         if( !m_transpose)
         {
@@ -183,16 +266,9 @@ struct Average<MPI_Vector<container> >
                 dg::mpi_average( m_nx, m_ny, src.data(), m_w.data(),
                     m_temp1d.data(), m_comm, m_comm_mod, m_comm_mod_reduce);
             else
-            {
-                dg::transpose( m_nx, m_ny, src.data(), m_temp.data());
-                dg::simple_mpi_average( m_ny, m_nx, m_temp.data(), m_w.data(),
+                //one segment per contiguous chunk, no transpose needed
+                dg::segment_average_mpi( m_nx, m_ny, src.data(), m_w.data(),
                     m_temp1d.data(), m_comm);
-            }
-
-            if( extend )
-                dg::extend_column( m_nx, m_ny, m_temp1d.data(), res.data());
-            else
-                res = m_temp1d;
         }
         else
         {
@@ -206,16 +282,19 @@ struct Average<MPI_Vector<container> >
             else
                 dg::simple_mpi_average( m_nx, m_ny, src.data(), m_w.data(),
                     m_temp1d.data(), m_comm);
-
-            if( extend )
-                dg::extend_line( m_nx, m_ny, m_temp1d.data(), res.data());
-            else
-                res = m_temp1d;
         }
     }
-  private:
+    template<class ContainerType1>
+    void extend_back( ContainerType1& res)
+    {
+        if( !m_transpose)
+            dg::extend_column( m_nx, m_ny, m_temp1d.data(), res.data());
+        else
+            dg::extend_line( m_nx, m_ny, m_temp1d.data(), res.data());
+    }
     unsigned m_nx, m_ny;
     MPI_Vector<container> m_w, m_temp, m_temp1d;
+    container m_batch;
     bool m_transpose;
     MPI_Comm m_comm, m_comm_mod, m_comm_mod_reduce;
     std::string m_mode;
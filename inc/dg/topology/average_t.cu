@@ -41,6 +41,20 @@ int main()
     const dg::DVec w2d = dg::create::weights( g);
     res.d = sqrt( dg::blas2::dot( average_y, w2d, average_y));
     std::cout << "Distance to solution is: "<<res.d<<"\t"<<res.i-binary[1]<<std::endl;
+    std::cout << "Averaging x through views ... \n";
+    dg::DVec result( vector);
+    dg::View<const dg::DVec> view_in( vector.data(), vector.size());
+    dg::View<dg::DVec> view_out( result.data(), result.size());
+    tor( view_in, view_out, true);
+    dg::blas1::axpby( 1., solution, -1., result);
+    res.d = sqrt( dg::blas2::dot( result, w2d, result));
+    std::cout << "Distance to solution is: "<<res.d<<"\t"<<res.i-binary[1]<<std::endl;
+    std::cout << "Averaging x over a batch of fields ... \n";
+    std::vector<dg::DVec> batch( 3, vector), batch_avg( 3, vector);
+    tor( batch, batch_avg, true);
+    dg::blas1::axpby( 1., solution, -1., batch_avg[2]);
+    res.d = sqrt( dg::blas2::dot( batch_avg[2], w2d, batch_avg[2]));
+    std::cout << "Distance to solution is: "<<res.d<<"\t"<<res.i-binary[1]<<std::endl;
     //std::cout << "\n Continue with \n\n";
 
     return 0;
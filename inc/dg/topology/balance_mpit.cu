@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include <mpi.h>
+#include "mpi_balance.h"
+
+double bottleneck( const std::vector<double>& weights, const std::vector<unsigned>& offsets)
+{
+    double max = 0;
+    for( unsigned p=0; p<offsets.size()-1; p++)
+    {
+        double sum = 0;
+        for( unsigned i=offsets[p]; i<offsets[p+1]; i++)
+            sum += weights[i];
+        max = std::max( max, sum);
+    }
+    return max;
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init( &argc, &argv);
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    if(rank==0)std::cout << "This program tests the balanced_partition function and the LoadBalance class. A TEST is PASSED if the relative error in the last column is small (or the condition in the second to last column holds)!\n";
+    //// Test the partitioner on a synthetic refined region: most blocks cost
+    //// 1, a few neighboring blocks (the "separatrix") cost 5
+    unsigned num_blocks = 8*size;
+    std::vector<double> weights( num_blocks, 1.);
+    for( unsigned i=num_blocks/2; i<num_blocks/2+3 && i<num_blocks; i++)
+        weights[i] = 5.;
+    std::vector<unsigned> offsets = dg::balanced_partition( weights, size);
+    double total = 0;
+    for( unsigned i=0; i<num_blocks; i++)
+        total += weights[i];
+    double equal = bottleneck( weights, dg::LoadBalance( num_blocks, MPI_COMM_WORLD).get_offsets());
+    double balanced = bottleneck( weights, offsets);
+    if(rank==0)
+    {
+        std::cout << "Partition of "<<num_blocks<<" blocks among "<<size<<" ranks:\n";
+        std::cout << "    equal split bottleneck "<<equal<<" balanced bottleneck "<<balanced<<" average "<<total/(double)size<<"\n";
+        std::cout << "    balanced <= equal ? "<<std::boolalpha<<(balanced <= equal)<<"\n";
+        bool monotone = true, covers = (offsets[0]==0 && offsets[size]==num_blocks);
+        for( int p=0; p<size; p++)
+            if( offsets[p] > offsets[p+1])
+                monotone = false;
+        std::cout << "    offsets monotone and covering ? "<<(monotone&&covers)<<"\n";
+    }
+    //// Test measurement and repartitioning: burn time proportional to the
+    //// synthetic weights, then check that the measured partition agrees
+    dg::LoadBalance balance( num_blocks, MPI_COMM_WORLD);
+    for( unsigned b=balance.begin(); b<balance.end(); b++)
+    {
+        balance.tic( b);
+        double sum = 0;
+        for( unsigned k=0; k<(unsigned)(weights[b]*2e6); k++)
+            sum += 1./(double)(k+1);
+        if( sum < 0) std::cout << sum; //prevent optimization
+        balance.toc( b);
+    }
+    double imbalance = balance.imbalance();
+    std::vector<unsigned> measured = dg::balanced_partition( weights, size);
+    std::vector<unsigned> repart = balance.repartition();
+    unsigned diff = 0;
+    for( int p=0; p<=size; p++)
+        diff = std::max( diff, (unsigned)std::abs( (int)repart[p]-(int)measured[p]));
+    if(rank==0)
+    {
+        std::cout << "Measured imbalance of the equal split (expect > 1): "<<imbalance<<"\n";
+        std::cout << "Max offset deviation measured vs exact (expect small, subject to timing noise): "<<diff<<"\n";
+    }
+    balance.set_offsets( repart);
+    double reset = balance.imbalance();
+    if(rank==0)std::cout << "Imbalance after reset (expect 1): "<<reset<<"\n";
+
+    MPI_Finalize();
+    return 0;
+}
@@ -28,6 +28,8 @@ namespace create{
  * @param dir The direction of the first derivative
  *
  * @return A host matrix
+ * @note On the GPU the x-derivative profits from a sliced (SELL-C) storage
+ * layout; convert through <tt> dg::EllSparseBlockMatDevice<real_type>( dg::create::dx(g), true) </tt>
  */
 template<class real_type>
 EllSparseBlockMat<real_type> dx( const aRealTopology2d<real_type>& g, bc bcx, direction dir = centered)
@@ -100,6 +100,59 @@ int main(int argc, char* argv[])
                 thrust::logical_or<bool>(), dg::ISNFINITE<double>());
         if(rank==0)std::cout << "Symv contains NaN: "<<std::boolalpha<<hasnan<<" (false)\n";
     }
+    if(rank==0)std::cout << "TEST batched group halo exchange\n";
+    {
+        Vector in[3] = { f2d, dx2d, dy2d};
+        Vector single[3] = { null2, null2, null2}, batched[3] = { null2, null2, null2};
+        std::vector<const Vector*> xs = {&in[0], &in[1], &in[2]};
+        std::vector<Vector*> ys = {&batched[0], &batched[1], &batched[2]};
+        Matrix ms[2] = {dx2, dy2}; //one communicating, one trivial direction
+        for( unsigned m=0; m<2; m++)
+        {
+            ms[m].symv( 1., xs, 0., ys);
+            double err = 0.;
+            for( unsigned k=0; k<3; k++)
+            {
+                dg::blas2::symv( 1., ms[m], in[k], 0., single[k]);
+                dg::blas1::axpby( 1., single[k], -1., batched[k]);
+                err += dg::blas2::dot( batched[k], w2d, batched[k]);
+            }
+            if(rank==0)std::cout << "Batched symv difference: "<<sqrt(err)<<" (Must be zero)\n";
+        }
+    }
+    if(rank==0)std::cout << "TEST compressed halo exchange\n";
+    Vector dfd( f2d), dfc( f2d);
+    dg::blas2::symv( m2[0], f2d, dfd);
+    dg::mpi_halo_compression() = true;
+    dg::blas2::symv( m2[0], f2d, dfc);
+    dg::mpi_halo_compression() = false;
+    dg::blas1::axpby( 1., dfd, -1., dfc);
+    double cerr = sqrt(dg::blas2::dot( dfc, w2d, dfc)/dg::blas2::dot( dfd, w2d, dfd));
+    if(rank==0)std::cout << "Compression error: "<<cerr<<" (Must be smaller than 1e-6)\n";
+    if(rank==0)std::cout << "TEST shared memory halo exchange\n";
+    {
+        //the window path moves the same bytes as the messages, so the
+        //results must agree to the last bit
+        Vector dfm[2] = { f2d, f2d};
+        dg::blas2::symv( m2[0], f2d, dfm[0]);
+        dg::blas2::symv( m2[1], f2d, dfm[1]);
+        dg::mpi_shared_halo() = true;
+        double serr = 0.;
+        for( unsigned i=0; i<4; i++) //repeat to exercise the double buffering
+        {
+            Vector dfs( f2d);
+            dg::blas2::symv( m2[i%2], f2d, dfs);
+            dg::blas1::axpby( 1., dfm[i%2], -1., dfs);
+            serr += sqrt( dg::blas2::dot( dfs, w2d, dfs));
+        }
+        dg::mpi_shared_halo() = false;
+        Vector dfs( f2d);
+        dg::blas2::symv( m2[0], f2d, dfs); //back on the message path
+        dg::blas1::axpby( 1., dfm[0], -1., dfs);
+        serr += sqrt( dg::blas2::dot( dfs, w2d, dfs));
+        if(rank==0)std::cout << "Shared halo difference to message path: "
+                             <<serr<<" (Must be zero)\n";
+    }
     if(rank==0)std::cout << "\nFINISHED! Continue with arakawa_mpit.cu !\n\n";
 
 
@@ -76,6 +76,25 @@ int main()
         value_t norm = sqrt(dg::blas2::dot( error, w3d, error)); res.d = norm;
         std::cout << "Distance to true solution: "<<norm<<"\t"<<res.i-binary3[i]<<"\n";
     }
+    std::cout << "TEST fused symv_axpby of DX\n";
+    {
+        // z = -dx f + cosx must equal the error of the symv test above
+        Vector z( f3d);
+        dg::blas2::symv_axpby( -1., dx3, f3d, 1., dx3d, z);
+        Vector error = dx3d;
+        dg::blas2::symv( -1., dx3, f3d, 1., error);
+        dg::blas1::axpby( 1., z, -1., error);
+        value_t norm = sqrt(dg::blas2::dot( error, w3d, error));
+        std::cout << "Distance to unfused result (0): "<<norm<<"\n";
+    }
+    std::cout << "TEST sliced (SELL-C) layout of DX\n";
+    {
+        Matrix dxs( dg::create::dx( g3d, dg::forward), true);
+        Vector error = dx3d;
+        dg::blas2::symv( -1., dxs, f3d, 1., error);
+        value_t norm = sqrt(dg::blas2::dot( error, w3d, error)); res.d = norm;
+        std::cout << "Distance to true solution: "<<norm<<"\t"<<res.i-binary3[0]<<"\n";
+    }
     std::cout << "TEST if symv captures NaN\n";
     for( unsigned i=0; i<6; i++)
     {
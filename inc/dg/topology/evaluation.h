@@ -3,7 +3,10 @@
 #include <cassert>
 #include <cmath>
 #include <thrust/host_vector.h>
+#include <thrust/device_vector.h>
 #include "dg/backend/config.h"
+#include "../blas1.h"
+#include "functions.h"
 #include "grid.h"
 #include "operator.h"
 
@@ -167,6 +170,60 @@ thrust::host_vector<real_type> evaluate( real_type(f)(real_type, real_type, real
     return evaluate<real_type(real_type, real_type, real_type)>( *f, g);
 };
 ///@endcond
+
+/**
+ * @brief Evaluate a 2d function on grid coordinates on the device
+ *
+ * Same as \c dg::evaluate but the functor is applied to all grid points in
+ * parallel on the device, which makes the evaluation bandwidth-bound instead
+ * of single-core-bound.  Worthwhile for expensive functors at production
+ * resolutions, in particular when the evaluation is repeated on every grid of
+ * a multigrid hierarchy.
+ * @copydoc hide_binary
+ * @param f The function to evaluate: \f$ f = f(x,y)\f$; must be callable on
+ * the device, i.e. its \c operator() must be marked \c DG_DEVICE and all its
+ * members must be trivially copyable (no \c std::function or heap allocated
+ * members)
+ * @param g The 2d grid on which to evaluate \c f
+ *
+ * @return The output vector \c v as a device vector
+ * @sa \c dg::evaluate
+ */
+template< class BinaryOp, class real_type>
+thrust::device_vector<real_type> gpu_evaluate( const BinaryOp& f, const aRealTopology2d<real_type>& g)
+{
+    thrust::device_vector<real_type> x( evaluate( cooX2d, g));
+    thrust::device_vector<real_type> y( evaluate( cooY2d, g));
+    thrust::device_vector<real_type> v( g.size());
+    dg::blas1::evaluate( v, dg::equals(), f, x, y);
+    return v;
+};
+
+/**
+ * @brief Evaluate a 3d function on grid coordinates on the device
+ *
+ * Same as \c dg::evaluate but the functor is applied to all grid points in
+ * parallel on the device
+ * @copydoc hide_ternary
+ * @param f The function to evaluate: \f$ f = f(x,y,z)\f$; must be callable on
+ * the device, i.e. its \c operator() must be marked \c DG_DEVICE and all its
+ * members must be trivially copyable (no \c std::function or heap allocated
+ * members)
+ * @param g The 3d grid on which to evaluate \c f
+ *
+ * @return The output vector \c v as a device vector
+ * @sa \c dg::evaluate
+ */
+template< class TernaryOp, class real_type>
+thrust::device_vector<real_type> gpu_evaluate( const TernaryOp& f, const aRealTopology3d<real_type>& g)
+{
+    thrust::device_vector<real_type> x( evaluate( cooX3d, g));
+    thrust::device_vector<real_type> y( evaluate( cooY3d, g));
+    thrust::device_vector<real_type> z( evaluate( cooZ3d, g));
+    thrust::device_vector<real_type> v( g.size());
+    dg::blas1::evaluate( v, dg::equals(), f, x, y, z);
+    return v;
+};
 /////////////////////////////////////INTEGRATE/////////////////
 
 /*!@brief Indefinite integral of a function on a grid
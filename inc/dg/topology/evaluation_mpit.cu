@@ -80,6 +80,12 @@ int main(int argc, char** argv)
     double solution3d = (exp(4.)-exp(2))/2.*(exp(8.)-exp(6.))/2.*(exp(12.)-exp(10))/2.;
     if(rank==0)std::cout << "Correct square norm is    "<<std::setw(6)<<solution3d<<std::endl;
     if(rank==0)std::cout << "Relative 3d error is      "<<(norm3d-solution3d)/solution3d<<"\n";
+    if(rank==0)std::cout << "TEST asynchronous dot (must be binary equal to dot):\n";
+    auto future = dg::blas1::dot_async( w3d, func3d);
+    double norm3da = dg::blas2::dot( func3d, w3d, func3d); //overlaps with the reduction
+    res.d = future.get();
+    if(rank==0)std::cout << "Async 3D integral         "<<std::setw(6)<<res.d <<"\t" << res.i - 4675882723962622631<< "\n";
+    if(rank==0)std::cout << "Repeated get              "<<std::setw(6)<<future.get()<<"\t"<<(norm3da==norm3d)<<"\n\n";
     if(rank==0)std::cout << "TEST if dot throws on Inf or Nan:\n";
     dg::MDVec x = dg::evaluate( dg::CONSTANT( 6.12610567450009658), g2d);
     dg::blas1::transform( x, x, []DG_DEVICE(double x){ return sin(x);} );
@@ -8,6 +8,7 @@
 #include "grid.h"
 #include "interpolation.h"
 #include "projection.h"
+#include "plan_cache.h"
 #ifdef MPI_VERSION
 #include "mpi_grid.h"
 #endif //MPI_VERSION
@@ -21,11 +22,29 @@
 namespace dg
 {
 
+///@cond
+namespace detail
+{
+//Does the matrix type provide the batched group symv that exchanges the
+//halos of several vectors in a single message per neighbor?
+template<class Matrix>
+struct has_group_symv : std::false_type{};
+#ifdef MPI_VERSION
+template<class LI, class LO, class C>
+struct has_group_symv<RowColDistMat<LI, LO, C>> : std::true_type{};
+#endif
+}//namespace detail
+///@endcond
+
 /**
  * @brief Struct that applies given matrices one after the other
  *
  * \f[ y = M_{N-1}(...M_1(M_0x))\f]
  * where \f$ M_i\f$ is the i-th matrix
+ * @note If exactly two block matrices are stored (the x- and y-stage of the
+ * 2d fast_interpolation and fast_projection for example) the composite is
+ * applied in a single fused kernel so the intermediate vector never touches
+ * global memory
  * @sa mainly used by dg::create::fast_interpolation and dg::ModalFilter
  * @copydoc hide_matrix
  * @copydoc hide_ContainerType
@@ -72,18 +91,131 @@ struct MultiMatrix
             dg::blas2::symv( alpha, inter_[0], x, beta, y);
             return;
         }
+        //two block matrices can be fused into a single pass without the
+        //intermediate vector (e.g. the x- and y-stage of fast_projection)
+        if( dims == 2 && fused_symv( alpha, x, beta, y,
+            std::integral_constant<bool,
+            detail::is_ell_matrix<MatrixType>::value
+            && std::is_base_of<SharedVectorTag,
+                get_tensor_category<ContainerType0>>::value
+            && std::is_base_of<SharedVectorTag,
+                get_tensor_category<ContainerType1>>::value>()))
+            return;
         dg::blas2::symv( inter_[0], x,temp_[0].data());
         for( int i=1; i<dims-1; i++)
             dg::blas2::symv( inter_[i], temp_[i-1].data(), temp_[i].data());
         dg::blas2::symv( alpha, inter_[dims-1], temp_[dims-2].data(), beta, y);
     }
+    /**
+    * @brief Batched application to a group of vectors
+    *
+    * Computes \f$ y_k = \alpha M x_k + \beta y_k\f$ for all vectors of the
+    * group in one pass per stage. If the stored matrices are MPI distributed
+    * the halos of all vectors are exchanged in a single batched message per
+    * neighbor and stage (cf. the batched \c RowColDistMat::symv), otherwise
+    * the group is applied back to back such that the matrix stays cached
+    * between fields. For example to transfer several fields between
+    * multigrid stages at once
+    * @param alpha scalar
+    * @param x pointers to the input vectors
+    * @param beta scalar
+    * @param y pointers to the output vectors (size must equal \c x.size())
+    */
+    template<class ContainerType0, class ContainerType1>
+    void symv( real_type alpha, const std::vector<const ContainerType0*>& x,
+        real_type beta, std::vector<ContainerType1*>& y) const
+    {
+        assert( x.size() == y.size());
+        group_symv( alpha, x, beta, y,
+            typename detail::has_group_symv<MatrixType>::type());
+    }
     std::vector<Buffer<ContainerType> >& get_temp(){ return temp_;}
     const std::vector<Buffer<ContainerType> >& get_temp()const{ return temp_;}
     std::vector<MatrixType>& get_matrices(){ return inter_;}
     const std::vector<MatrixType>& get_matrices()const{ return inter_;}
     private:
+    template<class ContainerType0, class ContainerType1>
+    bool fused_symv( real_type alpha, const ContainerType0& x, real_type beta,
+        ContainerType1& y, std::true_type) const
+    {
+        if( -1 == fused_)
+        {
+            const MatrixType& right = inter_[0], &left = inter_[1];
+            fused_ = ( right.right_range[0] == 0
+                    && right.right_range[1] == right.right_size
+                    && left.right_range[0] == 0
+                    && left.right_range[1] == left.right_size);
+        }
+        if( !fused_)
+            return false;
+        detail::KroneckerEllView<real_type> product{
+            detail::make_ell_view( inter_[1]),
+            detail::make_ell_view( inter_[0])};
+        dg::blas2::parallel_for( [product, alpha, beta]DG_DEVICE(
+            unsigned i, const real_type* xx, real_type* yy)
+            {
+                if( 0 == beta)
+                    yy[i] = alpha*product( xx, i);
+                else
+                    yy[i] = DG_FMA( alpha, product( xx, i), beta*yy[i]);
+            }, y.size(), x, y);
+        return true;
+    }
+    template<class ContainerType0, class ContainerType1>
+    bool fused_symv( real_type, const ContainerType0&, real_type,
+        ContainerType1&, std::false_type) const
+    {
+        return false;
+    }
+    //shared memory matrices: apply per field (the two-stage fused kernel
+    //kicks in per field and the matrix stays cached between fields)
+    template<class ContainerType0, class ContainerType1>
+    void group_symv( real_type alpha, const std::vector<const ContainerType0*>& x,
+        real_type beta, std::vector<ContainerType1*>& y, std::false_type) const
+    {
+        for( unsigned k=0; k<x.size(); k++)
+            symv( alpha, *x[k], beta, *y[k]);
+    }
+    //MPI matrices: batch the halo exchange of the whole group per stage
+    template<class ContainerType0, class ContainerType1>
+    void group_symv( real_type alpha, const std::vector<const ContainerType0*>& x,
+        real_type beta, std::vector<ContainerType1*>& y, std::true_type) const
+    {
+        unsigned num = x.size();
+        int dims = inter_.size();
+        if( dims == 1)
+        {
+            inter_[0].symv( alpha, x, beta, y);
+            return;
+        }
+        //the group needs its own intermediate vectors (lazily sized)
+        if( m_group_temp.size() < (unsigned)(dims-1))
+            m_group_temp.resize( dims-1);
+        for( int i=0; i<dims-1; i++)
+            while( m_group_temp[i].size() < num)
+                m_group_temp[i].push_back( temp_[i]);
+        std::vector<const ContainerType*> in( num);
+        std::vector<ContainerType*> out( num);
+        for( unsigned k=0; k<num; k++)
+            out[k] = &m_group_temp[0][k].data();
+        inter_[0].symv( 1., x, 0., out);
+        for( int i=1; i<dims-1; i++)
+        {
+            for( unsigned k=0; k<num; k++)
+            {
+                in[k] = &m_group_temp[i-1][k].data();
+                out[k] = &m_group_temp[i][k].data();
+            }
+            inter_[i].symv( 1., in, 0., out);
+        }
+        for( unsigned k=0; k<num; k++)
+            in[k] = &m_group_temp[dims-2][k].data();
+        inter_[dims-1].symv( alpha, in, beta, y);
+    }
     std::vector<MatrixType > inter_;
     std::vector<Buffer<ContainerType> > temp_;
+    mutable std::vector<std::vector<Buffer<ContainerType>>> m_group_temp;
+    mutable int fused_ = -1; //-1: unknown, detected on first two-stage apply
 };
 
 ///@cond
@@ -479,6 +611,134 @@ auto fast_transform( dg::Operator<typename Topology::value_type> opx, dg::Operat
     auto interY = dg::create::fast_transform( dg::coo3d::y, opy, t);
     return dg::detail::multiply( interY, interX);
 }
+
+/*!
+ * @brief Create the visualization backscatter transform in fast block format
+ *
+ * The result applies the same transformation as the \c
+ * dg::create::backscatter matrix ( dG coefficients to function values on
+ * equidistant plot points) but is assembled from the per-cell block
+ * transforms of \c fast_transform, which apply as batched small dense blocks
+ * instead of a general sparse matrix and are thus much cheaper to apply,
+ * especially on GPUs where visualization or frequent 2d output would
+ * otherwise perturb the step timing.
+ * On a 3d grid every x-y plane is transformed separately ( the z direction
+ * carries a single polynomial coefficient for which the equidistant
+ * transform is the identity).
+ * @tparam Topology any shared or MPI 2d or 3d grid
+ * @param t The grid
+ * @return a \c dg::MultiMatrix of an x- and a y- block transform
+ * @sa dg::create::backscatter
+ */
+template<class Topology>
+auto fast_backscatter( const Topology& t)
+{
+    using real_type = typename Topology::value_type;
+    dg::DLT<real_type> dltx( t.nx()), dlty( t.ny());
+    dg::Operator<real_type> opx = dg::Operator<real_type>( dltx.backwardEQ())
+                                * dg::Operator<real_type>( dltx.forward());
+    dg::Operator<real_type> opy = dg::Operator<real_type>( dlty.backwardEQ())
+                                * dg::Operator<real_type>( dlty.forward());
+    return fast_transform( opx, opy, t);
+}
+
+/**
+ * @brief Create a fast transfer matrix between grids of rational size ratio
+ *
+ * The integer creators \c fast_interpolation and \c fast_projection only
+ * cover grids whose cell numbers and polynomial coefficients are integer
+ * multiples of each other. For a rational ratio \c N_new/N_old=p/q (in lowest
+ * terms) this function composes an interpolation to the least common
+ * refinement of both grids (multiply by \c p) with a projection down to the
+ * new grid (divide by \c q) in a \c dg::MultiMatrix, so the apply path stays
+ * a few \c dg::EllSparseBlockMat kernels without communication.
+ * The same decomposition is applied to the polynomial coefficients.
+ * @note Since the old grid is a subspace of the common refinement the result
+ * is the exact \f$ L^2\f$ projection from the old onto the new grid; if the
+ * new grid is finer and nests with the old one it reduces to interpolation
+ * @tparam real_type a floating point type
+ * @return a matrix that when applied to vectors on the old grid produces a vector on the new grid
+ * @param t_old The existing grid
+ * @param t_new The new grid, must have the same boundaries as \c t_old
+ */
+template<class real_type>
+MultiMatrix< dg::HMatrix_t<real_type>, dg::HVec_t<real_type> > fast_transfer( const RealGrid1d<real_type>& t_old, const RealGrid1d<real_type>& t_new)
+{
+    if( t_old.x0() != t_new.x0() || t_old.x1() != t_new.x1())
+        throw Error( Message(_ping_)<< "old and new grid must have the same boundaries!");
+    unsigned gN = dg::gcd( t_old.N(), t_new.N()), gn = dg::gcd( t_old.n(), t_new.n());
+    unsigned mN = t_new.N()/gN, dN = t_old.N()/gN;
+    unsigned mn = t_new.n()/gn, dn = t_old.n()/gn;
+    if( dN == 1 && dn == 1)
+    {
+        MultiMatrix< dg::HMatrix_t<real_type>, dg::HVec_t<real_type> > trafo(1);
+        trafo.get_matrices()[0] = fast_interpolation( t_old, mn, mN);
+        return trafo;
+    }
+    if( mN == 1 && mn == 1)
+    {
+        MultiMatrix< dg::HMatrix_t<real_type>, dg::HVec_t<real_type> > trafo(1);
+        trafo.get_matrices()[0] = fast_projection( t_old, dn, dN);
+        return trafo;
+    }
+    dg::RealGrid1d<real_type> t_mid( t_old.x0(), t_old.x1(), t_old.n()*mn, t_old.N()*mN, t_old.bcx());
+    return dg::detail::multiply( fast_projection( t_mid, dn, dN),
+                                 fast_interpolation( t_old, mn, mN));
+}
+
+///@copydoc fast_transfer(const RealGrid1d<real_type>&,const RealGrid1d<real_type>&)
+template<class real_type>
+MultiMatrix< dg::HMatrix_t<real_type>, dg::HVec_t<real_type> > fast_transfer( const aRealTopology2d<real_type>& t_old, const aRealTopology2d<real_type>& t_new)
+{
+    if( t_old.x0() != t_new.x0() || t_old.x1() != t_new.x1() ||
+        t_old.y0() != t_new.y0() || t_old.y1() != t_new.y1())
+        throw Error( Message(_ping_)<< "old and new grid must have the same boundaries!");
+    unsigned gNx = dg::gcd( t_old.Nx(), t_new.Nx()), gnx = dg::gcd( t_old.nx(), t_new.nx());
+    unsigned mNx = t_new.Nx()/gNx, dNx = t_old.Nx()/gNx;
+    unsigned mnx = t_new.nx()/gnx, dnx = t_old.nx()/gnx;
+    unsigned gNy = dg::gcd( t_old.Ny(), t_new.Ny()), gny = dg::gcd( t_old.ny(), t_new.ny());
+    unsigned mNy = t_new.Ny()/gNy, dNy = t_old.Ny()/gNy;
+    unsigned mny = t_new.ny()/gny, dny = t_old.ny()/gny;
+    //intermediate grids of the four-stage pipeline (x first, then y)
+    dg::RealGrid1d<real_type> gxMid( t_old.x0(), t_old.x1(), t_old.nx()*mnx, t_old.Nx()*mNx, t_old.bcx());
+    dg::RealGrid1d<real_type> gyMid( t_old.y0(), t_old.y1(), t_old.ny()*mny, t_old.Ny()*mNy, t_old.bcy());
+    dg::RealGrid2d<real_type> gA( gxMid, t_old.gy());
+    dg::RealGrid2d<real_type> gB( t_new.gx(), t_old.gy());
+    dg::RealGrid2d<real_type> gC( t_new.gx(), gyMid);
+    std::vector<dg::HMatrix_t<real_type>> stages;
+    std::vector<unsigned> sizes; //output size of each stage
+    if( mNx > 1 || mnx > 1)
+    {
+        stages.push_back( fast_interpolation( dg::coo3d::x, t_old, mnx, mNx));
+        sizes.push_back( gA.size());
+    }
+    if( dNx > 1 || dnx > 1)
+    {
+        stages.push_back( fast_projection( dg::coo3d::x, gA, dnx, dNx));
+        sizes.push_back( gB.size());
+    }
+    if( mNy > 1 || mny > 1)
+    {
+        stages.push_back( fast_interpolation( dg::coo3d::y, gB, mny, mNy));
+        sizes.push_back( gC.size());
+    }
+    if( dNy > 1 || dny > 1)
+    {
+        stages.push_back( fast_projection( dg::coo3d::y, gC, dny, dNy));
+        sizes.push_back( t_new.size());
+    }
+    if( stages.empty()) //identical grids
+    {
+        stages.push_back( fast_interpolation( dg::coo3d::x, t_old, 1, 1));
+        sizes.push_back( t_old.size());
+    }
+    MultiMatrix< dg::HMatrix_t<real_type>, dg::HVec_t<real_type> > trafo( stages.size());
+    for( unsigned i=0; i<stages.size(); i++)
+        trafo.get_matrices()[i] = stages[i];
+    for( unsigned i=0; i+1<stages.size(); i++)
+        trafo.get_temp()[i] = Buffer<dg::HVec_t<real_type>>( dg::HVec_t<real_type>( sizes[i]));
+    return trafo;
+}
 ///@}
 
 }//namespace create
@@ -497,8 +757,14 @@ template<class real_type>
 thrust::host_vector<real_type> forward_transform( const thrust::host_vector<real_type>& in, const aRealTopology2d<real_type>& g)
 {
     thrust::host_vector<real_type> out(in.size(), 0);
-    auto forward = create::fast_transform( g.dltx().forward(),
-            g.dlty().forward(), g);
+    //diagnostics transform many same-shape records: keep the plan cached
+    using Matrix = MultiMatrix< dg::HMatrix_t<real_type>, dg::HVec_t<real_type>>;
+    const auto& forward = create::cached_plan<Matrix>(
+        "forward_transform:"+create::grid_signature( g), [&]()
+        {
+            return create::fast_transform( g.dltx().forward(),
+                g.dlty().forward(), g);
+        });
     dg::blas2::symv( forward, in, out);
     return out;
 }
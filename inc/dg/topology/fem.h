@@ -85,9 +85,38 @@ struct TriDiagonal
     Container M, O, P;
 };
 
+///@cond
+namespace detail
+{
+//Precompute the Thomas factorization of a tridiagonal matrix: ci are the
+//modified superdiagonal coefficients, inv the reciprocals of the forward
+//sweep denominators. Both depend only on the matrix and can be reused
+//across solves, which removes all divisions from the application
+template<class value_type>
+void thomas_factorize( const thrust::host_vector<value_type>& M,
+    const thrust::host_vector<value_type>& O,
+    const thrust::host_vector<value_type>& P,
+    thrust::host_vector<value_type>& ci,
+    thrust::host_vector<value_type>& inv)
+{
+    unsigned size = O.size();
+    ci.resize( size), inv.resize( size);
+    ci[0] = P[0]/O[0];
+    inv[0] = 1./O[0];
+    for( unsigned i=1; i<size; i++)
+    {
+        inv[i] = 1./( O[i] - M[i]*ci[i-1]);
+        ci[i] = P[i]*inv[i];
+    }
+}
+}//namespace detail
+///@endcond
+
 /*!@brief Fast inverse tridiagonal sparse matrix
  *
- * When applied to a vector, uses Thomas algorithm to compute \f$ T^{-1} v\f$
+ * When applied to a vector, uses Thomas algorithm to compute \f$ T^{-1} v\f$.
+ * The factorization (which involves all divisions) is precomputed in the
+ * constructor so that only the two sweeps remain per application
  * @attention Only for shared memory host vectors
  */
 template<class value_type>
@@ -97,28 +126,21 @@ struct InverseTriDiagonal
     InverseTriDiagonal( const TriDiagonal<thrust::host_vector<value_type>>& tri)
     {
         dg::assign( tri.M, this->M);
-        dg::assign( tri.O, this->O);
-        dg::assign( tri.P, this->P);
+        detail::thomas_factorize( tri.M, tri.O, tri.P, this->ci, this->inv);
     }
 
     void operator()( const thrust::host_vector<value_type>& y, thrust::host_vector<value_type>& x) const
     {
         unsigned size = M.size();
-        thrust::host_vector<value_type> ci(size), di(size);
         x.resize(size);
-        ci[0] = P[0]/O[0];
-        di[0] = y[0]/O[0];
+        x[0] = y[0]*inv[0];
         for( unsigned i=1; i<size; i++)
-        {
-            ci[i] = P[i]/ ( O[i] -M[i]*ci[i-1]);
-            di[i] = (y[i]-M[i]*di[i-1])/(O[i] -M[i]*ci[i-1]);
-        }
-        x[size-1] = di[size-1];
+            x[i] = (y[i]-M[i]*x[i-1])*inv[i];
         for( int i=size-2; i>=0; i--)
-            x[i] = di[i] - ci[i]*x[i+1];
+            x[i] = x[i] - ci[i]*x[i+1];
     }
     private:
-    thrust::host_vector<value_type> M, O, P;
+    thrust::host_vector<value_type> M, ci, inv;
 };
 
 /*!@brief Fast tridiagonal sparse matrix in 2d \f$ T_y\otimes T_x\f$
@@ -245,8 +267,10 @@ struct KroneckerTriDiagonal2d
 /*!@brief Fast inverse tridiagonal sparse matrix in 2d \f$ T_y^{-1}\otimes T_x^{-1}\f$
  *
  * When applied to a vector, uses Thomas algorithm to compute \f$ T^{-1} v\f$ first
- * row-wise in x and then column-wise in y
- * @attention Only for shared memory vectors (works for GPUs but is not fast)
+ * row-wise in x and then column-wise in y. The Thomas factorization of both
+ * directions is precomputed in the constructor so each application consists
+ * of division-free sweeps that run in place without scratch arrays
+ * @attention Only for shared memory vectors
  */
 template<class Container>
 struct InverseKroneckerTriDiagonal2d
@@ -256,19 +280,13 @@ struct InverseKroneckerTriDiagonal2d
     InverseKroneckerTriDiagonal2d( const KroneckerTriDiagonal2d<Container>& tri)
     {
         m_t = tri;
-        unsigned size = m_t.x().size()*m_t.y().size()*m_t.nz();
-        m_ci.resize( size);
-        m_di.resize( size);
-        m_tmp.resize( size);
+        factorize();
     }
     template<class Container2>
     InverseKroneckerTriDiagonal2d( const InverseKroneckerTriDiagonal2d<Container2>& inv_tri)
     {
         m_t = inv_tri.tri();
-        unsigned size = m_t.x().size()*m_t.y().size()*m_t.nz();
-        m_ci.resize( size);
-        m_di.resize( size);
-        m_tmp.resize( size);
+        factorize();
     }
     const KroneckerTriDiagonal2d<Container>& tri() const {return m_t;}
     template<class ContainerType0, class ContainerType1>
@@ -276,53 +294,49 @@ struct InverseKroneckerTriDiagonal2d
     {
         unsigned Nx = m_t.x().size(), Ny = m_t.y().size();
         // solve in two passes, first x then y
-        dg::blas2::parallel_for( [ this, Nx] DG_DEVICE(
+        dg::blas2::parallel_for( [ Nx] DG_DEVICE(
                     unsigned k,
                     const value_type* M,
-                    const value_type* O,
-                    const value_type* P,
-                    value_type* ci,
-                    value_type* di,
+                    const value_type* ci,
+                    const value_type* inv,
                     const value_type* y, value_type* x){
-            ci[k*Nx + 0] = P[0]/O[0];
-            di[k*Nx + 0] = y[k*Nx + 0]/O[0];
+            x[k*Nx + 0] = y[k*Nx + 0]*inv[0];
             for( unsigned i=1; i<Nx; i++)
-            {
-                ci[k*Nx+i] = P[i]/ ( O[i] -M[i]*ci[k*Nx+i-1]);
-                di[k*Nx+i] = (y[k*Nx+i]-M[i]*di[k*Nx+i-1])/(O[i] -M[i]*ci[k*Nx+i-1]);
-            }
-            x[k*Nx + Nx-1] = di[k*Nx + Nx-1];
+                x[k*Nx+i] = (y[k*Nx+i]-M[i]*x[k*Nx+i-1])*inv[i];
             for( int i=Nx-2; i>=0; i--)
-                x[k*Nx+i] = di[k*Nx+i] - ci[k*Nx+i]*x[k*Nx +i+1];
+                x[k*Nx+i] = x[k*Nx+i] - ci[i]*x[k*Nx +i+1];
 
-        }, m_t.y().size()*m_t.nz(), m_t.x().M, m_t.x().O, m_t.x().P, m_ci, m_di, y, m_tmp);
+        }, m_t.y().size()*m_t.nz(), m_t.x().M, m_xci, m_xinv, y, m_tmp);
 
-        dg::blas2::parallel_for( [ this, Nx, Ny] DG_DEVICE(
+        dg::blas2::parallel_for( [ Nx, Ny] DG_DEVICE(
                     unsigned l,
                     const value_type* M,
-                    const value_type* O,
-                    const value_type* P,
-                    value_type* ci,
-                    value_type* di,
+                    const value_type* ci,
+                    const value_type* inv,
                     const value_type* y, value_type* x){
             unsigned i = l%Nx, j = l/Nx;
-            ci[(j*Ny+0)*Nx + i] = P[0]/O[0];
-            di[(j*Ny+0)*Nx + i] = y[(j*Ny+0)*Nx + i]/O[0];
+            x[(j*Ny+0)*Nx + i] = y[(j*Ny+0)*Nx + i]*inv[0];
             for( unsigned k=1; k<Ny; k++)
-            {
-                ci[(j*Ny+k)*Nx+i] = P[k]/ ( O[k] -M[k]*ci[(j*Ny+k-1)*Nx+i]);
-                di[(j*Ny+k)*Nx+i] = (y[(j*Ny+k)*Nx+i]-M[k]*di[(j*Ny+k-1)*Nx+i])/(O[k] -M[k]*ci[(j*Ny+k-1)*Nx+i]);
-            }
-            x[(j*Ny+Ny-1)*Nx + i] = di[(j*Ny+Ny-1)*Nx + i];
+                x[(j*Ny+k)*Nx+i] = (y[(j*Ny+k)*Nx+i]-M[k]*x[(j*Ny+k-1)*Nx+i])*inv[k];
             for( int k=Ny-2; k>=0; k--)
-                x[(j*Ny+k)*Nx+i] = di[(j*Ny+k)*Nx+i] - ci[(j*Ny+k)*Nx+i]*x[(j*Ny+k+1)*Nx +i];
+                x[(j*Ny+k)*Nx+i] = x[(j*Ny+k)*Nx+i] - ci[k]*x[(j*Ny+k+1)*Nx +i];
 
-        }, m_t.x().size()*m_t.nz(), m_t.y().M, m_t.y().O, m_t.y().P, m_ci, m_di,m_tmp, x);
+        }, m_t.x().size()*m_t.nz(), m_t.y().M, m_yci, m_yinv, m_tmp, x);
     }
 
     private:
+    void factorize()
+    {
+        dg::TriDiagonal<thrust::host_vector<value_type>> hx( m_t.x()), hy( m_t.y());
+        thrust::host_vector<value_type> ci, inv;
+        detail::thomas_factorize( hx.M, hx.O, hx.P, ci, inv);
+        dg::assign( ci, m_xci), dg::assign( inv, m_xinv);
+        detail::thomas_factorize( hy.M, hy.O, hy.P, ci, inv);
+        dg::assign( ci, m_yci), dg::assign( inv, m_yinv);
+        m_tmp.resize( m_t.x().size()*m_t.y().size()*m_t.nz());
+    }
     KroneckerTriDiagonal2d<Container> m_t;
-    Container m_ci, m_di, m_tmp;
+    Container m_xci, m_xinv, m_yci, m_yinv, m_tmp;
 
 };
 ///@}
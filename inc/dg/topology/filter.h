@@ -264,6 +264,163 @@ struct CSRSymvFilter
     }
 };
 
+/**
+ * @brief Apply a 2d modal filter cell by cell in a single pass
+ *
+ * This filter applies the per-cell matrices \f$ V D V^{-1}\f$ created by
+ * \c dg::create::modal_filter in both the x and the y direction of each dG
+ * cell in one kernel, i.e. forward transformation, damping and backward
+ * transformation happen in registers without intermediate global memory
+ * traffic. The result equals \c dg::blas2::symv applied with the
+ * corresponding \c dg::create::fast_transform matrix but needs only a single
+ * sweep over the vector.
+ * Must be applied in combination with \c dg::create::filter_stencil
+ * @sa dg::blas2::stencil dg::create::filter_stencil dg::create::modal_filter
+ */
+template<class real_type>
+struct CSRModalFilter
+{
+    ///The maximum number of polynomial coefficients per dimension
+    static const unsigned max_size = 10;
+    CSRModalFilter() : m_nx(0), m_ny(0) {}
+    /**
+     * @brief Construct from per-cell filter blocks
+     *
+     * @param fx filter matrix acting in x (e.g. from \c dg::create::modal_filter), its size must not exceed \c max_size
+     * @param fy filter matrix acting in y, its size must not exceed \c max_size
+     */
+    CSRModalFilter( const dg::Operator<real_type>& fx,
+            const dg::Operator<real_type>& fy) :
+        m_nx( fx.size()), m_ny( fy.size())
+    {
+        assert( m_nx <= max_size && "fx size exceeds max_size in CSRModalFilter");
+        assert( m_ny <= max_size && "fy size exceeds max_size in CSRModalFilter");
+        for( unsigned i=0; i<m_nx; i++)
+            for( unsigned j=0; j<m_nx; j++)
+                m_fx[i*m_nx+j] = fx(i,j);
+        for( unsigned i=0; i<m_ny; i++)
+            for( unsigned j=0; j<m_ny; j++)
+                m_fy[i*m_ny+j] = fy(i,j);
+    }
+    DG_DEVICE
+    void operator()( unsigned i, const int* row_offsets,
+            const int* column_indices, const real_type* values,
+            const real_type* x, real_type* y)
+    {
+        int k = row_offsets[i];
+        if( row_offsets[i+1] == k) //only the first point in each cell does something
+            return;
+        real_type u[max_size*max_size], w[max_size*max_size];
+        for( unsigned j=0; j<m_ny*m_nx; j++)
+            u[j] = x[column_indices[k+j]];
+        // filter in x
+        for( unsigned j=0; j<m_ny; j++)
+            for( unsigned l=0; l<m_nx; l++)
+            {
+                w[j*m_nx+l] = 0;
+                for( unsigned m=0; m<m_nx; m++)
+                    w[j*m_nx+l] += m_fx[l*m_nx+m]*u[j*m_nx+m];
+            }
+        // filter in y and write back
+        for( unsigned j=0; j<m_ny; j++)
+            for( unsigned l=0; l<m_nx; l++)
+            {
+                real_type result = 0;
+                for( unsigned m=0; m<m_ny; m++)
+                    result += m_fy[j*m_ny+m]*w[m*m_nx+l];
+                y[column_indices[k+j*m_nx+l]] = result;
+            }
+    }
+    private:
+    real_type m_fx[max_size*max_size], m_fy[max_size*max_size];
+    unsigned m_nx, m_ny;
+};
+
+/**
+ * @brief Estimate the highest-mode energy fraction of each dG cell
+ *
+ * The probe forward-transforms the \c nx*ny points of each cell to modal
+ * space (the same per-cell DLT that \c dg::CSRModalFilter applies) and
+ * writes the fraction
+ * \f[ f = \frac{\sum_{j,l:\ j = n_y-1 \vee l = n_x-1} c_{jl}^2}{\sum_{j,l}
+ * c_{jl}^2}\f]
+ * of energy held by the highest mode number in x or y to every point of the
+ * cell (and 0 for a cell with vanishing energy). For a well resolved
+ * solution the fraction decays spectrally, so a large value flags
+ * under-resolution: a reduction like <tt> dg::blas1::reduce( y, 0.,
+ * thrust::maximum<double>())</tt> over the output yields a cheap online
+ * indicator that can drive automatic filter-strength adaptation without
+ * storing the transformed vector.
+ * Must be applied in combination with \c dg::create::filter_stencil
+ * @sa dg::blas2::stencil dg::create::filter_stencil dg::CSRModalFilter
+ */
+template<class real_type>
+struct CSRModalEnergyProbe
+{
+    ///The maximum number of polynomial coefficients per dimension
+    static const unsigned max_size = 10;
+    CSRModalEnergyProbe() : m_nx(0), m_ny(0) {}
+    /**
+     * @brief Construct from per-cell forward transformations
+     *
+     * @param fx forward transformation in x (e.g. <tt>
+     * grid.dltx().forward()</tt>), its size must not exceed \c max_size
+     * @param fy forward transformation in y, its size must not exceed \c
+     * max_size
+     */
+    CSRModalEnergyProbe( const dg::Operator<real_type>& fx,
+            const dg::Operator<real_type>& fy) :
+        m_nx( fx.size()), m_ny( fy.size())
+    {
+        assert( m_nx <= max_size && "fx size exceeds max_size in CSRModalEnergyProbe");
+        assert( m_ny <= max_size && "fy size exceeds max_size in CSRModalEnergyProbe");
+        for( unsigned i=0; i<m_nx; i++)
+            for( unsigned j=0; j<m_nx; j++)
+                m_fx[i*m_nx+j] = fx(i,j);
+        for( unsigned i=0; i<m_ny; i++)
+            for( unsigned j=0; j<m_ny; j++)
+                m_fy[i*m_ny+j] = fy(i,j);
+    }
+    DG_DEVICE
+    void operator()( unsigned i, const int* row_offsets,
+            const int* column_indices, const real_type* values,
+            const real_type* x, real_type* y)
+    {
+        int k = row_offsets[i];
+        if( row_offsets[i+1] == k) //only the first point in each cell does something
+            return;
+        real_type u[max_size*max_size], w[max_size*max_size];
+        for( unsigned j=0; j<m_ny*m_nx; j++)
+            u[j] = x[column_indices[k+j]];
+        // transform in x
+        for( unsigned j=0; j<m_ny; j++)
+            for( unsigned l=0; l<m_nx; l++)
+            {
+                w[j*m_nx+l] = 0;
+                for( unsigned m=0; m<m_nx; m++)
+                    w[j*m_nx+l] += m_fx[l*m_nx+m]*u[j*m_nx+m];
+            }
+        // transform in y and sum up modal energies
+        real_type e_tot = 0, e_high = 0;
+        for( unsigned j=0; j<m_ny; j++)
+            for( unsigned l=0; l<m_nx; l++)
+            {
+                real_type c = 0;
+                for( unsigned m=0; m<m_ny; m++)
+                    c += m_fy[j*m_ny+m]*w[m*m_nx+l];
+                e_tot += c*c;
+                if( j == m_ny-1 || l == m_nx-1)
+                    e_high += c*c;
+            }
+        real_type frac = e_tot > 0 ? e_high/e_tot : 0;
+        for( unsigned j=0; j<m_ny*m_nx; j++)
+            y[column_indices[k+j]] = frac;
+    }
+    private:
+    real_type m_fx[max_size*max_size], m_fy[max_size*max_size];
+    unsigned m_nx, m_ny;
+};
+
 /**
  * @brief Generalized slope limiter for dG methods
  *
@@ -6,6 +6,7 @@
 #include "interpolation.h"
 #include "evaluation.h"
 #include "filter.h"
+#include "stencil.h"
 
 double function( double x, double y){return sin(x)*sin(y);}
 double function( double x, double y, double z){return sin(x)*sin(y)*sin(z);}
@@ -60,6 +61,48 @@ int main()
         std::cout << "2D TEST FAILED!\n";
     else
         std::cout << "2D TEST PASSED!\n";
+
+    std::cout << "Test 2d single-kernel modal filter: \n";
+    dg::DVec stencil_vec( vec);
+    dg::CSRModalFilter<double> modal(
+       dg::create::modal_filter( op, g3.dltx()),
+       dg::create::modal_filter( op, g3.dlty()));
+    dg::IDMatrix stencil = dg::create::filter_stencil( g3);
+    dg::blas2::stencil( modal, stencil, vec, stencil_vec);
+    dg::blas1::axpby( 1., filtered_vec, -1., stencil_vec);
+    error = sqrt(dg::blas2::dot( stencil_vec, weights, stencil_vec)/ dg::blas2::dot( vec, weights, vec));
+    std::cout << "Error between single-kernel and transform filter: "<<error<<std::endl;
+    if( error > 1e-14)
+        std::cout << "2D STENCIL TEST FAILED!\n";
+    else
+        std::cout << "2D STENCIL TEST PASSED!\n";
+
+    std::cout << "Test 2d modal energy probe: \n";
+    dg::CSRModalEnergyProbe<double> probe( g3.dltx().forward(), g3.dlty().forward());
+    //a constant has no energy in the highest modes
+    dg::DVec probed( vec);
+    dg::blas2::stencil( probe, stencil, dg::DVec( vec.size(), 1.), probed);
+    double frac = dg::blas1::reduce( probed, 0., thrust::maximum<double>());
+    std::cout << "Highest mode fraction of constant: "<<frac<<" (0)\n";
+    bool passed = ( frac == 0);
+    //a pure highest mode holds all its energy there
+    dg::HVec modal_vec( vec.size(), 0.);
+    unsigned nx = g3.nx(), ny = g3.ny();
+    for( unsigned jN=0; jN<Ny; jN++)
+    for( unsigned iN=0; iN<Nx; iN++)
+        modal_vec[ ((jN*ny + ny-1)*Nx + iN)*nx + nx-1] = 1.;
+    dg::MultiMatrix<dg::DMatrix, dg::DVec> backward = dg::create::fast_transform(
+        g3.dltx().backward(), g3.dlty().backward(), g3);
+    dg::DVec mode_vec = dg::construct<dg::DVec>( modal_vec);
+    dg::blas2::symv( backward, dg::DVec( mode_vec), mode_vec);
+    dg::blas2::stencil( probe, stencil, mode_vec, probed);
+    frac = dg::blas1::reduce( probed, 1., thrust::minimum<double>());
+    std::cout << "Highest mode fraction of highest mode: "<<frac<<" (1)\n";
+    passed = passed && fabs( frac - 1.) < 1e-14;
+    if( passed)
+        std::cout << "2D PROBE TEST PASSED!\n";
+    else
+        std::cout << "2D PROBE TEST FAILED!\n";
     }
     {
     std::cout << "Test 3d exponential filter: \n";
@@ -3,7 +3,12 @@
 
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif //_OPENMP
 #include "dg/backend/typedefs.h"
+#include "dg/blas1.h"
+#include "dg/blas2.h"
 #include "grid.h"
 #include "evaluation.h"
 #include "functions.h"
@@ -211,6 +216,67 @@ std::vector<real_type> choose_1d_abscissas( real_type X,
     return xs;
 }
 
+//Chunked two-pass assembly of a coo matrix: each (OpenMP) thread collects
+//the entries of a contiguous range of rows into thread-local buffers that
+//are reserved upfront, the buffer sizes are then prefix-summed and every
+//chunk copied to its final position. This replaces the global push_back
+//assembly, which spends most of its time in repeated reallocations when
+//many matrices are built (e.g. the Nz per-plane matrices in Fieldaligned),
+//and parallelizes the row construction.
+//do_row( i, cols, vals) must append the entries of row i in column order
+template<class real_type, class RowFunction>
+cusp::coo_matrix<int, real_type, cusp::host_memory> assemble_coo(
+        unsigned num_rows, unsigned num_cols, unsigned max_entries_per_row,
+        RowFunction do_row)
+{
+    unsigned num_chunks = 1;
+#ifdef _OPENMP
+    if( !omp_in_parallel())
+        num_chunks = omp_get_max_threads();
+#endif //_OPENMP
+    if( num_chunks > num_rows)
+        num_chunks = num_rows > 0 ? num_rows : 1;
+    std::vector<std::vector<int>> chunk_rows( num_chunks), chunk_cols( num_chunks);
+    std::vector<std::vector<real_type>> chunk_vals( num_chunks);
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads( num_chunks) schedule( static, 1)
+#endif //_OPENMP
+    for( int c=0; c<(int)num_chunks; c++)
+    {
+        unsigned begin = (unsigned)((size_t)num_rows*c/num_chunks);
+        unsigned end   = (unsigned)((size_t)num_rows*(c+1)/num_chunks);
+        chunk_rows[c].reserve( (end-begin)*max_entries_per_row);
+        chunk_cols[c].reserve( (end-begin)*max_entries_per_row);
+        chunk_vals[c].reserve( (end-begin)*max_entries_per_row);
+        for( unsigned i=begin; i<end; i++)
+        {
+            size_t old_size = chunk_cols[c].size();
+            do_row( i, chunk_cols[c], chunk_vals[c]);
+            chunk_rows[c].insert( chunk_rows[c].end(),
+                chunk_cols[c].size() - old_size, (int)i);
+        }
+    }
+    //the prefix sum over the chunk sizes gives the final positions
+    std::vector<size_t> offset( num_chunks+1, 0);
+    for( unsigned c=0; c<num_chunks; c++)
+        offset[c+1] = offset[c] + chunk_vals[c].size();
+    cusp::coo_matrix<int, real_type, cusp::host_memory> A(
+            num_rows, num_cols, offset[num_chunks]);
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads( num_chunks) schedule( static, 1)
+#endif //_OPENMP
+    for( int c=0; c<(int)num_chunks; c++)
+    {
+        std::copy( chunk_rows[c].begin(), chunk_rows[c].end(),
+                A.row_indices.begin() + offset[c]);
+        std::copy( chunk_cols[c].begin(), chunk_cols[c].end(),
+                A.column_indices.begin() + offset[c]);
+        std::copy( chunk_vals[c].begin(), chunk_vals[c].end(),
+                A.values.begin() + offset[c]);
+    }
+    return A;
+}
+
 }//namespace detail
 ///@endcond
 ///@addtogroup interpolation
@@ -257,13 +323,12 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
         dg::bc bcx = dg::NEU,
         std::string method = "dg")
 {
-    cusp::array1d<real_type, cusp::host_memory> values;
-    cusp::array1d<int, cusp::host_memory> row_indices;
-    cusp::array1d<int, cusp::host_memory> column_indices;
     if( method == "dg")
     {
         dg::Operator<real_type> forward( g.dlt().forward());
-        for( unsigned i=0; i<x.size(); i++)
+        return detail::assemble_coo<real_type>( x.size(), g.size(), g.n(),
+            [&]( unsigned i, std::vector<int>& column_indices,
+                std::vector<real_type>& values)
         {
             real_type X = x[i];
             bool negative = false;
@@ -289,51 +354,42 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
             unsigned cols = n*g.n();
             for ( unsigned l=0; l<g.n(); l++)
             {
-                row_indices.push_back(i);
                 column_indices.push_back( cols + l);
                 values.push_back(negative ? -pxF[l] : pxF[l]);
             }
-        }
+        });
     }
+    unsigned points_per_line = 1;
+    if( method == "nearest")
+        points_per_line = 1;
+    else if( method == "linear")
+        points_per_line = 2;
+    else if( method == "cubic")
+        points_per_line = 4;
     else
+        throw std::runtime_error( "Interpolation method "+method+" not recognized!\n");
+    thrust::host_vector<real_type> abs = dg::create::abscissas( g);
+    dg::RealGrid1d<real_type> gx( g.x0(), g.x1(), g.n(), g.N(), bcx);
+    return detail::assemble_coo<real_type>( x.size(), g.size(), points_per_line,
+        [&]( unsigned i, std::vector<int>& column_indices,
+            std::vector<real_type>& values)
     {
-        unsigned points_per_line = 1;
-        if( method == "nearest")
-            points_per_line = 1;
-        else if( method == "linear")
-            points_per_line = 2;
-        else if( method == "cubic")
-            points_per_line = 4;
-        else
-            throw std::runtime_error( "Interpolation method "+method+" not recognized!\n");
-        thrust::host_vector<real_type> abs = dg::create::abscissas( g);
-        dg::RealGrid1d<real_type> gx( g.x0(), g.x1(), g.n(), g.N(), bcx);
-        for( unsigned i=0; i<x.size(); i++)
-        {
-            real_type X = x[i];
-            bool negative = false;
-            g.shift( negative, X, bcx);
+        real_type X = x[i];
+        bool negative = false;
+        g.shift( negative, X, bcx);
 
-            thrust::host_vector<unsigned> cols;
-            std::vector<real_type> xs  = detail::choose_1d_abscissas( X,
-                    points_per_line, gx, abs, cols);
+        thrust::host_vector<unsigned> cols;
+        std::vector<real_type> xs  = detail::choose_1d_abscissas( X,
+                points_per_line, gx, abs, cols);
 
-            std::vector<real_type> px = detail::lagrange( X, xs);
-            // px may have size != points_per_line (at boundary)
-            for ( unsigned l=0; l<px.size(); l++)
-            {
-                row_indices.push_back(i);
-                column_indices.push_back( cols[l]);
-                values.push_back(negative ? -px[l] : px[l]);
-            }
+        std::vector<real_type> px = detail::lagrange( X, xs);
+        // px may have size != points_per_line (at boundary)
+        for ( unsigned l=0; l<px.size(); l++)
+        {
+            column_indices.push_back( cols[l]);
+            values.push_back(negative ? -px[l] : px[l]);
         }
-    }
-    cusp::coo_matrix<int, real_type, cusp::host_memory> A(
-            x.size(), g.size(), values.size());
-    A.row_indices = row_indices;
-    A.column_indices = column_indices;
-    A.values = values;
-    return A;
+    });
 }
 
 /**
@@ -366,9 +422,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
         std::string method = "dg")
 {
     assert( x.size() == y.size());
-    cusp::array1d<real_type, cusp::host_memory> values;
-    cusp::array1d<int, cusp::host_memory> row_indices;
-    cusp::array1d<int, cusp::host_memory> column_indices;
     if( method == "dg")
     {
         std::vector<real_type> gauss_nodesx = g.dltx().abscissas();
@@ -376,8 +429,10 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
         dg::Operator<real_type> forwardx( g.dltx().forward());
         dg::Operator<real_type> forwardy( g.dlty().forward());
 
-
-        for( int i=0; i<(int)x.size(); i++)
+        return detail::assemble_coo<real_type>( x.size(), g.size(),
+            g.nx()*g.ny(), [&]( unsigned i,
+                std::vector<int>& column_indices,
+                std::vector<real_type>& values)
         {
             real_type X = x[i], Y = y[i];
             bool negative=false;
@@ -428,7 +483,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                 for(unsigned k=0; k<g.ny(); k++)
                     for( unsigned l=0; l<g.nx(); l++)
                     {
-                        row_indices.push_back( i);
                         column_indices.push_back( ((mm*g.ny()+k)*g.Nx()+nn)*g.nx() + l);
                         real_type pxy = pyF[k]*pxF[l];
                         if( !negative)
@@ -446,7 +500,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                         pxF[l]+= px[k]*forwardx(k,l);
                 for( unsigned l=0; l<g.nx(); l++)
                 {
-                    row_indices.push_back( i);
                     column_indices.push_back( ((idxY)*g.Nx() + nn)*g.nx() + l);
                     if( !negative)
                         values.push_back( pxF[l]);
@@ -464,7 +517,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                         pyF[l]+= py[k]*forwardy(k,l);
                 for( unsigned k=0; k<g.ny(); k++)
                 {
-                    row_indices.push_back(i);
                     column_indices.push_back((mm*g.ny()+k)*g.Nx()*g.nx() + idxX);
                     if( !negative)
                         values.push_back( pyF[k]);
@@ -475,7 +527,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
             }
             else //the point already exists
             {
-                row_indices.push_back(i);
                 column_indices.push_back(idxY*g.Nx()*g.nx() + idxX);
                 if( !negative)
                     values.push_back( 1.);
@@ -483,65 +534,57 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                     values.push_back(-1.);
             }
 
-        }
+        });
     }
+    unsigned points_per_line = 1;
+    if( method == "nearest")
+        points_per_line = 1;
+    else if( method == "linear")
+        points_per_line = 2;
+    else if( method == "cubic")
+        points_per_line = 4;
     else
-    {
-        unsigned points_per_line = 1;
-        if( method == "nearest")
-            points_per_line = 1;
-        else if( method == "linear")
-            points_per_line = 2;
-        else if( method == "cubic")
-            points_per_line = 4;
-        else
-            throw std::runtime_error( "Interpolation method "+method+" not recognized!\n");
-        RealGrid1d<real_type> gx(g.x0(), g.x1(), g.nx(), g.Nx(), bcx);
-        RealGrid1d<real_type> gy(g.y0(), g.y1(), g.ny(), g.Ny(), bcy);
-        thrust::host_vector<real_type> absX = dg::create::abscissas( gx);
-        thrust::host_vector<real_type> absY = dg::create::abscissas( gy);
+        throw std::runtime_error( "Interpolation method "+method+" not recognized!\n");
+    RealGrid1d<real_type> gx(g.x0(), g.x1(), g.nx(), g.Nx(), bcx);
+    RealGrid1d<real_type> gy(g.y0(), g.y1(), g.ny(), g.Ny(), bcy);
+    thrust::host_vector<real_type> absX = dg::create::abscissas( gx);
+    thrust::host_vector<real_type> absY = dg::create::abscissas( gy);
 
-        for( unsigned i=0; i<x.size(); i++)
-        {
-            real_type X = x[i], Y = y[i];
-            bool negative = false;
-            g.shift( negative, X, Y, bcx, bcy);
+    return detail::assemble_coo<real_type>( x.size(), g.size(),
+        points_per_line*points_per_line, [&]( unsigned i,
+            std::vector<int>& column_indices,
+            std::vector<real_type>& values)
+    {
+        real_type X = x[i], Y = y[i];
+        bool negative = false;
+        g.shift( negative, X, Y, bcx, bcy);
 
-            thrust::host_vector<unsigned> colsX, colsY;
-            std::vector<real_type> xs  = detail::choose_1d_abscissas( X,
-                    points_per_line, gx, absX, colsX);
-            std::vector<real_type> ys  = detail::choose_1d_abscissas( Y,
-                    points_per_line, gy, absY, colsY);
+        thrust::host_vector<unsigned> colsX, colsY;
+        std::vector<real_type> xs  = detail::choose_1d_abscissas( X,
+                points_per_line, gx, absX, colsX);
+        std::vector<real_type> ys  = detail::choose_1d_abscissas( Y,
+                points_per_line, gy, absY, colsY);
 
-            //evaluate 2d Legendre polynomials at (xn, yn)...
-            std::vector<real_type> pxy( points_per_line*points_per_line);
-            std::vector<real_type> px = detail::lagrange( X, xs),
-                                   py = detail::lagrange( Y, ys);
-            // note: px , py may have size != points_per_line at boundary
-            for(unsigned k=0; k<py.size(); k++)
-                for( unsigned l=0; l<px.size(); l++)
-                    pxy[k*px.size()+l]= py[k]*px[l];
-            for( unsigned k=0; k<py.size(); k++)
-                for( unsigned l=0; l<px.size(); l++)
+        //evaluate 2d Legendre polynomials at (xn, yn)...
+        std::vector<real_type> pxy( points_per_line*points_per_line);
+        std::vector<real_type> px = detail::lagrange( X, xs),
+                               py = detail::lagrange( Y, ys);
+        // note: px , py may have size != points_per_line at boundary
+        for(unsigned k=0; k<py.size(); k++)
+            for( unsigned l=0; l<px.size(); l++)
+                pxy[k*px.size()+l]= py[k]*px[l];
+        for( unsigned k=0; k<py.size(); k++)
+            for( unsigned l=0; l<px.size(); l++)
+            {
+                if( fabs(pxy[k*px.size() +l]) > 1e-14)
                 {
-                    if( fabs(pxy[k*px.size() +l]) > 1e-14)
-                    {
-                        row_indices.push_back( i);
-                        column_indices.push_back( (colsY[k])*g.nx()*g.Nx() +
-                            colsX[l]);
-                        values.push_back( negative ? - pxy[k*px.size()+l]
-                                :  pxy[k*px.size()+l]);
-                    }
+                    column_indices.push_back( (colsY[k])*g.nx()*g.Nx() +
+                        colsX[l]);
+                    values.push_back( negative ? - pxy[k*px.size()+l]
+                            :  pxy[k*px.size()+l]);
                 }
-        }
-    }
-    cusp::coo_matrix<int, real_type, cusp::host_memory> A( x.size(),
-            g.size(), values.size());
-    A.row_indices = row_indices;
-    A.column_indices = column_indices;
-    A.values = values;
-
-    return A;
+            }
+    });
 }
 
 
@@ -580,9 +623,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
 {
     assert( x.size() == y.size());
     assert( y.size() == z.size());
-    cusp::array1d<real_type, cusp::host_memory> values;
-    cusp::array1d<int, cusp::host_memory> row_indices;
-    cusp::array1d<int, cusp::host_memory> column_indices;
 
     if( method == "dg")
     {
@@ -592,7 +632,10 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
         dg::Operator<real_type> forwardx( g.dltx().forward());
         dg::Operator<real_type> forwardy( g.dlty().forward());
         dg::Operator<real_type> forwardz( g.dltz().forward());
-        for( int i=0; i<(int)x.size(); i++)
+        return detail::assemble_coo<real_type>( x.size(), g.size(),
+            g.nx()*g.ny()*g.nz(), [&]( unsigned i,
+                std::vector<int>& column_indices,
+                std::vector<real_type>& values)
         {
             real_type X = x[i], Y = y[i], Z = z[i];
             bool negative = false;
@@ -641,7 +684,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
             }
             if( idxX >= 0 && idxY >= 0 && idxZ >= 0) //the point already exists
             {
-                row_indices.push_back(i);
                 column_indices.push_back((idxZ*g.Ny()*g.ny()+idxY)*g.Nx()*g.nx() + idxX);
                 if( !negative)
                     values.push_back( 1.);
@@ -657,7 +699,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                         pxF[l]+= px[k]*forwardx(k,l);
                 for( unsigned l=0; l<g.nx(); l++)
                 {
-                    row_indices.push_back( i);
                     column_indices.push_back( (idxZ*g.Ny()*g.ny() +
                                 idxY)*g.Nx()*g.nx() + nn*g.nx() + l);
                     if( !negative)
@@ -675,7 +716,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                         pyF[l]+= py[k]*forwardy(k,l);
                 for( unsigned k=0; k<g.ny(); k++)
                 {
-                    row_indices.push_back(i);
                     column_indices.push_back(((idxZ*g.Ny()+mm)*g.ny()+k)*g.Nx()*g.nx() + idxX);
                     if(!negative)
                         values.push_back( pyF[k]);
@@ -704,7 +744,6 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                 for( unsigned k=0; k<g.ny(); k++)
                 for( unsigned l=0; l<g.nx(); l++)
                 {
-                    row_indices.push_back( i);
                     column_indices.push_back(
                         ((((ll*g.nz()+s)*g.Ny()+mm)*g.ny()+k)*g.Nx()+nn)*g.nx()+l);
                     real_type pxyz = pzF[s]*pyF[k]*pxF[l];
@@ -714,73 +753,65 @@ cusp::coo_matrix<int, real_type, cusp::host_memory> interpolation(
                         values.push_back(-pxyz);
                 }
             }
-        }
+        });
     }
+    unsigned points_per_line = 1;
+    if( method == "nearest")
+        points_per_line = 1;
+    else if( method == "linear")
+        points_per_line = 2;
+    else if( method == "cubic")
+        points_per_line = 4;
     else
+        throw std::runtime_error( "Interpolation method "+method+" not recognized!\n");
+    RealGrid1d<real_type> gx(g.x0(), g.x1(), g.nx(), g.Nx(), bcx);
+    RealGrid1d<real_type> gy(g.y0(), g.y1(), g.ny(), g.Ny(), bcy);
+    RealGrid1d<real_type> gz(g.z0(), g.z1(), g.nz(), g.Nz(), bcz);
+    thrust::host_vector<real_type> absX = dg::create::abscissas( gx);
+    thrust::host_vector<real_type> absY = dg::create::abscissas( gy);
+    thrust::host_vector<real_type> absZ = dg::create::abscissas( gz);
+    return detail::assemble_coo<real_type>( x.size(), g.size(),
+        points_per_line*points_per_line*points_per_line, [&]( unsigned i,
+            std::vector<int>& column_indices,
+            std::vector<real_type>& values)
     {
-        unsigned points_per_line = 1;
-        if( method == "nearest")
-            points_per_line = 1;
-        else if( method == "linear")
-            points_per_line = 2;
-        else if( method == "cubic")
-            points_per_line = 4;
-        else
-            throw std::runtime_error( "Interpolation method "+method+" not recognized!\n");
-        RealGrid1d<real_type> gx(g.x0(), g.x1(), g.nx(), g.Nx(), bcx);
-        RealGrid1d<real_type> gy(g.y0(), g.y1(), g.ny(), g.Ny(), bcy);
-        RealGrid1d<real_type> gz(g.z0(), g.z1(), g.nz(), g.Nz(), bcz);
-        thrust::host_vector<real_type> absX = dg::create::abscissas( gx);
-        thrust::host_vector<real_type> absY = dg::create::abscissas( gy);
-        thrust::host_vector<real_type> absZ = dg::create::abscissas( gz);
-        for( unsigned i=0; i<x.size(); i++)
+        real_type X = x[i], Y = y[i], Z = z[i];
+        bool negative = false;
+        g.shift( negative, X, Y, Z, bcx, bcy, bcz);
+
+        thrust::host_vector<unsigned> colsX, colsY, colsZ;
+        std::vector<real_type> xs  = detail::choose_1d_abscissas( X,
+                points_per_line, gx, absX, colsX);
+        std::vector<real_type> ys  = detail::choose_1d_abscissas( Y,
+                points_per_line, gy, absY, colsY);
+        std::vector<real_type> zs  = detail::choose_1d_abscissas( Z,
+                points_per_line, gz, absZ, colsZ);
+
+        //evaluate 3d Legendre polynomials at (xn, yn, zn)...
+        std::vector<real_type> pxyz( points_per_line*points_per_line
+                *points_per_line);
+        std::vector<real_type> px = detail::lagrange( X, xs),
+                               py = detail::lagrange( Y, ys),
+                               pz = detail::lagrange( Z, zs);
+        // note: px, py, pz may have size != points_per_line at boundary
+        for( unsigned m=0; m<pz.size(); m++)
+        for( unsigned k=0; k<py.size(); k++)
+        for( unsigned l=0; l<px.size(); l++)
+            pxyz[(m*py.size()+k)*px.size()+l]= pz[m]*py[k]*px[l];
+        for( unsigned m=0; m<pz.size(); m++)
+        for( unsigned k=0; k<py.size(); k++)
+        for( unsigned l=0; l<px.size(); l++)
         {
-            real_type X = x[i], Y = y[i], Z = z[i];
-            bool negative = false;
-            g.shift( negative, X, Y, Z, bcx, bcy, bcz);
-
-            thrust::host_vector<unsigned> colsX, colsY, colsZ;
-            std::vector<real_type> xs  = detail::choose_1d_abscissas( X,
-                    points_per_line, gx, absX, colsX);
-            std::vector<real_type> ys  = detail::choose_1d_abscissas( Y,
-                    points_per_line, gy, absY, colsY);
-            std::vector<real_type> zs  = detail::choose_1d_abscissas( Z,
-                    points_per_line, gz, absZ, colsZ);
-
-            //evaluate 3d Legendre polynomials at (xn, yn, zn)...
-            std::vector<real_type> pxyz( points_per_line*points_per_line
-                    *points_per_line);
-            std::vector<real_type> px = detail::lagrange( X, xs),
-                                   py = detail::lagrange( Y, ys),
-                                   pz = detail::lagrange( Z, zs);
-            // note: px, py, pz may have size != points_per_line at boundary
-            for( unsigned m=0; m<pz.size(); m++)
-            for( unsigned k=0; k<py.size(); k++)
-            for( unsigned l=0; l<px.size(); l++)
-                pxyz[(m*py.size()+k)*px.size()+l]= pz[m]*py[k]*px[l];
-            for( unsigned m=0; m<pz.size(); m++)
-            for( unsigned k=0; k<py.size(); k++)
-            for( unsigned l=0; l<px.size(); l++)
+            if( fabs(pxyz[(m*py.size()+k)*px.size() +l]) > 1e-14)
             {
-                if( fabs(pxyz[(m*py.size()+k)*px.size() +l]) > 1e-14)
-                {
-                    row_indices.push_back( i);
-                    column_indices.push_back( ((colsZ[m])*g.ny()*g.Ny() +
-                                colsY[k])*g.nx()*g.Nx() + colsX[l]);
-                    values.push_back( negative ?
-                            -pxyz[(m*py.size()+k)*px.size()+l]
-                          :  pxyz[(m*py.size()+k)*px.size()+l] );
-                }
+                column_indices.push_back( ((colsZ[m])*g.ny()*g.Ny() +
+                            colsY[k])*g.nx()*g.Nx() + colsX[l]);
+                values.push_back( negative ?
+                        -pxyz[(m*py.size()+k)*px.size()+l]
+                      :  pxyz[(m*py.size()+k)*px.size()+l] );
             }
         }
-    }
-    cusp::coo_matrix<int, real_type, cusp::host_memory> A( x.size(), g.size(),
-            values.size());
-    A.row_indices = row_indices;
-    A.column_indices = column_indices;
-    A.values = values;
-
-    return A;
+    });
 }
 /**
  * @brief Create interpolation between two grids
@@ -1011,4 +1042,106 @@ real_type interpolate(
     return value;
 }
 
+/*!@brief Evaluate a small batch of interpolation points in a single kernel
+ *
+ * This class stores the coefficients of an interpolation matrix for a (small)
+ * list of points in a padded structure-of-array layout and evaluates all
+ * points with a single call to \c dg::blas2::parallel_for. For a few hundred
+ * points (think of probe or particle diagnostics) this is significantly
+ * faster than a general sparse matrix-vector multiplication, which is latency
+ * bound at such sizes.
+ * @note It only works on shared memory vectors; the MPI version can be found in \c mpi_projection.h
+ * @tparam ContainerType One of the shared memory containers
+ * @ingroup interpolation
+ */
+template<class ContainerType>
+struct PointInterpolation
+{
+    using container_type = ContainerType;
+    using value_type = dg::get_value_type<ContainerType>;
+    PointInterpolation() = default;
+    /**
+     * @brief Store the coefficients of \c mat
+     *
+     * @param mat an interpolation matrix, e.g. created by \c dg::create::interpolation;
+     * each row holds the coefficients of one point
+     */
+    PointInterpolation( const cusp::coo_matrix<int, value_type, cusp::host_memory>& mat)
+    {
+        m_num = mat.num_rows;
+        thrust::host_vector<int> counts( m_num, 0);
+        for( unsigned k=0; k<mat.values.size(); k++)
+            counts[ mat.row_indices[k]]++;
+        m_stencil = 0;
+        for( unsigned i=0; i<m_num; i++)
+            if( (unsigned)counts[i] > m_stencil)
+                m_stencil = counts[i];
+        //pad all rows to the maximum stencil size; the padding entries
+        //multiply x[0] with a zero coefficient
+        thrust::host_vector<int> cols( m_stencil*m_num, 0);
+        thrust::host_vector<value_type> vals( m_stencil*m_num, 0.);
+        for( unsigned i=0; i<m_num; i++)
+            counts[i] = 0;
+        for( unsigned k=0; k<mat.values.size(); k++)
+        {
+            int i = mat.row_indices[k];
+            //structure of array layout: entry s of point i lies at [s*m_num+i]
+            cols[ counts[i]*m_num + i] = mat.column_indices[k];
+            vals[ counts[i]*m_num + i] = mat.values[k];
+            counts[i]++;
+        }
+        m_cols = cols;
+        m_vals = dg::construct<ContainerType>( vals);
+    }
+    ///@copydoc dg::create::interpolation(const thrust::host_vector<real_type>&,const thrust::host_vector<real_type>&,const aRealTopology2d<real_type>&,dg::bc,dg::bc,std::string)
+    PointInterpolation(
+        const thrust::host_vector<value_type>& x,
+        const thrust::host_vector<value_type>& y,
+        const aRealTopology2d<value_type>& g,
+        dg::bc bcx = dg::NEU, dg::bc bcy = dg::NEU,
+        std::string method = "dg")
+        : PointInterpolation( dg::create::interpolation( x, y, g, bcx, bcy, method)){}
+    ///@copydoc dg::create::interpolation(const thrust::host_vector<real_type>&,const thrust::host_vector<real_type>&,const thrust::host_vector<real_type>&,const aRealTopology3d<real_type>&,dg::bc,dg::bc,dg::bc,std::string)
+    PointInterpolation(
+        const thrust::host_vector<value_type>& x,
+        const thrust::host_vector<value_type>& y,
+        const thrust::host_vector<value_type>& z,
+        const aRealTopology3d<value_type>& g,
+        dg::bc bcx = dg::NEU, dg::bc bcy = dg::NEU, dg::bc bcz = dg::PER,
+        std::string method = "dg")
+        : PointInterpolation( dg::create::interpolation( x, y, z, g, bcx, bcy, bcz, method)){}
+    ///@brief The number of interpolation points
+    unsigned size() const {return m_num;}
+    /**
+     * @brief Interpolate \c x on all points
+     *
+     * @param x values from which to interpolate ( must have the grid size that the coefficients were created for)
+     * @param y contains the interpolated values on output ( must have \c size() elements)
+     */
+    void operator()( const ContainerType& x, ContainerType& y) const
+    {
+        if( m_num == 0)
+            return;
+        unsigned num = m_num, stencil = m_stencil;
+        dg::blas2::parallel_for( [num, stencil] DG_DEVICE(
+                    unsigned i,
+                    const int* cols,
+                    const value_type* vals,
+                    const value_type* x, value_type* y)
+            {
+                value_type sum = 0;
+                for( unsigned s=0; s<stencil; s++)
+                    sum += vals[s*num+i]*x[cols[s*num+i]];
+                y[i] = sum;
+            }, m_num, m_cols, m_vals, x, y);
+    }
+    private:
+    using IVec = std::conditional_t< std::is_same<
+        dg::get_execution_policy<ContainerType>, dg::SerialTag>::value,
+        thrust::host_vector<int>, thrust::device_vector<int>>;
+    unsigned m_num = 0, m_stencil = 0;
+    IVec m_cols;
+    ContainerType m_vals;
+};
+
 } //namespace dg
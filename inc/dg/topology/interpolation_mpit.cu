@@ -148,6 +148,26 @@ int main(int argc, char* argv[])
         std::cout << "FAILED from rank "<<rank<<"!\n";
     else
         std::cout << "SUCCESS from rank "<<rank<<"!\n";
+    MPI_Barrier(comm);
+    ///%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%//
+    if(rank==0) std::cout << "Now test batched POINT interpolation!\n";
+    //all processes hold the same points and must get the same values
+    dg::HVec xp = std::vector<double>{ 0.13, 0.49, 0.55, 0.87}, yp( xp);
+    dg::PointInterpolation<dg::MHVec> points( xp, yp, g2d);
+    dg::MHVec point_values( dg::HVec( xp.size()), g2d.communicator());
+    points( sine, point_values);
+    dg::IHMatrix direct_points = dg::create::interpolation( xp, yp, g2d.global());
+    dg::HVec g_point_values( xp.size());
+    dg::blas2::symv( direct_points, global_sine, g_point_values);
+    //now compare
+    success = true;
+    for( unsigned i=0; i<xp.size(); i++)
+        if( fabs(point_values.data()[i] - g_point_values[i]) > 1e-14)
+            success = false;
+    if( !success)
+        std::cout << "FAILED from rank "<<rank<<"!\n";
+    else
+        std::cout << "SUCCESS from rank "<<rank<<"!\n";
 
     MPI_Finalize();
     return 0;
@@ -131,6 +131,29 @@ int main()
         std::cout<< "2D TEST FAILED!\n";
     else
         std::cout << "2D TEST PASSED!\n";
+    //the fast block transform must reproduce the backscatter matrix
+    auto fastA = dg::create::fast_backscatter( g);
+    thrust::host_vector<double> inter3(vec), inter4(vec);
+    dg::blas2::symv( fastA, vec, inter3);
+    dg::blas2::symv( A, vec, inter4);
+    dg::blas1::axpby( 1., inter4, -1., inter3);
+    error = dg::blas1::dot( inter3, inter3);
+    std::cout << "Error of fast backscatter is "<<error<<" (should be 0)!\n";
+    if( error > 1e-25)
+        std::cout<< "2D FAST BACKSCATTER TEST FAILED!\n";
+    else
+        std::cout << "2D FAST BACKSCATTER TEST PASSED!\n";
+    //the batched point evaluation must reproduce the matrix-vector product
+    dg::PointInterpolation<thrust::host_vector<double>> batch( B);
+    thrust::host_vector<double> inter2(inter);
+    batch( vec, inter2);
+    dg::blas1::axpby( 1., inter, -1., inter2);
+    error = dg::blas1::dot( inter2, inter2);
+    std::cout << "Error of batched point interpolation is "<<error<<" (should be 0)!\n";
+    if( error > 1e-14)
+        std::cout<< "2D POINT TEST FAILED!\n";
+    else
+        std::cout << "2D POINT TEST PASSED!\n";
     std::vector<std::string> methods = {"nearest", "linear", "cubic"};
     dg::Grid2d g2d ( -1.5, 6.5, -1.5, 6.5, 1, 8, 8);
     std::vector<double> x1d{ -1.4, -0.4, .1, 2.2, 2.8, 3, 3.1, 3.4, 4.9, 6.1};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../blas.h"
+#include "grid.h"
+#include "weights.h"
+
+/*! @file
+  * @brief A Kronecker product form of the integration weights
+  */
+
+namespace dg{
+
+///@addtogroup sparsematrix
+///@{
+/*!@brief Fast (shared memory) Kronecker product weights \f$ w_z\otimes w_y\otimes w_x\f$
+ *
+ * On product grids the nodal integration weights and volume forms factor
+ * into one short vector per dimension. This class stores only the 1d factors
+ * and multiplies them on the fly when applied, so a weighted scaling reads
+ * three short vectors instead of one volume sized vector - roughly a third
+ * less memory traffic than \c dg::blas1::pointwiseDot with materialized
+ * weights. The class registers as a \c SelfMadeMatrixTag matrix and can thus
+ * be used wherever a diagonal matrix is applied through \c dg::blas2::symv,
+ * in particular as the (inverse) weights preconditioner in \c dg::PCG.
+ * @note The binary reproducible \c dg::blas2::dot works on materialized
+ * vectors only, so the scalar products inside the solvers keep the full
+ * weights; the savings apply to every scaling and preconditioner application
+ * @note It is fast to apply but only works on shared memory vectors
+ * @tparam Container One of the shared memory containers
+ */
+template<class Container>
+struct KroneckerWeights
+{
+    using container_type = Container;
+    using value_type = dg::get_value_type<Container>;
+    KroneckerWeights() = default;
+    /*!@brief Store the given 1d factors
+     *
+     * The represented diagonal is
+     * \f$ W_{i} = w_x[i\%s_x] w_y[(i/s_x)\%s_y] w_z[i/(s_xs_y)]\f$ with
+     * \f$ s_x \f$, \f$ s_y\f$ the sizes of \c wx and \c wy.
+     * @param wx weights in the first (fastest varying) dimension
+     * @param wy weights in the second dimension
+     * @param wz weights in the third dimension
+     * @note To represent inverse weights simply pass inverted factors
+     */
+    template<class real_type>
+    KroneckerWeights( const thrust::host_vector<real_type>& wx,
+            const thrust::host_vector<real_type>& wy,
+            const thrust::host_vector<real_type>& wz)
+    {
+        dg::assign( wx, m_wx);
+        dg::assign( wy, m_wy);
+        dg::assign( wz, m_wz);
+    }
+    ///@brief The weights of \c g as the product of the 1d weights of its axes
+    ///@param g The grid
+    template<class real_type>
+    KroneckerWeights( const aRealTopology2d<real_type>& g) : KroneckerWeights(
+            dg::create::weights( g.gx()), dg::create::weights( g.gy()),
+            thrust::host_vector<real_type>( 1, 1.)){}
+    ///@copydoc KroneckerWeights(const aRealTopology2d<real_type>&)
+    template<class real_type>
+    KroneckerWeights( const aRealTopology3d<real_type>& g) : KroneckerWeights(
+            dg::create::weights( g.gx()), dg::create::weights( g.gy()),
+            dg::create::weights( g.gz())){}
+    ///@brief The total size of the represented diagonal
+    unsigned size() const { return m_wx.size()*m_wy.size()*m_wz.size();}
+    ///@brief Access the 1d factor in the first dimension
+    const Container& wx() const { return m_wx;}
+    ///@brief Access the 1d factor in the second dimension
+    const Container& wy() const { return m_wy;}
+    ///@brief Access the 1d factor in the third dimension
+    const Container& wz() const { return m_wz;}
+    /*!@brief \f$ y = W x\f$ in a single fused pass
+     * @param x input vector (of total size \c size())
+     * @param y contains the result on output (may alias \c x)
+     */
+    template<class ContainerType0, class ContainerType1>
+    void symv( const ContainerType0& x, ContainerType1& y) const
+    {
+        unsigned nx = m_wx.size(), ny = m_wy.size();
+        dg::blas2::parallel_for( [nx, ny] DG_DEVICE(
+                    unsigned i,
+                    const value_type* wx,
+                    const value_type* wy,
+                    const value_type* wz,
+                    const value_type* x, value_type* y)
+            {
+                y[i] = wx[i%nx]*wy[(i/nx)%ny]*wz[i/(nx*ny)]*x[i];
+            }, size(), m_wx, m_wy, m_wz, x, y);
+    }
+    /*!@brief \f$ y = \alpha W x + \beta y\f$ in a single fused pass
+     * @param alpha A scalar
+     * @param x input vector (of total size \c size())
+     * @param beta A scalar
+     * @param y contains the result on output (may alias \c x)
+     */
+    template<class ContainerType0, class ContainerType1>
+    void symv( value_type alpha, const ContainerType0& x, value_type beta,
+            ContainerType1& y) const
+    {
+        unsigned nx = m_wx.size(), ny = m_wy.size();
+        dg::blas2::parallel_for( [nx, ny, alpha, beta] DG_DEVICE(
+                    unsigned i,
+                    const value_type* wx,
+                    const value_type* wy,
+                    const value_type* wz,
+                    const value_type* x, value_type* y)
+            {
+                y[i] = alpha*wx[i%nx]*wy[(i/nx)%ny]*wz[i/(nx*ny)]*x[i]
+                    + beta*y[i];
+            }, size(), m_wx, m_wy, m_wz, x, y);
+    }
+    private:
+    Container m_wx, m_wy, m_wz;
+};
+///@}
+
+///@cond
+template<class Container>
+struct TensorTraits<KroneckerWeights<Container>>
+{
+    using value_type = dg::get_value_type<Container>;
+    using tensor_category = SelfMadeMatrixTag;
+    using execution_policy = dg::get_execution_policy<Container>;
+};
+///@endcond
+
+}//namespace dg
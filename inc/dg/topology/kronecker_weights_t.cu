@@ -0,0 +1,52 @@
+#include <iostream>
+#include <cmath>
+
+#include "dg/blas.h"
+#include "evaluation.h"
+#include "weights.h"
+#include "kronecker_weights.h"
+
+double function2d( double x, double y){ return sin(x)*exp(y);}
+double function3d( double x, double y, double z){ return sin(x)*exp(y)*cos(z);}
+
+int main()
+{
+    std::cout << "Test Kronecker product weights\n";
+    dg::Grid2d g2d( 0.1, 1, 0.2, 2, 3, 12, 5);
+    dg::KroneckerWeights<dg::DVec> kron2d( g2d);
+    dg::DVec w2d = dg::construct<dg::DVec>( dg::create::weights( g2d));
+    dg::DVec x = dg::construct<dg::DVec>( dg::evaluate( function2d, g2d));
+    dg::DVec y( x), z( x);
+    dg::blas2::symv( kron2d, x, y);
+    dg::blas1::pointwiseDot( w2d, x, z);
+    dg::blas1::axpby( 1., y, -1., z);
+    double err = sqrt( dg::blas1::dot( z, z)/dg::blas2::dot( y, w2d, y));
+    std::cout << "Relative difference 2d to materialized weights: "
+              <<err<<" (should be small)\n";
+
+    dg::Grid3d g3d( 0.1, 1, 0.2, 2, 0.3, 3, 3, 12, 5, 4);
+    dg::KroneckerWeights<dg::DVec> kron3d( g3d);
+    dg::DVec w3d = dg::construct<dg::DVec>( dg::create::weights( g3d));
+    x = dg::construct<dg::DVec>( dg::evaluate( function3d, g3d));
+    y = z = x;
+    dg::blas2::symv( 2., kron3d, x, -1., y); // y = 2Wx - x
+    dg::blas1::pointwiseDot( 2., w3d, x, -1., z);
+    dg::blas1::axpby( 1., y, -1., z);
+    err = sqrt( dg::blas1::dot( z, z)/dg::blas2::dot( y, w3d, y));
+    std::cout << "Relative difference 3d to materialized weights: "
+              <<err<<" (should be small)\n";
+
+    // inverse factors must undo the weights
+    dg::KroneckerWeights<dg::DVec> inv3d(
+            dg::create::inv_weights( g3d.gx()),
+            dg::create::inv_weights( g3d.gy()),
+            dg::create::inv_weights( g3d.gz()));
+    dg::blas2::symv( kron3d, x, y);
+    dg::blas2::symv( inv3d, y, y);
+    dg::blas1::axpby( 1., x, -1., y);
+    err = sqrt( dg::blas1::dot( y, y)/dg::blas1::dot( x, x));
+    std::cout << "Relative error of inverse round trip: "
+              <<err<<" (should be small)\n";
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <mpi.h>
+#include "dg/backend/exceptions.h"
+
+/*! @file
+  @brief Measured load balancing of overdecomposed domains
+  */
+
+namespace dg
+{
+
+/**
+ * @brief Partition weighted blocks into contiguous parts with minimal bottleneck
+ *
+ * Given \c num_blocks positive weights (e.g. measured execution times of
+ * logical blocks) compute offsets \f$ 0 = o_0 \leq o_1 \leq ... \leq o_P = \f$
+ * \c num_blocks such that part \c p owns blocks \f$ [o_p, o_{p+1})\f$ and the
+ * maximum part weight \f$ \max_p \sum_{i=o_p}^{o_{p+1}-1} w_i\f$ is minimal
+ * among all contiguous partitions (the classic chains-on-chains problem,
+ * solved exactly by bisection on the bottleneck value).
+ * Keeping blocks contiguous means that when the partition changes only
+ * blocks at part boundaries move, i.e. only neighboring parts exchange data.
+ * @param weights the block weights (must be non-negative, size \c num_blocks)
+ * @param num_parts the number of parts P (e.g. the number of MPI ranks)
+ * @return P+1 offsets into \c weights as described above
+ * @note If there are at least as many blocks with positive weight as parts
+ * every part receives at least one block
+ * @ingroup mpi_structures
+ */
+inline std::vector<unsigned> balanced_partition(
+    const std::vector<double>& weights, unsigned num_parts)
+{
+    unsigned num_blocks = weights.size();
+    if( num_parts == 0)
+        throw dg::Error(dg::Message(_ping_)<<"num_parts must not be zero!");
+    //feasibility test: can we partition with bottleneck <= value?
+    auto feasible = [&]( double value, std::vector<unsigned>& offsets)
+    {
+        offsets.assign( 1, 0);
+        double current = 0;
+        for( unsigned i=0; i<num_blocks; i++)
+        {
+            if( weights[i] > value)
+                return false;
+            if( current + weights[i] > value)
+            {
+                offsets.push_back( i);
+                current = 0;
+                if( offsets.size() > num_parts)
+                    return false;
+            }
+            current += weights[i];
+        }
+        while( offsets.size() < num_parts+1)
+            offsets.push_back( num_blocks);
+        return true;
+    };
+    double total = 0, max_weight = 0;
+    for( unsigned i=0; i<num_blocks; i++)
+    {
+        total += weights[i];
+        max_weight = std::max( max_weight, weights[i]);
+    }
+    double lower = std::max( max_weight, total/(double)num_parts);
+    double upper = total;
+    std::vector<unsigned> offsets, trial;
+    feasible( upper, offsets); //always succeeds
+    for( unsigned iter=0; iter<60; iter++)
+    {
+        double middle = 0.5*(lower+upper);
+        if( feasible( middle, trial))
+        {
+            offsets = trial;
+            upper = middle;
+        }
+        else
+            lower = middle;
+    }
+    //greedily pull blocks into empty trailing parts (zero weight blocks)
+    for( unsigned p=1; p<num_parts; p++)
+        if( offsets[p] == num_blocks && offsets[p-1] < num_blocks-(num_parts-p))
+            for( unsigned q=p; q<num_parts; q++)
+                offsets[q] = std::min( num_blocks, offsets[p-1] + (q-p+1));
+    return offsets;
+}
+
+/**
+ * @brief Measure per-block execution times and rebalance an overdecomposed domain
+ *
+ * The MPI topologies in this library split the domain into one equally sized
+ * subdomain per rank (Section \c aRealMPITopology2d), which is optimal only if
+ * every grid point costs the same.  On X-point grids
+ * (\c dg::geo::CurvilinearGridX2d and its refined versions) the cells near the
+ * separatrix are locally refined and the ranks that own them can be
+ * substantially slower than the rest.  The remedy is
+ * <b>overdecomposition</b>: the application splits the domain into more
+ * logical blocks than ranks (say 4-8 blocks per rank, e.g. slabs in the
+ * poloidal index), assigns contiguous runs of blocks to ranks and
+ * periodically reassigns runs based on measured per-block time.  Because data
+ * layout and communication patterns in this library are constructed from the
+ * grid objects, a reassignment is applied by reconstructing the per-rank
+ * grids and operators from the new offsets (the \c construct idiom), e.g. at
+ * a restart or output point of a long turbulence run; blocks do not migrate
+ * transparently behind the containers.
+ *
+ * This class provides the measurement and the reassignment decision:
+ * the application brackets the work on each of its blocks with \c tic / \c
+ * toc, and \c repartition gathers the accumulated times of all blocks and
+ * returns new contiguous offsets via \c balanced_partition.  Since the
+ * partition is contiguous, only neighboring ranks exchange blocks when it
+ * changes.
+ * @code
+ * // 8 poloidal slabs per rank, initially equally distributed
+ * dg::LoadBalance balance( 8*size, comm);
+ * for( unsigned step=0; step<steps; step++)
+ * {
+ *     for( unsigned b=balance.begin(); b<balance.end(); b++)
+ *     {
+ *         balance.tic( b);
+ *         // ... advance block b ...
+ *         balance.toc( b);
+ *     }
+ *     if( step % 100 == 99 && balance.imbalance() > 1.1)
+ *     {
+ *         std::vector<unsigned> offsets = balance.repartition();
+ *         // ... reconstruct grids and operators from offsets, exchange
+ *         // block data with neighboring ranks, then ...
+ *         balance.set_offsets( offsets);
+ *     }
+ * }
+ * @endcode
+ * @ingroup mpi_structures
+ */
+struct LoadBalance
+{
+    ///@brief no allocation
+    LoadBalance() = default;
+    /**
+     * @brief Allocate for \c num_blocks global blocks, equally distributed
+     *
+     * Rank \c r initially owns blocks <tt>[num_blocks*r/P, num_blocks*(r+1)/P)</tt>
+     * @param num_blocks total number of logical blocks over all ranks
+     * (should be a small multiple of the number of ranks)
+     * @param comm the communicator over which the blocks are distributed
+     */
+    LoadBalance( unsigned num_blocks, MPI_Comm comm): m_comm(comm)
+    {
+        int rank, size;
+        MPI_Comm_rank( comm, &rank);
+        MPI_Comm_size( comm, &size);
+        m_offsets.resize( size+1);
+        for( int r=0; r<=size; r++)
+            m_offsets[r] = (unsigned)((size_t)num_blocks*r/size);
+        m_times.assign( num_blocks, 0.);
+    }
+    ///@copydoc LoadBalance::LoadBalance(unsigned,MPI_Comm)
+    ///@param offsets current contiguous block distribution (size P+1)
+    LoadBalance( unsigned num_blocks, MPI_Comm comm,
+        std::vector<unsigned> offsets): m_comm(comm), m_offsets(offsets)
+    {
+        m_times.assign( num_blocks, 0.);
+    }
+    ///@brief first global block index owned by the calling rank
+    unsigned begin() const{
+        int rank;
+        MPI_Comm_rank( m_comm, &rank);
+        return m_offsets[rank];
+    }
+    ///@brief one past the last global block index owned by the calling rank
+    unsigned end() const{
+        int rank;
+        MPI_Comm_rank( m_comm, &rank);
+        return m_offsets[rank+1];
+    }
+    ///@brief Start timing block \c block (must be owned by the calling rank)
+    ///@note Unlike \c dg::Timer the measurement is purely local, there is no
+    ///barrier (a barrier would hide exactly the imbalance we want to measure)
+    void tic( unsigned block)
+    {
+        (void)block;
+        m_start = MPI_Wtime();
+    }
+    ///@brief Stop timing block \c block and accumulate the elapsed time
+    void toc( unsigned block)
+    {
+        m_times[block] += MPI_Wtime() - m_start;
+    }
+    /**
+     * @brief Ratio of slowest rank to average rank since the last \c clear
+     *
+     * @note collective on the communicator
+     * @return \f$ \max_r t_r / \left(\frac{1}{P}\sum_r t_r\right)\f$ where
+     * \c t_r is the accumulated time of rank \c r; 1 means perfect balance
+     */
+    double imbalance() const
+    {
+        int rank, size;
+        MPI_Comm_rank( m_comm, &rank);
+        MPI_Comm_size( m_comm, &size);
+        double local = 0;
+        for( unsigned b=m_offsets[rank]; b<m_offsets[rank+1]; b++)
+            local += m_times[b];
+        double max = local, sum = local;
+        MPI_Allreduce( MPI_IN_PLACE, &max, 1, MPI_DOUBLE, MPI_MAX, m_comm);
+        MPI_Allreduce( MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, m_comm);
+        return sum > 0 ? max/(sum/(double)size) : 1.;
+    }
+    /**
+     * @brief Compute new contiguous offsets from the measured block times
+     *
+     * Gathers the accumulated per-block times of all ranks and calls \c
+     * balanced_partition on them.
+     * @note collective on the communicator; the returned offsets are the
+     * same on all ranks.  The current distribution is unchanged until the
+     * application calls \c set_offsets
+     * @return P+1 offsets, rank \c r should own blocks
+     * <tt>[offsets[r], offsets[r+1])</tt>
+     */
+    std::vector<unsigned> repartition() const
+    {
+        int rank, size;
+        MPI_Comm_rank( m_comm, &rank);
+        MPI_Comm_size( m_comm, &size);
+        std::vector<double> global( m_times.size(), 0.);
+        std::vector<int> counts( size), displs( size);
+        for( int r=0; r<size; r++)
+        {
+            counts[r] = (int)(m_offsets[r+1]-m_offsets[r]);
+            displs[r] = (int)m_offsets[r];
+        }
+        MPI_Allgatherv( &m_times[m_offsets[rank]], counts[rank], MPI_DOUBLE,
+            &global[0], &counts[0], &displs[0], MPI_DOUBLE, m_comm);
+        return balanced_partition( global, (unsigned)size);
+    }
+    /**
+     * @brief Adopt a new block distribution and reset all measurements
+     * @param offsets as returned by \c repartition
+     */
+    void set_offsets( std::vector<unsigned> offsets)
+    {
+        m_offsets = offsets;
+        clear();
+    }
+    ///@brief current contiguous block distribution (size P+1)
+    const std::vector<unsigned>& get_offsets() const{ return m_offsets;}
+    ///@brief Reset all accumulated times to zero
+    void clear()
+    {
+        m_times.assign( m_times.size(), 0.);
+    }
+    private:
+    MPI_Comm m_comm = MPI_COMM_NULL;
+    std::vector<unsigned> m_offsets;
+    std::vector<double> m_times;
+    double m_start = 0.;
+};
+
+}//namespace dg
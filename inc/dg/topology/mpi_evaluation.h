@@ -153,6 +153,53 @@ MPI_Vector<thrust::host_vector<real_type> > evaluate( real_type(f)(real_type, re
     return evaluate<real_type(real_type, real_type, real_type)>( *f, g);
 };
 ///@endcond
+
+/**
+ * @brief Evaluate a 2d function on mpi distributed grid coordinates on the device
+ *
+ * Same as \c dg::evaluate but the functor is applied to all local grid points
+ * in parallel on the device
+ * @copydoc hide_binary
+ * @param f The function to evaluate: \f$ f = f(x,y)\f$; must be callable on
+ * the device (see \c dg::gpu_evaluate)
+ * @param g The 2d grid on which to evaluate \c f
+ *
+ * @return The output vector \c v as an MPI device Vector
+ * @sa \c dg::gpu_evaluate \c dg::evaluate
+ */
+template< class BinaryOp, class real_type>
+MPI_Vector<thrust::device_vector<real_type> > gpu_evaluate( const BinaryOp& f, const aRealMPITopology2d<real_type>& g)
+{
+    thrust::device_vector<real_type> x( evaluate( cooX2d, g).data());
+    thrust::device_vector<real_type> y( evaluate( cooY2d, g).data());
+    thrust::device_vector<real_type> v( g.local().size());
+    dg::blas1::evaluate( v, dg::equals(), f, x, y);
+    return MPI_Vector<thrust::device_vector<real_type> >( v, g.communicator());
+};
+
+/**
+ * @brief Evaluate a 3d function on mpi distributed grid coordinates on the device
+ *
+ * Same as \c dg::evaluate but the functor is applied to all local grid points
+ * in parallel on the device
+ * @copydoc hide_ternary
+ * @param f The function to evaluate: \f$ f = f(x,y,z)\f$; must be callable on
+ * the device (see \c dg::gpu_evaluate)
+ * @param g The 3d grid on which to evaluate \c f
+ *
+ * @return The output vector \c v as an MPI device Vector
+ * @sa \c dg::gpu_evaluate \c dg::evaluate
+ */
+template< class TernaryOp, class real_type>
+MPI_Vector<thrust::device_vector<real_type> > gpu_evaluate( const TernaryOp& f, const aRealMPITopology3d<real_type>& g)
+{
+    thrust::device_vector<real_type> x( evaluate( cooX3d, g).data());
+    thrust::device_vector<real_type> y( evaluate( cooY3d, g).data());
+    thrust::device_vector<real_type> z( evaluate( cooZ3d, g).data());
+    thrust::device_vector<real_type> v( g.local().size());
+    dg::blas1::evaluate( v, dg::equals(), f, x, y, z);
+    return MPI_Vector<thrust::device_vector<real_type> >( v, g.communicator());
+};
 //
 ///@}
 
@@ -462,6 +462,15 @@ struct aRealMPITopology3d
      * @return 2d Cartesian Communicator
      */
     MPI_Comm get_perp_comm() const {return planeComm;}
+    /**
+     * @brief MPI Cartesian communicator in the third dimension (z)
+     *
+     * Cached in the constructor such that purely perpendicular or purely
+     * parallel operations (e.g. a toroidal average) do not need to call
+     * the collective \c MPI_Cart_sub on the full 3d communicator
+     * @return 1d Cartesian Communicator
+     */
+    MPI_Comm get_para_comm() const {return zComm;}
     /**
      * @brief The Discrete Legendre Transformation
      *
@@ -571,6 +580,8 @@ struct aRealMPITopology3d
         update_local();
         int remain_dims[] = {true,true,false}; //true true false
         MPI_Cart_sub( comm, remain_dims, &planeComm);
+        int remain_z[] = {false,false,true};
+        MPI_Cart_sub( comm, remain_z, &zComm);
     }
     ///explicit copy constructor (default)
     ///@param src source
@@ -631,7 +642,7 @@ struct aRealMPITopology3d
                 { z0, z1, g.nz(), Nz, g.bcz()});
     }
     RealGrid3d<real_type> g, l; //global grid
-    MPI_Comm comm, planeComm; //just an integer...
+    MPI_Comm comm, planeComm, zComm; //just an integer...
 };
 ///@cond
 template<class real_type>
@@ -307,4 +307,199 @@ dg::MIHMatrix_t<real_type> interpolation(
 ///@}
 
 }//namespace create
+
+/**
+ * @brief Construct a grid with the same global topology but a new process decomposition
+ *
+ * For strongly elongated domains the process decomposition chosen at startup
+ * may be far from the one that minimizes halo communication. This function
+ * creates a new Cartesian communicator with the given dimensions from the
+ * processes of \c g.communicator() (keeping the periodicity) and returns the
+ * same global grid distributed over it. Use \c repartition of the vectors to
+ * migrate fields between the two grids.
+ * @param g the grid to repartition
+ * @param dims the new number of processes in x and y; the product must equal
+ * the number of processes in \c g.communicator() and the global cell numbers
+ * must be divisible by the respective entries
+ * @return the same global grid with the new process decomposition
+ * @ingroup mpi_structures
+ */
+template<class real_type>
+RealMPIGrid2d<real_type> repartition( const aRealMPITopology2d<real_type>& g,
+        std::array<int,2> dims)
+{
+    int old_dims[2], periods[2], coords[2], size;
+    MPI_Cart_get( g.communicator(), 2, old_dims, periods, coords);
+    MPI_Comm_size( g.communicator(), &size);
+    assert( dims[0]*dims[1] == size);
+    MPI_Comm comm;
+    MPI_Cart_create( g.communicator(), 2, &dims[0], periods, true, &comm);
+    return RealMPIGrid2d<real_type>( g.global().gx(), g.global().gy(), comm);
+}
+
+///@copydoc repartition(const aRealMPITopology2d<real_type>&,std::array<int,2>)
+template<class real_type>
+RealMPIGrid3d<real_type> repartition( const aRealMPITopology3d<real_type>& g,
+        std::array<int,3> dims)
+{
+    int old_dims[3], periods[3], coords[3], size;
+    MPI_Cart_get( g.communicator(), 3, old_dims, periods, coords);
+    MPI_Comm_size( g.communicator(), &size);
+    assert( dims[0]*dims[1]*dims[2] == size);
+    MPI_Comm comm;
+    MPI_Cart_create( g.communicator(), 3, &dims[0], periods, true, &comm);
+    return RealMPIGrid3d<real_type>( g.global().gx(), g.global().gy(),
+            g.global().gz(), comm);
+}
+
+/**
+ * @brief Migrate a vector from one process decomposition to another
+ *
+ * Every element of \c in is sent to the process that owns its global index in
+ * \c g_new, i.e. the result is the same field re-distributed over the new
+ * decomposition:
+ * @code{.cpp}
+ * auto g_new = dg::repartition( g_old, {npx, npy});
+ * auto v_new = dg::repartition( v_old, g_old, g_new);
+ * @endcode
+ * The communication pattern is bijective but we construct it through
+ * \c dg::GeneralComm since only its index maps guarantee the element order of
+ * the target layout.
+ * @param in a vector distributed according to \c g_old
+ * @param g_old the grid \c in is distributed on
+ * @param g_new a grid with the same global topology as \c g_old (e.g. from
+ * \c repartition); both communicators must contain the same processes
+ * @return \c in distributed according to \c g_new
+ * @ingroup mpi_structures
+ */
+template<class real_type, class MPITopologyOld, class MPITopologyNew>
+MPI_Vector<thrust::host_vector<real_type>> repartition(
+        const MPI_Vector<thrust::host_vector<real_type>>& in,
+        const MPITopologyOld& g_old, const MPITopologyNew& g_new)
+{
+    assert( g_old.size() == g_new.size());
+    int rank;
+    MPI_Comm_rank( g_new.communicator(), &rank);
+    thrust::host_vector<int> globalIdx( g_new.local_size());
+    for( unsigned i=0; i<globalIdx.size(); i++)
+        g_new.local2globalIdx( i, rank, globalIdx[i]);
+    dg::GeneralComm< dg::iHVec, thrust::host_vector<real_type>> comm(
+            globalIdx, g_old);
+    return MPI_Vector<thrust::host_vector<real_type>>(
+            comm.global_gather( &in.data()[0]), g_new.communicator());
+}
+
+/*!@brief MPI specialized version of \c PointInterpolation
+ *
+ * Each process stores the coefficients of the matrix entries whose columns
+ * index into its local vector and evaluates those with the shared memory
+ * version. The partial results are then summed with an \c MPI_Allreduce of
+ * the (small) result vector such that afterwards every process holds the
+ * interpolated values of all points.
+ * @tparam container One of the shared memory containers
+ * @ingroup interpolation
+ */
+template<class container>
+struct PointInterpolation<MPI_Vector<container> >
+{
+    using container_type = MPI_Vector<container>;
+    using value_type = dg::get_value_type<container>;
+    PointInterpolation() = default;
+    /**
+     * @brief Distribute the coefficients of a global interpolation matrix
+     *
+     * @param mat an interpolation matrix created on \c g.global(); the row
+     * indices are the point indices, the column indices are global
+     * @param g the conversion object determines which entries this process keeps
+     * @tparam ConversionPolicy has to have the members
+     *  - <tt> bool global2localIdx(int,int&,int&) const; </tt>
+     *  - <tt> MPI_Comm %communicator() const; </tt>
+     *  - <tt> local_size(); </tt>
+     * @sa basictopology the MPI %grids defined in Level 3 can all be used as a ConversionPolicy
+     */
+    template<class ConversionPolicy>
+    PointInterpolation( const cusp::coo_matrix<int, value_type, cusp::host_memory>& mat, const ConversionPolicy& g) : m_comm( g.communicator())
+    {
+        int rank;
+        MPI_Comm_rank( m_comm, &rank);
+        m_num = mat.num_rows;
+        //keep the entries whose columns this process owns; the contributions
+        //of points whose stencil overlaps several processes are summed in
+        //the Allreduce in operator()
+        thrust::host_vector<int> rows, cols;
+        thrust::host_vector<value_type> vals;
+        bool success = true;
+        for( unsigned k=0; k<mat.values.size(); k++)
+        {
+            int lIdx = 0, pid = 0;
+            if( !g.global2localIdx( mat.column_indices[k], lIdx, pid))
+                success = false;
+            if( pid != rank)
+                continue;
+            int row = mat.row_indices[k];
+            if( m_rows.size() == 0 || m_rows[m_rows.size()-1] != row)
+                m_rows.push_back( row);
+            rows.push_back( m_rows.size()-1);
+            cols.push_back( lIdx);
+            vals.push_back( mat.values[k]);
+        }
+        assert( success);
+        cusp::coo_matrix<int, value_type, cusp::host_memory> local(
+                m_rows.size(), g.local_size(), vals.size());
+        local.row_indices.assign( rows.begin(), rows.end());
+        local.column_indices.assign( cols.begin(), cols.end());
+        local.values.assign( vals.begin(), vals.end());
+        m_local = PointInterpolation<container>( local);
+        m_buffer = dg::construct<container>( thrust::host_vector<value_type>( m_rows.size(), 0.));
+        m_reduce.resize( m_num);
+    }
+    ///@copydoc dg::create::interpolation(const thrust::host_vector<real_type>&,const thrust::host_vector<real_type>&,const aRealMPITopology2d<real_type>&,dg::bc,dg::bc,std::string)
+    PointInterpolation(
+        const thrust::host_vector<value_type>& x,
+        const thrust::host_vector<value_type>& y,
+        const aRealMPITopology2d<value_type>& g,
+        dg::bc bcx = dg::NEU, dg::bc bcy = dg::NEU,
+        std::string method = "dg")
+        : PointInterpolation( dg::create::interpolation( x, y, g.global(), bcx, bcy, method), g){}
+    ///@copydoc dg::create::interpolation(const thrust::host_vector<real_type>&,const thrust::host_vector<real_type>&,const thrust::host_vector<real_type>&,const aRealMPITopology3d<real_type>&,dg::bc,dg::bc,dg::bc,std::string)
+    PointInterpolation(
+        const thrust::host_vector<value_type>& x,
+        const thrust::host_vector<value_type>& y,
+        const thrust::host_vector<value_type>& z,
+        const aRealMPITopology3d<value_type>& g,
+        dg::bc bcx = dg::NEU, dg::bc bcy = dg::NEU, dg::bc bcz = dg::PER,
+        std::string method = "linear")
+        : PointInterpolation( dg::create::interpolation( x, y, z, g.global(), bcx, bcy, bcz, method), g){}
+    ///@brief The (global) number of interpolation points
+    unsigned size() const {return m_num;}
+    /**
+     * @brief Interpolate \c x on all points
+     *
+     * @param x values from which to interpolate
+     * @param y contains the interpolated values of all points on all processes on output ( must have \c size() elements)
+     */
+    void operator()( const MPI_Vector<container>& x, MPI_Vector<container>& y)
+    {
+        if( m_num == 0)
+            return;
+        m_local( x.data(), m_buffer);
+        thrust::host_vector<value_type> buffer;
+        dg::assign( m_buffer, buffer);
+        for( unsigned i=0; i<m_num; i++)
+            m_reduce[i] = 0.;
+        for( unsigned k=0; k<m_rows.size(); k++)
+            m_reduce[ m_rows[k]] = buffer[k];
+        MPI_Allreduce( MPI_IN_PLACE, m_reduce.data(), m_num,
+                getMPIDataType<value_type>(), MPI_SUM, m_comm);
+        dg::assign( m_reduce, y.data());
+    }
+    private:
+    unsigned m_num = 0;
+    MPI_Comm m_comm = MPI_COMM_NULL;
+    thrust::host_vector<int> m_rows;
+    PointInterpolation<container> m_local;
+    container m_buffer;
+    thrust::host_vector<value_type> m_reduce;
+};
+
 }//namespace dg
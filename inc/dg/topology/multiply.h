@@ -35,6 +35,21 @@ struct TensorMultiply2d{
         out0 = DG_FMA( lambda, tmp0, temp);
     }
 };
+/// \f$ y_i \leftarrow \lambda T_{ii} x_i + \mu y_i\f$ (diagonal \c T)
+template<class value_type>
+struct DiagonalTensorMultiply2d{
+    DG_DEVICE
+    void operator() (
+              value_type lambda,
+              value_type t00, value_type t11,
+              value_type in0, value_type in1,
+              value_type mu,
+              value_type& out0, value_type& out1) const
+    {
+        out1 = DG_FMA( lambda, t11*in1, out1*mu);
+        out0 = DG_FMA( lambda, t00*in0, out0*mu);
+    }
+};
 /// \f$ y_i \leftarrow \lambda T_{ij} x_i + \mu y_i\f$
 template<class value_type>
 struct TensorMultiply3d{
@@ -58,6 +73,41 @@ struct TensorMultiply3d{
         out0 = DG_FMA( lambda, tmp0, temp);
     }
 };
+/// \f$ y_i \leftarrow \lambda T_{ij} x_i + \mu y_i\f$ (perpendicular block plus \c T_{22})
+template<class value_type>
+struct PerpTensorMultiply3d{
+    DG_DEVICE
+    void operator() ( value_type lambda,
+                      value_type t00, value_type t01,
+                      value_type t10, value_type t11, value_type t22,
+                      value_type in0, value_type in1, value_type in2,
+                      value_type mu,
+                      value_type& out0, value_type& out1, value_type& out2) const
+    {
+        value_type tmp0 = DG_FMA(t00,in0 , t01*in1);
+        value_type tmp1 = DG_FMA(t10,in0 , t11*in1);
+        out2 = DG_FMA( lambda, t22*in2, out2*mu);
+        value_type temp = out1*mu;
+        out1 = DG_FMA( lambda, tmp1, temp);
+        temp = out0*mu;
+        out0 = DG_FMA( lambda, tmp0, temp);
+    }
+};
+/// \f$ y_i \leftarrow \lambda T_{ii} x_i + \mu y_i\f$ (diagonal \c T)
+template<class value_type>
+struct DiagonalTensorMultiply3d{
+    DG_DEVICE
+    void operator() ( value_type lambda,
+                      value_type t00, value_type t11, value_type t22,
+                      value_type in0, value_type in1, value_type in2,
+                      value_type mu,
+                      value_type& out0, value_type& out1, value_type& out2) const
+    {
+        out2 = DG_FMA( lambda, t22*in2, out2*mu);
+        out1 = DG_FMA( lambda, t11*in1, out1*mu);
+        out0 = DG_FMA( lambda, t00*in0, out0*mu);
+    }
+};
 /// \f$ y_i \leftarrow \lambda T^{-1}_{ij} x_i + \mu y_i\f$
 template<class value_type>
 struct InverseTensorMultiply2d{
@@ -155,6 +205,40 @@ struct TensorDot3d{
     }
 };
 
+/// \f$ y = \lambda \sum_i T_{ij} w_j \f$ (contract and sum the components)
+template<class value_type>
+struct TensorSum2d{
+    DG_DEVICE
+    value_type operator() (
+              value_type lambda,
+              value_type t00, value_type t01,
+              value_type t10, value_type t11,
+              value_type w0, value_type w1
+              ) const
+    {
+        value_type tmp0 = DG_FMA(t00,w0 , t01*w1);
+        value_type tmp1 = DG_FMA(t10,w0 , t11*w1);
+        return lambda*(tmp0+tmp1);
+    }
+};
+/// \f$ y = \lambda \sum_i T_{ij} w_j \f$ (contract and sum the components)
+template<class value_type>
+struct TensorSum3d{
+    DG_DEVICE
+    value_type operator() (
+              value_type lambda,
+              value_type t00, value_type t01, value_type t02,
+              value_type t10, value_type t11, value_type t12,
+              value_type t20, value_type t21, value_type t22,
+              value_type w0, value_type w1, value_type w2) const
+    {
+        value_type tmp0 = DG_FMA( t00,w0 , (DG_FMA( t01,w1 , t02*w2)));
+        value_type tmp1 = DG_FMA( t10,w0 , (DG_FMA( t11,w1 , t12*w2)));
+        value_type tmp2 = DG_FMA( t20,w0 , (DG_FMA( t21,w1 , t22*w2)));
+        return lambda*(tmp0+tmp1+tmp2);
+    }
+};
+
 ///\f$ y = t_{00} t_{11} - t_{10}t_{01} \f$
 template<class value_type>
 struct TensorDeterminant2d
@@ -224,11 +308,22 @@ void scal( SparseTensor<ContainerType0>& t, const ContainerType1& mu)
  * @param out0 (output) first component  of \c w (may alias in0)
  * @param out1 (output) second component of \c w (may alias in1)
  * @note This function is just a shortcut for a call to \c dg::blas1::subroutine with \c dg::TensorMultiply2d
+ * @note Elements with value index 0 are taken as structurally zero (the
+ * convention of the \c SparseTensor constructors): if both off-diagonal
+ * elements have index 0 a diagonal kernel is used that does not load them
  * @copydoc hide_ContainerType
  */
 template<class ContainerTypeL, class ContainerType0, class ContainerType1, class ContainerType2, class ContainerTypeM, class ContainerType3, class ContainerType4>
 void multiply2d( const ContainerTypeL& lambda, const SparseTensor<ContainerType0>& t, const ContainerType1& in0, const ContainerType2& in1, const ContainerTypeM& mu, ContainerType3& out0, ContainerType4& out1)
 {
+    if( t.idx(0,1) == 0 && t.idx(1,0) == 0)
+    {
+        dg::blas1::subroutine( dg::DiagonalTensorMultiply2d<get_value_type<ContainerType0>>(),
+                lambda,      t.value(0,0), t.value(1,1),
+                             in0,  in1,
+                mu,          out0, out1);
+        return;
+    }
     dg::blas1::subroutine( dg::TensorMultiply2d<get_value_type<ContainerType0>>(),
             lambda,      t.value(0,0), t.value(0,1),
                          t.value(1,0), t.value(1,1),
@@ -250,11 +345,31 @@ void multiply2d( const ContainerTypeL& lambda, const SparseTensor<ContainerType0
  * @param out1 (output)  second component of \c w (may alias in1)
  * @param out2 (output)  third component of \c w  (may alias in2)
  * @note This function is just a shortcut for a call to \c dg::blas1::subroutine with \c dg::TensorMultiply3d
+ * @note Elements with value index 0 are taken as structurally zero (the
+ * convention of the \c SparseTensor constructors): if the third row and
+ * column couplings have index 0 (as in any product geometry) the loads of
+ * these elements are skipped, and a diagonal tensor uses a kernel that only
+ * loads the diagonal
  * @copydoc hide_ContainerType
  */
 template<class ContainerTypeL, class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3, class ContainerTypeM, class ContainerType4, class ContainerType5, class ContainerType6>
 void multiply3d( const ContainerTypeL& lambda, const SparseTensor<ContainerType0>& t, const ContainerType1& in0, const ContainerType2& in1, const ContainerType3& in2, const ContainerTypeM& mu, ContainerType4& out0, ContainerType5& out1, ContainerType6& out2)
 {
+    if( t.idx(0,2) == 0 && t.idx(2,0) == 0 && t.idx(1,2) == 0 && t.idx(2,1) == 0)
+    {
+        if( t.idx(0,1) == 0 && t.idx(1,0) == 0)
+            dg::blas1::subroutine( dg::DiagonalTensorMultiply3d<get_value_type<ContainerType0>>(),
+                    lambda,      t.value(0,0), t.value(1,1), t.value(2,2),
+                                 in0, in1, in2,
+                    mu,          out0, out1, out2);
+        else
+            dg::blas1::subroutine( dg::PerpTensorMultiply3d<get_value_type<ContainerType0>>(),
+                    lambda,      t.value(0,0), t.value(0,1),
+                                 t.value(1,0), t.value(1,1), t.value(2,2),
+                                 in0, in1, in2,
+                    mu,          out0, out1, out2);
+        return;
+    }
     dg::blas1::subroutine( dg::TensorMultiply3d<get_value_type<ContainerType0>>(),
             lambda,      t.value(0,0), t.value(0,1), t.value(0,2),
                          t.value(1,0), t.value(1,1), t.value(1,2),
@@ -574,6 +689,85 @@ void scalar_product3d(
             mu,
             w0, w1, w2);
 }
+
+/**
+ * @brief \f$ y = \alpha \lambda \sum_{i=0}^1\sum_{j=0}^1 t^{ij}w_j + \beta y \f$
+ *
+ * Contract the tensor with a vector and accumulate the sum of the resulting
+ * components in a single pass. Ignore the 3rd dimension in \c t.
+ * This fuses a call to \c multiply2d with the subsequent
+ * \c dg::blas1::axpbypgz accumulation, which saves the write and re-read of
+ * the two component arrays, e.g. when the tensor-weighted jump contributions
+ * of \c dg::Elliptic are added to the divergence.
+ * @param alpha scalar input prefactor
+ * @param lambda input prefactor (may be a vector or an actual number like 0 or 1)
+ * @param t input Tensor
+ * @param w0 (input) first component  of \c w
+ * @param w1 (input) second component of \c w
+ * @param beta scalar output prefactor
+ * @param y (output)
+ * @note This function is just a shortcut for a call to \c dg::blas1::evaluate with \c dg::TensorSum2d
+ * @copydoc hide_ContainerType
+ */
+template<class ContainerTypeL, class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3>
+void multiply_sum2d(
+        get_value_type<ContainerType0> alpha,
+        const ContainerTypeL& lambda,
+        const SparseTensor<ContainerType0>& t,
+        const ContainerType1& w0,
+        const ContainerType2& w1,
+        get_value_type<ContainerType0> beta,
+        ContainerType3& y)
+{
+    dg::blas1::evaluate( y,
+             dg::Axpby<get_value_type<ContainerType0>>( alpha, beta),
+             dg::TensorSum2d<get_value_type<ContainerType0>>(),
+             lambda,
+             t.value(0,0), t.value(0,1),
+             t.value(1,0), t.value(1,1),
+             w0, w1);
+}
+
+/**
+ * @brief \f$ y = \alpha \lambda \sum_{i=0}^2\sum_{j=0}^2 t^{ij}w_j + \beta y \f$
+ *
+ * Contract the tensor with a vector and accumulate the sum of the resulting
+ * components in a single pass.
+ * This fuses a call to \c multiply3d with the subsequent
+ * \c dg::blas1::axpbypgz accumulation, which saves the write and re-read of
+ * the three component arrays, e.g. when the tensor-weighted jump
+ * contributions of \c dg::Elliptic3d are added to the divergence.
+ * @param alpha scalar input prefactor
+ * @param lambda input prefactor (may be a vector or an actual number like 0 or 1)
+ * @param t input Tensor
+ * @param w0 (input) first component  of \c w
+ * @param w1 (input) second component of \c w
+ * @param w2 (input) third component  of \c w
+ * @param beta scalar output prefactor
+ * @param y (output)
+ * @note This function is just a shortcut for a call to \c dg::blas1::evaluate with \c dg::TensorSum3d
+ * @copydoc hide_ContainerType
+ */
+template<class ContainerTypeL, class ContainerType0, class ContainerType1, class ContainerType2, class ContainerType3, class ContainerType4>
+void multiply_sum3d(
+        get_value_type<ContainerType0> alpha,
+        const ContainerTypeL& lambda,
+        const SparseTensor<ContainerType0>& t,
+        const ContainerType1& w0,
+        const ContainerType2& w1,
+        const ContainerType3& w2,
+        get_value_type<ContainerType0> beta,
+        ContainerType4& y)
+{
+    dg::blas1::evaluate( y,
+            dg::Axpby<get_value_type<ContainerType0>>( alpha, beta),
+            dg::TensorSum3d<get_value_type<ContainerType0>>(),
+            lambda,
+            t.value(0,0), t.value(0,1), t.value(0,2),
+            t.value(1,0), t.value(1,1), t.value(1,2),
+            t.value(2,0), t.value(2,1), t.value(2,2),
+            w0, w1, w2);
+}
 ///@}
 
 }//namespace tensor
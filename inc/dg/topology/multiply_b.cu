@@ -44,5 +44,21 @@ int main()
         dg::tensor::multiply2d( 1., g, v_x, v_y, 0., w_x, w_y);
     t.toc();
     std::cout<<"multiply2d(g,v_x,v_y,w_x,w_y) took    "<<t.diff()/multi<<"s\t"<<9*gbytes*multi/t.diff()<<"GB/s\n";
+
+    //contract-then-reduce: unfused vs fused
+    Vector y = dg::evaluate( dg::CONSTANT(1), grid);
+    t.tic();
+    for( int i=0; i<multi; i++)
+    {
+        dg::tensor::multiply2d( 1., g, v_x, v_y, 0., w_x, w_y);
+        dg::blas1::axpbypgz( 1., w_x, 1., w_y, 1., y);
+    }
+    t.toc();
+    std::cout<<"multiply2d + axpbypgz took            "<<t.diff()/multi<<"s\t"<<13*gbytes*multi/t.diff()<<"GB/s\n";
+    t.tic();
+    for( int i=0; i<multi; i++)
+        dg::tensor::multiply_sum2d( 1., g, v_x, v_y, 1., y);
+    t.toc();
+    std::cout<<"multiply_sum2d(g,v_x,v_y,y) took      "<<t.diff()/multi<<"s\t"<<7*gbytes*multi/t.diff()<<"GB/s\n";
     return 0;
 }
@@ -50,6 +50,10 @@ int main()
     inout0 = eight;
     dg::tensor::scalar_product2d( 1., 2., one, two, t, 2., eight, nine, 1., inout0);
     std::cout << "Result         is "<<inout0[0]<<" (1312)\n";
+    std::cout << "Multiply sum 2d\n";
+    inout0 = eight;
+    dg::tensor::multiply_sum2d( 1., two, t, eight, nine, 1., inout0);
+    std::cout << "Result         is "<<inout0[0]<<" (420)\n";
     std::cout << "Multiply T^{-1} with [86,120]\n";
     dg::tensor::inv_multiply2d(1., t, work0, work1, 0., work0, work1);
     std::cout << "Result         is ["<<work0[0]<<" "<<work1[0]<<"] ([8 9])\n";
@@ -64,6 +68,10 @@ int main()
     inout0 = eight;
     dg::tensor::scalar_product3d( 1., 3., one, two,three, t, 3., 8.,9.,2., -100., inout0);
     std::cout << "Result         is "<<inout0[0]<<" (3034)\n";
+    std::cout << "Multiply sum 3d\n";
+    inout0 = eight;
+    dg::tensor::multiply_sum3d( 1., three, t, 8., 9., 2., -100., inout0);
+    std::cout << "Result         is "<<inout0[0]<<" (-122)\n";
     std::cout << "Multiply T^{-1} with [102,48,76]\n";
     dg::tensor::inv_multiply3d(1., t, work0, work1, work2, 0., work0, work1, work2);
     std::cout << "Result         is ["<<work0[0]<<" "<<work1[0]<<" "<<work2[0]<<"] ([8 9 2])\n";
@@ -382,20 +382,24 @@ T lu_pivot( dg::Operator<T>& m, std::vector<unsigned>& p)
     unsigned pivotzeile, numberOfSwaps=0;
     const size_t n = m.size();
     p.resize( n);
+    //fixed capacity work space: the inner loops only shrink or grow within
+    //the reserved capacity and thus never allocate
+    thrust::host_vector<T> mik, mkj;
+    mik.reserve( n), mkj.reserve( n);
     for( size_t j = 0; j < n; j++) //gehe Spalten /Diagonale durch
     {
         //compute upper matrix except for the diagonal element (the pivot)
         for( size_t i = 0; i< j; i++)
         {
-            thrust::host_vector<T> mik(i), mkj(i);
+            mik.resize(i), mkj.resize(i);
             for( size_t k=0; k<i; k++)
                 mik[k] = m(i,k), mkj[k] = m(k,j);
             m(i,j) -= dg::blas1::dot( mik, mkj);
         }
         //compute canditates for pivot elements
+        mik.resize(j), mkj.resize(j);
         for( size_t i = j; i< n; i++)
         {
-            thrust::host_vector<T> mik(j), mkj(j);
             for( size_t k=0; k<j; k++)
                 mik[k] = m(i,k), mkj[k] = m(k,j);
             m(i,j) -= dg::blas1::dot( mik, mkj);
@@ -446,12 +450,15 @@ void lu_solve( const dg::Operator<T>& lu, const std::vector<unsigned>& p, std::v
 {
     assert(p.size() == lu.size() && p.size() == b.size());
     const size_t n = p.size();
+    //fixed capacity work space (see dg::create::lu_pivot)
+    thrust::host_vector<T> lui, bi;
+    lui.reserve( n), bi.reserve( n);
     // Vorwärtseinsetzen
     for( size_t i = 0; i<n; i++)
     {
         //mache Zeilentausch
         std::swap( b[ p[i] ], b[i]);
-        thrust::host_vector<T> lui(i), bi(i);
+        lui.resize(i), bi.resize(i);
         for( size_t j = 0; j < i; j++)
             lui[j] = lu(i,j), bi[j] = b[j];
         b[i] -= dg::blas1::dot( lui, bi);
@@ -459,7 +466,7 @@ void lu_solve( const dg::Operator<T>& lu, const std::vector<unsigned>& p, std::v
     // Rückwärtseinsetzen
     for( int i = n-1; i>=0; i--)
     {
-        thrust::host_vector<T> lui(n-(i+1)), bi(n-(i+1));
+        lui.resize(n-(i+1)), bi.resize(n-(i+1));
         for( size_t j = i+1; j < n; j++)
             lui[j-(i+1)] = lu(i,j), bi[j-(i+1)] = b[j];
         b[i] -= dg::blas1::dot( lui, bi);
@@ -489,9 +496,10 @@ dg::Operator<T> inverse( const dg::Operator<T>& in)
     T determinant = lu_pivot( lu, pivot);
     if( fabs(determinant ) < 1e-14)
         throw std::runtime_error( "Determinant zero!");
+    std::vector<T> unit( n);
     for( unsigned i=0; i<n; i++)
     {
-        std::vector<T> unit(n, 0);
+        unit.assign( n, 0);
         unit[i] = 1;
         lu_solve( lu, pivot, unit);
         for( unsigned j=0; j<n; j++)
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <sstream>
+#include "grid.h"
+#include "operator.h"
+
+/*! @file
+  @brief A process-wide cache for transformation plans
+  */
+namespace dg{
+namespace create{
+///@cond
+namespace detail{
+//one cache per cached matrix type
+template<class MatrixType>
+std::map<std::string, MatrixType>& plan_cache()
+{
+    static std::map<std::string, MatrixType> cache;
+    return cache;
+}
+}//namespace detail
+///@endcond
+
+///@addtogroup misc
+///@{
+/**
+ * @brief A string that uniquely identifies the shape of a grid
+ *
+ * Contains the boundaries, the number of polynomial coefficients, the
+ * number of cells and the boundary conditions in full (hexadecimal)
+ * precision; two grids have the same signature exactly if vectors and
+ * matrices created on them are interchangeable. Use as (part of) a key in
+ * \c dg::create::cached_plan
+ */
+template<class real_type>
+std::string grid_signature( const RealGrid1d<real_type>& g)
+{
+    std::ostringstream out;
+    out << std::hexfloat << "g1d:"<<g.x0()<<","<<g.x1()<<","<<g.n()<<","
+        <<g.N()<<","<<(int)g.bcx();
+    return out.str();
+}
+///@copydoc grid_signature(const RealGrid1d<real_type>&)
+template<class real_type>
+std::string grid_signature( const aRealTopology2d<real_type>& g)
+{
+    return "g2d:"+grid_signature( g.gx())+";"+grid_signature( g.gy());
+}
+///@copydoc grid_signature(const RealGrid1d<real_type>&)
+template<class real_type>
+std::string grid_signature( const aRealTopology3d<real_type>& g)
+{
+    return "g3d:"+grid_signature( g.gx())+";"+grid_signature( g.gy())
+        +";"+grid_signature( g.gz());
+}
+///@brief The signature of a dense block operator (e.g. from \c dg::create::modal_filter )
+///@copydetails grid_signature(const RealGrid1d<real_type>&)
+template<class real_type>
+std::string op_signature( const dg::Operator<real_type>& op)
+{
+    std::ostringstream out;
+    out << std::hexfloat << "op:"<<op.size();
+    for( unsigned i=0; i<op.size(); i++)
+        for( unsigned j=0; j<op.size(); j++)
+            out << ","<<op(i,j);
+    return out.str();
+}
+
+/**
+ * @brief Get a transformation plan from the process-wide cache
+ *
+ * Creation functions like \c dg::create::backscatter or \c
+ * dg::create::fast_transform assemble the same matrices again on every
+ * call, which dominates the runtime when many same-shape records are
+ * transformed one after the other (e.g. in the diagnostics tools). In the
+ * manner of FFTW plans this function keeps one cache per matrix type for
+ * the lifetime of the process: the generator only runs when the signature
+ * is seen for the first time, afterwards the stored plan is returned.
+ * @code{.cpp}
+// repeated calls only pay the creation cost once:
+const auto& scatter = dg::create::cached_plan<dg::IHMatrix>(
+    "backscatter:"+dg::create::grid_signature( grid),
+    [&](){ return dg::create::backscatter( grid);});
+ * @endcode
+ * @tparam MatrixType the type of the cached plan
+ * @param signature uniquely identifies the plan among all plans of
+ * \c MatrixType (use \c grid_signature plus a name of the creator and any
+ * further parameters)
+ * @param generate called without arguments to create the plan on a cache
+ * miss; must return a \c MatrixType
+ * @return reference to the cached plan (valid until \c release_plans)
+ * @attention the cache trades memory for setup time; call \c release_plans
+ * if the grids of a program change often
+ */
+template<class MatrixType, class Generator>
+const MatrixType& cached_plan( const std::string& signature, Generator&& generate)
+{
+    auto& cache = detail::plan_cache<MatrixType>();
+    auto it = cache.find( signature);
+    if( it == cache.end())
+        it = cache.emplace( signature, generate()).first;
+    return it->second;
+}
+
+///@brief Release all cached plans of the given matrix type
+///@tparam MatrixType the type given to \c cached_plan
+template<class MatrixType>
+void release_plans()
+{
+    detail::plan_cache<MatrixType>().clear();
+}
+///@}
+
+}//namespace create
+}//namespace dg
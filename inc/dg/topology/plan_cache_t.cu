@@ -0,0 +1,37 @@
+#include <iostream>
+
+#include "plan_cache.h"
+#include "xspacelib.h"
+
+int main()
+{
+    std::cout << "Program to test the transform plan cache\n";
+    dg::Grid2d g2d( 0., 1., 0., 1., 3, 20, 20);
+    dg::Grid2d g2d_eq( 0., 1., 0., 1., 3, 20, 20);
+    dg::Grid2d g2d_ne( 0., 1., 0., 1., 3, 20, 40);
+    std::cout << "Signature: "<<dg::create::grid_signature( g2d)<<"\n";
+    std::cout << "Equal grids give equal signatures:    "
+        <<( dg::create::grid_signature( g2d) == dg::create::grid_signature( g2d_eq))
+        <<" (1)\n";
+    std::cout << "Unequal grids give unequal signatures: "
+        <<( dg::create::grid_signature( g2d) != dg::create::grid_signature( g2d_ne))
+        <<" (1)\n";
+
+    unsigned calls = 0;
+    auto generate = [&calls](){ calls++; return dg::create::backscatter(
+        dg::Grid2d( 0., 1., 0., 1., 3, 20, 20));};
+    const auto& first = dg::create::cached_plan<dg::IHMatrix>( "test", generate);
+    const auto& second = dg::create::cached_plan<dg::IHMatrix>( "test", generate);
+    std::cout << "Generator ran once:  "<<( calls == 1)<<" (1)\n";
+    std::cout << "Same plan returned:  "<<( &first == &second)<<" (1)\n";
+    dg::create::release_plans<dg::IHMatrix>();
+    dg::create::cached_plan<dg::IHMatrix>( "test", generate);
+    std::cout << "Release empties the cache: "<<( calls == 2)<<" (1)\n";
+
+    //the creation functions use the cache themselves
+    const auto& b0 = dg::create::backscatter( g2d);
+    const auto& b1 = dg::create::backscatter( g2d_eq);
+    std::cout << "backscatter plan cached:   "<<( &b0 == &b1)<<" (1)\n";
+
+    return 0;
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <cusp/coo_matrix.h>
 #include <cusp/transpose.h>
@@ -197,6 +199,68 @@ cusp::coo_matrix< int, real_type, cusp::host_memory> transformation( const RealG
     Y.sort_by_row_and_column();
     return Y;
 }
+
+///@cond
+namespace detail
+{
+//funnel the admissible matrix types of a composition chain into csr format
+template<class real_type>
+dg::IHMatrix_t<real_type> doComposeConvert( const dg::EllSparseBlockMat<real_type>& m)
+{
+    return (dg::IHMatrix_t<real_type>)m.asCuspMatrix();
+}
+template<class real_type>
+dg::IHMatrix_t<real_type> doComposeConvert( const cusp::coo_matrix<int, real_type, cusp::host_memory>& m)
+{
+    return (dg::IHMatrix_t<real_type>)m;
+}
+template<class real_type>
+const dg::IHMatrix_t<real_type>& doComposeConvert( const dg::IHMatrix_t<real_type>& m)
+{
+    return m;
+}
+}//namespace detail
+///@endcond
+
+/*! @brief \f$ M = M_l M_r\f$ Multiply two sparse matrices at setup time
+ *
+ * A fixed chain of matrices (like project - derive - interpolate) that is
+ * applied many times is cheaper preassembled into a single sparse matrix
+ * (one sparse matrix-matrix multiplication per composition at setup) than
+ * applied matrix by matrix with intermediate vectors at every use.
+ * The result is an ordinary \c dg::IHMatrix_t that drops into
+ * \c dg::blas2::symv (or converts to its device counterpart) like any other
+ * creation function result.
+ * @param left the left (outer, applied last) matrix
+ * @param right the right (inner, applied first) matrix
+ * @return the composition \c left*right in csr format
+ * @note admissible argument types are \c dg::EllSparseBlockMat (e.g. the
+ * derivative creation functions) and cusp host matrices in coo or csr
+ * format (e.g. the interpolation/projection creation functions); the value
+ * types must match
+ * @tparam MatrixLeft,MatrixRight one of the admissible matrix types
+ */
+template<class MatrixLeft, class MatrixRight>
+auto compose( const MatrixLeft& left, const MatrixRight& right)
+{
+    const auto& l = detail::doComposeConvert( left);
+    const auto& r = detail::doComposeConvert( right);
+    std::decay_t<decltype(detail::doComposeConvert(left))> out;
+    cusp::multiply( l, r, out);
+    return out;
+}
+/*! @brief \f$ M = M_1 M_2 \cdots M_n \f$ Multiply a chain of sparse matrices at setup time
+ *
+ * The chain is composed right to left, i.e. in the order the matrices are
+ * applied to a vector
+ * @copydetails compose(const MatrixLeft&,const MatrixRight&)
+ */
+template<class MatrixLeft, class MatrixRight, class MatrixThird, class ...Matrices>
+auto compose( const MatrixLeft& left, const MatrixRight& second,
+    const MatrixThird& third, const Matrices& ...rest)
+{
+    return compose( left, compose( second, third, rest...));
+}
 ///@}
 ///@addtogroup scatter
 ///@{
@@ -287,6 +351,118 @@ dg::IHMatrix_t<real_type> inv_backproject( const aRealTopology3d<real_type>& g)
     return dg::tensorproduct( transformZ, dg::tensorproduct(transformY, transformX));
 }
 
+///@cond
+namespace detail
+{
+//interleave the bits of x and y (the Morton or z-curve cell key)
+inline uint64_t morton_key( unsigned x, unsigned y)
+{
+    uint64_t key = 0;
+    for( unsigned b=0; b<32; b++)
+        key |= ((uint64_t)((x>>b)&1)<<(2*b)) | ((uint64_t)((y>>b)&1)<<(2*b+1));
+    return key;
+}
+//new index -> old (lexicographic) index of the morton ordered plane
+inline std::vector<int> morton_map( unsigned nx, unsigned ny, unsigned Nx, unsigned Ny)
+{
+    std::vector<std::pair<uint64_t, std::pair<unsigned,unsigned>>> cells;
+    for( unsigned iy=0; iy<Ny; iy++)
+    for( unsigned ix=0; ix<Nx; ix++)
+        cells.push_back( { morton_key( ix, iy), {ix,iy}});
+    std::sort( cells.begin(), cells.end());
+    std::vector<int> map( nx*ny*Nx*Ny);
+    for( unsigned c=0; c<cells.size(); c++)
+    {
+        unsigned ix = cells[c].second.first, iy = cells[c].second.second;
+        for( unsigned ky=0; ky<ny; ky++)
+        for( unsigned kx=0; kx<nx; kx++)
+            map[ (c*ny + ky)*nx + kx] = ((iy*ny + ky)*Nx + ix)*nx + kx;
+    }
+    return map;
+}
+template<class real_type>
+dg::IHMatrix_t<real_type> morton_matrix( const std::vector<int>& map, unsigned planes)
+{
+    unsigned size = map.size();
+    cusp::coo_matrix<int, real_type, cusp::host_memory> A( planes*size,
+            planes*size, planes*size);
+    for( unsigned z=0; z<planes; z++)
+        for( unsigned i=0; i<size; i++)
+        {
+            A.row_indices[z*size+i] = z*size + i;
+            A.column_indices[z*size+i] = z*size + map[i];
+            A.values[z*size+i] = 1.;
+        }
+    return (dg::IHMatrix_t<real_type>)A;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Create the permutation \f$ P\f$ into a cache friendly Morton (z-curve) ordered layout
+ *
+ * The lexicographic layout of \c dg::evaluate places the cells of a row
+ * next to each other, so the y-neighbours of a 2d stencil lie a full row
+ * apart and fall out of cache for large \c Nx. The returned permutation
+ * reorders the cells along a Morton space filling curve (cells are sorted by
+ * their bit-interleaved \f$ (i_x,i_y)\f$ key, which also covers non-power-of-two
+ * grids) and in addition makes the \f$ n_x n_y\f$ polynomial coefficients of
+ * each cell contiguous, such that x- and y-neighbours stay close in memory.
+ *
+ * Intended for CPU (shared memory) runs where the 2d stencil bandwidth is
+ * limited by cache misses. Reorder vectors and weights with
+ * <tt>dg::blas2::symv( P, v, v_m)</tt> and conjugate setup-time matrices into
+ * the new layout with the matrix chain
+ * <tt>dg::create::compose( P, A, Pinv)</tt>; the result is a regular sparse
+ * matrix that works transparently in \c dg::blas2::symv through
+ * \c TensorTraits. Scalar products and pointwise operations are order
+ * invariant and need no conversion.
+ * @note The permutation is orthogonal, its inverse equals its transpose
+ * (see \c dg::create::inv_morton_reorder)
+ * @param g The grid that defines the lexicographic layout
+ *
+ * @return permutation matrix from lexicographic to Morton order
+ * @sa dg::create::compose
+ */
+template<class real_type>
+dg::IHMatrix_t<real_type> morton_reorder( const aRealTopology2d<real_type>& g)
+{
+    auto map = detail::morton_map( g.nx(), g.ny(), g.Nx(), g.Ny());
+    return detail::morton_matrix<real_type>( map, 1);
+}
+
+///@copydoc morton_reorder(const aRealTopology2d<real_type>&)
+///@note In 3d the xy planes are reordered independently, the z direction
+///remains outermost (the layout of choice for the per-plane 2d stencils)
+template<class real_type>
+dg::IHMatrix_t<real_type> morton_reorder( const aRealTopology3d<real_type>& g)
+{
+    auto map = detail::morton_map( g.nx(), g.ny(), g.Nx(), g.Ny());
+    return detail::morton_matrix<real_type>( map, g.nz()*g.Nz());
+}
+
+/**
+ * @brief Create the permutation \f$ P^\mathrm{T} = P^{-1}\f$ back from the Morton ordered layout
+ *
+ * @copydetails morton_reorder(const aRealTopology2d<real_type>&)
+ */
+template<class real_type>
+dg::IHMatrix_t<real_type> inv_morton_reorder( const aRealTopology2d<real_type>& g)
+{
+    dg::IHMatrix_t<real_type> inv;
+    cusp::transpose( morton_reorder( g), inv);
+    return inv;
+}
+
+///@copydoc inv_morton_reorder(const aRealTopology2d<real_type>&)
+template<class real_type>
+dg::IHMatrix_t<real_type> inv_morton_reorder( const aRealTopology3d<real_type>& g)
+{
+    dg::IHMatrix_t<real_type> inv;
+    cusp::transpose( morton_reorder( g), inv);
+    return inv;
+}
+
 ///@}
 
 }//namespace create
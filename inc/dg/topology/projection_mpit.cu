@@ -97,6 +97,15 @@ int main(int argc, char* argv[])
     dg::blas2::gemv( project2dg, sinOg, sinNg);
     value1 = sqrt( dg::blas2::dot( sinNg, w2dng, sinNg));
     if(rank==0)std::cout << "MPI Projection   : difference in Norms "<<value0 - value1 << "\n" << std::endl;
+    ///%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%//
+    if(rank==0)std::cout << "TEST repartition \n";
+    dg::MPIGrid3d g2r = dg::repartition( g2o, {4,1,1});
+    const dg::MHVec sinR = dg::evaluate( sine, g2r);
+    dg::MHVec sinM = dg::repartition( sinO, g2o, g2r);
+    dg::blas1::axpby( 1., sinR, -1., sinM);
+    const dg::MHVec w2dr = dg::create::weights( g2r);
+    value0 = sqrt( dg::blas2::dot( sinM, w2dr, sinM));
+    if(rank==0)std::cout << "Repartition Error "<<value0 << " (Must be zero)\n" << std::endl;
 
     MPI_Finalize();
     return 0;
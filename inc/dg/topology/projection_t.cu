@@ -96,6 +96,29 @@ int main()
         value2 = sqrt(dg::blas2::dot( sinI, w2do, sinI));
         std::cout << "Forward-Backward Error   "<<value2 << " (Must be zero)\n" << std::endl;
     }
+    std::cout << "TEST rational transfer\n";
+    {
+        dg::Grid1d go ( 0, M_PI/2., 3, 30);
+        dg::Grid1d gn ( 0, M_PI/2., 2, 20);
+        auto trafo = dg::create::fast_transfer( go, gn);
+        dg::HVec v = dg::evaluate( sine, go), w( gn.size());
+        dg::HVec w1do = dg::create::weights( go);
+        dg::HVec w1dn = dg::create::weights( gn);
+        dg::blas2::symv( trafo, v, w);
+        std::cout << "Original vector  "<<dg::blas1::dot( w1do, v) << "\n";
+        std::cout << "Transferred vec  "<<dg::blas1::dot( w1dn, w) << "\n";
+        std::cout << "Difference       "<<dg::blas1::dot( w1do, v) - dg::blas1::dot( w1dn, w) << " (Must be 0)\n"<<std::endl;
+        dg::Grid2d g2o (0, M_PI, 0, M_PI, 3, 30, 20);
+        dg::Grid2d g2n (0, M_PI, 0, M_PI, 3, 20, 30);
+        auto trafo2d = dg::create::fast_transfer( g2o, g2n);
+        dg::HVec v2 = dg::evaluate( sine, g2o), w2( g2n.size());
+        dg::HVec w2do = dg::create::weights( g2o);
+        dg::HVec w2dn = dg::create::weights( g2n);
+        dg::blas2::symv( trafo2d, v2, w2);
+        std::cout << "Original vector  "<<dg::blas1::dot( w2do, v2) << "\n";
+        std::cout << "Transferred vec  "<<dg::blas1::dot( w2dn, w2) << "\n";
+        std::cout << "Difference       "<<dg::blas1::dot( w2do, v2) - dg::blas1::dot( w2dn, w2) << " (Must be 0)\n"<<std::endl;
+    }
     std::cout << "Test backproject\n";
     unsigned n=3, N = 20;
     dg::Grid1d g1d( 0.0, M_PI+0.0, n, N, dg::DIR);
@@ -113,5 +136,57 @@ int main()
     dg::blas1::axpby( 1., v, -1., x);
     double err = dg::blas1::dot( x, x);
     std::cout << "Error is "<<sqrt(err)<<" (Must be zero)\n";
+    std::cout << "Test compose\n";
+    {
+        //preassemble a project - derive - interpolate chain and compare
+        //against the matrix by matrix application
+        dg::Grid2d gc (0, M_PI, 0, M_PI, 3, 20, 20, dg::DIR);
+        dg::Grid2d gf (0, M_PI, 0, M_PI, 3, 40, 40, dg::DIR);
+        cusp::coo_matrix<int, double, cusp::host_memory> inte =
+            dg::create::interpolation( gf, gc);
+        auto deri = dg::create::dx( gf, dg::DIR); //EllSparseBlockMat
+        dg::IHMatrix proje = dg::create::projection( gc, gf);
+        dg::IHMatrix chain = dg::create::compose( proje, deri, inte);
+        dg::HVec vc = dg::evaluate( sine, gc), vf( gf.size()), df( vf);
+        dg::HVec wc( vc), wc_chain( vc);
+        dg::blas2::symv( inte, vc, vf);
+        dg::blas2::symv( deri, vf, df);
+        dg::blas2::symv( proje, df, wc);
+        dg::blas2::symv( chain, vc, wc_chain);
+        dg::blas1::axpby( 1., wc, -1., wc_chain);
+        auto w2dc = dg::create::weights( gc);
+        err = sqrt( dg::blas2::dot( wc_chain, w2dc, wc_chain));
+        std::cout << "Error of preassembled chain is "<<err
+                  <<" (Must be zero up to rounding)\n";
+    }
+    std::cout << "Test morton reorder\n";
+    {
+        //non-power-of-two grid on purpose
+        dg::Grid2d g2 (0, M_PI, 0, M_PI, 3, 20, 12, dg::DIR);
+        dg::IHMatrix morton = dg::create::morton_reorder( g2);
+        dg::IHMatrix inv_morton = dg::create::inv_morton_reorder( g2);
+        dg::HVec v2 = dg::evaluate( sine, g2), vm( v2), vb( v2);
+        dg::blas2::symv( morton, v2, vm);
+        dg::blas2::symv( inv_morton, vm, vb);
+        dg::blas1::axpby( 1., v2, -1., vb);
+        double err = sqrt( dg::blas1::dot( vb, vb));
+        std::cout << "Error of inverse reorder is "<<err<<" (Must be zero)\n";
+        //weights reorder consistently: the scalar product is order invariant
+        auto w2 = dg::create::weights( g2), wm( w2);
+        dg::blas2::symv( morton, w2, wm);
+        err = dg::blas2::dot( v2, w2, v2) - dg::blas2::dot( vm, wm, vm);
+        std::cout << "Error of reordered dot is "<<err<<" (Must be zero)\n";
+        //conjugate the derivative into the morton layout at setup time
+        auto deri = dg::create::dx( g2, dg::DIR);
+        dg::IHMatrix deri_m = dg::create::compose( morton, deri, inv_morton);
+        dg::HVec d2( v2), dm( v2), dmb( v2);
+        dg::blas2::symv( deri, v2, d2);
+        dg::blas2::symv( deri_m, vm, dm);
+        dg::blas2::symv( inv_morton, dm, dmb);
+        dg::blas1::axpby( 1., d2, -1., dmb);
+        err = sqrt( dg::blas2::dot( dmb, w2, dmb));
+        std::cout << "Error of morton ordered derivative is "<<err
+                  <<" (Must be zero)\n";
+    }
     return 0;
 }
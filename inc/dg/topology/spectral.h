@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cusp/csr_matrix.h>
+#include "grid.h"
+#include "evaluation.h"
+#include "weights.h"
+#include "dg/blas1.h"
+#include "dg/blas2.h"
+#include "dg/backend/view.h"
+
+/*! @file
+  @brief In-situ poloidal spectra computations
+  */
+namespace dg{
+
+namespace create{
+/**
+ * @brief Projection onto the lowest Fourier modes in the y direction
+ *
+ * Create the sparse matrix that computes for every x point the first
+ * \c num_modes Fourier cosine and sine coefficients of a field along y
+ \f[ a_k(x) = \frac{2-\delta_{k0}}{L_y}\int_0^{L_y} f(x,y) \cos( 2\pi k
+     y/L_y) \mathrm{d}y,\qquad
+     b_k(x) = \frac{2}{L_y}\int_0^{L_y} f(x,y) \sin( 2\pi k y/L_y)
+     \mathrm{d}y \f]
+ * The integrals are computed with the Gauss-Legendre quadrature of the
+ * grid, which is exact for all modes the grid can resolve; an FFT does
+ * not apply to the non-equidistant dG nodes. The result vector has size
+ * <tt> 2*num_modes*nx </tt> and is ordered with x fastest: the first
+ * \c num_modes*nx entries are \f$ a_k(x)\f$, the second half
+ * \f$ b_k(x)\f$ (the \f$ b_0\f$ rows are empty).
+ * @note the cost of applying the matrix is \c 2*num_modes dG weighted
+ * reductions, so request only the modes you need
+ * @param g the 2d grid (the y direction should be periodic)
+ * @param num_modes number of poloidal modes \c k=0,...,num_modes-1
+ * @return transformation matrix (to be converted with \c
+ * dg::blas2::transfer for device application)
+ * @sa \c dg::SpectralY
+ * @ingroup utilities
+ */
+template<class real_type>
+cusp::csr_matrix<int, real_type, cusp::host_memory> spectraly(
+    const aRealTopology2d<real_type>& g, unsigned num_modes)
+{
+    const unsigned nxt = g.nx()*g.Nx(), nyt = g.ny()*g.Ny();
+    RealGrid1d<real_type> gy( g.y0(), g.y1(), g.ny(), g.Ny());
+    thrust::host_vector<real_type> absy = dg::evaluate( dg::cooX1d, gy);
+    thrust::host_vector<real_type> wy = dg::create::weights( gy);
+    cusp::csr_matrix<int, real_type, cusp::host_memory> A(
+        2*num_modes*nxt, g.size(), (2*num_modes-1)*nxt*nyt);
+    int counter = 0;
+    A.row_offsets[0] = 0;
+    for( unsigned s=0; s<2; s++) //cosine rows, then sine rows
+    for( unsigned k=0; k<num_modes; k++)
+    for( unsigned ix=0; ix<nxt; ix++)
+    {
+        unsigned row = (s*num_modes + k)*nxt + ix;
+        if( !(s==1 && k==0)) //the b_0 rows are empty
+        {
+            real_type norm = (k==0 ? 1. : 2.)/g.ly();
+            for( unsigned iy=0; iy<nyt; iy++)
+            {
+                real_type arg = 2.*M_PI*(real_type)k*(absy[iy]-g.y0())/g.ly();
+                A.column_indices[counter] = iy*nxt + ix;
+                A.values[counter] = norm*wy[iy]*( s==0 ? cos(arg) : sin(arg));
+                counter++;
+            }
+        }
+        A.row_offsets[row+1] = counter;
+    }
+    return A;
+}
+}//namespace create
+
+/**
+ * @brief In-situ poloidal power spectra with Welch averaging
+ *
+ * Computes the power \f$ P_k(x) = a_k^2(x) + b_k^2(x)\f$ of the lowest
+ * \c num_modes Fourier modes of a field along the (periodic) y direction
+ * of a 2d grid and accumulates the running average over all absorbed
+ * samples on the device. The intention is to compute fluctuation spectra
+ * in-situ during a simulation (absorbing a snapshot every N-th timestep
+ * acts as Welch averaging with the snapshots as windows) and write only
+ * the reduced, time-averaged spectra instead of the full 3d fields:
+ * @code{.cpp}
+dg::SpectralY<dg::IDMatrix, dg::DVec> spec( grid2d, 16);
+// in the timeloop, for a poloidal plane f of a selected field
+spec.accumulate( f);
+// at output time: spec.spectrum() has size 16*nx, average over x or
+// write as is, then spec.flush()
+ * @endcode
+ * Fields on 3d grids can be processed plane-wise with \c dg::split.
+ * @tparam MatrixType the matrix class to apply the mode projection with
+ * (e.g. \c dg::IDMatrix)
+ * @copydoc hide_ContainerType
+ * @sa \c dg::create::spectraly \c dg::RunningStatistics
+ * @ingroup utilities
+ */
+template<class MatrixType, class ContainerType>
+struct SpectralY
+{
+    using matrix_type = MatrixType;
+    using container_type = ContainerType;
+    using value_type = get_value_type<ContainerType>;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    SpectralY() = default;
+    /**
+     * @brief Allocate memory and create the mode projection
+     * @param g the 2d grid of the samples (the y direction should be
+     * periodic)
+     * @param num_modes number of poloidal modes \c k=0,...,num_modes-1
+     */
+    template<class real_type>
+    SpectralY( const aRealTopology2d<real_type>& g, unsigned num_modes):
+        m_num_modes( num_modes), m_nxt( g.nx()*g.Nx())
+    {
+        dg::blas2::transfer( dg::create::spectraly( g, num_modes), m_dft);
+        thrust::host_vector<value_type> t( num_modes*m_nxt, 0.);
+        m_spec = m_avg = dg::construct<ContainerType>( t);
+        t.resize( 2*num_modes*m_nxt);
+        m_coeffs = dg::construct<ContainerType>( t);
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        *this = SpectralY( std::forward<Params>( ps)...);
+    }
+    ///@brief number of poloidal modes
+    unsigned num_modes() const{ return m_num_modes;}
+    /**
+     * @brief Compute the Fourier coefficients of a single field
+     * @param f the field on the grid given in the constructor
+     * @param coeffs coefficients in the layout of \c dg::create::spectraly
+     * (size \c 2*num_modes*nx )
+     */
+    void transform( const ContainerType& f, ContainerType& coeffs) const
+    {
+        dg::blas2::symv( m_dft, f, coeffs);
+    }
+    /**
+     * @brief Absorb a sample into the average power spectrum
+     * @param f the field on the grid given in the constructor
+     */
+    void accumulate( const ContainerType& f)
+    {
+        dg::blas2::symv( m_dft, f, m_coeffs);
+        unsigned size = m_num_modes*m_nxt;
+        const value_type* ptr = thrust::raw_pointer_cast( m_coeffs.data());
+        dg::View<const ContainerType> a( ptr, size), b( ptr+size, size);
+        dg::blas1::pointwiseDot( 1., a, a, 0., m_spec);
+        dg::blas1::pointwiseDot( 1., b, b, 1., m_spec);
+        m_count++;
+        value_type inv_n = (value_type)1/(value_type)m_count;
+        dg::blas1::axpby( inv_n, m_spec, 1.-inv_n, m_avg);
+    }
+    ///@brief The number of samples absorbed since the last \c flush
+    unsigned long count() const{ return m_count;}
+    /**
+     * @brief The average power spectrum of all absorbed samples
+     * @return vector of size \c num_modes*nx containing \f$ P_k(x)\f$
+     * with x fastest
+     */
+    const ContainerType& spectrum() const{ return m_avg;}
+    ///@brief Reset the average spectrum to zero
+    void flush()
+    {
+        dg::blas1::copy( 0., m_avg);
+        m_count = 0;
+    }
+    private:
+    MatrixType m_dft;
+    ContainerType m_coeffs, m_spec, m_avg;
+    unsigned m_num_modes, m_nxt;
+    unsigned long m_count = 0;
+};
+
+}//namespace dg
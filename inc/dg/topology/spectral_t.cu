@@ -0,0 +1,60 @@
+#include <iostream>
+#include <cmath>
+
+#include "dg/blas.h"
+#include "spectral.h"
+#include "evaluation.h"
+
+double function( double x, double y){
+    return 0.5 + cos(x)*cos(y) + sin(2.*y);
+}
+
+int main()
+{
+    std::cout << "Program to test the poloidal spectra computations\n";
+    unsigned n = 3, Nx = 16, Ny = 16, num_modes = 4;
+    dg::Grid2d g2d( 0, 2.*M_PI, 0, 2.*M_PI, n, Nx, Ny, dg::PER, dg::PER);
+    const dg::DVec f = dg::construct<dg::DVec>( dg::evaluate( function, g2d));
+    dg::Grid1d g1d( 0, 2.*M_PI, n, Nx);
+    const dg::HVec cosx = dg::evaluate( cos, g1d);
+    const unsigned nxt = n*Nx;
+
+    dg::SpectralY<dg::IDMatrix, dg::DVec> spec( g2d, num_modes);
+    dg::DVec coeffs( dg::construct<dg::DVec>( dg::HVec( 2*num_modes*nxt, 0.)));
+    spec.transform( f, coeffs);
+    dg::HVec c = dg::construct<dg::HVec>( coeffs);
+    // f = 0.5 + cos(x)cos(y) + sin(2y), i.e.
+    // a_0 = 0.5, a_1 = cos(x), b_2 = 1, all others vanish
+    double err = 0.;
+    for( unsigned ix=0; ix<nxt; ix++)
+    {
+        err = std::max( err, fabs( c[0*nxt+ix] - 0.5));
+        err = std::max( err, fabs( c[1*nxt+ix] - cosx[ix]));
+        err = std::max( err, fabs( c[2*nxt+ix]));
+        err = std::max( err, fabs( c[3*nxt+ix]));
+        err = std::max( err, fabs( c[(num_modes+1)*nxt+ix]));
+        err = std::max( err, fabs( c[(num_modes+2)*nxt+ix] - 1.));
+        err = std::max( err, fabs( c[(num_modes+3)*nxt+ix]));
+    }
+    std::cout << "Max error of coefficients is "<<err<<" (should be small)\n";
+
+    // the averaged power spectrum of a constant-in-time signal is its
+    // periodogram
+    spec.accumulate( f);
+    spec.accumulate( f);
+    std::cout << "Absorbed "<<spec.count()<<" samples (2)\n";
+    dg::HVec p = dg::construct<dg::HVec>( spec.spectrum());
+    err = 0.;
+    for( unsigned ix=0; ix<nxt; ix++)
+    {
+        err = std::max( err, fabs( p[0*nxt+ix] - 0.25));
+        err = std::max( err, fabs( p[1*nxt+ix] - cosx[ix]*cosx[ix]));
+        err = std::max( err, fabs( p[2*nxt+ix] - 1.));
+        err = std::max( err, fabs( p[3*nxt+ix]));
+    }
+    std::cout << "Max error of spectrum is "<<err<<" (should be small)\n";
+    spec.flush();
+    std::cout << "After flush count is "<<spec.count()<<" (0)\n";
+
+    return 0;
+}
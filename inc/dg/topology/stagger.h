@@ -0,0 +1,324 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "dg/backend/sparseblockmat.h"
+#include "dg/enums.h"
+#include "grid.h"
+#include "operator.h"
+#include "dx.h"
+
+/*! @file
+  @brief Staggered grid interpolation and derivative matrices
+  */
+namespace dg
+{
+namespace create
+{
+///@cond
+namespace detail
+{
+// Legendre polynomials at xn; in contrast to the interpolation coefficients
+// the argument may lie outside [-1,1] (one-sided evaluation at the domain
+// boundary of a staggered grid)
+template<class real_type>
+std::vector<real_type> legendre( real_type xn, unsigned n)
+{
+    std::vector<real_type> p( n, 0.);
+    p[0] = 1.;
+    if( n > 1)
+    {
+        p[1] = xn;
+        for( unsigned i=1; i<n-1; i++)
+            p[i+1] = ((real_type)(2*i+1)*xn*p[i]-(real_type)i*p[i-1])
+                /(real_type)(i+1);
+    }
+    return p;
+}
+
+// Assemble the 1d staggered interpolation matrix: each block evaluates the
+// primal polynomial directly at the abscissas of the grid shifted by half a
+// cell to the right (forward) or left (backward). An abscissa that falls
+// exactly onto a cell interface (the middle node for odd n, every node for
+// n==1) averages the two one-sided limits, which reproduces the classical
+// arithmetic face average for n==1
+template<class real_type>
+EllSparseBlockMat<real_type> stagger_normed( int n, int N, bc bcx,
+        direction dir)
+{
+    if( dir != dg::forward && dir != dg::backward)
+        throw Error( Message(_ping_)
+                << "stagger: only forward and backward are possible");
+    RealGrid1d<real_type> g( 0, 1, n, 1);
+    Operator<real_type> forward = g.dlt().forward();
+    const std::vector<real_type>& a = g.dlt().abscissas();
+    // M couples to the lower, P to the upper of the two primal cells that
+    // the shifted cell overlaps; B evaluates one-sided from the boundary cell
+    Operator<real_type> M(n, 0.), P(n, 0.), B(n, 0.);
+    for( int r=0; r<n; r++)
+    {
+        std::vector<real_type> pm = legendre( a[r]+(real_type)1, n);
+        std::vector<real_type> pp = legendre( a[r]-(real_type)1, n);
+        real_type wm = a[r] < 0 ? 1. : ( a[r] > 0 ? 0. : 0.5);
+        for( int l=0; l<n; l++)
+        {
+            real_type rowm = 0., rowp = 0.;
+            for( int k=0; k<n; k++)
+            {
+                rowm += pm[k]*forward(k,l);
+                rowp += pp[k]*forward(k,l);
+            }
+            M(r,l) = wm*rowm;
+            P(r,l) = (1.-wm)*rowp;
+            B(r,l) = dir == dg::forward ? rowm : rowp;
+        }
+    }
+    if( bcx == PER)
+    {
+        EllSparseBlockMat<real_type> A( N, N, 2, 2, n);
+        for( int i=0; i<n; i++)
+        for( int j=0; j<n; j++)
+        {
+            A.data[(0*n+i)*n+j] = M(i,j);
+            A.data[(1*n+i)*n+j] = P(i,j);
+        }
+        int shift = dir == dg::forward ? 0 : -1;
+        for( int i=0; i<N; i++)
+            for( int d=0; d<2; d++)
+            {
+                A.data_idx[i*2+d] = d;
+                A.cols_idx[i*2+d] = (i+d+shift+N)%N;
+            }
+        return A;
+    }
+    EllSparseBlockMat<real_type> A( N, N, 2, 4, n);
+    for( int i=0; i<n; i++)
+    for( int j=0; j<n; j++)
+    {
+        A.data[(0*n+i)*n+j] = M(i,j);
+        A.data[(1*n+i)*n+j] = P(i,j);
+        A.data[(2*n+i)*n+j] = B(i,j);
+        A.data[(3*n+i)*n+j] = 0; //to invalidate boundary entries
+    }
+    if( dir == dg::forward)
+    {
+        for( int i=0; i<N-1; i++)
+            for( int d=0; d<2; d++)
+            {
+                A.data_idx[i*2+d] = d;
+                A.cols_idx[i*2+d] = i+d;
+            }
+        A.data_idx[(N-1)*2+0] = 2; //one-sided B
+        A.cols_idx[(N-1)*2+0] = N-1;
+        A.data_idx[(N-1)*2+1] = 3; //0
+        A.cols_idx[(N-1)*2+1] = N-1; //prevent unnecessary data fetch
+    }
+    else
+    {
+        A.data_idx[0*2+0] = 2; //one-sided B
+        A.cols_idx[0*2+0] = 0;
+        A.data_idx[0*2+1] = 3; //0
+        A.cols_idx[0*2+1] = 0; //prevent unnecessary data fetch
+        for( int i=1; i<N; i++)
+            for( int d=0; d<2; d++)
+            {
+                A.data_idx[i*2+d] = d;
+                A.cols_idx[i*2+d] = i-1+d;
+            }
+    }
+    return A;
+}
+
+// Compute the product of two 1d block matrices (left and right size 1) as a
+// new EllSparseBlockMat. Blocks that appear in several rows (all interior
+// rows of a banded product) are stored only once
+template<class real_type>
+EllSparseBlockMat<real_type> multiply_1d( const EllSparseBlockMat<real_type>& A,
+        const EllSparseBlockMat<real_type>& B)
+{
+    if( A.num_cols != B.num_rows || A.n != B.n)
+        throw Error( Message(_ping_)
+                << "multiply_1d: matrix sizes do not match "
+                << A.num_cols << " vs "<<B.num_rows);
+    int n = A.n;
+    // accumulate the block products row by row
+    std::vector<std::map<int, std::vector<real_type>>> rows( A.num_rows);
+    for( int i=0; i<A.num_rows; i++)
+    for( int d=0; d<A.blocks_per_line; d++)
+    {
+        int m = A.cols_idx[i*A.blocks_per_line+d];
+        int ad = A.data_idx[i*A.blocks_per_line+d];
+        for( int e=0; e<B.blocks_per_line; e++)
+        {
+            int col = B.cols_idx[m*B.blocks_per_line+e];
+            int bd = B.data_idx[m*B.blocks_per_line+e];
+            std::vector<real_type>& block = rows[i][col];
+            block.resize( n*n, 0.);
+            for( int r=0; r<n; r++)
+            for( int q=0; q<n; q++)
+            for( int l=0; l<n; l++)
+                block[r*n+l] += A.data[(ad*n+r)*n+q]*B.data[(bd*n+q)*n+l];
+        }
+    }
+    unsigned bpl = 0;
+    for( int i=0; i<A.num_rows; i++)
+        bpl = rows[i].size() > bpl ? rows[i].size() : bpl;
+    // identical blocks (interior rows) are shared through the data index
+    std::map<std::vector<real_type>, int> unique;
+    std::vector<std::vector<real_type>> data;
+    std::vector<real_type> zero( n*n, 0.);
+    unique[zero] = 0;
+    data.push_back( zero);
+    EllSparseBlockMat<real_type> C( A.num_rows, B.num_cols, bpl, 1, n);
+    for( int i=0; i<A.num_rows; i++)
+    {
+        unsigned d = 0;
+        for( auto& entry : rows[i])
+        {
+            auto it = unique.find( entry.second);
+            if( it == unique.end())
+            {
+                it = unique.emplace( entry.second, (int)data.size()).first;
+                data.push_back( entry.second);
+            }
+            C.data_idx[i*bpl+d] = it->second;
+            C.cols_idx[i*bpl+d] = entry.first;
+            d++;
+        }
+        for( ; d<bpl; d++)
+        {
+            C.data_idx[i*bpl+d] = 0; //zero block
+            C.cols_idx[i*bpl+d] = i < B.num_cols ? i : 0; //prevent unnecessary data fetch
+        }
+    }
+    C.data.resize( data.size()*n*n);
+    for( unsigned k=0; k<data.size(); k++)
+        for( int i=0; i<n*n; i++)
+            C.data[k*n*n+i] = data[k][i];
+    return C;
+}
+}//namespace detail
+///@endcond
+
+///@addtogroup lowlevel
+///@{
+/**
+ * @brief Create a 1d staggered grid interpolation matrix
+ *
+ * The dual (staggered) grid shares the topology of \c g but its cells are
+ * shifted by half a cell size. The returned matrix evaluates a function
+ * given on \c g directly at the abscissas of the dual grid, i.e.
+ * interpolation onto the staggered grid costs a single matrix application
+ * instead of a generic interpolation matrix product. For \c n==1 the
+ * evaluation reduces to the classical arithmetic average onto the cell faces.
+ * @param g The grid on which to operate
+ * @param bcx boundary condition (for \c dg::PER the shift wraps around,
+ * otherwise the outermost staggered cell is evaluated one-sided from the
+ * boundary cell)
+ * @param dir \c dg::forward shifts by +h/2, \c dg::backward by -h/2
+ * (\c dg::centered is invalid)
+ * @return Host Matrix
+ * @sa \c dg::create::dxST for the fused staggered derivative
+ */
+template<class real_type>
+EllSparseBlockMat<real_type> stagger( const RealGrid1d<real_type>& g,
+        bc bcx, direction dir)
+{
+    return detail::stagger_normed<real_type>( g.n(), g.N(), bcx, dir);
+}
+///@copydoc stagger(const RealGrid1d<real_type>&,bc,direction)
+template<class real_type>
+EllSparseBlockMat<real_type> stagger( const RealGrid1d<real_type>& g,
+        direction dir)
+{
+    return stagger( g, g.bcx(), dir);
+}
+
+/**
+ * @brief Create a 1d staggered derivative matrix
+ *
+ * The centered derivative on the dual grid is composed with the staggered
+ * interpolation \c dg::create::stagger into a single precomputed
+ * \c EllSparseBlockMat product, such that the derivative at the staggered
+ * points costs one matrix application instead of two. For \c n==1 this
+ * produces the classical second order staggered difference quotient.
+ * @param g The grid on which to operate
+ * @param bcx boundary condition applied to both factors
+ * @param dir \c dg::forward places the derivative on the +h/2 shifted grid,
+ * \c dg::backward on the -h/2 shifted one (\c dg::centered is invalid)
+ * @return Host Matrix
+ */
+template<class real_type>
+EllSparseBlockMat<real_type> dxST( const RealGrid1d<real_type>& g,
+        bc bcx, direction dir)
+{
+    EllSparseBlockMat<real_type> S = detail::stagger_normed<real_type>(
+            g.n(), g.N(), bcx, dir);
+    EllSparseBlockMat<real_type> D = dx_normed<real_type>(
+            g.n(), g.N(), g.h(), bcx, dg::centered);
+    return detail::multiply_1d( D, S);
+}
+///@copydoc dxST(const RealGrid1d<real_type>&,bc,direction)
+template<class real_type>
+EllSparseBlockMat<real_type> dxST( const RealGrid1d<real_type>& g,
+        direction dir)
+{
+    return dxST( g, g.bcx(), dir);
+}
+
+/**
+ * @brief Create a 2d staggered grid interpolation in x-direction
+ * @copydetails stagger(const RealGrid1d<real_type>&,bc,direction)
+ */
+template<class real_type>
+EllSparseBlockMat<real_type> staggerX( const aRealTopology2d<real_type>& g,
+        direction dir)
+{
+    EllSparseBlockMat<real_type> S = detail::stagger_normed<real_type>(
+            g.nx(), g.Nx(), g.bcx(), dir);
+    S.set_left_size( g.ny()*g.Ny());
+    return S;
+}
+/**
+ * @brief Create a 2d staggered grid interpolation in y-direction
+ * @copydetails stagger(const RealGrid1d<real_type>&,bc,direction)
+ */
+template<class real_type>
+EllSparseBlockMat<real_type> staggerY( const aRealTopology2d<real_type>& g,
+        direction dir)
+{
+    EllSparseBlockMat<real_type> S = detail::stagger_normed<real_type>(
+            g.ny(), g.Ny(), g.bcy(), dir);
+    S.set_right_size( g.nx()*g.Nx());
+    return S;
+}
+/**
+ * @brief Create a 2d staggered derivative in x-direction
+ * @copydetails dxST(const RealGrid1d<real_type>&,bc,direction)
+ */
+template<class real_type>
+EllSparseBlockMat<real_type> dxST( const aRealTopology2d<real_type>& g,
+        direction dir)
+{
+    EllSparseBlockMat<real_type> D = dxST( RealGrid1d<real_type>(
+                g.x0(), g.x1(), g.nx(), g.Nx(), g.bcx()), g.bcx(), dir);
+    D.set_left_size( g.ny()*g.Ny());
+    return D;
+}
+/**
+ * @brief Create a 2d staggered derivative in y-direction
+ * @copydetails dxST(const RealGrid1d<real_type>&,bc,direction)
+ */
+template<class real_type>
+EllSparseBlockMat<real_type> dyST( const aRealTopology2d<real_type>& g,
+        direction dir)
+{
+    EllSparseBlockMat<real_type> D = dxST( RealGrid1d<real_type>(
+                g.y0(), g.y1(), g.ny(), g.Ny(), g.bcy()), g.bcy(), dir);
+    D.set_right_size( g.nx()*g.Nx());
+    return D;
+}
+///@}
+}//namespace create
+}//namespace dg
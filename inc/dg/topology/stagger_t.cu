@@ -0,0 +1,87 @@
+#include <iostream>
+#include <cmath>
+
+#include "dg/blas.h"
+#include "stagger.h"
+#include "evaluation.h"
+
+double function( double x){ return sin(x);}
+double derivative( double x){ return cos(x);}
+
+int main()
+{
+    std::cout << "TEST STAGGERED GRID MATRICES\n";
+    std::cout << "Type in n and N!\n";
+    unsigned n=3, N=40;
+    //std::cin >> n >> N;
+    std::cout << "# on grid " << n <<" x "<<N<<"\n";
+    dg::Grid1d g( 0, 2.*M_PI, n, N, dg::PER);
+    double h = g.h();
+    const dg::DVec func = dg::construct<dg::DVec>( dg::evaluate( function, g));
+    dg::DVec result( func);
+
+    dg::DMatrix Sf = dg::create::stagger( g, dg::forward);
+    dg::DMatrix Sb = dg::create::stagger( g, dg::backward);
+    dg::DMatrix Df = dg::create::dxST( g, dg::forward);
+    dg::DMatrix Db = dg::create::dxST( g, dg::backward);
+
+    const dg::DVec solf = dg::construct<dg::DVec>( dg::evaluate(
+                [h]( double x){ return function( x+h/2.);}, g));
+    const dg::DVec solb = dg::construct<dg::DVec>( dg::evaluate(
+                [h]( double x){ return function( x-h/2.);}, g));
+    const dg::DVec derf = dg::construct<dg::DVec>( dg::evaluate(
+                [h]( double x){ return derivative( x+h/2.);}, g));
+    const dg::DVec derb = dg::construct<dg::DVec>( dg::evaluate(
+                [h]( double x){ return derivative( x-h/2.);}, g));
+
+    dg::blas2::symv( Sf, func, result);
+    dg::blas1::axpby( 1., solf, -1., result);
+    std::cout << "Distance to forward stagger:  "
+              << sqrt( dg::blas1::dot( result, result)) << " (Expect: order "<<n<<")\n";
+    dg::blas2::symv( Sb, func, result);
+    dg::blas1::axpby( 1., solb, -1., result);
+    std::cout << "Distance to backward stagger: "
+              << sqrt( dg::blas1::dot( result, result)) << " (Expect: order "<<n<<")\n";
+    dg::blas2::symv( Df, func, result);
+    dg::blas1::axpby( 1., derf, -1., result);
+    std::cout << "Distance to forward  dxST:    "
+              << sqrt( dg::blas1::dot( result, result)) << "\n";
+    dg::blas2::symv( Db, func, result);
+    dg::blas1::axpby( 1., derb, -1., result);
+    std::cout << "Distance to backward dxST:    "
+              << sqrt( dg::blas1::dot( result, result)) << "\n";
+
+    std::cout << "TEST the classical staggered scheme for n==1\n";
+    dg::Grid1d g1( 0, 2.*M_PI, 1, 200, dg::PER);
+    const dg::DVec func1 = dg::construct<dg::DVec>( dg::evaluate( function, g1));
+    dg::DVec result1( func1);
+    double h1 = g1.h();
+    dg::DMatrix D1 = dg::create::dxST( g1, dg::forward);
+    const dg::DVec der1 = dg::construct<dg::DVec>( dg::evaluate(
+                [h1]( double x){ return derivative( x+h1/2.);}, g1));
+    dg::blas2::symv( D1, func1, result1);
+    dg::blas1::axpby( 1., der1, -1., result1);
+    std::cout << "Distance to n==1 staggered derivative: "
+              << sqrt( dg::blas1::dot( result1, result1))/sqrt( (double)g1.size())
+              << " (Expect: order 2)\n";
+
+    std::cout << "TEST 2d variants\n";
+    dg::Grid2d g2( 0, 2.*M_PI, 0, 2.*M_PI, n, N/2, N, dg::PER, dg::PER);
+    const dg::DVec func2 = dg::construct<dg::DVec>( dg::evaluate(
+                []( double x, double y){ return sin(x)*sin(y);}, g2));
+    dg::DVec result2( func2);
+    double hx = g2.hx(), hy = g2.hy();
+    dg::DMatrix SX = dg::create::staggerX( g2, dg::forward);
+    dg::DMatrix DY = dg::create::dyST( g2, dg::backward);
+    const dg::DVec solX = dg::construct<dg::DVec>( dg::evaluate(
+                [hx]( double x, double y){ return sin(x+hx/2.)*sin(y);}, g2));
+    const dg::DVec derY = dg::construct<dg::DVec>( dg::evaluate(
+                [hy]( double x, double y){ return sin(x)*cos(y-hy/2.);}, g2));
+    dg::blas2::symv( SX, func2, result2);
+    dg::blas1::axpby( 1., solX, -1., result2);
+    std::cout << "Distance to staggerX: " << sqrt( dg::blas1::dot( result2, result2)) << "\n";
+    dg::blas2::symv( DY, func2, result2);
+    dg::blas1::axpby( 1., derY, -1., result2);
+    std::cout << "Distance to dyST:     " << sqrt( dg::blas1::dot( result2, result2)) << "\n";
+    return 0;
+}
@@ -143,6 +143,221 @@ cusp::csr_matrix<int, real_type, cusp::host_memory> limiter_stencil(
     return A;
 }
 
+template<class real_type>
+cusp::csr_matrix<int, real_type, cusp::host_memory> filter_stencil(
+        const aRealTopology2d<real_type>& local,
+        const aRealTopology2d<real_type>& global)
+{
+    cusp::array1d<real_type, cusp::host_memory> values;
+    cusp::array1d<int, cusp::host_memory> row_offsets;
+    cusp::array1d<int, cusp::host_memory> column_indices;
+
+    unsigned nx = local.gx().n(), ny = local.gy().n();
+    unsigned Mx = global.gx().size();
+    int L0x = round((local.gx().x0() - global.gx().x0())/global.gx().h())*global.gx().n();
+    int L0y = round((local.gy().x0() - global.gy().x0())/global.gy().h())*global.gy().n();
+
+    row_offsets.push_back(0);
+    for( unsigned j=0; j<local.gy().size(); j++)
+    for( unsigned i=0; i<local.gx().size(); i++)
+    {
+        // only the first point in each cell holds the cell stencil
+        if( j%ny == 0 && i%nx == 0)
+        {
+            row_offsets.push_back(row_offsets[row_offsets.size()-1] + nx*ny);
+            for( unsigned jj=0; jj<ny; jj++)
+            for( unsigned ll=0; ll<nx; ll++)
+            {
+                column_indices.push_back( (int)((L0y + j + jj)*Mx) + L0x + (int)(i + ll));
+                values.push_back( 1.0);
+            }
+        }
+        else
+            row_offsets.push_back(row_offsets[row_offsets.size()-1]);
+    }
+    // the stencil is cell-local so no boundary treatment is necessary
+
+    cusp::csr_matrix<int, real_type, cusp::host_memory> A(
+            local.size(), global.size(), values.size());
+    A.row_offsets = row_offsets;
+    A.column_indices = column_indices;
+    A.values = values;
+    return A;
+}
+
+template<class real_type>
+cusp::csr_matrix<int, real_type, cusp::host_memory> filter_stencil(
+        const aRealTopology3d<real_type>& local,
+        const aRealTopology3d<real_type>& global)
+{
+    cusp::array1d<real_type, cusp::host_memory> values;
+    cusp::array1d<int, cusp::host_memory> row_offsets;
+    cusp::array1d<int, cusp::host_memory> column_indices;
+
+    unsigned nx = local.gx().n(), ny = local.gy().n();
+    unsigned Mx = global.gx().size(), My = global.gy().size();
+    int L0x = round((local.gx().x0() - global.gx().x0())/global.gx().h())*global.gx().n();
+    int L0y = round((local.gy().x0() - global.gy().x0())/global.gy().h())*global.gy().n();
+    int L0z = round((local.gz().x0() - global.gz().x0())/global.gz().h())*global.gz().n();
+
+    row_offsets.push_back(0);
+    for( unsigned s=0; s<local.gz().size(); s++)
+    for( unsigned j=0; j<local.gy().size(); j++)
+    for( unsigned i=0; i<local.gx().size(); i++)
+    {
+        // only the first point in each cell holds the cell stencil
+        if( j%ny == 0 && i%nx == 0)
+        {
+            row_offsets.push_back(row_offsets[row_offsets.size()-1] + nx*ny);
+            for( unsigned jj=0; jj<ny; jj++)
+            for( unsigned ll=0; ll<nx; ll++)
+            {
+                column_indices.push_back( (int)(((L0z + s)*My + L0y + j + jj)*Mx)
+                        + L0x + (int)(i + ll));
+                values.push_back( 1.0);
+            }
+        }
+        else
+            row_offsets.push_back(row_offsets[row_offsets.size()-1]);
+    }
+    // the stencil is cell-local so no boundary treatment is necessary
+
+    cusp::csr_matrix<int, real_type, cusp::host_memory> A(
+            local.size(), global.size(), values.size());
+    A.row_offsets = row_offsets;
+    A.column_indices = column_indices;
+    A.values = values;
+    return A;
+}
+
+//map a global index that leaves [0,M) back into the domain according to the
+//boundary condition and accumulate the Dirichlet sign (same rules as
+//set_boundary, but entry by entry so that x and y can be treated separately)
+template<class real_type>
+int reflect_boundary( int idx, int M, dg::bc bound, real_type& sign)
+{
+    if( idx < 0)
+    {
+        if( bound == dg::PER)
+            return idx + M;
+        if( bound == dg::DIR || bound == dg::DIR_NEU)
+            sign *= (real_type)-1;
+        return -(idx+1);
+    }
+    if( idx >= M)
+    {
+        if( bound == dg::PER)
+            return idx - M;
+        if( bound == dg::DIR || bound == dg::NEU_DIR)
+            sign *= (real_type)-1;
+        return 2*M-1-idx;
+    }
+    return idx;
+}
+
+template<class real_type>
+cusp::csr_matrix<int, real_type, cusp::host_memory> cell_stencil(
+        const aRealTopology2d<real_type>& local,
+        const aRealTopology2d<real_type>& global,
+        dg::bc bcx, dg::bc bcy)
+{
+    cusp::array1d<real_type, cusp::host_memory> values;
+    cusp::array1d<int, cusp::host_memory> row_offsets;
+    cusp::array1d<int, cusp::host_memory> column_indices;
+
+    unsigned nx = local.gx().n(), ny = local.gy().n();
+    int Mx = global.gx().size(), My = global.gy().size();
+    int L0x = round((local.gx().x0() - global.gx().x0())/global.gx().h())*global.gx().n();
+    int L0y = round((local.gy().x0() - global.gy().x0())/global.gy().h())*global.gy().n();
+    //the center cell first, then its face neighbors in x and y
+    const int off[5][2] = { {0,0}, {-(int)nx,0}, {(int)nx,0},
+        {0,-(int)ny}, {0,(int)ny}};
+
+    row_offsets.push_back(0);
+    for( unsigned j=0; j<local.gy().size(); j++)
+    for( unsigned i=0; i<local.gx().size(); i++)
+    {
+        // only the first point in each cell holds the cell stencil
+        if( j%ny == 0 && i%nx == 0)
+        {
+            row_offsets.push_back(row_offsets[row_offsets.size()-1] + 5*nx*ny);
+            for( unsigned c=0; c<5; c++)
+            for( unsigned jj=0; jj<ny; jj++)
+            for( unsigned ll=0; ll<nx; ll++)
+            {
+                real_type sign = 1;
+                int cx = reflect_boundary( L0x + (int)(i + ll) + off[c][0],
+                        Mx, bcx, sign);
+                int cy = reflect_boundary( L0y + (int)(j + jj) + off[c][1],
+                        My, bcy, sign);
+                column_indices.push_back( cy*Mx + cx);
+                values.push_back( sign);
+            }
+        }
+        else
+            row_offsets.push_back(row_offsets[row_offsets.size()-1]);
+    }
+
+    cusp::csr_matrix<int, real_type, cusp::host_memory> A(
+            local.size(), global.size(), values.size());
+    A.row_offsets = row_offsets;
+    A.column_indices = column_indices;
+    A.values = values;
+    return A;
+}
+
+template<class real_type>
+cusp::csr_matrix<int, real_type, cusp::host_memory> cell_stencil(
+        const aRealTopology3d<real_type>& local,
+        const aRealTopology3d<real_type>& global,
+        dg::bc bcx, dg::bc bcy)
+{
+    cusp::array1d<real_type, cusp::host_memory> values;
+    cusp::array1d<int, cusp::host_memory> row_offsets;
+    cusp::array1d<int, cusp::host_memory> column_indices;
+
+    unsigned nx = local.gx().n(), ny = local.gy().n();
+    int Mx = global.gx().size(), My = global.gy().size();
+    int L0x = round((local.gx().x0() - global.gx().x0())/global.gx().h())*global.gx().n();
+    int L0y = round((local.gy().x0() - global.gy().x0())/global.gy().h())*global.gy().n();
+    int L0z = round((local.gz().x0() - global.gz().x0())/global.gz().h())*global.gz().n();
+    const int off[5][2] = { {0,0}, {-(int)nx,0}, {(int)nx,0},
+        {0,-(int)ny}, {0,(int)ny}};
+
+    row_offsets.push_back(0);
+    for( unsigned s=0; s<local.gz().size(); s++)
+    for( unsigned j=0; j<local.gy().size(); j++)
+    for( unsigned i=0; i<local.gx().size(); i++)
+    {
+        // only the first point in each cell holds the cell stencil
+        if( j%ny == 0 && i%nx == 0)
+        {
+            row_offsets.push_back(row_offsets[row_offsets.size()-1] + 5*nx*ny);
+            for( unsigned c=0; c<5; c++)
+            for( unsigned jj=0; jj<ny; jj++)
+            for( unsigned ll=0; ll<nx; ll++)
+            {
+                real_type sign = 1;
+                int cx = reflect_boundary( L0x + (int)(i + ll) + off[c][0],
+                        Mx, bcx, sign);
+                int cy = reflect_boundary( L0y + (int)(j + jj) + off[c][1],
+                        My, bcy, sign);
+                column_indices.push_back( ((L0z + (int)s)*My + cy)*Mx + cx);
+                values.push_back( sign);
+            }
+        }
+        else
+            row_offsets.push_back(row_offsets[row_offsets.size()-1]);
+    }
+
+    cusp::csr_matrix<int, real_type, cusp::host_memory> A(
+            local.size(), global.size(), values.size());
+    A.row_offsets = row_offsets;
+    A.column_indices = column_indices;
+    A.values = values;
+    return A;
+}
+
 template<class real_type>
 cusp::csr_matrix< int, real_type, cusp::host_memory> identity_matrix( const RealGrid1d<real_type>& local, const RealGrid1d<real_type>& global)
 {
@@ -159,6 +374,31 @@ cusp::csr_matrix< int, real_type, cusp::host_memory> identity_matrix( const Real
     return A;
 }
 
+template<class real_type>
+cusp::csr_matrix< int, real_type, cusp::host_memory> region_stencil(
+        const thrust::host_vector<real_type>& mask, unsigned num_cols)
+{
+    cusp::array1d<real_type, cusp::host_memory> values;
+    cusp::array1d<int, cusp::host_memory> row_offsets;
+    cusp::array1d<int, cusp::host_memory> column_indices;
+    row_offsets.push_back(0);
+    for( unsigned i=0; i<mask.size(); i++)
+    {
+        if( mask[i] != 0)
+        {
+            row_offsets.push_back( row_offsets[row_offsets.size()-1] + 1);
+            column_indices.push_back( (int)i);
+            values.push_back( mask[i]);
+        }
+    }
+    cusp::csr_matrix<int, real_type, cusp::host_memory> A(
+            row_offsets.size()-1, num_cols, values.size());
+    A.row_offsets = row_offsets;
+    A.column_indices = column_indices;
+    A.values = values;
+    return A;
+}
+
 } //namespace detail
 ///@endcond
 
@@ -290,6 +530,80 @@ dg::IHMatrix_t<real_type> limiter_stencil(
     return dg::tensorproduct( mz, dg::tensorproduct( einsy, einsx));
 }
 
+/*!
+ * @brief A cell-local stencil for modal filtering
+ *
+ * Create a CSR Matrix in which the row of the first point of each dG cell
+ * contains all <tt> g.n()*g.n() </tt> points of that cell (ordered y-major)
+ * and all other rows are empty. Since the stencil never leaves the cell no
+ * boundary conditions are necessary.
+ * @param g the grid
+ * @return A sparse matrix with \c g.n()*g.n() entries in the row of each
+ * first cell point, each with value 1 (the values are ignored by the filter)
+ * @tparam real_type The value type of the matrix
+ * @sa \c dg::blas2::stencil \c dg::CSRModalFilter
+ * @attention Do not sort the matrix as then the ordering is destroyed
+ */
+template<class real_type>
+dg::IHMatrix_t<real_type> filter_stencil(
+        const aRealTopology2d<real_type>& g)
+{
+    return detail::filter_stencil( g, g);
+}
+
+///@copydoc filter_stencil(const aRealTopology2d<real_type>&)
+///@note The filter acts on every x-y plane separately
+template<class real_type>
+dg::IHMatrix_t<real_type> filter_stencil(
+        const aRealTopology3d<real_type>& g)
+{
+    return detail::filter_stencil( g, g);
+}
+
+/*!
+ * @brief A cell stencil including the nearest face neighbor cells
+ *
+ * Create a CSR Matrix in which the row of the first point of each dG cell
+ * contains all <tt> g.nx()*g.ny() </tt> points of the cell itself followed by
+ * the points of its four face neighbor cells (in the order x-left, x-right,
+ * y-left, y-right, each block ordered y-major) and all other rows are empty.
+ * This is the matrix to give to \c dg::blas2::stencil to write element-local
+ * kernels: a functor is called once per cell, reads the cell and its
+ * neighbors through \c column_indices (under MPI the neighbor points may be
+ * gathered halo points) and writes its result to the first
+ * <tt> g.nx()*g.ny() </tt> columns, which always index the cell itself. With
+ * derivatives expressed through neighbor differences an entire right hand
+ * side can thus be fused into one kernel instead of separate \c symv and
+ * pointwise stages.
+ * @param g the grid
+ * @param bcx Determine what to do at the x-boundary. For Neumann conditions
+ * the boundary points are simply duplicated, for Dirichlet they are
+ * duplicated as well and the values are set to -1 instead of 1.
+ * @param bcy analogous to \c bcx for the y-boundary
+ * @return A sparse matrix with \c 5*g.nx()*g.ny() entries in the row of each
+ * first cell point; the values hold the boundary sign of the respective point
+ * @tparam real_type The value type of the matrix
+ * @sa \c dg::blas2::stencil \c dg::CSRModalFilter (for the write-back pattern)
+ * @attention Do not sort the matrix as then the ordering is destroyed
+ */
+template<class real_type>
+dg::IHMatrix_t<real_type> cell_stencil(
+        const aRealTopology2d<real_type>& g,
+        dg::bc bcx, dg::bc bcy)
+{
+    return detail::cell_stencil( g, g, bcx, bcy);
+}
+
+///@copydoc cell_stencil(const aRealTopology2d<real_type>&,dg::bc,dg::bc)
+///@note The stencil acts on every x-y plane separately
+template<class real_type>
+dg::IHMatrix_t<real_type> cell_stencil(
+        const aRealTopology3d<real_type>& g,
+        dg::bc bcx, dg::bc bcy)
+{
+    return detail::cell_stencil( g, g, bcx, bcy);
+}
+
 /*!
  * @brief A 2d centered window stencil
  *
@@ -321,6 +635,45 @@ dg::IHMatrix_t<real_type> window_stencil(
     return dg::tensorproduct( mz, dg::tensorproduct( my, mx));
 }
 
+/*!
+ * @brief A stencil over the points where a mask is nonzero
+ *
+ * Create a CSR Matrix with one row per point where \c mask does not vanish.
+ * Each row holds a single entry whose column is the index of that point and
+ * whose value is the mask value there.  Together with \c dg::blas2::stencil
+ * this restricts pointwise kernels to the region covered by the mask instead
+ * of evaluating them on the whole grid and multiplying by the mask
+ * afterwards (penalization masks typically cover only a small fraction of
+ * the domain).
+ * @param mask defines the region, must have \c g.size() elements
+ * @param g the grid
+ * @return A sparse matrix with one row and one entry per nonzero mask point,
+ * the entry holds the mask value
+ * @tparam real_type The value type of the matrix
+ * @note All columns of the stencil are process local (even in MPI), so the
+ * additional vector arguments of \c dg::blas2::stencil may also be read and
+ * written through the column indices
+ * @sa \c dg::blas2::stencil
+ */
+template<class real_type>
+dg::IHMatrix_t<real_type> region_stencil(
+        const thrust::host_vector<real_type>& mask,
+        const aRealTopology2d<real_type>& g)
+{
+    assert( mask.size() == g.size());
+    return detail::region_stencil( mask, g.size());
+}
+
+///@copydoc region_stencil(const thrust::host_vector<real_type>&,const aRealTopology2d<real_type>&)
+template<class real_type>
+dg::IHMatrix_t<real_type> region_stencil(
+        const thrust::host_vector<real_type>& mask,
+        const aRealTopology3d<real_type>& g)
+{
+    assert( mask.size() == g.size());
+    return detail::region_stencil( mask, g.size());
+}
+
 #ifdef MPI_VERSION
 ///@copydoc dg::create::window_stencil(std::array<int,2>,const aRealTopology2d<real_type>&,dg::bc,dg::bc)
 template<class real_type>
@@ -401,6 +754,89 @@ dg::MIHMatrix_t<real_type> limiter_stencil(
     return dg::convert( local, g);
 }
 
+///@copydoc filter_stencil(const aRealTopology2d<real_type>&)
+template<class real_type>
+dg::MIHMatrix_t<real_type> filter_stencil(
+        const aRealMPITopology2d<real_type>& g)
+{
+    auto local = detail::filter_stencil( g.local(), g.global());
+    return dg::convert( local, g);
+}
+
+///@copydoc filter_stencil(const aRealTopology2d<real_type>&)
+///@note The filter acts on every x-y plane separately
+template<class real_type>
+dg::MIHMatrix_t<real_type> filter_stencil(
+        const aRealMPITopology3d<real_type>& g)
+{
+    auto local = detail::filter_stencil( g.local(), g.global());
+    return dg::convert( local, g);
+}
+
+///@copydoc cell_stencil(const aRealTopology2d<real_type>&,dg::bc,dg::bc)
+template<class real_type>
+dg::MIHMatrix_t<real_type> cell_stencil(
+        const aRealMPITopology2d<real_type>& g,
+        dg::bc bcx, dg::bc bcy)
+{
+    auto local = detail::cell_stencil( g.local(), g.global(), bcx, bcy);
+    return dg::convert( local, g);
+}
+
+///@copydoc cell_stencil(const aRealTopology2d<real_type>&,dg::bc,dg::bc)
+///@note The stencil acts on every x-y plane separately
+template<class real_type>
+dg::MIHMatrix_t<real_type> cell_stencil(
+        const aRealMPITopology3d<real_type>& g,
+        dg::bc bcx, dg::bc bcy)
+{
+    auto local = detail::cell_stencil( g.local(), g.global(), bcx, bcy);
+    return dg::convert( local, g);
+}
+
+///@cond
+namespace detail
+{
+template<class real_type, class MPITopology>
+dg::MIHMatrix_t<real_type> mpi_region_stencil(
+        const MPI_Vector<thrust::host_vector<real_type>>& mask,
+        const MPITopology& g)
+{
+    auto local = detail::region_stencil( mask.data(), g.local().size());
+    int rank;
+    MPI_Comm_rank( g.communicator(), &rank);
+    for( unsigned i=0; i<local.column_indices.size(); i++)
+    {
+        int globalIdx = 0;
+        g.local2globalIdx( local.column_indices[i], rank, globalIdx);
+        local.column_indices[i] = globalIdx;
+    }
+    //all columns are local, so the resulting communicator is empty
+    return dg::convert( local, g);
+}
+} //namespace detail
+///@endcond
+
+///@copydoc region_stencil(const thrust::host_vector<real_type>&,const aRealTopology2d<real_type>&)
+template<class real_type>
+dg::MIHMatrix_t<real_type> region_stencil(
+        const MPI_Vector<thrust::host_vector<real_type>>& mask,
+        const aRealMPITopology2d<real_type>& g)
+{
+    assert( mask.data().size() == g.local().size());
+    return detail::mpi_region_stencil( mask, g);
+}
+
+///@copydoc region_stencil(const thrust::host_vector<real_type>&,const aRealTopology2d<real_type>&)
+template<class real_type>
+dg::MIHMatrix_t<real_type> region_stencil(
+        const MPI_Vector<thrust::host_vector<real_type>>& mask,
+        const aRealMPITopology3d<real_type>& g)
+{
+    assert( mask.data().size() == g.local().size());
+    return detail::mpi_region_stencil( mask, g);
+}
+
 #endif // MPI_VERSION
 
 ///@}
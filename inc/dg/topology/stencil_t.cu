@@ -5,6 +5,25 @@
 #include "filter.h"
 #include "../blas2.h"
 
+// one kernel for a profile relaxation term: the stencil average and the
+// pointwise relaxation with a further input field fused into one pass
+struct FusedRelaxation
+{
+    FusedRelaxation( double omega): m_omega(omega){}
+    DG_DEVICE
+    void operator()( unsigned i, const int* row_offsets,
+        const int* column_indices, const double* values,
+        const double* x, const double* a, double* avg, double* relax) const
+    {
+        avg[i] = 0;
+        int num = row_offsets[i+1]-row_offsets[i];
+        for( int k=row_offsets[i]; k<row_offsets[i+1]; k++)
+            avg[i] += x[column_indices[k]]*values[k]/(double)num;
+        relax[i] = m_omega*a[i]*(x[i]-avg[i]);
+    }
+    private:
+    double m_omega;
+};
 
 int main()
 {
@@ -71,7 +90,104 @@ int main()
     double err = dg::blas1::dot( y, 1.);
     std::cout << "error between transposed application and app is: " <<err<<" (0)\n";
 
+    std::cout << "Test cell stencil\n";
+    for( auto bc : bcs)
+    {
+        std::cout << "Test "<<dg::bc2str( bc)<<" boundary:\n";
+        dg::IHMatrix cells = dg::create::cell_stencil( g2d, bc, bc);
+        unsigned nx = g2d.nx(), ny = g2d.ny(), Mx = g2d.gx().size();
+        unsigned num_entries = 0, errors = 0;
+        for( unsigned j=0; j<g2d.gy().size(); j++)
+        for( unsigned i=0; i<g2d.gx().size(); i++)
+        {
+            unsigned row = j*Mx+i;
+            unsigned size = cells.row_offsets[row+1]-cells.row_offsets[row];
+            unsigned expected = ( j%ny == 0 && i%nx == 0) ? 5*nx*ny : 0;
+            if( size != expected)
+                errors++;
+            num_entries += size;
+            if( size == 0)
+                continue;
+            // the first nx*ny columns index the cell itself
+            int k = cells.row_offsets[row];
+            for( unsigned jj=0; jj<ny; jj++)
+            for( unsigned ll=0; ll<nx; ll++)
+            {
+                if( cells.column_indices[k] != (int)((j+jj)*Mx + i + ll)
+                        || cells.values[k] != 1)
+                    errors++;
+                k++;
+            }
+        }
+        std::cout << "Structure errors: "<<errors<<" (0) with "
+            <<num_entries<<" ("<<5*g2d.size()<<") entries\n";
+        // the neighbor blocks of the interior cell (1,1)
+        int k = cells.row_offsets[ny*Mx+nx] + nx*ny;
+        std::cout << "First x-left, x-right, y-left, y-right neighbor columns: ";
+        for( unsigned c=0; c<4; c++)
+            std::cout << cells.column_indices[k+c*nx*ny]<<" ";
+        std::cout << "("<<ny*Mx<<" "<<ny*Mx+2*nx<<" "<<nx<<" "<<2*ny*Mx+nx<<")\n";
+        // applying the symv filter to a constant must recover the
+        // number of points each row sees (with signs at the boundary)
+        dg::blas1::copy( 1., x);
+        dg::blas2::stencil( dg::CSRSymvFilter(), cells, x, y);
+        std::cout << "Sum over first cell point is "<<y[0];
+        if( bc == dg::DIR)
+            std::cout <<" ("<<(int)(nx*ny)<<")\n"; //both ghost blocks negative
+        else
+            std::cout <<" ("<<5*nx*ny<<")\n";
+    }
+
+    std::cout << "Test fused multi-argument stencil (average + relaxation)\n";
+    x = dg::evaluate( [](double x, double y){return sin(M_PI*x)*cos(y)+2.;},
+            g2d);
+    auto a = dg::evaluate( [](double x, double y){return x+1.;}, g2d);
+    auto avg(x), relax(x);
+    //a window over the whole y extent realizes the poloidal average
+    auto ystencil = dg::create::window_stencil( {1, (int)g2d.gy().size()},
+            g2d, dg::PER, dg::PER);
+    dg::blas2::stencil( FusedRelaxation(0.5), (dg::IHMatrix)ystencil,
+            x, a, avg, relax);
+    err = 0.;
+    unsigned Mx = g2d.gx().size(), My = g2d.gy().size();
+    for( unsigned k=0; k<Mx; k++)
+    {
+        double sum = 0.;
+        for( unsigned i=0; i<My; i++)
+            sum += x[i*Mx+k];
+        sum /= (double)My;
+        for( unsigned i=0; i<My; i++)
+            err = std::max( err,
+                fabs( relax[i*Mx+k] - 0.5*a[i*Mx+k]*(x[i*Mx+k]-sum)));
+    }
+    std::cout << "Error of fused relaxation term "<<err<<" (Expect 0)\n";
 
+    std::cout << "Test region stencil\n";
+    //a mask that is nonzero on a small part of the domain only
+    auto mask = dg::evaluate( [](double x, double y){
+            return x < 0.2 ? 0.5+x : 0.;}, g2d);
+    auto region = dg::create::region_stencil( mask, g2d);
+    x = dg::evaluate( [](double x, double y){return sin(M_PI*x)*cos(y)+2.;},
+            g2d);
+    // y = x*(1-mask) on the whole grid, compacted to the nonzero points
+    dg::blas1::copy( x, y);
+    dg::blas2::stencil( []DG_DEVICE( unsigned i, const int* row_offsets,
+        const int* column_indices, const double* values, const double*,
+        double* out)
+        {
+            for( int k=row_offsets[i]; k<row_offsets[i+1]; k++)
+                out[column_indices[k]] *= (1.-values[k]);
+        }, region, y, y);
+    err = 0.;
+    unsigned num_rows = 0;
+    for( unsigned i=0; i<g2d.size(); i++)
+    {
+        err = std::max( err, fabs( y[i] - x[i]*(1.-mask[i])));
+        if( mask[i] != 0)
+            num_rows++;
+    }
+    std::cout << "Error of compacted masking "<<err<<" (Expect 0) on "
+        <<region.num_rows<<" ("<<num_rows<<") of "<<g2d.size()<<" points\n";
 
     return 0;
 }
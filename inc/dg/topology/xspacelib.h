@@ -11,6 +11,7 @@
 #include "dlt.h"
 #include "operator.h"
 #include "operator_tensor.h"
+#include "plan_cache.h"
 
 
 /*! @file
@@ -95,23 +96,36 @@ dg::IHMatrix_t<real_type> backscatter( const RealGrid1d<real_type>& g)
 }
 
 ///@copydoc backscatter(const RealGrid1d<real_type>&)
+///@note the returned reference points into the \c dg::create::cached_plan
+///cache and is valid for the lifetime of the process
 template<class real_type>
-dg::IHMatrix_t<real_type> backscatter( const aRealTopology2d<real_type>& g)
+const dg::IHMatrix_t<real_type>& backscatter( const aRealTopology2d<real_type>& g)
 {
-    //create equidistant backward transformation
-    auto transformX = backscatter( g.gx());
-    auto transformY = backscatter( g.gy());
-    return dg::tensorproduct( transformY, transformX);
+    //visualisation tools call this for every record: keep the plan cached
+    return cached_plan<dg::IHMatrix_t<real_type>>(
+        "backscatter:"+grid_signature( g), [&]()
+    {
+        //create equidistant backward transformation
+        auto transformX = backscatter( g.gx());
+        auto transformY = backscatter( g.gy());
+        return dg::tensorproduct( transformY, transformX);
+    });
 }
 
 ///@copydoc backscatter(const RealGrid1d<real_type>&)
+///@note the returned reference points into the \c dg::create::cached_plan
+///cache and is valid for the lifetime of the process
 template<class real_type>
-dg::IHMatrix_t<real_type> backscatter( const aRealTopology3d<real_type>& g)
+const dg::IHMatrix_t<real_type>& backscatter( const aRealTopology3d<real_type>& g)
 {
-    auto transformX = backscatter( g.gx());
-    auto transformY = backscatter( g.gy());
-    auto transformZ = backscatter( g.gz());
-    return dg::tensorproduct( transformZ, dg::tensorproduct(transformY, transformX));
+    return cached_plan<dg::IHMatrix_t<real_type>>(
+        "backscatter:"+grid_signature( g), [&]()
+    {
+        auto transformX = backscatter( g.gx());
+        auto transformY = backscatter( g.gy());
+        auto transformZ = backscatter( g.gz());
+        return dg::tensorproduct( transformZ, dg::tensorproduct(transformY, transformX));
+    });
 }
 
 /**
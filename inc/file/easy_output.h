@@ -1,11 +1,29 @@
 #pragma once
 
 #include <exception>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <set>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <netcdf.h>
+#if defined(MPI_VERSION) && defined(DG_PARALLEL_NETCDF)
+#include <netcdf_par.h>
+#endif //DG_PARALLEL_NETCDF
+#include <thrust/copy.h>
 #include "dg/topology/grid.h"
+#include "dg/topology/functions.h"
+#include "dg/topology/evaluation.h"
+#include "dg/backend/prof.h"
 #ifdef MPI_VERSION
 #include "dg/backend/mpi_vector.h"
 #include "dg/topology/mpi_grid.h"
+#include "dg/topology/mpi_evaluation.h"
 #endif //MPI_VERSION
 
 /*!@file
@@ -127,6 +145,7 @@ template<class host_vector>
 void put_var_double(int ncid, int varid, const dg::aTopology2d& grid,
     const host_vector& data, bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[2] = {0,0}, count[2];
     count[0] = grid.ny()*grid.Ny();
@@ -165,6 +184,7 @@ template<class host_vector>
 void put_vara_double(int ncid, int varid, unsigned slice,
     const dg::aTopology2d& grid, const host_vector& data, bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[3] = {slice,0,0}, count[3];
     count[0] = 1;
@@ -178,6 +198,7 @@ template<class host_vector>
 void put_var_double(int ncid, int varid, const dg::aTopology3d& grid,
     const host_vector& data, bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[3] = {0,0,0}, count[3];
     count[0] = grid.nz()*grid.Nz();
@@ -191,6 +212,7 @@ template<class host_vector>
 void put_vara_double(int ncid, int varid, unsigned slice,
     const dg::aTopology3d& grid, const host_vector& data, bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[4] = {slice, 0,0,0}, count[4];
     count[0] = 1;
@@ -206,6 +228,7 @@ template<class host_vector>
 void put_var_double(int ncid, int varid, const dg::aMPITopology2d& grid,
     const dg::MPI_Vector<host_vector>& data, bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[3] = {0,0}, count[2];
     count[0] = grid.ny()*grid.local().Ny();
@@ -257,6 +280,7 @@ void put_vara_double(int ncid, int varid, unsigned slice,
     const dg::aMPITopology2d& grid, const dg::MPI_Vector<host_vector>& data,
     bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[3] = {slice, 0,0}, count[3];
     count[0] = 1;
@@ -309,6 +333,7 @@ void put_var_double(int ncid, int varid,
     const dg::aMPITopology3d& grid, const dg::MPI_Vector<host_vector>& data,
     bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[3] = {0,0,0}, count[3];
     count[0] = grid.nz()*grid.local().Nz();
@@ -363,6 +388,7 @@ void put_vara_double(int ncid, int varid, unsigned slice,
     const dg::aMPITopology3d& grid, const dg::MPI_Vector<host_vector>& data,
     bool parallel = false)
 {
+    DG_PROF_SCOPE( "file::put_var");
     file::NC_Error_Handle err;
     size_t start[4] = {slice, 0,0,0}, count[4];
     count[0] = 1;
@@ -411,8 +437,611 @@ void put_vara_double(int ncid, int varid, unsigned slice,
         MPI_Barrier( comm);
     }
 }
+#if defined(DG_PARALLEL_NETCDF)
+/**
+ * @brief Convenience wrapper around \c nc_create_par()
+ *
+ * Creates the file collectively on all processes of \c comm for parallel
+ * access, which is the prerequisite for the \c parallel=true mode of the \c
+ * put_var_double functions. In contrast to the default funnel through the
+ * master rank no global gather of the field is needed before a write.
+ * @note Only defined if the macro \c DG_PARALLEL_NETCDF is defined (compile
+ * with \c -DDG_PARALLEL_NETCDF) since it requires a **parallel netcdf and
+ * hdf5** library to link
+ * @param filename Name of the file to create
+ * @param cmode Creation mode forwarded to \c nc_create_par; the flags \c
+ * NC_NETCDF4 and \c NC_MPIIO are added automatically
+ * @param comm The communicator of all processes that access the file,
+ * usually \c grid.communicator()
+ * @param ncid (write only) The id of the new file
+ * @return NetCDF error code (0 on success)
+ */
+inline int create_par( std::string filename, int cmode, MPI_Comm comm,
+    int* ncid)
+{
+    return nc_create_par( filename.data(), cmode|NC_NETCDF4|NC_MPIIO, comm,
+        MPI_INFO_NULL, ncid);
+}
+
+/**
+ * @brief Define a variable for collective parallel writes with chunking
+ * matched to the local grid
+ *
+ * At large resolutions the default \c parallel=false mode of the \c
+ * put_var_double functions gathers the full field to the master rank before
+ * writing, which costs a global communication per output step. In the
+ * parallel mode each process instead writes its own hyperslab of the global
+ * grid directly into the file (NetCDF-4/HDF5 collective I/O). This function
+ * defines such a variable: it calls \c nc_def_var, sets the HDF5 chunking to
+ * exactly one local grid per chunk (so that every process writes whole chunks
+ * and the HDF5 layer does not have to reassemble chunks from several
+ * processes) and marks the variable for \c NC_COLLECTIVE access.
+ *
+ * For example
+ * @code
+ * int ncid, dimids[4], tvarID, dataID;
+ * dg::file::create_par( "out.nc", NC_CLOBBER, grid.communicator(), &ncid);
+ * dg::file::define_dimensions( ncid, dimids, &tvarID, grid);
+ * dg::file::def_var_par( ncid, "data", 4, dimids, grid, &dataID);
+ * nc_enddef( ncid);
+ * dg::file::put_vara_double( ncid, dataID, 0, grid, data, true);
+ * @endcode
+ * @note This function and \c create_par are only defined if the macro \c
+ * DG_PARALLEL_NETCDF is defined (compile with \c -DDG_PARALLEL_NETCDF) since
+ * they require a **parallel netcdf and hdf5** library to link
+ * @param ncid NetCDF file id (must be created with \c create_par)
+ * @param name Name of the variable to define
+ * @param ndims Number of dimensions of the variable: 4 for a time-dependent
+ * variable (use with \c put_vara_double), 3 for a time-independent one
+ * (use with \c put_var_double)
+ * @param dimids Dimension ids, e.g. from \c define_dimensions
+ * @param grid The grid that is later used to write the variable; determines
+ * the chunk sizes
+ * @param varid (write only) The id of the new variable
+ * @return NetCDF error code (0 on success)
+ */
+inline int def_var_par( int ncid, std::string name, int ndims,
+    const int* dimids, const dg::aMPITopology3d& grid, int* varid)
+{
+    int retval = nc_def_var( ncid, name.data(), NC_DOUBLE, ndims, dimids,
+        varid);
+    if( retval) return retval;
+    size_t chunks[4] = {1,
+        grid.nz()*grid.local().Nz(),
+        grid.ny()*grid.local().Ny(),
+        grid.nx()*grid.local().Nx()};
+    retval = nc_def_var_chunking( ncid, *varid, NC_CHUNKED, &chunks[4-ndims]);
+    if( retval) return retval;
+    return nc_var_par_access( ncid, *varid, NC_COLLECTIVE);
+}
+
+///@copydoc def_var_par()
+///@note This version is for 2d grids: use \c ndims=3 for a time-dependent
+///variable and \c ndims=2 for a time-independent one
+inline int def_var_par( int ncid, std::string name, int ndims,
+    const int* dimids, const dg::aMPITopology2d& grid, int* varid)
+{
+    int retval = nc_def_var( ncid, name.data(), NC_DOUBLE, ndims, dimids,
+        varid);
+    if( retval) return retval;
+    size_t chunks[3] = {1,
+        grid.ny()*grid.local().Ny(),
+        grid.nx()*grid.local().Nx()};
+    retval = nc_def_var_chunking( ncid, *varid, NC_CHUNKED, &chunks[3-ndims]);
+    if( retval) return retval;
+    return nc_var_par_access( ncid, *varid, NC_COLLECTIVE);
+}
+#endif //DG_PARALLEL_NETCDF
 #endif //MPI_VERSION
 
+///@cond
+namespace detail
+{
+template<class ContainerType>
+const ContainerType& flat_data( const ContainerType& v){ return v;}
+template<class ContainerType>
+ContainerType& flat_data( ContainerType& v){ return v;}
+#ifdef MPI_VERSION
+template<class ContainerType>
+const ContainerType& flat_data( const dg::MPI_Vector<ContainerType>& v){ return v.data();}
+template<class ContainerType>
+ContainerType& flat_data( dg::MPI_Vector<ContainerType>& v){ return v.data();}
+#endif //MPI_VERSION
+
+//number of mantissa bits needed to resolve a relative tolerance
+inline int keepbits( double rel_tolerance)
+{
+    int bits = (int)ceil( -log2( rel_tolerance));
+    return bits < 1 ? 1 : ( bits > 52 ? 52 : bits);
+}
+//round-to-nearest on the discarded mantissa bits (bit-grooming)
+inline double groom_bits( double d, int keepbits)
+{
+    if( !std::isfinite( d))
+        return d;
+    uint64_t bits;
+    std::memcpy( &bits, &d, sizeof(bits));
+    uint64_t shift = 52 - keepbits;
+    //the carry of round-to-nearest correctly propagates into the exponent
+    bits += (uint64_t)1 << (shift-1);
+    bits &= ~( ( (uint64_t)1 << shift) - 1);
+    std::memcpy( &d, &bits, sizeof(bits));
+    return d;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Define a variable with lossless deflate compression
+ *
+ * Diagnostic and restart fields are smooth and compress well; defining them
+ * with this function instead of a plain \c nc_def_var activates the HDF5
+ * shuffle filter and zlib deflate such that the NetCDF library compresses
+ * each chunk transparently on write. The compression is lossless, i.e. reads
+ * return bit-identical data, so it is safe for restart fields.
+ * @note Requires a NetCDF-4 file (created with \c NC_NETCDF4); deflate is
+ * incompatible with the parallel write mode of \c def_var_par
+ * @param ncid NetCDF file id
+ * @param name Name of the variable to define
+ * @param ndims Number of dimensions of the variable
+ * @param dimids Dimension ids, e.g. from \c define_dimensions
+ * @param varid (write only) The id of the new variable
+ * @param level deflate level between 1 (fastest) and 9 (best compression);
+ * levels beyond 3 rarely pay off for floating point data
+ * @return NetCDF error code (0 on success)
+ */
+inline int def_var_deflate( int ncid, std::string name, int ndims,
+    const int* dimids, int* varid, int level = 1)
+{
+    int retval = nc_def_var( ncid, name.data(), NC_DOUBLE, ndims, dimids,
+        varid);
+    if( retval) return retval;
+    return nc_def_var_deflate( ncid, *varid, 1, 1, level);
+}
+
+/**
+ * @brief Lossy version of \c put_vara_double for diagnostic output
+ *
+ * Rounds the mantissa of every value to the number of bits needed to resolve
+ * \c rel_tolerance (bit-grooming) before forwarding to \c put_vara_double.
+ * The rounding itself does not shrink the record, but the zeroed trailing
+ * mantissa bits make the data highly compressible, so combined with a
+ * variable defined through \c def_var_deflate the archive volume of
+ * diagnostic fields drops by roughly the fraction of discarded bits.
+ * Use different tolerances for different records of a diagnostics list as
+ * needed; restart fields should be written losslessly with the plain
+ * \c put_var_double.
+ *
+ * For example
+ * @code
+ * int id;
+ * dg::file::def_var_deflate( ncid, "electrons", 4, dim_ids, &id);
+ * // ... enddef, timestep ...
+ * //keep 5 significant digits of the density field
+ * dg::file::put_vara_double_lossy( ncid, id, start, g3d_out, transferH, 1e-5);
+ * @endcode
+ * @param rel_tolerance the maximum relative error of each stored value,
+ * e.g. \c 1e-5 keeps 17 mantissa bits instead of 52
+ * @copydetails put_vara_double()
+ */
+template<class Topology, class host_vector>
+void put_vara_double_lossy( int ncid, int varid, unsigned slice,
+    const Topology& grid, const host_vector& data, double rel_tolerance,
+    bool parallel = false)
+{
+    host_vector groomed( data);
+    auto& flat = detail::flat_data( groomed);
+    int bits = detail::keepbits( rel_tolerance);
+    for( unsigned i=0; i<flat.size(); i++)
+        flat[i] = detail::groom_bits( flat[i], bits);
+    put_vara_double( ncid, varid, slice, grid, groomed, parallel);
+}
+
+///@brief Lossy version of \c put_var_double for time-independent variables
+///@copydetails put_vara_double_lossy()
+template<class Topology, class host_vector>
+void put_var_double_lossy( int ncid, int varid, const Topology& grid,
+    const host_vector& data, double rel_tolerance, bool parallel = false)
+{
+    host_vector groomed( data);
+    auto& flat = detail::flat_data( groomed);
+    int bits = detail::keepbits( rel_tolerance);
+    for( unsigned i=0; i<flat.size(); i++)
+        flat[i] = detail::groom_bits( flat[i], bits);
+    put_var_double( ncid, varid, grid, groomed, parallel);
+}
+
+/**
+ * @brief Asynchronous double-buffered output stage around \c put_var_double
+ *
+ * Writing the 3d fields of a production simulation with \c put_vara_double
+ * stalls the timestepper for the whole duration of the disk write. This class
+ * decouples the two: \c queue_vara_double snapshots the field into a slot of a
+ * (page-locked) host ring buffer and returns, while a dedicated writer thread
+ * drains the ring in first-in first-out order through the existing
+ * \c put_var_double / \c put_vara_double routines. Timestepping thus overlaps
+ * with I/O and only blocks if it produces records faster than the disk can
+ * absorb them (in which case \c queue_vara_double waits for a free slot).
+ * Record ordering in the file is exactly the order of the queue calls.
+ *
+ * For example
+ * @code
+ * dg::file::AsyncWriter<dg::Grid3d> writer( g3d_out, 2);
+ * for( unsigned i=0; i<maxout; i++)
+ * {
+ *     // ... timestep to the next output point ...
+ *     dg::assign( result, transferD);
+ *     writer.queue_vara_double( ncid, id4d, i, transferD); //returns immediately
+ * }
+ * writer.flush(); //wait for outstanding records before closing the file
+ * @endcode
+ * @note On the CUDA backend the ring buffer is registered as page-locked
+ * memory such that the device to host snapshot runs at full PCIe bandwidth.
+ * @note Exceptions thrown by the write calls on the writer thread (e.g.
+ * \c dg::file::NC_Error) are caught and re-thrown on the calling thread by the
+ * next \c queue_*_double or \c flush call.
+ * @attention In the MPI version the writer thread issues MPI communication
+ * (the funnel through the master rank), so MPI must be initialized with
+ * \c MPI_THREAD_MULTIPLE and all ranks must queue records in the same order.
+ * @tparam Topology Any grid class with a \c host_vector typedef that the
+ * \c put_var_double routines accept, e.g. \c dg::Grid3d or \c dg::MPIGrid3d
+ */
+template<class Topology>
+struct AsyncWriter
+{
+    using host_vector = typename Topology::host_vector; //!< the type of the ring buffer slots
+    /**
+     * @brief Allocate the ring buffer and start the writer thread
+     * @param grid the grid of all fields that are later queued; used to
+     * allocate the ring buffer and forwarded to \c put_var_double
+     * @param depth number of slots in the ring buffer (2 gives the classic
+     * double buffer: one slot being written to disk while the other one
+     * receives the next snapshot)
+     */
+    AsyncWriter( const Topology& grid, unsigned depth = 2): m_grid(grid),
+        m_buffers( depth, dg::evaluate( dg::zero, grid))
+    {
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        for( auto& buffer : m_buffers)
+            cudaHostRegister( thrust::raw_pointer_cast(
+                detail::flat_data(buffer).data()),
+                detail::flat_data(buffer).size()*sizeof(double),
+                cudaHostRegisterDefault);
+#endif
+        m_writer = std::thread( [this]{ this->write_loop();});
+    }
+    ///@brief \c flush remaining records and join the writer thread
+    ~AsyncWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex);
+            m_shutdown = true;
+        }
+        m_cv.notify_all();
+        m_writer.join();
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        for( auto& buffer : m_buffers)
+            cudaHostUnregister( thrust::raw_pointer_cast(
+                detail::flat_data(buffer).data()));
+#endif
+    }
+    AsyncWriter( const AsyncWriter&) = delete;
+    AsyncWriter& operator=( const AsyncWriter&) = delete;
+
+    /**
+     * @brief Queue a time-slice for writing (asynchronous \c put_vara_double)
+     *
+     * Copies \c data into the next free ring buffer slot (waiting for the
+     * writer thread if all slots are in flight) and returns; the actual
+     * \c put_vara_double happens on the writer thread.
+     * @param ncid Forwarded to \c put_vara_double
+     * @param varid Forwarded to \c put_vara_double
+     * @param slice Forwarded to \c put_vara_double
+     * @param data may reside in GPU memory; must have the size of the grid
+     * @tparam ContainerType any vector that \c thrust::copy can copy to
+     * \c host_vector, e.g. \c dg::DVec for \c dg::Grid3d
+     */
+    template<class ContainerType>
+    void queue_vara_double( int ncid, int varid, unsigned slice,
+        const ContainerType& data)
+    {
+        unsigned slot = acquire_slot( data);
+        std::lock_guard<std::mutex> lock( m_mutex);
+        m_queue.push( {ncid, varid, slice, true, slot});
+        m_cv.notify_all();
+    }
+    /**
+     * @brief Queue a time-independent variable for writing (asynchronous \c put_var_double)
+     * @copydetails queue_vara_double()
+     */
+    template<class ContainerType>
+    void queue_var_double( int ncid, int varid, const ContainerType& data)
+    {
+        unsigned slot = acquire_slot( data);
+        std::lock_guard<std::mutex> lock( m_mutex);
+        m_queue.push( {ncid, varid, 0, false, slot});
+        m_cv.notify_all();
+    }
+    /**
+     * @brief Wait until all queued records are written to file
+     *
+     * Call this before closing the file with \c nc_close
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        m_cv.wait( lock, [this]{ return m_queue.empty();});
+        rethrow();
+    }
+    private:
+    struct Record
+    {
+        int ncid, varid;
+        unsigned slice;
+        bool has_slice;
+        unsigned slot;
+    };
+    //must be called with m_mutex unlocked
+    template<class ContainerType>
+    unsigned acquire_slot( const ContainerType& data)
+    {
+        unsigned slot;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex);
+            rethrow();
+            //the ring is used round-robin so if a slot is free it is m_head
+            m_cv.wait( lock, [this]{
+                return m_queue.size() < m_buffers.size();});
+            slot = m_head;
+            m_head = (m_head+1)%m_buffers.size();
+        }
+        thrust::copy( detail::flat_data(data).begin(),
+            detail::flat_data(data).end(),
+            detail::flat_data(m_buffers[slot]).begin());
+        return slot;
+    }
+    //must be called with m_mutex held
+    void rethrow()
+    {
+        if( m_exception)
+        {
+            std::exception_ptr e = m_exception;
+            m_exception = nullptr;
+            std::rethrow_exception( e);
+        }
+    }
+    void write_loop()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        while( true)
+        {
+            m_cv.wait( lock, [this]{ return !m_queue.empty() || m_shutdown;});
+            if( m_queue.empty() && m_shutdown)
+                return;
+            Record record = m_queue.front();
+            //release the lock during the write; the record stays in the
+            //queue so its slot is not re-used before the write completes
+            lock.unlock();
+            try
+            {
+                if( record.has_slice)
+                    put_vara_double( record.ncid, record.varid, record.slice,
+                        m_grid, m_buffers[record.slot]);
+                else
+                    put_var_double( record.ncid, record.varid, m_grid,
+                        m_buffers[record.slot]);
+            }
+            catch( ...)
+            {
+                lock.lock();
+                m_exception = std::current_exception();
+                m_queue.pop();
+                m_cv.notify_all();
+                continue;
+            }
+            lock.lock();
+            m_queue.pop();
+            m_cv.notify_all();
+        }
+    }
+    Topology m_grid;
+    std::vector<host_vector> m_buffers;
+    std::queue<Record> m_queue;
+    unsigned m_head = 0;
+    bool m_shutdown = false;
+    std::exception_ptr m_exception = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_writer;
+};
+
+/**
+ * @brief Buffered writer for scalar and 1d time series records
+ *
+ * The frequent 0d diagnostics of a simulation (energies, particle numbers,
+ * probe signals) issue one \c nc_put_vara_double per scalar per timestep;
+ * each of these tiny writes pays the full file-system latency and in sum they
+ * become visible in the timestep loop. This class removes that latency from
+ * the loop: \c queue_vara_double copies the few values of a record into a
+ * slot of a lock-free single-producer single-consumer ring buffer and
+ * returns, while a dedicated writer thread drains the ring in batches through
+ * \c nc_put_vara_double and periodically calls \c nc_sync so that at most
+ * \c sync_interval seconds of records are lost if the program crashes.
+ * Record ordering in the file is exactly the order of the queue calls.
+ *
+ * For example
+ * @code
+ * dg::file::BufferedRecordWriter recorder;
+ * for( unsigned i=0; i<=NT; i++)
+ * {
+ *     // ... timestep ...
+ *     recorder.queue_vara_double( ncid, energyID, i, energy); //returns immediately
+ * }
+ * recorder.flush(); //all records must be on disk before nc_close
+ * @endcode
+ * @note In contrast to \c AsyncWriter the hot path takes no mutex: producer
+ * and writer thread only exchange two atomic counters, so a queue call costs
+ * a few nanoseconds unless the ring is full (i.e. the disk cannot absorb the
+ * records as fast as they are produced).
+ * @attention Records may only be queued from one thread (in an MPI program
+ * typically only the master rank writes the reduced 0d series, so no
+ * threaded MPI support is required). Call \c flush before \c nc_close on any
+ * file that records were queued for.
+ */
+struct BufferedRecordWriter
+{
+    /**
+     * @brief Allocate the ring buffer and start the writer thread
+     * @param capacity number of records the ring can hold before \c
+     * queue_vara_double blocks
+     * @param sync_interval maximum time in seconds between two \c nc_sync
+     * calls on files with unsynced records (crash-safety window)
+     */
+    BufferedRecordWriter( unsigned capacity = 1024, double sync_interval = 10.):
+        m_ring( capacity), m_sync_interval( sync_interval)
+    {
+        m_writer = std::thread( [this]{ this->write_loop();});
+    }
+    ///@brief \c flush remaining records and join the writer thread
+    ~BufferedRecordWriter()
+    {
+        m_shutdown.store( true, std::memory_order_release);
+        m_writer.join();
+    }
+    BufferedRecordWriter( const BufferedRecordWriter&) = delete;
+    BufferedRecordWriter& operator=( const BufferedRecordWriter&) = delete;
+
+    /**
+     * @brief Queue a record for writing (buffered \c nc_put_vara_double)
+     *
+     * Copies the values into the next free ring slot (waiting for the writer
+     * thread only if the ring is full) and returns; the actual
+     * \c nc_put_vara_double happens on the writer thread.
+     * @param ncid Forwarded to \c nc_put_vara_double
+     * @param varid Forwarded to \c nc_put_vara_double
+     * @param ndims number of dimensions of the hyperslab (1 or 2)
+     * @param start Forwarded to \c nc_put_vara_double ( \c ndims entries)
+     * @param count Forwarded to \c nc_put_vara_double ( \c ndims entries)
+     * @param data the <tt>count[0]*...*count[ndims-1]</tt> values to write
+     */
+    void queue_vara_double( int ncid, int varid, unsigned ndims,
+        const size_t* start, const size_t* count, const double* data)
+    {
+        if( m_has_error.load( std::memory_order_acquire))
+            rethrow();
+        size_t head = m_head.load( std::memory_order_relaxed);
+        //wait for a free slot (only if the disk cannot keep up)
+        while( head - m_tail.load( std::memory_order_acquire) >= m_ring.size())
+            std::this_thread::yield();
+        Record& record = m_ring[ head % m_ring.size()];
+        record.ncid = ncid, record.varid = varid, record.ndims = ndims;
+        size_t size = 1;
+        for( unsigned i=0; i<ndims; i++)
+        {
+            record.start[i] = start[i], record.count[i] = count[i];
+            size *= count[i];
+        }
+        //the slot re-uses its allocation after the first round trip
+        record.data.assign( data, data+size);
+        m_head.store( head+1, std::memory_order_release);
+    }
+    ///@brief Queue a single scalar of a time series ( \c start is the time index)
+    void queue_vara_double( int ncid, int varid, size_t start, double data)
+    {
+        size_t count = 1;
+        queue_vara_double( ncid, varid, 1, &start, &count, &data);
+    }
+    /**
+     * @brief Wait until all queued records are written and synced to file
+     *
+     * Call this before closing a file with \c nc_close
+     */
+    void flush()
+    {
+        m_flush.store( true, std::memory_order_release);
+        while( m_flush.load( std::memory_order_acquire))
+            std::this_thread::sleep_for( std::chrono::milliseconds(1));
+        if( m_has_error.load( std::memory_order_acquire))
+            rethrow();
+    }
+    private:
+    struct Record
+    {
+        int ncid, varid;
+        unsigned ndims;
+        size_t start[2], count[2];
+        std::vector<double> data;
+    };
+    void rethrow()
+    {
+        std::lock_guard<std::mutex> lock( m_emutex);
+        std::exception_ptr e = m_exception;
+        m_exception = nullptr;
+        m_has_error.store( false, std::memory_order_release);
+        if( e)
+            std::rethrow_exception( e);
+    }
+    void sync( std::set<int>& touched)
+    {
+        for( int ncid : touched)
+            nc_sync( ncid); //best effort: the data is already written
+        touched.clear();
+        m_last_sync = std::chrono::steady_clock::now();
+    }
+    void write_loop()
+    {
+        std::set<int> touched; //files with unsynced records
+        m_last_sync = std::chrono::steady_clock::now();
+        while( true)
+        {
+            size_t tail = m_tail.load( std::memory_order_relaxed);
+            size_t head = m_head.load( std::memory_order_acquire);
+            //drain the whole batch before syncing
+            for( ; tail != head; tail++)
+            {
+                Record& record = m_ring[ tail % m_ring.size()];
+                int status = nc_put_vara_double( record.ncid, record.varid,
+                    record.start, record.count, record.data.data());
+                if( status != NC_NOERR)
+                {
+                    std::lock_guard<std::mutex> lock( m_emutex);
+                    m_exception = std::make_exception_ptr( NC_Error( status));
+                    m_has_error.store( true, std::memory_order_release);
+                }
+                else
+                    touched.insert( record.ncid);
+                m_tail.store( tail+1, std::memory_order_release);
+            }
+            bool empty = ( head == m_head.load( std::memory_order_acquire));
+            if( empty && m_flush.load( std::memory_order_acquire))
+            {
+                sync( touched);
+                m_flush.store( false, std::memory_order_release);
+            }
+            else if( std::chrono::duration<double>( std::chrono::steady_clock::now()
+                        - m_last_sync).count() > m_sync_interval && !touched.empty())
+                sync( touched);
+            if( empty)
+            {
+                if( m_shutdown.load( std::memory_order_acquire))
+                {
+                    sync( touched);
+                    return;
+                }
+                std::this_thread::sleep_for( std::chrono::milliseconds(1));
+            }
+        }
+    }
+    std::vector<Record> m_ring;
+    double m_sync_interval;
+    std::chrono::steady_clock::time_point m_last_sync;
+    std::atomic<size_t> m_head{0}, m_tail{0};
+    std::atomic<bool> m_shutdown{false}, m_flush{false}, m_has_error{false};
+    std::exception_ptr m_exception = nullptr;
+    std::mutex m_emutex;
+    std::thread m_writer;
+};
+
 ///@}
 }//namespace file
 }//namespace dg
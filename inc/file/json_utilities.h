@@ -4,6 +4,9 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <set>
+#include <vector>
+#include <memory>
 #include <stdexcept> //std::runtime_error
 
 #include "json/json.h"
@@ -90,17 +93,17 @@ struct WrappedJsonValue
 {
     ///@brief Default constructor
     ///By default the error mode is \c error::is_throw
-    WrappedJsonValue() : m_js(0), m_mode( error::is_throw){}
+    WrappedJsonValue() : m_js(0), m_mode( error::is_throw), m_record( std::make_shared<std::set<std::string>>()){}
     ///@brief Construct with error mode
     ///@param mode The error mode
-    WrappedJsonValue( error mode): m_js(0), m_mode( mode) {}
+    WrappedJsonValue( error mode): m_js(0), m_mode( mode), m_record( std::make_shared<std::set<std::string>>()) {}
     ///@brief By default the error mode is \c error::is_throw
     ///@param js The Json value that will be guarded
-    WrappedJsonValue(Json::Value js): m_js(js), m_mode( error::is_throw) {}
+    WrappedJsonValue(Json::Value js): m_js(js), m_mode( error::is_throw), m_record( std::make_shared<std::set<std::string>>()) {}
     ///@brief Construct with Json value and error mode
     ///@param js The Json value that will be guarded
     ///@param mode The error mode
-    WrappedJsonValue(Json::Value js, error mode): m_js(js), m_mode( mode) {}
+    WrappedJsonValue(Json::Value js, error mode): m_js(js), m_mode( mode), m_record( std::make_shared<std::set<std::string>>()) {}
     ///@brief Change the error mode
     ///@param new_mode The new error mode
     void set_mode( error new_mode){
@@ -118,6 +121,30 @@ struct WrappedJsonValue
      */
     std::string access_string() const {return m_access_str;}
 
+    /*! @brief All keys of the guarded Json value that were never accessed
+     *
+     * All copies that originate in the same \c WrappedJsonValue share a
+     * record of the keys that were successfully looked up through \c
+     * operator[] or \c get. This function walks the Json value and returns
+     * the access strings of all object keys that are absent from that
+     * record (children of unaccessed keys are not reported again). A
+     * misspelled key in an input file silently falls back to its default
+     * value, so after the startup phase of a program has read all its
+     * parameters this list should be empty:
+     * @code
+    for( auto& key : js.unused_keys())
+        std::cerr << "WARNING: Input key "<<key<<" was never read!\n";
+     * @endcode
+     * @return access strings of all keys never accessed (empty if all keys were read)
+     */
+    std::vector<std::string> unused_keys() const
+    {
+        std::vector<std::string> unused;
+        if( m_record)
+            collect_unused( m_js, m_access_str, unused);
+        return unused;
+    }
+
     // //////////Members imitating the original Json::Value///////////////
     /// Wrap the corresponding Json::Value function with error handling
     WrappedJsonValue operator[](std::string key) const{
@@ -175,7 +202,7 @@ struct WrappedJsonValue
         return type_error<std::string>( value, "a String");
     }
     private:
-    WrappedJsonValue(Json::Value js, error mode, std::string access):m_js(js), m_mode( mode), m_access_str(access) {}
+    WrappedJsonValue(Json::Value js, error mode, std::string access, std::shared_ptr<std::set<std::string>> record):m_js(js), m_mode( mode), m_access_str(access), m_record(record) {}
     WrappedJsonValue get( std::string key, const Json::Value& value, std::string default_str) const
     {
         std::string access = m_access_str + "\""+key+"\": ";
@@ -184,9 +211,11 @@ struct WrappedJsonValue
         {
             message <<"*** Key error: "<<access<<" not found.";
             raise_error( message.str(), default_str);
-            return WrappedJsonValue( value, m_mode, access);
+            return WrappedJsonValue( value, m_mode, access, m_record);
         }
-        return WrappedJsonValue(m_js[key], m_mode, access);
+        if( m_record)
+            m_record->insert( access);
+        return WrappedJsonValue(m_js[key], m_mode, access, m_record);
     }
     WrappedJsonValue get( unsigned idx, const Json::Value& value, std::string default_str) const
     {
@@ -202,9 +231,23 @@ struct WrappedJsonValue
             else
                 message <<"*** Index error: Index "<<idx<<" not present in "<<m_access_str<<".";
             raise_error( message.str(), default_str);
-            return WrappedJsonValue( value, m_mode, access);
+            return WrappedJsonValue( value, m_mode, access, m_record);
+        }
+        return WrappedJsonValue(m_js[idx], m_mode, access, m_record);
+    }
+    void collect_unused( const Json::Value& js, std::string access,
+        std::vector<std::string>& unused) const
+    {
+        if( !js.isObject())
+            return;
+        for( auto name : js.getMemberNames())
+        {
+            std::string child = access + "\""+name+"\": ";
+            if( m_record->count( child) == 0)
+                unused.push_back( child);
+            else //only descend into keys that were accessed themselves
+                collect_unused( js[name], child, unused);
         }
-        return WrappedJsonValue(m_js[idx], m_mode, access);
     }
     template<class T>
     T type_error( T value, std::string type) const
@@ -227,6 +270,7 @@ struct WrappedJsonValue
     Json::Value m_js;
     error m_mode;
     std::string m_access_str = "";
+    std::shared_ptr<std::set<std::string>> m_record;
 };
 
 /**
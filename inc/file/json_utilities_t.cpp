@@ -91,6 +91,23 @@ int main()
         std::cout << ws["nested"]["another_nest"]["number"].access_string()
                   <<" (nested: another_nest: number)\n";
     }
+    {
+        std::cout << "Test unused keys:\n";
+        dg::file::WrappedJsonValue ws( js);
+        ws["hello"].asString();
+        ws["nested"]["hi"].asDouble();
+        auto unused = ws.unused_keys();
+        for( auto& key : unused)
+            std::cout << "Never accessed "<<key<<"\n";
+        //"array", "nested": "bool" and "nested": "another_nest" (whose
+        //children are not reported again)
+        assert( unused.size() == 3);
+        ws["array"].size();
+        ws["nested"]["bool"].asBool();
+        ws["nested"]["another_nest"]["number"].asUInt();
+        assert( ws.unused_keys().empty());
+        std::cout << "TEST PASSED!\n";
+    }
 
     return 0;
 }
@@ -3,6 +3,12 @@
 #pragma message( "The inclusion of file/nc_utilities.h is deprecated. Please use dg/file/nc_utilities.h")
 #endif //_INCLUDED_BY_DG_
 
+#include <vector>
+#include <string>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <netcdf.h>
 #include "thrust/host_vector.h"
 
@@ -53,6 +59,16 @@ template<>
 inline int put_var_T<double>( int ncid, int varID, double* data){
     return nc_put_var_double( ncid, varID, data);
 }
+template<class T>
+inline int get_vara_T( int ncid, int varID, const size_t* startp, const size_t* countp, T* data);
+template<>
+inline int get_vara_T<float>( int ncid, int varID, const size_t* startp, const size_t* countp, float* data){
+    return nc_get_vara_float( ncid, varID, startp, countp, data);
+}
+template<>
+inline int get_vara_T<double>( int ncid, int varID, const size_t* startp, const size_t* countp, double* data){
+    return nc_get_vara_double( ncid, varID, startp, countp, data);
+}
 ///@endcond
 
 ///@addtogroup netcdf
@@ -366,6 +382,309 @@ inline int define_dimensions( int ncid, int* dimsIDs, int* tvarID, const dg::aRe
 }
 #endif //MPI_VERSION
 
+/**
+ * @brief Define one set of spatial dimensions per output grid
+ *
+ * When variables of a diagnostics list are written on individually coarsened
+ * output grids, every distinct resolution needs its own set of NetCDF
+ * dimensions and coordinate variables, while variables that share a
+ * resolution must share the dimensions. This class keys the \c
+ * define_dimensions calls on the global number of points per dimension: the
+ * first grid gets the plain dimension names (by default "z", "y", "x"), every
+ * subsequent distinct shape gets a numbered set ("z2", "y2", "x2", ...), and
+ * a grid with a shape seen before returns the already defined ids without
+ * touching the file.
+ *
+ * For example
+ * @code
+ * dg::file::DimensionCache cache;
+ * cache.dimension_ids( ncid, g3d_out, &dim_ids[1]); //defines z,y,x
+ * cache.dimension_ids( ncid, g3d_coarse, coarse_ids); //defines z2,y2,x2
+ * cache.dimension_ids( ncid, g3d_out, other_ids); //re-uses z,y,x
+ * @endcode
+ * @attention In an MPI program only the master process may call \c
+ * dimension_ids (as with \c define_dimensions); the returned ids are only
+ * valid on the master process
+ */
+struct DimensionCache
+{
+    ///@brief Construct with the names of the first set of dimensions
+    ///@param name_dims names of the first dimension set; further sets append
+    ///a counter to each name
+    DimensionCache( std::array<std::string,3> name_dims = {"z", "y", "x"}):
+        m_names( name_dims) {}
+    /**
+     * @brief Get (or define) the dimension ids for a grid
+     *
+     * Calls \c define_dimensions if and only if no grid with the same global
+     * number of points per dimension was seen before
+     * @param ncid file ID
+     * @param g the output grid; only its shape and abscissas are used
+     * @param dimsIDs (write - only) 3D array of dimension IDs (Z,Y,X)
+     * @return if anything goes wrong it returns the netCDF code, else SUCCESS
+     * @tparam Topology3d a 3d grid, shared or MPI
+     */
+    template<class Topology3d>
+    int dimension_ids( int ncid, const Topology3d& g, int* dimsIDs)
+    {
+        std::array<size_t,3> shape = { g.nz()*(size_t)g.Nz(),
+            g.ny()*(size_t)g.Ny(), g.nx()*(size_t)g.Nx()};
+        auto it = m_dims.find( shape);
+        if( it != m_dims.end())
+        {
+            for( unsigned i=0; i<3; i++)
+                dimsIDs[i] = it->second[i];
+            return NC_NOERR;
+        }
+        std::string suffix = m_dims.empty() ? "" :
+            std::to_string( m_dims.size()+1);
+        int retval = define_dimensions( ncid, dimsIDs, g, { m_names[0]+suffix,
+            m_names[1]+suffix, m_names[2]+suffix});
+        if( retval)
+            return retval;
+        m_dims[ shape] = { dimsIDs[0], dimsIDs[1], dimsIDs[2]};
+        return NC_NOERR;
+    }
+    private:
+    std::array<std::string,3> m_names;
+    std::map<std::array<size_t,3>, std::array<int,3>> m_dims;
+};
+
+/**
+ * @brief Streaming reader with double-buffered prefetch for record variables
+ *
+ * The post-processing tools load entire variables into memory before touching
+ * a single time slice, which makes them run out of memory on the output files
+ * of large production runs. This class streams a set of record (i.e.
+ * time-dependent) variables one record hyperslab at a time and thus bounds
+ * host memory to **two** slices per variable: \c read makes a record
+ * available in the front buffers while a dedicated reader thread already
+ * fetches the following record into the back buffers, so in a sequential
+ * sweep through the file the disk read of the next record overlaps with the
+ * computation on the current one.
+ *
+ * For example
+ * @code
+ * dg::file::RecordReader reader( ncid_in, {"electrons", "ions", "potential"});
+ * for( unsigned i=0; i<reader.num_records(); i++)
+ * {
+ *     reader.read( i); //returns as soon as record i is in memory
+ *     for( unsigned j=0; j<reader.num_variables(); j++)
+ *         process( reader.data( j)); //overlaps with the read of record i+1
+ * }
+ * @endcode
+ * @note Records read out of order work but forfeit the prefetch (the slice is
+ * then read synchronously).
+ * @note The data is converted to \c T by the netCDF library, so e.g. a
+ * \c NC_FLOAT variable can be streamed as \c RecordReader_t<double>
+ * @attention The prefetch issues netCDF calls from the reader thread. Unless
+ * your netCDF/HDF5 libraries are thread-safe builds, bracket your own netCDF
+ * calls (e.g. writes of the processed slice to another file) with \c wait,
+ * which blocks until no prefetch is in flight
+ * @tparam T the type the records are read as, usually \c double or \c float
+ */
+template<class T>
+struct RecordReader_t
+{
+    /**
+     * @brief Inspect the variables and start the reader thread
+     *
+     * All variables must have the record (time) dimension as their first
+     * dimension and must agree on its length; the remaining dimensions may
+     * differ between variables.
+     * @param ncid file ID of an open netCDF file, must remain open for the
+     * lifetime of this class
+     * @param varids the variables to stream; two slices are allocated for
+     * each
+     */
+    RecordReader_t( int ncid, std::vector<int> varids) : m_ncid( ncid),
+        m_varids( varids)
+    {
+        NC_Error_Handle err;
+        unsigned num = varids.size();
+        m_count.resize( num);
+        m_front.resize( num), m_back.resize( num);
+        for( unsigned j=0; j<num; j++)
+        {
+            int ndims;
+            err = nc_inq_varndims( ncid, varids[j], &ndims);
+            std::vector<int> dimids( ndims);
+            err = nc_inq_vardimid( ncid, varids[j], dimids.data());
+            size_t records = 0;
+            err = nc_inq_dimlen( ncid, dimids[0], &records);
+            if( j == 0)
+                m_num_records = records;
+            else if( records != m_num_records)
+                throw std::runtime_error( "RecordReader: all variables must "
+                        "share the length of the record dimension!");
+            size_t size = 1;
+            m_count[j].push_back( 1);
+            for( int d=1; d<ndims; d++)
+            {
+                size_t len = 0;
+                err = nc_inq_dimlen( ncid, dimids[d], &len);
+                m_count[j].push_back( len);
+                size *= len;
+            }
+            m_front[j].resize( size), m_back[j].resize( size);
+        }
+        m_reader = std::thread( [this]{ this->read_loop();});
+    }
+    ///@brief Convenience constructor that looks up the variables by name
+    ///@copydetails RecordReader_t(int,std::vector<int>)
+    RecordReader_t( int ncid, std::vector<std::string> names)
+        : RecordReader_t( ncid, name2id( ncid, names))
+    {
+    }
+    ///@brief Join the reader thread
+    ~RecordReader_t()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex);
+            m_shutdown = true;
+        }
+        m_cv.notify_all();
+        m_reader.join();
+    }
+    RecordReader_t( const RecordReader_t&) = delete;
+    RecordReader_t& operator=( const RecordReader_t&) = delete;
+
+    ///@brief The length of the record dimension
+    size_t num_records() const { return m_num_records;}
+    ///@brief The number of streamed variables
+    unsigned num_variables() const { return m_varids.size();}
+
+    /**
+     * @brief Make a record available in the front buffers
+     *
+     * If the record was prefetched (the common sequential case) the buffers
+     * are simply swapped, else the record is read synchronously; in both
+     * cases the prefetch of <tt> record+1 </tt> is triggered before the
+     * function returns.
+     * @param record the record (time) index to read, must be less than
+     * \c num_records()
+     */
+    void read( unsigned record)
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        m_cv.wait( lock, [this]{ return m_request < 0;});
+        rethrow();
+        if( m_loaded == (int)record)
+            m_front.swap( m_back);
+        else
+        {
+            //cold start or non-sequential access
+            lock.unlock();
+            read_record( record, m_front);
+            lock.lock();
+        }
+        m_loaded = -1;
+        if( record + 1 < m_num_records)
+        {
+            m_request = (int)(record + 1);
+            m_cv.notify_all();
+        }
+    }
+    /**
+     * @brief The current slice of a variable
+     * @param j index into the \c varids of the constructor
+     * @return the slice made available by the last call to \c read; remains
+     * valid until the next call to \c read
+     */
+    const thrust::host_vector<T>& data( unsigned j = 0) const
+    {
+        return m_front[j];
+    }
+    /**
+     * @brief Block until no prefetch is in flight
+     *
+     * Call before issuing your own netCDF calls if the netCDF library is not
+     * thread-safe
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        m_cv.wait( lock, [this]{ return m_request < 0;});
+        rethrow();
+    }
+    private:
+    static std::vector<int> name2id( int ncid,
+            std::vector<std::string> names)
+    {
+        NC_Error_Handle err;
+        std::vector<int> varids( names.size());
+        for( unsigned j=0; j<names.size(); j++)
+            err = nc_inq_varid( ncid, names[j].data(), &varids[j]);
+        return varids;
+    }
+    void read_record( unsigned record,
+            std::vector<thrust::host_vector<T>>& buffers)
+    {
+        NC_Error_Handle err;
+        for( unsigned j=0; j<m_varids.size(); j++)
+        {
+            std::vector<size_t> start( m_count[j].size(), 0);
+            start[0] = record;
+            err = get_vara_T<T>( m_ncid, m_varids[j], start.data(),
+                    m_count[j].data(), buffers[j].data());
+        }
+    }
+    //must be called with m_mutex held
+    void rethrow()
+    {
+        if( m_exception)
+        {
+            std::exception_ptr e = m_exception;
+            m_exception = nullptr;
+            std::rethrow_exception( e);
+        }
+    }
+    void read_loop()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        while( true)
+        {
+            m_cv.wait( lock, [this]{ return m_request >= 0 || m_shutdown;});
+            if( m_shutdown)
+                return;
+            unsigned record = (unsigned)m_request;
+            //release the lock during the read; m_request >= 0 keeps the
+            //front buffers from being swapped under our feet
+            lock.unlock();
+            try
+            {
+                read_record( record, m_back);
+            }
+            catch( ...)
+            {
+                lock.lock();
+                m_exception = std::current_exception();
+                m_loaded = -1;
+                m_request = -1;
+                m_cv.notify_all();
+                continue;
+            }
+            lock.lock();
+            m_loaded = (int)record;
+            m_request = -1;
+            m_cv.notify_all();
+        }
+    }
+    int m_ncid;
+    std::vector<int> m_varids;
+    std::vector<std::vector<size_t>> m_count;
+    std::vector<thrust::host_vector<T>> m_front, m_back;
+    size_t m_num_records = 0;
+    int m_request = -1, m_loaded = -1;
+    bool m_shutdown = false;
+    std::exception_ptr m_exception = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_reader;
+};
+///@brief Most common instantiation of \c RecordReader_t
+using RecordReader = RecordReader_t<double>;
+
 ///@}
 } //namespace file
 } //namespace dg
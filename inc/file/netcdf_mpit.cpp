@@ -57,6 +57,27 @@ int main(int argc, char* argv[])
         if(rank==0)err = nc_put_vara_double( ncid, tvarID, &Tstart, &Tcount, &time);
     }
     if(rank==0)err = nc_close(ncid);
+#ifdef DG_PARALLEL_NETCDF
+    //repeat with collective parallel writes (no gather to the master rank)
+    if(rank==0)std::cout<<"Repeat with parallel writes to testmpi_par.nc\n";
+    err = dg::file::create_par( "testmpi_par.nc", NC_CLOBBER,
+        grid.communicator(), &ncid);
+    err = dg::file::define_dimensions( ncid, dimids, &tvarID, grid);
+    err = dg::file::def_var_par( ncid, "data", 4, dimids, grid, &dataID);
+    err = nc_enddef( ncid);
+    for(unsigned i=0; i<=NT; i++)
+    {
+        if(rank==0)std::cout<<"Write timestep "<<i<<"\n";
+        time = i*dt;
+        Tstart = i;
+        data = dg::evaluate( function, grid);
+        dg::blas1::scal( data, cos( time));
+        //each process writes its own hyperslab (one timeslice)
+        dg::file::put_vara_double( ncid, dataID, i, grid, data, true);
+        if(rank==0)err = nc_put_vara_double( ncid, tvarID, &Tstart, &Tcount, &time);
+    }
+    err = nc_close(ncid);
+#endif //DG_PARALLEL_NETCDF
     MPI_Finalize();
     return 0;
 }
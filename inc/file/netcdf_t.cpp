@@ -34,9 +34,10 @@ int main()
     int dim_ids[4], tvarID;
     err = dg::file::define_dimensions( ncid, dim_ids, &tvarID, g);
 
-    int dataID, scalarID, vectorID[3];
+    int dataID, scalarID, lossyID, vectorID[3];
     err = nc_def_var( ncid, "data", NC_DOUBLE, 1, dim_ids, &dataID);
     err = nc_def_var( ncid, "scalar", NC_DOUBLE, 4, dim_ids, &scalarID);
+    err = dg::file::def_var_deflate( ncid, "scalar_lossy", 4, dim_ids, &lossyID);
     err = nc_def_var( ncid, "vectorX", NC_DOUBLE, 4, dim_ids, &vectorID[0]);
     err = nc_def_var( ncid, "vectorY", NC_DOUBLE, 4, dim_ids, &vectorID[1]);
     err = nc_def_var( ncid, "vectorZ", NC_DOUBLE, 4, dim_ids, &vectorID[2]);
@@ -55,6 +56,8 @@ int main()
         err = nc_put_vara_double( ncid, dataID, start, count, &energy);
         //write scalar field
         err = nc_put_vara_double( ncid, scalarID, start, count, data.data());
+        //write compressed scalar field keeping 5 significant digits
+        dg::file::put_vara_double_lossy( ncid, lossyID, i, g, data, 1e-5);
         //write vector field
         HVec dataX = dg::evaluate( gradientX, g);
         HVec dataY = dg::evaluate( gradientY, g);
@@ -69,6 +72,66 @@ int main()
         err = nc_put_vara_double( ncid, tvarID, &Tstart, &Tcount, &time);
     }
 
+    std::cout << "WRITE THE SCALAR FIELD AGAIN FROM THE ASYNCHRONOUS WRITER THREAD\n";
+    int asyncID;
+    err = nc_redef( ncid);
+    err = nc_def_var( ncid, "scalar_async", NC_DOUBLE, 4, dim_ids, &asyncID);
+    err = nc_enddef( ncid);
+    {
+        dg::file::AsyncWriter<dg::Grid3d> writer( g, 2);
+        for(unsigned i=0; i<=NT; i++)
+        {
+            double time = i*h;
+            data = dg::evaluate( function, g);
+            dg::blas1::scal( data, cos( time));
+            writer.queue_vara_double( ncid, asyncID, i, data);
+        }
+        writer.flush(); //all records must be on disk before nc_close
+    }
+
+    std::cout << "WRITE THE SCALAR TIME SERIES AGAIN FROM THE BUFFERED RECORD WRITER\n";
+    int bufferedID;
+    err = nc_redef( ncid);
+    err = nc_def_var( ncid, "data_buffered", NC_DOUBLE, 1, dim_ids, &bufferedID);
+    err = nc_enddef( ncid);
+    {
+        dg::file::BufferedRecordWriter recorder;
+        for(unsigned i=0; i<=NT; i++)
+        {
+            double time = i*h;
+            data = dg::evaluate( function, g);
+            dg::blas1::scal( data, cos( time));
+            double energy = dg::blas1::dot( data, data);
+            recorder.queue_vara_double( ncid, bufferedID, i, energy);
+        }
+        recorder.flush(); //all records must be on disk before nc_close
+    }
+
+    std::cout << "READ THE FIELDS BACK WITH THE STREAMING RECORD READER\n";
+    {
+        dg::file::RecordReader reader( ncid,
+            std::vector<std::string>{"scalar", "vectorX", "data"});
+        double read_err = 0.;
+        for( unsigned i=0; i<reader.num_records(); i++)
+        {
+            reader.read( i); //prefetches record i+1 while we compute
+            double time = i*h;
+            data = dg::evaluate( function, g);
+            dg::blas1::scal( data, cos( time));
+            double energy = dg::blas1::dot( data, data);
+            HVec diff( reader.data( 0));
+            dg::blas1::axpby( 1., data, -1., diff);
+            read_err = std::max( read_err, sqrt( dg::blas1::dot( diff, diff)));
+            HVec dataX = dg::evaluate( gradientX, g);
+            dg::blas1::scal( dataX, cos( time));
+            dg::blas1::copy( reader.data( 1), diff);
+            dg::blas1::axpby( 1., dataX, -1., diff);
+            read_err = std::max( read_err, sqrt( dg::blas1::dot( diff, diff)));
+            read_err = std::max( read_err, fabs( reader.data( 2)[0] - energy));
+        }
+        std::cout << "Max read-back error "<<read_err<<" (0)\n";
+    }
+
     err = nc_close(ncid);
     return 0;
 }
@@ -337,7 +337,7 @@ in arbitrary coordinates
 * @ingroup fieldaligned
 * @tparam ProductGeometry must be either \c dg::aProductGeometry3d or \c dg::aProductMPIGeometry3d or any derivative
 * @tparam IMatrix The type of the interpolation matrix
-    - \c dg::IHMatrix, or \c dg::IDMatrix, \c dg::MIHMatrix, or \c dg::MIDMatrix
+    - \c dg::IHMatrix, or \c dg::IDMatrix, \c dg::MIHMatrix, or \c dg::MIDMatrix (use \c dg::IEllMatrix or \c dg::MIEllMatrix for the fastest application on GPUs)
 * @tparam Matrix The matrix class of the jump matrix
     - \c dg::HMatrix, or \c dg::DMatrix, \c dg::MHMatrix, or \c dg::MDMatrix
 * @tparam container The container-class on which the interpolation matrix operates on
@@ -479,16 +479,14 @@ struct DS
     * @copydoc hide_ds_parameters4
     */
     void centered( double alpha, const container& f, double beta, container& g){
-        m_fa(einsPlus,  f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         ds_centered( m_fa, alpha, m_tempM, m_tempP, beta, g);
     }
     /// Same as \c dg::geo::ds_centered after \c dg::geo::ds_assign_bc_along_field_2nd
     void centered_bc_along_field(
         double alpha, const container& f, double beta, container& g, dg::bc bound,
         std::array<double,2> boundary_value = {0,0}){
-        m_fa(einsPlus,  f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         assign_bc_along_field_2nd( m_fa, m_tempM, f, m_tempP, m_tempM, m_tempP,
                 bound, boundary_value);
         ds_centered( m_fa, alpha, m_tempM, m_tempP, beta, g);
@@ -542,8 +540,7 @@ struct DS
     ///@copydoc hide_ds_parameters4
     ///@copydoc hide_ds_attention
     void divCentered(double alpha, const container& f, double beta, container& g){
-        m_fa(einsPlus,  f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         ds_divCentered( m_fa, alpha, m_tempM, m_tempP, beta, g);
     }
     ///@brief forward divergence \f$ g = \nabla\cdot(\vec v f)\f$
@@ -631,8 +628,7 @@ struct DS
      * @copydoc hide_ds_parameters4
      */
     void dss( double alpha, const container& f, double beta, container& g){
-        m_fa(einsPlus, f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         m_fa(zeroForw,  f, m_tempO);
         dss_centered( m_fa, alpha, m_tempM, m_tempO, m_tempP, beta, g);
     }
@@ -640,8 +636,7 @@ struct DS
     void dss_bc_along_field(
         double alpha, const container& f, double beta, container& g, dg::bc bound,
         std::array<double,2> boundary_value = {0,0}){
-        m_fa(einsPlus, f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         m_fa(zeroForw,  f, m_tempO);
         assign_bc_along_field_2nd( m_fa, m_tempM, m_tempO, m_tempP, m_tempM, m_tempP,
                 bound, boundary_value);
@@ -650,8 +645,7 @@ struct DS
     /// Same as \c dg::geo::dssd_centered
     void dssd( double alpha, const container& f, double
             beta, container& g){
-        m_fa(einsPlus, f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         m_fa(zeroForw,  f, m_tempO);
         dssd_centered( m_fa, alpha, m_tempM, m_tempO, m_tempP, beta, g);
     }
@@ -659,8 +653,7 @@ struct DS
     void dssd_bc_along_field( double alpha, const
             container& f, double beta, container& g, dg::bc bound,
             std::array<double,2> boundary_value = {0,0}){
-        m_fa(einsPlus, f, m_tempP);
-        m_fa(einsMinus, f, m_tempM);
+        m_fa.ePlusMinus( f, m_tempP, m_tempM);
         m_fa(zeroForw,  f, m_tempO);
         assign_bc_along_field_2nd( m_fa, m_tempM, m_tempO, m_tempP, m_tempM, m_tempP,
                 bound, boundary_value);
@@ -1,6 +1,9 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 #include <array>
+#include <map>
+#include <memory>
 #include <cusp/csr_matrix.h>
 
 #include "dg/algorithm.h"
@@ -134,6 +137,131 @@ struct DSField
     dg::ClonePtr<dg::aGeometry2d> m_g;
 };
 
+//POD view of the three Legendre coefficient fields of a DSField usable
+//inside DG_DEVICE lambdas: evaluates the lspace branch of dg::interpolate
+//including the boundary shifts, with the Legendre polynomials computed on
+//the fly
+template<class real_type>
+struct DSFieldView
+{
+    const real_type* dzetadphi, *detadphi, *dvdphi;
+    real_type gx0, gx1, gy0, gy1;
+    unsigned nx, ny, Nx, Ny;
+    dg::bc bcx, bcy;
+    DG_DEVICE void operator()( real_type x, real_type y, real_type v,
+        real_type& yp0, real_type& yp1, real_type& yp2) const
+    {
+        bool negative = false;
+        shift( negative, x, gx0, gx1, bcx);
+        shift( negative, y, gy0, gy1, bcy);
+        real_type px[20], py[20]; //dg::DLT limits n < 21
+        real_type xnn = (x-gx0)/((gx1-gx0)/(real_type)Nx);
+        real_type ynn = (y-gy0)/((gy1-gy0)/(real_type)Ny);
+        unsigned nn = (unsigned)floor(xnn), mm = (unsigned)floor(ynn);
+        real_type xn = 2.*xnn - (real_type)(2*nn+1);
+        real_type yn = 2.*ynn - (real_type)(2*mm+1);
+        if( nn == Nx) nn -= 1, xn = 1.;
+        if( mm == Ny) mm -= 1, yn = 1.;
+        coefficients( xn, px, nx), coefficients( yn, py, ny);
+        unsigned cols = mm*Nx*ny*nx + nn*nx;
+        real_type f0 = 0, f1 = 0, f2 = 0;
+        for( unsigned i=0; i<ny; i++)
+            for( unsigned j=0; j<nx; j++)
+            {
+                unsigned k = cols + i*Nx*nx + j;
+                real_type p = px[j]*py[i];
+                f0 = DG_FMA( dzetadphi[k], p, f0);
+                f1 = DG_FMA( detadphi[k],  p, f1);
+                f2 = DG_FMA( dvdphi[k],    p, f2);
+            }
+        if( negative)
+            f0 = -f0, f1 = -f1, f2 = -f2;
+        yp0 = f0, yp1 = f1, yp2 = f2*v;
+    }
+    private:
+    DG_DEVICE static void coefficients( real_type xn, real_type* px, unsigned n)
+    {
+        px[0] = 1.;
+        if( n > 1)
+        {
+            px[1] = xn;
+            for( unsigned i=1; i<n-1; i++)
+                px[i+1] = ((real_type)(2*i+1)*xn*px[i] -
+                        (real_type)i*px[i-1])/(real_type)(i+1);
+        }
+    }
+    //same as aRealTopology::shift
+    DG_DEVICE static void shift( bool& negative, real_type& x, real_type x0,
+            real_type x1, dg::bc bcx)
+    {
+        if( bcx == dg::PER)
+        {
+            real_type N = floor((x-x0)/(x1-x0)); // ... -2[ -1[ 0[ 1[ 2[ ...
+            x = x - N*(x1-x0); //shift
+        }
+        //mirror along boundary as often as necessary
+        while( (x<x0) || (x>x1) )
+        {
+            if( x < x0){
+                x = 2.*x0 - x;
+                //every mirror swaps the sign if Dirichlet
+                if( bcx == dg::DIR || bcx == dg::DIR_NEU)
+                    negative = !negative;//swap sign
+            }
+            if( x > x1){
+                x = 2.*x1 - x;
+                if( bcx == dg::DIR || bcx == dg::NEU_DIR) //notice the different boundary NEU_DIR to the above DIR_NEU !
+                    negative = !negative; //swap sign
+            }
+        }
+    }
+};
+
+//Batched version of DSField: the components of y are the x- and y-
+//coordinates and the volume ratios of ALL fieldlines at once in a
+//structure-of-array state, so the right hand side is a single
+//interpolation kernel over all fieldlines and the whole ensemble can be
+//advanced on the device by the ordinary ODE integrators
+template<class real_type, class Container>
+struct DSFieldBatched
+{
+    DSFieldBatched() = default;
+    //z component of v may not vanish
+    DSFieldBatched( const dg::geo::CylindricalVectorLvl1& v,
+            const dg::aRealGeometry2d<real_type>& g): m_g(g)
+    {
+        thrust::host_vector<real_type> v_zeta, v_eta;
+        dg::pushForwardPerp( v.x(), v.y(), v_zeta, v_eta, g);
+        thrust::host_vector<real_type> vz = dg::pullback( v.z(), g);
+        thrust::host_vector<real_type> divvvz = dg::pullback( v.divvvz(), g);
+        dg::blas1::pointwiseDivide( v_zeta, vz, v_zeta);
+        dg::blas1::pointwiseDivide( v_eta,  vz, v_eta);
+        m_dzetadphi = dg::construct<Container>( dg::forward_transform( v_zeta, *m_g));
+        m_detadphi  = dg::construct<Container>( dg::forward_transform( v_eta, *m_g));
+        m_dvdphi    = dg::construct<Container>( dg::forward_transform( divvvz, *m_g));
+    }
+    void operator()( real_type t, const std::array<Container,3>& y,
+            std::array<Container,3>& yp) const
+    {
+        DSFieldView<real_type> view{
+            thrust::raw_pointer_cast( m_dzetadphi.data()),
+            thrust::raw_pointer_cast( m_detadphi.data()),
+            thrust::raw_pointer_cast( m_dvdphi.data()),
+            m_g->x0(), m_g->x1(), m_g->y0(), m_g->y1(),
+            m_g->nx(), m_g->ny(), m_g->Nx(), m_g->Ny(),
+            m_g->bcx(), m_g->bcy()};
+        dg::blas2::parallel_for( [view]DG_DEVICE( unsigned i,
+            const real_type* xx, const real_type* yy, const real_type* vv,
+            real_type* p0, real_type* p1, real_type* p2)
+            {
+                view( xx[i], yy[i], vv[i], p0[i], p1[i], p2[i]);
+            }, y[0].size(), y[0], y[1], y[2], yp[0], yp[1], yp[2]);
+    }
+    private:
+    Container m_dzetadphi, m_detadphi, m_dvdphi;
+    dg::ClonePtr<dg::aRealGeometry2d<real_type>> m_g;
+};
+
 //used in constructor of Fieldaligned
 template<class real_type>
 void integrate_all_fieldlines2d( const dg::geo::CylindricalVectorLvl1& vec,
@@ -171,18 +299,37 @@ void integrate_all_fieldlines2d( const dg::geo::CylindricalVectorLvl1& vec,
         odeint = dg::AdaptiveTimeloop<std::array<real_type,3>>( adapt,
                 field, dg::pid_control, dg::fast_l2norm, eps, 1e-10);
 
-    for( unsigned i=0; i<size; i++)
+    //advance all fieldlines simultaneously as one SoA state on the device;
+    //the batched right hand side is a single interpolation kernel and the
+    //sup norm keeps the error control per fieldline at least as strict as
+    //the sequential integration
     {
-        std::array<real_type,3> coords{y[0][i],y[1][i],y[2][i]}, coordsP;
-        //x,y,s
-        real_type phi1 = deltaPhi;
-        odeint.set_dt( deltaPhi/2.);
-        odeint.integrate( 0, coords, phi1, coordsP);
-        yp[0][i] = coordsP[0], yp[1][i] = coordsP[1], yp[2][i] = coordsP[2];
+        using DVec = thrust::device_vector<real_type>;
+        DSFieldBatched<real_type, DVec> batched( vec, grid_field);
+        std::array<DVec,3> yd, ypd;
+        for( unsigned u=0; u<3; u++)
+            yd[u] = ypd[u] = dg::construct<DVec>( y[u]);
+        dg::Adaptive<dg::ERKStep<std::array<DVec,3>>> badapt(
+                "Dormand-Prince-7-4-5", yd);
+        auto sup_norm = []( const std::array<DVec,3>& x)
+        {
+            real_type norm = 0;
+            for( unsigned u=0; u<3; u++)
+                norm = std::max( norm, dg::blas1::reduce( x[u], (real_type)0,
+                            dg::AbsMax<real_type>()));
+            return norm;
+        };
+        dg::AdaptiveTimeloop<std::array<DVec,3>> bodeint( badapt,
+                batched, dg::pid_control, sup_norm, eps, 1e-10);
+        bodeint.set_dt( deltaPhi/2.);
+        bodeint.integrate( 0, yd, deltaPhi, ypd);
+        for( unsigned u=0; u<3; u++)
+            dg::assign( ypd[u], yp[u]);
     }
     yp2b.assign( grid_evaluate.size(), deltaPhi); //allocate memory for output
     in_boxp.resize( yp2b.size());
     //Now integrate again but this time find the boundary distance
+    odeint.set_dt( deltaPhi/2.);
     for( unsigned i=0; i<size; i++)
     {
         std::array<real_type,3> coords{y[0][i],y[1][i],y[2][i]}, coordsP;
@@ -199,6 +346,234 @@ void integrate_all_fieldlines2d( const dg::geo::CylindricalVectorLvl1& vec,
 }
 
 
+//FNV-1a over the bytes of a vector of doubles
+inline uint64_t fnv1a( const std::vector<double>& v)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const unsigned char* bytes =
+        reinterpret_cast<const unsigned char*>( v.data());
+    for( unsigned i=0; i<v.size()*sizeof(double); i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash;
+}
+//fingerprint grid, vector field and integrator parameters; two keys agree
+//only if the fieldline integration would yield the same result
+template<class real_type>
+uint64_t fieldline_cache_key( const dg::geo::CylindricalVectorLvl1& vec,
+    const dg::aRealTopology2d<real_type>& grid, real_type deltaPhi,
+    real_type eps)
+{
+    std::vector<double> key = { grid.x0(), grid.x1(), grid.y0(), grid.y1(),
+        (double)grid.nx(), (double)grid.ny(),
+        (double)grid.Nx(), (double)grid.Ny(),
+        (double)grid.bcx(), (double)grid.bcy(),
+        (double)deltaPhi, (double)eps};
+    //sample the vector field on a coarse lattice as a magnetic field hash
+    for( unsigned i=0; i<16; i++)
+    for( unsigned j=0; j<16; j++)
+    {
+        double R = grid.x0() + (i+0.5)/16.*grid.lx();
+        double Z = grid.y0() + (j+0.5)/16.*grid.ly();
+        key.push_back( vec.x()(R,Z));
+        key.push_back( vec.y()(R,Z));
+        key.push_back( vec.z()(R,Z));
+    }
+    return fnv1a( key);
+}
+#ifdef _NETCDF_
+//Read previously integrated fieldlines from file; returns false if the file
+//does not exist or was written for a different key
+inline bool read_fieldline_cache( std::string file, uint64_t key,
+    unsigned size,
+    std::array<thrust::host_vector<double>,3>& yp,
+    thrust::host_vector<double>& hbp, thrust::host_vector<bool>& in_boxp,
+    std::array<thrust::host_vector<double>,3>& ym,
+    thrust::host_vector<double>& hbm, thrust::host_vector<bool>& in_boxm)
+{
+    int ncid;
+    if( nc_open( file.data(), NC_NOWRITE, &ncid) != NC_NOERR)
+        return false;
+    unsigned long long stored = 0;
+    size_t len = 0;
+    int dimid;
+    if( nc_get_att_ulonglong( ncid, NC_GLOBAL, "key", &stored) != NC_NOERR
+        || stored != key
+        || nc_inq_dimid( ncid, "points", &dimid) != NC_NOERR
+        || nc_inq_dimlen( ncid, dimid, &len) != NC_NOERR
+        || len != (size_t)size)
+    {
+        nc_close( ncid);
+        return false;
+    }
+    std::array<thrust::host_vector<double>,3>* ys[2] = {&yp, &ym};
+    thrust::host_vector<double>* hbs[2] = {&hbp, &hbm};
+    thrust::host_vector<bool>* boxs[2] = {&in_boxp, &in_boxm};
+    std::string sign[2] = {"p", "m"}, coord[3] = {"R", "Z", "s"};
+    int varid, retval = 0;
+    for( unsigned s=0; s<2; s++)
+    {
+        for( unsigned i=0; i<3; i++)
+        {
+            (*ys[s])[i].resize( size);
+            retval = nc_inq_varid( ncid, ("y"+sign[s]+coord[i]).data(), &varid);
+            if( retval) break;
+            retval = nc_get_var_double( ncid, varid, (*ys[s])[i].data());
+            if( retval) break;
+        }
+        if( retval) break;
+        hbs[s]->resize( size);
+        retval = nc_inq_varid( ncid, ("hb"+sign[s]).data(), &varid);
+        if( retval) break;
+        retval = nc_get_var_double( ncid, varid, hbs[s]->data());
+        if( retval) break;
+        std::vector<signed char> box( size);
+        retval = nc_inq_varid( ncid, ("in_box"+sign[s]).data(), &varid);
+        if( retval) break;
+        retval = nc_get_var_schar( ncid, varid, box.data());
+        if( retval) break;
+        boxs[s]->resize( size);
+        for( unsigned i=0; i<size; i++)
+            (*boxs[s])[i] = (bool)box[i];
+    }
+    nc_close( ncid);
+    return retval == 0;
+}
+//Write integrated fieldlines to file (overwrites existing file)
+inline void write_fieldline_cache( std::string file, uint64_t key,
+    const std::array<thrust::host_vector<double>,3>& yp,
+    const thrust::host_vector<double>& hbp,
+    const thrust::host_vector<bool>& in_boxp,
+    const std::array<thrust::host_vector<double>,3>& ym,
+    const thrust::host_vector<double>& hbm,
+    const thrust::host_vector<bool>& in_boxm)
+{
+    int ncid;
+    if( nc_create( file.data(), NC_NETCDF4|NC_CLOBBER, &ncid) != NC_NOERR)
+    {
+        std::cerr << "# WARNING: Cannot create fieldline cache "<<file<<"!\n";
+        return;
+    }
+    unsigned size = yp[0].size();
+    unsigned long long stored = key;
+    nc_put_att_ulonglong( ncid, NC_GLOBAL, "key", NC_UINT64, 1, &stored);
+    int dimid, varids[10];
+    nc_def_dim( ncid, "points", size, &dimid);
+    std::string names[10] = { "ypR", "ypZ", "yps", "hbp", "in_boxp",
+                              "ymR", "ymZ", "yms", "hbm", "in_boxm"};
+    for( unsigned i=0; i<10; i++)
+        nc_def_var( ncid, names[i].data(), i%5==4 ? NC_BYTE : NC_DOUBLE, 1,
+            &dimid, &varids[i]);
+    nc_enddef( ncid);
+    const std::array<thrust::host_vector<double>,3>* ys[2] = {&yp, &ym};
+    const thrust::host_vector<double>* hbs[2] = {&hbp, &hbm};
+    const thrust::host_vector<bool>* boxs[2] = {&in_boxp, &in_boxm};
+    for( unsigned s=0; s<2; s++)
+    {
+        for( unsigned i=0; i<3; i++)
+            nc_put_var_double( ncid, varids[5*s+i], (*ys[s])[i].data());
+        nc_put_var_double( ncid, varids[5*s+3], hbs[s]->data());
+        std::vector<signed char> box( size);
+        for( unsigned i=0; i<size; i++)
+            box[i] = (*boxs[s])[i];
+        nc_put_var_schar( ncid, varids[5*s+4], box.data());
+    }
+    nc_close( ncid);
+}
+#endif //_NETCDF_
+
+//In-memory cache of integrated fieldlines: feltor constructs several
+//Fieldaligned objects on the same grid and vector field (e.g. for different
+//parallel boundary conditions) and each would repeat the integration
+struct FieldlineTrajectories
+{
+    std::array<thrust::host_vector<double>,3> yp, ym;
+    thrust::host_vector<double> hbp, hbm;
+    thrust::host_vector<bool> in_boxp, in_boxm;
+};
+inline std::map<uint64_t, std::shared_ptr<const FieldlineTrajectories>>&
+    fieldline_memory_cache()
+{
+    static std::map<uint64_t, std::shared_ptr<const FieldlineTrajectories>>
+        cache;
+    return cache;
+}
+//extends the fieldline fingerprint with everything that enters the assembly
+//of the parallel interpolation matrices
+inline uint64_t matrix_cache_key( uint64_t fieldline_key, dg::bc bcx,
+    dg::bc bcy, unsigned mx, unsigned my, std::string interpolation_method)
+{
+    std::vector<double> key = { (double)(fieldline_key>>32),
+        (double)(fieldline_key&0xffffffffull), (double)bcx, (double)bcy,
+        (double)mx, (double)my};
+    for( char c : interpolation_method)
+        key.push_back( (double)c);
+    return fnv1a( key);
+}
+//Constructions with the same key share the assembled plus, zero and minus
+//matrices; weak pointers so the (device) memory is released once the last
+//owning Fieldaligned instance dies
+template<class IMatrix>
+std::map<uint64_t, std::array<std::weak_ptr<IMatrix>,3>>& matrix_memory_cache()
+{
+    static std::map<uint64_t, std::array<std::weak_ptr<IMatrix>,3>> cache;
+    return cache;
+}
+
+//In-memory cache of evaluated wall fieldline functors (sheath setup):
+//feltor evaluates the sheath coordinate on the same grid more than once
+inline std::map<uint64_t, thrust::host_vector<double>>& sheath_memory_cache()
+{
+    static std::map<uint64_t, thrust::host_vector<double>> cache;
+    return cache;
+}
+#ifdef _NETCDF_
+//Read a previously evaluated wall fieldline functor from file; returns false
+//if the file does not exist or was written for a different key
+inline bool read_sheath_cache( std::string file, uint64_t key, unsigned size,
+    thrust::host_vector<double>& values)
+{
+    int ncid;
+    if( nc_open( file.data(), NC_NOWRITE, &ncid) != NC_NOERR)
+        return false;
+    unsigned long long stored = 0;
+    size_t len = 0;
+    int dimid, varid;
+    if( nc_get_att_ulonglong( ncid, NC_GLOBAL, "key", &stored) != NC_NOERR
+        || stored != key
+        || nc_inq_dimid( ncid, "points", &dimid) != NC_NOERR
+        || nc_inq_dimlen( ncid, dimid, &len) != NC_NOERR
+        || len != (size_t)size
+        || nc_inq_varid( ncid, "values", &varid) != NC_NOERR)
+    {
+        nc_close( ncid);
+        return false;
+    }
+    values.resize( size);
+    int retval = nc_get_var_double( ncid, varid, values.data());
+    nc_close( ncid);
+    return retval == 0;
+}
+//Write an evaluated wall fieldline functor to file (overwrites existing file)
+inline void write_sheath_cache( std::string file, uint64_t key,
+    const thrust::host_vector<double>& values)
+{
+    int ncid;
+    if( nc_create( file.data(), NC_NETCDF4|NC_CLOBBER, &ncid) != NC_NOERR)
+    {
+        std::cerr << "# WARNING: Cannot create sheath cache "<<file<<"!\n";
+        return;
+    }
+    unsigned long long stored = key;
+    nc_put_att_ulonglong( ncid, NC_GLOBAL, "key", NC_UINT64, 1, &stored);
+    int dimid, varid;
+    nc_def_dim( ncid, "points", values.size(), &dimid);
+    nc_def_var( ncid, "values", NC_DOUBLE, 1, &dimid, &varid);
+    nc_enddef( ncid);
+    nc_put_var_double( ncid, varid, values.data());
+    nc_close( ncid);
+}
+#endif //_NETCDF_
+
 }//namespace detail
 ///@endcond
 
@@ -362,6 +737,121 @@ struct WallFieldlineCoordinate : public aCylindricalFunctor<WallFieldlineCoordin
     std::string m_type;
 };
 
+/**
+ * @brief Evaluate a wall fieldline functor on all points of a grid (with caching)
+ *
+ * Same result as \c dg::evaluate of \c WallFieldlineDistance (\c mode ==
+ * "distance") or \c WallFieldlineCoordinate (\c mode == "coordinate") on \c
+ * grid, except that the independent fieldlines through the evaluation points
+ * are integrated in parallel (OpenMP) and the result is cached: in memory
+ * within the process and, if \c cache_file is given, in a netcdf file keyed
+ * by a fingerprint of wall domain, grid, vector field and integrator
+ * parameters (cf. the \c Fieldaligned cache). A stale or foreign file is
+ * silently recomputed and overwritten, so the sheath setup of a simulation
+ * becomes a one-time cost per magnetic configuration.
+ * @param vec The vector field to integrate
+ * @param walls The box
+ * @param grid The grid on which to evaluate
+ * @param maxPhi the maximum angle to integrate to
+ * @param eps the accuracy of the fieldline integrator
+ * @param type either "phi" or "s", see \c WallFieldlineDistance
+ * @param mode either "distance" or "coordinate"
+ * @param cache_file If non-empty, cache the result in this file (needs
+ * netcdf; without netcdf a runtime warning is produced and the parameter
+ * is ignored)
+ * @return the functor evaluated on all points of \c grid
+ * @ingroup fluxfunctions
+ */
+inline thrust::host_vector<double> wall_fieldline_evaluate(
+    const dg::geo::CylindricalVectorLvl0& vec,
+    const dg::aRealTopology2d<double>& walls,
+    const dg::aRealTopology2d<double>& grid,
+    double maxPhi, double eps, std::string type, std::string mode,
+    std::string cache_file = "")
+{
+    if( mode != "distance" && mode != "coordinate")
+        throw std::runtime_error( "Mode "+mode+" not recognized!\n");
+    //fingerprint everything that enters the integration
+    std::vector<double> fingerprint = { walls.x0(), walls.x1(), walls.y0(),
+        walls.y1(), grid.x0(), grid.x1(), grid.y0(), grid.y1(),
+        (double)grid.nx(), (double)grid.ny(), (double)grid.Nx(),
+        (double)grid.Ny(), maxPhi, eps, (double)(mode == "distance")};
+    for( char c : type)
+        fingerprint.push_back( (double)c);
+    //sample the vector field on a coarse lattice as a magnetic field hash
+    for( unsigned i=0; i<16; i++)
+    for( unsigned j=0; j<16; j++)
+    {
+        double R = grid.x0() + (i+0.5)/16.*grid.lx();
+        double Z = grid.y0() + (j+0.5)/16.*grid.ly();
+        fingerprint.push_back( vec.x()(R,Z));
+        fingerprint.push_back( vec.y()(R,Z));
+        fingerprint.push_back( vec.z()(R,Z));
+    }
+    uint64_t key = detail::fnv1a( fingerprint);
+    auto& cache = detail::sheath_memory_cache();
+    auto entry = cache.find( key);
+    if( entry != cache.end())
+        return entry->second;
+#ifdef _NETCDF_
+    if( !cache_file.empty())
+    {
+        thrust::host_vector<double> values;
+        if( detail::read_sheath_cache( cache_file, key, grid.size(), values))
+        {
+            cache[key] = values;
+            return values;
+        }
+    }
+#else
+    if( !cache_file.empty())
+        std::cerr << "# WARNING: Sheath cache "<<cache_file<<" requested but netcdf.h is not included! Continuing without cache!\n";
+#endif //_NETCDF_
+    dg::geo::CylindricalFunctor func;
+    if( "distance" == mode)
+        func = WallFieldlineDistance( vec, walls, maxPhi, eps, type);
+    else
+        func = WallFieldlineCoordinate( vec, walls, maxPhi, eps, type);
+    thrust::host_vector<double> x = dg::evaluate( dg::cooX2d, grid);
+    thrust::host_vector<double> y = dg::evaluate( dg::cooY2d, grid);
+    thrust::host_vector<double> values( grid.size());
+    const int size = grid.size();
+    //the fieldlines through the evaluation points are independent; dynamic
+    //schedule because lines near the wall are much cheaper than core lines
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for( int i=0; i<size; i++)
+        values[i] = func( x[i], y[i]);
+#ifdef _NETCDF_
+    if( !cache_file.empty())
+        detail::write_sheath_cache( cache_file, key, values);
+#endif //_NETCDF_
+    cache[key] = values;
+    return values;
+}
+#ifdef MPI_VERSION
+///@copydoc wall_fieldline_evaluate()
+///@note Each rank evaluates and caches its local portion of the grid; the
+///cache file name is therefore suffixed with the rank
+inline dg::MPI_Vector<thrust::host_vector<double>> wall_fieldline_evaluate(
+    const dg::geo::CylindricalVectorLvl0& vec,
+    const dg::aRealTopology2d<double>& walls,
+    const dg::aRealMPITopology2d<double>& grid,
+    double maxPhi, double eps, std::string type, std::string mode,
+    std::string cache_file = "")
+{
+    int rank;
+    MPI_Comm_rank( grid.communicator(), &rank);
+    if( !cache_file.empty())
+        cache_file += "_"+std::to_string(rank);
+    thrust::host_vector<double> values = wall_fieldline_evaluate( vec, walls,
+        grid.local(), maxPhi, eps, type, mode, cache_file);
+    return dg::MPI_Vector<thrust::host_vector<double>>( values,
+        grid.communicator());
+}
+#endif //MPI_VERSION
+
 
     /*!@class hide_fieldaligned_physics_parameters
     * @tparam Limiter Class that can be evaluated on a 2d grid, returns 1 if there
@@ -414,6 +904,19 @@ struct WallFieldlineCoordinate : public aCylindricalFunctor<WallFieldlineCoordin
      * to \c create::projection (from the fine grid to the given grid)
      *
      * @param benchmark If true write construction timings to std::cout
+     * @param cache_file If non-empty, cache the fieldline integration in the
+     * given NetCDF file: if the file exists and was written for the same grid,
+     * vector field, \c deltaPhi and \c eps (checked through a hash stored in
+     * the file), the integration is skipped entirely and the fieldlines are
+     * read back, which reduces construction time on restarts from minutes to
+     * seconds at production resolution; otherwise the fieldlines are
+     * integrated and the file is (over)written. Since a stale cache is
+     * detected through the hash the file can be kept between parameter
+     * changes. In the MPI version each process appends its rank to the
+     * filename and caches its local fieldlines.
+     * @attention The cache is only available if \c netcdf.h is included
+     * before this header (e.g. through \c dg/file/nc_utilities.h), else a
+     * non-empty \c cache_file produces a runtime warning and is ignored.
     */
 //////////////////////////////FieldalignedCLASS////////////////////////////////////////////
 /**
@@ -423,7 +926,7 @@ struct WallFieldlineCoordinate : public aCylindricalFunctor<WallFieldlineCoordin
 * @snippet ds_t.cu doxygen
 * @tparam ProductGeometry must be either \c dg::aProductGeometry3d or \c dg::aProductMPIGeometry3d or any derivative
 * @tparam IMatrix The type of the interpolation matrix
-    - \c dg::IHMatrix, or \c dg::IDMatrix, \c dg::MIHMatrix, or \c dg::MIDMatrix
+    - \c dg::IHMatrix, or \c dg::IDMatrix, \c dg::MIHMatrix, or \c dg::MIDMatrix (use \c dg::IEllMatrix or \c dg::MIEllMatrix for the fastest application on GPUs)
 * @tparam container The container-class on which the interpolation matrix operates on
     - \c dg::HVec, or \c dg::DVec, \c dg::MHVec, or \c dg::MDVec
 * @sa The pdf <a href="https://www.overleaf.com/read/jjvstccqzcjv" target="_blank">parallel derivative</a> writeup
@@ -447,10 +950,12 @@ struct Fieldaligned
         unsigned mx=12, unsigned my=12,
         double deltaPhi = -1,
         std::string interpolation_method = "linear-nearest",
-        bool benchmark=true
+        bool benchmark=true,
+        std::string cache_file = ""
         ):
             Fieldaligned( dg::geo::createBHat(vec),
-                grid, bcx, bcy, limit, eps, mx, my, deltaPhi, interpolation_method)
+                grid, bcx, bcy, limit, eps, mx, my, deltaPhi,
+                interpolation_method, benchmark, cache_file)
     {
     }
 
@@ -467,7 +972,8 @@ struct Fieldaligned
         unsigned mx=12, unsigned my=12,
         double deltaPhi = -1,
         std::string interpolation_method = "linear-nearest",
-        bool benchmark=true
+        bool benchmark=true,
+        std::string cache_file = ""
         );
     /**
     * @brief Perfect forward parameters to one of the constructors
@@ -550,6 +1056,18 @@ struct Fieldaligned
     */
     void operator()(enum whichMatrix which, const container& in, container& out);
 
+    /**
+    * @brief Apply the plus and the minus interpolation in one plane sweep
+    *
+    * Computes the same as \c operator()(einsPlus,f,fpe) followed by
+    * \c operator()(einsMinus,f,fme) but schedules both interpolations of
+    * each plane together such that every plane of \c f is read only once
+    * @param f input
+    * @param fpe plus interpolation, may not equal input
+    * @param fme minus interpolation, may not equal input
+    */
+    void ePlusMinus( const container& f, container& fpe, container& fme);
+
     double deltaPhi() const{return m_deltaPhi;}
     ///@brief Distance between the planes and the boundary \f$ (s_{k}-s_{b}^-) \f$
     ///@return three-dimensional vector
@@ -674,7 +1192,11 @@ struct Fieldaligned
     void ePlus( enum whichMatrix which, const container& in, container& out);
     void eMinus(enum whichMatrix which, const container& in, container& out);
     void zero( enum whichMatrix which, const container& in, container& out);
-    IMatrix m_plus, m_zero, m_minus, m_plusT, m_minusT; //2d interpolation matrices
+    void planeSymv( const IMatrix& m, int shift, const container& in,
+        container& out);
+    //2d interpolation matrices; shared among instances with the same
+    //construction parameters (see matrix_memory_cache)
+    std::shared_ptr<IMatrix> m_plus, m_zero, m_minus, m_plusT, m_minusT;
     container m_hbm, m_hbp;         //3d size
     container m_G, m_Gm, m_Gp; // 3d size
     container m_bphi, m_bphiM, m_bphiP; // 3d size
@@ -695,8 +1217,8 @@ struct Fieldaligned
     bool m_have_adjoint = false;
     void updateAdjoint( )
     {
-        m_plusT = dg::transpose( m_plus);
-        m_minusT = dg::transpose( m_minus);
+        m_plusT = std::make_shared<IMatrix>( dg::transpose( *m_plus));
+        m_minusT = std::make_shared<IMatrix>( dg::transpose( *m_minus));
         m_have_adjoint = true;
     }
 };
@@ -710,7 +1232,7 @@ Fieldaligned<Geometry, IMatrix, container>::Fieldaligned(
     const dg::geo::CylindricalVectorLvl1& vec,
     const Geometry& grid,
     dg::bc bcx, dg::bc bcy, Limiter limit, double eps,
-    unsigned mx, unsigned my, double deltaPhi, std::string interpolation_method, bool benchmark) :
+    unsigned mx, unsigned my, double deltaPhi, std::string interpolation_method, bool benchmark, std::string cache_file) :
         m_g(grid),
         m_interpolation_method(interpolation_method)
 {
@@ -763,10 +1285,75 @@ Fieldaligned<Geometry, IMatrix, container>::Fieldaligned(
     thrust::host_vector<double> vol = dg::tensor::volume(grid.metric()), vol2d0;
     auto vol2d = dg::split( vol, grid);
     dg::assign( vol2d[0], vol2d0);
-    detail::integrate_all_fieldlines2d( vec, *grid_magnetic, *grid_transform,
-            yp_trafo, vol2d0, hbp, in_boxp, deltaPhi, eps);
-    detail::integrate_all_fieldlines2d( vec, *grid_magnetic, *grid_transform,
-            ym_trafo, vol2d0, hbm, in_boxm, -deltaPhi, eps);
+    bool cached = false;
+    uint64_t key = detail::fieldline_cache_key( vec, *grid_transform, deltaPhi,
+            eps);
+    //first consult the in-memory cache filled by previous constructions
+    auto& tcache = detail::fieldline_memory_cache();
+    auto trajectories = tcache.find( key);
+    if( trajectories != tcache.end())
+    {
+        yp_trafo = trajectories->second->yp, hbp = trajectories->second->hbp,
+            in_boxp = trajectories->second->in_boxp;
+        ym_trafo = trajectories->second->ym, hbm = trajectories->second->hbm,
+            in_boxm = trajectories->second->in_boxm;
+        cached = true;
+        if( benchmark)
+            std::cout << "# DS: Fieldline cache hit in memory\n";
+    }
+#ifdef _NETCDF_
+    if( !cached && !cache_file.empty())
+    {
+        cached = detail::read_fieldline_cache( cache_file, key,
+                grid_transform->size(), yp_trafo, hbp, in_boxp, ym_trafo, hbm,
+                in_boxm);
+        if( benchmark && cached)
+            std::cout << "# DS: Fieldline cache hit in "<<cache_file<<"\n";
+    }
+#else
+    if( !cache_file.empty())
+        std::cerr << "# WARNING: Fieldline cache "<<cache_file<<" requested but netcdf.h is not included! Continuing without cache!\n";
+#endif //_NETCDF_
+    if( !cached)
+    {
+        detail::integrate_all_fieldlines2d( vec, *grid_magnetic, *grid_transform,
+                yp_trafo, vol2d0, hbp, in_boxp, deltaPhi, eps);
+        detail::integrate_all_fieldlines2d( vec, *grid_magnetic, *grid_transform,
+                ym_trafo, vol2d0, hbm, in_boxm, -deltaPhi, eps);
+#ifdef _NETCDF_
+        if( !cache_file.empty())
+            detail::write_fieldline_cache( cache_file, key, yp_trafo, hbp,
+                    in_boxp, ym_trafo, hbm, in_boxm);
+#endif //_NETCDF_
+    }
+    if( trajectories == tcache.end())
+        tcache[ key] = std::make_shared<const detail::FieldlineTrajectories>(
+            detail::FieldlineTrajectories{ yp_trafo, ym_trafo, hbp, hbm,
+                in_boxp, in_boxm});
+    ///%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%//
+    //instances with identical construction parameters share the device
+    //matrices through the in-memory cache
+    uint64_t mkey = detail::matrix_cache_key( key, bcx, bcy, mx, my,
+            interpolation_method);
+    auto& mcache = detail::matrix_memory_cache<IMatrix>();
+    auto matrices = mcache.find( mkey);
+    if( matrices != mcache.end())
+    {
+        m_plus  = matrices->second[0].lock();
+        m_zero  = matrices->second[1].lock();
+        m_minus = matrices->second[2].lock();
+    }
+    if( m_plus && m_zero && m_minus)
+    {
+        if( benchmark)
+        {
+            t.toc();
+            std::cout << "# DS: Interpolation cache hit in memory\n";
+            t.tic();
+        }
+    }
+    else
+    {
     dg::HVec Xf = dg::evaluate(  dg::cooX2d, grid_fine);
     dg::HVec Yf = dg::evaluate(  dg::cooY2d, grid_fine);
     {
@@ -786,7 +1373,9 @@ Fieldaligned<Geometry, IMatrix, container>::Fieldaligned(
         std::cout << "# DS: Computing all points took: "<<t.diff()<<"\n";
         t.tic();
     }
-    ///%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%//
+    m_plus  = std::make_shared<IMatrix>();
+    m_zero  = std::make_shared<IMatrix>();
+    m_minus = std::make_shared<IMatrix>();
     if( inter_m == "dg")
     {
         dg::IHMatrix fine, projection, multi;
@@ -801,15 +1390,15 @@ Fieldaligned<Geometry, IMatrix, container>::Fieldaligned(
         fine = dg::create::interpolation( yp[0], yp[1],
             *grid_transform, bcx, bcy, "dg");
         cusp::multiply( projection, fine, multi);
-        dg::blas2::transfer( multi, m_plus);
+        dg::blas2::transfer( multi, *m_plus);
         fine = dg::create::interpolation( Xf, Yf,
             *grid_transform, bcx, bcy, "dg");
         cusp::multiply( projection, fine, multi);
-        dg::blas2::transfer( multi, m_zero);
+        dg::blas2::transfer( multi, *m_zero);
         fine = dg::create::interpolation( ym[0], ym[1],
             *grid_transform, bcx, bcy, "dg");
         cusp::multiply( projection, fine, multi);
-        dg::blas2::transfer( multi, m_minus);
+        dg::blas2::transfer( multi, *m_minus);
     }
     else
     {
@@ -829,19 +1418,19 @@ Fieldaligned<Geometry, IMatrix, container>::Fieldaligned(
             grid_equidist, bcx, bcy, inter_m);
         cusp::multiply( multi, fine, temp);
         cusp::multiply( projection, temp, multi);
-        dg::blas2::transfer( multi, m_plus);
+        dg::blas2::transfer( multi, *m_plus);
 
         multi = dg::create::interpolation( Xf, Yf,
                 grid_equidist, bcx, bcy, inter_m);
         cusp::multiply( multi, fine, temp);
         cusp::multiply( projection, temp, multi);
-        dg::blas2::transfer( multi, m_zero);
+        dg::blas2::transfer( multi, *m_zero);
 
         multi = dg::create::interpolation( ym[0], ym[1],
             grid_equidist, bcx, bcy, inter_m);
         cusp::multiply( multi, fine, temp);
         cusp::multiply( projection, temp, multi);
-        dg::blas2::transfer( multi, m_minus);
+        dg::blas2::transfer( multi, *m_minus);
     }
 
     if( benchmark)
@@ -849,6 +1438,8 @@ Fieldaligned<Geometry, IMatrix, container>::Fieldaligned(
         t.toc();
         std::cout << "# DS: Multiplication PI    took: "<<t.diff()<<"\n";
     }
+    mcache[ mkey] = { m_plus, m_zero, m_minus};
+    }
     ///%%%%%%%%%%%%%%%%%%%%copy into h vectors %%%%%%%%%%%%%%%%%%%//
     dg::HVec hbphi( yp_trafo[2]), hbphiP(hbphi), hbphiM(hbphi);
     hbphi = dg::pullback( vec.z(), *grid_transform);
@@ -949,9 +1540,9 @@ container Fieldaligned<G, I,container>::interpolate_from_coarse_grid(
         for( int j=1; j<(int)cphi; j++)
         {
             //!!! The value of f at the plus plane is I^- of the current plane
-            dg::blas2::symv( m_minus, out_split[i*cphi+j-1], out_split[i*cphi+j]);
+            dg::blas2::symv( *m_minus, out_split[i*cphi+j-1], out_split[i*cphi+j]);
             //!!! The value of f at the minus plane is I^+ of the current plane
-            dg::blas2::symv( m_plus, m_temp[(i*cphi+cphi+1-j)%Nz], m_temp[i*cphi+cphi-j]);
+            dg::blas2::symv( *m_plus, m_temp[(i*cphi+cphi+1-j)%Nz], m_temp[i*cphi+cphi-j]);
         }
     }
     //3. Now add up with appropriate weights
@@ -978,11 +1569,11 @@ void Fieldaligned<G, I,container>::integrate_between_coarse_grid( const G& grid,
     for( int j=1; j<(int)cphi; j++)
     {
         //!!! The value of f at the plus plane is I^- of the current plane
-        dg::blas2::symv( m_minus, helperP, tempP);
+        dg::blas2::symv( *m_minus, helperP, tempP);
         dg::blas1::axpby( (double)(cphi-j)/(double)cphi, tempP, 1., out  );
         helperP.swap(tempP);
         //!!! The value of f at the minus plane is I^+ of the current plane
-        dg::blas2::symv( m_plus, helperM, tempM);
+        dg::blas2::symv( *m_plus, helperM, tempM);
         dg::blas1::axpby( (double)(cphi-j)/(double)cphi, tempM, 1., out  );
         helperM.swap(tempM);
     }
@@ -999,62 +1590,82 @@ void Fieldaligned<G, I, container >::operator()(enum whichMatrix which, const co
             which == zeroForw  ) zero(   which, f, fe);
 }
 
+//The 2d interpolation matrices are the same in every plane (the fieldline map
+//only depends on the starting plane through the plane-shift), so instead of
+//Nz separate symv launches we apply the shared sparsity structure to all
+//planes in a single kernel: output plane i0 reads input plane (i0+shift)%Nz,
+//which lives at a fixed offset in the contiguous 3d vector
+template<class G, class I, class container>
+void Fieldaligned<G, I, container>::planeSymv( const I& m, int shift,
+        const container& f, container& fe)
+{
+    using real_type = dg::get_value_type<container>;
+    const int* row_offsets =
+        thrust::raw_pointer_cast( m.row_offsets.data());
+    const int* column_indices =
+        thrust::raw_pointer_cast( m.column_indices.data());
+    const real_type* values = thrust::raw_pointer_cast( m.values.data());
+    const unsigned Nz = m_Nz, perp_size = m_perp_size;
+    const unsigned s = (unsigned)((int)Nz + shift)%Nz;
+    dg::blas2::parallel_for( [=]DG_DEVICE( unsigned idx,
+        const real_type* in, real_type* out)
+    {
+        unsigned i0 = idx/perp_size, row = idx%perp_size;
+        unsigned in_offset = ((i0+s)%Nz)*perp_size;
+        real_type temp = 0;
+        for( int j = row_offsets[row]; j<row_offsets[row+1]; j++)
+            temp = DG_FMA( values[j], in[ in_offset + column_indices[j]],
+                    temp);
+        out[idx] = temp;
+    }, Nz*perp_size, f, fe);
+}
+
 template< class G, class I, class container>
 void Fieldaligned<G, I, container>::zero( enum whichMatrix which,
         const container& f, container& f0)
 {
-    dg::split( f, m_f, *m_g);
-    dg::split( f0, m_temp, *m_g);
-    //1. compute 2d interpolation in every plane and store in m_temp
-    for( unsigned i0=0; i0<m_Nz; i0++)
+    //compute 2d interpolation in every plane in a single batched kernel
+    if(which == zeroPlus)
+        planeSymv( *m_plus, 0, f, f0);
+    else if(which == zeroMinus)
+        planeSymv( *m_minus, 0, f, f0);
+    else if(which == zeroPlusT)
     {
-        if(which == zeroPlus)
-            dg::blas2::symv( m_plus,   m_f[i0], m_temp[i0]);
-        else if(which == zeroMinus)
-            dg::blas2::symv( m_minus,  m_f[i0], m_temp[i0]);
-        else if(which == zeroPlusT)
-        {
-            if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_plusT,  m_f[i0], m_temp[i0]);
-        }
-        else if(which == zeroMinusT)
-        {
-            if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_minusT, m_f[i0], m_temp[i0]);
-        }
-        else if( which == zeroForw)
-        {
-            if ( m_interpolation_method != "dg" )
-            {
-                dg::blas2::symv( m_zero, m_f[i0], m_temp[i0]);
-            }
-            else
-                dg::blas1::copy( m_f[i0], m_temp[i0]);
-        }
+        if( ! m_have_adjoint) updateAdjoint( );
+        planeSymv( *m_plusT, 0, f, f0);
+    }
+    else if(which == zeroMinusT)
+    {
+        if( ! m_have_adjoint) updateAdjoint( );
+        planeSymv( *m_minusT, 0, f, f0);
+    }
+    else if( which == zeroForw)
+    {
+        if ( m_interpolation_method != "dg" )
+            planeSymv( *m_zero, 0, f, f0);
+        else
+            dg::blas1::copy( f, f0);
     }
 }
 template< class G, class I, class container>
 void Fieldaligned<G, I, container>::ePlus( enum whichMatrix which,
         const container& f, container& fpe)
 {
-    dg::split( f, m_f, *m_g);
-    dg::split( fpe, m_temp, *m_g);
-    //1. compute 2d interpolation in every plane and store in m_temp
-    for( unsigned i0=0; i0<m_Nz; i0++)
+    //1. compute 2d interpolation in every plane in a single batched kernel
+    //(plane i0 reads plane ip = i0+1 with periodic wrap)
+    if(which == einsPlus)
+        planeSymv( *m_plus, +1, f, fpe);
+    else if(which == einsMinusT)
     {
-        unsigned ip = (i0==m_Nz-1) ? 0:i0+1;
-        if(which == einsPlus)
-            dg::blas2::symv( m_plus,   m_f[ip], m_temp[i0]);
-        else if(which == einsMinusT)
-        {
-            if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_minusT, m_f[ip], m_temp[i0]);
-        }
+        if( ! m_have_adjoint) updateAdjoint( );
+        planeSymv( *m_minusT, +1, f, fpe);
     }
     //2. apply right boundary conditions in last plane
     unsigned i0=m_Nz-1;
     if( m_bcz != dg::PER)
     {
+        dg::split( f, m_f, *m_g);
+        dg::split( fpe, m_temp, *m_g);
         if( m_bcz == dg::DIR || m_bcz == dg::NEU_DIR)
             dg::blas1::axpby( 2, m_right, -1., m_f[i0], m_ghostP);
         if( m_bcz == dg::NEU || m_bcz == dg::DIR_NEU)
@@ -1069,24 +1680,21 @@ template< class G, class I, class container>
 void Fieldaligned<G, I, container>::eMinus( enum whichMatrix which,
         const container& f, container& fme)
 {
-    dg::split( f, m_f, *m_g);
-    dg::split( fme, m_temp, *m_g);
-    //1. compute 2d interpolation in every plane and store in m_temp
-    for( unsigned i0=0; i0<m_Nz; i0++)
+    //1. compute 2d interpolation in every plane in a single batched kernel
+    //(plane i0 reads plane im = i0-1 with periodic wrap)
+    if(which == einsPlusT)
     {
-        unsigned im = (i0==0) ? m_Nz-1:i0-1;
-        if(which == einsPlusT)
-        {
-            if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_plusT, m_f[im], m_temp[i0]);
-        }
-        else if (which == einsMinus)
-            dg::blas2::symv( m_minus, m_f[im], m_temp[i0]);
+        if( ! m_have_adjoint) updateAdjoint( );
+        planeSymv( *m_plusT, -1, f, fme);
     }
+    else if (which == einsMinus)
+        planeSymv( *m_minus, -1, f, fme);
     //2. apply left boundary conditions in first plane
     unsigned i0=0;
     if( m_bcz != dg::PER)
     {
+        dg::split( f, m_f, *m_g);
+        dg::split( fme, m_temp, *m_g);
         if( m_bcz == dg::DIR || m_bcz == dg::DIR_NEU)
             dg::blas1::axpby( 2., m_left,  -1., m_f[i0], m_ghostM);
         if( m_bcz == dg::NEU || m_bcz == dg::NEU_DIR)
@@ -1097,6 +1705,40 @@ void Fieldaligned<G, I, container>::eMinus( enum whichMatrix which,
     }
 }
 
+template< class G, class I, class container>
+void Fieldaligned<G, I, container>::ePlusMinus(
+        const container& f, container& fpe, container& fme)
+{
+    //1. compute both 2d interpolations with one batched kernel each
+    //( fpe[i0] = I^+ f[i0+1] and fme[i0] = I^- f[i0-1] with periodic wrap)
+    planeSymv( *m_plus, +1, f, fpe);
+    planeSymv( *m_minus, -1, f, fme);
+    if( m_bcz != dg::PER)
+    {
+        dg::split( f, m_f, *m_g);
+        dg::split( fpe, m_temp, *m_g);
+        std::vector<dg::View< container>> tempM = dg::split( fme, *m_g);
+        //2. apply right boundary conditions in last plane
+        unsigned i0=m_Nz-1;
+        if( m_bcz == dg::DIR || m_bcz == dg::NEU_DIR)
+            dg::blas1::axpby( 2, m_right, -1., m_f[i0], m_ghostP);
+        if( m_bcz == dg::NEU || m_bcz == dg::DIR_NEU)
+            dg::blas1::axpby( m_deltaPhi, m_right, 1., m_f[i0], m_ghostP);
+        //interlay ghostcells with periodic cells: L*g + (1-L)*fpe
+        dg::blas1::axpby( 1., m_ghostP, -1., m_temp[i0], m_ghostP);
+        dg::blas1::pointwiseDot( 1., m_limiter, m_ghostP, 1., m_temp[i0]);
+        //3. apply left boundary conditions in first plane
+        i0=0;
+        if( m_bcz == dg::DIR || m_bcz == dg::DIR_NEU)
+            dg::blas1::axpby( 2., m_left,  -1., m_f[i0], m_ghostM);
+        if( m_bcz == dg::NEU || m_bcz == dg::NEU_DIR)
+            dg::blas1::axpby( -m_deltaPhi, m_left, 1., m_f[i0], m_ghostM);
+        //interlay ghostcells with periodic cells: L*g + (1-L)*fme
+        dg::blas1::axpby( 1., m_ghostM, -1., tempM[i0], m_ghostM);
+        dg::blas1::pointwiseDot( 1., m_limiter, m_ghostM, 1., tempM[i0]);
+    }
+}
+
 template<class G, class I, class container>
 template< class BinaryOp, class UnaryOp>
 container Fieldaligned<G, I,container>::evaluate( BinaryOp binary,
@@ -1124,10 +1766,10 @@ container Fieldaligned<G, I,container>::evaluate( BinaryOp binary,
             for(unsigned k=0; k<rep; k++)
             {
                 //!!! The value of f at the plus plane is I^- of the current plane
-                dg::blas2::symv( m_minus, tempP, temp);
+                dg::blas2::symv( *m_minus, tempP, temp);
                 temp.swap( tempP);
                 //!!! The value of f at the minus plane is I^+ of the current plane
-                dg::blas2::symv( m_plus, tempM, temp);
+                dg::blas2::symv( *m_plus, tempM, temp);
                 temp.swap( tempM);
             }
             dg::blas1::scal( tempP, unary(  (double)rep*m_deltaPhi ) );
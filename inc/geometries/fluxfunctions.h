@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <functional>
+#include <map>
 #include "dg/algorithm.h"
 
 namespace dg
@@ -72,7 +74,7 @@ struct aCylindricalFunctor
     *
     * @return f(R,Z)
     */
-    double operator()(double R, double Z) const
+    DG_DEVICE double operator()(double R, double Z) const
     {
         const Derived& underlying = static_cast<const Derived&>(*this);
         return underlying.do_compute(R,Z);
@@ -86,7 +88,7 @@ struct aCylindricalFunctor
     *
     * @return f(R,Z)
     */
-    double operator()(double R, double Z, double phi)const
+    DG_DEVICE double operator()(double R, double Z, double phi)const
     {
         const Derived& underlying = static_cast<const Derived&>(*this);
         return underlying.do_compute(R,Z);
@@ -256,13 +258,58 @@ struct CylindricalFunctorsLvl2
 };
 
 
+///@cond
+namespace detail
+{
+//64 bit Fowler-Noll-Vo hash
+static inline uint64_t critical_fnv1a( uint64_t hash, const double* data, unsigned size)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for( unsigned i=0; i<size*sizeof(double); i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+//Fingerprint psi by sampling its gradient on a small lattice around the
+//initial guess: two flux functions that agree on all samples and start from
+//the same guess converge to the same critical point
+static inline uint64_t critical_point_key( const CylindricalFunctorsLvl2& psi, double RC, double ZC)
+{
+    uint64_t hash = 14695981039346656037ull;
+    double guess[2] = {RC, ZC};
+    hash = critical_fnv1a( hash, guess, 2);
+    double h = 0.1*fabs(RC);
+    for( unsigned i=0; i<4; i++)
+        for( unsigned j=0; j<4; j++)
+        {
+            double R = RC + (2.*i/3.-1.)*h, Z = ZC + (2.*j/3.-1.)*h;
+            double sample[2] = { psi.dfx()(R,Z), psi.dfy()(R,Z)};
+            hash = critical_fnv1a( hash, sample, 2);
+        }
+    return hash;
+}
+//In-memory cache of critical points (RC, ZC, type): the X-point grid
+//generation and the wall and sheath setup repeatedly search the same psi
+//from the same initial guess
+static inline std::map<uint64_t, std::array<double,3>>& critical_point_cache()
+{
+    static std::map<uint64_t, std::array<double,3>> cache;
+    return cache;
+}
+}//namespace detail
+///@endcond
+
 /**
  * @brief This function finds critical points of psi (any point with vanishing gradient, including the X-point or O-point) via Newton iteration applied to the gradient of psi
  *
  * Newton iteration applied to \f$ \nabla \psi (\vec x) = 0 \f$ reads
- * \f[ \vec x_{i+1} = \vec x_i - H^{-1} \nabla \psi (\vec x_i)\f]
+ * \f[ \vec x_{i+1} = \vec x_i - \lambda H^{-1} \nabla \psi (\vec x_i)\f]
  * where H is the Hessian matrix.
- * The inverse of the Hessian matrix is computed analytically
+ * The inverse of the Hessian matrix is computed analytically and the step is
+ * damped (\f$ \lambda \le 1\f$ halved until the norm of the gradient
+ * decreases) such that the iteration converges also from poor initial guesses
+ * @note The result is cached: repeated calls with the same psi (identified by
+ * sampling its gradient around the initial guess) and the same initial guess
+ * return the stored point without iterating again
  * @param psi \f$ \psi(R,Z)\f$
  * @param RC start value on input, critical point on output
  * @param ZC start value on input, critical point on output
@@ -274,6 +321,16 @@ struct CylindricalFunctorsLvl2
  */
 static inline int findCriticalPoint( const CylindricalFunctorsLvl2& psi, double& RC, double& ZC)
 {
+    uint64_t key = detail::critical_point_key( psi, RC, ZC);
+    auto& cache = detail::critical_point_cache();
+    auto entry = cache.find( key);
+    if( entry != cache.end())
+    {
+        int point = (int)entry->second[2];
+        if( point != 0)
+            RC = entry->second[0], ZC = entry->second[1];
+        return point;
+    }
     std::array<double, 2> X{ {0,0} }, XN(X), X_OLD(X);
     X[0] = RC, X[1] = ZC;
     double eps = 1e10, eps_old= 2e10;
@@ -293,9 +350,20 @@ static inline int findCriticalPoint( const CylindricalFunctorsLvl2& psi, double&
     double Dinv = 1./D0;
     while( (eps < eps_old || eps > 1e-7) && eps > 1e-10 && counter < 100)
     {
-        //newton iteration
-        XN[0] = X[0] - Dinv*(psipZZ*psipR - psipRZ*psipZ);
-        XN[1] = X[1] - Dinv*(-psipRZ*psipR + psipRR*psipZ);
+        //damped newton iteration: halve the step until the gradient norm
+        //decreases so that the iteration cannot run away from a poor guess
+        double stepR = -Dinv*( psipZZ*psipR - psipRZ*psipZ);
+        double stepZ = -Dinv*(-psipRZ*psipR + psipRR*psipZ);
+        double norm = psipR*psipR + psipZ*psipZ, damping = 1.;
+        for( unsigned i=0; i<10; i++)
+        {
+            XN[0] = X[0] + damping*stepR;
+            XN[1] = X[1] + damping*stepZ;
+            double gR = psi.dfx()(XN[0], XN[1]), gZ = psi.dfy()(XN[0], XN[1]);
+            if( gR*gR + gZ*gZ <= norm)
+                break;
+            damping /= 2.;
+        }
         XN.swap(X);
         eps = sqrt( (X[0]-X_OLD[0])*(X[0]-X_OLD[0]) + (X[1]-X_OLD[1])*(X[1]-X_OLD[1]));
         X_OLD = X; eps_old= eps;
@@ -308,14 +376,38 @@ static inline int findCriticalPoint( const CylindricalFunctorsLvl2& psi, double&
         counter++;
     }
     if ( counter >= 100 || D0 == 0|| std::isnan( Dinv) )
+    {
+        cache[ key] = { RC, ZC, 0.};
         return 0;
+    }
     RC = X[0], ZC = X[1];
+    int point = 3; //saddle point (Dinv < 0)
     if( Dinv > 0 &&  psipRR > 0)
-        return 1; //local minimum
+        point = 1; //local minimum
     if( Dinv > 0 &&  psipRR < 0)
-        return 2; //local maximum
-    //if( Dinv < 0)
-    return 3; //saddle point
+        point = 2; //local maximum
+    cache[ key] = { RC, ZC, (double)point};
+    return point;
+}
+
+/**
+ * @brief Find critical points of psi for several initial guesses at once
+ *
+ * Calls \c findCriticalPoint for each initial guess in turn. Use this
+ * function if several critical points of the same flux function are needed
+ * (e.g. both X-points of a double X-point equilibrium)
+ * @param psi \f$ \psi(R,Z)\f$
+ * @param RC start values on input, critical points on output
+ * @param ZC start values on input, critical points on output (same size as \c RC)
+ * @return for each point the return code of \c findCriticalPoint
+ * @ingroup misc_geo
+ */
+static inline std::vector<int> findCriticalPoints( const CylindricalFunctorsLvl2& psi, std::vector<double>& RC, std::vector<double>& ZC)
+{
+    std::vector<int> points( RC.size());
+    for( unsigned i=0; i<RC.size(); i++)
+        points[i] = findCriticalPoint( psi, RC[i], ZC[i]);
+    return points;
 }
 
 /**
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include "dg/algorithm.h"
 #include "fluxfunctions.h"
 #include "curvilinear.h"
@@ -199,6 +200,76 @@ void transform(
     dg::tensor::multiply2d( jac.transpose(), uh_zeta, uh_eta, u_x, u_y);
 }
 
+//FNV-1a over grid parameters and the discretized PDE data; two keys agree
+//only if the elliptic solves would yield the same adaptation function u
+inline uint64_t hector_cache_key( std::vector<double> key,
+    const thrust::host_vector<double>& chi,
+    const thrust::host_vector<double>& lapu)
+{
+    key.insert( key.end(), chi.begin(), chi.end());
+    key.insert( key.end(), lapu.begin(), lapu.end());
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const unsigned char* bytes =
+        reinterpret_cast<const unsigned char*>( key.data());
+    for( unsigned i=0; i<key.size()*sizeof(double); i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    return hash;
+}
+#ifdef _NETCDF_
+//Read a previously computed adaptation function u from file; returns false
+//if the file does not exist or was written for a different key
+inline bool read_hector_cache( std::string file, uint64_t key,
+    unsigned& Nx, unsigned& Ny, thrust::host_vector<double>& u)
+{
+    int ncid;
+    if( nc_open( file.data(), NC_NOWRITE, &ncid) != NC_NOERR)
+        return false;
+    unsigned long long stored = 0;
+    if( nc_get_att_ulonglong( ncid, NC_GLOBAL, "key", &stored) != NC_NOERR
+        || stored != key
+        || nc_get_att_uint( ncid, NC_GLOBAL, "Nx", &Nx) != NC_NOERR
+        || nc_get_att_uint( ncid, NC_GLOBAL, "Ny", &Ny) != NC_NOERR)
+    {
+        nc_close( ncid);
+        return false;
+    }
+    int dimid, varid;
+    size_t len = 0;
+    if( nc_inq_dimid( ncid, "points", &dimid) != NC_NOERR
+        || nc_inq_dimlen( ncid, dimid, &len) != NC_NOERR
+        || nc_inq_varid( ncid, "u", &varid) != NC_NOERR)
+    {
+        nc_close( ncid);
+        return false;
+    }
+    u.resize( len);
+    int retval = nc_get_var_double( ncid, varid, u.data());
+    nc_close( ncid);
+    return retval == NC_NOERR;
+}
+//Write the adaptation function to file (overwrites existing file)
+inline void write_hector_cache( std::string file, uint64_t key,
+    unsigned Nx, unsigned Ny, const thrust::host_vector<double>& u)
+{
+    int ncid;
+    if( nc_create( file.data(), NC_NETCDF4|NC_CLOBBER, &ncid) != NC_NOERR)
+    {
+        std::cerr << "# WARNING: Cannot create Hector cache "<<file<<"!\n";
+        return;
+    }
+    unsigned long long stored = key;
+    nc_put_att_ulonglong( ncid, NC_GLOBAL, "key", NC_UINT64, 1, &stored);
+    nc_put_att_uint( ncid, NC_GLOBAL, "Nx", NC_UINT, 1, &Nx);
+    nc_put_att_uint( ncid, NC_GLOBAL, "Ny", NC_UINT, 1, &Ny);
+    int dimid, varid;
+    nc_def_dim( ncid, "points", u.size(), &dimid);
+    nc_def_var( ncid, "u", NC_DOUBLE, 1, &dimid, &varid);
+    nc_enddef( ncid);
+    nc_put_var_double( ncid, varid, u.data());
+    nc_close( ncid);
+}
+#endif //_NETCDF_
+
 }//namespace detail
 ///@endcond
 
@@ -232,12 +303,19 @@ struct Hector : public aGenerator2d
      * @param Ny initial number of points in eta for the internal grid
      * @param eps_u the accuracy of u
      * @param verbose If true convergence details are printed to std::cout
+     * @param cache_file If non-empty, cache the solution of the elliptic
+     * grid-adaptation equation in the given NetCDF file. The file is keyed by
+     * a hash over the grid parameters and the discretized equation; on a
+     * mismatch it is transparently recomputed and overwritten.
+     * @attention The cache is only available if \c netcdf.h is included
+     * before this header; otherwise a non-empty \c cache_file produces a
+     * runtime warning and is ignored.
      */
-    Hector( const CylindricalFunctorsLvl2& psi, double psi0, double psi1, double X0, double Y0, unsigned n = 13, unsigned Nx = 2, unsigned Ny = 10, double eps_u = 1e-10, bool verbose=false) :
+    Hector( const CylindricalFunctorsLvl2& psi, double psi0, double psi1, double X0, double Y0, unsigned n = 13, unsigned Nx = 2, unsigned Ny = 10, double eps_u = 1e-10, bool verbose=false, std::string cache_file = "") :
         m_g2d(dg::geo::RibeiroFluxGenerator(psi, psi0, psi1, X0, Y0,1), n, Nx, Ny, dg::DIR)
     {
         //first construct m_u
-        container u = construct_grid_and_u( dg::geo::Constant(1), dg::geo::detail::LaplacePsi(psi), psi0, psi1, X0, Y0, eps_u , verbose);
+        container u = construct_grid_and_u( dg::geo::Constant(1), dg::geo::detail::LaplacePsi(psi), psi0, psi1, X0, Y0, eps_u , verbose, cache_file);
         construct( u, psi0, psi1, dg::geo::Constant(1.), dg::geo::Constant(0.), dg::geo::Constant(1.), verbose);
         m_conformal=m_orthogonal=true;
         ////we actually don't need m_u but it makes a good testcase
@@ -263,13 +341,16 @@ struct Hector : public aGenerator2d
      * @param Ny initial number of points in eta for the internal grid
      * @param eps_u the accuracy of u
      * @param verbose If true convergence details are printed to std::cout
+     * @param cache_file If non-empty, cache the solution of the elliptic
+     * grid-adaptation equation in the given NetCDF file (requires \c netcdf.h
+     * to be included before this header)
      */
-    Hector( const CylindricalFunctorsLvl2& psi, const CylindricalFunctorsLvl1& chi, double psi0, double psi1, double X0, double Y0, unsigned n = 13, unsigned Nx = 2, unsigned Ny = 10, double eps_u = 1e-10, bool verbose=false) :
+    Hector( const CylindricalFunctorsLvl2& psi, const CylindricalFunctorsLvl1& chi, double psi0, double psi1, double X0, double Y0, unsigned n = 13, unsigned Nx = 2, unsigned Ny = 10, double eps_u = 1e-10, bool verbose=false, std::string cache_file = "") :
         m_g2d(dg::geo::RibeiroFluxGenerator(psi, psi0, psi1, X0, Y0,1), n, Nx, Ny, dg::DIR)
     {
         dg::geo::detail::LaplaceAdaptPsi lapAdaPsi( psi, chi);
         //first construct m_u
-        container u = construct_grid_and_u( chi.f(), lapAdaPsi, psi0, psi1, X0, Y0, eps_u , verbose);
+        container u = construct_grid_and_u( chi.f(), lapAdaPsi, psi0, psi1, X0, Y0, eps_u , verbose, cache_file);
         construct( u, psi0, psi1, chi.f(),dg::geo::Constant(0), chi.f(), verbose );
         m_orthogonal=true;
         m_conformal=false;
@@ -296,14 +377,17 @@ struct Hector : public aGenerator2d
      * @param Ny initial number of points in eta for the internal grid
      * @param eps_u the accuracy of u
      * @param verbose If true convergence details are printed to std::cout
+     * @param cache_file If non-empty, cache the solution of the elliptic
+     * grid-adaptation equation in the given NetCDF file (requires \c netcdf.h
+     * to be included before this header)
      */
     Hector( const CylindricalFunctorsLvl2& psi,const CylindricalSymmTensorLvl1& chi,
-            double psi0, double psi1, double X0, double Y0, unsigned n = 13, unsigned Nx = 2, unsigned Ny = 10, double eps_u = 1e-10, bool verbose=false) :
+            double psi0, double psi1, double X0, double Y0, unsigned n = 13, unsigned Nx = 2, unsigned Ny = 10, double eps_u = 1e-10, bool verbose=false, std::string cache_file = "") :
         m_g2d(dg::geo::RibeiroFluxGenerator(psi, psi0, psi1, X0, Y0,1), n, Nx, Ny, dg::DIR)
     {
         //first construct m_u
         container u = construct_grid_and_u( psi, chi,
-                psi0, psi1, X0, Y0, eps_u , verbose);
+                psi0, psi1, X0, Y0, eps_u , verbose, cache_file);
         construct( u, psi0, psi1, chi.xx(), chi.xy(), chi.yy(), verbose);
         m_orthogonal=m_conformal=false;
         ////we actually don't need m_u but it makes a good testcase
@@ -369,18 +453,42 @@ struct Hector : public aGenerator2d
         //std::cout << "Error in u is "<<eps<<std::endl;
     }
 
-    container construct_grid_and_u( const CylindricalFunctor& chi, const CylindricalFunctor& lapChiPsi, double psi0, double psi1, double X0, double Y0, double eps_u , bool verbose)
+    container construct_grid_and_u( const CylindricalFunctor& chi, const CylindricalFunctor& lapChiPsi, double psi0, double psi1, double X0, double Y0, double eps_u , bool verbose, std::string cache_file)
     {
         //first find u( \zeta, \eta)
         double eps = 1e10, eps_old = 2e10;
         dg::geo::CurvilinearGrid2d g2d_old = m_g2d;
         container adapt = dg::pullback(chi, g2d_old);
+        container lapu = dg::pullback( lapChiPsi, g2d_old);
+        uint64_t key = 0;
+        if( !cache_file.empty())
+        {
+            thrust::host_vector<double> adapt_h, lapu_h;
+            dg::assign( adapt, adapt_h);
+            dg::assign( lapu, lapu_h);
+            key = detail::hector_cache_key( { (double)m_g2d.n(),
+                (double)m_g2d.Nx(), (double)m_g2d.Ny(),
+                psi0, psi1, X0, Y0, eps_u}, adapt_h, lapu_h);
+#ifdef _NETCDF_
+            unsigned Nx = 0, Ny = 0;
+            thrust::host_vector<double> u_h;
+            if( detail::read_hector_cache( cache_file, key, Nx, Ny, u_h)
+                && u_h.size() == (size_t)(m_g2d.n()*m_g2d.n()*Nx*Ny))
+            {
+                if(verbose) std::cout << "# Hector: cache hit in "<<cache_file<<"\n";
+                m_g2d.multiplyCellNumbers( (double)Nx/(double)m_g2d.Nx(),
+                                           (double)Ny/(double)m_g2d.Ny());
+                return dg::construct<container>( u_h);
+            }
+#else
+            std::cerr << "# WARNING: Hector cache "<<cache_file<<" requested but netcdf.h is not included! Continuing without cache!\n";
+#endif //_NETCDF_
+        }
         dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container> ellipticD_old( g2d_old, dg::DIR, dg::PER, dg::centered);
         ellipticD_old.set_chi( adapt);
 
         container u_old = dg::evaluate( dg::zero, g2d_old), u(u_old);
         dg::PCG<container > invert_old( u_old, g2d_old.size());
-        container lapu = dg::pullback( lapChiPsi, g2d_old);
         unsigned number = invert_old.solve( ellipticD_old, u_old, lapu, ellipticD_old.precond(), ellipticD_old.weights(), eps_u);
         if(verbose) std::cout << "Nx "<<m_g2d.Nx()<<" Ny "<<m_g2d.Ny()<<std::flush;
         if(verbose) std::cout <<" iter "<<number<<" error "<<eps<<"\n";
@@ -389,70 +497,127 @@ struct Hector : public aGenerator2d
             eps = eps_old;
             m_g2d.multiplyCellNumbers(2,2);
             if(verbose) std::cout << "Nx "<<m_g2d.Nx()<<" Ny "<<m_g2d.Ny()<<std::flush;
-            dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container> ellipticD( m_g2d, dg::DIR, dg::PER, dg::centered);
-            adapt = dg::pullback(chi, m_g2d);
-            ellipticD.set_chi( adapt);
             const container vol2d = dg::create::weights( m_g2d);
             const IMatrix Q = dg::create::interpolation( m_g2d, g2d_old);
             container u_diff = dg::evaluate( dg::zero, m_g2d);
             dg::blas2::gemv( Q, u_old, u_diff);
             u = u_diff;
 
-            dg::PCG<container > invert( u_diff, m_g2d.size());
+            //solve through nested grids with the interpolated coarse solution as initial guess
+            unsigned stages = 3;
+            while( stages > 1 && ( m_g2d.Nx()%(1u<<(stages-1)) != 0
+                                || m_g2d.Ny()%(1u<<(stages-1)) != 0))
+                stages--;
+            dg::MultigridCG2d<dg::geo::CurvilinearGrid2d, Matrix, container> multigrid( m_g2d, stages);
+            multigrid.set_benchmark( verbose, "Hector");
+            std::vector<dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container>> multi_ellipticD( stages);
+            for( unsigned s=0; s<stages; s++)
+            {
+                multi_ellipticD[s].construct( multigrid.grid(s), dg::DIR, dg::PER, dg::centered);
+                adapt = dg::pullback( chi, multigrid.grid(s));
+                multi_ellipticD[s].set_chi( adapt);
+            }
             lapu = dg::pullback( lapChiPsi, m_g2d);
-            number = invert.solve( ellipticD, u, lapu, ellipticD.precond(), ellipticD.weights(), 0.1*eps_u);
+            std::vector<unsigned> numbers = multigrid.solve( multi_ellipticD, u, lapu, 0.1*eps_u);
             dg::blas1::axpby( 1. ,u, -1., u_diff);
             eps = sqrt( dg::blas2::dot( u_diff, vol2d, u_diff) / dg::blas2::dot( u, vol2d, u) );
-            if(verbose) std::cout <<" iter "<<number<<" error "<<eps<<"\n";
+            if(verbose) std::cout <<" iter "<<numbers[0]<<" error "<<eps<<"\n";
             g2d_old = m_g2d;
             u_old = u;
-            number++;//get rid of warning
         }
+#ifdef _NETCDF_
+        if( !cache_file.empty())
+        {
+            thrust::host_vector<double> u_h;
+            dg::assign( u, u_h);
+            detail::write_hector_cache( cache_file, key, m_g2d.Nx(), m_g2d.Ny(), u_h);
+        }
+#endif //_NETCDF_
         return u;
     }
 
     container construct_grid_and_u( const CylindricalFunctorsLvl2& psi,
-            const CylindricalSymmTensorLvl1& chi, double psi0, double psi1, double X0, double Y0, double eps_u, bool verbose )
+            const CylindricalSymmTensorLvl1& chi, double psi0, double psi1, double X0, double Y0, double eps_u, bool verbose, std::string cache_file )
     {
         dg::geo::detail::LaplaceChiPsi lapChiPsi( psi, chi);
         //first find u( \zeta, \eta)
         double eps = 1e10, eps_old = 2e10;
         dg::geo::CurvilinearGrid2d g2d_old = m_g2d;
-        dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container> ellipticD_old( g2d_old, dg::DIR, dg::PER, dg::centered);
         dg::SparseTensor<container> chi_t;
         dg::pushForwardPerp( chi.xx(), chi.xy(), chi.yy(), chi_t, g2d_old);
-
+        container lapu = dg::pullback( lapChiPsi, g2d_old);
+        uint64_t key = 0;
+        if( !cache_file.empty())
+        {
+            thrust::host_vector<double> chi_h, lapu_h;
+            dg::assign( chi_t.value(0,0), chi_h);
+            dg::assign( lapu, lapu_h);
+            key = detail::hector_cache_key( { (double)m_g2d.n(),
+                (double)m_g2d.Nx(), (double)m_g2d.Ny(),
+                psi0, psi1, X0, Y0, eps_u}, chi_h, lapu_h);
+#ifdef _NETCDF_
+            unsigned Nx = 0, Ny = 0;
+            thrust::host_vector<double> u_h;
+            if( detail::read_hector_cache( cache_file, key, Nx, Ny, u_h)
+                && u_h.size() == (size_t)(m_g2d.n()*m_g2d.n()*Nx*Ny))
+            {
+                if(verbose) std::cout << "# Hector: cache hit in "<<cache_file<<"\n";
+                m_g2d.multiplyCellNumbers( (double)Nx/(double)m_g2d.Nx(),
+                                           (double)Ny/(double)m_g2d.Ny());
+                return dg::construct<container>( u_h);
+            }
+#else
+            std::cerr << "# WARNING: Hector cache "<<cache_file<<" requested but netcdf.h is not included! Continuing without cache!\n";
+#endif //_NETCDF_
+        }
+        dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container> ellipticD_old( g2d_old, dg::DIR, dg::PER, dg::centered);
         ellipticD_old.set_chi( chi_t);
 
         container u_old = dg::evaluate( dg::zero, g2d_old), u(u_old);
         dg::PCG<container > invert_old( u_old, g2d_old.size());
-        container lapu = dg::pullback( lapChiPsi, g2d_old);
         unsigned number = invert_old.solve( ellipticD_old, u_old, lapu, ellipticD_old.precond(), ellipticD_old.weights(), eps_u);
         while( (eps < eps_old||eps > 1e-7) && eps > eps_u)
         {
             eps = eps_old;
             m_g2d.multiplyCellNumbers(2,2);
             if(verbose) std::cout << "Nx "<<m_g2d.Nx()<<" Ny "<<m_g2d.Ny()<<std::flush;
-            dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container> ellipticD( m_g2d, dg::DIR, dg::PER, dg::centered);
-            dg::pushForwardPerp( chi.xx(), chi.xy(), chi.yy(), chi_t, m_g2d);
-
-            ellipticD.set_chi( chi_t );
             const container vol2d = dg::create::weights( m_g2d);
             const IMatrix Q = dg::create::interpolation( m_g2d, g2d_old);
             container u_diff = dg::evaluate( dg::zero, m_g2d);
             dg::blas2::gemv( Q, u_old, u_diff);
             u = u_diff;
 
-            dg::PCG<container > invert( u_diff, m_g2d.size());
+            //solve through nested grids with the interpolated coarse solution as initial guess
+            unsigned stages = 3;
+            while( stages > 1 && ( m_g2d.Nx()%(1u<<(stages-1)) != 0
+                                || m_g2d.Ny()%(1u<<(stages-1)) != 0))
+                stages--;
+            dg::MultigridCG2d<dg::geo::CurvilinearGrid2d, Matrix, container> multigrid( m_g2d, stages);
+            multigrid.set_benchmark( verbose, "Hector");
+            std::vector<dg::Elliptic2d<dg::geo::CurvilinearGrid2d, Matrix, container>> multi_ellipticD( stages);
+            for( unsigned s=0; s<stages; s++)
+            {
+                multi_ellipticD[s].construct( multigrid.grid(s), dg::DIR, dg::PER, dg::centered);
+                dg::pushForwardPerp( chi.xx(), chi.xy(), chi.yy(), chi_t, multigrid.grid(s));
+                multi_ellipticD[s].set_chi( chi_t);
+            }
             lapu = dg::pullback( lapChiPsi, m_g2d);
-            number = invert.solve( ellipticD, u, lapu, ellipticD.precond(), ellipticD.weights(), 0.1*eps_u);
+            std::vector<unsigned> numbers = multigrid.solve( multi_ellipticD, u, lapu, 0.1*eps_u);
             dg::blas1::axpby( 1. ,u, -1., u_diff);
             eps = sqrt( dg::blas2::dot( u_diff, vol2d, u_diff) / dg::blas2::dot( u, vol2d, u) );
-            if(verbose) std::cout <<" iter "<<number<<" error "<<eps<<"\n";
+            if(verbose) std::cout <<" iter "<<numbers[0]<<" error "<<eps<<"\n";
             g2d_old = m_g2d;
             u_old = u;
             number++;//get rid of warning
         }
+#ifdef _NETCDF_
+        if( !cache_file.empty())
+        {
+            thrust::host_vector<double> u_h;
+            dg::assign( u, u_h);
+            detail::write_hector_cache( cache_file, key, m_g2d.Nx(), m_g2d.Ny(), u_h);
+        }
+#endif //_NETCDF_
         return u;
     }
 
@@ -60,6 +60,52 @@ void sendBackward( const thrust_vector0& in, thrust_vector1& out, MPI_Comm comm)
                     source, 3, //source
                     comm, &status);
 }
+///nonblocking version of sendForward; rqst must hold 2 requests
+template<class thrust_vector0, class thrust_vector1>
+void isendForward( const thrust_vector0& in, thrust_vector1& out, MPI_Comm comm, MPI_Request rqst[2]) //send to next plane
+{
+    int source, dest;
+    MPI_Cart_shift( comm, 2, +1, &source, &dest);
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    if( std::is_same< get_execution_policy<thrust_vector0>, CudaTag>::value) //could be serial tag
+    {
+        cudaError_t code = cudaGetLastError( );
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaDeviceSynchronize(); //wait until device functions are finished before sending data
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    }
+#endif //THRUST_DEVICE_SYSTEM
+    unsigned size = in.size();
+    MPI_Irecv( thrust::raw_pointer_cast(out.data()), size, MPI_DOUBLE, //receiver
+                    source, 9, comm, &rqst[0]); //source
+    MPI_Isend( thrust::raw_pointer_cast(in.data()), size, MPI_DOUBLE,  //sender
+                    dest, 9, comm, &rqst[1]);  //destination
+}
+///nonblocking version of sendBackward; rqst must hold 2 requests
+template<class thrust_vector0, class thrust_vector1>
+void isendBackward( const thrust_vector0& in, thrust_vector1& out, MPI_Comm comm, MPI_Request rqst[2]) //send to previous plane
+{
+    int source, dest;
+    MPI_Cart_shift( comm, 2, -1, &source, &dest);
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+    if( std::is_same< get_execution_policy<thrust_vector0>, CudaTag>::value) //could be serial tag
+    {
+        cudaError_t code = cudaGetLastError( );
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+        code = cudaDeviceSynchronize(); //wait until device functions are finished before sending data
+        if( code != cudaSuccess)
+            throw dg::Error(dg::Message(_ping_)<<cudaGetErrorString(code));
+    }
+#endif //THRUST_DEVICE_SYSTEM
+    unsigned size = in.size();
+    MPI_Irecv( thrust::raw_pointer_cast(out.data()), size, MPI_DOUBLE, //receiver
+                    source, 3, comm, &rqst[0]); //source
+    MPI_Isend( thrust::raw_pointer_cast(in.data()), size, MPI_DOUBLE,  //sender
+                    dest, 3, comm, &rqst[1]);  //destination
+}
 }//namespace detail
 
 template <class ProductMPIGeometry, class LocalIMatrix, class CommunicatorXY, class LocalContainer>
@@ -75,9 +121,11 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
         double eps = 1e-5,
         unsigned mx=12, unsigned my=12,
         double deltaPhi = -1, std::string interpolation_method = "linear-nearest",
-        bool benchmark = true):
+        bool benchmark = true,
+        std::string cache_file = ""):
             Fieldaligned( dg::geo::createBHat(vec), grid, bcx, bcy, limit, eps,
-                    mx, my, deltaPhi, interpolation_method)
+                    mx, my, deltaPhi, interpolation_method, benchmark,
+                    cache_file)
     {
     }
     template <class Limiter>
@@ -89,7 +137,8 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
         double eps = 1e-5,
         unsigned mx=12, unsigned my=12,
         double deltaPhi = -1, std::string interpolation_method = "linear-nearest",
-        bool benchmark = true);
+        bool benchmark = true,
+        std::string cache_file = "");
     template<class ...Params>
     void construct( Params&& ...ps)
     {
@@ -128,6 +177,9 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
 
     void operator()(enum whichMatrix which, const MPI_Vector<LocalContainer>& in, MPI_Vector<LocalContainer>& out);
 
+    ///@copydoc Fieldaligned::ePlusMinus
+    void ePlusMinus( const MPI_Vector<LocalContainer>& f, MPI_Vector<LocalContainer>& fpe, MPI_Vector<LocalContainer>& fme);
+
     double deltaPhi() const{return m_deltaPhi;}
     const MPI_Vector<LocalContainer>& hbm()const {
         return m_hbm;
@@ -172,7 +224,10 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
     void ePlus( enum whichMatrix which, const MPI_Vector<LocalContainer>& in, MPI_Vector<LocalContainer>& out);
     void eMinus(enum whichMatrix which, const MPI_Vector<LocalContainer>& in, MPI_Vector<LocalContainer>& out);
     void zero(enum whichMatrix which, const MPI_Vector<LocalContainer>& in, MPI_Vector<LocalContainer>& out);
-    MPIDistMat<LocalIMatrix, CommunicatorXY> m_plus, m_zero, m_minus, m_plusT, m_minusT; //2d interpolation matrices
+    //2d interpolation matrices; shared among instances with the same
+    //construction parameters (see matrix_memory_cache)
+    std::shared_ptr<MPIDistMat<LocalIMatrix, CommunicatorXY>> m_plus, m_zero,
+        m_minus, m_plusT, m_minusT;
     MPI_Vector<LocalContainer> m_hbm, m_hbp; //3d size
     MPI_Vector<LocalContainer> m_G, m_Gm, m_Gp; //3d size
     MPI_Vector<LocalContainer> m_bphi, m_bphiM, m_bphiP; //3d size
@@ -192,12 +247,15 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
 #ifdef _DG_CUDA_UNAWARE_MPI
     //we need to manually send data through the host
     thrust::host_vector<double> m_send_buffer, m_recv_buffer; //2d size
+    thrust::host_vector<double> m_send_buffer2, m_recv_buffer2; //2d size, second exchange in flight
 #endif
     bool m_have_adjoint = false;
     void updateAdjoint( )
     {
-        m_plusT = dg::transpose( m_plus);
-        m_minusT = dg::transpose( m_minus);
+        m_plusT = std::make_shared<MPIDistMat<LocalIMatrix, CommunicatorXY>>(
+                dg::transpose( *m_plus));
+        m_minusT = std::make_shared<MPIDistMat<LocalIMatrix, CommunicatorXY>>(
+                dg::transpose( *m_minus));
         m_have_adjoint = true;
     }
 };
@@ -208,7 +266,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
     const dg::geo::CylindricalVectorLvl1& vec,
     const MPIGeometry& grid,
     dg::bc bcx, dg::bc bcy, Limiter limit, double eps,
-    unsigned mx, unsigned my, double deltaPhi, std::string interpolation_method, bool benchmark
+    unsigned mx, unsigned my, double deltaPhi, std::string interpolation_method, bool benchmark, std::string cache_file
     ):
         m_g(grid),
         m_interpolation_method(interpolation_method)
@@ -269,12 +327,82 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
     auto vol = dg::tensor::volume(grid.metric()), vol2d0(vol);
     auto vol2d = dg::split( vol, grid);
     dg::assign( vol2d[0], vol2d0);
-    detail::integrate_all_fieldlines2d( vec, *global_grid_magnetic,
-            grid_transform->local(), yp_trafo, vol2d0.data(), hbp, in_boxp,
+    bool cached = false;
+    uint64_t key = detail::fieldline_cache_key( vec, grid_transform->local(),
             deltaPhi, eps);
-    detail::integrate_all_fieldlines2d( vec, *global_grid_magnetic,
-            grid_transform->local(), ym_trafo, vol2d0.data(), hbm, in_boxm,
-            -deltaPhi, eps);
+    //first consult the process local in-memory cache filled by previous
+    //constructions
+    auto& tcache = detail::fieldline_memory_cache();
+    auto trajectories = tcache.find( key);
+    if( trajectories != tcache.end())
+    {
+        yp_trafo = trajectories->second->yp, hbp = trajectories->second->hbp,
+            in_boxp = trajectories->second->in_boxp;
+        ym_trafo = trajectories->second->ym, hbm = trajectories->second->hbm,
+            in_boxm = trajectories->second->in_boxm;
+        cached = true;
+        if( benchmark && rank==0)
+            std::cout << "# DS: Fieldline cache hit in memory\n";
+    }
+#ifdef _NETCDF_
+    if( !cache_file.empty())
+        //every process caches its local fieldlines in its own file
+        cache_file += "."+std::to_string( rank);
+    if( !cached && !cache_file.empty())
+    {
+        cached = detail::read_fieldline_cache( cache_file, key,
+                grid_transform->local().size(), yp_trafo, hbp, in_boxp,
+                ym_trafo, hbm, in_boxm);
+        if( benchmark && cached && rank==0)
+            std::cout << "# DS: Fieldline cache hit in "<<cache_file<<"\n";
+    }
+#else
+    if( !cache_file.empty() && rank==0)
+        std::cerr << "# WARNING: Fieldline cache "<<cache_file<<" requested but netcdf.h is not included! Continuing without cache!\n";
+#endif //_NETCDF_
+    if( !cached)
+    {
+        detail::integrate_all_fieldlines2d( vec, *global_grid_magnetic,
+                grid_transform->local(), yp_trafo, vol2d0.data(), hbp, in_boxp,
+                deltaPhi, eps);
+        detail::integrate_all_fieldlines2d( vec, *global_grid_magnetic,
+                grid_transform->local(), ym_trafo, vol2d0.data(), hbm, in_boxm,
+                -deltaPhi, eps);
+#ifdef _NETCDF_
+        if( !cache_file.empty())
+            detail::write_fieldline_cache( cache_file, key, yp_trafo, hbp,
+                    in_boxp, ym_trafo, hbm, in_boxm);
+#endif //_NETCDF_
+    }
+    if( trajectories == tcache.end())
+        tcache[ key] = std::make_shared<const detail::FieldlineTrajectories>(
+            detail::FieldlineTrajectories{ yp_trafo, ym_trafo, hbp, hbm,
+                in_boxp, in_boxm});
+    ///%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%//
+    //instances with identical construction parameters share the device
+    //matrices through the process local in-memory cache
+    using IMatrix = MPIDistMat<LocalIMatrix, CommunicatorXY>;
+    uint64_t mkey = detail::matrix_cache_key( key, bcx, bcy, mx, my,
+            interpolation_method);
+    auto& mcache = detail::matrix_memory_cache<IMatrix>();
+    auto matrices = mcache.find( mkey);
+    if( matrices != mcache.end())
+    {
+        m_plus  = matrices->second[0].lock();
+        m_zero  = matrices->second[1].lock();
+        m_minus = matrices->second[2].lock();
+    }
+    if( m_plus && m_zero && m_minus)
+    {
+        if( benchmark)
+        {
+            t.toc();
+            if(rank==0) std::cout << "# DS: Interpolation cache hit in memory\n";
+            t.tic();
+        }
+    }
+    else
+    {
     dg::HVec Xf = dg::evaluate(  dg::cooX2d, grid_fine.local());
     dg::HVec Yf = dg::evaluate(  dg::cooY2d, grid_fine.local());
     {
@@ -294,7 +422,9 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
         if(rank==0) std::cout << "# DS: Fieldline integration took: "<<t.diff()<<"\n";
         t.tic();
     }
-    ///%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%//
+    m_plus  = std::make_shared<IMatrix>();
+    m_zero  = std::make_shared<IMatrix>();
+    m_minus = std::make_shared<IMatrix>();
     if( inter_m == "dg")
     {
         dg::IHMatrix fine, projection, multi, temp;
@@ -314,7 +444,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
             temp.swap(multi);
         }
         dg::MIHMatrix mpi = dg::convert( multi, *grid_transform); //, tempT;
-        dg::blas2::transfer( mpi, m_plus);
+        dg::blas2::transfer( mpi, *m_plus);
 
         fine = dg::create::interpolation( Xf, Yf,
             grid_transform->global(), bcx, bcy, "dg");
@@ -327,7 +457,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
             temp.swap(multi);
         }
         mpi = dg::convert( multi, *grid_transform); //, tempT;
-        dg::blas2::transfer( mpi, m_zero);
+        dg::blas2::transfer( mpi, *m_zero);
 
         fine = dg::create::interpolation( ym[0], ym[1],
             grid_transform->global(), bcx, bcy, "dg");
@@ -340,7 +470,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
             temp.swap(multi);
         }
         mpi = dg::convert( multi, *grid_transform); //, tempT;
-        dg::blas2::transfer( mpi, m_minus);
+        dg::blas2::transfer( mpi, *m_minus);
     }
     else
     {
@@ -363,7 +493,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
             temp.swap(multi);
         }
         dg::MIHMatrix mpi = dg::convert( multi, *grid_transform);
-        dg::blas2::transfer( mpi, m_plus);
+        dg::blas2::transfer( mpi, *m_plus);
 
         fine = dg::create::backproject( grid_transform->global()); // from dg to equidist
         multi = dg::create::interpolation( Xf, Yf,
@@ -378,7 +508,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
             temp.swap(multi);
         }
         mpi = dg::convert( multi, *grid_transform);
-        dg::blas2::transfer( mpi, m_zero);
+        dg::blas2::transfer( mpi, *m_zero);
 
         fine = dg::create::backproject( grid_transform->global()); // from dg to equidist
         multi = dg::create::interpolation( ym[0], ym[1],
@@ -393,13 +523,15 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
             temp.swap(multi);
         }
         mpi = dg::convert( multi, *grid_transform);
-        dg::blas2::transfer( mpi, m_minus);
+        dg::blas2::transfer( mpi, *m_minus);
     }
     if( benchmark)
     {
         t.toc();
         if(rank==0) std::cout << "# DS: Multiplication PI     took: "<<t.diff()<<"\n";
     }
+    mcache[ mkey] = { m_plus, m_zero, m_minus};
+    }
     ///%%%%%%%%%%%%%%%%%%%%copy into h vectors %%%%%%%%%%%%%%%%%%%//
     dg::HVec hbphi( yp_trafo[2]), hbphiP(hbphi), hbphiM(hbphi);
     auto tmp = dg::pullback( vec.z(), *grid_transform);
@@ -468,6 +600,7 @@ Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<L
     m_ghostM = m_ghostP = m_right = m_left;
 #ifdef _DG_CUDA_UNAWARE_MPI
     m_recv_buffer = m_send_buffer = m_ghostP.data();
+    m_recv_buffer2 = m_send_buffer2 = m_ghostP.data();
 #endif
 }
 
@@ -477,8 +610,6 @@ void Fieldaligned<G, MPIDistMat<M,C>, MPI_Vector<container> >::operator()(enum
         whichMatrix which, const MPI_Vector<container>& f,
         MPI_Vector<container>& fe)
 {
-    if(which == einsPlus || which == einsMinusT) ePlus( which, f, fe);
-    if(which == einsMinus || which == einsPlusT) eMinus( which, f, fe);
     if(     which == einsPlus  || which == einsMinusT ) ePlus(  which, f, fe);
     else if(which == einsMinus || which == einsPlusT  ) eMinus( which, f, fe);
     else if(which == zeroMinus || which == zeroPlus ||
@@ -494,24 +625,24 @@ void Fieldaligned<G, MPIDistMat<M,C>, MPI_Vector<container> >::zero( enum whichM
     for( unsigned i0=0; i0<m_Nz; i0++)
     {
         if(which == zeroPlus)
-            dg::blas2::symv( m_plus,   m_f[i0], m_temp[i0]);
+            dg::blas2::symv( *m_plus,   m_f[i0], m_temp[i0]);
         else if(which == zeroMinus)
-            dg::blas2::symv( m_minus,  m_f[i0], m_temp[i0]);
+            dg::blas2::symv( *m_minus,  m_f[i0], m_temp[i0]);
         else if(which == zeroPlusT)
         {
             if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_plusT,  m_f[i0], m_temp[i0]);
+            dg::blas2::symv( *m_plusT,  m_f[i0], m_temp[i0]);
         }
         else if(which == zeroMinusT)
         {
             if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_minusT, m_f[i0], m_temp[i0]);
+            dg::blas2::symv( *m_minusT, m_f[i0], m_temp[i0]);
         }
         else if( which == zeroForw)
         {
             if ( m_interpolation_method != "dg" )
             {
-                dg::blas2::symv( m_zero, m_f[i0], m_temp[i0]);
+                dg::blas2::symv( *m_zero, m_f[i0], m_temp[i0]);
             }
             else
                 dg::blas1::copy( m_f[i0], m_temp[i0]);
@@ -524,30 +655,41 @@ void Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::ePlus( enum whichM
 {
     dg::split( f, m_f, *m_g);
     dg::split( fpe, m_temp, *m_g);
-    //1. compute 2d interpolation in every plane and store in m_temp
-    for( unsigned i0=0; i0<m_Nz; i0++)
+    if( which == einsMinusT && ! m_have_adjoint) updateAdjoint( );
+    //1. compute the halo plane first and post its exchange right away
+    MPI_Request rqst[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    if( m_sizeZ != 1)
+    {
+        unsigned i0 = m_Nz-1;
+        if(which == einsPlus)
+            dg::blas2::symv( *m_plus,   m_f[0], m_temp[i0]);
+        else if(which == einsMinusT)
+            dg::blas2::symv( *m_minusT, m_f[0], m_temp[i0]);
+#ifdef _DG_CUDA_UNAWARE_MPI
+        thrust::copy( m_temp[i0].data().cbegin(), m_temp[i0].data().cend(), m_send_buffer.begin());
+        detail::isendBackward( m_send_buffer, m_recv_buffer, m_g->communicator(), rqst);
+#else
+        detail::isendBackward( m_temp[i0].data(), m_ghostM.data(), m_g->communicator(), rqst);
+#endif //_DG_CUDA_UNAWARE_MPI
+    }
+    //2. compute 2d interpolation in the remaining planes, overlapping with communication
+    unsigned last = (m_sizeZ != 1) ? m_Nz-1 : m_Nz;
+    for( unsigned i0=0; i0<last; i0++)
     {
         unsigned ip = (i0==m_Nz-1) ? 0:i0+1;
         if(which == einsPlus)
-            dg::blas2::symv( m_plus,   m_f[ip], m_temp[i0]);
+            dg::blas2::symv( *m_plus,   m_f[ip], m_temp[i0]);
         else if(which == einsMinusT)
-        {
-            if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_minusT, m_f[ip], m_temp[i0]);
-        }
+            dg::blas2::symv( *m_minusT, m_f[ip], m_temp[i0]);
     }
-
-    //2. communicate halo in z
+    //wait for the halo and overwrite the last plane
     if( m_sizeZ != 1)
     {
-        unsigned i0 = m_Nz-1;
+        MPI_Waitall( 2, rqst, MPI_STATUSES_IGNORE);
 #ifdef _DG_CUDA_UNAWARE_MPI
-        thrust::copy( m_temp[i0].data().cbegin(), m_temp[i0].data().cend(), m_send_buffer.begin());
-        detail::sendBackward( m_send_buffer, m_recv_buffer, m_g->communicator());
-        thrust::copy( m_recv_buffer.cbegin(), m_recv_buffer.cend(), m_temp[i0].data().begin());
+        thrust::copy( m_recv_buffer.cbegin(), m_recv_buffer.cend(), m_temp[m_Nz-1].data().begin());
 #else
-        detail::sendBackward( m_temp[i0].data(), m_ghostM.data(), m_g->communicator());
-        dg::blas1::copy( m_ghostM, m_temp[i0]);
+        dg::blas1::copy( m_ghostM, m_temp[m_Nz-1]);
 #endif //_DG_CUDA_UNAWARE_MPI
     }
 
@@ -572,30 +714,40 @@ void Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::eMinus( enum which
     MPI_Comm_rank(m_g->communicator(), &rank);
     dg::split( f, m_f, *m_g);
     dg::split( fme, m_temp, *m_g);
-    //1. compute 2d interpolation in every plane and store in m_temp
-    for( unsigned i0=0; i0<m_Nz; i0++)
+    if( which == einsPlusT && ! m_have_adjoint) updateAdjoint( );
+    //1. compute the halo plane first and post its exchange right away
+    MPI_Request rqst[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    if( m_sizeZ != 1)
+    {
+        if(which == einsPlusT)
+            dg::blas2::symv( *m_plusT, m_f[m_Nz-1], m_temp[0]);
+        else if(which == einsMinus)
+            dg::blas2::symv( *m_minus, m_f[m_Nz-1], m_temp[0]);
+#ifdef _DG_CUDA_UNAWARE_MPI
+        thrust::copy( m_temp[0].data().cbegin(), m_temp[0].data().cend(), m_send_buffer.begin());
+        detail::isendForward( m_send_buffer, m_recv_buffer, m_g->communicator(), rqst);
+#else
+        detail::isendForward( m_temp[0].data(), m_ghostP.data(), m_g->communicator(), rqst);
+#endif //_DG_CUDA_UNAWARE_MPI
+    }
+    //2. compute 2d interpolation in the remaining planes, overlapping with communication
+    unsigned first = (m_sizeZ != 1) ? 1 : 0;
+    for( unsigned i0=first; i0<m_Nz; i0++)
     {
         unsigned im = (i0==0) ? m_Nz-1:i0-1;
         if(which == einsPlusT)
-        {
-            if( ! m_have_adjoint) updateAdjoint( );
-            dg::blas2::symv( m_plusT, m_f[im], m_temp[i0]);
-        }
+            dg::blas2::symv( *m_plusT, m_f[im], m_temp[i0]);
         else if(which == einsMinus)
-            dg::blas2::symv( m_minus, m_f[im], m_temp[i0]);
+            dg::blas2::symv( *m_minus, m_f[im], m_temp[i0]);
     }
-
-    //2. communicate halo in z
+    //wait for the halo and overwrite the first plane
     if( m_sizeZ != 1)
     {
-        unsigned i0 = 0;
+        MPI_Waitall( 2, rqst, MPI_STATUSES_IGNORE);
 #ifdef _DG_CUDA_UNAWARE_MPI
-        thrust::copy( m_temp[i0].data().cbegin(), m_temp[i0].data().cend(), m_send_buffer.begin());
-        detail::sendForward( m_send_buffer, m_recv_buffer, m_g->communicator());
-        thrust::copy( m_recv_buffer.cbegin(), m_recv_buffer.cend(), m_temp[i0].data().begin());
+        thrust::copy( m_recv_buffer.cbegin(), m_recv_buffer.cend(), m_temp[0].data().begin());
 #else
-        detail::sendForward( m_temp[i0].data(), m_ghostP.data(), m_g->communicator());
-        dg::blas1::copy( m_ghostP, m_temp[i0]);
+        dg::blas1::copy( m_ghostP, m_temp[0]);
 #endif //_DG_CUDA_UNAWARE_MPI
     }
 
@@ -613,6 +765,78 @@ void Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::eMinus( enum which
     }
 }
 
+template<class G, class M, class C, class container>
+void Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::ePlusMinus( const MPI_Vector<container>& f, MPI_Vector<container>& fpe, MPI_Vector<container>& fme)
+{
+    dg::split( f, m_f, *m_g);
+    dg::split( fpe, m_temp, *m_g);
+    std::vector<MPI_Vector<dg::View<container>> > tempM = dg::split( fme, *m_g);
+    //1. compute the two halo planes first and post their exchanges right away
+    MPI_Request rqst[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL,
+                           MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+    if( m_sizeZ != 1)
+    {
+        dg::blas2::symv( *m_plus,  m_f[0],      m_temp[m_Nz-1]);
+        dg::blas2::symv( *m_minus, m_f[m_Nz-1], tempM[0]);
+#ifdef _DG_CUDA_UNAWARE_MPI
+        thrust::copy( m_temp[m_Nz-1].data().cbegin(), m_temp[m_Nz-1].data().cend(), m_send_buffer.begin());
+        detail::isendBackward( m_send_buffer, m_recv_buffer, m_g->communicator(), &rqst[0]);
+        thrust::copy( tempM[0].data().cbegin(), tempM[0].data().cend(), m_send_buffer2.begin());
+        detail::isendForward( m_send_buffer2, m_recv_buffer2, m_g->communicator(), &rqst[2]);
+#else
+        detail::isendBackward( m_temp[m_Nz-1].data(), m_ghostM.data(), m_g->communicator(), &rqst[0]);
+        detail::isendForward( tempM[0].data(), m_ghostP.data(), m_g->communicator(), &rqst[2]);
+#endif //_DG_CUDA_UNAWARE_MPI
+    }
+    //2. compute the remaining 2d interpolations in one sweep, overlapping with communication
+    for( unsigned i0=0; i0<m_Nz; i0++)
+    {
+        unsigned im = (i0==0) ? m_Nz-1:i0-1;
+        unsigned ip = (i0==m_Nz-1) ? 0:i0+1;
+        if( m_sizeZ == 1 || i0 != 0)
+            dg::blas2::symv( *m_plus,  m_f[i0], m_temp[im]);
+        if( m_sizeZ == 1 || i0 != m_Nz-1)
+            dg::blas2::symv( *m_minus, m_f[i0], tempM[ip]);
+    }
+    //wait for the halos and overwrite the boundary planes
+    if( m_sizeZ != 1)
+    {
+        MPI_Waitall( 4, rqst, MPI_STATUSES_IGNORE);
+#ifdef _DG_CUDA_UNAWARE_MPI
+        thrust::copy( m_recv_buffer.cbegin(), m_recv_buffer.cend(), m_temp[m_Nz-1].data().begin());
+        thrust::copy( m_recv_buffer2.cbegin(), m_recv_buffer2.cend(), tempM[0].data().begin());
+#else
+        dg::blas1::copy( m_ghostM, m_temp[m_Nz-1]);
+        dg::blas1::copy( m_ghostP, tempM[0]);
+#endif //_DG_CUDA_UNAWARE_MPI
+    }
+
+    //3. apply right boundary conditions in last plane
+    unsigned i0=m_Nz-1;
+    if( m_bcz != dg::PER && m_g->local().z1() == m_g->global().z1())
+    {
+        if( m_bcz == dg::DIR || m_bcz == dg::NEU_DIR)
+            dg::blas1::axpby( 2, m_right, -1., m_f[i0], m_ghostP);
+        if( m_bcz == dg::NEU || m_bcz == dg::DIR_NEU)
+            dg::blas1::axpby( m_deltaPhi, m_right, 1., m_f[i0], m_ghostP);
+        //interlay ghostcells with periodic cells: L*g + (1-L)*fpe
+        dg::blas1::axpby( 1., m_ghostP, -1., m_temp[i0], m_ghostP);
+        dg::blas1::pointwiseDot( 1., m_limiter, m_ghostP, 1., m_temp[i0]);
+    }
+    //4. apply left boundary conditions in first plane
+    i0=0;
+    if( m_bcz != dg::PER && m_g->local().z0() == m_g->global().z0())
+    {
+        if( m_bcz == dg::DIR || m_bcz == dg::DIR_NEU)
+            dg::blas1::axpby( 2., m_left,  -1., m_f[i0], m_ghostM);
+        if( m_bcz == dg::NEU || m_bcz == dg::NEU_DIR)
+            dg::blas1::axpby( -m_deltaPhi, m_left, 1., m_f[i0], m_ghostM);
+        //interlay ghostcells with periodic cells: L*g + (1-L)*fme
+        dg::blas1::axpby( 1., m_ghostM, -1., tempM[i0], m_ghostM);
+        dg::blas1::pointwiseDot( 1., m_limiter, m_ghostM, 1., tempM[i0]);
+    }
+}
+
 template<class G, class M, class C, class container>
 template< class BinaryOp, class UnaryOp>
 MPI_Vector<container> Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::evaluate( BinaryOp binary, UnaryOp unary, unsigned p0, unsigned rounds) const
@@ -640,10 +864,10 @@ MPI_Vector<container> Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::e
             for(unsigned k=0; k<rep; k++)
             {
                 //!!! The value of f at the plus plane is I^- of the current plane
-                dg::blas2::symv( m_minus, tempP, temp);
+                dg::blas2::symv( *m_minus, tempP, temp);
                 temp.swap( tempP);
                 //!!! The value of f at the minus plane is I^+ of the current plane
-                dg::blas2::symv( m_plus, tempM, temp);
+                dg::blas2::symv( *m_plus, tempM, temp);
                 temp.swap( tempM);
             }
             dg::blas1::scal( tempP, unary(  (double)rep*m_deltaPhi ) );
@@ -42,7 +42,7 @@ struct Psip: public aCylindricalFunctor<Psip>
      * @param gp geometric parameters
      */
     Psip( Parameters gp ): m_R0(gp.R_0),  m_pp(gp.pp), m_horner(gp.c, gp.M, gp.N) {}
-    double do_compute(double R, double Z) const
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         return m_R0*m_pp*m_horner( R/m_R0,Z/m_R0);
     }
@@ -61,7 +61,7 @@ struct PsipR: public aCylindricalFunctor<PsipR>
                 beta[i*gp.N+j] = (double)(i+1)*gp.c[ ( i+1)*gp.N +j];
         m_horner = Horner2d( beta, gp.M-1, gp.N);
     }
-    double do_compute(double R, double Z) const
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         return m_pp*m_horner( R/m_R0,Z/m_R0);
     }
@@ -79,7 +79,7 @@ struct PsipRR: public aCylindricalFunctor<PsipRR>
                 beta[i*gp.N+j] = (double)((i+2)*(i+1))*gp.c[ (i+2)*gp.N +j];
         m_horner = Horner2d( beta, gp.M-2, gp.N);
     }
-    double do_compute(double R, double Z) const
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         return m_pp/m_R0*m_horner( R/m_R0,Z/m_R0);
     }
@@ -97,7 +97,7 @@ struct PsipZ: public aCylindricalFunctor<PsipZ>
                 beta[i*(gp.N-1)+j] = (double)(j+1)*gp.c[ i*gp.N +j+1];
         m_horner = Horner2d( beta, gp.M, gp.N-1);
     }
-    double do_compute(double R, double Z) const
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         return m_pp*m_horner( R/m_R0,Z/m_R0);
     }
@@ -115,7 +115,7 @@ struct PsipZZ: public aCylindricalFunctor<PsipZZ>
                 beta[i*(gp.N-2)+j] = (double)((j+2)*(j+1))*gp.c[ i*gp.N +j+2];
         m_horner = Horner2d( beta, gp.M, gp.N-2);
     }
-    double do_compute(double R, double Z) const
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         return m_pp/m_R0*m_horner(R/m_R0,Z/m_R0);
     }
@@ -133,7 +133,7 @@ struct PsipRZ: public aCylindricalFunctor<PsipRZ>
                 beta[i*(gp.N-1)+j] = (double)((j+1)*(i+1))*gp.c[ (i+1)*gp.N +j+1];
         m_horner = Horner2d( beta, gp.M-1, gp.N-1);
     }
-    double do_compute(double R, double Z) const
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         return m_pp/m_R0*m_horner(R/m_R0,Z/m_R0);
     }
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <array>
 #include <vector>
 
 #include "dg/blas.h"
@@ -64,8 +65,10 @@ struct Psip: public aCylindricalFunctor<Psip>
      *
      * @param gp geometric parameters
      */
-    Psip( Parameters gp ): m_R0(gp.R_0), m_A(gp.A), m_pp(gp.pp), m_c(gp.c) {}
-    double do_compute(double R, double Z) const
+    Psip( Parameters gp ): m_R0(gp.R_0), m_A(gp.A), m_pp(gp.pp) {
+        std::copy( gp.c.begin(), gp.c.end(), m_c.begin());
+    }
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,Zn5,Zn6,lgRn;
         Rn = R/m_R0; Rn2 = Rn*Rn; Rn4 = Rn2*Rn2;
@@ -89,7 +92,7 @@ struct Psip: public aCylindricalFunctor<Psip>
     }
   private:
     double m_R0, m_A, m_pp;
-    std::vector<double> m_c;
+    std::array<double,12> m_c;
 };
 
 /**
@@ -113,8 +116,10 @@ struct Psip: public aCylindricalFunctor<Psip>
 struct PsipR: public aCylindricalFunctor<PsipR>
 {
     ///@copydoc Psip::Psip()
-    PsipR( Parameters gp ): m_R0(gp.R_0), m_A(gp.A), m_pp(gp.pp), m_c(gp.c) {}
-    double do_compute(double R, double Z) const
+    PsipR( Parameters gp ): m_R0(gp.R_0), m_A(gp.A), m_pp(gp.pp) {
+        std::copy( gp.c.begin(), gp.c.end(), m_c.begin());
+    }
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn3,Rn5,Zn,Zn2,Zn3,Zn4,lgRn;
         Rn = R/m_R0; Rn2 = Rn*Rn; Rn3 = Rn2*Rn;  Rn5 = Rn3*Rn2;
@@ -132,7 +137,7 @@ struct PsipR: public aCylindricalFunctor<PsipR>
     }
   private:
     double m_R0, m_A, m_pp;
-    std::vector<double> m_c;
+    std::array<double,12> m_c;
 };
 /**
  * @brief \f[ \frac{\partial^2  \hat{\psi}_p }{ \partial \hat{R}^2}\f]
@@ -154,8 +159,10 @@ struct PsipR: public aCylindricalFunctor<PsipR>
 struct PsipRR: public aCylindricalFunctor<PsipRR>
 {
     ///@copydoc Psip::Psip()
-    PsipRR( Parameters gp ): m_R0(gp.R_0), m_A(gp.A), m_pp(gp.pp), m_c(gp.c) {}
-    double do_compute(double R, double Z) const
+    PsipRR( Parameters gp ): m_R0(gp.R_0), m_A(gp.A), m_pp(gp.pp) {
+        std::copy( gp.c.begin(), gp.c.end(), m_c.begin());
+    }
+    DG_DEVICE double do_compute(double R, double Z) const
     {
        double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,lgRn;
        Rn = R/m_R0; Rn2 = Rn*Rn;  Rn4 = Rn2*Rn2;
@@ -171,7 +178,7 @@ struct PsipRR: public aCylindricalFunctor<PsipRR>
     }
   private:
     double m_R0, m_A, m_pp;
-    std::vector<double> m_c;
+    std::array<double,12> m_c;
 };
 /**
  * @brief \f[\frac{\partial \hat{\psi}_p }{ \partial \hat{Z}}\f]
@@ -190,8 +197,10 @@ struct PsipRR: public aCylindricalFunctor<PsipRR>
 struct PsipZ: public aCylindricalFunctor<PsipZ>
 {
     ///@copydoc Psip::Psip()
-    PsipZ( Parameters gp ): m_R0(gp.R_0), m_pp(gp.pp), m_c(gp.c) { }
-    double do_compute(double R, double Z) const
+    PsipZ( Parameters gp ): m_R0(gp.R_0), m_pp(gp.pp) {
+        std::copy( gp.c.begin(), gp.c.end(), m_c.begin());
+    }
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,Zn5,lgRn;
         Rn = R/m_R0; Rn2 = Rn*Rn;  Rn4 = Rn2*Rn2;
@@ -212,7 +221,7 @@ struct PsipZ: public aCylindricalFunctor<PsipZ>
     }
   private:
     double m_R0, m_pp;
-    std::vector<double> m_c;
+    std::array<double,12> m_c;
 };
 /**
  * @brief \f[ \frac{\partial^2  \hat{\psi}_p }{ \partial \hat{Z}^2}\f]
@@ -228,8 +237,10 @@ struct PsipZ: public aCylindricalFunctor<PsipZ>
 struct PsipZZ: public aCylindricalFunctor<PsipZZ>
 {
     ///@copydoc Psip::Psip()
-    PsipZZ( Parameters gp): m_R0(gp.R_0), m_pp(gp.pp), m_c(gp.c) { }
-    double do_compute(double R, double Z) const
+    PsipZZ( Parameters gp): m_R0(gp.R_0), m_pp(gp.pp) {
+        std::copy( gp.c.begin(), gp.c.end(), m_c.begin());
+    }
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,lgRn;
         Rn = R/m_R0; Rn2 = Rn*Rn; Rn4 = Rn2*Rn2;
@@ -240,7 +251,7 @@ struct PsipZZ: public aCylindricalFunctor<PsipZZ>
     }
   private:
     double m_R0, m_pp;
-    std::vector<double> m_c;
+    std::array<double,12> m_c;
 };
 /**
  * @brief  \f[\frac{\partial^2  \hat{\psi}_p }{ \partial \hat{R} \partial\hat{Z}}\f]
@@ -258,8 +269,10 @@ struct PsipZZ: public aCylindricalFunctor<PsipZZ>
 struct PsipRZ: public aCylindricalFunctor<PsipRZ>
 {
     ///@copydoc Psip::Psip()
-    PsipRZ( Parameters gp ): m_R0(gp.R_0), m_pp(gp.pp), m_c(gp.c) { }
-    double do_compute(double R, double Z) const
+    PsipRZ( Parameters gp ): m_R0(gp.R_0), m_pp(gp.pp) {
+        std::copy( gp.c.begin(), gp.c.end(), m_c.begin());
+    }
+    DG_DEVICE double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn3,Zn,Zn2,Zn3,lgRn;
         Rn = R/m_R0; Rn2 = Rn*Rn; Rn3 = Rn2*Rn;
@@ -273,7 +286,7 @@ struct PsipRZ: public aCylindricalFunctor<PsipRZ>
     }
   private:
     double m_R0, m_pp;
-    std::vector<double> m_c;
+    std::array<double,12> m_c;
 };
 
 /**
@@ -346,11 +359,153 @@ struct IpolZ: public aCylindricalFunctor<IpolZ>
     std::function<double(double,double)> m_psip, m_psipZ;
 };
 
+///@cond
+namespace detail
+{
+//monomial tables of \bar\psi_p = P(\bar R,\bar Z) + ln(\bar R) Q(\bar R,\bar Z)
+//with P[i*N+j] the coefficient of \bar R^i \bar Z^j and M = N = 7
+static inline void psip_tables( double A, const std::vector<double>& c,
+        std::vector<double>& P, std::vector<double>& Q)
+{
+    const unsigned N = 7;
+    P.assign( N*N, 0.), Q.assign( N*N, 0.);
+    auto p = [&]( unsigned i, unsigned j) -> double& { return P[i*N+j];};
+    auto q = [&]( unsigned i, unsigned j) -> double& { return Q[i*N+j];};
+    p(4,0) = 1./8. - A/8. + c[3];
+    p(0,0) = c[0];
+    p(2,0) = c[1];
+    p(0,2) = c[2];
+    p(2,2) = -4.*c[3] - 9.*c[4];
+    p(0,4) = 2.*c[4];
+    p(6,0) = c[5];
+    p(4,2) = -12.*c[5] + 75.*c[6];
+    p(2,4) = 8.*c[5] - 140.*c[6];
+    p(0,6) = 8.*c[6];
+    p(0,1) = c[7];
+    p(2,1) = c[8];
+    p(0,3) = c[9];
+    p(4,1) = 3.*c[10] - 45.*c[11];
+    p(2,3) = -4.*c[10];
+    p(0,5) = 8.*c[11];
+    q(2,0) = A/2. - c[2];
+    q(4,0) = 3.*c[4];
+    q(2,2) = -12.*c[4];
+    q(6,0) = -15.*c[6];
+    q(4,2) = 180.*c[6];
+    q(2,4) = -120.*c[6];
+    q(2,1) = -3.*c[9];
+    q(4,1) = 60.*c[11];
+    q(2,3) = -80.*c[11];
+}
+//derivatives and division by x of a monomial table
+static inline std::vector<double> poly_dx( const std::vector<double>& P,
+        unsigned N)
+{
+    std::vector<double> D( P.size(), 0.);
+    for( unsigned i=0; i<N-1; i++)
+        for( unsigned j=0; j<N; j++)
+            D[i*N+j] = (double)(i+1)*P[(i+1)*N+j];
+    return D;
+}
+static inline std::vector<double> poly_dy( const std::vector<double>& P,
+        unsigned N)
+{
+    std::vector<double> D( P.size(), 0.);
+    for( unsigned i=0; i<N; i++)
+        for( unsigned j=0; j<N-1; j++)
+            D[i*N+j] = (double)(j+1)*P[i*N+j+1];
+    return D;
+}
+//all logarithmic terms of psip carry at least two powers of R so the
+//divisions that appear in the R-derivatives remain polynomial
+static inline std::vector<double> poly_divx( const std::vector<double>& P,
+        unsigned N)
+{
+    std::vector<double> D( P.size(), 0.);
+    for( unsigned i=0; i<N-1; i++)
+        for( unsigned j=0; j<N; j++)
+            D[i*N+j] = P[(i+1)*N+j];
+    return D;
+}
+static inline void poly_axpy( double a, const std::vector<double>& x,
+        std::vector<double>& y)
+{
+    for( unsigned i=0; i<y.size(); i++)
+        y[i] += a*x[i];
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief \f$ s\big( P(\bar R,\bar Z) + \ln(\bar R) Q(\bar R,\bar Z)\big)\f$ Horner table representation of the Psip family
+ *
+ * Each member of the Psip family is of this form with monomial tables \c P
+ * and \c Q; the tables are evaluated with two Horner schemes and a single
+ * logarithm per point, which is considerably faster than the explicit
+ * 12-term sums in the point-wise hot loops of the geometry construction
+ * (e.g. the X-point search) and vectorizes.  The functor is usable in
+ * device code (see \c dg::gpu_evaluate)
+ * @sa createTablePsip
+ */
+struct PsipTable: public aCylindricalFunctor<PsipTable>
+{
+    ///@param R0 major radius (normalizes R and Z)
+    ///@param scale prefactor \c s
+    ///@param P monomial table of the polynomial part ( \c P[i*N+j] is the coefficient of \f$ \bar R^i \bar Z^j\f$)
+    ///@param Q monomial table of the logarithmic part
+    ///@param N number of coefficients per dimension
+    PsipTable( double R0, double scale, const std::vector<double>& P,
+            const std::vector<double>& Q, unsigned N):
+        m_R0(R0), m_scale(scale), m_p( P, N, N), m_q( Q, N, N){}
+    DG_DEVICE double do_compute(double R, double Z) const
+    {
+        double Rn = R/m_R0, Zn = Z/m_R0;
+        return m_scale*( m_p( Rn, Zn) + log(Rn)*m_q( Rn, Zn));
+    }
+  private:
+    double m_R0, m_scale;
+    Horner2d m_p, m_q;
+};
+
 static inline dg::geo::CylindricalFunctorsLvl2 createPsip( const Parameters& gp)
 {
     return CylindricalFunctorsLvl2( Psip(gp), PsipR(gp), PsipZ(gp),
         PsipRR(gp), PsipRZ(gp), PsipZZ(gp));
 }
+/**
+ * @brief Horner table variant of \c createPsip
+ *
+ * Evaluates the same polynomials as \c createPsip regrouped into monomial
+ * tables; the values agree up to rounding errors while the evaluation is
+ * several times faster
+ * @param gp geometric parameters
+ * @return the flux function and its first and second derivatives
+ * @sa PsipTable
+ */
+static inline dg::geo::CylindricalFunctorsLvl2 createTablePsip( const Parameters& gp)
+{
+    const unsigned N = 7;
+    std::vector<double> P, Q;
+    detail::psip_tables( gp.A, gp.c, P, Q);
+    std::vector<double> Px = detail::poly_dx( P, N), Qx = detail::poly_dx( Q, N);
+    std::vector<double> Py = detail::poly_dy( P, N), Qy = detail::poly_dy( Q, N);
+    // psi_R = pp*( P_x + Q/x + ln(x) Q_x), analogous for the second derivatives
+    std::vector<double> PR = Px;
+    detail::poly_axpy( 1., detail::poly_divx( Q, N), PR);
+    std::vector<double> PRR = detail::poly_dx( Px, N);
+    detail::poly_axpy(  2., detail::poly_divx( Qx, N), PRR);
+    detail::poly_axpy( -1., detail::poly_divx( detail::poly_divx( Q, N), N), PRR);
+    std::vector<double> PRZ = detail::poly_dy( Px, N);
+    detail::poly_axpy( 1., detail::poly_divx( Qy, N), PRZ);
+    return CylindricalFunctorsLvl2(
+        PsipTable( gp.R_0, gp.R_0*gp.pp, P, Q, N),
+        PsipTable( gp.R_0, gp.pp, PR, Qx, N),
+        PsipTable( gp.R_0, gp.pp, Py, Qy, N),
+        PsipTable( gp.R_0, gp.pp/gp.R_0, PRR, detail::poly_dx( Qx, N), N),
+        PsipTable( gp.R_0, gp.pp/gp.R_0, PRZ, detail::poly_dy( Qx, N), N),
+        PsipTable( gp.R_0, gp.pp/gp.R_0, detail::poly_dy( Py, N),
+                   detail::poly_dy( Qy, N), N));
+}
 static inline dg::geo::CylindricalFunctorsLvl1 createIpol( const Parameters& gp, const CylindricalFunctorsLvl1& psip)
 {
     return CylindricalFunctorsLvl1(
@@ -377,8 +532,10 @@ static inline dg::geo::TokamakMagneticField createSolovevField(
 {
     MagneticFieldParameters params = { gp.a, gp.elongation, gp.triangularity,
             equilibrium::solovev, modifier::none, str2description.at( gp.description)};
-    return TokamakMagneticField( gp.R_0, solovev::createPsip(gp),
-        solovev::createIpol(gp, solovev::createPsip(gp)), params);
+    //the Horner table representation evaluates several times faster in the
+    //point-wise loops of the geometry construction
+    return TokamakMagneticField( gp.R_0, solovev::createTablePsip(gp),
+        solovev::createIpol(gp, solovev::createTablePsip(gp)), params);
 }
 /**
  * @brief DEPRECATED Create a modified Solovev Magnetic field
@@ -403,8 +560,8 @@ static inline dg::geo::TokamakMagneticField createModifiedSolovevField(
     MagneticFieldParameters params = { gp.a, gp.elongation, gp.triangularity,
             equilibrium::solovev, modifier::heaviside, str2description.at( gp.description)};
     return TokamakMagneticField( gp.R_0,
-            mod::createPsip( mod::everywhere, solovev::createPsip(gp), psi0, alpha, sign),
-        solovev::createIpol( gp, mod::createPsip( mod::everywhere, solovev::createPsip(gp), psi0, alpha, sign)),
+            mod::createPsip( mod::everywhere, solovev::createTablePsip(gp), psi0, alpha, sign),
+        solovev::createIpol( gp, mod::createPsip( mod::everywhere, solovev::createTablePsip(gp), psi0, alpha, sign)),
         params);
 }
 
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "dg/algorithm.h"
+#include "lanczos.h"
+#include "matrixfunction.h"
+
+namespace dg{
+namespace mat{
+
+/**
+ * @brief Turnkey matrix function \f$ \vec y = f( \nu \Delta_\parallel) \vec x\f$ for exponential integration of parallel diffusion
+ *
+ * The parallel diffusion operator \f$ \nu \Delta_\parallel \f$ given by the
+ * \c symv member of \c dg::geo::DS is stiff enough to dominate the timestep
+ * restriction of any explicit scheme. This class wraps it as a \c
+ * MatrixFunction (\ref hide_matrix_function) so that it can be passed directly
+ * to \c ExponentialStep or \c ExponentialERKStep, which treat the parallel
+ * diffusion exactly through \f$\varphi\f$-functions and thus remove it from
+ * the stability constraint altogether:
+ * @code
+dg::geo::DS<Geometry, IMatrix, Matrix, Container> ds( ...);
+dg::mat::ExponentialDS<decltype(ds), Container> expDS( ds, nu_parallel,
+    ds.weights(), 1e-8);
+dg::mat::ExponentialERKStep<Container> rk( "Hochbruck-3-3-4", y0);
+dg::SinglestepTimeloop<Container>( rk, std::tie( explicit_rhs, expDS),
+    dt).integrate( t0, y0, t1, y1);
+ * @endcode
+ * Internally \f$ f( \nu\Delta_\parallel)\vec x\f$ is evaluated with \c
+ * UniversalLanczos in its "universal" stopping criterion, so the size of the
+ * Krylov basis adapts to the requested accuracy in every call; \c get_iter
+ * tells how many basis vectors the last evaluation needed.  Since the Lanczos
+ * method requires a positive (semi-)definite operator the class
+ * tridiagonalizes \f$ -\nu \Delta_\parallel\f$ and flips the sign back inside
+ * the function evaluation, analogous to the \c f_inner mechanism of \c
+ * MatrixFunction.
+ * @note For \f$ f = \exp\f$ or the \f$ \varphi_i\f$ functions the semi-definite
+ * nullspace of constants along the fieldline is harmless: the eigenvalue zero
+ * is simply mapped to \f$ f(0)\f$
+ * @tparam DSType any operator with a <tt> void symv( double alpha, const
+ * ContainerType&, double beta, ContainerType&)</tt> member, typically \c
+ * dg::geo::DS (taken as template parameter so that this header does not
+ * depend on the geometries library)
+ * @copydoc hide_ContainerType
+ * @ingroup matrixfunctionapproximation
+ * @sa \c ExponentialStep \c ExponentialERKStep \c MatrixFunction
+ */
+template<class DSType, class ContainerType>
+struct ExponentialDS
+{
+    using container_type = ContainerType;
+    using value_type = dg::get_value_type<ContainerType>;
+
+    /// Construct empty
+    ExponentialDS() = default;
+
+    /**
+     * @brief Construct from parallel derivative
+     *
+     * @param ds the parallel derivative; is stored by reference
+     * @param nu the parallel diffusion coefficient \f$ \nu\f$ in \f$
+     * \nu\Delta_\parallel = \nu \vec{ ds.symv}\f$
+     * @param weights the weights in which \c ds.symv is self-adjoint,
+     * typically \c ds.weights()
+     * @param eps_rel relative accuracy of the Krylov approximation (this is
+     * what drives the adaptive basis size)
+     * @param nrmb_correction absolute accuracy in units of \c eps_rel
+     * @param max_iter Maximum number of iterations in Lanczos tridiagonalization
+     */
+    ExponentialDS( DSType& ds, value_type nu,
+            const ContainerType& weights, value_type eps_rel,
+            value_type nrmb_correction = 1.,
+            unsigned max_iter = 500
+            ) : m_weights( weights), m_eps(eps_rel), m_abs(nrmb_correction)
+    {
+        m_A = [&ds, nu]( const ContainerType& x, ContainerType& y){
+            // Lanczos needs positive semi-definite, so tridiagonalize -nu Delta_par
+            ds.symv( -nu, x, 0., y);
+        };
+        m_lanczos.construct( weights, max_iter);
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = ExponentialDS( std::forward<Params>( ps)...);
+    }
+    /// Get the size of the Krylov basis in the latest call to \c operator()
+    unsigned get_iter() const{return m_number;}
+
+    ///@copydoc MatrixSqrt::set_benchmark()
+    void set_benchmark( bool benchmark, std::string message = "ExpDS"){
+        m_benchmark = benchmark;
+        m_message = message;
+    }
+    ///@copydoc UniversalLanczos::set_reuse_tolerance()
+    void set_reuse_tolerance( value_type tol){
+        m_lanczos.set_reuse_tolerance( tol);
+    }
+
+    /**
+     * @brief Apply \f$ \vec y = f( \nu\Delta_\parallel) \vec x\f$
+     *
+     * This is the \ref hide_matrix_function interface called by the
+     * exponential integrators
+     * @param f_outer the function to apply, e.g. the exponential or one of
+     * the \c dg::mat::phi1, \c dg::mat::phi2, ... functions
+     * @param x input vector
+     * @param y output vector, contains \f$ \vec y = f( \nu\Delta_\parallel)
+     * \vec x\f$ on output
+     */
+    template<class UnaryOp, class ContainerType0, class ContainerType1>
+    void operator()( UnaryOp f_outer, const ContainerType0& x, ContainerType1& y)
+    {
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+        dg::Timer t;
+        t.tic();
+        // we tridiagonalized -nu Delta_par, so flip the sign back
+        auto func = make_FuncEigen_Te1( [&](value_type lambda) {
+                return f_outer( -lambda);});
+        m_number = m_lanczos.solve( y, func, m_A, x, m_weights, m_eps, m_abs,
+                "universal", 1., 2);
+        t.toc();
+        if( m_benchmark)
+            DG_RANK0 std::cout << "# `"<<m_message<<"` solve with {"<<m_number<<"} iterations took "<<t.diff()<<"s\n";
+    }
+    private:
+    UniversalLanczos<ContainerType> m_lanczos;
+    ContainerType m_weights;
+    std::function< void( const ContainerType&, ContainerType&)> m_A;
+    unsigned m_number = 0;
+    value_type m_eps, m_abs;
+    bool m_benchmark = true;
+    std::string m_message = "ExpDS";
+
+};
+
+}//namespace mat
+}//namespace dg
@@ -14,6 +14,48 @@
 namespace dg{
 namespace mat{
 
+///@cond
+namespace detail
+{
+//Compute several weighted dot products res[k] = ( *xs[k], w, *ys[k]) with a
+//single global reduction. For shared memory vectors this is just a loop; for
+//MPI vectors the local products are exact (exblas) while the global sum is a
+//single ordinary MPI_Allreduce, which trades the bitwise reproducibility of
+//dg::blas2::dot for one latency instead of xs.size() many.
+template<class ContainerType, class ContainerType2>
+std::vector<double> multi_dot( dg::AnyVectorTag,
+    const std::vector<const ContainerType*>& xs, const ContainerType2& w,
+    const std::vector<const ContainerType*>& ys)
+{
+    std::vector<double> res( xs.size());
+    for( unsigned k=0; k<xs.size(); k++)
+        res[k] = dg::blas2::dot( *xs[k], w, *ys[k]);
+    return res;
+}
+#ifdef MPI_VERSION
+template<class ContainerType, class ContainerType2>
+std::vector<double> multi_dot( dg::MPIVectorTag,
+    const std::vector<const ContainerType*>& xs, const ContainerType2& w,
+    const std::vector<const ContainerType*>& ys)
+{
+    std::vector<double> res( xs.size());
+    for( unsigned k=0; k<xs.size(); k++)
+        res[k] = dg::blas2::dot( xs[k]->data(), w.data(), ys[k]->data());
+    MPI_Allreduce( MPI_IN_PLACE, res.data(), (int)res.size(), MPI_DOUBLE,
+            MPI_SUM, w.communicator());
+    return res;
+}
+#endif //MPI_VERSION
+template<class ContainerType, class ContainerType2>
+std::vector<double> multi_dot(
+    const std::vector<const ContainerType*>& xs, const ContainerType2& w,
+    const std::vector<const ContainerType*>& ys)
+{
+    return multi_dot( dg::get_tensor_category<ContainerType>(), xs, w, ys);
+}
+}//namespace detail
+///@endcond
+
 /**
 * @brief Tridiagonalize \f$A\f$ and approximate \f$f(A)b \approx |b|_W V f(T) e_1\f$
 *  via Lanczos algorithm. A is self-adjoint in the weights \f$ W\f$
@@ -110,6 +152,59 @@ class UniversalLanczos
     ///@param verbose If true, additional output will be written to \c std::cout during solution
     void set_verbose( bool verbose){ m_verbose = verbose;}
 
+    /**
+     * @brief Reuse the tridiagonal matrix of the previous \c solve if A and b changed little
+     *
+     * In time integrations the operator \f$ A\f$ and the vector \f$ \vec
+     * b\f$ often change only slowly between calls. Since \c solve
+     * regenerates the Krylov basis from \f$ \vec b\f$ and \f$ T\f$ with the
+     * three-term recurrence anyway, the tridiagonalization can be skipped
+     * entirely if the previous \f$ T\f$ still describes the action of \f$
+     * A\f$ on the Krylov space of \f$ \vec b\f$. With \c tol greater than
+     * zero \c solve first checks (with one matrix-vector product) whether
+     * the direction of \f$ \vec b\f$ and the first Lanczos coefficients
+     * \f$\alpha_1,\ \beta_1\f$ deviate relatively less than \c tol from the
+     * cached ones and if so reuses the cached \f$ T\f$. This halves the
+     * matrix-vector products of a solve and avoids all scalar products of
+     * the tridiagonalization (a significant saving in parallel) in
+     * quasi-stationary phases, at the cost of one additional matrix-vector
+     * product whenever the check fails.
+     * @param tol relative tolerance for the reuse check (0, the default,
+     *  tridiagonalizes on every call); should be chosen in the order of the
+     *  accuracy \c eps given to \c solve
+     */
+    void set_reuse_tolerance( value_type tol)
+    {
+        m_reuse_tol = tol;
+        if( tol > 0)
+            m_b_old = m_v;
+        m_cache_valid = false;
+    }
+
+    /**
+     * @brief Use the communication-avoiding s-step tridiagonalization engine
+     *
+     * The default tridiagonalization performs two global reductions per
+     * iteration, which becomes allreduce-bound at large rank counts. The
+     * s-step engine instead generates a block of monomial basis vectors,
+     * computes their Gram matrix with a **single** global reduction and
+     * recovers \c s Lanczos coefficients per block from coordinate
+     * recurrences in the small basis (the Gram matrix corrects for the
+     * non-orthogonality of the monomial basis). Communication drops by
+     * roughly a factor \f$ 2s\f$ at the cost of almost twice the number of
+     * matrix-vector products ( \f$2s-1\f$ per block) and additional local
+     * dot products.
+     * @note The monomial basis becomes ill-conditioned for large \c s so
+     * values above 4 are not recommended. The global sums also lose the
+     * bitwise reproducibility of \c dg::blas2::dot across rank topologies.
+     * @param s number of Lanczos steps per global reduction (1, the
+     *  default, selects the standard engine)
+     */
+    void set_sstep( unsigned s)
+    {
+        m_sstep = s == 0 ? 1 : s;
+    }
+
     ///@brief Norm of \c b from last call to \c operator()
     ///@return bnorm
     value_type get_bnorm() const{return m_bnorm;}
@@ -151,13 +246,38 @@ class UniversalLanczos
             value_type res_fac = 1.,
             unsigned q = 1 )
     {
-        tridiag( f, std::forward<MatrixType>(A), b, weights, eps,
-                nrmb_correction, error_norm, res_fac, q);
+        if( m_reuse_tol > 0 && check_reuse( std::forward<MatrixType>(A), b,
+                    weights))
+        {
+            if( m_verbose)
+            {
+#ifdef MPI_VERSION
+                int rank;
+                MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+                DG_RANK0 std::cout << "# Reuse cached T with "<<m_iter<<" iterations\n";
+            }
+            m_yH = f( m_TH);
+            normMbVy(std::forward<MatrixType>(A), m_TH, m_yH, x, b,
+                    m_bnorm);
+            return m_iter;
+        }
+        if( m_sstep > 1)
+            tridiag_sstep( f, std::forward<MatrixType>(A), b, weights, eps,
+                    nrmb_correction, error_norm, res_fac, q);
+        else
+            tridiag( f, std::forward<MatrixType>(A), b, weights, eps,
+                    nrmb_correction, error_norm, res_fac, q);
         if( "residual" == error_norm)
             m_yH = f( m_TH);
         //Compute x = |b|_M V f(T) e1
         normMbVy(std::forward<MatrixType>(A), m_TH, m_yH, x, b,
                 m_bnorm);
+        if( m_reuse_tol > 0 && m_bnorm != 0)
+        {
+            dg::blas1::axpby( 1./m_bnorm, b, 0., m_b_old);
+            m_cache_valid = true;
+        }
         return m_iter;
     }
     /**
@@ -189,8 +309,12 @@ class UniversalLanczos
         )
     {
         auto op = make_Linear_Te1( -1);
-        tridiag( op, std::forward<MatrixType>(A), b, weights, eps,
-                nrmb_correction, error_norm, res_fac, q);
+        if( m_sstep > 1)
+            tridiag_sstep( op, std::forward<MatrixType>(A), b, weights, eps,
+                    nrmb_correction, error_norm, res_fac, q);
+        else
+            tridiag( op, std::forward<MatrixType>(A), b, weights, eps,
+                    nrmb_correction, error_norm, res_fac, q);
         return m_TH;
     }
 
@@ -200,6 +324,33 @@ class UniversalLanczos
     unsigned get_iter() const {return m_iter;}
   private:
 
+    /** @brief Check whether the cached tridiagonal matrix can be reused
+     *
+     * Compares the direction of \c b and the first Lanczos coefficients
+     * \f$ \alpha_1,\ \beta_1\f$ (one matrix-vector product) against the
+     * cached values. Also sets \c m_bnorm.
+     * @return true if both deviate relatively less than \c m_reuse_tol
+     */
+    template< class MatrixType, class ContainerType1, class ContainerType2>
+    bool check_reuse( MatrixType&& A, const ContainerType1& b,
+            const ContainerType2& weights)
+    {
+        m_bnorm = sqrt(dg::blas2::dot(b, weights, b));
+        if( !m_cache_valid || 0 == m_bnorm || m_iter < 2)
+            return false;
+        dg::blas1::axpby( 1./m_bnorm, b, 0., m_v);
+        dg::blas1::axpby( 1., m_v, -1., m_b_old, m_vm);
+        if( sqrt(dg::blas2::dot( m_vm, weights, m_vm)) > m_reuse_tol)
+            return false;
+        dg::blas2::symv( std::forward<MatrixType>(A), m_v, m_vp);
+        value_type alpha = dg::blas2::dot( m_vp, weights, m_v);
+        dg::blas1::axpby( -alpha, m_v, 1., m_vp);
+        value_type beta = sqrt(dg::blas2::dot( m_vp, weights, m_vp));
+        value_type scale = fabs( m_TH.values(0,1)) + fabs( m_TH.values(0,2));
+        return ( fabs( alpha - m_TH.values(0,1))
+               + fabs( beta  - m_TH.values(0,2))) <= m_reuse_tol*scale;
+    }
+
     /** @brief compute \f$ x = |b|_W V y \f$ from a given tridiagonal matrix T
      * and in-place re-computation of V
      *
@@ -327,6 +478,156 @@ class UniversalLanczos
             set_iter( m_max_iter);
         }
     }
+    /** @brief s-step tridiagonalization with one global reduction per block
+     *
+     * Generates the monomial basis \f$ [v, Av, ..., A^s v, v_{-}, Av_{-},
+     * ..., A^{s-1}v_{-}]\f$ from the two current Lanczos vectors, computes
+     * its Gram matrix with a single global reduction and recovers \c s
+     * Lanczos coefficients per block from the three-term recurrence in
+     * coordinates of the basis; all inner products are evaluated through
+     * the Gram matrix. Only the two last Lanczos vectors are reconstructed
+     * explicitly at the end of each block to start the next one.
+     */
+    template < class MatrixType, class ContainerType1,
+             class ContainerType2, class UnaryOp>
+    void tridiag_sstep(UnaryOp f,
+            MatrixType&& A, const ContainerType1& b,
+            const ContainerType2& weights, value_type eps,
+            value_type nrmb_correction,
+            std::string error_norm = "residual",
+            value_type res_fac = 1.,
+            unsigned q = 1 )
+    {
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+        m_bnorm = sqrt(dg::blas2::dot(b, weights, b));
+        if( m_verbose)
+            DG_RANK0 std::cout << "# Norm of b  "<<m_bnorm <<"\n";
+        if( m_bnorm == 0)
+        {
+            set_iter(1);
+            return;
+        }
+        const unsigned s = m_sstep, nb = 2*s+1;
+        if( m_basis.size() != nb)
+            m_basis.assign( nb, m_v);
+        dg::blas1::axpby( 1./m_bnorm, b, 0., m_v);
+        dg::blas1::copy( 0., m_vm);
+        std::vector<value_type> G( nb*nb), cv(nb), cvm(nb), cA(nb), r(nb);
+        std::vector<const ContainerType*> xs, ys;
+        value_type betaip = 0., residual = 1e10, xnorm = 0.;
+        unsigned iter = 0;
+        set_iter( m_max_iter);
+        bool done = false;
+        while( !done && iter < m_max_iter)
+        {
+            //generate the block basis from the two current Lanczos vectors
+            dg::blas1::copy( m_v, m_basis[0]);
+            for( unsigned j=1; j<=s; j++)
+                dg::blas2::symv( std::forward<MatrixType>(A), m_basis[j-1],
+                        m_basis[j]);
+            dg::blas1::copy( m_vm, m_basis[s+1]);
+            for( unsigned j=1; j<s; j++)
+                dg::blas2::symv( std::forward<MatrixType>(A), m_basis[s+j],
+                        m_basis[s+1+j]);
+            //Gram matrix of the basis with a single global reduction
+            xs.clear(), ys.clear();
+            for( unsigned i=0; i<nb; i++)
+                for( unsigned j=i; j<nb; j++)
+                    xs.push_back( &m_basis[i]), ys.push_back( &m_basis[j]);
+            std::vector<double> dots = detail::multi_dot( xs, weights, ys);
+            for( unsigned i=0, k=0; i<nb; i++)
+                for( unsigned j=i; j<nb; j++, k++)
+                    G[i*nb+j] = G[j*nb+i] = dots[k];
+            //coordinates of v and vm in the basis
+            std::fill( cv.begin(), cv.end(), 0.), cv[0] = 1.;
+            std::fill( cvm.begin(), cvm.end(), 0.), cvm[s+1] = 1.;
+            for( unsigned i=0; i<s; i++)
+            {
+                m_TH.values(iter,0) = betaip; // -1 diagonal
+                //cA = A cv in coordinates (degree shift within the basis)
+                std::fill( cA.begin(), cA.end(), 0.);
+                for( unsigned j=0; j<s; j++)
+                    cA[j+1] += cv[j];
+                for( unsigned j=0; j+1<s; j++)
+                    cA[s+2+j] += cv[s+1+j];
+                value_type alphai = quadratic_form( G, cA, cv);
+                m_TH.values(iter,1) = alphai;
+                for( unsigned j=0; j<nb; j++)
+                    r[j] = cA[j] - alphai*cv[j] - betaip*cvm[j];
+                value_type beta2 = quadratic_form( G, r, r);
+                value_type beta = beta2 > 0 ? sqrt( beta2) : 0.;
+                if (beta == 0)
+                {
+                    if( m_verbose)
+                        DG_RANK0 std::cout << "beta["<<iter+1 <<"]=0 encountered\n";
+                    set_iter(iter+1);
+                    done = true;
+                    break;
+                }
+                m_TH.values(iter,2) = beta;  // +1 diagonal
+                if( "residual" == error_norm)
+                {
+                    residual = compute_residual_error( m_TH, iter)*m_bnorm;
+                    xnorm = m_bnorm;
+                }
+                else
+                {
+                    if( iter>=q &&(  (iter<=10) || (iter>10 && iter%10 == 0) ))
+                    {
+                        residual = compute_universal_error( m_TH, iter, q, f,
+                                m_yH)*m_bnorm;
+                        xnorm = dg::fast_l2norm( m_yH)*m_bnorm;
+                        set_iter( m_max_iter);
+                    }
+                    else
+                    {
+                        residual = 1e10;
+                        xnorm = m_bnorm;
+                    }
+                }
+                if( m_verbose)
+                    DG_RANK0 std::cout << "# ||r||_W = " << residual << "\tat i = " << iter << "\n";
+                if (res_fac*residual< eps*(xnorm + nrmb_correction) )
+                {
+                    set_iter(iter+1);
+                    done = true;
+                    break;
+                }
+                for( unsigned j=0; j<nb; j++)
+                    cvm[j] = cv[j], cv[j] = r[j]/beta;
+                betaip = beta;
+                iter++;
+                if( iter == m_max_iter)
+                    break;
+            }
+            if( !done && iter < m_max_iter)
+            {
+                //reconstruct the two last Lanczos vectors for the next block
+                dg::blas1::copy( 0., m_v), dg::blas1::copy( 0., m_vm);
+                for( unsigned j=0; j<nb; j++)
+                {
+                    if( cv[j] != 0)
+                        dg::blas1::axpby( cv[j], m_basis[j], 1., m_v);
+                    if( cvm[j] != 0)
+                        dg::blas1::axpby( cvm[j], m_basis[j], 1., m_vm);
+                }
+            }
+        }
+    }
+    /// \f$ x^T G y\f$ in the coordinates of the block basis
+    value_type quadratic_form( const std::vector<value_type>& G,
+            const std::vector<value_type>& x, const std::vector<value_type>& y)
+    {
+        unsigned n = x.size();
+        value_type sum = 0.;
+        for( unsigned i=0; i<n; i++)
+            for( unsigned j=0; j<n; j++)
+                sum += x[i]*G[i*n+j]*y[j];
+        return sum;
+    }
     value_type compute_residual_error( const HDiaMatrix& TH, unsigned iter)
     {
         value_type T1 = compute_Tinv_m1( TH, iter+1);
@@ -374,12 +675,14 @@ class UniversalLanczos
         m_TH.diagonal_offsets[2] =  1;
         m_iter = new_iter;
     }
-    ContainerType  m_v, m_vp, m_vm;
+    ContainerType  m_v, m_vp, m_vm, m_b_old;
+    std::vector<ContainerType> m_basis;
     HDiaMatrix m_TH;
     HVec m_yH;
     unsigned m_iter, m_max_iter;
-    bool m_verbose = false;
-    value_type m_bnorm = 0.;
+    bool m_verbose = false, m_cache_valid = false;
+    value_type m_bnorm = 0., m_reuse_tol = 0.;
+    unsigned m_sstep = 1;
 };
 
 
@@ -104,6 +104,22 @@ int main(int argc, char * argv[])
         std::cout << "    time: "<< t.diff()<<"s \n";
         std::cout << "    # Relative error between x=||b||_M V^T T^{-1} e_1 and x: \n";
         std::cout << "    error: " << sqrt(dg::blas2::dot(w2d, error)/dg::blas2::dot(w2d, xexac)) << " \n";
+
+        std::cout << "\nM-Lanczos-Tinv-universal (s-step, s=4):\n";
+        lanczos.set_sstep( 4);
+        b = dg::evaluate( rhs, grid);
+        xexac = dg::evaluate( lhs, grid);
+        t.tic();
+        lanczos.solve( x, dg::mat::make_Linear_Te1( -1), A, b, w2d, eps, 1.,
+                "universal", 1., 1);
+        t.toc();
+        lanczos.set_sstep( 1);
+
+        dg::blas1::axpby(-1.0, xexac, 1.0, x,error);
+        std::cout << "    iter: "<< lanczos.get_iter() << "\n";
+        std::cout << "    time: "<< t.diff()<<"s \n";
+        std::cout << "    # Relative error between x=||b||_M V^T T^{-1} e_1 and x: \n";
+        std::cout << "    error: " << sqrt(dg::blas2::dot(w2d, error)/dg::blas2::dot(w2d, xexac)) << " \n";
     }
     {
         std::cout << "\nM-CG-Tinv: \n";
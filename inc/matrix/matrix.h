@@ -7,6 +7,7 @@
 #include "lanczos.h"
 #include "mcg.h"
 #include "matrixsqrt.h"
+#include "fast_diagonalization.h"
 #include "matrixfunction.h"
 #include "polarization.h"
 #include "polarization_init.h"
@@ -15,3 +16,4 @@
 #include "tensorelliptic.h"
 #include "tridiaginv.h"
 #include "exp_runge_kutta.h"
+#include "exp_ds.h"
@@ -203,5 +203,149 @@ inline static auto make_Linear_Te1( int exp)
 }
 
 ///@}
+
+/**
+ * @brief Apply \f$ x = p(A)\vec b\f$ where \f$ p\f$ is a Chebyshev polynomial
+ * approximation of a given function
+ *
+ * Krylov approximations of \f$ f(A)\vec b\f$ ( \c UniversalLanczos, \c MCG)
+ * need one global scalar product per iteration, which on many nodes can cost
+ * as much as the matrix applications. If estimates of the extreme
+ * Eigenvalues of \f$ A\f$ are known (e.g. from \c compute_extreme_EV of a
+ * previous tridiagonalization), the function can instead be expanded in
+ * Chebyshev polynomials on \f$ [\lambda_{min}, \lambda_{max}]\f$ once and
+ * applied with the Clenshaw recurrence (the Horner scheme of the Chebyshev
+ * basis): \c degree matrix applications and one fused vector update each,
+ * with no reductions at all - the evaluation is communication free except
+ * for the halo exchanges inside \c A.
+ * @code{.cpp}
+ *  dg::mat::UniversalLanczos lanczos( A.weights(), 20);
+ *  auto T = lanczos.tridiag( A, A.weights(), A.weights());
+ *  auto EVs = dg::mat::compute_extreme_EV( T);
+ *  dg::mat::PolynomialFunction<dg::DVec> poly( x, 40);
+ *  poly.set_function( [](double x){ return exp( -x);}, EVs);
+ *  poly( A, b, x); // x = exp( -A) b
+ * @endcode
+ * @note The Chebyshev expansion converges geometrically for functions
+ * analytic in a neighborhood of the spectral interval; increase the degree
+ * until the coefficients decay below the required accuracy
+ * @attention In contrast to the Krylov methods the result is only accurate
+ * if the Eigenvalues of \f$ A\f$ really lie inside the given interval
+ * @ingroup matrixfunctionapproximation
+ * @copydoc hide_ContainerType
+ */
+template<class ContainerType>
+struct PolynomialFunction
+{
+    using value_type = dg::get_value_type<ContainerType>;
+    using container_type = ContainerType;
+    ///@brief Allocate nothing, Call \c construct method before usage
+    PolynomialFunction() = default;
+    /**
+     * @brief Allocate memory for the polynomial application
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param degree polynomial degree; \c operator() uses \c degree
+     * applications of the matrix
+     */
+    PolynomialFunction( const ContainerType& copyable, unsigned degree) :
+        m_b1( copyable), m_b2( copyable), m_ap( copyable), m_c( degree+1, 0.)
+    {
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        *this = PolynomialFunction( std::forward<Params>( ps)...);
+    }
+    ///@brief The degree given in the constructor
+    unsigned degree() const{ return m_c.size()-1;}
+    ///@brief Read access to the current Chebyshev coefficients
+    const std::vector<value_type>& coefficients() const{ return m_c;}
+    /**
+     * @brief Compute the Chebyshev coefficients of \c f on the spectral
+     * interval
+     *
+     * The coefficients are computed by collocation in the Chebyshev points,
+     * i.e. \c degree+1 evaluations of \c f on the host
+     * @param f the function to approximate (e.g. \c dg::SQRT<double> or
+     * \c dg::EXP<double>)
+     * @param EVs {minimum Eigenvalue of A, maximum Eigenvalue of A}
+     */
+    template<class UnaryOp>
+    void set_function( UnaryOp f, std::array<value_type,2> EVs)
+    {
+        m_EVs = EVs;
+        unsigned N = m_c.size();
+        std::vector<value_type> fx( N);
+        for( unsigned j=0; j<N; j++)
+        {
+            value_type theta = M_PI*(j+0.5)/(value_type)N;
+            value_type lambda = 0.5*(EVs[1]-EVs[0])*cos( theta)
+                              + 0.5*(EVs[1]+EVs[0]);
+            fx[j] = f( lambda);
+        }
+        for( unsigned k=0; k<N; k++)
+        {
+            value_type sum = 0;
+            for( unsigned j=0; j<N; j++)
+                sum += fx[j]*cos( M_PI*k*(j+0.5)/(value_type)N);
+            m_c[k] = 2.*sum/(value_type)N;
+        }
+        m_c[0] /= 2.;
+    }
+    /**
+     * @brief Compute \f$ x = p(A) \vec b\f$ with the Clenshaw recurrence
+     *
+     * \c degree applications of \f$ A\f$, each followed by a single fused
+     * vector update; no scalar products
+     * @param A a matrix self-adjoint in some weights; its Eigenvalues must
+     * lie in the interval given to \c set_function
+     * @param b input vector
+     * @param x contains the result on output (may not alias \c b)
+     */
+    template<class MatrixType, class ContainerType0, class ContainerType1>
+    void operator()( MatrixType&& A, const ContainerType0& b,
+            ContainerType1& x)
+    {
+        unsigned n = m_c.size()-1;
+        if( n == 0)
+        {
+            dg::blas1::axpby( m_c[0], b, 0., x);
+            return;
+        }
+        //map A to [-1,1]: tilde A = alpha A - shift
+        value_type alpha = 2./(m_EVs[1]-m_EVs[0]);
+        value_type shift = (m_EVs[1]+m_EVs[0])/(m_EVs[1]-m_EVs[0]);
+        //u_k = c_k b + 2 tilde A u_{k+1} - u_{k+2}
+        dg::blas1::axpby( m_c[n], b, 0., m_b1); //u_n
+        dg::blas1::copy( 0., m_b2); //u_{n+1}
+        for( unsigned k=n-1; k>=1; k--)
+        {
+            dg::blas2::symv( std::forward<MatrixType>(A), m_b1, m_ap);
+            value_type ck = m_c[k];
+            dg::blas1::subroutine( [ck, a2 = 2.*alpha, s2 = 2.*shift]
+                DG_DEVICE ( value_type bi, value_type ap, value_type b1,
+                    value_type& b2)
+                {
+                    b2 = ck*bi + a2*ap - s2*b1 - b2;
+                }, b, m_ap, m_b1, m_b2);
+            std::swap( m_b1, m_b2);
+        }
+        //x = c_0 b + tilde A u_1 - u_2
+        dg::blas2::symv( std::forward<MatrixType>(A), m_b1, m_ap);
+        dg::blas1::subroutine( [c0 = m_c[0], alpha, shift] DG_DEVICE
+            ( value_type bi, value_type ap, value_type b1, value_type b2,
+              value_type& xi)
+            {
+                xi = c0*bi + alpha*ap - shift*b1 - b2;
+            }, b, m_ap, m_b1, m_b2, x);
+    }
+    private:
+    ContainerType m_b1, m_b2, m_ap;
+    std::vector<value_type> m_c;
+    std::array<value_type,2> m_EVs = {0,0};
+};
+
 } //namespace mat
 } //namespace dg
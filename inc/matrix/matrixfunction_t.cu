@@ -0,0 +1,37 @@
+#include <iostream>
+#include <cmath>
+#include <array>
+
+#include "dg/algorithm.h"
+#include "matrixfunction.h"
+
+int main()
+{
+    std::cout << "Test Chebyshev polynomial matrix function applicator\n";
+    // a diagonal matrix makes the exact result available pointwise
+    unsigned size = 100;
+    dg::HVec diag( size), b( size), x( size, 0.);
+    for( unsigned i=0; i<size; i++)
+    {
+        diag[i] = 1. + 9.*i/(size-1.); //Eigenvalues in [1,10]
+        b[i] = sin( (double)i);
+    }
+    std::array<double,2> EVs = {1., 10.};
+    std::cout << "Compute x = A^{-1/2} b\n";
+    for( unsigned degree : {5u, 10u, 20u, 30u})
+    {
+        dg::mat::PolynomialFunction<dg::HVec> poly( x, degree);
+        poly.set_function( [](double lambda){ return 1./sqrt(lambda);}, EVs);
+        poly( diag, b, x);
+        double err = 0., norm = 0.;
+        for( unsigned i=0; i<size; i++)
+        {
+            double sol = b[i]/sqrt( diag[i]);
+            err += (x[i]-sol)*(x[i]-sol);
+            norm += sol*sol;
+        }
+        std::cout << "Degree "<<degree<<" relative error "
+                  <<sqrt(err/norm)<<" (decays geometrically)\n";
+    }
+    return 0;
+}
@@ -78,6 +78,10 @@ struct MatrixSqrt
         m_benchmark = benchmark;
         m_message = message;
     }
+    ///@copydoc UniversalLanczos::set_reuse_tolerance()
+    void set_reuse_tolerance( value_type tol){
+        m_lanczos.set_reuse_tolerance( tol);
+    }
 
     /**
      * @brief Apply matrix sqrt
@@ -190,6 +194,10 @@ struct MatrixFunction
         m_benchmark = benchmark;
         m_message = message;
     }
+    ///@copydoc UniversalLanczos::set_reuse_tolerance()
+    void set_reuse_tolerance( value_type tol){
+        m_lanczos.set_reuse_tolerance( tol);
+    }
 
     /**
      * @brief Apply matrix function
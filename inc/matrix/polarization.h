@@ -204,6 +204,9 @@ class PolCharge
      * This is especially good when \f$ \chi\f$ exhibits large amplitudes or
      *  variations
      * @return the inverse of \f$\chi\f$.
+     * @sa At high density contrast \c dg::mat::FastDiagonalization inverts
+     * the constant coefficient part of the operator exactly and typically
+     * converges in fewer iterations
      */
     const Container& precond()const {
         if (m_mode == "ffO4")
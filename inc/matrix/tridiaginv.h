@@ -573,6 +573,166 @@ class TridiagInvD
     unsigned m_size;
 };
 
+/**
+* @brief Batched inversion and solution of many small tridiagonal matrices in one parallel launch
+*
+* The host classes above invert one matrix at a time, which serializes
+* computations that produce many small tridiagonal matrices at once, e.g. the
+* Lanczos tridiagonal matrices arising across species or planes in
+* \c dg::mat::UniversalLanczos based solves. This class processes one system
+* per parallel index through \c dg::blas2::parallel_for such that all systems
+* are handled in a single kernel launch on GPUs (and in parallel in OpenMP).
+* Within each system the solve runs the same Thomas recursion as
+* \c compute_Tinv_y and the inversion the same recursions as
+* \c TridiagInvDF.
+*
+* All diagonals and vectors are stored system after system, i.e. element
+* \c i of system \c s sits at index <tt> s*size+i</tt>; the inverse of system
+* \c s starts at <tt> s*size*size</tt> in row-major order.
+* @note Since the number of systems provides the parallelism, each system
+* stays small ( Lanczos matrices rarely exceed a few hundred rows) and the
+* recursions are sequential per system, this is faster than cyclic reduction
+* schemes that parallelize within a single system unless there are only very
+* few systems.
+* @attention Unlike the host classes no zero-division checks are performed
+* (device code cannot throw); the result then contains Inf or NaN
+* @tparam ContainerType \c thrust::device_vector<value_type> or any shared memory vector usable in \c dg::blas2::parallel_for
+*/
+template< class ContainerType>
+class TridiagInvBatch
+{
+  public:
+    using value_type = dg::get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    TridiagInvBatch(){}
+    /**
+     * @brief Allocate workspace
+     *
+     * @param num_batch number of tridiagonal systems
+     * @param size size of each (square) system
+     */
+    TridiagInvBatch( unsigned num_batch, unsigned size)
+    {
+        resize( num_batch, size);
+    }
+    ///@copydoc hide_construct
+    template<class ...Params>
+    void construct( Params&& ...ps)
+    {
+        //construct and swap
+        *this = TridiagInvBatch( std::forward<Params>( ps)...);
+    }
+    /**
+     * @brief Resize batch and helper vectors
+     *
+     * @param num_batch new number of tridiagonal systems
+     * @param size new size of each (square) system
+    */
+    void resize( unsigned num_batch, unsigned size)
+    {
+        m_nb = num_batch;
+        m_size = size;
+        m_phi.assign( num_batch*size, 0.);
+        m_theta.assign( num_batch*size, 0.);
+    }
+    /**
+     * @brief Solve \f$ (\alpha T_s + \delta I)\vec x_s = \vec y_s\f$ for all systems \c s
+     *
+     * The diagonal vectors are given as in the cusp dia_matrix format
+     * @param a  "0" diagonal vectors (size <tt> num_batch*size</tt>)
+     * @param b "+1" diagonal vectors (last index of each system outside)
+     * @param c "-1" diagonal vectors (first index of each system outside)
+     * @param x contains the solutions on output (size <tt> num_batch*size</tt>)
+     * @param y the right hand sides
+     * @param alpha optional scaling factor of T
+     * @param delta optional addition to diagonal of T
+     */
+    template<class ContainerType0, class ContainerType1, class ContainerType2,
+        class ContainerType3, class ContainerType4>
+    void operator()(const ContainerType0& a, const ContainerType1& b,
+            const ContainerType2& c, ContainerType3& x,
+            const ContainerType4& y, value_type alpha = 1., value_type delta = 0.)
+    {
+        const unsigned size = m_size;
+        dg::blas2::parallel_for( [size, alpha, delta]DG_DEVICE( unsigned s,
+            const value_type* aa, const value_type* bb, const value_type* cc,
+            value_type* xx, const value_type* yy,
+            value_type* ci, value_type* di)
+            {
+                const unsigned off = s*size;
+                value_type helper = alpha*aa[off] + delta;
+                ci[off] = alpha*bb[off]/helper;
+                di[off] = yy[off]/helper;
+                for( unsigned i=1; i<size; i++)
+                {
+                    helper = alpha*aa[off+i] + delta
+                        - alpha*cc[off+i]*ci[off+i-1];
+                    ci[off+i] = alpha*bb[off+i]/helper;
+                    di[off+i] = (yy[off+i]-alpha*cc[off+i]*di[off+i-1])/helper;
+                }
+                xx[off+size-1] = di[off+size-1];
+                for( int i=size-2; i>=0; i--)
+                    xx[off+i] = di[off+i] - ci[off+i]*xx[off+i+1];
+            }, m_nb, a, b, c, x, y, m_phi, m_theta);
+    }
+    /**
+     * @brief Compute the inverses of all tridiagonal systems
+     *
+     * The diagonal vectors are given as in the cusp dia_matrix format
+     * @param a  "0" diagonal vectors (size <tt> num_batch*size</tt>)
+     * @param b "+1" diagonal vectors (last index of each system outside)
+     * @param c "-1" diagonal vectors (first index of each system outside)
+     * @param Tinv contains the dense inverses on output (size
+     * <tt> num_batch*size*size</tt>, row-major per system), must be
+     * allocated by the caller
+     */
+    template<class ContainerType0, class ContainerType1, class ContainerType2,
+        class ContainerType3>
+    void invert(const ContainerType0& a, const ContainerType1& b,
+            const ContainerType2& c, ContainerType3& Tinv)
+    {
+        const unsigned size = m_size;
+        dg::blas2::parallel_for( [size]DG_DEVICE( unsigned s,
+            const value_type* aa, const value_type* bb, const value_type* cc,
+            value_type* vv, value_type* phi, value_type* theta)
+            {
+                const unsigned off = s*size, voff = s*size*size;
+                //fill phi and theta values as in TridiagInvDF
+                phi[off] = - bb[off]/aa[off];
+                for( unsigned i=1; i<size; i++)
+                    phi[off+i] = -bb[off+i]/(phi[off+i-1]*cc[off+i] + aa[off+i]);
+                theta[off+size-1] = size == 1 ? 0.
+                    : - cc[off+size-1]/aa[off+size-1];
+                for( int i=size-2; i>=0; i--)
+                    theta[off+i] = -cc[off+i]/(theta[off+i+1]*bb[off+i]
+                            + aa[off+i]);
+                //Diagonal entries
+                vv[voff] = 1./( size == 1 ? aa[off]
+                        : aa[off] + bb[off]*theta[off+1]);
+                for( unsigned i=1; i<size; i++)
+                {
+                    value_type helper = aa[off+i] + cc[off+i]*phi[off+i-1];
+                    if( i < size-1)
+                        helper += bb[off+i]*theta[off+i+1];
+                    vv[voff+i*size+i] = 1./helper;
+                }
+                //Off-diagonal entries
+                for( unsigned j=0; j<size; j++) //column index
+                {
+                    for( unsigned i=j+1; i<size; i++)
+                        vv[voff+i*size+j] =
+                            theta[off+i]*vv[voff+(i-1)*size+j];
+                    for( int i=(int)j-1; i>=0; i--)
+                        vv[voff+i*size+j] =
+                            phi[off+i]*vv[voff+(i+1)*size+j];
+                }
+            }, m_nb, a, b, c, Tinv, m_phi, m_theta);
+    }
+  private:
+    ContainerType m_phi, m_theta;
+    unsigned m_nb, m_size;
+};
+
 /**
  * @brief Invert a tridiagonal matrix
  *
@@ -205,6 +205,39 @@ int main()
     //std::cout << "    # result "<<T1mana<<" "<<T1m<<"\n";
     std::cout <<  "    # error_rel: " << sqrt(dg::blas1::dot(err,err)/dg::blas1::dot(x_symsol,x_symsol)) << "\n";
 
+    std::cout << "# Test batched inversion\n";
+    unsigned nb = 4;
+    Container a_batch( nb*size), b_batch( nb*size), c_batch( nb*size);
+    Container d_batch( nb*size, 1.), x_batch( nb*size, 0.);
+    Container Tinv_batch( nb*size*size, 0.);
+    for( unsigned s=0; s<nb; s++)
+        for( unsigned i=0; i<size; i++)
+        {
+            a_batch[s*size+i] = a_sym[i];
+            b_batch[s*size+i] = b_sym[i];
+            c_batch[s*size+i] = c_sym[i];
+        }
+    dg::mat::TridiagInvBatch<Container> tridiaginvBatch( nb, size);
+    t.tic();
+    tridiaginvBatch( a_batch, b_batch, c_batch, x_batch, d_batch);
+    t.toc();
+    for( unsigned i=0; i<size; i++)
+        err[i] = x_batch[(nb-1)*size+i] - x_symsol[i];
+    std::cout <<  "    # time: "<< t.diff()<<"s \n";
+    std::cout <<  "    # error_rel: " << sqrt(dg::blas1::dot(err,err)/dg::blas1::dot(x_symsol,x_symsol)) << "\n";
+    t.tic();
+    tridiaginvBatch.invert( a_batch, b_batch, c_batch, Tinv_batch);
+    t.toc();
+    for( unsigned i=0; i<size; i++)
+    {
+        y[i] = 0.;
+        for( unsigned j=0; j<size; j++)
+            y[i] += Tinv_batch[(nb-1)*size*size+i*size+j];
+        err[i] = y[i] - x_symsol[i];
+    }
+    std::cout <<  "    # time: "<< t.diff()<<"s \n";
+    std::cout <<  "    # error_rel: " << sqrt(dg::blas1::dot(err,err)/dg::blas1::dot(x_symsol,x_symsol)) << "\n";
+
 
 
     std::cout << "\n####Compute inverse of non-symmetric tridiagonal matrix\n";
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dg/file/nc_utilities.h"
+
+namespace feltor
+{//We use the typedefs and DG_RANK0
+
+namespace detail
+{
+
+#ifdef WITH_MPI
+inline const dg::HVec& checkpoint_flat( const dg::x::HVec& v){ return v.data();}
+inline dg::HVec& checkpoint_flat( dg::x::HVec& v){ return v.data();}
+#else
+inline const dg::HVec& checkpoint_flat( const dg::x::HVec& v){ return v;}
+inline dg::HVec& checkpoint_flat( dg::x::HVec& v){ return v;}
+#endif
+
+//FNV-1a over the local bytes; the per rank hashes are summed mod 2^64 so the
+//result is independent of the process layout
+inline uint64_t checkpoint_checksum( const dg::x::HVec& v)
+{
+    const dg::HVec& flat = checkpoint_flat( v);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const unsigned char* bytes =
+        reinterpret_cast<const unsigned char*>( flat.data());
+    for( size_t i=0; i<flat.size()*sizeof(double); i++)
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+#ifdef WITH_MPI
+    uint64_t global = 0;
+    MPI_Allreduce( &hash, &global, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM,
+        MPI_COMM_WORLD);
+    hash = global;
+#endif //WITH_MPI
+    return hash;
+}
+
+//elementwise XOR of the bit patterns: z_i = bits(x_i) ^ bits(y_i)
+//(exactly invertible and all zero where x and y agree; aliasing z==x is fine)
+inline void checkpoint_xor( const dg::x::HVec& x, const dg::x::HVec& y,
+    dg::x::HVec& z)
+{
+    const dg::HVec& xx = checkpoint_flat( x), &yy = checkpoint_flat( y);
+    dg::HVec& zz = checkpoint_flat( z);
+    for( size_t i=0; i<xx.size(); i++)
+    {
+        uint64_t bx, by;
+        std::memcpy( &bx, &xx[i], sizeof(double));
+        std::memcpy( &by, &yy[i], sizeof(double));
+        bx ^= by;
+        std::memcpy( &zz[i], &bx, sizeof(double));
+    }
+}
+
+//everyone reads their portion (the file must be written on the same grid)
+inline void checkpoint_get_var( int ncid, int varid,
+    const dg::x::CylindricalGrid3d& grid, dg::x::HVec& data)
+{
+    dg::file::NC_Error_Handle err;
+#ifdef WITH_MPI
+    int dims[3], coords[3];
+    int periods[3] = {false, false, true}; //non-, non-, periodic
+    MPI_Cart_get( grid.communicator(), 3, dims, periods, coords);
+    size_t count[3] = {grid.local().Nz(), grid.n()*grid.local().Ny(),
+        grid.n()*grid.local().Nx()};
+    size_t start[3] = {coords[2]*count[0], coords[1]*count[1],
+        coords[0]*count[2]};
+    err = nc_get_vara_double( ncid, varid, start, count, data.data().data());
+#else //WITH_MPI
+    size_t start[3] = {0, 0, 0};
+    size_t count[3] = {grid.Nz(), grid.n()*grid.Ny(), grid.n()*grid.Nx()};
+    err = nc_get_vara_double( ncid, varid, start, count, data.data());
+#endif //WITH_MPI
+}
+
+//read raw slot content (delta slots are NOT reconstructed or verified here)
+//returns false if the file is missing, truncated or from a different grid
+inline bool read_checkpoint_slot( std::string file_name,
+    const dg::x::CylindricalGrid3d& grid, const std::vector<std::string>& names,
+    std::vector<dg::x::HVec>& data, std::vector<unsigned long long>& checksums,
+    double& time, int& index, bool& delta)
+{
+    int ncid;
+    if( nc_open( file_name.data(), NC_NOWRITE, &ncid) != NC_NOERR)
+        return false;
+    dg::file::NC_Error_Handle err;
+    try
+    {
+        err = nc_get_att_int( ncid, NC_GLOBAL, "checkpoint_index", &index);
+        int idelta = 0;
+        err = nc_get_att_int( ncid, NC_GLOBAL, "checkpoint_delta", &idelta);
+        delta = idelta;
+        err = nc_get_att_double( ncid, NC_GLOBAL, "time", &time);
+        for( unsigned u=0; u<names.size(); u++)
+        {
+            int varid;
+            err = nc_inq_varid( ncid, names[u].data(), &varid);
+            err = nc_get_att_ulonglong( ncid, varid, "checksum",
+                &checksums[u]);
+            checkpoint_get_var( ncid, varid, grid, data[u]);
+        }
+    }
+    catch( std::exception& e)
+    {
+        nc_close( ncid);
+        return false;
+    }
+    err = nc_close( ncid);
+    return true;
+}
+
+}//namespace detail
+
+/**
+ * @brief Fast restart checkpoints: double buffered, checksummed, optionally
+ * incremental
+ *
+ * For queue jobs with a hard wall-clock limit the restart fields must be
+ * written far more often than the diagnostics, and a crash (or the queue
+ * killing the job) in the middle of a write must never destroy the last
+ * usable restart point. This class therefore writes only the fields needed
+ * for exact restart (plus the time) and alternates between the two files
+ * <base>.0.nc and <base>.1.nc, so that at any moment at least one of them
+ * holds a complete checkpoint. Every field carries a checksum attribute of
+ * its physical values; a reader that finds a mismatch (e.g. because the
+ * write was interrupted) falls back to the other file.
+ *
+ * In delta mode every second checkpoint stores, instead of the field itself,
+ * the bitwise XOR of the field with the previous (full) checkpoint that
+ * still resides in the other file. The XOR is exactly invertible, so the
+ * restart remains bit-exact, and since most leading mantissa bits agree
+ * between consecutive checkpoints the delta consists mostly of zero bytes
+ * and writes considerably faster on compressing file systems (or with
+ * \c def_var_deflate).
+ *
+ * @attention A checkpoint can only be read back on exactly the grid it was
+ * written on; restarts on a different resolution must go through the restart
+ * fields in the regular output file
+ */
+struct Checkpointer
+{
+    /**
+     * @param base_name checkpoints alternate between the files
+     * <base_name>.0.nc and <base_name>.1.nc
+     * @param grid the (full, unprojected) simulation grid
+     * @param names the names of the fields handed to \c write (in order)
+     * @param inputfile written as global attribute (documentation only)
+     * @param delta if true every second checkpoint is written as bitwise
+     * delta against the previous one
+     */
+    Checkpointer( std::string base_name,
+        const dg::x::CylindricalGrid3d& grid, std::vector<std::string> names,
+        std::string inputfile, bool delta = false)
+      : m_base( base_name), m_grid( grid), m_names( names),
+        m_inputfile( inputfile), m_delta( delta)
+    {
+        if( delta)
+        {
+            m_prev.assign( names.size(), dg::evaluate( dg::zero, grid));
+            m_buffer = dg::evaluate( dg::zero, grid);
+        }
+    }
+    /**
+     * @brief Write the next checkpoint (alternating between the two files)
+     *
+     * @param time the current simulation time
+     * @param fields the restart fields in the order of the names given in
+     * the constructor; must live on the constructor grid
+     */
+    void write( double time, const std::vector<dg::x::HVec>& fields)
+    {
+        dg::file::NC_Error_Handle err;
+        unsigned slot = m_counter % 2;
+        //a delta only ever refers to the full checkpoint in the other slot
+        bool delta = m_delta && (m_counter % 2 == 1);
+        std::string file_name = m_base + "." + std::to_string( slot) + ".nc";
+        int ncid = 0;
+        DG_RANK0 err = nc_create( file_name.data(), NC_NETCDF4|NC_CLOBBER,
+            &ncid);
+        DG_RANK0 err = nc_put_att_text( ncid, NC_GLOBAL, "inputfile",
+            m_inputfile.size(), m_inputfile.data());
+        int index = (int)m_counter;
+        DG_RANK0 err = nc_put_att_int( ncid, NC_GLOBAL, "checkpoint_index",
+            NC_INT, 1, &index);
+        int idelta = delta;
+        DG_RANK0 err = nc_put_att_int( ncid, NC_GLOBAL, "checkpoint_delta",
+            NC_INT, 1, &idelta);
+        DG_RANK0 err = nc_put_att_double( ncid, NC_GLOBAL, "time", NC_DOUBLE,
+            1, &time);
+        int dim_ids[3];
+        DG_RANK0 err = dg::file::define_dimensions( ncid, dim_ids, m_grid,
+            {"zr", "yr", "xr"});
+        std::vector<int> varids( m_names.size(), 0);
+        for( unsigned u=0; u<m_names.size(); u++)
+        {
+            DG_RANK0 err = nc_def_var( ncid, m_names[u].data(), NC_DOUBLE, 3,
+                dim_ids, &varids[u]);
+            //always checksum the physical field so that a reader verifies
+            //the reconstruction, not the stored representation
+            unsigned long long checksum =
+                detail::checkpoint_checksum( fields[u]);
+            DG_RANK0 err = nc_put_att_ulonglong( ncid, varids[u], "checksum",
+                NC_UINT64, 1, &checksum);
+        }
+        for( unsigned u=0; u<m_names.size(); u++)
+        {
+            if( delta)
+            {
+                detail::checkpoint_xor( fields[u], m_prev[u], m_buffer);
+                dg::file::put_var_double( ncid, varids[u], m_grid, m_buffer);
+            }
+            else
+                dg::file::put_var_double( ncid, varids[u], m_grid, fields[u]);
+        }
+        DG_RANK0 err = nc_close( ncid);
+        if( m_delta && !delta)
+            m_prev = fields; //the next write is a delta against this state
+        m_counter++;
+    }
+    ///Number of checkpoints written so far
+    unsigned get_counter() const { return m_counter;}
+    private:
+    std::string m_base;
+    dg::x::CylindricalGrid3d m_grid;
+    std::vector<std::string> m_names;
+    std::string m_inputfile;
+    bool m_delta;
+    unsigned m_counter = 0;
+    std::vector<dg::x::HVec> m_prev;
+    dg::x::HVec m_buffer;
+};
+
+/**
+ * @brief Read back the newest valid checkpoint written by \c Checkpointer
+ *
+ * Both slot files are inspected; full checkpoints are verified against their
+ * checksums, delta checkpoints are first reconstructed from the full
+ * checkpoint in the other slot and then verified. Among the valid slots the
+ * one with the highest checkpoint index wins, so an interrupted or corrupted
+ * write automatically falls back to the previous checkpoint.
+ *
+ * @param base_name the base name given to \c Checkpointer
+ * @param grid must equal the grid the checkpoint was written on
+ * @param names the field names to read (in order)
+ * @param fields (write-only) contains the restart fields on output
+ * @param time (write-only) the simulation time of the checkpoint
+ * @return false if neither slot holds a valid checkpoint
+ */
+inline bool read_checkpoint( std::string base_name,
+    const dg::x::CylindricalGrid3d& grid, const std::vector<std::string>& names,
+    std::vector<dg::x::HVec>& fields, double& time)
+{
+    std::array<std::vector<dg::x::HVec>,2> data;
+    std::array<std::vector<unsigned long long>,2> sums;
+    double slot_time[2] = {0.,0.};
+    int slot_index[2] = {-1,-1};
+    bool slot_delta[2] = {false,false}, slot_ok[2] = {false,false};
+    for( unsigned slot=0; slot<2; slot++)
+    {
+        data[slot].assign( names.size(), dg::evaluate( dg::zero, grid));
+        sums[slot].assign( names.size(), 0);
+        slot_ok[slot] = detail::read_checkpoint_slot(
+            base_name + "." + std::to_string( slot) + ".nc", grid, names,
+            data[slot], sums[slot], slot_time[slot], slot_index[slot],
+            slot_delta[slot]);
+    }
+    //full slots verify directly
+    for( unsigned slot=0; slot<2; slot++)
+        if( slot_ok[slot] && !slot_delta[slot])
+            for( unsigned u=0; u<names.size(); u++)
+                if( detail::checkpoint_checksum( data[slot][u]) != sums[slot][u])
+                    slot_ok[slot] = false;
+    //a delta slot reconstructs from the full checkpoint in the other slot
+    for( unsigned slot=0; slot<2; slot++)
+        if( slot_ok[slot] && slot_delta[slot])
+        {
+            unsigned other = 1-slot;
+            if( !slot_ok[other] || slot_delta[other])
+                slot_ok[slot] = false;
+            else
+                for( unsigned u=0; u<names.size(); u++)
+                {
+                    detail::checkpoint_xor( data[slot][u], data[other][u],
+                        data[slot][u]);
+                    if( detail::checkpoint_checksum( data[slot][u])
+                            != sums[slot][u])
+                        slot_ok[slot] = false;
+                }
+        }
+    //the newest valid slot wins
+    int best = -1;
+    for( int slot=0; slot<2; slot++)
+        if( slot_ok[slot] && ( best < 0 || slot_index[slot] > slot_index[best]))
+            best = slot;
+    if( best < 0)
+        return false;
+    fields = data[best];
+    time = slot_time[best];
+    return true;
+}
+
+}//namespace feltor
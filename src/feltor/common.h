@@ -1,9 +1,56 @@
 #pragma once
 
+#include <array>
+#include <map>
+#include <string>
+
 #include "dg/algorithm.h"
 
 namespace feltor
 {
+
+//The real type of all simulation fields. Compile with -DWITH_FLOAT to run
+//the simulation stack in single precision: containers and derivative and
+//interpolation matrices halve their memory and roughly double their
+//throughput on memory bound kernels, while all dot products and reductions
+//keep their exactness because exblas accumulates exdot in 64-bit
+//superaccumulators independent of the input type. The geometry, the input
+//parameters and the initial field generation remain in double precision and
+//convert on assignment.
+#ifdef WITH_FLOAT
+using Real = float;
+#else
+using Real = double;
+#endif
+//The simulation-wide vector and matrix types: like the dg::x namespace
+//resolves the shared-memory/MPI distinction, this resolves the precision
+namespace x
+{
+#ifdef WITH_FLOAT
+using DVec = dg::x::fDVec;
+using HVec = dg::x::fHVec;
+using DMatrix = dg::x::fDMatrix;
+using HMatrix = dg::x::fHMatrix;
+#ifdef WITH_MPI
+using IDMatrix = dg::MIDMatrix_t<float>;
+using IHMatrix = dg::MIHMatrix_t<float>;
+using IEllMatrix = dg::MIEllMatrix_t<float>;
+#else
+using IDMatrix = dg::IDMatrix_t<float>;
+using IHMatrix = dg::IHMatrix_t<float>;
+using IEllMatrix = dg::IEllMatrix_t<float>;
+#endif
+#else
+using DVec = dg::x::DVec;
+using HVec = dg::x::HVec;
+using DMatrix = dg::x::DMatrix;
+using HMatrix = dg::x::HMatrix;
+using IDMatrix = dg::x::IDMatrix;
+using IHMatrix = dg::x::IHMatrix;
+using IEllMatrix = dg::x::IEllMatrix;
+#endif
+}//namespace x
+
 namespace routines{
 
 
@@ -108,8 +155,237 @@ void jacobian(
     dg::blas1::evaluate( result, dg::Axpby<double>(alpha,beta), Jacobian(),
         a[0], a[1], a[2], b[0], b[1], b[2], c[0], c[1], c[2]);
 }
+
+// 1/B and its logarithmic derivatives bR = dB/dR, bZ = dB/dZ from the
+// primitive flux functions; cf. dg::geo::InvB, BR and BZ which compute the
+// same point-wise
+struct BFields{
+    BFields( double R0): m_R0(R0){}
+    DG_DEVICE void operator()( double R, double psipR, double psipZ,
+        double psipRR, double psipRZ, double psipZZ,
+        double ipol, double ipolR, double ipolZ,
+        double& invB, double& bR, double& bZ) const
+    {
+        invB = R/(m_R0*sqrt(ipol*ipol + psipR*psipR + psipZ*psipZ));
+        double Rn = R/m_R0;
+        bR = -1./R/invB + invB/Rn/Rn*(ipol*ipolR + psipR*psipRR + psipZ*psipRZ);
+        bZ = invB/Rn/Rn*(ipol*ipolZ + psipR*psipRZ + psipZ*psipZZ);
+    }
+    private:
+    double m_R0;
+};
+// divb = -GradLnB; cf. dg::geo::Divb
+struct DivbFromB{
+    DivbFromB( double R0): m_R0(R0){}
+    DG_DEVICE void operator()( double R, double psipR, double psipZ,
+        double invB, double bR, double bZ, double& divb) const
+    {
+        divb = -m_R0*invB*invB*(bR*psipZ - bZ*psipR)/R;
+    }
+    private:
+    double m_R0;
+};
+// the cylindrical components of the true curvature fields and the
+// divergence of the kappa curvature; cf. dg::geo::TrueCurvatureNablaBR et al.
+struct TrueCurvature{
+    TrueCurvature( double R0): m_R0(R0){}
+    DG_DEVICE void operator()( double R, double psipR, double psipZ,
+        double psipRR, double psipZZ,
+        double ipol, double ipolR, double ipolZ,
+        double invB, double bR, double bZ,
+        double& nablaR, double& nablaZ, double& nablaP,
+        double& kappaR, double& kappaZ, double& kappaP,
+        double& divKappa) const
+    {
+        double invB2 = invB*invB;
+        nablaR = -invB2*invB*ipol*m_R0/R*bZ;
+        nablaZ =  invB2*invB*ipol*m_R0/R*bR;
+        nablaP = m_R0*invB2*invB/R/R*( psipZ*bZ + psipR*bR);
+        kappaR = m_R0*invB2/R*( ipolZ - ipol*invB*bZ);
+        kappaZ = m_R0*invB2/R*(-ipolR + ipol*invB*bR);
+        kappaP = m_R0*invB2/R/R*( invB*psipZ*bZ + invB*psipR*bR
+                 + psipR/R - psipRR - psipZZ);
+        divKappa = m_R0*invB2*invB/R*( ipolR*bZ - ipolZ*bR);
+    }
+    private:
+    double m_R0;
+};
+// the toroidal field line approximation of the curvature fields; the R
+// component of kappa and both Phi components vanish;
+// cf. dg::geo::CurvatureNablaBR et al.
+struct ToroidalCurvature{
+    ToroidalCurvature( int sign): m_sign(sign){}
+    DG_DEVICE void operator()( double R, double invB, double bR, double bZ,
+        double& nablaR, double& nablaZ, double& kappaZ, double& divKappa) const
+    {
+        nablaR = -m_sign*invB*invB*bZ;
+        nablaZ =  m_sign*invB*invB*bR;
+        kappaZ = -m_sign*invB/R;
+        divKappa = m_sign*bZ*invB*invB/R;
+    }
+    private:
+    double m_sign;
+};
 }//namespace routines
 
+// A per-grid cache of the magnetic geometry fields entering the feltor
+// equations. The derived functors in inc/geometries/magnetic_field.h
+// re-evaluate the primitive flux functions (psip and its derivatives, ipol
+// and its derivatives) in every nested sub-functor, which makes a naive
+// pullback of all curvature components evaluate each primitive 30+ times per
+// grid point. Here each primitive is pulled back exactly once and the
+// derived fields are composed from the cached evaluations with the fused
+// routines above. Cached fields are keyed by name because the type-erased
+// CylindricalFunctor offers no functor identity to hash on.
+template<class Geometry>
+struct MagneticFieldCache
+{
+    using host_vector = dg::get_host_vector<Geometry>;
+    MagneticFieldCache( const Geometry& g,
+        const dg::geo::TokamakMagneticField& mag) : m_R0( mag.R0())
+    {
+        // each primitive flux function is evaluated exactly once on the grid
+        m_fields["R"]      = g.map()[0];
+        m_fields["psip"]   = dg::pullback( mag.psip(),   g);
+        m_fields["psipR"]  = dg::pullback( mag.psipR(),  g);
+        m_fields["psipZ"]  = dg::pullback( mag.psipZ(),  g);
+        m_fields["psipRR"] = dg::pullback( mag.psipRR(), g);
+        m_fields["psipRZ"] = dg::pullback( mag.psipRZ(), g);
+        m_fields["psipZZ"] = dg::pullback( mag.psipZZ(), g);
+        m_fields["ipol"]   = dg::pullback( mag.ipol(),   g);
+        m_fields["ipolR"]  = dg::pullback( mag.ipolR(),  g);
+        m_fields["ipolZ"]  = dg::pullback( mag.ipolZ(),  g);
+        // the field modulus gradient is shared by all curvature fields
+        host_vector invB( get("R")), bR( invB), bZ( invB), divb( invB);
+        dg::blas1::subroutine( routines::BFields( m_R0), get("R"),
+            get("psipR"), get("psipZ"), get("psipRR"), get("psipRZ"),
+            get("psipZZ"), get("ipol"), get("ipolR"), get("ipolZ"),
+            invB, bR, bZ);
+        dg::blas1::subroutine( routines::DivbFromB( m_R0), get("R"),
+            get("psipR"), get("psipZ"), invB, bR, bZ, divb);
+        m_fields["invB"] = invB;
+        m_fields["bR"]   = bR;
+        m_fields["bZ"]   = bZ;
+        m_fields["divb"] = divb;
+    }
+    // Access a cached field by name
+    const host_vector& get( const std::string& name) const
+    {
+        auto it = m_fields.find( name);
+        if( it == m_fields.end())
+            throw dg::Error( dg::Message(_ping_) << "Field '"<<name
+                <<"' not in magnetic field cache!");
+        return it->second;
+    }
+    // Memoized pullback: f is only evaluated if name is not yet cached
+    template<class Functor>
+    const host_vector& pullback( const std::string& name, const Functor& f,
+        const Geometry& g)
+    {
+        auto it = m_fields.find( name);
+        if( it == m_fields.end())
+            it = m_fields.emplace( name, dg::pullback( f, g)).first;
+        return it->second;
+    }
+    const host_vector& invB() const { return get("invB");}
+    const host_vector& divb() const { return get("divb");}
+    // cylindrical components of the curvature fields (before push forward)
+    const std::array<host_vector,3>& trueCurvatureNablaB()
+    {
+        compute_true();
+        return m_trueNablaB;
+    }
+    const std::array<host_vector,3>& trueCurvatureKappa()
+    {
+        compute_true();
+        return m_trueKappa;
+    }
+    const host_vector& trueDivCurvatureKappa()
+    {
+        compute_true();
+        return m_trueDivKappa;
+    }
+    const std::array<host_vector,3>& curvatureNablaB( int sign)
+    {
+        compute_toroidal( sign);
+        return m_toroNablaB;
+    }
+    const std::array<host_vector,3>& curvatureKappa( int sign)
+    {
+        compute_toroidal( sign);
+        return m_toroKappa;
+    }
+    const host_vector& divCurvatureKappa( int sign)
+    {
+        compute_toroidal( sign);
+        return m_toroDivKappa;
+    }
+    private:
+    void compute_true()
+    {
+        if( m_true_done)
+            return;
+        for( auto a : {&m_trueNablaB, &m_trueKappa})
+            for( unsigned i=0; i<3; i++)
+                (*a)[i] = get("R");
+        m_trueDivKappa = get("R");
+        dg::blas1::subroutine( routines::TrueCurvature( m_R0), get("R"),
+            get("psipR"), get("psipZ"), get("psipRR"), get("psipZZ"),
+            get("ipol"), get("ipolR"), get("ipolZ"),
+            get("invB"), get("bR"), get("bZ"),
+            m_trueNablaB[0], m_trueNablaB[1], m_trueNablaB[2],
+            m_trueKappa[0], m_trueKappa[1], m_trueKappa[2], m_trueDivKappa);
+        m_true_done = true;
+    }
+    void compute_toroidal( int sign)
+    {
+        if( m_toroidal_sign == sign)
+            return;
+        for( auto a : {&m_toroNablaB, &m_toroKappa})
+            for( unsigned i=0; i<3; i++)
+            {
+                (*a)[i] = get("R");
+                dg::blas1::copy( 0., (*a)[i]);
+            }
+        m_toroDivKappa = get("R");
+        dg::blas1::subroutine( routines::ToroidalCurvature( sign), get("R"),
+            get("invB"), get("bR"), get("bZ"),
+            m_toroNablaB[0], m_toroNablaB[1], m_toroKappa[1], m_toroDivKappa);
+        m_toroidal_sign = sign;
+    }
+    double m_R0;
+    std::map<std::string, host_vector> m_fields;
+    std::array<host_vector,3> m_trueNablaB, m_trueKappa, m_toroNablaB,
+        m_toroKappa;
+    host_vector m_trueDivKappa, m_toroDivKappa;
+    bool m_true_done = false;
+    int m_toroidal_sign = 0;
+};
+
+// Execute a per-species functor for both species, concurrently if possible:
+// the electron and ion chains of the right hand side are independent until
+// the field solves couple them, so in shared memory builds with OpenMP
+// enabled on the host f(0) and f(1) are executed by two host threads. With
+// the serial device backend each species then runs on its own core; with the
+// CUDA backend each thread submits to its own stream when compiled with
+// --default-stream per-thread (cf. dg::GraphCache) such that the kernels of
+// both species overlap on the device. In MPI builds the species are
+// processed sequentially because the derivative chains exchange halos and
+// dg::mpi_init does not request MPI_THREAD_MULTIPLE. The two calls must not
+// write to common workspace.
+template<class Functor>
+void for_each_species( Functor&& f)
+{
+#if defined(_OPENMP) && !defined(WITH_MPI) && THRUST_DEVICE_SYSTEM!=THRUST_DEVICE_SYSTEM_OMP
+    #pragma omp parallel for num_threads(2)
+    for( int i=0; i<2; i++)
+        f(i);
+#else
+    for( int i=0; i<2; i++)
+        f(i);
+#endif
+}
+
 // take first 2d plane out of a 3d vector
 template<class Container>
 void slice_vector3d( const Container& transfer, Container& transfer2d, size_t local_size2d)
@@ -129,6 +405,92 @@ void slice_vector3d( const Container& transfer, Container& transfer2d, size_t lo
 #endif
 }
 
+// Device-side staging area for diagnostic outputs: pack many equally sized
+// (2d) device fields contiguously and transfer all of them to the host in one
+// single copy instead of one PCIe transfer per field
+struct DeviceStager
+{
+    DeviceStager() = default;
+    DeviceStager( size_t slot_size, unsigned num_slots)
+      : m_device( slot_size*num_slots, 0.), m_host( slot_size*num_slots, 0.),
+        m_slot( slot_size), m_capacity( num_slots) {}
+    // append the (local) data of src as the next slot
+    template<class Container>
+    void stage( const Container& src)
+    {
+        assert( m_count < m_capacity);
+#ifdef WITH_MPI
+        thrust::copy( src.data().begin(), src.data().end(),
+            m_device.begin() + m_count*m_slot);
+#else
+        thrust::copy( src.begin(), src.end(),
+            m_device.begin() + m_count*m_slot);
+#endif
+        m_count++;
+    }
+    // one device to host transfer of all staged slots
+    void transfer()
+    {
+        thrust::copy( m_device.begin(), m_device.begin() + m_count*m_slot,
+            m_host.begin());
+    }
+    // copy a transferred slot into the (local) data of dst
+    template<class Container>
+    void unstage( unsigned slot, Container& dst) const
+    {
+#ifdef WITH_MPI
+        thrust::copy( m_host.begin() + slot*m_slot,
+            m_host.begin() + (slot+1)*m_slot, dst.data().begin());
+#else
+        thrust::copy( m_host.begin() + slot*m_slot,
+            m_host.begin() + (slot+1)*m_slot, dst.begin());
+#endif
+    }
+    // forget all staged slots (does not deallocate)
+    void reset(){ m_count = 0;}
+    private:
+    dg::DVec m_device;
+    dg::HVec m_host;
+    size_t m_slot = 0;
+    unsigned m_count = 0, m_capacity = 0;
+};
+
+// Cost-aware scheduler for the expensive per-step (2d) diagnostics: in
+// turbulent bursts the solver iterations make the steps slower while the
+// diagnostics cost stays the same, so a fixed cadence spends an ever larger
+// fraction of the runtime on diagnostics. The scheduler tracks the
+// wall-clock cost of the steps and of the diagnostics (via dg::Timer in the
+// time loop) and admits a new expensive record only while the diagnostics
+// share of the total runtime stays below the given fraction. Cheap records
+// (0d probes) are not scheduled and remain at every step. A fraction >= 1
+// reproduces the fixed cadence.
+struct DiagnosticsScheduler
+{
+    DiagnosticsScheduler( double fraction = 1.): m_fraction( fraction) {}
+    // record the wall-clock cost of the last timestep
+    void step_cost( double seconds){ m_t_step += seconds;}
+    // record the wall-clock cost of the last expensive diagnostics
+    void diag_cost( double seconds)
+    {
+        m_t_diag += seconds;
+        // exponential moving average as the estimate for the next record
+        m_estimate = m_estimate == 0. ? seconds
+                   : 0.9*m_estimate + 0.1*seconds;
+    }
+    // true if another expensive record keeps the diagnostics share of the
+    // runtime below the fraction (the first record is always admitted)
+    bool due() const
+    {
+        if( m_fraction >= 1. || m_estimate == 0.)
+            return true;
+        double diag = m_t_diag + m_estimate;
+        return diag <= m_fraction*( m_t_step + diag);
+    }
+    private:
+    double m_fraction = 1.;
+    double m_t_step = 0., m_t_diag = 0., m_estimate = 0.;
+};
+
 // generate a Curvilinear flux aligned grid
 // config contains configuration parameters from input file
 // mag is the magnetic field
@@ -119,24 +119,20 @@ int main( int argc, char* argv[])
     dg::blas1::pointwiseDot( vol3d, multi_chi[STAGE], vol3d);
     IHMatrix chi_diag = dg::create::diagonal( vol3d);
     IHMatrix inv_vol = dg::create::diagonal( inv_vol3d);
-    IHMatrix CX, XX, CY, YY, JJ, result;
+    IHMatrix CX, XX, YY, JJ, result;
 
-    std::cout << "Multiply 1. matrices\n";
-    cusp::multiply( chi_diag, rightx, CX);
-    std::cout << "Multiply 2. matrices\n";
-    cusp::multiply( leftx, CX, XX );
-    std::cout << "Multiply 3. matrices\n";
-    cusp::multiply( chi_diag, righty, CY);
-    std::cout << "Multiply 4. matrices\n";
-    cusp::multiply( lefty, CY, YY );
+    std::cout << "Compose x matrices\n";
+    XX = dg::create::compose( leftx, chi_diag, rightx);
+    std::cout << "Compose y matrices\n";
+    YY = dg::create::compose( lefty, chi_diag, righty);
     std::cout << "Add 1. matrices\n";
     cusp::add( jumpx, jumpy, JJ);
     std::cout << "Add 2. matrices\n";
     cusp::add( XX, YY, CX);
     std::cout << "Add 3. matrices\n";
     cusp::add( CX, JJ, XX);
-    std::cout << "Multiply 5. matrices\n";
-    cusp::multiply( inv_vol, XX, result);
+    std::cout << "Compose volume\n";
+    result = dg::create::compose( inv_vol, XX);
     //std::cout << "Sort\n";
     //result.sort_by_row();
     std::cout << "Done\n";
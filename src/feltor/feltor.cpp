@@ -19,6 +19,8 @@
 #include "init.h"
 #include "feltordiag.h"
 #include "init_from_file.h"
+#include "checkpoint.h"
+#include "insitu.h"
 
 #ifdef WITH_MPI
 //ATTENTION: in slurm should be used with --signal=SIGINT@30 (<signal>@<time in seconds>)
@@ -32,15 +34,56 @@ void sigterm_handler(int signal)
 }
 #endif //WITH_MPI
 
-using Vector = std::array<std::array<dg::x::DVec, 2>,2>;
+using Vector = std::array<std::array<feltor::x::DVec, 2>,2>;
+
+//Estimate the peak memory of a run from its input file without allocating
+//anything. The per-point counts are calibrated against the members of
+//feltor::Explicit and dg::memory_report() of a small run; they are
+//estimates (within ~20%), not bounds.
+void predict_memory( const feltor::Parameters& p, double budget_gb,
+    std::ostream& os)
+{
+    size_t points = (size_t)p.n*p.n*p.Nx*p.Ny*( p.symmetric ? 1 : p.Nz);
+    double field = (double)points*sizeof(double);
+    //the multigrid stages form a geometric series in the perp plane
+    double stages = 0.;
+    for( unsigned u=0; u<p.stages; u++)
+        stages += pow( 0.25, u);
+    std::map<std::string, double> est;
+    est["prognostic fields + timestepper history"] = 4*10*field;
+    est["feltor::Explicit work vectors"] = 120*field;
+    est["derivative + FCI interpolation matrices"] = 50*field;
+    est["elliptic/Helmholtz hierarchy + solvers"] = 30*stages*field;
+    est["diagnostics and output buffers"] = 10*field;
+    double total = 0.;
+    os << "# Predicted peak memory (sum over all processes):\n";
+    os << std::fixed << std::setprecision(3);
+    for( const auto& it : est)
+    {
+        os << "# "<<std::setw(44)<<it.first<<" "
+           <<std::setw(10)<<it.second/1e9<<" GB\n";
+        total += it.second;
+    }
+    os << "# "<<std::setw(44)<<"total"<<" "
+       <<std::setw(10)<<total/1e9<<" GB\n";
+    os << "# Divide by the number of processes for the per rank size\n";
+    if( budget_gb > 0 && total > budget_gb*1e9)
+        os << "# ATTENTION: prediction exceeds the budget of "
+           <<budget_gb<<" GB per run!\n";
+}
 
 int main( int argc, char* argv[])
 {
 #ifdef WITH_MPI
     ////////////////////////////////setup MPI///////////////////////////////
     dg::mpi_init( argc, argv);
-    MPI_Comm comm;
-    dg::mpi_init3d( dg::DIR, dg::DIR, dg::PER, comm, std::cin, true);
+    MPI_Comm comm, inter_comm;
+    bool is_sidecar = false;
+    //launching with more ranks than npx*npy*npz activates the staged
+    //in-situ diagnostics: the excess ranks form a sidecar group that
+    //evaluates and writes all diagnostics (see insitu.h)
+    dg::mpi_init3d_sidecar( dg::DIR, dg::DIR, dg::PER, comm, inter_comm,
+            is_sidecar, std::cin, true);
     int rank;
     MPI_Comm_rank( MPI_COMM_WORLD, &rank);
 
@@ -53,6 +96,7 @@ int main( int argc, char* argv[])
     {
         DG_RANK0 std::cerr << "ERROR: Wrong number of arguments!\nUsage: "
                 << argv[0]<<" [input.json] \n OR \n"
+                << argv[0]<<" [input.json] dry-run\n OR \n"
                 << argv[0]<<" [input.json] [output.nc]\n OR \n"
                 << argv[0]<<" [input.json] [output.nc] [initial.nc] "<<std::endl;
         dg::abort_program();
@@ -87,6 +131,21 @@ int main( int argc, char* argv[])
         dg::abort_program();
     }
     const feltor::Parameters p( js);
+    //optional per process memory budget in GB (0 disables the check)
+    double budget_gb = 0.;
+    if( js.asJson().isMember( "memory"))
+        budget_gb = js["memory"].get( "budget in GB", 0.).asDouble();
+    if( budget_gb > 0)
+        dg::set_memory_budget( (size_t)(budget_gb*1e9));
+    if( argc == 3 && std::string(argv[2]) == "dry-run")
+    {
+        //predict peak memory from the input file without allocating
+        DG_RANK0 predict_memory( p, budget_gb, std::cout);
+#ifdef WITH_MPI
+        MPI_Finalize();
+#endif //WITH_MPI
+        return 0;
+    }
     DG_RANK0 std::cout << js.asJson() <<  std::endl;
     std::string inputfile = js.asJson().toStyledString();
     dg::geo::TokamakMagneticField mag, mod_mag, unmod_mag;
@@ -125,6 +184,29 @@ int main( int argc, char* argv[])
         , comm
         #endif //WITH_MPI
         );
+#ifdef WITH_MPI
+    // Staged in-situ diagnostics: compute ranks only timestep and ship the
+    // prognostic fields, the sidecar ranks evaluate and write all diagnostics
+    std::unique_ptr<feltor::InsituShipper> shipper;
+    if( inter_comm != MPI_COMM_NULL)
+    {
+        if( p.output != "netcdf")
+        {
+            DG_RANK0 std::cerr << "ERROR: In-situ diagnostics require netcdf output!"<<std::endl;
+            dg::abort_program();
+        }
+        shipper = std::make_unique<feltor::InsituShipper>( inter_comm, grid);
+        // rank guards all prints and file access: route them through the
+        // sidecar group
+        if( is_sidecar)
+            MPI_Comm_rank( comm, &rank);
+        else if( rank == 0)
+            rank = -1;
+    }
+    const bool do_output = !shipper || is_sidecar;
+#else
+    const bool do_output = true;
+#endif //WITH_MPI
 
     if( p.periodify)
     {
@@ -137,20 +219,20 @@ int main( int argc, char* argv[])
         mag = unmod_mag;
 
     DG_RANK0 std::cout << "# Constructing Feltor...\n";
-    //feltor::Filter<dg::x::CylindricalGrid3d, dg::x::IDMatrix, dg::x::DVec> filter( grid, js);
-    feltor::Explicit< dg::x::CylindricalGrid3d, dg::x::IDMatrix,
-        dg::x::DMatrix, dg::x::DVec> feltor( grid, p, mag, js);
+    //feltor::Filter<dg::x::CylindricalGrid3d, feltor::x::IDMatrix, feltor::x::DVec> filter( grid, js);
+    feltor::Explicit< dg::x::CylindricalGrid3d, feltor::x::IEllMatrix,
+        feltor::x::DMatrix, feltor::x::DVec> feltor( grid, p, mag, js);
     DG_RANK0 std::cout << "# Done!\n";
 
-    feltor.set_wall( p.wall_rate, dg::construct<dg::x::DVec>( dg::pullback(
+    feltor.set_wall( p.wall_rate, dg::construct<feltor::x::DVec>( dg::pullback(
                     wall, grid)), p.nwall, p.uwall );
     dg::Timer t;
     if( p.sheath_bc != "none")
     {
         t.tic();
         DG_RANK0 std::cout << "# Compute Sheath coordinates \n";
+        dg::Grid2d sheath_walls( Rmin, Rmax, Zmin, Zmax, 1, 1, 1);
         try{
-            dg::Grid2d sheath_walls( Rmin, Rmax, Zmin, Zmax, 1, 1, 1);
             dg::geo::createSheathRegion( js["boundary"]["sheath"],
                 dg::geo::createMagneticField(js["magnetic_field"]["params"]),
                 wall, sheath_walls, sheath);
@@ -164,12 +246,19 @@ int main( int argc, char* argv[])
             DG_RANK0 std::cerr <<e.what()<<std::endl;
             dg::abort_program();
         }
-        dg::x::HVec coord2d = dg::pullback( sheath_coordinate, *grid.perp_grid());
-        dg::x::DVec coord3d;
+        // evaluate the fieldlines in parallel and cache the result so that
+        // restarts of the same setup skip the integration
+        std::string sheath_cache = js["boundary"]["sheath"].get(
+                "cache", "").asString();
+        dg::x::HVec coord2d = dg::geo::wall_fieldline_evaluate(
+                dg::geo::createBHat( mag), sheath_walls, *grid.perp_grid(),
+                p.sheath_max_angle, 1e-6, p.sheath_coord, "coordinate",
+                sheath_cache);
+        feltor::x::DVec coord3d;
         dg::assign3dfrom2d( coord2d, coord3d, grid);
         feltor.set_sheath(
                 p.sheath_rate,
-                dg::construct<dg::x::DVec>(dg::pullback( sheath, grid)),
+                dg::construct<feltor::x::DVec>(dg::pullback( sheath, grid)),
                 coord3d);
         t.toc();
         DG_RANK0 std::cout << "# ... took  "<<t.diff()<<"s\n";
@@ -184,8 +273,8 @@ int main( int argc, char* argv[])
             fixed_profile, ne_profile, grid, mag, unmod_mag, js["source"],
             minne, minrate, minalpha);
         feltor.set_source( fixed_profile,
-                dg::construct<dg::x::DVec>(ne_profile), p.source_rate,
-                dg::construct<dg::x::DVec>(source_profile),
+                dg::construct<feltor::x::DVec>(ne_profile), p.source_rate,
+                dg::construct<feltor::x::DVec>(source_profile),
                 minne, minrate, minalpha);
     }catch ( std::out_of_range& error){
         DG_RANK0 std::cerr << "ERROR: in source: "<<error.what();
@@ -196,7 +285,7 @@ int main( int argc, char* argv[])
     double time = 0.;
     std::vector<double> time_intern(p.itstp);
     Vector y0;
-    std::array<dg::x::DVec, 3> gradPsip; //referenced by Variables
+    std::array<feltor::x::DVec, 3> gradPsip; //referenced by Variables
     gradPsip[0] =  dg::evaluate( mag.psipR(), grid);
     gradPsip[1] =  dg::evaluate( mag.psipZ(), grid);
     gradPsip[2] =  dg::evaluate( dg::zero, grid); //zero
@@ -208,6 +297,17 @@ int main( int argc, char* argv[])
     };
     DG_RANK0 std::cout << "# Set Initial conditions ... \n";
     t.tic();
+#ifdef WITH_MPI
+    if( shipper && is_sidecar)
+    {
+        // the compute group ships the initial state
+        y0[0][0] = y0[0][1] = y0[1][0] = y0[1][1] =
+            dg::construct<feltor::x::DVec>( dg::evaluate( dg::zero, grid));
+        bool dummy = false;
+        shipper->receive( time, dummy, y0);
+    }
+    else
+#endif //WITH_MPI
     if( argc == 4 )
     {
         try{
@@ -240,6 +340,10 @@ int main( int argc, char* argv[])
             dg::abort_program();
         }
     }
+#ifdef WITH_MPI
+    if( shipper && !is_sidecar)
+        shipper->ship( time, false, y0);
+#endif //WITH_MPI
     t.toc();
     DG_RANK0 std::cout << "# ... took  "<<t.diff()<<"s\n";
 
@@ -260,18 +364,20 @@ int main( int argc, char* argv[])
     //IDMatrix probe_interpolate = dg::create::interpolation( R_probe, Z_probe, phi_probe, grid);
     //dg::IDMatrix probe_interpolate = dg::create::interpolation( R_probe, Z_probe, phi_probe, grid.global());
 #ifdef WITH_MPI
-    dg::MDVec simple_probes_device((dg::DVec)R_probe,grid.communicator());
+    feltor::x::DVec simple_probes_device( thrust::device_vector<feltor::Real>(
+                R_probe.begin(), R_probe.end()), grid.communicator());
     dg::MHVec simple_probes(R_probe, grid.communicator());
 #else //WITH_MPI
-    dg::DVec simple_probes_device(p.num_pins);
+    feltor::x::DVec simple_probes_device(p.num_pins);
     dg::HVec simple_probes(p.num_pins);
 #endif
+    //the staged probe values are written with nc_put_vara_double and stay double
     std::map<std::string, std::vector<dg::x::HVec>> simple_probes_intern;
     for( auto& record : feltor::probe_list)
     {
         simple_probes_intern[record.name] = std::vector<dg::x::HVec>(p.itstp+1, simple_probes);
     }
-    dg::x::IDMatrix probe_interpolate = dg::create::interpolation( R_probe, Z_probe, phi_probe, grid);
+    dg::PointInterpolation<feltor::x::DVec> probe_interpolate( R_probe, Z_probe, phi_probe, grid);
 
 
 
@@ -310,6 +416,9 @@ int main( int argc, char* argv[])
     double t_output = time;
 
     unsigned maxout = js["output"].get( "maxout", 0).asUInt();
+    //keep the expensive per-step diagnostics below this fraction of runtime
+    feltor::DiagnosticsScheduler scheduler( js["output"].get(
+            "diagnostics fraction", 1.).asDouble());
     std::string output_mode = js["timestepper"].get(
             "output-mode", "Tend").asString();
     double Tend = 0, deltaT = 0.;
@@ -348,17 +457,68 @@ int main( int argc, char* argv[])
         unsigned local_size2d = g2d_out_ptr->size();
 #endif
         std::map<std::string, dg::Simpsons<dg::x::HVec>> time_integrals;
-        dg::Average<dg::x::HVec> toroidal_average( g3d_out, dg::coo3d::z, "simple");
+        //averaging on the device so the result can be packed into the staged
+        //2d transfer (see DeviceStager in common.h)
+        dg::Average<feltor::x::DVec> toroidal_averageD( g3d_out, dg::coo3d::z, "simple");
         dg::MultiMatrix<dg::x::HMatrix,dg::x::HVec> projectH =
             dg::create::fast_projection( grid, 1, cx, cy);
-        dg::MultiMatrix<dg::x::DMatrix,dg::x::DVec> projectD =
+        dg::MultiMatrix<feltor::x::DMatrix,feltor::x::DVec> projectD =
             dg::create::fast_projection( grid, 1, cx, cy);
         dg::x::HVec transferH( dg::evaluate(dg::zero, g3d_out));
-        dg::x::DVec transferD( dg::evaluate(dg::zero, g3d_out));
+        feltor::x::DVec transferD( dg::evaluate(dg::zero, g3d_out));
         dg::x::HVec transferH2d = dg::evaluate( dg::zero, *g2d_out_ptr);
-        dg::x::DVec transferD2d = dg::evaluate( dg::zero, *g2d_out_ptr);
+        feltor::x::DVec transferD2d = dg::evaluate( dg::zero, *g2d_out_ptr);
         dg::x::HVec resultH = dg::evaluate( dg::zero, grid);
-        dg::x::DVec resultD = dg::evaluate( dg::zero, grid);
+        feltor::x::DVec resultD = dg::evaluate( dg::zero, grid);
+        // runtime record selection: restrict the diagnostics lists to the
+        // records named in the input file so that disabling expensive
+        // records does not require a rebuild; unselected records cost
+        // neither evaluation nor file definition
+        if( js["output"].asJson().isMember("records"))
+        {
+            std::vector<std::string> record_names;
+            for( unsigned i=0; i<js["output"]["records"].size(); i++)
+                record_names.push_back( js["output"]["records"][i].asString());
+            auto unmatched = feltor::select_records( record_names);
+            for( auto& name : unmatched)
+                throw std::runtime_error( "output: records: "+name+" not recognized!\n");
+        }
+        // per-record output grids: records of the 3d diagnostics may declare
+        // an additional compression factor (see feltordiag.h); all records
+        // with the same factor share one output grid, projection and buffers
+        struct OutputLevel
+        {
+            std::unique_ptr<dg::x::CylindricalGrid3d> grid;
+            dg::MultiMatrix<feltor::x::DMatrix,feltor::x::DVec> project;
+            feltor::x::DVec transferD;
+            dg::x::HVec transferH;
+            int dim_ids[3];
+        };
+        std::map<unsigned, OutputLevel> output_levels;
+        for( auto& record : feltor::diagnostics3d_list)
+        {
+            unsigned c = record.compression;
+            if( c == 1 || output_levels.count( c) != 0)
+                continue;
+            if( Nx_out % c != 0 || Ny_out % c != 0)
+                throw std::runtime_error( "output: compression "
+                        +std::to_string(c)+" of record "+record.name
+                        +" does not divide the output grid!\n");
+            OutputLevel level;
+            level.grid = std::make_unique<dg::x::CylindricalGrid3d>( Rmin,
+                Rmax, Zmin, Zmax, 0., 2.*M_PI, n_out, Nx_out/c, Ny_out/c,
+                p.symmetric ? 1 : Nz_out, p.bcxN, p.bcyN, dg::PER
+                #ifdef WITH_MPI
+                , comm
+                #endif //WITH_MPI
+                );
+            //projection stays on the device: only the coarse field is
+            //transferred to the host and written
+            level.project = dg::create::fast_projection( grid, 1, cx*c, cy*c);
+            level.transferD = dg::evaluate( dg::zero, *level.grid);
+            level.transferH = dg::evaluate( dg::zero, *level.grid);
+            output_levels.insert( std::make_pair( c, std::move( level)));
+        }
         if( argc != 3 && argc != 4)
         {
             DG_RANK0 std::cerr << "ERROR: Wrong number of arguments for netcdf output!\nUsage: "
@@ -411,8 +571,11 @@ int main( int argc, char* argv[])
 
         // Define dimensions (t,z,y,x)
         int dim_ids[4], restart_dim_ids[3], tvarID;
-        DG_RANK0 err = dg::file::define_dimensions( ncid, &dim_ids[1], g3d_out,
-                {"z", "y", "x"});
+        dg::file::DimensionCache dim_cache;
+        DG_RANK0 err = dim_cache.dimension_ids( ncid, g3d_out, &dim_ids[1]);
+        for( auto& entry : output_levels)
+            DG_RANK0 err = dim_cache.dimension_ids( ncid, *entry.second.grid,
+                    entry.second.dim_ids);
         if( !p.calibrate)
             DG_RANK0 err = dg::file::define_time( ncid, "time", dim_ids, &tvarID);
         DG_RANK0 err = dg::file::define_dimensions( ncid, restart_dim_ids, grid,
@@ -429,6 +592,7 @@ int main( int argc, char* argv[])
 #endif //WITH_MPI
 
         //create & output static 3d variables into file
+        if( do_output)
         for ( auto& record : feltor::diagnostics3d_static_list)
         {
             int vecID;
@@ -443,6 +607,7 @@ int main( int argc, char* argv[])
             dg::file::put_var_double( ncid, vecID, g3d_out, transferH);
         }
         //create & output static 2d variables into file
+        if( do_output)
         for ( auto& record : feltor::diagnostics2d_static_list)
         {
             int vecID;
@@ -456,6 +621,7 @@ int main( int argc, char* argv[])
             dg::blas2::symv( projectH, resultH, transferH);
             if(write2d)dg::file::put_var_double( ncid, vecID, *g2d_out_ptr, transferH);
         }
+        if( do_output)
         {
             // transition has to be done by hand
             int vecID;
@@ -474,6 +640,8 @@ int main( int argc, char* argv[])
         {
             DG_RANK0 err = nc_close(ncid);
 #ifdef WITH_MPI
+            if( shipper)
+                shipper->flush();
             MPI_Finalize();
 #endif //WITH_MPI
             return 0;
@@ -487,7 +655,13 @@ int main( int argc, char* argv[])
             std::string name = record.name;
             std::string long_name = record.long_name;
             id4d[name] = 0;//creates a new id4d entry for all processes
-            DG_RANK0 err = nc_def_var( ncid, name.data(), NC_DOUBLE, 4, dim_ids,
+            int record_dims[4] = { dim_ids[0], dim_ids[1], dim_ids[2],
+                dim_ids[3]};
+            if( record.compression > 1)
+                for( unsigned i=0; i<3; i++)
+                    record_dims[1+i] =
+                        output_levels.at( record.compression).dim_ids[i];
+            DG_RANK0 err = nc_def_var( ncid, name.data(), NC_DOUBLE, 4, record_dims,
                 &id4d.at(name));
             DG_RANK0 err = nc_put_att_text( ncid, id4d.at(name), "long_name", long_name.size(),
                 long_name.data());
@@ -502,6 +676,24 @@ int main( int argc, char* argv[])
             DG_RANK0 err = nc_put_att_text( ncid, restart_ids.at(name),
                     "long_name", long_name.size(), long_name.data());
         }
+        // Fast restart checkpoints (written in addition to the restart fields
+        // in the main output file, see checkpoint.h)
+        std::unique_ptr<feltor::Checkpointer> checkpointer;
+        std::vector<dg::x::HVec> checkpoint_fields;
+        {
+            std::string base = js["output"].get( "checkpoint", "").asString();
+            bool delta = js["output"].get( "checkpoint-delta", false).asBool();
+            if( !base.empty())
+            {
+                std::vector<std::string> names;
+                for( auto& record : feltor::restart3d_list)
+                    names.push_back( record.name);
+                checkpointer = std::make_unique<feltor::Checkpointer>(
+                        base, grid, names, inputfile, delta);
+                checkpoint_fields.assign( names.size(),
+                        dg::evaluate( dg::zero, grid));
+            }
+        }
 
         std::vector<std::vector<feltor::Record>> equation_list;
         bool equation_list_exists = js["output"].asJson().isMember("equations");
@@ -537,6 +729,12 @@ int main( int argc, char* argv[])
             equation_list.push_back(feltor::ParallelMomDiagnostics2d_list);
             equation_list.push_back(feltor::RSDiagnostics2d_list);
         }
+        // pack all 2d diagnostics of one record list into a single device to
+        // host transfer (see common.h)
+        unsigned max_records2d = 0;
+        for( auto& m_list : equation_list)
+            max_records2d = std::max( max_records2d, (unsigned)m_list.size());
+        feltor::DeviceStager stager( local_size2d, 2*max_records2d);
 
         std::string m_list;
         for( auto& m_list : equation_list)
@@ -598,11 +796,16 @@ int main( int argc, char* argv[])
             }
         }
 
+        // The frequent 0d/1d records (energies, probes) are batched on a
+        // writer thread so the timestep loop never waits for the file system
+        dg::file::BufferedRecordWriter recorder;
+
         ///////////////////////////////////first output/////////////////////////
         DG_RANK0 std::cout << "First output ... \n";
         //first, update feltor (to get potential etc.)
+        if( do_output)
         {
-            std::array<std::array<dg::x::DVec,2>,2> y1(y0);
+            std::array<std::array<feltor::x::DVec,2>,2> y1(y0);
             try{
                 feltor( time, y0, y1);
             } catch( dg::Fail& fail) {
@@ -615,55 +818,85 @@ int main( int argc, char* argv[])
 
         size_t start = 0, count = 1;
         DG_RANK0 err = nc_put_vara_double( ncid, tvarID, &start, &count, &time);
+        if( do_output)
         for( auto& record : feltor::diagnostics3d_list)
         {
             record.function( resultD, var);
-            dg::blas2::symv( projectD, resultD, transferD);
-            dg::assign( transferD, transferH);
-            dg::file::put_vara_double( ncid, id4d.at(record.name), start, g3d_out, transferH);
+            if( record.compression > 1)
+            {
+                auto& level = output_levels.at( record.compression);
+                dg::blas2::symv( level.project, resultD, level.transferD);
+                dg::assign( level.transferD, level.transferH);
+                dg::file::put_vara_double( ncid, id4d.at(record.name), start,
+                        *level.grid, level.transferH);
+            }
+            else
+            {
+                dg::blas2::symv( projectD, resultD, transferD);
+                dg::assign( transferD, transferH);
+                dg::file::put_vara_double( ncid, id4d.at(record.name), start,
+                        g3d_out, transferH);
+            }
         }
+        if( do_output)
         for( auto& record : feltor::restart3d_list)
         {
             record.function( resultD, var);
             dg::assign( resultD, resultH);
             dg::file::put_var_double( ncid, restart_ids.at(record.name), grid, resultH);
         }
+        if( do_output && checkpointer)
+        {
+            for( unsigned u=0; u<feltor::restart3d_list.size(); u++)
+            {
+                feltor::restart3d_list[u].function( resultD, var);
+                dg::assign( resultD, checkpoint_fields[u]);
+            }
+            checkpointer->write( time, checkpoint_fields);
+        }
 
+        if( do_output)
         for( auto& m_list : equation_list)
         {
+            dg::Timer tti;
+            tti.tic();
+            stager.reset();
             for( auto& record : m_list)
             {
-                dg::Timer tti;
-                tti.tic();
                 record.function( resultD, var);
                 dg::blas2::symv( projectD, resultD, transferD);
                 //toroidal average
+                toroidal_averageD( transferD, transferD2d, false);
+                stager.stage( transferD2d);
+                // add a slice
+                feltor::slice_vector3d( transferD, transferD2d, local_size2d);
+                stager.stage( transferD2d);
+            }
+            stager.transfer(); //single device to host copy of all records
+            tti.toc();
+            DG_RANK0 std::cout<< " Computing 2d averages and slices took "<<tti.diff()<<"\n";
+            tti.tic();
+            unsigned slot = 0;
+            for( auto& record : m_list)
+            {
                 std::string name = record.name + "_ta2d";
-                dg::assign( transferD, transferH);
-                toroidal_average( transferH, transferH2d, false);
+                stager.unstage( slot++, transferH2d);
                 //create and init Simpsons for time integrals
                 if( record.integral) time_integrals[name].init( time, transferH2d);
-                tti.toc();
-                DG_RANK0 std::cout<< name << " Computing average took "<<tti.diff()<<"\n";
-                tti.tic();
                 if(write2d) dg::file::put_vara_double( ncid, id3d.at(name), start, *g2d_out_ptr, transferH2d);
-                tti.toc();
-                DG_RANK0 std::cout<< name << " 2d output took "<<tti.diff()<<"\n";
-                tti.tic();
-                // add a slice
                 name = record.name + "_2d";
-                feltor::slice_vector3d( transferD, transferD2d, local_size2d);
-                dg::assign( transferD2d, transferH2d);
+                stager.unstage( slot++, transferH2d);
                 if( record.integral) time_integrals[name].init( time, transferH2d);
                 if(write2d) dg::file::put_vara_double( ncid, id3d.at(name), start, *g2d_out_ptr, transferH2d);
-                tti.toc();
-                DG_RANK0 std::cout<< name << " 2d output took "<<tti.diff()<<"\n";
             }
+            tti.toc();
+            DG_RANK0 std::cout<< " 2d output took "<<tti.diff()<<"\n";
         }
+        if( do_output)
         for( auto& record : feltor::diagnostics1d_list)
         {
             double result = record.function( var);
-            DG_RANK0 nc_put_vara_double( ncid, id1d.at(record.name), &start, &count, &result);
+            DG_RANK0 recorder.queue_vara_double( ncid, id1d.at(record.name), start, result);
         }
 
 
@@ -671,40 +904,75 @@ int main( int argc, char* argv[])
         size_t probe_start[] = {0, 0};
         size_t probe_count[] = {1, p.num_pins};
         time_intern[0]=time;
-        if(p.probes)
+        if( do_output && p.probes)
         {
-        DG_RANK0 err = nc_put_vara_double( probe_grp_id, R_pin_id, &probe_start[1], &probe_count[1], R_probe.data());
-        DG_RANK0 err = nc_put_vara_double( probe_grp_id, Z_pin_id, &probe_start[1], &probe_count[1], Z_probe.data());
-        DG_RANK0 err = nc_put_vara_double( probe_grp_id, phi_pin_id, &probe_start[1], &probe_count[1], phi_probe.data());
-        DG_RANK0 err = nc_put_vara_double( probe_grp_id, probe_timevarID, &probe_start[0], &count, &time_intern[0]);
+        DG_RANK0 recorder.queue_vara_double( probe_grp_id, R_pin_id, 1, &probe_start[1], &probe_count[1], R_probe.data());
+        DG_RANK0 recorder.queue_vara_double( probe_grp_id, Z_pin_id, 1, &probe_start[1], &probe_count[1], Z_probe.data());
+        DG_RANK0 recorder.queue_vara_double( probe_grp_id, phi_pin_id, 1, &probe_start[1], &probe_count[1], phi_probe.data());
+        DG_RANK0 recorder.queue_vara_double( probe_grp_id, probe_timevarID, probe_start[0], time_intern[0]);
 
         for( auto& record : feltor::probe_list)
         {
             record.function( resultD, var);
-            dg::blas2::symv( probe_interpolate, resultD, simple_probes_device);
+            probe_interpolate( resultD, simple_probes_device);
             dg::assign(simple_probes_device,simple_probes);
             simple_probes_intern.at(record.name)[0]=simple_probes;
 #ifdef WITH_MPI
-            DG_RANK0 err = nc_put_vara_double( probe_grp_id, probe_id_field.at(record.name), probe_start, probe_count, simple_probes.data().data());
+            DG_RANK0 recorder.queue_vara_double( probe_grp_id, probe_id_field.at(record.name), 2, probe_start, probe_count, simple_probes.data().data());
 #else
-            DG_RANK0 err = nc_put_vara_double( probe_grp_id, probe_id_field.at(record.name), probe_start, probe_count, simple_probes.data());
+            DG_RANK0 recorder.queue_vara_double( probe_grp_id, probe_id_field.at(record.name), 2, probe_start, probe_count, simple_probes.data());
 #endif
         }
         }
          /// End probes output ///
 
+        recorder.flush(); //all records must be on disk before nc_close
         DG_RANK0 err = nc_close(ncid);
         DG_RANK0 std::cout << "First write successful!\n";
+        // At this point all components have read their parameters; any key
+        // that was never accessed is most likely misspelled and would
+        // silently fall back to its default in a production run
+        for( auto& key : js.unused_keys())
+            DG_RANK0 std::cerr << "WARNING: Input key "<<key
+                               <<"was never read - misspelled?\n";
+
         ///////////////////////////////Timeloop/////////////////////////////////
 
         t.tic();
         bool abort = false;
+#ifdef WITH_MPI
+        Vector y1diag;
+        if( shipper && is_sidecar)
+            y1diag = y0;
+#endif //WITH_MPI
         for( unsigned i=1; i<=maxout; i++)
         {
             dg::Timer ti;
             ti.tic();
             for( unsigned j=1; j<=p.itstp; j++)
             {
+                dg::Timer ts;
+                ts.tic();
+#ifdef WITH_MPI
+                if( shipper && is_sidecar)
+                {
+                    bool sim_abort = false;
+                    shipper->receive( time, sim_abort, y0);
+                    try{
+                        feltor( time, y0, y1diag); //refresh derived quantities
+                    }
+                    catch( std::exception& fail) {
+                        DG_RANK0 std::cerr << "ERROR in sidecar diagnostics\n";
+                        DG_RANK0 std::cerr << fail.what()<<std::endl;
+                        DG_RANK0 std::cerr << "Writing last Output and exit..."<<std::endl;
+                        abort = true;
+                    }
+                    if( sim_abort)
+                        abort = true;
+                }
+                else
+                {
+#endif //WITH_MPI
                 try{
                     odeint->integrate( time, y0, t_output + j*deltaT, y0,
                         j<p.itstp ? dg::to::at_least :  dg::to::exact);
@@ -721,43 +989,75 @@ int main( int argc, char* argv[])
                     DG_RANK0 std::cerr << "Writing last Output and exit..."<<std::endl;
                     abort = true;
                 }
+                //the elliptic equations of the next step need not be solved
+                //deeper than the timestep accuracy requires: relax their
+                //tolerances by the current error slack of the controller
+                if( p.timestepper == "adaptive" && p.eps_scale_max > 1)
+                    feltor.set_eps_scale( std::min( p.eps_scale_max,
+                        std::max( 1., 0.1/adapt.get_error())));
+#ifdef WITH_MPI
+                if( shipper)
+                    shipper->ship( time, abort, y0);
+                }
+#endif //WITH_MPI
+                ts.toc();
+                scheduler.step_cost( ts.diff());
                 dg::Timer tti;
                 tti.tic();
 
 
-                if(p.probes)
+                if( do_output && p.probes)
                 {
                 for( auto& record : feltor::probe_list)
                 {
                     record.function( resultD, var);
-                    dg::blas2::symv( probe_interpolate, resultD, simple_probes_device);
+                    probe_interpolate( resultD, simple_probes_device);
                     dg::assign(simple_probes_device,simple_probes);
                     simple_probes_intern.at(record.name)[j]=simple_probes;
                     time_intern[j]=time;
                 }
                 }
+                //the expensive 2d records are admitted by wall-clock budget
+                bool diag_due = scheduler.due();
+                dg::Timer td;
+                td.tic();
+                if( do_output && diag_due)
                 for( auto& m_list : equation_list)
                 {
+                    stager.reset();
                     for( auto& record : m_list)
                     {
                         if( record.integral)
                         {
                             record.function( resultD, var);
                             dg::blas2::symv( projectD, resultD, transferD);
-                            //toroidal average and add to time integral
-                            dg::assign( transferD, transferH);
-                            toroidal_average( transferH, transferH2d, false);
-                            time_integrals.at(record.name+"_ta2d").add( time,
-                                transferH2d);
+                            //toroidal average
+                            toroidal_averageD( transferD, transferD2d, false);
+                            stager.stage( transferD2d);
                             // 2d data of plane varphi = 0
                             feltor::slice_vector3d( transferD, transferD2d,
                                 local_size2d);
-                            dg::assign( transferD2d, transferH2d);
+                            stager.stage( transferD2d);
+                        }
+                    }
+                    stager.transfer(); //single device to host copy
+                    unsigned slot = 0;
+                    for( auto& record : m_list)
+                    {
+                        if( record.integral)
+                        {
+                            stager.unstage( slot++, transferH2d);
+                            time_integrals.at(record.name+"_ta2d").add( time,
+                                transferH2d);
+                            stager.unstage( slot++, transferH2d);
                             time_integrals.at(record.name+"_2d").add( time,
                                 transferH2d);
                         }
                     }
                 }
+                td.toc();
+                if( do_output && diag_due)
+                    scheduler.diag_cost( td.diff());
 
                 DG_RANK0 std::cout << "\tTime "<<time<<"\n";
                 double max_ue = dg::blas1::reduce(
@@ -797,14 +1097,27 @@ int main( int argc, char* argv[])
             start = i;
             DG_RANK0 err = nc_open(file_name.data(), NC_WRITE, &ncid);
             DG_RANK0 err = nc_put_vara_double( ncid, tvarID, &start, &count, &time);
+            if( do_output)
             for( auto& record : feltor::diagnostics3d_list)
             {
                 record.function( resultD, var);
-                dg::blas2::symv( projectD, resultD, transferD);
-                dg::assign( transferD, transferH);
-                dg::file::put_vara_double( ncid, id4d.at(record.name), start,
-                        g3d_out, transferH);
+                if( record.compression > 1)
+                {
+                    auto& level = output_levels.at( record.compression);
+                    dg::blas2::symv( level.project, resultD, level.transferD);
+                    dg::assign( level.transferD, level.transferH);
+                    dg::file::put_vara_double( ncid, id4d.at(record.name),
+                            start, *level.grid, level.transferH);
+                }
+                else
+                {
+                    dg::blas2::symv( projectD, resultD, transferD);
+                    dg::assign( transferD, transferH);
+                    dg::file::put_vara_double( ncid, id4d.at(record.name),
+                            start, g3d_out, transferH);
+                }
             }
+            if( do_output)
             for( auto& record : feltor::restart3d_list)
             {
                 record.function( resultD, var);
@@ -812,8 +1125,40 @@ int main( int argc, char* argv[])
                 dg::file::put_var_double( ncid, restart_ids.at(record.name),
                         grid, resultH);
             }
+            if( do_output && checkpointer)
+            {
+                dg::Timer tck;
+                tck.tic();
+                for( unsigned u=0; u<feltor::restart3d_list.size(); u++)
+                {
+                    feltor::restart3d_list[u].function( resultD, var);
+                    dg::assign( resultD, checkpoint_fields[u]);
+                }
+                checkpointer->write( time, checkpoint_fields);
+                tck.toc();
+                DG_RANK0 std::cout << " Checkpoint "
+                    << checkpointer->get_counter()-1 <<" took "
+                    << tck.diff()<<"s\n";
+            }
+            if( do_output)
             for( auto& m_list : equation_list)
             {
+            stager.reset();
+            for( auto& record : m_list)
+            {
+                if( !record.integral) // compute from scratch
+                {
+                    record.function( resultD, var);
+                    dg::blas2::symv( projectD, resultD, transferD);
+                    toroidal_averageD( transferD, transferD2d, false);
+                    stager.stage( transferD2d);
+                    // 2d data of plane varphi = 0
+                    feltor::slice_vector3d( transferD, transferD2d, local_size2d);
+                    stager.stage( transferD2d);
+                }
+            }
+            stager.transfer(); //single device to host copy
+            unsigned slot = 0;
             for( auto& record : m_list)
             {
                 if(record.integral) // we already computed the output...
@@ -830,48 +1175,46 @@ int main( int argc, char* argv[])
                     if(write2d) dg::file::put_vara_double( ncid, id3d.at(name),
                             start, *g2d_out_ptr, transferH2d);
                 }
-                else // compute from scratch
+                else
                 {
-                    record.function( resultD, var);
-                    dg::blas2::symv( projectD, resultD, transferD);
                     std::string name = record.name + "_ta2d";
-                    dg::assign( transferD, transferH);
-                    toroidal_average( transferH, transferH2d, false);
+                    stager.unstage( slot++, transferH2d);
                     if(write2d) dg::file::put_vara_double( ncid, id3d.at(name),
                             start, *g2d_out_ptr, transferH2d);
 
                     // 2d data of plane varphi = 0
                     name = record.name+"_2d";
-                    feltor::slice_vector3d( transferD, transferD2d, local_size2d);
-                    dg::assign( transferD2d, transferH2d);
+                    stager.unstage( slot++, transferH2d);
                     if(write2d) dg::file::put_vara_double( ncid, id3d.at(name),
                             start, *g2d_out_ptr, transferH2d);
                 }
             }
             }
 
+            if( do_output)
             for( auto& record : feltor::diagnostics1d_list)
             {
                 double result = record.function( var);
-                DG_RANK0 nc_put_vara_double( ncid, id1d.at(record.name), &start, &count, &result);
+                DG_RANK0 recorder.queue_vara_double( ncid, id1d.at(record.name), start, result);
             }
             //OUTPUT OF PROBES
-            if(p.probes){
+            if( do_output && p.probes){
             for( unsigned j=1; j<=p.itstp; j++)
             {
                 probe_start[0] += 1;
-                DG_RANK0 err = nc_put_vara_double( probe_grp_id, probe_timevarID, &probe_start[0] , &probe_count[0], &time_intern[j]);
+                DG_RANK0 recorder.queue_vara_double( probe_grp_id, probe_timevarID, probe_start[0], time_intern[j]);
                 for( auto& record : feltor::probe_list)
                 {
 #ifdef WITH_MPI
-                    DG_RANK0 err = nc_put_vara_double( probe_grp_id, probe_id_field.at(record.name), probe_start, probe_count, simple_probes_intern.at(record.name)[j].data().data());
+                    DG_RANK0 recorder.queue_vara_double( probe_grp_id, probe_id_field.at(record.name), 2, probe_start, probe_count, simple_probes_intern.at(record.name)[j].data().data());
 #else
-                    DG_RANK0 err = nc_put_vara_double( probe_grp_id, probe_id_field.at(record.name), probe_start, probe_count, simple_probes_intern.at(record.name)[j].data());
+                    DG_RANK0 recorder.queue_vara_double( probe_grp_id, probe_id_field.at(record.name), 2, probe_start, probe_count, simple_probes_intern.at(record.name)[j].data());
 #endif
                 }
             }
             }
 
+            recorder.flush(); //all records must be on disk before nc_close
             DG_RANK0 err = nc_close(ncid);
             ti.toc();
             DG_RANK0 std::cout << "\n\t Time for output: "<<ti.diff()<<"s\n\n"<<std::flush;
@@ -890,14 +1233,16 @@ int main( int argc, char* argv[])
     {
         dg::Timer t;
 
-        std::map<std::string, const dg::x::DVec* > v4d;
+        std::map<std::string, const feltor::x::DVec* > v4d;
         v4d["ne-1 / "] = &feltor.density(0),  v4d["ni-1 / "] = &feltor.density(1);
         v4d["Ue / "]   = &feltor.velocity(0), v4d["Ui / "]   = &feltor.velocity(1);
         v4d["Phi / "] = &feltor.potential(0); v4d["Apar / "] = &feltor.aparallel();
         /////////////////////////set up transfer for glfw
         dg::DVec dvisual( grid.size(), 0.);
         dg::HVec hvisual( grid.size(), 0.), visual(hvisual), avisual(hvisual);
-        dg::IHMatrix equi = dg::create::backscatter( grid);
+        //the block format applies as batched dense per-cell transforms on device
+        dg::MultiMatrix<dg::DMatrix, dg::DVec> equi =
+            dg::create::fast_backscatter( grid);
         draw::ColorMapRedBlueExtMinMax colors(-1.0, 1.0);
 
         /////////glfw initialisation ////////////////////////////////////////////
@@ -932,7 +1277,9 @@ int main( int argc, char* argv[])
                 }
                 else
                     dg::assign( *pair.second, hvisual);
-                dg::blas2::gemv( equi, hvisual, visual);
+                //backscatter on device, only the equidistant result transfers
+                dg::blas2::gemv( equi, *pair.second, dvisual);
+                dg::assign( dvisual, visual);
                 colors.scalemax() = dg::blas1::reduce(
                     visual, 0., dg::AbsMax<double>() );
                 colors.scalemin() = -colors.scalemax();
@@ -967,6 +1314,9 @@ int main( int argc, char* argv[])
             {
                 odeint->integrate( time, y0, t_output + i*deltaT, y0,
                          i<p.itstp ? dg::to::at_least :  dg::to::exact);
+                if( p.timestepper == "adaptive" && p.eps_scale_max > 1)
+                    feltor.set_eps_scale( std::min( p.eps_scale_max,
+                        std::max( 1., 0.1/adapt.get_error())));
                 std::cout << "Time "<<time<<" t_out "<<t_output<<" deltaT "<<deltaT<<" i "<<i<<" itstp "<<p.itstp<<"\n";
 
                 double max_ue = dg::blas1::reduce(
@@ -1000,6 +1350,8 @@ int main( int argc, char* argv[])
     }
 #endif //WITHOUT_GLFW
 #ifdef WITH_MPI
+    if( shipper)
+        shipper->flush();
     MPI_Finalize();
 #endif //WITH_MPI
 
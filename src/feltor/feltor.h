@@ -2,6 +2,7 @@
 
 #include "dg/algorithm.h"
 #include "parameters.h"
+#include "common.h"
 #include "dg/geometries/geometries.h"
 
 #define FELTORPARALLEL 1
@@ -482,6 +483,7 @@ struct Explicit
         dg::blas1::copy( wall, m_wall);
         m_nwall = nwall;
         m_uwall = uwall;
+        update_region_stencils();
     }
     void set_sheath(double sheath_rate, const Container& sheath,
             const Container& sheath_coordinate)
@@ -489,6 +491,7 @@ struct Explicit
         m_sheath_rate = sheath_rate;
         dg::blas1::copy( sheath, m_sheath);
         dg::blas1::copy( sheath_coordinate, m_sheath_coordinate);
+        update_region_stencils();
     }
     void compute_aparST( double t, const std::array<Container,2>&,
             std::array<Container,2>&, Container&, bool);
@@ -551,6 +554,7 @@ struct Explicit
         Container& flux,
         std::string slope_limiter);
     void compute_parallel(          std::array<std::array<Container,2>,2>& yp);
+    void update_region_stencils();
     void multiply_rhs_penalization(      Container& yp);
     void add_wall_and_sheath_terms( std::array<std::array<Container,2>,2>& yp);
     void add_source_terms(          std::array<std::array<Container,2>,2>& yp);
@@ -558,6 +562,13 @@ struct Explicit
     {
         return m_fa;
     }
+    //Couple the inner elliptic tolerances to the accuracy of the current
+    //timestep: all eps_pol/eps_gamma/eps_ampere values are multiplied by
+    //scale (>1 relaxes, set from the error slack of the adaptive integrator)
+    void set_eps_scale( double scale)
+    {
+        m_multigrid.set_eps_scale( scale);
+    }
   private:
     void construct_mag( const Geometry&, feltor::Parameters,
         dg::geo::TokamakMagneticField);
@@ -594,8 +605,15 @@ struct Explicit
     // Set by diag_update
     std::array<Container,2> m_dssU, m_lapParU, m_lapParN;
 
+    // Lagged perp diffusion terms (regularization: lag), set by add_implicit_density
+    std::array<Container,2> m_lagN, m_lagU;
+    unsigned m_lag_counter = 0;
+    bool m_lag_due = true;
+
     // Helper variables can be overwritten any time (except by compute_parallel)!!
     Container m_temp0, m_temp1;
+    // per species scratch for the species parallel derivative chains
+    std::array<Container,2> m_tempN;
     Container m_minus, m_zero, m_plus;
     // Helper variables for compute_parallel_flux
     Container m_vbm, m_vbp, m_dN, m_dNMM, m_dNM, m_dNZ, m_dNP, m_dNPP;
@@ -604,6 +622,8 @@ struct Explicit
     Matrix m_dxF_N, m_dxB_N, m_dxF_U, m_dxB_U, m_dx_P, m_dx_A;
     Matrix m_dyF_N, m_dyB_N, m_dyF_U, m_dyB_U, m_dy_P, m_dy_A, m_dz;
     Matrix m_dxC, m_dyC;
+    // one-entry-per-row stencils over the nonzero mask points (region compaction)
+    IMatrix m_wall_stencil, m_sheath_stencil, m_penalization_stencil;
     dg::geo::Fieldaligned<Geometry, IMatrix, Container> m_fa, m_faST;
     dg::Elliptic3d< Geometry, Matrix, Container> m_lapperpN, m_lapperpU, m_lapperpP;
     std::vector<dg::Elliptic3d< Geometry, Matrix, Container> > m_multi_pol;
@@ -633,51 +653,48 @@ void Explicit<Grid, IMatrix, Matrix, Container>::construct_mag(
     )
 {
     //due to the various approximations bhat and mag not always correspond
-    dg::geo::CylindricalVectorLvl0 curvNabla, curvKappa;
     m_reversed_field = false;
     if( mag.ipol()( g.x0(), g.y0()) < 0)
         m_reversed_field = true;
+    int sign = m_reversed_field ? -1 : +1;
+    //evaluate each primitive flux function exactly once on the grid: the
+    //nested functors in dg::geo evaluate psip and its derivatives over and
+    //over when pulled back individually
+    feltor::MagneticFieldCache<Grid> cache( g, mag);
+    using host_vector = typename feltor::MagneticFieldCache<Grid>::host_vector;
+    std::array<host_vector,3> curvNabla, curvKappa;
     if( p.curvmode == "true" )
     {
-        curvNabla = dg::geo::createTrueCurvatureNablaB(mag);
-        curvKappa = dg::geo::createTrueCurvatureKappa(mag);
-        dg::assign(  dg::pullback(dg::geo::TrueDivCurvatureKappa(mag), g),
-            m_divCurvKappa);
+        curvNabla = cache.trueCurvatureNablaB();
+        curvKappa = cache.trueCurvatureKappa();
+        dg::assign( cache.trueDivCurvatureKappa(), m_divCurvKappa);
     }
     else if( p.curvmode == "low beta")
     {
-        if( m_reversed_field)
-            curvNabla = curvKappa = dg::geo::createCurvatureNablaB(mag, -1);
-        else
-            curvNabla = curvKappa = dg::geo::createCurvatureNablaB(mag, +1);
+        curvNabla = curvKappa = cache.curvatureNablaB( sign);
         dg::assign( dg::evaluate(dg::zero, g), m_divCurvKappa);
     }
     else if( p.curvmode == "toroidal")
     {
-        if( m_reversed_field)
-        {
-            curvNabla = dg::geo::createCurvatureNablaB(mag, -1);
-            curvKappa = dg::geo::createCurvatureKappa(mag, -1);
-            dg::assign(  dg::pullback(dg::geo::DivCurvatureKappa(mag, -1), g),
-                m_divCurvKappa);
-        }
-        else
-        {
-            curvNabla = dg::geo::createCurvatureNablaB(mag, +1);
-            curvKappa = dg::geo::createCurvatureKappa(mag, +1);
-            dg::assign(  dg::pullback(dg::geo::DivCurvatureKappa(mag, +1), g),
-                m_divCurvKappa);
-        }
+        curvNabla = cache.curvatureNablaB( sign);
+        curvKappa = cache.curvatureKappa( sign);
+        dg::assign( cache.divCurvatureKappa( sign), m_divCurvKappa);
     }
     else
         throw std::runtime_error( "Warning! curvmode value '"+p.curvmode+"' not recognized!! I don't know what to do! I exit!\n");
-    dg::pushForward(curvNabla.x(), curvNabla.y(), curvNabla.z(),
-        m_curv[0], m_curv[1], m_curv[2], g);
-    dg::pushForward(curvKappa.x(), curvKappa.y(), curvKappa.z(),
-        m_curvKappa[0], m_curvKappa[1], m_curvKappa[2], g);
+    //push forward the cached cylindrical components (cf. dg::pushForward)
+    dg::tensor::multiply3d( g.jacobian(), curvNabla[0], curvNabla[1],
+        curvNabla[2], curvNabla[0], curvNabla[1], curvNabla[2]);
+    dg::tensor::multiply3d( g.jacobian(), curvKappa[0], curvKappa[1],
+        curvKappa[2], curvKappa[0], curvKappa[1], curvKappa[2]);
+    for( int i=0; i<3; i++)
+    {
+        dg::assign( curvNabla[i], m_curv[i]);
+        dg::assign( curvKappa[i], m_curvKappa[i]);
+    }
     dg::blas1::axpby( 1., m_curvKappa, 1., m_curv);
-    dg::assign(  dg::pullback(dg::geo::InvB(mag), g), m_binv);
-    dg::assign(  dg::pullback(dg::geo::Divb(mag), g), m_divb);
+    dg::assign( cache.invB(), m_binv);
+    dg::assign( cache.divb(), m_divb);
 
 }
 template<class Grid, class IMatrix, class Matrix, class Container>
@@ -806,6 +823,7 @@ Explicit<Grid, IMatrix, Matrix, Container>::Explicit( const Grid& g,
     m_source = m_sheath_coordinate = m_UE2 = m_temp1 = m_temp0;
     m_apar = m_aparST = m_profne = m_wall = m_sheath = m_temp0;
     m_plus = m_zero = m_minus = m_temp0;
+    m_tempN[0] = m_tempN[1] = m_temp0;
     m_vbm = m_vbp = m_temp0;
     if( m_p.slope_limiter != "none")
         m_dN = m_dNMM = m_dNM = m_dNZ = m_dNP = m_dNPP = m_temp1;
@@ -816,6 +834,8 @@ Explicit<Grid, IMatrix, Matrix, Container>::Explicit( const Grid& g,
     m_divNUb = m_density = m_densityST = m_velocity = m_potential;
     m_velocityST = m_potentialST = m_potential;
     m_dsN = m_dsP = m_dsU = m_dssU = m_lapParU = m_lapParN = m_potential;
+    if( m_p.diff_lag > 1)
+        m_lagN = m_lagU = m_potential;
 
     m_dA[0] = m_dA[1] = m_dA[2] = m_temp0;
     m_dP[0] = m_dP[1] = m_dA;
@@ -826,6 +846,7 @@ Explicit<Grid, IMatrix, Matrix, Container>::Explicit( const Grid& g,
     construct_mag( g, p, mag);
     construct_bhat( g, p, mag);
     construct_invert( g, p, mag);
+    update_region_stencils(); //empty until set_wall / set_sheath are called
 }
 
 template<class Geometry, class IMatrix, class Matrix, class Container>
@@ -1046,17 +1067,17 @@ void Explicit<Geometry, IMatrix, Matrix, Container>::update_perp_derivatives(
     const std::array<Container,2>& potential,
     const Container& apar)
 {
-    for( unsigned i=0; i<2; i++)
+    for_each_species( [&]( int i)
     {
         ////////////////////perpendicular dynamics////////////////////////
         //First compute forward and backward derivatives for upwind scheme
-        dg::blas1::transform( density[i], m_temp1, dg::PLUS<double>(-m_p.nbc));
-        dg::blas2::symv( m_dxF_N, m_temp1, m_dFN[i][0]);
-        dg::blas2::symv( m_dyF_N, m_temp1, m_dFN[i][1]);
-        dg::blas2::symv( m_dxB_N, m_temp1, m_dBN[i][0]);
-        dg::blas2::symv( m_dyB_N, m_temp1, m_dBN[i][1]);
-        if(m_compute_in_3d) dg::blas2::symv( m_dz, m_temp1, m_dFN[i][2]);
-        if(m_compute_in_3d) dg::blas2::symv( m_dz, m_temp1, m_dBN[i][2]);
+        dg::blas1::transform( density[i], m_tempN[i], dg::PLUS<double>(-m_p.nbc));
+        dg::blas2::symv( m_dxF_N, m_tempN[i], m_dFN[i][0]);
+        dg::blas2::symv( m_dyF_N, m_tempN[i], m_dFN[i][1]);
+        dg::blas2::symv( m_dxB_N, m_tempN[i], m_dBN[i][0]);
+        dg::blas2::symv( m_dyB_N, m_tempN[i], m_dBN[i][1]);
+        if(m_compute_in_3d) dg::blas2::symv( m_dz, m_tempN[i], m_dFN[i][2]);
+        if(m_compute_in_3d) dg::blas2::symv( m_dz, m_tempN[i], m_dBN[i][2]);
         dg::blas2::symv( m_dxF_U, velocity[i], m_dFU[i][0]);
         dg::blas2::symv( m_dyF_U, velocity[i], m_dFU[i][1]);
         dg::blas2::symv( m_dxB_U, velocity[i], m_dBU[i][0]);
@@ -1066,10 +1087,11 @@ void Explicit<Geometry, IMatrix, Matrix, Container>::update_perp_derivatives(
         dg::blas2::symv( m_dx_P, potential[i], m_dP[i][0]);
         dg::blas2::symv( m_dy_P, potential[i], m_dP[i][1]);
         if( m_compute_in_3d) dg::blas2::symv( m_dz, potential[i], m_dP[i][2]);
-        dg::blas2::symv( m_dx_A, apar, m_dA[0]);
-        dg::blas2::symv( m_dy_A, apar, m_dA[1]);
-        if( m_compute_in_3d) dg::blas2::symv( m_dz, apar, m_dA[2]);
-    }
+    });
+    //the apar derivatives are species independent
+    dg::blas2::symv( m_dx_A, apar, m_dA[0]);
+    dg::blas2::symv( m_dy_A, apar, m_dA[1]);
+    if( m_compute_in_3d) dg::blas2::symv( m_dz, apar, m_dA[2]);
 }
 template<class Geometry, class IMatrix, class Matrix, class Container>
 void Explicit<Geometry, IMatrix, Matrix, Container>::update_staggered_density_and_phi(
@@ -1597,99 +1619,160 @@ void Explicit<Geometry, IMatrix, Matrix, Container>::add_source_terms(
     dg::blas1::axpby( 1., m_s, 1.0, yp);
 }
 template<class Geometry, class IMatrix, class Matrix, class Container>
+void Explicit<Geometry, IMatrix, Matrix, Container>::update_region_stencils()
+{
+    //The masks are zero on the vast majority of points, so we precompute
+    //index lists of the nonzero points ( as one-entry-per-row stencils) and
+    //restrict the wall and sheath kernels to them.  All columns are process
+    //local, which makes it safe to read and write the additional vector
+    //arguments of dg::blas2::stencil through the column indices.
+    dg::x::HVec wall, sheath;
+    dg::assign( m_wall, wall);
+    dg::assign( m_sheath, sheath);
+    m_wall_stencil = (IMatrix)dg::create::region_stencil( wall, grid());
+    m_sheath_stencil = (IMatrix)dg::create::region_stencil( sheath, grid());
+    //the rhs penalization multiplies by (1-wall-sheath) depending on flags
+    if( !m_p.penalize_wall)
+        dg::blas1::scal( wall, 0.);
+    if( m_p.penalize_sheath)
+        dg::blas1::axpby( 1., sheath, 1., wall);
+    m_penalization_stencil = (IMatrix)dg::create::region_stencil( wall, grid());
+}
+template<class Geometry, class IMatrix, class Matrix, class Container>
 void Explicit<Geometry, IMatrix, Matrix, Container>::multiply_rhs_penalization(
         Container& yp)
 {
     //mask right hand side in penalization region
-    if( m_p.penalize_wall && m_p.penalize_sheath)
-    {
-        dg::blas1::subroutine( []DG_DEVICE(
-            double& rhs, double wall, double sheath){
-                rhs *= (1.0-wall-sheath);
-            }, yp, m_wall, m_sheath);
-    }
-    else if( m_p.penalize_wall)
-    {
-        dg::blas1::subroutine( []DG_DEVICE( double& rhs, double wall){
-                rhs *= (1.0-wall); }, yp, m_wall);
-    }
-    else if( m_p.penalize_sheath)
-    {
-        dg::blas1::subroutine( []DG_DEVICE( double& rhs, double sheath){
-                rhs *= (1.0-sheath); }, yp, m_sheath);
-    }
+    //the stencil values hold wall+sheath and visit only the nonzero points
+    if( !m_p.penalize_wall && !m_p.penalize_sheath)
+        return;
+    dg::blas2::stencil( []DG_DEVICE( unsigned i, const int* row_offsets,
+        const int* column_indices, const double* values, const double*,
+        double* rhs)
+        {
+            for( int k=row_offsets[i]; k<row_offsets[i+1]; k++)
+                rhs[column_indices[k]] *= (1.0-values[k]);
+        }, m_penalization_stencil, yp, yp);
 }
 template<class Geometry, class IMatrix, class Matrix, class Container>
 void Explicit<Geometry, IMatrix, Matrix, Container>::add_wall_and_sheath_terms(
         std::array<std::array<Container,2>,2>& yp)
 {
+    //All terms vanish outside the masks, so the kernels run over the
+    //compacted stencils only; the stencil values hold the mask values
     // add sheath boundary conditions
     if( m_sheath_rate != 0)
     {
+        double sheath_rate = m_sheath_rate;
         ////density
         ////Here, we need to find out where "downstream" is
         //!! Simulations does not really work without
+        auto upwind = [sheath_rate]DG_DEVICE( unsigned r, const int* ro,
+            const int* ci, const double* va, const double* coord,
+            const double* backward, const double* forward, double* rhs)
+        {
+            for( int k=ro[r]; k<ro[r+1]; k++)
+            {
+                int j = ci[k];
+                rhs[j] += sheath_rate*va[k]*
+                    ( coord[j] >= 0 ? backward[j] : forward[j]);
+            }
+        };
         for( unsigned i=0; i<2; i++)
         {
             //The coordinate automatically sees the reversed field
             //but m_plus and m_minus are defined wrt the angle coordinate
             if( m_reversed_field) //bphi negative (exchange + and -)
-                dg::blas1::evaluate( m_temp0, dg::equals(), dg::Upwind(),
-                     m_sheath_coordinate, m_plusN[i], m_minusN[i]);
+                dg::blas2::stencil( upwind, m_sheath_stencil,
+                     m_sheath_coordinate, m_plusN[i], m_minusN[i], yp[0][i]);
             else
-                dg::blas1::evaluate( m_temp0, dg::equals(), dg::Upwind(),
-                     m_sheath_coordinate, m_minusN[i], m_plusN[i]);
-            dg::blas1::pointwiseDot( m_sheath_rate, m_temp0, m_sheath, 1.,
-                    yp[0][i]);
+                dg::blas2::stencil( upwind, m_sheath_stencil,
+                     m_sheath_coordinate, m_minusN[i], m_plusN[i], yp[0][i]);
         }
         //compute sheath velocity
         if( "wall" == m_p.sheath_bc)
         {
+            double uwall = m_uwall;
             for( unsigned i=0; i<2; i++)
             {
-                //dg::blas1::axpby( +m_sheath_rate*m_nwall, m_sheath, 1., yp[0][i] );
-                dg::blas1::axpby( +m_sheath_rate*m_uwall, m_sheath, 1., yp[1][i] );
+                //yp[1][i] += sheath_rate*uwall*sheath
+                dg::blas2::stencil( [sheath_rate, uwall]DG_DEVICE( unsigned r,
+                    const int* ro, const int* ci, const double* va,
+                    const double*, double* rhs)
+                {
+                    for( int k=ro[r]; k<ro[r+1]; k++)
+                        rhs[ci[k]] += sheath_rate*uwall*va[k];
+                }, m_sheath_stencil, yp[1][i], yp[1][i]);
             }
         }
         else
         {
             //velocity c_s
-            double cs = sqrt(1.+m_p.tau[1]), sheath_rate = m_sheath_rate;
+            double cs = sqrt(1.+m_p.tau[1]);
             if( "insulating" == m_p.sheath_bc)
             {
                 // u_e,sh = s*sqrt(1+tau) Ni/ne
-                dg::blas1::evaluate( yp[1][0], dg::plus_equals(),
-                        [cs, sheath_rate]DG_DEVICE( double sheath_coord, double
-                            sheath, double ne, double ni) {
-                            return cs*sheath_rate*sheath_coord*ni/ne*sheath;
-                        },
-                        m_sheath_coordinate, m_sheath, m_densityST[0],
-                        m_densityST[1]);
+                dg::blas2::stencil( [cs, sheath_rate]DG_DEVICE( unsigned r,
+                    const int* ro, const int* ci, const double* va,
+                    const double* coord, const double* ne, const double* ni,
+                    double* rhs)
+                {
+                    for( int k=ro[r]; k<ro[r+1]; k++)
+                    {
+                        int j = ci[k];
+                        rhs[j] += cs*sheath_rate*coord[j]*ni[j]/ne[j]*va[k];
+                    }
+                }, m_sheath_stencil, m_sheath_coordinate, m_densityST[0],
+                    m_densityST[1], yp[1][0]);
             }
             else // "bohm" == m_p.sheath_bc
             {
                 //u_e,sh = s*1/sqrt(|mu_e|2pi) exp(-phi)
                 double mue = fabs(m_p.mu[0]), tau = m_p.tau[1];
-                dg::blas1::evaluate( yp[1][0], dg::plus_equals(),
-                    [mue, sheath_rate, tau]DG_DEVICE(
-                        double sheath_coord, double sheath, double phi) {
-                        return sheath_rate * sheath_coord * sheath *
-                            sqrt(1.+tau) * exp(-phi) / sqrt( mue*2.*M_PI);
-                    },
-                    m_sheath_coordinate, m_sheath, m_potentialST[0]);
+                dg::blas2::stencil( [mue, sheath_rate, tau]DG_DEVICE(
+                    unsigned r, const int* ro, const int* ci,
+                    const double* va, const double* coord, const double* phi,
+                    double* rhs)
+                {
+                    for( int k=ro[r]; k<ro[r+1]; k++)
+                    {
+                        int j = ci[k];
+                        rhs[j] += sheath_rate * coord[j] * va[k] *
+                            sqrt(1.+tau) * exp(-phi[j]) / sqrt( mue*2.*M_PI);
+                    }
+                }, m_sheath_stencil, m_sheath_coordinate, m_potentialST[0],
+                    yp[1][0]);
             }
             // u_i,sh = s*sqrt(1+tau)
-            dg::blas1::pointwiseDot( sheath_rate*cs,
-                    m_sheath, m_sheath_coordinate, 1.,  yp[1][1]);
+            dg::blas2::stencil( [cs, sheath_rate]DG_DEVICE( unsigned r,
+                const int* ro, const int* ci, const double* va,
+                const double* coord, double* rhs)
+            {
+                for( int k=ro[r]; k<ro[r+1]; k++)
+                {
+                    int j = ci[k];
+                    rhs[j] += sheath_rate*cs*coord[j]*va[k];
+                }
+            }, m_sheath_stencil, m_sheath_coordinate, yp[1][1]);
         }
     }
     // add wall boundary conditions
     if( m_wall_rate != 0)
     {
+        double wall_rate = m_wall_rate, nwall = m_nwall, uwall = m_uwall;
         for( unsigned i=0; i<2; i++)
         {
-            dg::blas1::axpby( +m_wall_rate*m_nwall, m_wall, 1., yp[0][i] );
-            dg::blas1::axpby( +m_wall_rate*m_uwall, m_wall, 1., yp[1][i] );
+            //yp[0][i] += wall_rate*nwall*wall; yp[1][i] += wall_rate*uwall*wall
+            dg::blas2::stencil( [wall_rate, nwall, uwall]DG_DEVICE( unsigned r,
+                const int* ro, const int* ci, const double* va, const double*,
+                double* rhsN, double* rhsU)
+            {
+                for( int k=ro[r]; k<ro[r+1]; k++)
+                {
+                    rhsN[ci[k]] += wall_rate*nwall*va[k];
+                    rhsU[ci[k]] += wall_rate*uwall*va[k];
+                }
+            }, m_wall_stencil, yp[0][i], yp[0][i], yp[1][i]);
         }
     }
 }
@@ -1846,9 +1929,25 @@ void Explicit<Geometry, IMatrix, Matrix, Container>::add_implicit_density(
     std::array<Container,2>& yp)
 {
 #if FELTORPERP == 1
-    for( unsigned i=0; i<2; i++)
-        compute_perp_diffusiveN( 1., density[i], m_temp0,
-                m_temp1, beta, yp[i]);
+    if( m_p.diff_lag > 1 && !m_p.partitioned)
+    {
+        // Lagged evaluation: the hyperdiffusive terms change slowly, so we
+        // evaluate them only every diff_lag RHS calls and reuse the result.
+        // The embedded error estimate of an adaptive stepper monitors the
+        // splitting error and reduces the timestep if the lag is too long.
+        m_lag_due = ( m_lag_counter % m_p.diff_lag == 0);
+        m_lag_counter++;
+        if( m_lag_due)
+            for( unsigned i=0; i<2; i++)
+                compute_perp_diffusiveN( 1., density[i], m_temp0,
+                        m_temp1, 0., m_lagN[i]);
+        for( unsigned i=0; i<2; i++)
+            dg::blas1::axpby( 1., m_lagN[i], beta, yp[i]);
+    }
+    else
+        for( unsigned i=0; i<2; i++)
+            compute_perp_diffusiveN( 1., density[i], m_temp0,
+                    m_temp1, beta, yp[i]);
 #else
     dg::blas1::scal( yp, beta);
 #endif
@@ -1882,11 +1981,23 @@ void Explicit<Geometry, IMatrix, Matrix, Container>::add_implicit_velocityST(
     // velocityST[0] := u_e^dagger
     // velocityST[1] := U_i^dagger
 #if FELTORPERP == 1
-    for( unsigned i=0; i<2; i++)
+    if( m_p.diff_lag > 1 && !m_p.partitioned)
     {
-        compute_perp_diffusiveU( 1., velocityST[i], densityST[i], m_temp0,
-                m_temp1, m_dFU[i][0], m_dFU[i][1], beta, yp[i]);
+        // reuse the decision of add_implicit_density, which is always
+        // called first in the explicit timestepper
+        if( m_lag_due)
+            for( unsigned i=0; i<2; i++)
+                compute_perp_diffusiveU( 1., velocityST[i], densityST[i],
+                        m_temp0, m_temp1, m_dFU[i][0], m_dFU[i][1], 0., m_lagU[i]);
+        for( unsigned i=0; i<2; i++)
+            dg::blas1::axpby( 1., m_lagU[i], beta, yp[i]);
     }
+    else
+        for( unsigned i=0; i<2; i++)
+        {
+            compute_perp_diffusiveU( 1., velocityST[i], densityST[i], m_temp0,
+                    m_temp1, m_dFU[i][0], m_dFU[i][1], beta, yp[i]);
+        }
 #else
     dg::blas1::scal( yp, beta);
 #endif
@@ -312,7 +312,7 @@ int main( int argc, char* argv[])
     std::string fsa_mode = config.get( "fsa", "convoluted-toroidal-average").asString();
 
     auto bhat = dg::geo::createBHat( mod_mag);
-    dg::geo::Fieldaligned<dg::CylindricalGrid3d, dg::IDMatrix, dg::DVec> fieldaligned;
+    dg::geo::Fieldaligned<dg::CylindricalGrid3d, dg::IEllMatrix, dg::DVec> fieldaligned;
     if( fsa_mode == "convoluted-toroidal-average" || diag_list["cta2d"].exists
             || diag_list["cta2dX"].exists)
     {
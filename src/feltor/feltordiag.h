@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <set>
 #include <string>
 #include <vector>
 #include <functional>
@@ -93,14 +95,14 @@ struct Positive
 //From here on, we use the typedefs to ease the notation
 
 struct Variables{
-    feltor::Explicit<dg::x::CylindricalGrid3d, dg::x::IDMatrix, dg::x::DMatrix, dg::x::DVec>& f;
-    std::array<std::array<dg::x::DVec,2>,2>& y0;
+    feltor::Explicit<dg::x::CylindricalGrid3d, feltor::x::IEllMatrix, feltor::x::DMatrix, feltor::x::DVec>& f;
+    std::array<std::array<feltor::x::DVec,2>,2>& y0;
     feltor::Parameters p;
     dg::geo::TokamakMagneticField mag;
-    const std::array<dg::x::DVec, 3>& gradPsip;
-    std::array<dg::x::DVec, 3> tmp;
-    std::array<dg::x::DVec, 3> tmp2;
-    std::array<dg::x::DVec, 3> tmp3;
+    const std::array<feltor::x::DVec, 3>& gradPsip;
+    std::array<feltor::x::DVec, 3> tmp;
+    std::array<feltor::x::DVec, 3> tmp2;
+    std::array<feltor::x::DVec, 3> tmp3;
     double duration;
     const unsigned* nfailed;
 };
@@ -109,7 +111,10 @@ struct Record{
     std::string name;
     std::string long_name;
     bool integral; //indicates whether the function should be time-integrated
-    std::function<void( dg::x::DVec&, Variables&)> function;
+    std::function<void( feltor::x::DVec&, Variables&)> function;
+    //additional compression of the output grid on top of output: compression
+    //(3d lists only); records with the same factor share grid and dimensions
+    unsigned compression = 1;
 };
 
 struct Record1d{
@@ -191,32 +196,32 @@ std::array<std::tuple<std::string, std::string, dg::x::HVec>, 3> generate_cyl2ca
 // Here are all 3d outputs we want to have
 std::vector<Record> diagnostics3d_list = { // 6
     {"electrons", "electron density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.density(0), result);
         }
     },
     {"ions", "ion density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.density(1), result);
         }
     },
     {"Ue", "parallel electron velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.velocity(0), result);
         }
     },
     {"Ui", "parallel ion velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.velocity(1), result);
         }
     },
     {"potential", "electric potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.potential(0), result);
         }
     },
     {"aparallel", "parallel magnetic potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.aparallel(), result);
         }
     }
@@ -408,88 +413,88 @@ std::vector<Record_static> diagnostics2d_static_list = {
 // and here are all the 2d outputs we want to produce (currently ~ 150)
 std::vector<Record> basicDiagnostics2d_list = { // 22
     {"electrons", "Electron density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.density(0), result);
         }
     },
     {"ions", "Ion gyro-centre density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.density(1), result);
         }
     },
     {"Ue", "Electron parallel velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.velocity(0), result);
         }
     },
     {"Ui", "Ion parallel velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.velocity(1), result);
         }
     },
     {"potential", "Electric potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.potential(0), result);
         }
     },
     {"psi", "Ion potential psi", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.potential(1), result);
         }
     },
     {"aparallel", "Magnetic potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.aparallel(), result);
         }
     },
     {"gammaNi", "Gamma Ni", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.gammaNi(), result);
         }
     },
     {"gammaPhi", "Gamma Phi", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.gammaPhi(), result);
         }
     },
     /// -----------------Miscellaneous additions --------------------//
     {"vorticity", "Minus Lap_perp of electric potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // has no jump terms
             v.f.compute_lapMperpP(0, result);
         }
     },
     {"vorticity_i", "Minus Lap_perp of ion potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // has no jump terms
             v.f.compute_lapMperpP(1, result);
         }
     },
     {"laplace_ne", "Positive Lap_perp of electron density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_lapMperpN(-1.0, v.f.density(0), v.tmp[0], 0., result);
         }
     },
     {"laplace_ni", "Positive Lap_perp of ion density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_lapMperpN(-1.0, v.f.density(1), v.tmp[0], 0., result);
         }
     },
     // Does not work due to direct application of Laplace
     // The Laplacian of Aparallel looks smooth in paraview
     {"apar_vorticity", "Minus Lap_perp of magnetic potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_lapMperpA( result);
         }
     },
     {"dssue", "2nd parallel derivative of electron velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::copy( v.f.dssU( 0), result);
         }
     },
     {"lperpinv", "Perpendicular density gradient length scale", false,
-        []( dg::x::DVec& result, Variables& v ) {
-            const std::array<dg::x::DVec, 3>& dN = v.f.gradN(0);
+        []( feltor::x::DVec& result, Variables& v ) {
+            const std::array<feltor::x::DVec, 3>& dN = v.f.gradN(0);
             dg::blas1::pointwiseDivide( 1., v.f.density(0), v.tmp[0]);
             dg::tensor::scalar_product3d( 1., v.tmp[0],
                 dN[0], dN[1], dN[2], v.f.projection(), v.tmp[0], //grad_perp
@@ -498,8 +503,8 @@ std::vector<Record> basicDiagnostics2d_list = { // 22
         }
     },
     {"perpaligned", "Perpendicular density alignement", false,
-        []( dg::x::DVec& result, Variables& v ) {
-            const std::array<dg::x::DVec, 3>& dN = v.f.gradN(0);
+        []( feltor::x::DVec& result, Variables& v ) {
+            const std::array<feltor::x::DVec, 3>& dN = v.f.gradN(0);
             dg::tensor::scalar_product3d( 1., 1.,
                 dN[0], dN[1], dN[2], v.f.projection(), 1., //grad_perp
                 dN[0], dN[1], dN[2], 0., result); // (grad N)**2
@@ -507,33 +512,33 @@ std::vector<Record> basicDiagnostics2d_list = { // 22
         }
     },
     {"lparallelinv", "Parallel density gradient length scale", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDivide( v.f.dsN(0), v.f.density(0), result);
             dg::blas1::pointwiseDot ( result, result, result);
             dg::blas1::transform( result, result, dg::SQRT<double>());
         }
     },
     {"aligned", "Parallel density alignement", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot ( v.f.dsN(0), v.f.dsN(0), result);
             dg::blas1::pointwiseDivide( result, v.f.density(0), result);
         }
     },
     /// ------------------ Correlation terms --------------------//
     {"ne2", "Square of electron density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot(
                 v.f.density(0), v.f.density(0), result);
         }
     },
     {"phi2", "Square of electron potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot(
                 v.f.potential(0), v.f.potential(0), result);
         }
     },
     {"nephi", "Product of electron potential and electron density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot(
                 v.f.potential(0), v.f.density(0), result);
         }
@@ -544,32 +549,32 @@ std::vector<Record> MassConsDiagnostics2d_list = { // 26
     /// ------------------ Density terms ------------------------//
     ////////////////// electron particle flux /////////////////////
     {"jsneE_tt", "Radial electron particle flux: ExB contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, result);
             dg::blas1::pointwiseDot( result, v.f.density(0), result);
         }
     },
     {"divneE_tt", "Divergence of ExB electron particle flux (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.f.curv(), v.f.gradP(0), result);
             dg::blas1::pointwiseDot( result, v.f.density(0), result);
             routines::jacobian( 1., v.f.bhatgB(), v.f.gradP(0), v.f.gradN(0), 1., result);
         }
     },
     {"jscurvne_tt", "Radial electron particle flux: curvature contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             routines::dot( v.f.curv(), v.gradPsip, result);
             dg::blas1::pointwiseDot( v.p.tau[0], v.f.density(0), result, 0., result);
         }
     },
     {"divcurvne_tt", "Divergence of curvature term (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.p.tau[0], v.f.curv(), v.f.gradN(0), 0., result);
         }
     },
     {"jscurvkappane_tt", "Radial electron particle flux: curvature contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( v.p.mu[0], v.f.density(0), v.f.velocity(0),
                     v.f.velocity(0), 0., result);
             routines::dot( v.f.curvKappa(), v.gradPsip, v.tmp[0]);
@@ -577,82 +582,82 @@ std::vector<Record> MassConsDiagnostics2d_list = { // 26
         }
     },
     {"divcurvkappane_tt", "Divergence of curvature term (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             dg::blas1::pointwiseDot( v.p.mu[0], v.f.density(0), v.f.velocity(0),
                     v.f.velocity(0), 0., v.tmp3[0]);
             v.f.centered_div( v.tmp3[0], v.f.curvKappa(), v.tmp2[0], result);
         }
     },
     {"jsneA_tt", "Radial electron particle flux: magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_bperp(v.tmp);
             routines::dot( v.tmp, v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., v.f.density(0), v.f.velocity(0), result, 0., result);
         }
     },
     {"divneA_tt", "Divergence of magnetic flutter electron particle flux (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             dg::blas1::pointwiseDot( v.f.density(0), v.f.velocity(0), v.tmp3[0]);
             v.f.compute_bperp(v.tmp);
             v.f.centered_div( v.tmp3[0], v.tmp, v.tmp2[0], result);
         }
     },
     {"jsdiae_tt", "Radial electron particle flux: diamagnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // u_D Dot GradPsi
             routines::jacobian( v.p.tau[0], v.f.bhatgB(), v.f.gradN(0), v.gradPsip, 0., result);
         }
     },
     {"lneperp_tt", "Perpendicular electron diffusion (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_perp_diffusiveN( 1., v.f.density(0), v.tmp[0],
                     v.tmp[1], 0., result);
         }
     },
     {"lneparallel_tt", "Parallel electron diffusion (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::axpby( v.p.nu_parallel_n, v.f.lapParN(0), 0., result);
         }
     },
     {"sne_tt", "Source term for electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::copy( v.f.density_source(0), result);
         }
     },
     {"divjnepar_tt", "Divergence of Parallel velocity term for electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::copy( v.f.divNUb(0), result);
         }
     },
     /// ------------------ Density terms ------------------------//
     //////////////////// ion particle flux ////////////////////////
     {"jsniE_tt", "Radial ion particle flux: ExB contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(1), v.gradPsip, result);
             dg::blas1::pointwiseDot( result, v.f.density(1), result);
         }
     },
     {"divniE_tt", "Divergence of ExB ion particle flux (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.f.curv(), v.f.gradP(1), result);
             dg::blas1::pointwiseDot( result, v.f.density(1), result);
             routines::jacobian( 1., v.f.bhatgB(), v.f.gradP(1), v.f.gradN(1), 1., result);
         }
     },
     {"jscurvni_tt", "Radial ion particle flux: curvature contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             routines::dot( v.f.curv(), v.gradPsip, result);
             dg::blas1::pointwiseDot( v.p.tau[1], v.f.density(1), result, 0., result);
         }
     },
     {"divcurvni_tt", "Divergence of curvature term (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.p.tau[1], v.f.curv(), v.f.gradN(1), 0., result);
         }
     },
     {"jscurvkappani_tt", "Radial ion particle flux: curvature contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.density(1), v.f.velocity(1),
                     v.f.velocity(1), 0., result);
             routines::dot( v.f.curvKappa(), v.gradPsip, v.tmp[0]);
@@ -660,50 +665,50 @@ std::vector<Record> MassConsDiagnostics2d_list = { // 26
         }
     },
     {"divcurvkappani_tt", "Divergence of curvature term (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.density(1), v.f.velocity(1),
                     v.f.velocity(1), 0., v.tmp3[0]);
             v.f.centered_div( v.tmp3[0], v.f.curvKappa(), v.tmp2[0], result);
         }
     },
     {"jsniA_tt", "Radial ion particle flux: magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_bperp(v.tmp);
             routines::dot( v.tmp, v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., v.f.density(1), v.f.velocity(1), result, 0., result);
         }
     },
     {"divniA_tt", "Divergence of magnetic flutter ion particle flux (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             dg::blas1::pointwiseDot( v.f.density(1), v.f.velocity(1), v.tmp3[0]);
             v.f.compute_bperp(v.tmp);
             v.f.centered_div( v.tmp3[0], v.tmp, v.tmp2[0], result);
         }
     },
     {"jsdiai_tt", "Radial ion particle flux: diamagnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // u_D Dot GradPsi
             routines::jacobian( v.p.tau[1], v.f.bhatgB(), v.f.gradN(1), v.gradPsip, 0., result);
         }
     },
     {"lniperp_tt", "Perpendicular ion diffusion (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_perp_diffusiveN( 1., v.f.density(1), v.tmp[0],
                     v.tmp[1], 0., result);
         }
     },
     {"lniparallel_tt", "Parallel ion diffusion (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::axpby( v.p.nu_parallel_n, v.f.lapParN(1), 0., result);
         }
     },
     {"sni_tt", "Source term for ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::copy( v.f.density_source(1), result);
         }
     },
     {"divjnipar_tt", "Divergence of Parallel velocity term in ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::copy( v.f.divNUb(1), result);
         }
     }
@@ -712,19 +717,19 @@ std::vector<Record> MassConsDiagnostics2d_list = { // 26
 std::vector<Record> EnergyDiagnostics2d_list = { // 23
     /// ------------------- Energy terms ------------------------//
     {"nelnne", "Entropy electrons", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::transform( v.f.density(0), result, PositiveLN());
             dg::blas1::pointwiseDot( result, v.f.density(0), result);
         }
     },
     {"nilnni", "Entropy ions", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::transform( v.f.density(1), result, PositiveLN());
             dg::blas1::pointwiseDot( v.p.tau[1], result, v.f.density(1), 0., result);
         }
     },
     {"aperp2", "Magnetic energy", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             if( v.p.beta == 0) // avoid divison by zero
             {
                 dg::blas1::scal( result, 0.);
@@ -739,25 +744,25 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"ue2", "ExB energy", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( 0.5, v.f.density(1), v.f.uE2(), 0., result);
         }
     },
     {"neue2", "Parallel electron energy", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( -0.5*v.p.mu[0], v.f.density(0),
                 v.f.velocity(0), v.f.velocity(0), 0., result);
         }
     },
     {"niui2", "Parallel ion energy", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( 0.5*v.p.mu[1], v.f.density(1),
                 v.f.velocity(1), v.f.velocity(1), 0., result);
         }
     },
     /// ------------------- Energy dissipation ----------------------//
     {"resistivity_tt", "Energy dissipation through resistivity (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( 1., v.f.velocity(1), v.f.density(0), -1.,
                     v.f.velocity(0), v.f.density(0), 0., v.tmp[0]);
             dg::blas1::pointwiseDot( 1., v.f.velocity(1), v.f.density(1), -1.,
@@ -766,7 +771,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"see_tt", "Energy sink/source for electrons", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::evaluate( result, dg::equals(),
                 RadialEnergyFlux( v.p.tau[0], v.p.mu[0], -1.),
                 v.f.density(0), v.f.velocity(0), v.f.potential(0),
@@ -775,7 +780,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"sei_tt", "Energy sink/source for ions", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::evaluate( result, dg::equals(),
                 RadialEnergyFlux( v.p.tau[1], v.p.mu[1], 1.),
                 v.f.density(1), v.f.velocity(1), v.f.potential(1),
@@ -785,7 +790,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
     },
     /// ------------------ Energy flux terms ------------------------//
     {"jsee_tt", "Radial electron energy flux without magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[0], v.p.mu[0], -1.),
                 v.f.density(0), v.f.velocity(0), v.f.potential(0),
@@ -799,7 +804,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"jseea_tt", "Radial electron energy flux: magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[0], v.p.mu[0], -1.),
                 v.f.density(0), v.f.velocity(0), v.f.potential(0), v.f.aparallel(),
@@ -812,7 +817,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"jsei_tt", "Radial ion energy flux without magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[1], v.p.mu[1], 1.),
                 v.f.density(1), v.f.velocity(1), v.f.potential(1),
@@ -826,7 +831,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"jseia_tt", "Radial ion energy flux: magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[1], v.p.mu[1], 1.),
                 v.f.density(1), v.f.velocity(1), v.f.potential(1), v.f.aparallel(),
@@ -839,7 +844,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"divee_tt", "Radial electron energy flux without magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[0], v.p.mu[0], -1.),
                 v.f.density(0), v.f.velocity(0), v.f.potential(0),
@@ -853,7 +858,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"diveea_tt", "Radial electron energy flux: magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[0], v.p.mu[0], -1.),
                 v.f.density(0), v.f.velocity(0), v.f.potential(0), v.f.aparallel(),
@@ -866,7 +871,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"divei_tt", "Radial ion energy flux without magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[1], v.p.mu[1], 1.),
                 v.f.density(1), v.f.velocity(1), v.f.potential(1),
@@ -880,7 +885,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"diveia_tt", "Radial ion energy flux: magnetic contribution (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::subroutine(
                 RadialEnergyFlux( v.p.tau[1], v.p.mu[1], 1.),
                 v.f.density(1), v.f.velocity(1), v.f.potential(1), v.f.aparallel(),
@@ -894,7 +899,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
     },
     /// ------------------------ Energy dissipation terms ------------------//
     {"leeperp_tt", "Perpendicular electron energy dissipation (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_perp_diffusiveN( 1., v.f.density(0), v.tmp3[0], v.tmp3[1],
                     0., v.tmp[0]);
             v.f.compute_perp_diffusiveU( 1., v.f.velocity(0), v.f.density(0),
@@ -907,7 +912,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"leiperp_tt", "Perpendicular ion energy dissipation (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_perp_diffusiveN( 1., v.f.density(1), v.tmp3[0], v.tmp3[1],
                     0., v.tmp[0]);
             v.f.compute_perp_diffusiveU( 1., v.f.velocity(1), v.f.density(1),
@@ -920,7 +925,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"leeparallel_tt", "Parallel electron energy dissipation (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::axpby( v.p.nu_parallel_n, v.f.lapParN(0), 0., v.tmp[0]);
             dg::blas1::pointwiseDot( v.p.nu_parallel_n, v.f.dsN(0), v.f.dsU(0),
                     0., v.tmp[1]);
@@ -935,7 +940,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"leiparallel_tt", "Parallel ion energy dissipation (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::axpby( v.p.nu_parallel_n, v.f.lapParN(1), 0., v.tmp[0]);
             dg::blas1::pointwiseDot( v.p.nu_parallel_n, v.f.dsN(1), v.f.dsU(1),
                     0., v.tmp[1]);
@@ -950,7 +955,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"divjeepar_tt", "Divergence of Parallel electron energy flux (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // Multiply out divNUb to get implementable form
             double z = -1.;
             dg::blas1::evaluate( result, dg::equals(),
@@ -968,7 +973,7 @@ std::vector<Record> EnergyDiagnostics2d_list = { // 23
         }
     },
     {"divjeipar_tt", "Divergence of Parallel ion energy flux (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             // Multiply out divNUb to get implementable form
             double z = +1.;
             dg::blas1::evaluate( result, dg::equals(),
@@ -991,20 +996,20 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
     /// ------------------------ Vorticity terms ---------------------------//
     /// ----------------------with ion density -------------------------///
     {"oexbi", "ExB vorticity term with ion density", false,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.f.gradP(0), v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., result, v.f.binv(), v.f.binv(), 0., result);
             dg::blas1::pointwiseDot( v.p.mu[1], result, v.f.density(1), 0., result);
         }
     },
     {"odiai", "Diamagnetic vorticity term with ion density", false,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.f.gradN(1), v.gradPsip, result);
             dg::blas1::scal( result, v.p.mu[1]*v.p.tau[1]);
         }
     },
     {"jsoexbi_tt", "ExB vorticity flux term with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, v.tmp[0]);
 
@@ -1018,7 +1023,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divoexbi_tt", "ExB vorticity flux term with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
 
@@ -1032,7 +1037,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"jsoexbiUD_tt", "ExB vorticity flux term by diamagnetic velocity with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // bxGradN/B Dot GradPsi
             routines::jacobian( v.p.tau[1], v.f.bhatgB(), v.f.gradN(1), v.gradPsip, 0., result);
 
@@ -1045,7 +1050,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divoexbiUD_tt", "ExB vorticity flux term by diamagnetic velocity with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::times( v.f.bhatgB(), v.f.gradN(1), v.tmp);
 
             // Omega_E
@@ -1057,7 +1062,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"jsodiaiUE_tt", "Diamagnetic vorticity flux by ExB veloctiy term with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, result);
 
@@ -1069,7 +1074,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divodiaiUE_tt", "Diamagnetic vorticity flux by ExB veloctiy term with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB
             routines::times( v.f.bhatgB(), v.f.gradP(0), v.tmp);
 
@@ -1082,20 +1087,20 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
     },
     /// ----------------------with electron density --------------------///
     {"oexbe", "ExB vorticity term with electron density", false,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.f.gradP(0), v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., result, v.f.binv(), v.f.binv(), 0., result);
             dg::blas1::pointwiseDot( v.p.mu[1], result, v.f.density(0), 0., result);
         }
     },
     {"odiae", "Diamagnetic vorticity term with electron density", false,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.f.gradN(0), v.gradPsip, result);
             dg::blas1::scal( result, v.p.mu[1]*v.p.tau[1]);
         }
     },
     {"jsoexbe_tt", "ExB vorticity flux term with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, v.tmp[0]);
 
@@ -1109,7 +1114,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divoexbe_tt", "ExB vorticity flux term with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
 
@@ -1123,7 +1128,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"jsoexbeUD_tt", "ExB vorticity flux term by diamagnetic velocity with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // bxGradN/B Dot GradPsi
             routines::jacobian( v.p.tau[1], v.f.bhatgB(), v.f.gradN(0), v.gradPsip, 0., result);
 
@@ -1136,7 +1141,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divoexbeUD_tt", "ExB vorticity flux term by diamagnetic velocity with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::times( v.f.bhatgB(), v.f.gradN(0), v.tmp);
 
             // Omega_E
@@ -1148,7 +1153,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"jsodiaeUE_tt", "Diamagnetic vorticity flux by ExB velocity term with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, result);
 
@@ -1160,7 +1165,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divodiaeUE_tt", "Diamagnetic vorticity flux by ExB veloctiy term with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB
             routines::times( v.f.bhatgB(), v.f.gradP(0), v.tmp);
 
@@ -1173,7 +1178,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
     },
     /// ----------------------Remainders--------------------------------///
     {"jsoApar_tt", "A parallel vorticity flux term (Maxwell stress) (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             if( v.p.beta == 0) // avoid division by zero
             {
                 dg::blas1::scal( result, 0.);
@@ -1187,7 +1192,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"divoApar_tt", "A parallel vorticity flux term (Maxwell stress) (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             if( v.p.beta == 0) // avoid division by zero
             {
                 dg::blas1::scal( result, 0.);
@@ -1201,7 +1206,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"jsodiaApar_tt", "A parallel diamagnetic vorticity flux term (magnetization stress) (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.gradPsip, v.f.gradU(1), v.tmp[0]);
             routines::dot( v.gradPsip, v.f.gradN(1), v.tmp[1]);
             dg::blas1::pointwiseDot( 1., v.tmp[0], v.f.density(1), 1., v.tmp[0], v.f.velocity(1), 0., result);
@@ -1211,7 +1216,7 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"jsoexbApar_tt", "A parallel ExB vorticity flux term (magnetization stress) (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::jacobian( v.f.bhatgB(), v.f.gradU(1), v.gradPsip, v.tmp[0]);
             routines::jacobian( v.f.bhatgB(), v.f.gradN(1), v.gradPsip, v.tmp[1]);
             dg::blas1::pointwiseDot( 1., v.tmp[0], v.f.density(1), 1., v.tmp[1], v.f.velocity(1), 0., result);
@@ -1220,46 +1225,46 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
         }
     },
     {"socurve_tt", "Vorticity source term electron curvature (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.f.curv(), v.gradPsip, result);
             dg::blas1::pointwiseDot( -v.p.tau[0], v.f.density(0), result, 0., result);
         }
     },
     {"socurvi_tt", "Vorticity source term ion curvature (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.f.curv(), v.gradPsip, result);
             dg::blas1::pointwiseDot( v.p.tau[1], v.f.density(1), result, 0., result);
         }
     },
     {"socurvkappae_tt", "Vorticity source term electron kappa curvature (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.f.curvKappa(), v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., v.f.density(0), v.f.velocity(0), v.f.velocity(0), 0., v.tmp[0]);
             dg::blas1::pointwiseDot( -v.p.mu[0], v.tmp[0], result, 0., result);
         }
     },
     {"socurvkappai_tt", "Vorticity source term ion kappa curvature (Time average)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             routines::dot( v.f.curvKappa(), v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., v.f.density(1), v.f.velocity(1), v.f.velocity(1), 0., v.tmp[0]);
             dg::blas1::pointwiseDot( v.p.mu[1], v.tmp[0], result, 0., result);
         }
     },
     {"sosne_tt", "ExB vorticity source term with electron source", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.f.gradP(0), v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., result, v.f.binv(), v.f.binv(), 0., result);
             dg::blas1::pointwiseDot( v.p.mu[1], result, v.f.density_source(0), 0., result);
         }
     },
     {"sospi_tt", "Diamagnetic vorticity source term with electron source", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_gradSN( 0, v.tmp);
             routines::dot( v.p.mu[1]*v.p.tau[1], v.tmp, v.gradPsip, 0., result);
         }
     },
     {"loexbe_tt", "Vorticity dissipation term with electron Lambda", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( v.f.gradP(0), v.gradPsip, result);
             dg::blas1::pointwiseDot( 1., result, v.f.binv(), v.f.binv(), 0., result);
 
@@ -1275,13 +1280,13 @@ std::vector<Record> ToroidalExBDiagnostics2d_list = { //27
 std::vector<Record> ParallelMomDiagnostics2d_list = { //36
     ///-----------------------Parallel momentum terms ------------------------//
     {"niui", "Product of ion gyrocentre density and velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot(
                 v.f.density(1), v.f.velocity(1), result);
         }
     },
     {"jsparexbi_tt", "Parallel momentum radial flux by ExB velocity with electron potential (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, result);
 
@@ -1290,7 +1295,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparexbi_tt", "Divergence of parallel momentum radial flux by ExB velocity with electron potential (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
             // parallel momentum mu_iN_iU_i
@@ -1299,7 +1304,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparexbii_tt", "Divergence of parallel momentum radial flux by ExB velocity with ion potential (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB
             routines::times(v.f.bhatgB(), v.f.gradP(1), v.tmp); //u_E
             // parallel momentum mu_iN_iU_i
@@ -1308,7 +1313,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divpardiai_tt", "Parallel momentum radial flux by Diamagnetic velocity with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( 1., v.f.curv(), v.f.gradN(1), 0., v.tmp[0]);
             routines::dot( 1., v.f.curv(), v.f.gradU(1), 0., v.tmp[1]);
             // Multiply everything
@@ -1317,7 +1322,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparkappai_tt", "Parallel momentum radial flux by curvature velocity (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.density(1), v.f.velocity(1), 0., v.tmp[0]); // mu NU
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.velocity(1), v.f.velocity(1), v.tmp[0], 0., v.tmp[1]); //muNU mu U**2
             // mu NU(mu U^2 + 2tau)
@@ -1326,7 +1331,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparmirrorAi_tt", "Divergence of parallel magnetic flutter force (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             //b_\perp
             v.f.compute_bperp( v.tmp);
             v.f.centered_div( v.f.density(1), v.tmp, v.tmp2[0], result);
@@ -1334,7 +1339,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparmirrorAe_tt", "Divergence of parallel magnetic flutter force (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             //b_\perp
             v.f.compute_bperp( v.tmp);
             v.f.centered_div( v.f.density(0), v.tmp, v.tmp2[0], result);
@@ -1342,7 +1347,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparApari_tt", "Parallel momentum radial flux by magnetic flutter (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.velocity(1), v.f.velocity(1), v.f.density(1),  0., v.tmp3[0]);
             //b_\perp^v
             v.f.compute_bperp( v.tmp);
@@ -1350,7 +1355,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparApare_tt", "Divergence of parallel momentum radial flux by magnetic flutter (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( -v.p.mu[0], v.f.velocity(0), v.f.velocity(0), v.f.density(0),  0., v.tmp3[0]);
             //b_\perp^v
             v.f.compute_bperp( v.tmp);
@@ -1359,7 +1364,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
     },
     /// --------------------- Parallel momentum source terms ---------------------//
     {"divjpari_tt", "Divergence of parallel ion momentum flux", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.divNUb(1), v.f.velocity(1),
                     0., result);
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.density(1),
@@ -1367,7 +1372,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divjpare_tt", "Divergence of parallel electron momentum flux", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( -v.p.mu[0], v.f.divNUb(0), v.f.velocity(0),
                     0., result);
             dg::blas1::pointwiseDot( -v.p.mu[0], v.f.density(0),
@@ -1375,7 +1380,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"lparpar_tt", "Parallel momentum dissipation by parallel diffusion", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::axpby( v.p.nu_parallel_u[1], v.f.lapParU(1), 0., result);
             dg::blas1::pointwiseDot( v.p.nu_parallel_n, v.f.velocity(1),
                     v.f.lapParN(1), 1., result);
@@ -1384,7 +1389,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"lparperp_tt", "Parallel momentum dissipation by perp diffusion", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_perp_diffusiveN( 1., v.f.density(1), v.tmp3[0], v.tmp3[1],
                     0., v.tmp[0]);
             v.f.compute_perp_diffusiveU( 1., v.f.velocity(1), v.f.density(1),
@@ -1394,7 +1399,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"lparparbphi_tt", "Parallel angular momentum dissipation by parallel diffusion", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::axpby( v.p.nu_parallel_u[1], v.f.lapParU(1), 0., result);
             dg::blas1::pointwiseDot( v.p.nu_parallel_n, v.f.velocity(1),
                     v.f.lapParN(1), 1., result);
@@ -1404,7 +1409,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"lparperpbphi_tt", "Parallel angular momentum dissipation by perp diffusion", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             v.f.compute_perp_diffusiveN( 1., v.f.density(1), v.tmp3[0], v.tmp3[1],
                     0., v.tmp[0]);
             v.f.compute_perp_diffusiveU( 1., v.f.velocity(1), v.f.density(1),
@@ -1416,27 +1421,27 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
     },
     //not so important
     {"sparKappaphii_tt", "Kappa Phi Source for parallel momentum", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             routines::dot( v.f.curvKappa(), v.f.gradP(1), result);
             dg::blas1::pointwiseDot( -v.p.mu[1], v.f.density(1), v.f.velocity(1), result, 0., result);
         }
     },
     //not so important
     {"sparmirrorKappai_tt", "Generalized mirror force (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( v.p.mu[1]*v.p.tau[1], v.f.density(1), v.f.velocity(1),
                 v.f.divCurvKappa(), 0., result);
         }
     },
     ///-----------------------Parallel anbular momentum terms-----------------//
     {"niuibphi", "Product of NiUi and covariant phi component of magnetic field unit vector", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( 1.,
                 v.f.density(1), v.f.velocity(1), v.f.bphi(), 0., result);
         }
     },
     {"jsparbphiexbi_tt", "Parallel angular momentum radial flux by ExB velocity with electron potential (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB Dot GradPsi
             routines::jacobian( v.f.bhatgB(), v.f.gradP(0), v.gradPsip, result);
 
@@ -1448,7 +1453,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparbphiexbi_tt", "Divergence of parallel angular momentum radial flux by ExB velocity with electron potential (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
             // parallel momentum mu_iN_iU_i bphi
@@ -1457,7 +1462,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparbphiexbii_tt", "Divergence of parallel angular momentum radial flux by ExB velocity with ion potential (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             // ExB
             routines::times(v.f.bhatgB(), v.f.gradP(1), v.tmp); //u_E
             // parallel momentum mu_iN_iU_i bphi
@@ -1466,7 +1471,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparbphidiai_tt", "Parallel angular momentum radial flux by Diamagnetic velocity with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             routines::dot( 1., v.f.curv(), v.f.gradN(1), 0., v.tmp[0]);
             routines::dot( 1., v.f.curv(), v.f.gradU(1), 0., v.tmp[1]);
             dg::blas1::pointwiseDot( v.tmp[0], v.f.bphi(), v.tmp[0]);
@@ -1477,7 +1482,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparbphikappai_tt", "Parallel angular momentum radial flux by curvature velocity (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.density(1), v.f.velocity(1), 0., v.tmp[0]);
             dg::blas1::pointwiseDot( v.p.mu[1], v.f.velocity(1), v.f.velocity(1), v.tmp[0],  0., v.tmp[1]);
             // mu NU(mu U^2 + 2tau)bphi
@@ -1486,7 +1491,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
         }
     },
     {"divparbphiApar_tt", "Parallel angular momentum radial flux by magnetic flutter (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( -v.p.mu[0], v.f.velocity(0), v.f.velocity(0), v.f.density(0),  0., result);
             dg::blas1::pointwiseDot( +v.p.mu[1], v.f.velocity(1), v.f.velocity(1), v.f.density(1),  1., result);
             dg::blas1::axpbypgz( -v.p.tau[0], v.f.density(0),
@@ -1498,73 +1503,73 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
     },
     /// --------------------electron force balance usually well-fulfilled ----//
     {"sparphie_tt", "Electric force in electron momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( 1., v.f.dsP(0), v.f.density(0), 0., result);
         }
     },
     {"sparmirrore_tt", "Parallel electron pressure (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::axpby( v.p.tau[0], v.f.dsN(0), 0., result);
         }
     },
     {"sparmirrorAe_tt", "Apar Mirror force term with electron density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_bperp( v.tmp);
             routines::dot( v.p.tau[0], v.tmp, v.f.gradN(0), 0., result);
         }
     },
 
     {"sparphiAe_tt", "Apar Electric force in electron momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_bperp( v.tmp);
             routines::dot( v.tmp, v.f.gradP(0), result);
             dg::blas1::pointwiseDot( v.f.density(0), result, result);
         }
     },
     {"spardotAe_tt", "Apar Electric force in electron momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_dot_aparallel( result);
             dg::blas1::pointwiseDot( v.f.density(0), result, result);
         }
     },
     {"neue", "Product of electron density and velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot(
                 v.f.density(0), v.f.velocity(0), result);
         }
     },
     /// -----------Ion force balance ----------------------///
     {"sparphii_tt", "Electric force term in ion momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::pointwiseDot( -1., v.f.dsP(1), v.f.density(1), 0., result);
         }
     },
     {"sparmirrori_tt", "Parallel ion pressure (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             dg::blas1::axpby( -v.p.tau[1], v.f.dsN(1), 0., result);
         }
     },
     {"sparmirrorAi_tt", "Apar Mirror force term with ion density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_bperp( v.tmp);
             routines::dot( -v.p.tau[1], v.tmp, v.f.gradN(1), 0., result);
         }
     },
     {"sparphiAi_tt", "Apar Electric force in ion momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_bperp( v.tmp);
             routines::dot( v.tmp, v.f.gradP(1), result);
             dg::blas1::pointwiseDot( -1., v.f.density(1), result, 0., result);
         }
     },
     {"spardotAi_tt", "Apar Electric force in ion momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v){
+        []( feltor::x::DVec& result, Variables& v){
             v.f.compute_dot_aparallel( result);
             dg::blas1::pointwiseDot( -1., v.f.density(1), result, 0., result);
         }
     },
     {"friction_tt", "Friction force in momentum density (Time average)", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             dg::blas1::pointwiseDot( 1., v.f.velocity(1), v.f.density(1), -1.,
                     v.f.velocity(0), v.f.density(0), 0., result);
             dg::blas1::pointwiseDot( v.p.eta, result, v.f.density(0), 0, result);
@@ -1575,7 +1580,7 @@ std::vector<Record> ParallelMomDiagnostics2d_list = { //36
 std::vector<Record> RSDiagnostics2d_list = { //2
     /// --------------------- Zonal flow energy terms------------------------//
     {"nei0", "inertial factor", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             routines::dot( v.gradPsip, v.gradPsip, result);
             dg::blas1::transform( result, result, Positive());
             dg::blas1::pointwiseDot( v.mag.R0()*v.mag.R0(),
@@ -1584,7 +1589,7 @@ std::vector<Record> RSDiagnostics2d_list = { //2
         }
     },
     {"snei0_tt", "inertial factor source", true,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
             routines::dot( v.gradPsip, v.gradPsip, result);
             dg::blas1::transform( result, result, Positive());
             dg::blas1::pointwiseDot( v.mag.R0()*v.mag.R0(),
@@ -1598,33 +1603,33 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
     /// ----------------- COCE EQUATION ----------------//
     /// ---------- Polarization charge densities -----------///
     {"v_Omega_E", "Electron polarisation term", false,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_pol( 1., v.f.density(0), v.tmp[0], 0., result);
         }
     },
     {"v_Omega_E_gf", "Ion polarisation term", false,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_pol( 1., v.f.density(1), v.tmp[0], 0., result);
         }
     },
     /// ------------ Polarization advections ------------------//
     //The fsa of the main and rest terms is almost the same as the one of divoexbi
     {"v_adv_E_main_tt", "Main electric advective term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_pol( 1., v.f.density(0), v.tmp[0], 0., v.tmp3[0]);
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
             v.f.centered_div( v.tmp3[0], v.tmp, v.tmp2[0], result);
         }
     },
     {"v_adv_E_main_gf_tt", "Main electric advective term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_pol( 1., v.f.density(1), v.tmp[0], 0., v.tmp3[0]);
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
             v.f.centered_div( v.tmp3[0], v.tmp, v.tmp2[0], result);
         }
     },
     {"v_adv_E_rest_tt", "Electric advective term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             // NOT implemented for true curvature mode
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp2); //u_E
             dg::blas1::pointwiseDot(1., v.f.binv(), v.f.binv(), v.f.density(0), 0., v.tmp[0]);
@@ -1635,7 +1640,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
         }
     },
     {"v_adv_E_rest_gf_tt", "Electric advective term GF (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             // NOT implemented for true curvature mode
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp2); //u_E
             dg::blas1::pointwiseDot(1., v.f.binv(), v.f.binv(), v.f.density(1), 0., v.tmp[0]);
@@ -1647,7 +1652,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
     },
     //The fsa of the main and rest terms is almost the same as the one of divodiaiUE
     {"v_adv_D_main_tt", "Main diamagnetic term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_lapMperpN(-1.0, v.f.density(0), v.tmp[0], 0., v.tmp3[0]);
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
             v.f.centered_div( v.tmp3[0], v.tmp, v.tmp2[0], result);
@@ -1655,7 +1660,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
         }
     },
     {"v_adv_D_main_gf_tt", "Main diamagnetic term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_lapMperpN(-1.0, v.f.density(1), v.tmp[0], 0., v.tmp3[0]);
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp); //u_E
             v.f.centered_div( v.tmp3[0], v.tmp, v.tmp2[0], result);
@@ -1663,7 +1668,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
         }
     },
     {"v_adv_D_rest_tt", "Diamagnetic advective term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             // NOT implemented for true curvature mode
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp2); //u_E
             v.f.centered_v_dot_nabla(v.f.gradN(0), v.tmp2[0], v.tmp[2], v.tmp[0]); //t3*nabla(u_E^R)
@@ -1673,7 +1678,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
     },
 
     {"v_adv_D_rest_gf_tt", "Diamagnetic advective term GF (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             // NOT implemented for true curvature mode
             routines::times(v.f.bhatgB(), v.f.gradP(0), v.tmp2); //u_E
             v.f.centered_v_dot_nabla(v.f.gradN(1), v.tmp2[0], v.tmp[2], v.tmp[0]); //t3*nabla(u_E^R)
@@ -1683,7 +1688,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
     },
     ///---------------- J_b_perp components --------//
     {"v_J_mag_tt", "Magnetization current term GF (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             // take care to use correct derivatives...
             v.f.compute_lapMperpN( -1., v.f.density(1), v.tmp[0], 0., v.tmp2[0]);
             dg::blas1::pointwiseDot( v.f.velocity(1), v.tmp2[0], v.tmp2[0]);
@@ -1701,7 +1706,7 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
         }
     },
     {"v_J_bperp_tt", "Div J_par times b_perp term (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_bperp(v.tmp);
             dg::blas1::pointwiseDot(1., v.f.density(1), v.f.velocity(1), -1.,
                     v.f.density(0), v.f.velocity(0), 0, v.tmp2[0]);
@@ -1710,23 +1715,23 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
     },
     ///-------------- Sources term----------///
     {"v_S_E_tt", "Electric source vorticity (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_source_pol( 1., v.f.density_source(0), v.tmp[0], 0., result);
         }
     },
     {"v_S_D_tt", "Diamagnetic source vorticity (time integrated)", true,
-        []( dg::x::DVec& result, Variables& v) {
+        []( feltor::x::DVec& result, Variables& v) {
             v.f.compute_lapMperpN(-v.p.tau[1]*v.p.mu[1], v.f.density_source(0), v.tmp[0], 0., result);
         }
     },
     /// ------------- Radial Force Balance terms ---------///
     {"RFB_E_r_GradPsip_tt", "Radial electric field in RFB (time integrated)", true,
-         []( dg::x::DVec& result, Variables& v){
+         []( feltor::x::DVec& result, Variables& v){
              routines::dot(-1., v.f.gradP(0), v.gradPsip, 0., result);
          }
      },
     {"RFB_GradPi_GradPsip_tt", "Radial pressure gradient component of RFB (time integrated)", true,
-         []( dg::x::DVec& result, Variables& v){
+         []( feltor::x::DVec& result, Variables& v){
              routines::dot(v.f.gradN(0), v.gradPsip, result);
              dg::blas1::pointwiseDivide(v.p.tau[1], result, v.f.density(0), 0.,
                      result);
@@ -1737,32 +1742,32 @@ std::vector<Record> COCEDiagnostics2d_list = { // 16
 
 std::vector<Record> probe_list = {
      {"electrons_probe", "probe measurement of electron density", false,
-         []( dg::x::DVec& result, Variables& v ) {
+         []( feltor::x::DVec& result, Variables& v ) {
               dg::blas1::copy(v.f.density(0), result);
          }
      },
      {"ions_probe", "probe measurement of ion density", false,
-         []( dg::x::DVec& result, Variables& v ) {
+         []( feltor::x::DVec& result, Variables& v ) {
               dg::blas1::copy(v.f.density(1), result);
          }
      },
      {"Ue_probe", "probe measurement of parallel electron velocity", false,
-         []( dg::x::DVec& result, Variables& v ) {
+         []( feltor::x::DVec& result, Variables& v ) {
               dg::blas1::copy(v.f.velocity(0), result);
          }
      },
      {"Ui_probe", "probe measurement of parallel ion velocity", false,
-         []( dg::x::DVec& result, Variables& v ) {
+         []( feltor::x::DVec& result, Variables& v ) {
               dg::blas1::copy(v.f.velocity(1), result);
          }
      },
      {"potential_probe", "probe measurement of electric potential", false,
-         []( dg::x::DVec& result, Variables& v ) {
+         []( feltor::x::DVec& result, Variables& v ) {
               dg::blas1::copy(v.f.potential(0), result);
          }
      },
      {"aparallel_probe", "probe measurement of parallel magnetic potential", false,
-         []( dg::x::DVec& result, Variables& v ) {
+         []( feltor::x::DVec& result, Variables& v ) {
               dg::blas1::copy(v.f.aparallel(), result);
          }
      }
@@ -1792,30 +1797,71 @@ std::vector<Record1d> diagnostics1d_list = {
 ///%%%%%%%%%%%%%%%%%%%%%%%%%%END DIAGNOSTICS LIST%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 std::vector<Record> restart3d_list = {
     {"restart_electrons", "electron density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.restart_density(0), result);
         }
     },
     {"restart_ions", "ion density", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.restart_density(1), result);
         }
     },
     {"restart_Ue", "parallel electron velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.restart_velocity(0), result);
         }
     },
     {"restart_Ui", "parallel ion velocity", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.restart_velocity(1), result);
         }
     },
     {"restart_aparallel", "parallel magnetic potential", false,
-        []( dg::x::DVec& result, Variables& v ) {
+        []( feltor::x::DVec& result, Variables& v ) {
              dg::blas1::copy(v.f.restart_aparallel(), result);
         }
     }
 };
 
+/**
+ * @brief Restrict the global diagnostics lists to the given record names
+ *
+ * The runtime counterpart to commenting records out of the lists above:
+ * records that are not named are erased from \c diagnostics3d_list, the 2d
+ * equation lists and \c probe_list, so neither their evaluation nor their
+ * NetCDF definition costs anything (cf. the "records" field of the input
+ * file). The \c restart3d_list and the cheap 1d counters are never
+ * restricted.
+ * @param names the record names to keep
+ * @return the names that did not match any record (a spelling error if not
+ * empty)
+ */
+inline std::vector<std::string> select_records( const std::vector<std::string>& names)
+{
+    std::set<std::string> chosen( names.begin(), names.end()), matched;
+    auto filter = [&]( std::vector<Record>& list){
+        list.erase( std::remove_if( list.begin(), list.end(),
+            [&]( const Record& record){
+                if( chosen.count( record.name) == 0)
+                    return true;
+                matched.insert( record.name);
+                return false;
+            }), list.end());
+    };
+    filter( diagnostics3d_list);
+    filter( basicDiagnostics2d_list);
+    filter( MassConsDiagnostics2d_list);
+    filter( EnergyDiagnostics2d_list);
+    filter( ToroidalExBDiagnostics2d_list);
+    filter( ParallelMomDiagnostics2d_list);
+    filter( RSDiagnostics2d_list);
+    filter( COCEDiagnostics2d_list);
+    filter( probe_list);
+    std::vector<std::string> unmatched;
+    for( auto& name : chosen)
+        if( matched.count( name) == 0)
+            unmatched.push_back( name);
+    return unmatched;
+}
+
 }//namespace feltor
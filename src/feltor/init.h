@@ -197,7 +197,7 @@ dg::x::HVec make_damping(
     return damping;
 }
 dg::x::HVec make_ntilde(
-    Explicit<dg::x::CylindricalGrid3d, dg::x::IDMatrix, dg::x::DMatrix, dg::x::DVec>& feltor,
+    Explicit<dg::x::CylindricalGrid3d, feltor::x::IEllMatrix, feltor::x::DMatrix, feltor::x::DVec>& feltor,
     const dg::x::CylindricalGrid3d& grid,
     const dg::geo::TokamakMagneticField& mag,
     dg::file::WrappedJsonValue js )
@@ -350,8 +350,8 @@ dg::x::HVec make_ntilde(
  * @note y0[1] has to be the staggered velocity
  */
 
-std::array<std::array<dg::x::DVec,2>,2> initial_conditions(
-    Explicit<dg::x::CylindricalGrid3d, dg::x::IDMatrix, dg::x::DMatrix, dg::x::DVec>& feltor,
+std::array<std::array<feltor::x::DVec,2>,2> initial_conditions(
+    Explicit<dg::x::CylindricalGrid3d, feltor::x::IEllMatrix, feltor::x::DMatrix, feltor::x::DVec>& feltor,
     const dg::x::CylindricalGrid3d& grid, const feltor::Parameters& p,
     const dg::geo::TokamakMagneticField& mag,
     const dg::geo::TokamakMagneticField& unmod_mag,
@@ -364,8 +364,8 @@ std::array<std::array<dg::x::DVec,2>,2> initial_conditions(
 #endif
     time = 0;
     //js = input["init"]
-    std::array<std::array<dg::x::DVec,2>,2> y0;
-    y0[0][0] = y0[0][1] = y0[1][0] = y0[1][1] = dg::construct<dg::x::DVec>(
+    std::array<std::array<feltor::x::DVec,2>,2> y0;
+    y0[0][0] = y0[0][1] = y0[1][0] = y0[1][1] = dg::construct<feltor::x::DVec>(
         dg::evaluate( dg::zero, grid));
     std::string type = js.get("type", "zero").asString();
     if( "fields" == type)
@@ -375,7 +375,7 @@ std::array<std::array<dg::x::DVec,2>,2> initial_conditions(
         if ( "const" == ntype)
         {
             double nbg = js["density"].get("background", 0.1).asDouble();
-            y0[0][0] = y0[0][1] = dg::construct<dg::x::DVec>(
+            y0[0][0] = y0[0][1] = dg::construct<feltor::x::DVec>(
                     dg::evaluate( dg::CONSTANT( nbg), grid));
         }
         else if( "ne" == ntype || "ni" == ntype)
@@ -465,7 +465,7 @@ std::array<std::array<dg::x::DVec,2>,2> initial_conditions(
 };
 
 dg::x::HVec source_profiles(
-    Explicit<dg::x::CylindricalGrid3d, dg::x::IDMatrix, dg::x::DMatrix, dg::x::DVec>& feltor,
+    Explicit<dg::x::CylindricalGrid3d, feltor::x::IEllMatrix, feltor::x::DMatrix, feltor::x::DVec>& feltor,
     bool& fixed_profile, //indicate whether a profile should be forced (yes or no)
     dg::x::HVec& ne_profile,    // if fixed_profile is yes you need to construct something here, if no then you can ignore the parameter; if you construct something it will show in the output file
     const dg::x::CylindricalGrid3d& grid,
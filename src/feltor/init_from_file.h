@@ -1,14 +1,50 @@
 #pragma once
 
+#include <future>
 
 #include "dg/file/nc_utilities.h"
 #include "parameters.h"
+#include "checkpoint.h"
 
 namespace feltor
 {//We use the typedefs and DG_RANK0
 //
+//everyone reads their portion; file_name may be the base name or either slot file
+std::array<std::array<feltor::x::DVec,2>,2> init_from_checkpoint( std::string file_name,
+        const dg::x::CylindricalGrid3d& grid, const Parameters& p,
+        double& time)
+{
+#ifdef WITH_MPI
+    int rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+#endif
+    // accept "name", "name.0.nc" or "name.1.nc"
+    std::string base = file_name;
+    for( std::string tail : {".0.nc", ".1.nc"})
+        if( base.size() > tail.size() &&
+                base.compare( base.size()-tail.size(), tail.size(), tail) == 0)
+            base = base.substr( 0, base.size()-tail.size());
+    std::vector<std::string> namesIN = {"restart_electrons", "restart_ions",
+        "restart_Ue", "restart_Ui", "restart_aparallel"};
+    std::vector<dg::x::HVec> fields;
+    if( !read_checkpoint( base, grid, namesIN, fields, time))
+        throw dg::Error( dg::Message(_ping_) << "No valid checkpoint found for "
+            <<base<<" (note that checkpoints require the exact same grid)");
+    DG_RANK0 std::cout << "RESTART from checkpoint "<<base<< std::endl;
+    DG_RANK0 std::cout << " Current time = "<< time <<  std::endl;
+    //Convert to W
+    dg::blas1::axpby( 1., fields[2], 1./p.mu[0], fields[4], fields[2]);
+    dg::blas1::axpby( 1., fields[3], 1./p.mu[1], fields[4], fields[3]);
+    std::array<std::array<feltor::x::DVec,2>,2> y0;
+    dg::assign( fields[0], y0[0][0]); //ne
+    dg::assign( fields[1], y0[0][1]); //Ni
+    dg::assign( fields[2], y0[1][0]); //We
+    dg::assign( fields[3], y0[1][1]); //Wi
+    return y0;
+}
+
 //everyone reads their portion of the input data
-std::array<std::array<dg::x::DVec,2>,2> init_from_file( std::string file_name,
+std::array<std::array<feltor::x::DVec,2>,2> init_from_file( std::string file_name,
         const dg::x::CylindricalGrid3d& grid, const Parameters& p,
         double& time)
 {
@@ -16,7 +52,20 @@ std::array<std::array<dg::x::DVec,2>,2> init_from_file( std::string file_name,
     int rank;
     MPI_Comm_rank( MPI_COMM_WORLD, &rank);
 #endif
-    std::array<std::array<dg::x::DVec,2>,2> y0;
+    std::array<std::array<feltor::x::DVec,2>,2> y0;
+    // Dispatch checkpoint files (see checkpoint.h)
+    {
+        int ncidCHK;
+        if( nc_open( file_name.data(), NC_NOWRITE, &ncidCHK) == NC_NOERR)
+        {
+            int index;
+            bool is_checkpoint = ( nc_get_att_int( ncidCHK, NC_GLOBAL,
+                "checkpoint_index", &index) == NC_NOERR);
+            nc_close( ncidCHK);
+            if( is_checkpoint)
+                return init_from_checkpoint( file_name, grid, p, time);
+        }
+    }
     ///////////////////read in and show inputfile
 
     dg::file::NC_Error_Handle errIN;
@@ -47,21 +96,36 @@ std::array<std::array<dg::x::DVec,2>,2> init_from_file( std::string file_name,
         , grid.communicator()
         #endif //WITH_MPI
         );
-    dg::x::IHMatrix interpolateIN;
+    // construct the remap between file and simulation grid; the file may
+    // have a different (n, Nx, Ny, Nz) than the current simulation
+    dg::x::IHMatrix remapIN;
     dg::x::HVec transferIN;
     if( pINsymmetric)
     {
         std::unique_ptr< typename dg::x::CylindricalGrid3d::perpendicular_grid>
-            grid_perp ( static_cast<typename
-                dg::x::CylindricalGrid3d::perpendicular_grid*>(grid.perp_grid()));
-        interpolateIN = dg::create::interpolation( grid, *grid_perp);
-        transferIN = dg::evaluate(dg::zero, *grid_perp);
+            grid_perpIN ( static_cast<typename
+                dg::x::CylindricalGrid3d::perpendicular_grid*>(grid_IN.perp_grid()));
+        remapIN = dg::create::interpolation( grid, *grid_perpIN);
+        transferIN = dg::evaluate(dg::zero, *grid_perpIN);
     }
     else
     {
-        interpolateIN = dg::create::interpolation( grid, grid_IN);
+        // when coarsening, the exact projection avoids aliasing the
+        // unresolvable modes of the finer file grid
+        bool coarsen = grid_IN.size() > grid.size()
+            && grid_IN.Nx() % grid.Nx() == 0
+            && grid_IN.Ny() % grid.Ny() == 0
+            && grid_IN.Nz() % grid.Nz() == 0;
+        if( coarsen)
+            remapIN = dg::create::projection( grid, grid_IN);
+        else
+            remapIN = dg::create::interpolation( grid, grid_IN);
         transferIN = dg::evaluate(dg::zero, grid_IN);
     }
+    // the remap runs in parallel on device
+    dg::x::IDMatrix remap;
+    dg::blas2::transfer( remapIN, remap);
+    dg::x::DVec transferINd = dg::construct<dg::x::DVec>( transferIN);
 
     #ifdef WITH_MPI
     int dimsIN[3],  coordsIN[3];
@@ -83,7 +147,8 @@ std::array<std::array<dg::x::DVec,2>,2> init_from_file( std::string file_name,
         countIN[0] = 1;
         startIN[0] = 0;
     }
-    std::vector<dg::x::HVec> transferOUTvec( 5, dg::evaluate( dg::zero, grid));
+    std::vector<dg::x::DVec> transferOUTvec( 5,
+        dg::construct<dg::x::DVec>( dg::evaluate( dg::zero, grid)));
 
     std::string namesIN[5] = {"restart_electrons", "restart_ions",
         "restart_Ue", "restart_Ui", "restart_aparallel"};
@@ -97,18 +162,33 @@ std::array<std::array<dg::x::DVec,2>,2> init_from_file( std::string file_name,
     size_time -= 1;
     errIN = nc_get_vara_double( ncidIN, timeIDIN, &size_time, &count_time, &time);
     DG_RANK0 std::cout << " Current time = "<< time <<  std::endl;
-    for( unsigned i=0; i<5; i++)
-    {
+    // Pipelined read: while the current record is uploaded to device and
+    // remapped, a reader thread already fetches the next record into the
+    // other of two staging buffers (the netcdf calls themselves stay
+    // serialized, the library is not thread-safe)
+    std::array<dg::x::HVec,2> stagingIN = {transferIN, transferIN};
+    auto read_record = [&]( unsigned i, dg::x::HVec& buffer) {
         int dataID;
         errIN = nc_inq_varid( ncidIN, namesIN[i].data(), &dataID);
         errIN = nc_get_vara_double( ncidIN, dataID, startIN, countIN,
             #ifdef WITH_MPI
-                transferIN.data().data()
+                buffer.data().data()
             #else //WITH_MPI
-                transferIN.data()
+                buffer.data()
             #endif //WITH_MPI
             );
-        dg::blas2::gemv( interpolateIN, transferIN, transferOUTvec[i]);
+    };
+    read_record( 0, stagingIN[0]);
+    for( unsigned i=0; i<5; i++)
+    {
+        std::future<void> next;
+        if( i < 4)
+            next = std::async( std::launch::async, read_record, i+1,
+                    std::ref( stagingIN[(i+1)%2]));
+        dg::assign( stagingIN[i%2], transferINd);
+        dg::blas2::gemv( remap, transferINd, transferOUTvec[i]);
+        if( i < 4)
+            next.get();
     }
     errIN = nc_close(ncidIN);
     /// ///////////////Now Construct initial fields ////////////////////////
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <vector>
+#include "dg/algorithm.h"
+
+#ifdef WITH_MPI
+namespace feltor
+{
+
+/**
+ * @brief Ship the prognostic fields from the compute to the sidecar group
+ *
+ * Companion to \c dg::mpi_init3d_sidecar for staged in-situ diagnostics:
+ * compute ranks snapshot the four prognostic fields into host buffers and
+ * post nonblocking sends, then immediately continue timestepping; the
+ * sidecar ranks receive the fields, evaluate the diagnostics record list
+ * and write the output file concurrently with the timestepping.
+ *
+ * Both groups decompose the same global grid, generally over a different
+ * number of processes, so every message is the intersection of a local with
+ * a remote subdomain. The subdomain table is exchanged once at construction
+ * via \c MPI_Allgather over the inter-communicator.
+ *
+ * The sends are double buffered: a \c ship call only waits for the sends
+ * posted two calls ago, so one snapshot is always in flight while the
+ * timestepper works on the next one. The receiving side is strictly
+ * sequential, which together with the MPI non-overtaking rule keeps the
+ * snapshots in order.
+ */
+struct InsituShipper
+{
+    using Vector = std::array<std::array<feltor::x::DVec,2>,2>;
+    /**
+     * @param inter_comm the inter-communicator from \c dg::mpi_init3d_sidecar
+     * @param grid the local side's grid (compute or sidecar decomposition of
+     * the same global grid)
+     */
+    InsituShipper( MPI_Comm inter_comm, const dg::x::CylindricalGrid3d& grid)
+      : m_inter( inter_comm)
+    {
+        m_host = dg::evaluate( dg::zero, grid);
+        // my global slab in (z,y,x): start and count per dimension
+        int dims[3], periods[3], coords[3];
+        MPI_Cart_get( grid.communicator(), 3, dims, periods, coords);
+        m_count[0] = grid.local().Nz();
+        m_count[1] = grid.n()*grid.local().Ny();
+        m_count[2] = grid.n()*grid.local().Nx();
+        int slab[6] = {(int)(coords[2]*m_count[0]), (int)m_count[0],
+                       (int)(coords[1]*m_count[1]), (int)m_count[1],
+                       (int)(coords[0]*m_count[2]), (int)m_count[2]};
+        int remote_size;
+        MPI_Comm_remote_size( inter_comm, &remote_size);
+        //in an inter-communicator the Allgather receives from the remote group
+        std::vector<int> remote( 6*remote_size);
+        MPI_Allgather( slab, 6, MPI_INT, remote.data(), 6, MPI_INT, inter_comm);
+        for( int r=0; r<remote_size; r++)
+        {
+            Partner p;
+            p.rank = r;
+            bool empty = false;
+            for( unsigned d=0; d<3; d++)
+            {
+                int lo = std::max( slab[2*d], remote[6*r+2*d]);
+                int hi = std::min( slab[2*d]+slab[2*d+1],
+                    remote[6*r+2*d]+remote[6*r+2*d+1]);
+                if( hi <= lo)
+                    empty = true;
+                p.start[d] = lo - slab[2*d]; //in local coordinates
+                p.count[d] = hi - lo;
+            }
+            if( !empty)
+                m_partners.push_back( p);
+        }
+        //message layout: [time, abort, data...]
+        for( unsigned gen=0; gen<2; gen++)
+        {
+            m_buffers[gen].resize( m_partners.size()*4);
+            for( unsigned u=0; u<m_partners.size(); u++)
+            {
+                const Partner& p = m_partners[u];
+                for( unsigned f=0; f<4; f++)
+                    m_buffers[gen][u*4+f].resize(
+                        2 + p.count[0]*p.count[1]*p.count[2]);
+            }
+        }
+    }
+    /**
+     * @brief Snapshot the fields and post nonblocking sends (compute side)
+     *
+     * Waits for the sends of the previous generation of buffers before
+     * reusing them, so at most one snapshot is in flight.
+     * @param time current simulation time, shipped with the fields
+     * @param abort if true, signals the sidecar group to write a last
+     * output and shut down
+     * @param y the four prognostic fields
+     */
+    void ship( double time, bool abort, const Vector& y)
+    {
+        unsigned gen = m_gen % 2;
+        if( !m_requests[gen].empty())
+            MPI_Waitall( m_requests[gen].size(), m_requests[gen].data(),
+                MPI_STATUSES_IGNORE);
+        m_requests[gen].clear();
+        for( unsigned i=0; i<2; i++)
+        for( unsigned j=0; j<2; j++)
+        {
+            unsigned f = i*2+j;
+            dg::assign( y[i][j], m_host);
+            const dg::HVec& flat = m_host.data();
+            for( unsigned u=0; u<m_partners.size(); u++)
+            {
+                const Partner& p = m_partners[u];
+                std::vector<double>& buf = m_buffers[gen][u*4+f];
+                buf[0] = time;
+                buf[1] = abort ? 1. : 0.;
+                unsigned q = 2;
+                for( unsigned iz=0; iz<p.count[0]; iz++)
+                for( unsigned iy=0; iy<p.count[1]; iy++)
+                {
+                    size_t idx = ((p.start[0]+iz)*m_count[1]
+                        + p.start[1]+iy)*m_count[2] + p.start[2];
+                    for( unsigned ix=0; ix<p.count[2]; ix++)
+                        buf[q++] = flat[idx+ix];
+                }
+                MPI_Request req;
+                MPI_Isend( buf.data(), buf.size(), MPI_DOUBLE, p.rank,
+                    (int)f, m_inter, &req);
+                m_requests[gen].push_back( req);
+            }
+        }
+        m_gen++;
+    }
+    /**
+     * @brief Receive the next snapshot (sidecar side, blocking)
+     * @param time (write only) the simulation time of the snapshot
+     * @param abort (write only) true if the compute group signals shutdown
+     * @param y (write only) the four prognostic fields
+     */
+    void receive( double& time, bool& abort, Vector& y)
+    {
+        for( unsigned i=0; i<2; i++)
+        for( unsigned j=0; j<2; j++)
+        {
+            unsigned f = i*2+j;
+            dg::HVec& flat = m_host.data();
+            for( unsigned u=0; u<m_partners.size(); u++)
+            {
+                const Partner& p = m_partners[u];
+                std::vector<double>& buf = m_buffers[0][u*4+f];
+                MPI_Recv( buf.data(), buf.size(), MPI_DOUBLE, p.rank,
+                    (int)f, m_inter, MPI_STATUS_IGNORE);
+                time = buf[0];
+                abort = (buf[1] != 0.);
+                unsigned q = 2;
+                for( unsigned iz=0; iz<p.count[0]; iz++)
+                for( unsigned iy=0; iy<p.count[1]; iy++)
+                {
+                    size_t idx = ((p.start[0]+iz)*m_count[1]
+                        + p.start[1]+iy)*m_count[2] + p.start[2];
+                    for( unsigned ix=0; ix<p.count[2]; ix++)
+                        flat[idx+ix] = buf[q++];
+                }
+            }
+            dg::assign( m_host, y[i][j]);
+        }
+    }
+    ///@brief Complete all outstanding sends (call before \c MPI_Finalize)
+    void flush()
+    {
+        for( unsigned gen=0; gen<2; gen++)
+        {
+            if( !m_requests[gen].empty())
+                MPI_Waitall( m_requests[gen].size(), m_requests[gen].data(),
+                    MPI_STATUSES_IGNORE);
+            m_requests[gen].clear();
+        }
+    }
+    private:
+    struct Partner
+    {
+        int rank; //in the remote group of m_inter
+        unsigned start[3], count[3]; //intersection in local coordinates
+    };
+    MPI_Comm m_inter;
+    dg::x::HVec m_host; //staging stays double: the sidecar protocol sends MPI_DOUBLE
+    size_t m_count[3];
+    std::vector<Partner> m_partners;
+    std::array<std::vector<std::vector<double>>,2> m_buffers;
+    std::array<std::vector<MPI_Request>,2> m_requests;
+    unsigned m_gen = 0;
+};
+
+}//namespace feltor
+#endif //WITH_MPI
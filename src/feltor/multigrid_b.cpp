@@ -57,9 +57,19 @@ int main( int argc, char* argv[])
     /////////////////////////////////////////////////////////////////////////
     dg::CylindricalGrid3d g3d( Rmin, Rmax, Zmin, Zmax, 0., 2.*M_PI,
         p.n, p.Nx, p.Ny, p.Nz, p.bcxN, p.bcyN, dg::PER);
+    std::cout << "Plane? ( "<<p.Nz<<" or larger solves all planes batched)\n";
+    unsigned k=4;
+    std::cin >>k;
+    const bool batched = (k >= p.Nz);
+    if( batched)
+        std::cout << "All "<<p.Nz<<" planes batched\n";
+    else
+        std::cout << "Plane "<<k<<"\n";
+    //The perpendicular polarisation does not couple planes, so instead of
+    //solving one plane after the other we can solve all Nz planes as one
+    //batched vector (the solver kernels then see Nz times more parallelism)
     dg::CylindricalGrid3d g2d( Rmin, Rmax, Zmin, Zmax, 0., 2.*M_PI,
-    //    p.n, p.Nx, p.Ny, p.Nz, p.bcxN, p.bcyN, dg::PER);
-        p.n, p.Nx, p.Ny, 1, p.bcxN, p.bcyN, dg::PER);
+        p.n, p.Nx, p.Ny, batched ? p.Nz : 1, p.bcxN, p.bcyN, dg::PER);
     std::cout << "Opening file "<<argv[1]<<"\n";
     std::string names[7] = {"chi", "sol", "rhs", "ne", "Ni", "phiH", "phi0"};
     dg::x::HVec transferH = dg::evaluate( dg::zero, g3d);
@@ -70,13 +80,8 @@ int main( int argc, char* argv[])
     dg::x::HVec phi_sol = dg::create::volume( g3d);
     auto split_sol = dg::split( phi_sol, g3d);
 
-    //for( unsigned k =0; k<p.Nz; k++)
     {
 
-    std::cout << "Plane? \n";
-    unsigned k=4;
-    std::cin >>k;
-    std::cout << "Plane "<<k<<"\n";
     unsigned num_stages = p.stages;
     std::cout << "Num stages\n";
     std::cin >> num_stages;
@@ -109,9 +114,13 @@ int main( int argc, char* argv[])
         err = nc_inq_varid(ncid_in, names[i].data(), &dataID);
         err = nc_get_var_double( ncid_in, dataID,
                         transferH.data());
-        auto split_view = dg::split( transferH, g3d);
-        dg::assign( split_view[k], vecs[names[i]]);
-        //dg::assign( transferH, vecs[names[i]]);
+        if( batched)
+            dg::assign( transferH, vecs[names[i]]);
+        else
+        {
+            auto split_view = dg::split( transferH, g3d);
+            dg::assign( split_view[k], vecs[names[i]]);
+        }
     }
     for( auto pair : vecs)
     {
@@ -137,7 +146,8 @@ int main( int argc, char* argv[])
             bhat, multigrid.grid(u));
         multi_pol[u].set_chi( hh);
         multi_invgammaN[u].matrix().set_chi( hh);
-        if(p.curvmode != "true"){
+        //the batched solve must not couple planes through dz or jumpZ
+        if( batched || p.curvmode != "true"){
             multi_pol[u].set_compute_in_2d( true);
             multi_invgammaN[u].matrix().set_compute_in_2d( true);
         }
@@ -166,8 +176,23 @@ int main( int argc, char* argv[])
     error = dg::blas2::dot( temp0, weights, temp0);
     norm = dg::blas2::dot( vecs["sol"], weights, vecs["sol"]);
     std::cout << "Norm error Inv Phi "<<sqrt(error/norm)<<"\n";
+    if( batched)
+    {
+        //the batched solve iterates until the worst plane converges; show
+        //how far each individual plane is from the reference solution
+        auto split_err = dg::split( temp0, g2d);
+        auto split_s   = dg::split( vecs["sol"], g2d);
+        auto split_w   = dg::split( weights, g2d);
+        for( unsigned i=0; i<p.Nz; i++)
+        {
+            double e = dg::blas2::dot( split_err[i], split_w[i], split_err[i]);
+            double s = dg::blas2::dot( split_s[i], split_w[i], split_s[i]);
+            std::cout << "Plane "<<i<<" error Inv Phi "<<sqrt(e/s)<<"\n";
+        }
+    }
     dg::assign( phi, transferH2d);
-    dg::blas1::copy( transferH2d, split_sol[k]);
+    if( !batched)
+        dg::blas1::copy( transferH2d, split_sol[k]);
     }
     //int dataID;
     //err = nc_inq_varid(ncid_in, "sol", &dataID);
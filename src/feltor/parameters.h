@@ -19,6 +19,7 @@ struct Parameters
     std::vector<double> eps_pol;
     double jfactor;
     double eps_gamma, eps_ampere;
+    double eps_scale_max;
     unsigned stages;
     unsigned mx, my;
     double rk4eps;
@@ -31,6 +32,7 @@ struct Parameters
     double eta, beta;
 
     unsigned diff_order;
+    unsigned diff_lag;
     double nu_perp_n, nu_perp_u, nu_parallel_n;
     enum dg::direction diff_dir;
     std::string slope_limiter;
@@ -90,6 +92,9 @@ struct Parameters
         jfactor     = js["elliptic"].get( "jumpfactor", 1).asDouble();
         eps_gamma   = js["elliptic"].get( "eps_gamma", 1e-6).asDouble();
         eps_ampere  = js["elliptic"].get( "eps_ampere", 1e-6).asDouble();
+        //maximum factor by which the adaptive timestepper may relax the
+        //elliptic tolerances (1 disables the coupling)
+        eps_scale_max = js["elliptic"].get( "eps_scale_max", 1.).asDouble();
         pol_dir = dg::str2direction(
                 js["elliptic"].get("direction", "centered").asString() );
 
@@ -102,6 +107,7 @@ struct Parameters
         fci_bc      = js["FCI"].get( "bc", "along_field").asString();
 
         diff_order  = js["regularization"].get( "order", 2).asUInt();
+        diff_lag    = js["regularization"].get( "lag", 1).asUInt();
         diff_dir    = dg::str2direction(
                 js["regularization"].get( "direction", "centered").asString() );
         nu_perp_n   = js["regularization"].get( "nu_perp_n", 0.).asDouble();
@@ -25,10 +25,19 @@ struct Filter
             double order = js[ "regularization"].get( "order", 8).asDouble();
             double eta_c = js[ "regularization"].get( "eta_c", 0.5).asDouble();
             auto op = dg::ExponentialFilter(alpha, eta_c, order, grid.n());
-            m_filter = dg::create::fast_transform(
+            m_modal = dg::CSRModalFilter<value_type>(
                     dg::create::modal_filter(op, grid.dltx()),
-                    dg::create::modal_filter(op, grid.dlty()),
-                    grid);
+                    dg::create::modal_filter(op, grid.dlty()));
+            m_stencil = dg::create::filter_stencil( grid);
+            // optionally probe the modal spectrum and filter only when needed
+            m_adapt_every = js["regularization"].get("adapt_every", 0).asUInt();
+            if( m_adapt_every > 0)
+            {
+                m_on  = js["regularization"].get("threshold_on", 1e-2).asDouble();
+                m_off = js["regularization"].get("threshold_off", m_on/10.).asDouble();
+                m_probe = dg::CSRModalEnergyProbe<value_type>(
+                        grid.dltx().forward(), grid.dlty().forward());
+            }
         }
         else if( m_type == "swm")
         {
@@ -53,11 +62,30 @@ struct Filter
 
     void operator()( Container& y){
         if( m_type == "none" || m_type == "viscosity") return;
+        if( m_type == "modal" && m_adapt_every > 0)
+        {
+            if( m_count % m_adapt_every == 0)
+            {
+                dg::blas2::stencil( m_probe, m_stencil, y, m_tmp);
+                value_type frac = dg::blas1::reduce( m_tmp, (value_type)0,
+                        thrust::maximum<value_type>());
+                //hysteresis between the on and off thresholds
+                if( !m_active && frac > m_on)
+                    m_active = true;
+                else if( m_active && frac < m_off)
+                    m_active = false;
+                std::cout << "Modal probe: highest mode fraction "<<frac
+                          <<" filter "<<(m_active ? "on" : "off")<<"\n";
+            }
+            m_count++;
+            if( !m_active)
+                return;
+        }
         dg::Timer t;
         t.tic();
         if( m_type == "modal")
         {
-            dg::blas2::symv( m_filter, y, m_tmp);
+            dg::blas2::stencil( m_modal, m_stencil, y, m_tmp);
             using std::swap;
             swap( m_tmp, y);
         }
@@ -90,9 +118,13 @@ struct Filter
     }
     private:
     std::string m_type;
-    dg::MultiMatrix<dg::DMatrix, dg::DVec> m_filter;
+    dg::CSRModalFilter<value_type> m_modal;
+    dg::CSRModalEnergyProbe<value_type> m_probe;
     unsigned m_iter;
     value_type m_alpha0;
+    unsigned m_adapt_every = 0, m_count = 0;
+    value_type m_on, m_off;
+    bool m_active = true;
     IMatrix m_stencil, m_stencilY;
     Container m_tmp;
 };
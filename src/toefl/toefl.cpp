@@ -123,7 +123,9 @@ int main( int argc, char* argv[])
         //transform vector to an equidistant grid
         std::stringstream title;
         draw::ColorMapRedBlueExtMinMax colors( -1.0, 1.0);
-        dg::IDMatrix equidistant = dg::create::backscatter( grid );
+        //the block format applies as batched dense per-cell transforms
+        dg::MultiMatrix<dg::DMatrix, dg::DVec> equidistant =
+            dg::create::fast_backscatter( grid );
         // the things to plot:
         std::map<std::string, const dg::DVec* > v2d;
         v2d["ne / "] = &y0[0];